@@ -0,0 +1 @@
+#include "/root/repo/src/network/utils/flat-hash-map.h"
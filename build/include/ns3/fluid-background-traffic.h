@@ -0,0 +1 @@
+#include "/root/repo/src/internet/model/fluid-background-traffic.h"
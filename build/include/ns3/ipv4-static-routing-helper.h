@@ -0,0 +1 @@
+#include "/root/repo/src/internet/helper/ipv4-static-routing-helper.h"
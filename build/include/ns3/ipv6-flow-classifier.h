@@ -0,0 +1 @@
+#include "/root/repo/src/flow-monitor/model/ipv6-flow-classifier.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/propagation/model/itu-r-1411-nlos-over-rooftop-propagation-loss-model.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/spectrum/model/multi-model-spectrum-channel.h"
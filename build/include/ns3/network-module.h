@@ -0,0 +1,88 @@
+#ifdef NS3_MODULE_COMPILATION 
+    error "Do not include ns3 module aggregator headers from other modules these are meant only for end user scripts." 
+#endif 
+#ifndef NS3_MODULE_NETWORK
+    // Module headers: 
+    #include <ns3/application-container.h>
+    #include <ns3/application-helper.h>
+    #include <ns3/delay-jitter-estimation.h>
+    #include <ns3/net-device-container.h>
+    #include <ns3/node-container.h>
+    #include <ns3/packet-socket-helper.h>
+    #include <ns3/simple-net-device-helper.h>
+    #include <ns3/trace-helper.h>
+    #include <ns3/address.h>
+    #include <ns3/application.h>
+    #include <ns3/buffer.h>
+    #include <ns3/byte-tag-list.h>
+    #include <ns3/channel-list.h>
+    #include <ns3/channel.h>
+    #include <ns3/chunk.h>
+    #include <ns3/header.h>
+    #include <ns3/net-device.h>
+    #include <ns3/nix-vector.h>
+    #include <ns3/node-list.h>
+    #include <ns3/node.h>
+    #include <ns3/packet-metadata.h>
+    #include <ns3/packet-tag-list.h>
+    #include <ns3/packet.h>
+    #include <ns3/socket-factory.h>
+    #include <ns3/socket.h>
+    #include <ns3/tag-buffer.h>
+    #include <ns3/tag.h>
+    #include <ns3/trailer.h>
+    #include <ns3/header-serialization-test.h>
+    #include <ns3/address-hash.h>
+    #include <ns3/address-utils.h>
+    #include <ns3/binary-trace-file.h>
+    #include <ns3/bit-deserializer.h>
+    #include <ns3/bit-serializer.h>
+    #include <ns3/crc32.h>
+    #include <ns3/data-rate.h>
+    #include <ns3/drop-tail-queue.h>
+    #include <ns3/dynamic-queue-limits.h>
+    #include <ns3/error-channel.h>
+    #include <ns3/error-model.h>
+    #include <ns3/ethernet-header.h>
+    #include <ns3/ethernet-trailer.h>
+    #include <ns3/flat-hash-map.h>
+    #include <ns3/flow-id-tag.h>
+    #include <ns3/generic-phy.h>
+    #include <ns3/inet-socket-address.h>
+    #include <ns3/inet6-socket-address.h>
+    #include <ns3/ipv4-address.h>
+    #include <ns3/ipv6-address.h>
+    #include <ns3/llc-snap-header.h>
+    #include <ns3/lollipop-counter.h>
+    #include <ns3/mac16-address.h>
+    #include <ns3/mac48-address.h>
+    #include <ns3/mac64-address.h>
+    #include <ns3/mac8-address.h>
+    #include <ns3/net-device-queue-interface.h>
+    #include <ns3/output-stream-wrapper.h>
+    #include <ns3/packet-burst.h>
+    #include <ns3/packet-data-calculators.h>
+    #include <ns3/packet-probe.h>
+    #include <ns3/packet-socket-address.h>
+    #include <ns3/packet-socket-client.h>
+    #include <ns3/packet-socket-factory.h>
+    #include <ns3/packet-socket-server.h>
+    #include <ns3/packet-socket.h>
+    #include <ns3/packetbb.h>
+    #include <ns3/pcap-file-wrapper.h>
+    #include <ns3/pcap-file.h>
+    #include <ns3/pcap-test.h>
+    #include <ns3/prefix-trie.h>
+    #include <ns3/queue-fwd.h>
+    #include <ns3/queue-item.h>
+    #include <ns3/queue-limits.h>
+    #include <ns3/queue-size.h>
+    #include <ns3/queue.h>
+    #include <ns3/radiotap-header.h>
+    #include <ns3/segment-offload-tag.h>
+    #include <ns3/sequence-number.h>
+    #include <ns3/simple-channel.h>
+    #include <ns3/simple-net-device.h>
+    #include <ns3/sll-header.h>
+    #include <ns3/timestamp-tag.h>
+#endif 
\ No newline at end of file
@@ -0,0 +1 @@
+#include "/root/repo/src/network/utils/prefix-trie.h"
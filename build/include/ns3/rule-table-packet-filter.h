@@ -0,0 +1 @@
+#include "/root/repo/src/internet/model/rule-table-packet-filter.h"
@@ -28,6 +28,8 @@
 #include "ns3/ethernet-trailer.h"
 #include "ns3/llc-snap-header.h"
 #include "ns3/log.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/packet-burst.h"
 #include "ns3/pointer.h"
 #include "ns3/queue.h"
 #include "ns3/simulator.h"
@@ -1018,6 +1020,64 @@ CsmaNetDevice::SendFrom(Ptr<Packet> packet,
     return true;
 }
 
+uint32_t
+CsmaNetDevice::SendBurst(Ptr<PacketBurst> burst, const Address& dest, uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(burst << dest << protocolNumber);
+    NS_LOG_LOGIC("burst of " << burst->GetNPackets() << " packets");
+
+    NS_ASSERT(IsLinkUp());
+
+    //
+    // Only transmit if send side of net device is enabled
+    //
+    if (!IsSendEnabled())
+    {
+        for (auto it = burst->Begin(); it != burst->End(); ++it)
+        {
+            m_macTxDropTrace(*it);
+        }
+        return burst->GetNPackets();
+    }
+
+    Mac48Address destination = Mac48Address::ConvertFrom(dest);
+    //
+    // The packets left once the transmission queue is stopped are not taken,
+    // the caller drops them as it drops the packets sent to a stopped queue
+    //
+    Ptr<NetDeviceQueueInterface> ndqi = GetObject<NetDeviceQueueInterface>();
+    uint32_t taken = 0;
+    for (auto it = burst->Begin(); it != burst->End(); ++it, ++taken)
+    {
+        if (ndqi && ndqi->GetTxQueue(0)->IsStopped())
+        {
+            break;
+        }
+        Ptr<Packet> packet = *it;
+        AddHeader(packet, m_address, destination, protocolNumber);
+        m_macTxTrace(packet);
+
+        if (!m_queue->Enqueue(packet))
+        {
+            m_macTxDropTrace(packet);
+            continue;
+        }
+
+        //
+        // Start the transmitter as soon as the first packet is queued, as
+        // SendFrom would (see TransmitCompleteEvent for the following ones)
+        //
+        if (m_txMachineState == READY)
+        {
+            m_currentPkt = m_queue->Dequeue();
+            m_promiscSnifferTrace(m_currentPkt);
+            m_snifferTrace(m_currentPkt);
+            TransmitStart();
+        }
+    }
+    return taken;
+}
+
 Ptr<Node>
 CsmaNetDevice::GetNode() const
 {
@@ -291,6 +291,17 @@ class CsmaNetDevice : public NetDevice
                   const Address& dest,
                   uint16_t protocolNumber) override;
 
+    /**
+     * Start sending a burst of packets down the channel.
+     * \param burst packets to send
+     * \param dest layer 2 destination address
+     * \param protocolNumber protocol number
+     * \return the number of packets accepted by the device
+     */
+    uint32_t SendBurst(Ptr<PacketBurst> burst,
+                       const Address& dest,
+                       uint16_t protocolNumber) override;
+
     /**
      * Get the node to which this device is attached.
      *
@@ -0,0 +1,206 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/csma-helper.h"
+#include "ns3/csma-net-device.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/node-container.h"
+#include "ns3/packet-burst.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup csma
+ * \defgroup csma-test CSMA module tests
+ */
+
+/**
+ * \ingroup csma-test
+ *
+ * \brief Test class for CsmaNetDevice::SendBurst
+ *
+ * A burst of packets larger than the device queue is sent. Without flow
+ * control, the same packets must be dropped and received as when they are
+ * sent one by one. With flow control, the device must stop taking the
+ * packets of the burst once its transmission queue is stopped.
+ */
+class CsmaBurstTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    CsmaBurstTest();
+
+  private:
+    void DoRun() override;
+    /**
+     * \brief Send a number of packets
+     *
+     * \param device the sending device
+     * \param nPackets number of packets to send
+     * \param burst whether to send the packets as a single burst
+     */
+    void SendPackets(Ptr<NetDevice> device, uint32_t nPackets, bool burst);
+    /**
+     * \brief Receive a packet
+     *
+     * \param dev The receiving device.
+     * \param pkt The received packet.
+     * \param mode The protocol mode used.
+     * \param sender The sender address.
+     *
+     * \return A boolean indicating packet handled properly.
+     */
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+    /**
+     * \brief Run a simulation sending a number of packets
+     *
+     * \param nPackets number of packets to send
+     * \param burst whether to send the packets as a single burst
+     * \param flowControl whether flow control is enabled on the devices
+     */
+    void RunOne(uint32_t nPackets, bool burst, bool flowControl);
+
+    uint32_t m_taken;                //!< number of packets taken by the device
+    bool m_stopped;                  //!< whether the transmission queue was stopped
+    std::vector<uint32_t> m_rxSizes; //!< sizes of the received packets
+    uint32_t m_drops;                //!< number of MacTxDrop events
+};
+
+CsmaBurstTest::CsmaBurstTest()
+    : TestCase("Csma burst send")
+{
+}
+
+void
+CsmaBurstTest::SendPackets(Ptr<NetDevice> device, uint32_t nPackets, bool burst)
+{
+    Ptr<PacketBurst> packets = CreateObject<PacketBurst>();
+    for (uint32_t i = 0; i < nPackets; i++)
+    {
+        packets->AddPacket(Create<Packet>(100 + i));
+    }
+    if (burst)
+    {
+        m_taken = device->SendBurst(packets, device->GetBroadcast(), 0x800);
+    }
+    else
+    {
+        for (auto it = packets->Begin(); it != packets->End(); ++it)
+        {
+            device->Send(*it, device->GetBroadcast(), 0x800);
+        }
+        m_taken = nPackets;
+    }
+    Ptr<NetDeviceQueueInterface> ndqi = device->GetObject<NetDeviceQueueInterface>();
+    m_stopped = ndqi && ndqi->GetTxQueue(0)->IsStopped();
+}
+
+bool
+CsmaBurstTest::RxPacket(Ptr<NetDevice> dev,
+                        Ptr<const Packet> pkt,
+                        uint16_t mode,
+                        const Address& sender)
+{
+    m_rxSizes.push_back(pkt->GetSize());
+    return true;
+}
+
+void
+CsmaBurstTest::RunOne(uint32_t nPackets, bool burst, bool flowControl)
+{
+    m_taken = 0;
+    m_stopped = false;
+    m_drops = 0;
+    m_rxSizes.clear();
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    CsmaHelper csma;
+    csma.SetQueue("ns3::DropTailQueue<Packet>", "MaxSize", StringValue("5p"));
+    if (!flowControl)
+    {
+        csma.DisableFlowControl();
+    }
+    NetDeviceContainer devices = csma.Install(nodes);
+
+    devices.Get(1)->SetReceiveCallback(MakeCallback(&CsmaBurstTest::RxPacket, this));
+    devices.Get(0)->TraceConnectWithoutContext(
+        "MacTxDrop",
+        Callback<void, Ptr<const Packet>>([this](Ptr<const Packet>) { m_drops++; }));
+
+    Simulator::Schedule(Seconds(1.0),
+                        &CsmaBurstTest::SendPackets,
+                        this,
+                        devices.Get(0),
+                        nPackets,
+                        burst);
+
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+void
+CsmaBurstTest::DoRun()
+{
+    RunOne(10, false, false);
+    uint32_t drops = m_drops;
+    std::vector<uint32_t> rxSizes = m_rxSizes;
+
+    RunOne(10, true, false);
+    NS_TEST_EXPECT_MSG_EQ(m_taken, 10, "A device without flow control takes every packet");
+    // one packet is being transmitted and five are queued
+    NS_TEST_EXPECT_MSG_EQ(m_drops, 4, "Unexpected number of dropped packets");
+    NS_TEST_EXPECT_MSG_EQ(m_drops, drops, "Burst and single sends drop different packets");
+    NS_TEST_EXPECT_MSG_EQ((m_rxSizes == rxSizes),
+                          true,
+                          "Burst and single sends deliver different packets");
+
+    RunOne(10, true, true);
+    NS_TEST_EXPECT_MSG_EQ(m_taken, 6, "The device must stop taking packets once its queue stops");
+    NS_TEST_EXPECT_MSG_EQ(m_stopped, true, "The transmission queue must be stopped");
+    NS_TEST_EXPECT_MSG_EQ(m_drops, 0, "The device must not drop the packets it does not take");
+    rxSizes.resize(6);
+    NS_TEST_EXPECT_MSG_EQ((m_rxSizes == rxSizes), true, "The packets taken must be delivered");
+}
+
+/**
+ * \ingroup csma-test
+ *
+ * \brief TestSuite for the CSMA module
+ */
+class CsmaTestSuite : public TestSuite
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    CsmaTestSuite();
+};
+
+CsmaTestSuite::CsmaTestSuite()
+    : TestSuite("devices-csma", Type::UNIT)
+{
+    AddTestCase(new CsmaBurstTest, TestCase::Duration::QUICK);
+}
+
+static CsmaTestSuite g_csmaTestSuite; //!< The testsuite
@@ -22,6 +22,7 @@
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <fstream>
 #include <limits>
@@ -81,7 +82,13 @@ FlowMonitor::GetTypeId()
                 ("The minimum inter-arrival time that is considered a flow interruption."),
                 TimeValue(Seconds(0.5)),
                 MakeTimeAccessor(&FlowMonitor::m_flowInterruptionsMinTime),
-                MakeTimeChecker());
+                MakeTimeChecker())
+            .AddAttribute("SamplingRate",
+                          "One packet out of SamplingRate of each flow is tracked, and the "
+                          "counters are scaled accordingly (1 to track every packet).",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&FlowMonitor::m_samplingRate),
+                          MakeUintegerChecker<uint32_t>(1));
     return tid;
 }
 
@@ -92,7 +99,8 @@ FlowMonitor::GetInstanceTypeId() const
 }
 
 FlowMonitor::FlowMonitor()
-    : m_enabled(false)
+    : m_enabled(false),
+      m_samplingRate(1)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -115,6 +123,12 @@ FlowMonitor::DoDispose()
     Object::DoDispose();
 }
 
+uint64_t
+FlowMonitor::GetTrackedPacketKey(FlowId flowId, FlowPacketId packetId)
+{
+    return (static_cast<uint64_t>(flowId) << 32) | packetId;
+}
+
 inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow(FlowId flowId)
 {
@@ -159,22 +173,22 @@ FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
         return;
     }
     Time now = Simulator::Now();
-    TrackedPacket& tracked = m_trackedPackets[std::make_pair(flowId, packetId)];
+    TrackedPacket& tracked = m_trackedPackets[GetTrackedPacketKey(flowId, packetId)];
     tracked.firstSeenTime = now;
     tracked.lastSeenTime = tracked.firstSeenTime;
     tracked.timesForwarded = 0;
     NS_LOG_DEBUG("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId="
                                                                  << packetId << ").");
 
-    probe->AddPacketStats(flowId, packetSize, Seconds(0));
+    probe->AddPacketStats(flowId, packetSize, Seconds(0), m_samplingRate);
 
     FlowStats& stats = GetStatsForFlow(flowId);
-    stats.txBytes += packetSize;
-    stats.txPackets++;
-    if (stats.txPackets == 1)
+    if (stats.txPackets == 0)
     {
         stats.timeFirstTxPacket = now;
     }
+    stats.txBytes += static_cast<uint64_t>(packetSize) * m_samplingRate;
+    stats.txPackets += m_samplingRate;
     stats.timeLastTxPacket = now;
 }
 
@@ -190,8 +204,7 @@ FlowMonitor::ReportForwarding(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    std::pair<FlowId, FlowPacketId> key(flowId, packetId);
-    auto tracked = m_trackedPackets.find(key);
+    auto tracked = m_trackedPackets.find(GetTrackedPacketKey(flowId, packetId));
     if (tracked == m_trackedPackets.end())
     {
         NS_LOG_WARN("Received packet forward report (flowId="
@@ -203,7 +216,7 @@ FlowMonitor::ReportForwarding(Ptr<FlowProbe> probe,
     tracked->second.lastSeenTime = Simulator::Now();
 
     Time delay = (Simulator::Now() - tracked->second.firstSeenTime);
-    probe->AddPacketStats(flowId, packetSize, delay);
+    probe->AddPacketStats(flowId, packetSize, delay, m_samplingRate);
 }
 
 void
@@ -218,7 +231,7 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    auto tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
+    auto tracked = m_trackedPackets.find(GetTrackedPacketKey(flowId, packetId));
     if (tracked == m_trackedPackets.end())
     {
         NS_LOG_WARN("Received packet last-tx report (flowId="
@@ -228,22 +241,22 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
 
     Time now = Simulator::Now();
     Time delay = (now - tracked->second.firstSeenTime);
-    probe->AddPacketStats(flowId, packetSize, delay);
+    probe->AddPacketStats(flowId, packetSize, delay, m_samplingRate);
 
     FlowStats& stats = GetStatsForFlow(flowId);
-    stats.delaySum += delay;
+    stats.delaySum += delay * m_samplingRate;
     stats.delayHistogram.AddValue(delay.GetSeconds());
     if (stats.rxPackets > 0)
     {
         Time jitter = stats.lastDelay - delay;
         if (jitter > Seconds(0))
         {
-            stats.jitterSum += jitter;
+            stats.jitterSum += jitter * m_samplingRate;
             stats.jitterHistogram.AddValue(jitter.GetSeconds());
         }
         else
         {
-            stats.jitterSum -= jitter;
+            stats.jitterSum -= jitter * m_samplingRate;
             stats.jitterHistogram.AddValue(-jitter.GetSeconds());
         }
     }
@@ -257,10 +270,9 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         stats.minDelay = delay;
     }
 
-    stats.rxBytes += packetSize;
+    stats.rxBytes += static_cast<uint64_t>(packetSize) * m_samplingRate;
     stats.packetSizeHistogram.AddValue((double)packetSize);
-    stats.rxPackets++;
-    if (stats.rxPackets == 1)
+    if (stats.rxPackets == 0)
     {
         stats.timeFirstRxPacket = now;
     }
@@ -273,8 +285,9 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
             stats.flowInterruptionsHistogram.AddValue(interArrivalTime.GetSeconds());
         }
     }
+    stats.rxPackets += m_samplingRate;
     stats.timeLastRxPacket = now;
-    stats.timesForwarded += tracked->second.timesForwarded;
+    stats.timesForwarded += tracked->second.timesForwarded * m_samplingRate;
 
     NS_LOG_DEBUG("ReportLastTx: removing tracked packet (flowId=" << flowId << ", packetId="
                                                                   << packetId << ").");
@@ -296,21 +309,21 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
         return;
     }
 
-    probe->AddPacketDropStats(flowId, packetSize, reasonCode);
+    probe->AddPacketDropStats(flowId, packetSize, reasonCode, m_samplingRate);
 
     FlowStats& stats = GetStatsForFlow(flowId);
-    stats.lostPackets++;
+    stats.lostPackets += m_samplingRate;
     if (stats.packetsDropped.size() < reasonCode + 1)
     {
         stats.packetsDropped.resize(reasonCode + 1, 0);
         stats.bytesDropped.resize(reasonCode + 1, 0);
     }
-    ++stats.packetsDropped[reasonCode];
-    stats.bytesDropped[reasonCode] += packetSize;
-    NS_LOG_DEBUG("++stats.packetsDropped["
-                 << reasonCode << "]; // becomes: " << stats.packetsDropped[reasonCode]);
+    stats.packetsDropped[reasonCode] += m_samplingRate;
+    stats.bytesDropped[reasonCode] += static_cast<uint64_t>(packetSize) * m_samplingRate;
+    NS_LOG_DEBUG("stats.packetsDropped[" << reasonCode << "] += " << m_samplingRate
+                                         << "; // becomes: " << stats.packetsDropped[reasonCode]);
 
-    auto tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
+    auto tracked = m_trackedPackets.find(GetTrackedPacketKey(flowId, packetId));
     if (tracked != m_trackedPackets.end())
     {
         // we don't need to track this packet anymore
@@ -338,12 +351,12 @@ FlowMonitor::CheckForLostPackets(Time maxDelay)
         if (now - iter->second.lastSeenTime >= maxDelay)
         {
             // packet is considered lost, add it to the loss statistics
-            auto flow = m_flowStats.find(iter->first.first);
+            auto flow = m_flowStats.find(static_cast<FlowId>(iter->first >> 32));
             NS_ASSERT(flow != m_flowStats.end());
-            flow->second.lostPackets++;
+            flow->second.lostPackets += m_samplingRate;
 
             // we won't track it anymore
-            m_trackedPackets.erase(iter++);
+            iter = m_trackedPackets.erase(iter);
         }
         else
         {
@@ -378,6 +391,12 @@ FlowMonitor::AddProbe(Ptr<FlowProbe> probe)
     m_flowProbes.push_back(probe);
 }
 
+bool
+FlowMonitor::IsSampled(FlowPacketId packetId) const
+{
+    return packetId % m_samplingRate == 0;
+}
+
 const FlowMonitor::FlowProbeContainer&
 FlowMonitor::GetAllProbes() const
 {
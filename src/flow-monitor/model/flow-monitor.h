@@ -24,6 +24,7 @@
 #include "flow-probe.h"
 
 #include "ns3/event-id.h"
+#include "ns3/flat-hash-map.h"
 #include "ns3/histogram.h"
 #include "ns3/nstime.h"
 #include "ns3/object.h"
@@ -47,6 +48,13 @@ namespace ns3
  * The FlowMonitor class is responsible for coordinating efforts
  * regarding probes, and collects end-to-end flow statistics.
  *
+ * When the SamplingRate attribute is set to N > 1, only one packet out of N
+ * of each flow (the first one, then every N-th one) is tracked, and the
+ * packet and byte counters (including the sums of the delays and jitters,
+ * the drops and the per-probe statistics) are scaled by N, so that they
+ * estimate the values that would have been measured without sampling. The
+ * minimum, maximum and last delays, the timestamps of the packets and the
+ * histograms are those of the sampled packets.
  */
 class FlowMonitor : public Object
 {
@@ -175,6 +183,13 @@ class FlowMonitor : public Object
     /// \param probe the probe to add
     void AddProbe(Ptr<FlowProbe> probe);
 
+    /// FlowProbe implementations are supposed to call this method to
+    /// check whether a new packet has to be tracked, i.e., tagged and
+    /// reported, according to the SamplingRate attribute.
+    /// \param packetId Packet ID, as assigned by the FlowClassifier
+    /// \returns true if the packet is to be tracked
+    bool IsSampled(FlowPacketId packetId) const;
+
     /// FlowProbe implementations are supposed to call this method to
     /// report that a new packet was transmitted (but keep in mind the
     /// distinction between a new packet entering the system and a
@@ -297,8 +312,8 @@ class FlowMonitor : public Object
     /// FlowId --> FlowStats
     FlowStatsContainer m_flowStats;
 
-    /// (FlowId,PacketId) --> TrackedPacket
-    typedef std::map<std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+    /// (FlowId,PacketId) --> TrackedPacket, see GetTrackedPacketKey
+    typedef FlatHashMap<uint64_t, TrackedPacket> TrackedPacketMap;
     TrackedPacketMap m_trackedPackets; //!< Tracked packets
     Time m_maxPerHopDelay;             //!< Minimum per-hop delay
     FlowProbeContainer m_flowProbes;   //!< all the FlowProbes
@@ -314,6 +329,13 @@ class FlowMonitor : public Object
     double m_packetSizeBinWidth;        //!< packet size bin width (for histograms)
     double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
     Time m_flowInterruptionsMinTime;    //!< Flow interruptions minimum time
+    uint32_t m_samplingRate;            //!< One packet out of m_samplingRate is tracked
+
+    /// Get the key of a tracked packet
+    /// \param flowId the Flow identification
+    /// \param packetId the Packet ID
+    /// \returns the key of the packet in m_trackedPackets
+    static uint64_t GetTrackedPacketKey(FlowId flowId, FlowPacketId packetId);
 
     /// Get the stats for a given flow
     /// \param flowId the Flow identification
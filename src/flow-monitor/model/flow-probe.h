@@ -86,12 +86,20 @@ class FlowProbe : public Object
     /// \param flowId the flow Identifier
     /// \param packetSize the packet size
     /// \param delayFromFirstProbe packet delay
-    void AddPacketStats(FlowId flowId, uint32_t packetSize, Time delayFromFirstProbe);
+    /// \param count number of packets accounted for (more than one when packets are sampled)
+    void AddPacketStats(FlowId flowId,
+                        uint32_t packetSize,
+                        Time delayFromFirstProbe,
+                        uint32_t count = 1);
     /// Add a packet drop data to the flow stats
     /// \param flowId the flow Identifier
     /// \param packetSize the packet size
     /// \param reasonCode reason code for the drop
-    void AddPacketDropStats(FlowId flowId, uint32_t packetSize, uint32_t reasonCode);
+    /// \param count number of packets accounted for (more than one when packets are sampled)
+    void AddPacketDropStats(FlowId flowId,
+                            uint32_t packetSize,
+                            uint32_t reasonCode,
+                            uint32_t count = 1);
 
     /// Get the partial flow statistics stored in this probe.  With this
     /// information you can, for example, find out what is the delay
@@ -342,7 +342,10 @@ Ipv4FlowProbe::SendOutgoingLogger(const Ipv4Header& ipHeader,
         return;
     }
 
-    if (m_classifier->Classify(ipHeader, ipPayload, &flowId, &packetId))
+    // packets left out by sampling are classified, to number the packets of
+    // their flow, but neither reported nor tagged, hence ignored by the other probes
+    if (m_classifier->Classify(ipHeader, ipPayload, &flowId, &packetId) &&
+        m_flowMonitor->IsSampled(packetId))
     {
         uint32_t size = (ipPayload->GetSize() + ipHeader.GetSerializedSize());
         NS_LOG_DEBUG("ReportFirstTx (" << this << ", " << flowId << ", " << packetId << ", " << size
@@ -96,6 +96,21 @@ Ipv6FlowClassifier::Ipv6FlowClassifier()
 {
 }
 
+std::size_t
+Ipv6FlowClassifier::FiveTupleHash::operator()(const FiveTuple& tuple) const
+{
+    uint64_t source[2];
+    uint64_t destination[2];
+    tuple.sourceAddress.GetWords(source);
+    tuple.destinationAddress.GetWords(destination);
+    uint64_t ports = uint64_t(tuple.protocol) << 32 | uint32_t(tuple.sourcePort) << 16 |
+                     tuple.destinationPort;
+    uint64_t hash = FlatHashMix(source[0] ^ FlatHashMix(source[1]));
+    hash = FlatHashMix(hash ^ destination[0]);
+    hash = FlatHashMix(hash ^ destination[1]);
+    return static_cast<std::size_t>(FlatHashMix(hash ^ ports));
+}
+
 bool
 Ipv6FlowClassifier::Classify(const Ipv6Header& ipHeader,
                              Ptr<const Packet> ipPayload,
@@ -145,35 +160,29 @@ Ipv6FlowClassifier::Classify(const Ipv6Header& ipHeader,
     tuple.sourcePort = srcPort;
     tuple.destinationPort = dstPort;
 
-    // try to insert the tuple, but check if it already exists
+    // try to insert the tuple, but check if it already exists: the tuple is
+    // hashed once, the state of the flow is then found by its identifier
     auto insert = m_flowMap.insert(std::pair<FiveTuple, FlowId>(tuple, 0));
 
     // if the insertion succeeded, we need to assign this tuple a new flow identifier
     if (insert.second)
     {
         FlowId newFlowId = GetNewFlowId();
+        NS_ASSERT(newFlowId == m_flows.size() + 1);
         insert.first->second = newFlowId;
-        m_flowPktIdMap[newFlowId] = 0;
-        m_flowDscpMap[newFlowId];
+        m_flows.push_back(FlowState{tuple, 0, {}});
     }
     else
     {
-        m_flowPktIdMap[insert.first->second]++;
+        m_flows[insert.first->second - 1].lastPacketId++;
     }
+    FlowState& flow = m_flows[insert.first->second - 1];
 
     // increment the counter of packets with the same DSCP value
-    Ipv6Header::DscpType dscp = ipHeader.GetDscp();
-    auto dscpInserter = m_flowDscpMap[insert.first->second].insert(
-        std::pair<Ipv6Header::DscpType, uint32_t>(dscp, 1));
-
-    // if the insertion did not succeed, we need to increment the counter
-    if (!dscpInserter.second)
-    {
-        m_flowDscpMap[insert.first->second][dscp]++;
-    }
+    flow.dscpCounts[ipHeader.GetDscp()]++;
 
     *out_flowId = insert.first->second;
-    *out_packetId = m_flowPktIdMap[*out_flowId];
+    *out_packetId = flow.lastPacketId;
 
     return true;
 }
@@ -181,12 +190,9 @@ Ipv6FlowClassifier::Classify(const Ipv6Header& ipHeader,
 Ipv6FlowClassifier::FiveTuple
 Ipv6FlowClassifier::FindFlow(FlowId flowId) const
 {
-    for (auto iter = m_flowMap.begin(); iter != m_flowMap.end(); iter++)
+    if (flowId > 0 && flowId <= m_flows.size())
     {
-        if (iter->second == flowId)
-        {
-            return iter->first;
-        }
+        return m_flows[flowId - 1].tuple;
     }
     NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
     FiveTuple retval = {Ipv6Address::GetZero(), Ipv6Address::GetZero(), 0, 0, 0};
@@ -203,15 +209,14 @@ Ipv6FlowClassifier::SortByCount::operator()(std::pair<Ipv6Header::DscpType, uint
 std::vector<std::pair<Ipv6Header::DscpType, uint32_t>>
 Ipv6FlowClassifier::GetDscpCounts(FlowId flowId) const
 {
-    auto flow = m_flowDscpMap.find(flowId);
-
-    if (flow == m_flowDscpMap.end())
+    if (flowId == 0 || flowId > m_flows.size())
     {
         NS_FATAL_ERROR("Could not find the flow with ID " << flowId);
     }
 
-    std::vector<std::pair<Ipv6Header::DscpType, uint32_t>> v(flow->second.begin(),
-                                                             flow->second.end());
+    const auto& dscpCounts = m_flows[flowId - 1].dscpCounts;
+    std::vector<std::pair<Ipv6Header::DscpType, uint32_t>> v(dscpCounts.begin(),
+                                                             dscpCounts.end());
     std::sort(v.begin(), v.end(), SortByCount());
     return v;
 }
@@ -223,27 +228,23 @@ Ipv6FlowClassifier::SerializeToXmlStream(std::ostream& os, uint16_t indent) cons
     os << "<Ipv6FlowClassifier>\n";
 
     indent += 2;
-    for (auto iter = m_flowMap.begin(); iter != m_flowMap.end(); iter++)
+    for (FlowId flowId = 1; flowId <= m_flows.size(); flowId++)
     {
+        const FlowState& flow = m_flows[flowId - 1];
         Indent(os, indent);
-        os << "<Flow flowId=\"" << iter->second << "\""
-           << " sourceAddress=\"" << iter->first.sourceAddress << "\""
-           << " destinationAddress=\"" << iter->first.destinationAddress << "\""
-           << " protocol=\"" << int(iter->first.protocol) << "\""
-           << " sourcePort=\"" << iter->first.sourcePort << "\""
-           << " destinationPort=\"" << iter->first.destinationPort << "\">\n";
+        os << "<Flow flowId=\"" << flowId << "\""
+           << " sourceAddress=\"" << flow.tuple.sourceAddress << "\""
+           << " destinationAddress=\"" << flow.tuple.destinationAddress << "\""
+           << " protocol=\"" << int(flow.tuple.protocol) << "\""
+           << " sourcePort=\"" << flow.tuple.sourcePort << "\""
+           << " destinationPort=\"" << flow.tuple.destinationPort << "\">\n";
 
         indent += 2;
-        auto flow = m_flowDscpMap.find(iter->second);
-
-        if (flow != m_flowDscpMap.end())
+        for (auto i = flow.dscpCounts.begin(); i != flow.dscpCounts.end(); i++)
         {
-            for (auto i = flow->second.begin(); i != flow->second.end(); i++)
-            {
-                Indent(os, indent);
-                os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t>(i->first) << "\""
-                   << " packets=\"" << std::dec << i->second << "\" />\n";
-            }
+            Indent(os, indent);
+            os << "<Dscp value=\"0x" << std::hex << static_cast<uint32_t>(i->first) << "\""
+               << " packets=\"" << std::dec << i->second << "\" />\n";
         }
 
         indent -= 2;
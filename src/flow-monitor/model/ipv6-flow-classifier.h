@@ -23,10 +23,12 @@
 
 #include "flow-classifier.h"
 
+#include "ns3/flat-hash-map.h"
 #include "ns3/ipv6-header.h"
 
 #include <map>
 #include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
@@ -94,12 +96,31 @@ class Ipv6FlowClassifier : public FlowClassifier
     void SerializeToXmlStream(std::ostream& os, uint16_t indent) const override;
 
   private:
+    /**
+     * \brief Hash functor of the five-tuples.
+     */
+    struct FiveTupleHash
+    {
+        /**
+         * \param tuple the five-tuple to hash
+         * \returns the hash value
+         */
+        std::size_t operator()(const FiveTuple& tuple) const;
+    };
+
+    /// Structure holding the state of a flow
+    struct FlowState
+    {
+        FiveTuple tuple;           //!< Five-tuple of the flow
+        FlowPacketId lastPacketId; //!< Identifier of the last packet of the flow
+        /// Map DSCP values to packet counts
+        std::map<Ipv6Header::DscpType, uint32_t> dscpCounts;
+    };
+
     /// Map to Flows Identifiers to FlowIds
-    std::map<FiveTuple, FlowId> m_flowMap;
-    /// Map to FlowIds to FlowPacketId
-    std::map<FlowId, FlowPacketId> m_flowPktIdMap;
-    /// Map FlowIds to (DSCP value, packet count) pairs
-    std::map<FlowId, std::map<Ipv6Header::DscpType, uint32_t>> m_flowDscpMap;
+    FlatHashMap<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
+    /// The flows, indexed by FlowId - 1 (flow identifiers are assigned in sequence)
+    std::vector<FlowState> m_flows;
 };
 
 /**
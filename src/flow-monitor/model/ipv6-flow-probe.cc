@@ -285,7 +285,10 @@ Ipv6FlowProbe::SendOutgoingLogger(const Ipv6Header& ipHeader,
     FlowId flowId;
     FlowPacketId packetId;
 
-    if (m_classifier->Classify(ipHeader, ipPayload, &flowId, &packetId))
+    // packets left out by sampling are classified, to number the packets of
+    // their flow, but neither reported nor tagged, hence ignored by the other probes
+    if (m_classifier->Classify(ipHeader, ipPayload, &flowId, &packetId) &&
+        m_flowMonitor->IsSampled(packetId))
     {
         uint32_t size = (ipPayload->GetSize() + ipHeader.GetSerializedSize());
         NS_LOG_DEBUG("ReportFirstTx (" << this << ", " << flowId << ", " << packetId << ", " << size
@@ -0,0 +1,241 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/data-rate.h"
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/neighbor-cache-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/test.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <map>
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor
+ * \defgroup flow-monitor-test Flow monitor module tests
+ */
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief Check the counters of a sampling flow monitor against exact counts.
+ *
+ * Two UDP flows send datagrams from a node to another through a router, the
+ * first one a multiple of the sampling rate, the second one not. The packet
+ * and byte counters and the forwarding counts of the flow monitor, scaled by
+ * the sampling rate, must equal the numbers of datagrams sent and received
+ * when a flow sends a multiple of the sampling rate, and be off by less than
+ * the sampling rate otherwise. The datagrams all have the same delay, which
+ * the scaled sum of the delays must reflect.
+ */
+class FlowMonitorSamplingTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param samplingRate the sampling rate of the flow monitor
+     */
+    FlowMonitorSamplingTestCase(uint32_t samplingRate);
+
+  private:
+    void DoRun() override;
+    /**
+     * Send a datagram.
+     * \param socket the sending socket
+     */
+    void SendDatagram(Ptr<Socket> socket);
+    /**
+     * Read the datagrams received by a socket.
+     * \param socket the receiving socket
+     */
+    void ReceiveDatagrams(Ptr<Socket> socket);
+
+    uint32_t m_samplingRate;                 //!< sampling rate of the flow monitor
+    std::map<uint16_t, uint32_t> m_sent;     //!< datagrams sent, by source port
+    std::map<uint16_t, uint32_t> m_received; //!< datagrams received, by source port
+};
+
+FlowMonitorSamplingTestCase::FlowMonitorSamplingTestCase(uint32_t samplingRate)
+    : TestCase("Check the counters of a flow monitor with sampling rate " +
+               std::to_string(samplingRate)),
+      m_samplingRate(samplingRate)
+{
+}
+
+void
+FlowMonitorSamplingTestCase::SendDatagram(Ptr<Socket> socket)
+{
+    Address local;
+    socket->GetSockName(local);
+    if (socket->Send(Create<Packet>(100)) >= 0)
+    {
+        m_sent[InetSocketAddress::ConvertFrom(local).GetPort()]++;
+    }
+}
+
+void
+FlowMonitorSamplingTestCase::ReceiveDatagrams(Ptr<Socket> socket)
+{
+    Address from;
+    while (socket->RecvFrom(from))
+    {
+        m_received[InetSocketAddress::ConvertFrom(from).GetPort()]++;
+    }
+}
+
+void
+FlowMonitorSamplingTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(3);
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(nodes);
+
+    SimpleNetDeviceHelper simple;
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("10Mb/s")));
+    simple.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer source =
+        ipv4.Assign(simple.Install(NodeContainer(nodes.Get(0), nodes.Get(1))));
+    ipv4.SetBase("10.1.2.0", "255.255.255.0");
+    Ipv4InterfaceContainer destination =
+        ipv4.Assign(simple.Install(NodeContainer(nodes.Get(1), nodes.Get(2))));
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    // no ARP exchange delays the first datagram
+    NeighborCacheHelper neighborCache;
+    neighborCache.PopulateNeighborCache(source);
+    neighborCache.PopulateNeighborCache(destination);
+
+    FlowMonitorHelper flowMonitorHelper;
+    flowMonitorHelper.SetMonitorAttribute("SamplingRate", UintegerValue(m_samplingRate));
+    Ptr<FlowMonitor> flowMonitor = flowMonitorHelper.Install(nodes);
+
+    uint16_t port = 9;
+    Ptr<Socket> receiver = Socket::CreateSocket(nodes.Get(2), UdpSocketFactory::GetTypeId());
+    receiver->Bind(InetSocketAddress(Ipv4Address::GetAny(), port));
+    receiver->SetRecvCallback(MakeCallback(&FlowMonitorSamplingTestCase::ReceiveDatagrams, this));
+
+    // the datagrams of the two flows are interleaved and spaced enough not to
+    // be queued, hence have the same delay
+    std::map<uint16_t, uint32_t> datagrams;
+    Time start = Seconds(0);
+    for (uint32_t count : {10 * m_samplingRate, 10 * m_samplingRate + m_samplingRate / 2})
+    {
+        Ptr<Socket> socket = Socket::CreateSocket(nodes.Get(0), UdpSocketFactory::GetTypeId());
+        socket->Bind();
+        socket->Connect(InetSocketAddress(destination.GetAddress(1), port));
+        Address local;
+        socket->GetSockName(local);
+        datagrams[InetSocketAddress::ConvertFrom(local).GetPort()] = count;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            Simulator::Schedule(start + MilliSeconds(10 * i),
+                                &FlowMonitorSamplingTestCase::SendDatagram,
+                                this,
+                                socket);
+        }
+        start += MilliSeconds(5);
+    }
+
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+    flowMonitor->CheckForLostPackets();
+
+    // a 100 bytes payload, a UDP header and an IPv4 header
+    const uint64_t packetSize = 128;
+    Ptr<Ipv4FlowClassifier> classifier =
+        DynamicCast<Ipv4FlowClassifier>(flowMonitorHelper.GetClassifier());
+    NS_TEST_ASSERT_MSG_EQ(flowMonitor->GetFlowStats().size(), 2, "Unexpected number of flows");
+    for (const auto& [flowId, stats] : flowMonitor->GetFlowStats())
+    {
+        uint16_t sourcePort = classifier->FindFlow(flowId).sourcePort;
+        uint32_t sent = m_sent[sourcePort];
+        uint32_t received = m_received[sourcePort];
+        NS_TEST_EXPECT_MSG_EQ(sent, datagrams[sourcePort], "Not every datagram was sent");
+        NS_TEST_EXPECT_MSG_EQ(received, sent, "Not every datagram was received");
+
+        if (sent % m_samplingRate == 0)
+        {
+            NS_TEST_EXPECT_MSG_EQ(stats.txPackets, sent, "Bad scaled count of sent packets");
+            NS_TEST_EXPECT_MSG_EQ(stats.rxPackets, received, "Bad scaled count of packets");
+            NS_TEST_EXPECT_MSG_EQ(stats.txBytes, sent * packetSize, "Bad scaled count of bytes");
+            NS_TEST_EXPECT_MSG_EQ(stats.rxBytes,
+                                  received * packetSize,
+                                  "Bad scaled count of received bytes");
+            NS_TEST_EXPECT_MSG_EQ(stats.timesForwarded,
+                                  received,
+                                  "Every packet is forwarded once");
+            NS_TEST_EXPECT_MSG_EQ(stats.delaySum,
+                                  stats.lastDelay * received,
+                                  "Bad scaled sum of delays");
+        }
+        else
+        {
+            // the first packet is sampled, then one every m_samplingRate
+            uint32_t sampled = (sent + m_samplingRate - 1) / m_samplingRate;
+            NS_TEST_EXPECT_MSG_EQ(stats.txPackets,
+                                  sampled * m_samplingRate,
+                                  "Bad scaled count of sent packets");
+            NS_TEST_EXPECT_MSG_LT(stats.txPackets - sent,
+                                  m_samplingRate,
+                                  "Scaled count of sent packets too far from the exact one");
+            NS_TEST_EXPECT_MSG_EQ(stats.rxPackets,
+                                  sampled * m_samplingRate,
+                                  "Bad scaled count of received packets");
+        }
+        NS_TEST_EXPECT_MSG_EQ(stats.lostPackets, 0, "No packet is lost");
+        NS_TEST_EXPECT_MSG_EQ(stats.jitterSum, Seconds(0), "No jitter is expected");
+        NS_TEST_EXPECT_MSG_GT(stats.lastDelay, MilliSeconds(2), "Bad delay");
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief Flow monitor TestSuite
+ */
+class FlowMonitorTestSuite : public TestSuite
+{
+  public:
+    FlowMonitorTestSuite();
+};
+
+FlowMonitorTestSuite::FlowMonitorTestSuite()
+    : TestSuite("flow-monitor", Type::UNIT)
+{
+    AddTestCase(new FlowMonitorSamplingTestCase(1), TestCase::Duration::QUICK);
+    AddTestCase(new FlowMonitorSamplingTestCase(10), TestCase::Duration::QUICK);
+}
+
+static FlowMonitorTestSuite g_flowMonitorTestSuite; //!< Static variable for test initialization
@@ -87,6 +87,8 @@ class Ipv4GlobalRoutingHelper : public Ipv4RoutingHelper
      * Users must first call PopulateRoutingTables() and then may subsequently
      * call RecomputeRoutingTables() at any later time in the simulation.
      *
+     * If the "GlobalRoutingIncremental" global value is true, only the
+     * routes affected by the changes of the topology are recomputed.
      */
     static void RecomputeRoutingTables();
 };
@@ -29,11 +29,47 @@
 #include "ns3/ptr.h"
 #include "ns3/simulator.h"
 
+#include <map>
+
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("NeighborCacheHelper");
 
+/**
+ * \brief Get the IPv4 interface of a device.
+ * \param device the NetDevice
+ * \return the Ipv4Interface of the device, or nullptr if none
+ */
+static Ptr<Ipv4Interface>
+GetIpv4Interface(Ptr<NetDevice> device)
+{
+    Ptr<Ipv4L3Protocol> ipv4 = device->GetNode()->GetObject<Ipv4L3Protocol>();
+    if (!ipv4)
+    {
+        return nullptr;
+    }
+    int32_t index = ipv4->GetInterfaceForDevice(device);
+    return index != -1 ? ipv4->GetInterface(index) : nullptr;
+}
+
+/**
+ * \brief Get the IPv6 interface of a device.
+ * \param device the NetDevice
+ * \return the Ipv6Interface of the device, or nullptr if none
+ */
+static Ptr<Ipv6Interface>
+GetIpv6Interface(Ptr<NetDevice> device)
+{
+    Ptr<Ipv6L3Protocol> ipv6 = device->GetNode()->GetObject<Ipv6L3Protocol>();
+    if (!ipv6)
+    {
+        return nullptr;
+    }
+    int32_t index = ipv6->GetInterfaceForDevice(device);
+    return index != -1 ? ipv6->GetInterface(index) : nullptr;
+}
+
 NeighborCacheHelper::NeighborCacheHelper()
 {
     NS_LOG_FUNCTION(this);
@@ -60,6 +96,24 @@ void
 NeighborCacheHelper::PopulateNeighborCache(Ptr<Channel> channel) const
 {
     NS_LOG_FUNCTION(this << channel);
+    if (m_sharedNeighborCache)
+    {
+        Ptr<SharedNeighborTable<Ipv4Address>> ipv4Table = CreateSharedTableIpv4(channel);
+        Ptr<SharedNeighborTable<Ipv6Address>> ipv6Table = CreateSharedTableIpv6(channel);
+        for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
+        {
+            Ptr<NetDevice> netDevice = channel->GetDevice(i);
+            if (Ptr<Ipv4Interface> ipv4Interface = GetIpv4Interface(netDevice))
+            {
+                SetSharedTable(ipv4Interface, ipv4Table);
+            }
+            if (Ptr<Ipv6Interface> ipv6Interface = GetIpv6Interface(netDevice))
+            {
+                SetSharedTable(ipv6Interface, ipv6Table);
+            }
+        }
+        return;
+    }
     for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
     {
         Ptr<NetDevice> netDevice = channel->GetDevice(i);
@@ -129,6 +183,36 @@ void
 NeighborCacheHelper::PopulateNeighborCache(const NetDeviceContainer& c) const
 {
     NS_LOG_FUNCTION(this);
+    if (m_sharedNeighborCache)
+    {
+        // one table per channel, shared by the devices of the container attached to it
+        std::map<Ptr<Channel>, Ptr<SharedNeighborTable<Ipv4Address>>> ipv4Tables;
+        std::map<Ptr<Channel>, Ptr<SharedNeighborTable<Ipv6Address>>> ipv6Tables;
+        for (uint32_t i = 0; i < c.GetN(); ++i)
+        {
+            Ptr<NetDevice> netDevice = c.Get(i);
+            Ptr<Channel> channel = netDevice->GetChannel();
+            if (Ptr<Ipv4Interface> ipv4Interface = GetIpv4Interface(netDevice))
+            {
+                Ptr<SharedNeighborTable<Ipv4Address>>& table = ipv4Tables[channel];
+                if (!table)
+                {
+                    table = CreateSharedTableIpv4(channel);
+                }
+                SetSharedTable(ipv4Interface, table);
+            }
+            if (Ptr<Ipv6Interface> ipv6Interface = GetIpv6Interface(netDevice))
+            {
+                Ptr<SharedNeighborTable<Ipv6Address>>& table = ipv6Tables[channel];
+                if (!table)
+                {
+                    table = CreateSharedTableIpv6(channel);
+                }
+                SetSharedTable(ipv6Interface, table);
+            }
+        }
+        return;
+    }
     for (uint32_t i = 0; i < c.GetN(); ++i)
     {
         Ptr<NetDevice> netDevice = c.Get(i);
@@ -199,13 +283,25 @@ void
 NeighborCacheHelper::PopulateNeighborCache(const Ipv4InterfaceContainer& c) const
 {
     NS_LOG_FUNCTION(this);
+    // with shared neighbor cache, one table per channel
+    std::map<Ptr<Channel>, Ptr<SharedNeighborTable<Ipv4Address>>> tables;
     for (uint32_t i = 0; i < c.GetN(); ++i)
     {
         std::pair<Ptr<Ipv4>, uint32_t> returnValue = c.Get(i);
         Ptr<Ipv4> ipv4 = returnValue.first;
         uint32_t index = returnValue.second;
         Ptr<Ipv4Interface> ipv4Interface = DynamicCast<Ipv4L3Protocol>(ipv4)->GetInterface(index);
-        if (ipv4Interface)
+        if (ipv4Interface && m_sharedNeighborCache)
+        {
+            Ptr<Channel> channel = ipv4Interface->GetDevice()->GetChannel();
+            Ptr<SharedNeighborTable<Ipv4Address>>& table = tables[channel];
+            if (!table)
+            {
+                table = CreateSharedTableIpv4(channel);
+            }
+            SetSharedTable(ipv4Interface, table);
+        }
+        else if (ipv4Interface)
         {
             Ptr<NetDevice> netDevice = ipv4Interface->GetDevice();
             Ptr<Channel> channel = netDevice->GetChannel();
@@ -234,13 +330,25 @@ void
 NeighborCacheHelper::PopulateNeighborCache(const Ipv6InterfaceContainer& c) const
 {
     NS_LOG_FUNCTION(this);
+    // with shared neighbor cache, one table per channel
+    std::map<Ptr<Channel>, Ptr<SharedNeighborTable<Ipv6Address>>> tables;
     for (uint32_t i = 0; i < c.GetN(); ++i)
     {
         std::pair<Ptr<Ipv6>, uint32_t> returnValue = c.Get(i);
         Ptr<Ipv6> ipv6 = returnValue.first;
         uint32_t index = returnValue.second;
         Ptr<Ipv6Interface> ipv6Interface = DynamicCast<Ipv6L3Protocol>(ipv6)->GetInterface(index);
-        if (ipv6Interface)
+        if (ipv6Interface && m_sharedNeighborCache)
+        {
+            Ptr<Channel> channel = ipv6Interface->GetDevice()->GetChannel();
+            Ptr<SharedNeighborTable<Ipv6Address>>& table = tables[channel];
+            if (!table)
+            {
+                table = CreateSharedTableIpv6(channel);
+            }
+            SetSharedTable(ipv6Interface, table);
+        }
+        else if (ipv6Interface)
         {
             Ptr<NetDevice> netDevice = ipv6Interface->GetDevice();
             Ptr<Channel> channel = netDevice->GetChannel();
@@ -400,6 +508,105 @@ NeighborCacheHelper::AddEntry(Ptr<Ipv6Interface> netDeviceInterface,
     entry->MarkAutoGenerated();
 }
 
+Ptr<SharedNeighborTable<Ipv4Address>>
+NeighborCacheHelper::CreateSharedTableIpv4(Ptr<Channel> channel) const
+{
+    NS_LOG_FUNCTION(this << channel);
+    Ptr<SharedNeighborTable<Ipv4Address>> table = Create<SharedNeighborTable<Ipv4Address>>();
+    table->Reserve(channel->GetNDevices());
+    for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
+    {
+        Ptr<NetDevice> device = channel->GetDevice(i);
+        Ptr<Ipv4Interface> ipv4Interface = GetIpv4Interface(device);
+        if (!ipv4Interface)
+        {
+            continue;
+        }
+        for (uint32_t n = 0; n < ipv4Interface->GetNAddresses(); ++n)
+        {
+            table->Add(ipv4Interface->GetAddress(n).GetLocal(), device->GetAddress());
+        }
+    }
+    return table;
+}
+
+Ptr<SharedNeighborTable<Ipv6Address>>
+NeighborCacheHelper::CreateSharedTableIpv6(Ptr<Channel> channel) const
+{
+    NS_LOG_FUNCTION(this << channel);
+    Ptr<SharedNeighborTable<Ipv6Address>> table = Create<SharedNeighborTable<Ipv6Address>>();
+    // a link-local and a global address per device, usually
+    table->Reserve(2 * channel->GetNDevices());
+    for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
+    {
+        Ptr<NetDevice> device = channel->GetDevice(i);
+        Ptr<Ipv6Interface> ipv6Interface = GetIpv6Interface(device);
+        if (!ipv6Interface)
+        {
+            continue;
+        }
+        for (uint32_t n = 0; n < ipv6Interface->GetNAddresses(); ++n)
+        {
+            Ipv6InterfaceAddress ifAddr = ipv6Interface->GetAddress(n);
+            if (ifAddr.GetScope() != Ipv6InterfaceAddress::HOST)
+            {
+                table->Add(ifAddr.GetAddress(), device->GetAddress());
+            }
+        }
+    }
+    return table;
+}
+
+void
+NeighborCacheHelper::SetSharedTable(Ptr<Ipv4Interface> ipv4Interface,
+                                    Ptr<SharedNeighborTable<Ipv4Address>> table) const
+{
+    NS_LOG_FUNCTION(this << ipv4Interface << table);
+    Ptr<ArpCache> arpCache = ipv4Interface->GetArpCache();
+    if (!arpCache)
+    {
+        NS_LOG_LOGIC(
+            "ArpCache doesn't exist, might be a point-to-point NetDevice without ArpCache");
+        return;
+    }
+    if (m_dynamicNeighborCache)
+    {
+        ipv4Interface->RemoveAddressCallback(
+            MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv4AddressRemoved, this));
+        if (m_globalNeighborCache)
+        {
+            ipv4Interface->AddAddressCallback(
+                MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv4AddressAdded, this));
+        }
+    }
+    arpCache->SetSharedTable(table);
+}
+
+void
+NeighborCacheHelper::SetSharedTable(Ptr<Ipv6Interface> ipv6Interface,
+                                    Ptr<SharedNeighborTable<Ipv6Address>> table) const
+{
+    NS_LOG_FUNCTION(this << ipv6Interface << table);
+    Ptr<NdiscCache> ndiscCache = ipv6Interface->GetNdiscCache();
+    if (!ndiscCache)
+    {
+        NS_LOG_LOGIC(
+            "NdiscCache doesn't exist, might be a point-to-point NetDevice without NdiscCache");
+        return;
+    }
+    if (m_dynamicNeighborCache)
+    {
+        ipv6Interface->RemoveAddressCallback(
+            MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv6AddressRemoved, this));
+        if (m_globalNeighborCache)
+        {
+            ipv6Interface->AddAddressCallback(
+                MakeCallback(&NeighborCacheHelper::UpdateCacheByIpv6AddressAdded, this));
+        }
+    }
+    ndiscCache->SetSharedTable(table);
+}
+
 void
 NeighborCacheHelper::FlushAutoGenerated() const
 {
@@ -443,6 +650,12 @@ NeighborCacheHelper::UpdateCacheByIpv4AddressRemoved(const Ptr<Ipv4Interface> in
                                                      const Ipv4InterfaceAddress ifAddr) const
 {
     NS_LOG_FUNCTION(this);
+    Ptr<ArpCache> cache = interface->GetArpCache();
+    if (cache && cache->GetSharedTable())
+    {
+        cache->GetSharedTable()->Remove(ifAddr.GetLocal());
+        return;
+    }
     Ptr<NetDevice> netDevice = interface->GetDevice();
     Ptr<Channel> channel = netDevice->GetChannel();
     for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
@@ -475,6 +688,12 @@ NeighborCacheHelper::UpdateCacheByIpv4AddressAdded(const Ptr<Ipv4Interface> inte
                                                    const Ipv4InterfaceAddress ifAddr) const
 {
     NS_LOG_FUNCTION(this);
+    Ptr<ArpCache> cache = interface->GetArpCache();
+    if (cache && cache->GetSharedTable())
+    {
+        cache->GetSharedTable()->Add(ifAddr.GetLocal(), interface->GetDevice()->GetAddress());
+        return;
+    }
     Ptr<NetDevice> netDevice = interface->GetDevice();
     Ptr<Channel> channel = netDevice->GetChannel();
     for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
@@ -509,6 +728,12 @@ NeighborCacheHelper::UpdateCacheByIpv6AddressRemoved(const Ptr<Ipv6Interface> in
                                                      const Ipv6InterfaceAddress ifAddr) const
 {
     NS_LOG_FUNCTION(this);
+    Ptr<NdiscCache> cache = interface->GetNdiscCache();
+    if (cache && cache->GetSharedTable())
+    {
+        cache->GetSharedTable()->Remove(ifAddr.GetAddress());
+        return;
+    }
     Ptr<NetDevice> netDevice = interface->GetDevice();
     Ptr<Channel> channel = netDevice->GetChannel();
     for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
@@ -541,6 +766,12 @@ NeighborCacheHelper::UpdateCacheByIpv6AddressAdded(const Ptr<Ipv6Interface> inte
                                                    const Ipv6InterfaceAddress ifAddr) const
 {
     NS_LOG_FUNCTION(this);
+    Ptr<NdiscCache> cache = interface->GetNdiscCache();
+    if (cache && cache->GetSharedTable())
+    {
+        cache->GetSharedTable()->Add(ifAddr.GetAddress(), interface->GetDevice()->GetAddress());
+        return;
+    }
     Ptr<NetDevice> netDevice = interface->GetDevice();
     Ptr<Channel> channel = netDevice->GetChannel();
     for (std::size_t i = 0; i < channel->GetNDevices(); ++i)
@@ -577,4 +808,11 @@ NeighborCacheHelper::SetDynamicNeighborCache(bool enable)
     m_dynamicNeighborCache = enable;
 }
 
+void
+NeighborCacheHelper::SetSharedNeighborCache(bool enable)
+{
+    NS_LOG_FUNCTION(this);
+    m_sharedNeighborCache = enable;
+}
+
 } // namespace ns3
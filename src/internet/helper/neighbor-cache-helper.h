@@ -35,6 +35,7 @@
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/net-device-container.h"
 #include "ns3/node-list.h"
+#include "ns3/shared-neighbor-table.h"
 
 namespace ns3
 {
@@ -46,6 +47,11 @@ namespace ns3
  *
  * This class is used to populate neighbor cache. Permanent entries will be added
  * on the scope of a channel, a NetDeviceContainer, an InterfaceContainer or globally.
+ *
+ * On channels shared by many devices, the entries can instead be kept in one
+ * SharedNeighborTable per channel, referenced by the caches of all the
+ * interfaces attached to it (see SetSharedNeighborCache): populating takes a
+ * time and a memory linear in the number of devices instead of quadratic.
  */
 class NeighborCacheHelper
 {
@@ -104,6 +110,15 @@ class NeighborCacheHelper
      */
     void SetDynamicNeighborCache(bool enable);
 
+    /**
+     * \brief Enable/disable shared neighbor cache. When enabled, the neighbor caches of the
+     * interfaces attached to a channel share one table holding the addresses of all the
+     * interfaces of the channel instead of holding one auto-generated entry per neighbor.
+     * The addresses missing from the table are resolved by ARP and NDISC as usual.
+     * \param enable enable state
+     */
+    void SetSharedNeighborCache(bool enable);
+
   private:
     /**
      * \brief Populate neighbor ARP entries for given IPv4 interface.
@@ -141,6 +156,36 @@ class NeighborCacheHelper
                   Ipv6Address ipv6Address,
                   Address macAddress) const;
 
+    /**
+     * \brief Create the table of the IPv4 addresses of the interfaces attached to a channel.
+     * \param channel the Channel to process
+     * \return the shared table
+     */
+    Ptr<SharedNeighborTable<Ipv4Address>> CreateSharedTableIpv4(Ptr<Channel> channel) const;
+
+    /**
+     * \brief Create the table of the IPv6 addresses of the interfaces attached to a channel.
+     * \param channel the Channel to process
+     * \return the shared table
+     */
+    Ptr<SharedNeighborTable<Ipv6Address>> CreateSharedTableIpv6(Ptr<Channel> channel) const;
+
+    /**
+     * \brief Make the ARP cache of an interface use a shared table.
+     * \param ipv4Interface the Ipv4Interface to process
+     * \param table the table shared on the channel of the interface
+     */
+    void SetSharedTable(Ptr<Ipv4Interface> ipv4Interface,
+                        Ptr<SharedNeighborTable<Ipv4Address>> table) const;
+
+    /**
+     * \brief Make the NDISC cache of an interface use a shared table.
+     * \param ipv6Interface the Ipv6Interface to process
+     * \param table the table shared on the channel of the interface
+     */
+    void SetSharedTable(Ptr<Ipv6Interface> ipv6Interface,
+                        Ptr<SharedNeighborTable<Ipv6Address>> table) const;
+
     /**
      * \brief Update neighbor caches when an address is removed from a Ipv4Interface with auto
      * generated neighbor cache.
@@ -182,6 +227,9 @@ class NeighborCacheHelper
 
     bool m_dynamicNeighborCache{
         false}; //!< flag will set true if dynamic neighbor cache is enabled.
+
+    bool m_sharedNeighborCache{
+        false}; //!< flag will set true if shared neighbor cache is enabled.
 };
 
 } // namespace ns3
@@ -19,6 +19,7 @@
 #include "arp-cache.h"
 
 #include "ipv4-header.h"
+#include "ipv4-interface-address.h"
 #include "ipv4-interface.h"
 
 #include "ns3/assert.h"
@@ -30,6 +31,8 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 
+#include <map>
+
 namespace ns3
 {
 
@@ -102,6 +105,7 @@ ArpCache::DoDispose()
     Flush();
     m_device = nullptr;
     m_interface = nullptr;
+    m_sharedTable = nullptr;
     if (!m_waitReplyTimer.IsPending())
     {
         m_waitReplyTimer.Cancel();
@@ -199,38 +203,45 @@ ArpCache::HandleWaitReplyTimeout()
     NS_LOG_FUNCTION(this);
     ArpCache::Entry* entry;
     bool restartWaitReplyTimer = false;
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    // visit the entries waiting for a reply in address order, so that the order of
+    // the retransmitted requests does not depend on the hash table layout
+    for (auto i = m_waitReplyAddresses.begin(); i != m_waitReplyAddresses.end();)
     {
-        entry = (*i).second;
-        if (entry != nullptr && entry->IsWaitReply())
+        auto it = m_arpCache.find(*i);
+        entry = (it != m_arpCache.end()) ? it->second : nullptr;
+        if (entry == nullptr || !entry->IsWaitReply())
+        {
+            i = m_waitReplyAddresses.erase(i);
+            continue;
+        }
+        if (entry->GetRetries() < m_maxRetries)
         {
-            if (entry->GetRetries() < m_maxRetries)
+            NS_LOG_LOGIC("node=" << m_device->GetNode()->GetId() << ", ArpWaitTimeout for "
+                                 << entry->GetIpv4Address()
+                                 << " expired -- retransmitting arp request since retries = "
+                                 << entry->GetRetries());
+            m_arpRequestCallback(this, entry->GetIpv4Address());
+            restartWaitReplyTimer = true;
+            entry->IncrementRetries();
+            i++;
+        }
+        else
+        {
+            NS_LOG_LOGIC("node=" << m_device->GetNode()->GetId() << ", wait reply for "
+                                 << entry->GetIpv4Address()
+                                 << " expired -- drop since max retries exceeded: "
+                                 << entry->GetRetries());
+            entry->MarkDead();
+            entry->ClearRetries();
+            Ipv4PayloadHeaderPair pending = entry->DequeuePending();
+            while (pending.first)
             {
-                NS_LOG_LOGIC("node=" << m_device->GetNode()->GetId() << ", ArpWaitTimeout for "
-                                     << entry->GetIpv4Address()
-                                     << " expired -- retransmitting arp request since retries = "
-                                     << entry->GetRetries());
-                m_arpRequestCallback(this, entry->GetIpv4Address());
-                restartWaitReplyTimer = true;
-                entry->IncrementRetries();
-            }
-            else
-            {
-                NS_LOG_LOGIC("node=" << m_device->GetNode()->GetId() << ", wait reply for "
-                                     << entry->GetIpv4Address()
-                                     << " expired -- drop since max retries exceeded: "
-                                     << entry->GetRetries());
-                entry->MarkDead();
-                entry->ClearRetries();
-                Ipv4PayloadHeaderPair pending = entry->DequeuePending();
-                while (pending.first)
-                {
-                    // add the Ipv4 header for tracing purposes
-                    pending.first->AddHeader(pending.second);
-                    m_dropTrace(pending.first);
-                    pending = entry->DequeuePending();
-                }
+                // add the Ipv4 header for tracing purposes
+                pending.first->AddHeader(pending.second);
+                m_dropTrace(pending.first);
+                pending = entry->DequeuePending();
             }
+            i = m_waitReplyAddresses.erase(i);
         }
     }
     if (restartWaitReplyTimer)
@@ -249,7 +260,8 @@ ArpCache::Flush()
     {
         delete (*i).second;
     }
-    m_arpCache.erase(m_arpCache.begin(), m_arpCache.end());
+    m_arpCache.clear();
+    m_waitReplyAddresses.clear();
     if (m_waitReplyTimer.IsPending())
     {
         NS_LOG_LOGIC("Stopping WaitReplyTimer at " << Simulator::Now().GetSeconds()
@@ -264,7 +276,31 @@ ArpCache::PrintArpCache(Ptr<OutputStreamWrapper> stream)
     NS_LOG_FUNCTION(this << stream);
     std::ostream* os = stream->GetStream();
 
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    std::map<Ipv4Address, ArpCache::Entry*> sorted(m_arpCache.begin(), m_arpCache.end());
+    if (m_sharedTable)
+    {
+        // the shared entries are printed as the auto-generated entries of the
+        // neighbors in the subnets of the interface, without an Entry
+        for (auto it = m_sharedTable->Begin(); it != m_sharedTable->End(); it++)
+        {
+            bool neighbor = false;
+            for (uint32_t j = 0; j < m_interface->GetNAddresses(); j++)
+            {
+                Ipv4InterfaceAddress ifAddr = m_interface->GetAddress(j);
+                if (ifAddr.GetLocal() == it->first)
+                {
+                    neighbor = false;
+                    break;
+                }
+                neighbor = neighbor || ifAddr.IsInSameSubnet(it->first);
+            }
+            if (neighbor)
+            {
+                sorted.insert({it->first, nullptr});
+            }
+        }
+    }
+    for (auto i = sorted.begin(); i != sorted.end(); i++)
     {
         *os << i->first << " dev ";
         std::string found = Names::FindName(m_device);
@@ -277,6 +313,12 @@ ArpCache::PrintArpCache(Ptr<OutputStreamWrapper> stream)
             *os << static_cast<int>(m_device->GetIfIndex());
         }
 
+        if (!i->second)
+        {
+            *os << " lladdr " << *m_sharedTable->Lookup(i->first) << " STATIC_AUTOGENERATED\n";
+            continue;
+        }
+
         *os << " lladdr " << i->second->GetMacAddress();
 
         if (i->second->IsAlive())
@@ -312,11 +354,25 @@ ArpCache::RemoveAutoGeneratedEntries()
         {
             i->second->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
             delete i->second;
-            m_arpCache.erase(i++);
+            i = m_arpCache.erase(i);
             continue;
         }
         i++;
     }
+    m_sharedTable = nullptr;
+}
+
+void
+ArpCache::SetSharedTable(Ptr<SharedNeighborTable<Ipv4Address>> table)
+{
+    NS_LOG_FUNCTION(this << table);
+    m_sharedTable = table;
+}
+
+Ptr<SharedNeighborTable<Ipv4Address>>
+ArpCache::GetSharedTable() const
+{
+    return m_sharedTable;
 }
 
 std::list<ArpCache::Entry*>
@@ -333,6 +389,9 @@ ArpCache::LookupInverse(Address to)
             entryList.push_back(entry);
         }
     }
+    entryList.sort([](ArpCache::Entry* a, ArpCache::Entry* b) {
+        return a->GetIpv4Address() < b->GetIpv4Address();
+    });
     return entryList;
 }
 
@@ -365,15 +424,13 @@ ArpCache::Remove(ArpCache::Entry* entry)
 {
     NS_LOG_FUNCTION(this << entry);
 
-    for (auto i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    auto i = m_arpCache.find(entry->GetIpv4Address());
+    if (i != m_arpCache.end() && (*i).second == entry)
     {
-        if ((*i).second == entry)
-        {
-            m_arpCache.erase(i);
-            entry->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
-            delete entry;
-            return;
-        }
+        m_arpCache.erase(i);
+        entry->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
+        delete entry;
+        return;
     }
     NS_LOG_WARN("Entry not found in this ARP Cache");
 }
@@ -492,6 +549,7 @@ ArpCache::Entry::MarkWaitReply(Ipv4PayloadHeaderPair waiting)
     m_state = WAIT_REPLY;
     m_pending.push_back(waiting);
     UpdateSeen();
+    m_arp->m_waitReplyAddresses.insert(m_ipv4Address);
     m_arp->StartWaitReplyTimer();
 }
 
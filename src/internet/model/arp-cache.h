@@ -21,6 +21,7 @@
 
 #include "ns3/address.h"
 #include "ns3/callback.h"
+#include "ns3/flat-hash-map.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/net-device.h"
 #include "ns3/nstime.h"
@@ -28,11 +29,13 @@
 #include "ns3/output-stream-wrapper.h"
 #include "ns3/packet.h"
 #include "ns3/ptr.h"
+#include "ns3/shared-neighbor-table.h"
 #include "ns3/simulator.h"
 #include "ns3/traced-callback.h"
 
 #include <list>
 #include <map>
+#include <set>
 #include <stdint.h>
 
 namespace ns3
@@ -168,10 +171,27 @@ class ArpCache : public Object
     void PrintArpCache(Ptr<OutputStreamWrapper> stream);
 
     /**
-     * \brief Clear the ArpCache of all Auto-Generated entries
+     * \brief Clear the ArpCache of all Auto-Generated entries, including the
+     * shared neighbor table, if any.
      */
     void RemoveAutoGeneratedEntries();
 
+    /**
+     * \brief Set the neighbor table shared with the other interfaces of the channel.
+     *
+     * The addresses missing from the cache are looked up in the shared table
+     * before being resolved by ARP. Flush does not remove the shared table.
+     *
+     * \param table the shared table, or nullptr to remove it
+     */
+    void SetSharedTable(Ptr<SharedNeighborTable<Ipv4Address>> table);
+
+    /**
+     * \brief Get the neighbor table shared with the other interfaces of the channel.
+     * \return the shared table, or nullptr if none
+     */
+    Ptr<SharedNeighborTable<Ipv4Address>> GetSharedTable() const;
+
     /**
      * \brief Pair of a packet and an Ipv4 header.
      */
@@ -321,11 +341,11 @@ class ArpCache : public Object
     /**
      * \brief ARP Cache container
      */
-    typedef std::map<Ipv4Address, ArpCache::Entry*> Cache;
+    typedef FlatHashMap<Ipv4Address, ArpCache::Entry*> Cache;
     /**
      * \brief ARP Cache container iterator
      */
-    typedef std::map<Ipv4Address, ArpCache::Entry*>::iterator CacheI;
+    typedef Cache::iterator CacheI;
 
     void DoDispose() override;
 
@@ -347,6 +367,10 @@ class ArpCache : public Object
     void HandleWaitReplyTimeout();
     uint32_t m_pendingQueueSize; //!< number of packets waiting for a resolution
     Cache m_arpCache;            //!< the ARP cache
+    /// addresses of the entries marked WAIT_REPLY since the last wait reply timeout, in
+    /// address order; the entries no longer waiting for a reply are removed at the timeout
+    std::set<Ipv4Address> m_waitReplyAddresses;
+    Ptr<SharedNeighborTable<Ipv4Address>> m_sharedTable; //!< table shared on the channel
     TracedCallback<Ptr<const Packet>>
         m_dropTrace; //!< trace for packets dropped by the ARP cache queue
 };
@@ -294,6 +294,17 @@ ArpL3Protocol::Lookup(Ptr<Packet> packet,
 {
     NS_LOG_FUNCTION(this << packet << destination << device << cache << hardwareDestination);
     ArpCache::Entry* entry = cache->Lookup(destination);
+    if (entry == nullptr && cache->GetSharedTable())
+    {
+        const Address* macAddress = cache->GetSharedTable()->Lookup(destination);
+        if (macAddress != nullptr)
+        {
+            NS_LOG_LOGIC("node=" << m_node->GetId() << ", shared entry for " << destination
+                                 << " -- send");
+            *hardwareDestination = *macAddress;
+            return true;
+        }
+    }
     if (entry != nullptr)
     {
         if (entry->IsExpired())
@@ -58,20 +58,23 @@ operator<<(std::ostream& os, const SPFVertex::VertexType& t)
 std::ostream&
 operator<<(std::ostream& os, const CandidateQueue& q)
 {
-    const CandidateQueue::CandidateList_t& list = q.m_candidates;
+    std::vector<CandidateQueue::Candidate> list = q.m_candidates;
+    std::sort(list.begin(), list.end(), &CandidateQueue::CompareCandidate);
 
     os << "*** CandidateQueue Begin (<id, distance, LSA-type>) ***" << std::endl;
     for (auto iter = list.begin(); iter != list.end(); iter++)
     {
-        os << "<" << (*iter)->GetVertexId() << ", " << (*iter)->GetDistanceFromRoot() << ", "
-           << (*iter)->GetVertexType() << ">" << std::endl;
+        os << "<" << iter->vertex->GetVertexId() << ", " << iter->vertex->GetDistanceFromRoot()
+           << ", " << iter->vertex->GetVertexType() << ">" << std::endl;
     }
     os << "*** CandidateQueue End ***";
     return os;
 }
 
 CandidateQueue::CandidateQueue()
-    : m_candidates()
+    : m_candidates(),
+      m_index(),
+      m_sequence(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -99,11 +102,10 @@ CandidateQueue::Push(SPFVertex* vNew)
 {
     NS_LOG_FUNCTION(this << vNew);
 
-    auto i = std::upper_bound(m_candidates.begin(),
-                              m_candidates.end(),
-                              vNew,
-                              &CandidateQueue::CompareSPFVertex);
-    m_candidates.insert(i, vNew);
+    m_candidates.push_back({vNew, vNew->GetDistanceFromRoot(), m_sequence++});
+    std::push_heap(m_candidates.begin(), m_candidates.end(), &CandidateQueue::HeapCompare);
+    // keep the first vertex pushed if several vertices have the same id
+    m_index.insert({vNew->GetVertexId(), vNew});
 }
 
 SPFVertex*
@@ -115,8 +117,14 @@ CandidateQueue::Pop()
         return nullptr;
     }
 
-    SPFVertex* v = m_candidates.front();
-    m_candidates.pop_front();
+    std::pop_heap(m_candidates.begin(), m_candidates.end(), &CandidateQueue::HeapCompare);
+    SPFVertex* v = m_candidates.back().vertex;
+    m_candidates.pop_back();
+    auto it = m_index.find(v->GetVertexId());
+    if (it != m_index.end() && it->second == v)
+    {
+        m_index.erase(it);
+    }
     return v;
 }
 
@@ -129,7 +137,7 @@ CandidateQueue::Top() const
         return nullptr;
     }
 
-    return m_candidates.front();
+    return m_candidates.front().vertex;
 }
 
 bool
@@ -150,18 +158,28 @@ SPFVertex*
 CandidateQueue::Find(const Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this);
-    auto i = m_candidates.begin();
+    auto it = m_index.find(addr);
+    if (it != m_index.end())
+    {
+        return it->second;
+    }
+    if (m_index.size() == m_candidates.size())
+    {
+        return nullptr;
+    }
 
-    for (; i != m_candidates.end(); i++)
+    // some vertices share their id, and the one indexed has been popped:
+    // look for the first of the others in the queue order
+    const Candidate* found = nullptr;
+    for (const auto& candidate : m_candidates)
     {
-        SPFVertex* v = *i;
-        if (v->GetVertexId() == addr)
+        if (candidate.vertex->GetVertexId() == addr &&
+            (found == nullptr || CompareCandidate(candidate, *found)))
         {
-            return v;
+            found = &candidate;
         }
     }
-
-    return nullptr;
+    return found ? found->vertex : nullptr;
 }
 
 void
@@ -169,7 +187,25 @@ CandidateQueue::Reorder()
 {
     NS_LOG_FUNCTION(this);
 
-    m_candidates.sort(&CandidateQueue::CompareSPFVertex);
+    // order the vertices whose distance changed as if they were pushed now,
+    // in their previous order
+    std::vector<Candidate*> changed;
+    for (auto& candidate : m_candidates)
+    {
+        if (candidate.distance != candidate.vertex->GetDistanceFromRoot())
+        {
+            changed.push_back(&candidate);
+        }
+    }
+    std::sort(changed.begin(), changed.end(), [](const Candidate* c1, const Candidate* c2) {
+        return CompareCandidate(*c1, *c2);
+    });
+    for (auto candidate : changed)
+    {
+        candidate->distance = candidate->vertex->GetDistanceFromRoot();
+        candidate->sequence = m_sequence++;
+    }
+    std::make_heap(m_candidates.begin(), m_candidates.end(), &CandidateQueue::HeapCompare);
     NS_LOG_LOGIC("After reordering the CandidateQueue");
     NS_LOG_LOGIC(*this);
 }
@@ -182,24 +218,29 @@ CandidateQueue::Reorder()
  * This ordering is necessary for implementing ECMP
  */
 bool
-CandidateQueue::CompareSPFVertex(const SPFVertex* v1, const SPFVertex* v2)
+CandidateQueue::CompareCandidate(const Candidate& c1, const Candidate& c2)
 {
-    NS_LOG_FUNCTION(&v1 << &v2);
-
-    bool result = false;
-    if (v1->GetDistanceFromRoot() < v2->GetDistanceFromRoot())
+    if (c1.distance != c2.distance)
     {
-        result = true;
+        return c1.distance < c2.distance;
     }
-    else if (v1->GetDistanceFromRoot() == v2->GetDistanceFromRoot())
+    SPFVertex::VertexType t1 = c1.vertex->GetVertexType();
+    SPFVertex::VertexType t2 = c2.vertex->GetVertexType();
+    if (t1 == SPFVertex::VertexNetwork && t2 == SPFVertex::VertexRouter)
     {
-        if (v1->GetVertexType() == SPFVertex::VertexNetwork &&
-            v2->GetVertexType() == SPFVertex::VertexRouter)
-        {
-            result = true;
-        }
+        return true;
     }
-    return result;
+    if (t1 == SPFVertex::VertexRouter && t2 == SPFVertex::VertexNetwork)
+    {
+        return false;
+    }
+    return c1.sequence < c2.sequence;
+}
+
+bool
+CandidateQueue::HeapCompare(const Candidate& c1, const Candidate& c2)
+{
+    return CompareCandidate(c2, c1);
 }
 
 } // namespace ns3
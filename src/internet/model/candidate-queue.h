@@ -20,10 +20,11 @@
 #ifndef CANDIDATE_QUEUE_H
 #define CANDIDATE_QUEUE_H
 
+#include "ns3/flat-hash-map.h"
 #include "ns3/ipv4-address.h"
 
-#include <list>
 #include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
@@ -48,6 +49,14 @@ class SPFVertex;
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple
  * enhanced priority queue.
+ *
+ * The vertices are kept in a binary heap, indexed by vertex id, so that
+ * Push (), Pop () and Find () do not scan the whole queue.  Vertices at the
+ * same distance (and of the same type) are popped in the order they were
+ * pushed; a vertex whose distance changed is ordered, by Reorder (), as if
+ * it had just been pushed.  This is the order of the sorted list used by
+ * earlier versions, so that the routes computed do not depend on the
+ * implementation of the queue.
  */
 class CandidateQueue
 {
@@ -160,21 +169,39 @@ class CandidateQueue
     void Reorder();
 
   private:
+    /// A vertex in the queue, with the key it is ordered by
+    struct Candidate
+    {
+        SPFVertex* vertex; //!< the vertex
+        uint32_t distance; //!< the distance from the root of the vertex when it was ordered
+        uint64_t sequence; //!< the order in which the vertex was (re)ordered
+    };
+
     /**
-     * \brief return true if v1 < v2
+     * \brief return true if c1 should be popped before c2
+     *
+     * A vertex is popped first if its distance from the root is smaller;
+     * in case of a tie, a network vertex is popped before a router vertex;
+     * otherwise, the vertex ordered first is popped first.
      *
-     * SPFVertexes are added into the queue according to the ordering
-     * defined by this method. If v1 should be popped before v2, this
-     * method return true; false otherwise
+     * \param c1 first operand
+     * \param c2 second operand
+     * \return True if c1 should be popped before c2; false otherwise
+     */
+    static bool CompareCandidate(const Candidate& c1, const Candidate& c2);
+
+    /**
+     * \brief Heap comparison function, ordering the candidate to pop first at the top
      *
-     * \param v1 first operand
-     * \param v2 second operand
-     * \return True if v1 should be popped before v2; false otherwise
+     * \param c1 first operand
+     * \param c2 second operand
+     * \return True if c2 should be popped before c1; false otherwise
      */
-    static bool CompareSPFVertex(const SPFVertex* v1, const SPFVertex* v2);
+    static bool HeapCompare(const Candidate& c1, const Candidate& c2);
 
-    typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-    CandidateList_t m_candidates;                  //!< SPFVertex candidates
+    std::vector<Candidate> m_candidates;         //!< SPFVertex candidates, as a binary heap
+    FlatHashMap<Ipv4Address, SPFVertex*> m_index; //!< SPFVertex candidates, by vertex id
+    uint64_t m_sequence;                          //!< sequence number of the next candidate
 
     /**
      * \brief Stream insertion operator.
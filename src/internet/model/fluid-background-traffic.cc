@@ -0,0 +1,596 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "fluid-background-traffic.h"
+
+#include "ipv4-header.h"
+#include "ipv4-route.h"
+#include "ipv4-routing-protocol.h"
+#include "ipv4.h"
+#include "tcp-l4-protocol.h"
+
+#include "ns3/abort.h"
+#include "ns3/channel.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/queue-disc.h"
+#include "ns3/simulator.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FluidBackgroundTraffic");
+
+NS_OBJECT_ENSURE_REGISTERED(FluidBackgroundTraffic);
+
+/// Maximum number of hops of a path, to stop on routing loops
+static const uint32_t FLUID_MAX_HOPS = 64;
+
+TypeId
+FluidBackgroundTraffic::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::FluidBackgroundTraffic")
+            .SetParent<Object>()
+            .SetGroupName("Internet")
+            .AddConstructor<FluidBackgroundTraffic>()
+            .AddAttribute("Model",
+                          "The fluid model of the background flows.",
+                          EnumValue(FluidBackgroundTraffic::RENO),
+                          MakeEnumAccessor<Model>(&FluidBackgroundTraffic::m_model),
+                          MakeEnumChecker(FluidBackgroundTraffic::MAX_MIN,
+                                          "MaxMin",
+                                          FluidBackgroundTraffic::RENO,
+                                          "Reno"))
+            .AddAttribute("TimeStep",
+                          "The time step of the model, which should be well below the "
+                          "round-trip times of the flows.",
+                          TimeValue(MilliSeconds(1)),
+                          MakeTimeAccessor(&FluidBackgroundTraffic::m_timeStep),
+                          MakeTimeChecker(Time(1)))
+            .AddAttribute("ForegroundAveraging",
+                          "The time constant of the moving average of the rate of the "
+                          "foreground packets sent on a link.",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&FluidBackgroundTraffic::m_foregroundAveraging),
+                          MakeTimeChecker())
+            .AddAttribute("SegmentSize",
+                          "The segment size of the background flows.",
+                          UintegerValue(1448),
+                          MakeUintegerAccessor(&FluidBackgroundTraffic::m_segmentSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("BufferSize",
+                          "The buffer of each link for the background flows (RENO model), "
+                          "packets being counted as segments.",
+                          QueueSizeValue(QueueSize("100p")),
+                          MakeQueueSizeAccessor(&FluidBackgroundTraffic::m_bufferSize),
+                          MakeQueueSizeChecker())
+            .AddAttribute("MaxWindow",
+                          "The maximum window of a flow, in segments.",
+                          DoubleValue(1000),
+                          MakeDoubleAccessor(&FluidBackgroundTraffic::m_maxWindow),
+                          MakeDoubleChecker<double>(1))
+            .AddAttribute("MinCapacityShare",
+                          "The share of the capacity of a link always left to the "
+                          "foreground packets.",
+                          DoubleValue(0.05),
+                          MakeDoubleAccessor(&FluidBackgroundTraffic::m_minCapacityShare),
+                          MakeDoubleChecker<double>(0, 1));
+    return tid;
+}
+
+FluidBackgroundTraffic::FluidBackgroundTraffic()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FluidBackgroundTraffic::~FluidBackgroundTraffic()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FluidBackgroundTraffic::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_startEvent.Cancel();
+    m_stopEvent.Cancel();
+    m_stepEvent.Cancel();
+    m_links.clear();
+    m_linkIndex.clear();
+    m_aggregates.clear();
+    Object::DoDispose();
+}
+
+/**
+ * \param rate the capacity of a link
+ * \return the capacity in bytes per second
+ */
+static double
+BytesPerSecond(DataRate rate)
+{
+    return rate.GetBitRate() / 8.0;
+}
+
+uint32_t
+FluidBackgroundTraffic::AddFlows(Ptr<Node> source, Ipv4Address destination, uint32_t count)
+{
+    NS_LOG_FUNCTION(this << source << destination << count);
+    Aggregate aggregate;
+    aggregate.m_source = source;
+    aggregate.m_destination = destination;
+    aggregate.m_count = count;
+    if (m_running)
+    {
+        FindPath(aggregate);
+    }
+    m_aggregates.push_back(aggregate);
+    return m_aggregates.size() - 1;
+}
+
+void
+FluidBackgroundTraffic::SetFlowCount(uint32_t aggregate, uint32_t count)
+{
+    NS_LOG_FUNCTION(this << aggregate << count);
+    NS_ASSERT_MSG(aggregate < m_aggregates.size(), "Invalid aggregate " << aggregate);
+    m_aggregates[aggregate].m_count = count;
+}
+
+void
+FluidBackgroundTraffic::Start(Time start)
+{
+    NS_LOG_FUNCTION(this << start);
+    m_startEvent.Cancel();
+    m_startEvent = Simulator::Schedule(start, &FluidBackgroundTraffic::DoStart, this);
+}
+
+void
+FluidBackgroundTraffic::Stop(Time stop)
+{
+    NS_LOG_FUNCTION(this << stop);
+    m_stopEvent.Cancel();
+    m_stopEvent = Simulator::Schedule(stop, &FluidBackgroundTraffic::DoStop, this);
+}
+
+void
+FluidBackgroundTraffic::UpdatePaths()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& aggregate : m_aggregates)
+    {
+        FindPath(aggregate);
+    }
+}
+
+void
+FluidBackgroundTraffic::FindPath(Aggregate& aggregate)
+{
+    NS_LOG_FUNCTION(this << aggregate.m_source << aggregate.m_destination);
+    aggregate.m_links.clear();
+    aggregate.m_propagationRtt = 0;
+
+    Ipv4Header header;
+    header.SetDestination(aggregate.m_destination);
+    header.SetProtocol(TcpL4Protocol::PROT_NUMBER);
+    Ptr<Node> node = aggregate.m_source;
+    for (uint32_t hop = 0; hop < FLUID_MAX_HOPS; hop++)
+    {
+        Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+        NS_ABORT_MSG_UNLESS(ipv4, "Node " << node->GetId() << " has no IPv4 stack");
+        if (ipv4->GetInterfaceForAddress(aggregate.m_destination) >= 0)
+        {
+            return;
+        }
+
+        Socket::SocketErrno err;
+        Ptr<Ipv4RoutingProtocol> routing = ipv4->GetRoutingProtocol();
+        Ptr<Ipv4Route> route =
+            routing ? routing->RouteOutput(nullptr, header, nullptr, err) : nullptr;
+        if (!route)
+        {
+            NS_LOG_WARN("No route from node " << node->GetId() << " to "
+                                              << aggregate.m_destination);
+            return;
+        }
+        Ptr<NetDevice> device = route->GetOutputDevice();
+        Ipv4Address nextHop = route->GetGateway();
+        if (nextHop == Ipv4Address::GetAny())
+        {
+            nextHop = aggregate.m_destination;
+        }
+
+        int32_t link = GetLink(device);
+        if (link >= 0)
+        {
+            aggregate.m_links.push_back(link);
+            aggregate.m_propagationRtt += 2 * m_links[link].m_propagationDelay;
+        }
+
+        Ptr<Channel> channel = device->GetChannel();
+        Ptr<Node> next;
+        for (std::size_t i = 0; channel && i < channel->GetNDevices() && !next; i++)
+        {
+            Ptr<NetDevice> peer = channel->GetDevice(i);
+            if (peer == device)
+            {
+                continue;
+            }
+            Ptr<Ipv4> peerIpv4 = peer->GetNode()->GetObject<Ipv4>();
+            if (peerIpv4 && peerIpv4->GetInterfaceForAddress(nextHop) >= 0)
+            {
+                next = peer->GetNode();
+            }
+        }
+        if (!next)
+        {
+            NS_LOG_WARN("Next hop " << nextHop << " of node " << node->GetId()
+                                    << " not found on its channel");
+            return;
+        }
+        node = next;
+    }
+    NS_LOG_WARN("Path to " << aggregate.m_destination << " longer than " << FLUID_MAX_HOPS
+                           << " hops");
+}
+
+int32_t
+FluidBackgroundTraffic::GetLink(Ptr<NetDevice> device)
+{
+    NS_LOG_FUNCTION(this << device);
+    auto it = m_linkIndex.find(device);
+    if (it != m_linkIndex.end())
+    {
+        return it->second;
+    }
+
+    // the devices without a finite DataRate do not constrain the flows
+    DataRateValue rate;
+    if (!device->GetAttributeFailSafe("DataRate", rate) || rate.Get().GetBitRate() == 0)
+    {
+        return -1;
+    }
+
+    Link link;
+    link.m_device = device;
+    link.m_capacity = rate.Get();
+    if (Ptr<TrafficControlLayer> tc = device->GetNode()->GetObject<TrafficControlLayer>())
+    {
+        link.m_queueDisc = tc->GetRootQueueDiscOnDevice(device);
+    }
+    if (link.m_queueDisc)
+    {
+        link.m_foregroundBytes = link.m_queueDisc->GetStats().nTotalReceivedBytes;
+    }
+    TimeValue delay;
+    if (device->GetChannel() && device->GetChannel()->GetAttributeFailSafe("Delay", delay))
+    {
+        link.m_propagationDelay = delay.Get().GetSeconds();
+    }
+
+    m_links.push_back(link);
+    m_linkIndex.emplace(device, m_links.size() - 1);
+    return m_links.size() - 1;
+}
+
+const FluidBackgroundTraffic::Link*
+FluidBackgroundTraffic::FindLink(Ptr<NetDevice> device) const
+{
+    auto it = m_linkIndex.find(device);
+    return it != m_linkIndex.end() ? &m_links[it->second] : nullptr;
+}
+
+void
+FluidBackgroundTraffic::DoStart()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_running)
+    {
+        return;
+    }
+    m_running = true;
+    UpdatePaths();
+    for (auto& link : m_links)
+    {
+        if (link.m_queueDisc)
+        {
+            link.m_foregroundBytes = link.m_queueDisc->GetStats().nTotalReceivedBytes;
+        }
+    }
+    m_stepEvent = Simulator::Schedule(m_timeStep, &FluidBackgroundTraffic::Step, this);
+}
+
+void
+FluidBackgroundTraffic::DoStop()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_running)
+    {
+        return;
+    }
+    m_running = false;
+    m_stepEvent.Cancel();
+    for (auto& link : m_links)
+    {
+        Restore(link);
+    }
+}
+
+void
+FluidBackgroundTraffic::Step()
+{
+    NS_LOG_FUNCTION(this);
+    double dt = m_timeStep.GetSeconds();
+
+    for (auto& link : m_links)
+    {
+        if (link.m_queueDisc)
+        {
+            // the foreground packets are bursty at the scale of a time step
+            uint64_t bytes = link.m_queueDisc->GetStats().nTotalReceivedBytes;
+            double weight = std::min(dt / m_foregroundAveraging.GetSeconds(), 1.0);
+            double rate = (bytes - link.m_foregroundBytes) / dt;
+            link.m_foreground += weight * (rate - link.m_foreground);
+            link.m_foregroundBytes = bytes;
+        }
+    }
+
+    if (m_model == RENO)
+    {
+        UpdateReno(dt);
+    }
+    else
+    {
+        UpdateMaxMin();
+    }
+    UpdateLinks(dt);
+
+    for (auto& link : m_links)
+    {
+        Impose(link);
+    }
+    m_stepEvent = Simulator::Schedule(m_timeStep, &FluidBackgroundTraffic::Step, this);
+}
+
+void
+FluidBackgroundTraffic::UpdateReno(double dt)
+{
+    NS_LOG_FUNCTION(this << dt);
+    for (auto& aggregate : m_aggregates)
+    {
+        double rtt = aggregate.m_propagationRtt;
+        double success = 1;
+        for (uint32_t l : aggregate.m_links)
+        {
+            rtt += m_links[l].m_queue / BytesPerSecond(m_links[l].m_capacity);
+            success *= 1 - m_links[l].m_loss;
+        }
+        // the model cannot resolve round-trip times shorter than its time step
+        rtt = std::max(rtt, dt);
+        double loss = 1 - success;
+
+        // dW/dt = 1/RTT - W^2 p / (2 RTT), the feedback delay of the losses
+        // being neglected, after a slow start ended by the first loss
+        double& window = aggregate.m_window;
+        if (aggregate.m_slowStart)
+        {
+            if (loss > 0)
+            {
+                aggregate.m_slowStart = false;
+                window /= 2;
+            }
+            else
+            {
+                window += window * dt / rtt;
+            }
+        }
+        else
+        {
+            window += dt * (1 - window * window * loss / 2) / rtt;
+        }
+        window = std::clamp(window, 1.0, m_maxWindow);
+        aggregate.m_rate = aggregate.m_count > 0 ? window * m_segmentSize / rtt : 0;
+    }
+}
+
+void
+FluidBackgroundTraffic::UpdateMaxMin()
+{
+    NS_LOG_FUNCTION(this);
+    double dt = m_timeStep.GetSeconds();
+    for (auto& link : m_links)
+    {
+        link.m_remaining = std::max(BytesPerSecond(link.m_capacity) - link.m_foreground, 0.0);
+        link.m_activeAggregates = 0;
+    }
+    for (auto& aggregate : m_aggregates)
+    {
+        aggregate.m_rate = 0;
+        aggregate.m_frozen = (aggregate.m_count == 0);
+        for (uint32_t l : aggregate.m_links)
+        {
+            m_links[l].m_activeAggregates += aggregate.m_frozen ? 0 : aggregate.m_count;
+        }
+    }
+
+    // Progressive filling: the rates of the aggregates not frozen grow
+    // together until a link is saturated or an aggregate reaches the rate
+    // of its maximum window, which freezes at least one aggregate.
+    auto demand = [this, dt](const Aggregate& aggregate) {
+        return m_maxWindow * m_segmentSize / std::max(aggregate.m_propagationRtt, dt);
+    };
+    while (true)
+    {
+        double increment = std::numeric_limits<double>::infinity();
+        for (const auto& aggregate : m_aggregates)
+        {
+            if (!aggregate.m_frozen)
+            {
+                increment = std::min(increment, demand(aggregate) - aggregate.m_rate);
+            }
+        }
+        if (increment == std::numeric_limits<double>::infinity())
+        {
+            break;
+        }
+        for (const auto& link : m_links)
+        {
+            if (link.m_activeAggregates > 0)
+            {
+                increment = std::min(increment, link.m_remaining / link.m_activeAggregates);
+            }
+        }
+
+        for (auto& aggregate : m_aggregates)
+        {
+            if (!aggregate.m_frozen)
+            {
+                aggregate.m_rate += increment;
+                for (uint32_t l : aggregate.m_links)
+                {
+                    m_links[l].m_remaining -= increment * aggregate.m_count;
+                }
+            }
+        }
+        for (auto& aggregate : m_aggregates)
+        {
+            if (aggregate.m_frozen)
+            {
+                continue;
+            }
+            aggregate.m_frozen = aggregate.m_rate >= demand(aggregate) * (1 - 1e-9);
+            for (uint32_t l : aggregate.m_links)
+            {
+                const Link& link = m_links[l];
+                aggregate.m_frozen |= link.m_remaining <= BytesPerSecond(link.m_capacity) * 1e-9;
+            }
+            if (aggregate.m_frozen)
+            {
+                for (uint32_t l : aggregate.m_links)
+                {
+                    m_links[l].m_activeAggregates -= aggregate.m_count;
+                }
+            }
+        }
+    }
+}
+
+void
+FluidBackgroundTraffic::UpdateLinks(double dt)
+{
+    NS_LOG_FUNCTION(this << dt);
+    for (auto& link : m_links)
+    {
+        link.m_arrival = 0;
+    }
+    for (const auto& aggregate : m_aggregates)
+    {
+        for (uint32_t l : aggregate.m_links)
+        {
+            m_links[l].m_arrival += aggregate.m_count * aggregate.m_rate;
+        }
+    }
+
+    double buffer = m_bufferSize.GetValue();
+    if (m_bufferSize.GetUnit() == QueueSizeUnit::PACKETS)
+    {
+        buffer *= m_segmentSize;
+    }
+    for (auto& link : m_links)
+    {
+        if (m_model == MAX_MIN)
+        {
+            link.m_departure = link.m_arrival;
+            continue;
+        }
+
+        // drop-tail queue shared with the foreground packets: the link serves
+        // the arrivals in proportion while the queue is not empty, and the
+        // excess arrivals are lost while the queue is full
+        double capacity = BytesPerSecond(link.m_capacity);
+        double input = link.m_arrival + link.m_foreground;
+        double excess = input - capacity;
+        link.m_queue = std::clamp(link.m_queue + excess * dt, 0.0, buffer);
+        link.m_loss = (link.m_queue >= buffer && excess > 0) ? excess / input : 0;
+        if (input > 0 && (link.m_queue > 0 || excess > 0))
+        {
+            link.m_departure = capacity * link.m_arrival / input;
+        }
+        else
+        {
+            link.m_departure = link.m_arrival;
+        }
+    }
+}
+
+void
+FluidBackgroundTraffic::Impose(Link& link) const
+{
+    double capacity = BytesPerSecond(link.m_capacity);
+    double left = std::max(capacity - link.m_departure, m_minCapacityShare * capacity);
+    link.m_device->SetAttribute("DataRate",
+                                DataRateValue(DataRate(static_cast<uint64_t>(left * 8))));
+    if (link.m_queueDisc)
+    {
+        link.m_queueDisc->SetExternalLoad(link.m_loss, Seconds(link.m_queue / capacity));
+    }
+}
+
+void
+FluidBackgroundTraffic::Restore(Link& link) const
+{
+    link.m_device->SetAttribute("DataRate", DataRateValue(link.m_capacity));
+    if (link.m_queueDisc)
+    {
+        link.m_queueDisc->SetExternalLoad(0, Time(0));
+    }
+}
+
+DataRate
+FluidBackgroundTraffic::GetFlowRate(uint32_t aggregate) const
+{
+    NS_ASSERT_MSG(aggregate < m_aggregates.size(), "Invalid aggregate " << aggregate);
+    return DataRate(static_cast<uint64_t>(m_aggregates[aggregate].m_rate * 8));
+}
+
+DataRate
+FluidBackgroundTraffic::GetBackgroundRate(Ptr<NetDevice> device) const
+{
+    const Link* link = FindLink(device);
+    return DataRate(link ? static_cast<uint64_t>(link->m_departure * 8) : 0);
+}
+
+Time
+FluidBackgroundTraffic::GetQueueDelay(Ptr<NetDevice> device) const
+{
+    const Link* link = FindLink(device);
+    return link ? Seconds(link->m_queue / BytesPerSecond(link->m_capacity)) : Time(0);
+}
+
+double
+FluidBackgroundTraffic::GetLossProbability(Ptr<NetDevice> device) const
+{
+    const Link* link = FindLink(device);
+    return link ? link->m_loss : 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,264 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef FLUID_BACKGROUND_TRAFFIC_H
+#define FLUID_BACKGROUND_TRAFFIC_H
+
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/queue-size.h"
+
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+
+class Node;
+class NetDevice;
+class QueueDisc;
+
+/**
+ * \ingroup internet
+ *
+ * \brief Flow-level model of background TCP traffic.
+ *
+ * Large numbers of long-lived TCP flows are costly to simulate packet by
+ * packet, while they often only matter as the load they put on the links
+ * crossed by a few flows of interest. This class models such background
+ * flows as fluids: the flows are grouped in aggregates sharing a source and
+ * a destination, the path of each aggregate is found through the IPv4
+ * routing protocols of the nodes, and the rates of the aggregates, the
+ * queues and the loss probabilities of the links are updated every time
+ * step, from the routes only, without any packet being simulated.
+ *
+ * Two models are available:
+ * - MAX_MIN: the aggregates get the max-min fair share of the capacity left
+ *   by the foreground traffic, without queueing or loss;
+ * - RENO: the window of each flow follows the fluid model of TCP Reno
+ *   (Misra, Gong and Towsley, SIGCOMM 2000), with drop-tail queues of
+ *   BufferSize per link, the rate of a flow being its window over the
+ *   round-trip time of its path, queueing delays included.
+ *
+ * The links are the NetDevices having a DataRate attribute, their
+ * propagation delay is the Delay attribute of their channel. The foreground
+ * packets sent on a link are measured by its root queue disc, and the model
+ * imposes the background load on them: the DataRate of the device is reduced
+ * to the capacity left by the background flows (never below MinCapacityShare
+ * of the capacity), and the root queue disc drops packets with the loss
+ * probability and holds them for the queueing delay of the link (see
+ * QueueDisc::SetExternalLoad). The devices and the queue discs are restored
+ * when the model is stopped.
+ *
+ * The routes are looked up when the model is started: the routing protocols
+ * must be populated by then, and UpdatePaths must be called after a change of
+ * the routes.
+ */
+class FluidBackgroundTraffic : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /// Fluid models of the background flows
+    enum Model
+    {
+        MAX_MIN, //!< Max-min fair share, without queueing or loss
+        RENO,    //!< Fluid model of TCP Reno with drop-tail queues
+    };
+
+    FluidBackgroundTraffic();
+    ~FluidBackgroundTraffic() override;
+
+    /**
+     * \brief Add an aggregate of background flows.
+     * \param source the node sending the flows
+     * \param destination the address receiving the flows
+     * \param count the number of flows
+     * \return the index of the aggregate
+     */
+    uint32_t AddFlows(Ptr<Node> source, Ipv4Address destination, uint32_t count);
+
+    /**
+     * \brief Change the number of flows of an aggregate.
+     *
+     * The windows of the flows of the aggregate are kept.
+     *
+     * \param aggregate the index of the aggregate
+     * \param count the number of flows
+     */
+    void SetFlowCount(uint32_t aggregate, uint32_t count);
+
+    /**
+     * \brief Start updating the model and imposing the background load.
+     * \param start the delay before starting
+     */
+    void Start(Time start);
+
+    /**
+     * \brief Stop updating the model and restore the devices and queue discs.
+     * \param stop the delay before stopping
+     */
+    void Stop(Time stop);
+
+    /**
+     * \brief Look up the paths of the aggregates again.
+     *
+     * The rates, windows and queues are kept for the links still in use.
+     */
+    void UpdatePaths();
+
+    /**
+     * \param aggregate the index of the aggregate
+     * \return the rate of a flow of the aggregate
+     */
+    DataRate GetFlowRate(uint32_t aggregate) const;
+
+    /**
+     * \param device the device sending on a link
+     * \return the rate of the background flows leaving the link
+     */
+    DataRate GetBackgroundRate(Ptr<NetDevice> device) const;
+
+    /**
+     * \param device the device sending on a link
+     * \return the queueing delay of the link
+     */
+    Time GetQueueDelay(Ptr<NetDevice> device) const;
+
+    /**
+     * \param device the device sending on a link
+     * \return the loss probability of the link
+     */
+    double GetLossProbability(Ptr<NetDevice> device) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief A link crossed by background flows.
+     */
+    struct Link
+    {
+        Ptr<NetDevice> m_device;        //!< Device sending on the link
+        Ptr<QueueDisc> m_queueDisc;     //!< Root queue disc of the device, if any
+        DataRate m_capacity;            //!< Original DataRate of the device
+        double m_propagationDelay{0};   //!< Delay of the channel (s)
+        double m_queue{0};              //!< Background queue (bytes)
+        double m_loss{0};               //!< Loss probability
+        double m_arrival{0};            //!< Background arrival rate (bytes/s)
+        double m_departure{0};          //!< Background departure rate (bytes/s)
+        double m_foreground{0};         //!< Average foreground rate (bytes/s)
+        uint64_t m_foregroundBytes{0};  //!< Bytes received by the queue disc so far
+        uint32_t m_activeAggregates{0}; //!< Unfrozen aggregates (max-min filling)
+        double m_remaining{0};          //!< Capacity left (max-min filling, bytes/s)
+    };
+
+    /**
+     * \brief An aggregate of flows sharing a source and a destination.
+     */
+    struct Aggregate
+    {
+        Ptr<Node> m_source;            //!< Node sending the flows
+        Ipv4Address m_destination;     //!< Address receiving the flows
+        uint32_t m_count{0};           //!< Number of flows
+        std::vector<uint32_t> m_links; //!< Indexes of the links of the path
+        double m_propagationRtt{0};    //!< Round-trip propagation delay (s)
+        double m_window{1};            //!< Window of a flow (segments)
+        bool m_slowStart{true};        //!< True until the first loss
+        double m_rate{0};              //!< Rate of a flow (bytes/s)
+        bool m_frozen{false};          //!< Rate fixed (max-min filling)
+    };
+
+    /**
+     * \brief Look up the path of an aggregate, adding its links.
+     * \param aggregate the aggregate
+     */
+    void FindPath(Aggregate& aggregate);
+
+    /**
+     * \brief Get the link sent on by a device, adding it if needed.
+     * \param device the device
+     * \return the index of the link, or -1 if the device has no DataRate
+     */
+    int32_t GetLink(Ptr<NetDevice> device);
+
+    /**
+     * \brief Find a link sent on by a device.
+     * \param device the device
+     * \return the link, or nullptr if the device is not a link of the model
+     */
+    const Link* FindLink(Ptr<NetDevice> device) const;
+
+    /// Start the model
+    void DoStart();
+    /// Stop the model
+    void DoStop();
+    /// Update the model by a time step and impose the background load
+    void Step();
+
+    /**
+     * \brief Update the rates of the aggregates with the Reno model.
+     * \param dt the time step (s)
+     */
+    void UpdateReno(double dt);
+
+    /// Update the rates of the aggregates with the max-min model
+    void UpdateMaxMin();
+
+    /**
+     * \brief Update the queues and loss probabilities of the links.
+     * \param dt the time step (s)
+     */
+    void UpdateLinks(double dt);
+
+    /**
+     * \brief Impose the background load of a link on its foreground packets.
+     * \param link the link
+     */
+    void Impose(Link& link) const;
+
+    /**
+     * \brief Restore a link as it was before the model was started.
+     * \param link the link
+     */
+    void Restore(Link& link) const;
+
+    Model m_model;                                  //!< Fluid model of the flows
+    Time m_timeStep;                                //!< Time step of the model
+    Time m_foregroundAveraging;                     //!< Averaging of the foreground rate
+    uint32_t m_segmentSize;                         //!< Segment size of the flows (bytes)
+    QueueSize m_bufferSize;                         //!< Background buffer of the links
+    double m_maxWindow;                             //!< Maximum window of a flow (segments)
+    double m_minCapacityShare;                      //!< Capacity share left to the foreground
+    std::vector<Link> m_links;                      //!< Links crossed by the aggregates
+    std::map<Ptr<NetDevice>, uint32_t> m_linkIndex; //!< Index of the link of each device
+    std::vector<Aggregate> m_aggregates;            //!< Aggregates of flows
+    bool m_running{false};                          //!< True if the model is started
+    EventId m_startEvent;                           //!< Event starting the model
+    EventId m_stopEvent;                            //!< Event stopping the model
+    EventId m_stepEvent;                            //!< Event of the next time step
+};
+
+} // namespace ns3
+
+#endif /* FLUID_BACKGROUND_TRAFFIC_H */
@@ -29,14 +29,22 @@
 #include "ipv4.h"
 
 #include "ns3/assert.h"
+#include "ns3/boolean.h"
 #include "ns3/fatal-error.h"
+#include "ns3/global-value.h"
 #include "ns3/log.h"
 #include "ns3/node-list.h"
 #include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <queue>
+#include <set>
+#include <thread>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -45,6 +53,31 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("GlobalRouteManagerImpl");
 
+/**
+ * \relates GlobalRouteManager
+ * \anchor GlobalValueGlobalRoutingThreads
+ * \brief The number of threads calculating the global routes.
+ */
+static GlobalValue g_globalRoutingThreads =
+    GlobalValue("GlobalRoutingThreads",
+                "The number of threads calculating the shortest path trees of the routers "
+                "(0 for the number of hardware threads)",
+                UintegerValue(1),
+                MakeUintegerChecker<uint32_t>());
+
+/**
+ * \relates GlobalRouteManager
+ * \anchor GlobalValueGlobalRoutingIncremental
+ * \brief A global switch to recompute only the global routes affected by a
+ * change of the topology.
+ */
+static GlobalValue g_globalRoutingIncremental =
+    GlobalValue("GlobalRoutingIncremental",
+                "A global switch to recompute only the global routes affected by a change "
+                "of the topology",
+                BooleanValue(false),
+                MakeBooleanChecker());
+
 /**
  * \brief Stream insertion operator.
  *
@@ -426,7 +459,10 @@ SPFVertex::ClearVertexProcessed()
 
 GlobalRouteManagerLSDB::GlobalRouteManagerLSDB()
     : m_database(),
-      m_extdatabase()
+      m_extdatabase(),
+      m_lsas(),
+      m_lsaIndex(),
+      m_linkDataIndex()
 {
     NS_LOG_FUNCTION(this);
 }
@@ -469,9 +505,24 @@ GlobalRouteManagerLSDB::Insert(Ipv4Address addr, GlobalRoutingLSA* lsa)
     {
         m_extdatabase.push_back(lsa);
     }
-    else
+    else if (m_database.insert(LSDBPair_t(addr, lsa)).second)
     {
-        m_database.insert(LSDBPair_t(addr, lsa));
+        m_lsaIndex[addr] = m_lsas.size();
+        m_lsas.push_back(lsa);
+        for (uint32_t j = 0; j < lsa->GetNLinkRecords(); j++)
+        {
+            GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+            if (lr->GetLinkType() != GlobalRoutingLinkRecord::TransitNetwork)
+            {
+                continue;
+            }
+            // keep the LSA which comes first in the database
+            GlobalRoutingLSA*& indexed = m_linkDataIndex[lr->GetLinkData()];
+            if (indexed == nullptr || addr < indexed->GetLinkStateId())
+            {
+                indexed = lsa;
+            }
+        }
     }
 }
 
@@ -496,14 +547,12 @@ GlobalRouteManagerLSDB::GetLSA(Ipv4Address addr) const
     //
     // Look up an LSA by its address.
     //
-    for (auto i = m_database.begin(); i != m_database.end(); i++)
+    auto i = m_lsaIndex.find(addr);
+    if (i == m_lsaIndex.end())
     {
-        if (i->first == addr)
-        {
-            return i->second;
-        }
+        return nullptr;
     }
-    return nullptr;
+    return m_lsas[i->second];
 }
 
 GlobalRoutingLSA*
@@ -511,23 +560,40 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this << addr);
     //
-    // Look up an LSA by its address.
+    // Look up an LSA by the link data of its TransitNetwork link records.
     //
-    for (auto i = m_database.begin(); i != m_database.end(); i++)
+    auto i = m_linkDataIndex.find(addr);
+    if (i == m_linkDataIndex.end())
     {
-        GlobalRoutingLSA* temp = i->second;
-        // Iterate among temp's Link Records
-        for (uint32_t j = 0; j < temp->GetNLinkRecords(); j++)
-        {
-            GlobalRoutingLinkRecord* lr = temp->GetLinkRecord(j);
-            if (lr->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork &&
-                lr->GetLinkData() == addr)
-            {
-                return temp;
-            }
-        }
+        return nullptr;
     }
-    return nullptr;
+    return i->second;
+}
+
+uint32_t
+GlobalRouteManagerLSDB::GetNumLSAs() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_lsas.size();
+}
+
+uint32_t
+GlobalRouteManagerLSDB::GetLSAIndex(Ipv4Address addr) const
+{
+    NS_LOG_FUNCTION(this << addr);
+    auto i = m_lsaIndex.find(addr);
+    if (i == m_lsaIndex.end())
+    {
+        return m_lsas.size();
+    }
+    return i->second;
+}
+
+GlobalRoutingLSA*
+GlobalRouteManagerLSDB::GetLSAByIndex(uint32_t index) const
+{
+    NS_LOG_FUNCTION(this << index);
+    return m_lsas.at(index);
 }
 
 // ---------------------------------------------------------------------------
@@ -537,16 +603,27 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 // ---------------------------------------------------------------------------
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl()
-    : m_spfroot(nullptr)
+    : m_spfroot(nullptr),
+      m_spfDistances(nullptr),
+      m_ownLsdb(true)
 {
     NS_LOG_FUNCTION(this);
     m_lsdb = new GlobalRouteManagerLSDB();
 }
 
+GlobalRouteManagerImpl::GlobalRouteManagerImpl(GlobalRouteManagerLSDB* lsdb)
+    : m_spfroot(nullptr),
+      m_spfDistances(nullptr),
+      m_lsdb(lsdb),
+      m_ownLsdb(false)
+{
+    NS_LOG_FUNCTION(this << lsdb);
+}
+
 GlobalRouteManagerImpl::~GlobalRouteManagerImpl()
 {
     NS_LOG_FUNCTION(this);
-    if (m_lsdb)
+    if (m_lsdb && m_ownLsdb)
     {
         delete m_lsdb;
     }
@@ -556,17 +633,28 @@ void
 GlobalRouteManagerImpl::DebugUseLsdb(GlobalRouteManagerLSDB* lsdb)
 {
     NS_LOG_FUNCTION(this << lsdb);
-    if (m_lsdb)
+    if (m_lsdb && m_ownLsdb)
     {
         delete m_lsdb;
     }
     m_lsdb = lsdb;
+    m_ownLsdb = true;
+    m_distances.clear();
+}
+
+GlobalRouteManager::Statistics
+GlobalRouteManagerImpl::GetStatistics() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_statistics;
 }
 
 void
 GlobalRouteManagerImpl::DeleteGlobalRoutes()
 {
     NS_LOG_FUNCTION(this);
+    SystemWallClockMs clock;
+    clock.Start();
     for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
     {
         Ptr<Node> node = *i;
@@ -575,19 +663,8 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes()
         {
             continue;
         }
-        Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-        uint32_t j = 0;
-        uint32_t nRoutes = gr->GetNRoutes();
-        NS_LOG_LOGIC("Deleting " << gr->GetNRoutes() << " routes from node " << node->GetId());
-        // Each time we delete route 0, the route index shifts downward
-        // We can delete all routes if we delete the route numbered 0
-        // nRoutes times
-        for (j = 0; j < nRoutes; j++)
-        {
-            NS_LOG_LOGIC("Deleting global route " << j << " from node " << node->GetId());
-            gr->RemoveRoute(0);
-        }
-        NS_LOG_LOGIC("Deleted " << j << " global routes from node " << node->GetId());
+        NS_LOG_LOGIC("Deleting global routes from node " << node->GetId());
+        DeleteRoutes(router->GetRoutingProtocol());
     }
     if (m_lsdb)
     {
@@ -595,6 +672,27 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes()
         delete m_lsdb;
         m_lsdb = new GlobalRouteManagerLSDB();
     }
+    m_distances.clear();
+    m_statistics.deleteTime = clock.End();
+    NS_LOG_INFO("Deleted global routes in " << m_statistics.deleteTime << " ms");
+}
+
+void
+GlobalRouteManagerImpl::DeleteRoutes(Ptr<Ipv4GlobalRouting> routing)
+{
+    NS_LOG_FUNCTION(routing);
+    uint32_t j = 0;
+    uint32_t nRoutes = routing->GetNRoutes();
+    NS_LOG_LOGIC("Deleting " << nRoutes << " routes");
+    // Each time we delete route 0, the route index shifts downward
+    // We can delete all routes if we delete the route numbered 0
+    // nRoutes times
+    for (j = 0; j < nRoutes; j++)
+    {
+        NS_LOG_LOGIC("Deleting global route " << j);
+        routing->RemoveRoute(0);
+    }
+    NS_LOG_LOGIC("Deleted " << j << " global routes");
 }
 
 //
@@ -610,6 +708,8 @@ void
 GlobalRouteManagerImpl::BuildGlobalRoutingDatabase()
 {
     NS_LOG_FUNCTION(this);
+    SystemWallClockMs clock;
+    clock.Start();
     //
     // Walk the list of nodes looking for the GlobalRouter Interface.  Nodes with
     // global router interfaces are, not too surprisingly, our routers.
@@ -653,6 +753,8 @@ GlobalRouteManagerImpl::BuildGlobalRoutingDatabase()
             m_lsdb->Insert(lsa->GetLinkStateId(), lsa);
         }
     }
+    m_statistics.databaseTime = clock.End();
+    NS_LOG_INFO("Built the global routing database in " << m_statistics.databaseTime << " ms");
 }
 
 //
@@ -692,10 +794,26 @@ void
 GlobalRouteManagerImpl::InitializeRoutes()
 {
     NS_LOG_FUNCTION(this);
+    SystemWallClockMs clock;
+    clock.Start();
+    NS_LOG_INFO("About to start SPF calculation");
+    std::vector<SPFRoot> roots = GetSPFRoots();
+    m_distances.clear();
+    CalculateRoutes(roots);
+    m_statistics.spfTime = clock.End();
+    m_statistics.nRouters = roots.size();
+    m_statistics.nCalculated = roots.size();
+    NS_LOG_INFO("Finished SPF calculation in " << m_statistics.spfTime << " ms");
+}
+
+std::vector<GlobalRouteManagerImpl::SPFRoot>
+GlobalRouteManagerImpl::GetSPFRoots() const
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<SPFRoot> roots;
     //
     // Walk the list of nodes in the system.
     //
-    NS_LOG_INFO("About to start SPF calculation");
     for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
     {
         Ptr<Node> node = *i;
@@ -718,10 +836,521 @@ GlobalRouteManagerImpl::InitializeRoutes()
         //
         if (rtr && rtr->GetNumLSAs())
         {
-            SPFCalculate(rtr->GetRouterId());
+            roots.push_back(
+                {rtr->GetRouterId(), node->GetObject<Ipv4>(), rtr->GetRoutingProtocol()});
+        }
+    }
+    return roots;
+}
+
+void
+GlobalRouteManagerImpl::CalculateRoutes(const std::vector<SPFRoot>& roots)
+{
+    NS_LOG_FUNCTION(this << roots.size());
+    BooleanValue incremental;
+    g_globalRoutingIncremental.GetValue(incremental);
+    //
+    // In incremental mode, the distances of the LSAs from each root are kept
+    // to find out later which trees are affected by a change of the LSDB.  The
+    // entries are all inserted before taking their addresses, since an
+    // insertion may move the values of the map.
+    //
+    std::vector<std::vector<uint32_t>*> distances(roots.size(), nullptr);
+    if (incremental.Get())
+    {
+        for (const auto& root : roots)
+        {
+            m_distances[root.routerId];
+        }
+        for (std::size_t i = 0; i < roots.size(); i++)
+        {
+            distances[i] = &m_distances[roots[i].routerId];
+        }
+    }
+
+    UintegerValue threads;
+    g_globalRoutingThreads.GetValue(threads);
+    std::size_t nThreads = threads.Get();
+    if (nThreads == 0)
+    {
+        nThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    nThreads = std::min(nThreads, roots.size());
+    if (nThreads <= 1)
+    {
+        for (std::size_t i = 0; i < roots.size(); i++)
+        {
+            m_spfDistances = distances[i];
+            SPFCalculate(roots[i]);
+        }
+        m_spfDistances = nullptr;
+        return;
+    }
+    //
+    // The workers share the LSDB, which they only read, and keep the state of
+    // their SPF calculations for themselves.  Each root is calculated by a
+    // single worker, which is then the only one to access the objects of the
+    // root node.
+    //
+    NS_LOG_LOGIC("Calculating " << roots.size() << " SPF trees with " << nThreads << " threads");
+    std::atomic<std::size_t> next{0};
+    auto work = [this, &roots, &distances, &next]() {
+        GlobalRouteManagerImpl worker(m_lsdb);
+        for (std::size_t i = next++; i < roots.size(); i = next++)
+        {
+            worker.m_spfDistances = distances[i];
+            worker.SPFCalculate(roots[i]);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < nThreads; i++)
+    {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * \brief Get the contents of a link record, for comparisons
+ * \param lr the link record
+ * \return the type, link ID, link data and metric of the record
+ */
+static std::tuple<int, Ipv4Address, Ipv4Address, uint16_t>
+GetLinkRecordKey(const GlobalRoutingLinkRecord* lr)
+{
+    return std::make_tuple(lr->GetLinkType(), lr->GetLinkId(), lr->GetLinkData(), lr->GetMetric());
+}
+
+/**
+ * \brief Test whether two LSAs have the same contents
+ * \param a the first LSA
+ * \param b the second LSA
+ * \return true if the LSAs have the same contents
+ */
+static bool
+IsSameLSA(const GlobalRoutingLSA* a, const GlobalRoutingLSA* b)
+{
+    if (a->GetLSType() != b->GetLSType() || a->GetLinkStateId() != b->GetLinkStateId() ||
+        a->GetAdvertisingRouter() != b->GetAdvertisingRouter() ||
+        a->GetNetworkLSANetworkMask() != b->GetNetworkLSANetworkMask() ||
+        a->GetNLinkRecords() != b->GetNLinkRecords() ||
+        a->GetNAttachedRouters() != b->GetNAttachedRouters())
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < a->GetNLinkRecords(); i++)
+    {
+        if (GetLinkRecordKey(a->GetLinkRecord(i)) != GetLinkRecordKey(b->GetLinkRecord(i)))
+        {
+            return false;
         }
     }
-    NS_LOG_INFO("Finished SPF calculation");
+    for (uint32_t i = 0; i < a->GetNAttachedRouters(); i++)
+    {
+        if (a->GetAttachedRouter(i) != b->GetAttachedRouter(i))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+GlobalRouteManagerImpl::GetLSAChanges(const GlobalRouteManagerLSDB& oldLsdb,
+                                      const GlobalRouteManagerLSDB& newLsdb,
+                                      std::vector<LSAChange>& changes)
+{
+    NS_LOG_FUNCTION(&oldLsdb << &newLsdb);
+    if (oldLsdb.GetNumLSAs() != newLsdb.GetNumLSAs() ||
+        oldLsdb.GetNumExtLSAs() != newLsdb.GetNumExtLSAs())
+    {
+        NS_LOG_LOGIC("The number of LSAs has changed");
+        return false;
+    }
+    for (uint32_t i = 0; i < oldLsdb.GetNumExtLSAs(); i++)
+    {
+        if (!IsSameLSA(oldLsdb.GetExtLSA(i), newLsdb.GetExtLSA(i)))
+        {
+            NS_LOG_LOGIC("An external LSA has changed");
+            return false;
+        }
+    }
+    auto compare = [](const GlobalRoutingLinkRecord* a, const GlobalRoutingLinkRecord* b) {
+        return GetLinkRecordKey(a) < GetLinkRecordKey(b);
+    };
+    for (uint32_t i = 0; i < oldLsdb.GetNumLSAs(); i++)
+    {
+        GlobalRoutingLSA* oldLsa = oldLsdb.GetLSAByIndex(i);
+        GlobalRoutingLSA* newLsa = newLsdb.GetLSAByIndex(i);
+        if (IsSameLSA(oldLsa, newLsa))
+        {
+            continue;
+        }
+        if (oldLsa->GetLinkStateId() != newLsa->GetLinkStateId() ||
+            oldLsa->GetLSType() != GlobalRoutingLSA::RouterLSA ||
+            newLsa->GetLSType() != GlobalRoutingLSA::RouterLSA)
+        {
+            NS_LOG_LOGIC("LSA " << oldLsa->GetLinkStateId() << " cannot be updated");
+            return false;
+        }
+        std::vector<GlobalRoutingLinkRecord*> oldRecords;
+        for (uint32_t j = 0; j < oldLsa->GetNLinkRecords(); j++)
+        {
+            oldRecords.push_back(oldLsa->GetLinkRecord(j));
+        }
+        std::vector<GlobalRoutingLinkRecord*> newRecords;
+        for (uint32_t j = 0; j < newLsa->GetNLinkRecords(); j++)
+        {
+            newRecords.push_back(newLsa->GetLinkRecord(j));
+        }
+        std::stable_sort(oldRecords.begin(), oldRecords.end(), compare);
+        std::stable_sort(newRecords.begin(), newRecords.end(), compare);
+        LSAChange change{i, oldLsa, {}, {}};
+        std::set_difference(oldRecords.begin(),
+                            oldRecords.end(),
+                            newRecords.begin(),
+                            newRecords.end(),
+                            std::back_inserter(change.removed),
+                            compare);
+        std::set_difference(newRecords.begin(),
+                            newRecords.end(),
+                            oldRecords.begin(),
+                            oldRecords.end(),
+                            std::back_inserter(change.added),
+                            compare);
+        for (const auto records : {&change.removed, &change.added})
+        {
+            for (const auto lr : *records)
+            {
+                if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint &&
+                    lr->GetLinkType() != GlobalRoutingLinkRecord::StubNetwork)
+                {
+                    NS_LOG_LOGIC("A link of LSA " << oldLsa->GetLinkStateId()
+                                                  << " to a transit network has changed");
+                    return false;
+                }
+            }
+        }
+        changes.push_back(change);
+    }
+    return true;
+}
+
+void
+GlobalRouteManagerImpl::RecomputeRoutes()
+{
+    NS_LOG_FUNCTION(this);
+    m_statistics = GlobalRouteManager::Statistics();
+    BooleanValue incremental;
+    g_globalRoutingIncremental.GetValue(incremental);
+    if (!incremental.Get() || m_distances.empty())
+    {
+        DeleteGlobalRoutes();
+        BuildGlobalRoutingDatabase();
+        InitializeRoutes();
+        return;
+    }
+    //
+    // Build the new LSDB, and compare it with the one the current routes have
+    // been calculated from.
+    //
+    GlobalRouteManagerLSDB* oldLsdb = m_lsdb;
+    m_lsdb = new GlobalRouteManagerLSDB();
+    BuildGlobalRoutingDatabase();
+
+    SystemWallClockMs clock;
+    clock.Start();
+    std::vector<LSAChange> changes;
+    if (!GetLSAChanges(*oldLsdb, *m_lsdb, changes))
+    {
+        NS_LOG_INFO("Recomputing all the routes");
+        delete oldLsdb;
+        m_statistics.compareTime = clock.End();
+        clock.Start();
+        for (const auto& root : GetSPFRoots())
+        {
+            DeleteRoutes(root.routing);
+        }
+        m_statistics.deleteTime = clock.End();
+        InitializeRoutes();
+        return;
+    }
+    //
+    // Mark the LSAs which have changed or are the target of a changed link,
+    // and collect the point-to-point links which have been removed or added.
+    //
+    uint32_t nLSAs = m_lsdb->GetNumLSAs();
+    std::vector<bool> touched(nLSAs, false);
+    std::vector<SPFLink> removed;
+    std::vector<SPFLink> added;
+    for (const auto& change : changes)
+    {
+        touched[change.index] = true;
+        for (const auto lr : change.removed)
+        {
+            uint32_t target = m_lsdb->GetLSAIndex(lr->GetLinkId());
+            if (lr->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint && target < nLSAs)
+            {
+                touched[target] = true;
+                removed.emplace_back(change.index, target, lr->GetMetric());
+            }
+        }
+        for (const auto lr : change.added)
+        {
+            uint32_t target = m_lsdb->GetLSAIndex(lr->GetLinkId());
+            if (lr->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint && target < nLSAs)
+            {
+                touched[target] = true;
+                added.emplace_back(change.index, target, lr->GetMetric());
+            }
+        }
+    }
+    //
+    // Collect the links of the new LSDB towards the targets of the removed
+    // links.
+    //
+    std::vector<SPFLink> remaining;
+    if (!removed.empty())
+    {
+        std::vector<bool> isTarget(nLSAs, false);
+        for (const auto& link : removed)
+        {
+            isTarget[std::get<1>(link)] = true;
+        }
+        for (uint32_t i = 0; i < nLSAs; i++)
+        {
+            GlobalRoutingLSA* lsa = m_lsdb->GetLSAByIndex(i);
+            for (uint32_t j = 0; j < lsa->GetNLinkRecords(); j++)
+            {
+                GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+                if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
+                {
+                    continue;
+                }
+                uint32_t target = m_lsdb->GetLSAIndex(lr->GetLinkId());
+                if (target < nLSAs && isTarget[target])
+                {
+                    remaining.emplace_back(i, target, lr->GetMetric());
+                }
+            }
+        }
+    }
+    m_statistics.compareTime = clock.End();
+    NS_LOG_INFO(changes.size() << " router LSAs have changed");
+    //
+    // Update the routes of the routers whose shortest path tree is not
+    // affected by the changes, and delete the routes of the others.
+    //
+    clock.Start();
+    std::vector<SPFRoot> roots = GetSPFRoots();
+    std::vector<SPFRoot> affected;
+    for (const auto& root : roots)
+    {
+        auto found = m_distances.find(root.routerId);
+        if (found == m_distances.end() ||
+            IsTreeAffected(root,
+                           m_lsdb->GetLSAIndex(root.routerId),
+                           found->second,
+                           touched,
+                           removed,
+                           added,
+                           remaining,
+                           *oldLsdb) ||
+            (!found->second.empty() && !UpdateRoutes(root, found->second, changes)))
+        {
+            DeleteRoutes(root.routing);
+            affected.push_back(root);
+        }
+        else
+        {
+            m_statistics.nUpdated++;
+        }
+    }
+    m_statistics.updateTime = clock.End();
+    //
+    // Calculate the shortest path trees of the affected routers.
+    //
+    clock.Start();
+    CalculateRoutes(affected);
+    m_statistics.spfTime = clock.End();
+    m_statistics.nRouters = roots.size();
+    m_statistics.nCalculated = affected.size();
+    delete oldLsdb;
+    NS_LOG_INFO("Calculated " << affected.size() << " of " << roots.size() << " SPF trees in "
+                              << m_statistics.spfTime << " ms");
+}
+
+bool
+GlobalRouteManagerImpl::IsTreeAffected(const SPFRoot& root,
+                                       uint32_t index,
+                                       const std::vector<uint32_t>& distances,
+                                       const std::vector<bool>& touched,
+                                       const std::vector<SPFLink>& removed,
+                                       const std::vector<SPFLink>& added,
+                                       const std::vector<SPFLink>& remaining,
+                                       const GlobalRouteManagerLSDB& oldLsdb) const
+{
+    NS_LOG_FUNCTION(this << index);
+    //
+    // The tree of a router is affected by a change of its own LSA, or of the
+    // links of its neighbors towards it, from which the next hops are taken.
+    // The default route of a stub router depends on nothing else.
+    //
+    if (touched[index] || distances.empty())
+    {
+        return touched[index];
+    }
+    //
+    // The tree is affected by the addition of a link making a path at least
+    // as short.
+    //
+    for (const auto& [from, to, metric] : added)
+    {
+        if (distances[from] != SPF_INFINITY &&
+            (distances[to] == SPF_INFINITY || distances[from] + metric <= distances[to]))
+        {
+            return true;
+        }
+    }
+    //
+    // The next hops of the router towards an LSA are those of the host routes
+    // to the first point-to-point address of its previous version.
+    //
+    typedef std::set<std::pair<Ipv4Address, uint32_t>> Exits;
+    auto getExits = [&root, &oldLsdb](uint32_t lsaIndex, Exits& exits) {
+        GlobalRoutingLSA* lsa = oldLsdb.GetLSAByIndex(lsaIndex);
+        for (uint32_t j = 0; j < lsa->GetNLinkRecords(); j++)
+        {
+            GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+            if (lr->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint)
+            {
+                for (const auto& route : root.routing->GetHostRoutesTo(lr->GetLinkData()))
+                {
+                    exits.emplace(route.GetGateway(), route.GetInterface());
+                }
+                return !exits.empty();
+            }
+        }
+        return false;
+    };
+    //
+    // The removal of a link on a shortest path is harmless if its target
+    // keeps other parents at the same distance, which together provide the
+    // same next hops, as the next hops of equal cost paths are merged.  By
+    // induction on the distance, no other vertex is then affected.
+    //
+    for (const auto& [from, to, metric] : removed)
+    {
+        if (distances[from] == SPF_INFINITY || distances[from] + metric != distances[to])
+        {
+            continue;
+        }
+        Exits exits;
+        Exits parentExits;
+        bool found = false;
+        for (const auto& [parent, target, parentMetric] : remaining)
+        {
+            if (target != to || distances[parent] == SPF_INFINITY ||
+                distances[parent] + parentMetric != distances[to])
+            {
+                continue;
+            }
+            if (parent == index || !getExits(parent, parentExits))
+            {
+                return true;
+            }
+            found = true;
+        }
+        if (!found || !getExits(to, exits) || exits != parentExits)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+GlobalRouteManagerImpl::UpdateRoutes(const SPFRoot& root,
+                                     const std::vector<uint32_t>& distances,
+                                     const std::vector<LSAChange>& changes)
+{
+    NS_LOG_FUNCTION(this << root.routerId);
+    Ptr<Ipv4GlobalRouting> gr = root.routing;
+    //
+    // Find the next hops towards the advertising routers of the changed LSAs
+    // first, so that nothing is modified if one of them is missing.
+    //
+    std::vector<std::pair<const LSAChange*, std::vector<Ipv4RoutingTableEntry>>> exits;
+    for (const auto& change : changes)
+    {
+        if (distances[change.index] == SPF_INFINITY)
+        {
+            continue;
+        }
+        std::vector<Ipv4RoutingTableEntry> routes;
+        for (uint32_t j = 0; j < change.oldLsa->GetNLinkRecords(); j++)
+        {
+            GlobalRoutingLinkRecord* lr = change.oldLsa->GetLinkRecord(j);
+            if (lr->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint)
+            {
+                routes = gr->GetHostRoutesTo(lr->GetLinkData());
+                break;
+            }
+        }
+        if (routes.empty())
+        {
+            NS_LOG_LOGIC("No next hop from " << root.routerId << " towards "
+                                             << change.oldLsa->GetLinkStateId());
+            return false;
+        }
+        exits.emplace_back(&change, std::move(routes));
+    }
+    for (const auto& [change, routes] : exits)
+    {
+        for (const auto lr : change->removed)
+        {
+            Ipv4Mask mask(lr->GetLinkData().Get());
+            for (const auto& route : routes)
+            {
+                if (lr->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint)
+                {
+                    gr->RemoveHostRouteTo(lr->GetLinkData(),
+                                          route.GetGateway(),
+                                          route.GetInterface());
+                }
+                else
+                {
+                    gr->RemoveNetworkRouteTo(lr->GetLinkId().CombineMask(mask),
+                                             mask,
+                                             route.GetGateway(),
+                                             route.GetInterface());
+                }
+            }
+        }
+        for (const auto lr : change->added)
+        {
+            Ipv4Mask mask(lr->GetLinkData().Get());
+            for (const auto& route : routes)
+            {
+                if (lr->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint)
+                {
+                    gr->AddHostRouteTo(lr->GetLinkData(), route.GetGateway(), route.GetInterface());
+                }
+                else
+                {
+                    gr->AddNetworkRouteTo(lr->GetLinkId().CombineMask(mask),
+                                          mask,
+                                          route.GetGateway(),
+                                          route.GetInterface());
+                }
+            }
+        }
+    }
+    return true;
 }
 
 //
@@ -821,13 +1450,19 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
 
         // Note:  w_lsa at this point may be either RouterLSA or NetworkLSA
         //
+        // The SPF status of the LSAs is kept by this calculation rather than in
+        // the (shared) LSAs themselves.
+        //
+        GlobalRoutingLSA::SPFStatus& w_status =
+            m_lsaStatus[m_lsdb->GetLSAIndex(w_lsa->GetLinkStateId())];
+        //
         // (c) If vertex W is already on the shortest-path tree, examine the next
         // link in the LSA.
         //
         // If the link is to a router that is already in the shortest path first tree
         // then we have it covered -- ignore it.
         //
-        if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE)
+        if (w_status == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE)
         {
             NS_LOG_LOGIC("Skipping ->  LSA " << w_lsa->GetLinkStateId() << " already in SPF tree");
             continue;
@@ -851,7 +1486,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
         NS_LOG_LOGIC("Considering w_lsa " << w_lsa->GetLinkStateId());
 
         // Is there already vertex w in candidate list?
-        if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
+        if (w_status == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
         {
             // Calculate nexthop to w
             // We need to figure out how to actually get to the new router represented
@@ -863,7 +1498,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
             w = new SPFVertex(w_lsa);
             if (SPFNexthopCalculation(v, w, l, distance))
             {
-                w_lsa->SetStatus(GlobalRoutingLSA::LSA_SPF_CANDIDATE);
+                w_status = GlobalRoutingLSA::LSA_SPF_CANDIDATE;
                 //
                 // Push this new vertex onto the priority queue (ordered by distance from the
                 // root node).
@@ -880,7 +1515,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
                                   << "return false, but it does now!");
             }
         }
-        else if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_CANDIDATE)
+        else if (w_status == GlobalRoutingLSA::LSA_SPF_CANDIDATE)
         {
             //
             // We have already considered the link represented by <w>.  What wse have to
@@ -1303,9 +1938,7 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
                 if (lr->GetLinkId() == myRouterId)
                 {
                     // Next hop is stored in the LinkID field of lr
-                    Ptr<GlobalRouter> router = rlsa->GetNode()->GetObject<GlobalRouter>();
-                    NS_ASSERT(router);
-                    Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
+                    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
                     NS_ASSERT(gr);
                     gr->AddNetworkRouteTo(Ipv4Address("0.0.0.0"),
                                           Ipv4Mask("0.0.0.0"),
@@ -1323,17 +1956,46 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
     return false;
 }
 
-// quagga ospf_spf_calculate
 void
 GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
 {
     NS_LOG_FUNCTION(this << root);
 
+    SPFRoot spfRoot;
+    spfRoot.routerId = root;
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter>();
+        if (rtr && rtr->GetRouterId() == root)
+        {
+            spfRoot.ipv4 = (*i)->GetObject<Ipv4>();
+            spfRoot.routing = rtr->GetRoutingProtocol();
+            break;
+        }
+    }
+    SPFCalculate(spfRoot);
+}
+
+// quagga ospf_spf_calculate
+void
+GlobalRouteManagerImpl::SPFCalculate(const SPFRoot& spfRoot)
+{
+    NS_LOG_FUNCTION(this << spfRoot.routerId);
+
+    Ipv4Address root = spfRoot.routerId;
+    m_spfrootIpv4 = spfRoot.ipv4;
+    m_spfrootRouting = spfRoot.routing;
+
     SPFVertex* v;
     //
-    // Initialize the Link State Database.
+    // Initialize the SPF status of the LSAs (and the recorded distances, if any).
+    // The LSDB itself is not modified, so that several calculations can share it.
     //
-    m_lsdb->Initialize();
+    m_lsaStatus.assign(m_lsdb->GetNumLSAs(), GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED);
+    if (m_spfDistances)
+    {
+        m_spfDistances->assign(m_lsdb->GetNumLSAs(), SPF_INFINITY);
+    }
     //
     // The candidate queue is a priority queue of SPFVertex objects, with the top
     // of the queue being the closest vertex in terms of distance from the root
@@ -1353,7 +2015,7 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     //
     m_spfroot = v;
     v->SetDistanceFromRoot(0);
-    v->GetLSA()->SetStatus(GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
+    SetInSPFTree(v);
     NS_LOG_LOGIC("Starting SPFCalculate for node " << root);
 
     //
@@ -1363,10 +2025,17 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     // reached.  Instead, short-circuit this computation and just install
     // a default route in the CheckForStubNode() method.
     //
-    if (NodeList::GetNNodes() > 0 && CheckForStubNode(root))
+    if (m_spfrootRouting && CheckForStubNode(root))
     {
         NS_LOG_LOGIC("SPFCalculate truncated for stub node " << root);
+        if (m_spfDistances)
+        {
+            m_spfDistances->clear();
+        }
         delete m_spfroot;
+        m_spfroot = nullptr;
+        m_spfrootIpv4 = nullptr;
+        m_spfrootRouting = nullptr;
         return;
     }
 
@@ -1414,7 +2083,7 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
         // Update the status field of the vertex to indicate that it is in the SPF
         // tree.
         //
-        v->GetLSA()->SetStatus(GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
+        SetInSPFTree(v);
         //
         // The current vertex has a parent pointer.  By calling this rather oddly
         // named method (blame quagga) we add the current vertex to the list of
@@ -1488,6 +2157,20 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     //
     delete m_spfroot;
     m_spfroot = nullptr;
+    m_spfrootIpv4 = nullptr;
+    m_spfrootRouting = nullptr;
+}
+
+void
+GlobalRouteManagerImpl::SetInSPFTree(SPFVertex* v)
+{
+    NS_LOG_FUNCTION(this << v);
+    uint32_t index = m_lsdb->GetLSAIndex(v->GetLSA()->GetLinkStateId());
+    m_lsaStatus[index] = GlobalRoutingLSA::LSA_SPF_IN_SPFTREE;
+    if (m_spfDistances)
+    {
+        (*m_spfDistances)[index] = v->GetDistanceFromRoot();
+    }
 }
 
 void
@@ -1540,107 +2223,50 @@ GlobalRouteManagerImpl::SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v)
     NS_LOG_LOGIC("External is on remote host: " << extlsa->GetAdvertisingRouter()
                                                 << "; installing");
 
+    //
+    // The root of the Shortest Path First tree is the router to which we are
+    // going to write the actual routing table entries.  Its global routing
+    // protocol has been looked up when the calculation started.
+    //
     Ipv4Address routerId = m_spfroot->GetVertexId();
 
     NS_LOG_LOGIC("Vertex ID = " << routerId);
-    //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
-    //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    if (!m_spfrootRouting)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        NS_LOG_LOGIC("Can't find root node " << routerId);
+        return;
+    }
+    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+    NS_LOG_LOGIC("Setting routes for router " << routerId);
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFAddASExternal (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = extlsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
+
+    // walk through all next-hop-IPs and out-going-interfaces for reaching
+    // the stub network gateway 'v' from the root node
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
+    {
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            gr->AddASExternalRouteTo(tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Router " << routerId
+                                   << " add external network route to " << tempip
+                                   << " using next hop " << nextHop << " via interface " << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = extlsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddASExternalRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add external network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+            NS_LOG_LOGIC("(Route " << i << ") Router " << routerId
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative");
+        }
+    }
 }
 
 // Processing logic from RFC 2328, page 166 and quagga ospf_spf_process_stubs ()
@@ -1699,118 +2325,58 @@ GlobalRouteManagerImpl::SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v
     NS_LOG_LOGIC("Stub is on remote host: " << v->GetVertexId() << "; installing");
     //
     // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // going to write the actual routing table entries.  Its global routing
+    // protocol has been looked up when the calculation started.
     //
     Ipv4Address routerId = m_spfroot->GetVertexId();
 
     NS_LOG_LOGIC("Vertex ID = " << routerId);
+    if (!m_spfrootRouting)
+    {
+        NS_LOG_LOGIC("Can't find root node " << routerId);
+        return;
+    }
+    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+    NS_LOG_LOGIC("Setting routes for router " << routerId);
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFIntraAddStub (): "
+                  "Expected valid LSA in SPFVertex* v");
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // The stub network record holds the network number in its link ID and
+    // the network mask in its link data.
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
-    {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+    Ipv4Mask tempmask(l->GetLinkData().Get());
+    Ipv4Address tempip = l->GetLinkId();
+    tempip = tempip.CombineMask(tempmask);
 
-        if (!rtr)
+    // walk through all next-hop-IPs and out-going-interfaces for reaching
+    // the stub network gateway 'v' from the root node
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
+    {
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Router " << routerId << " add network route to "
+                                   << tempip << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask(l->GetLinkData().Get());
-            Ipv4Address tempip = l->GetLinkId();
-            tempip = tempip.CombineMask(tempmask);
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+            NS_LOG_LOGIC("(Route " << i << ") Router " << routerId
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative");
+        }
+    }
 }
 
 //
 // Return the interface number corresponding to a given IP address and mask
-// This is a wrapper around GetInterfaceForPrefix(), but we first
-// have to find the right node pointer to pass to that function.
+// This is a wrapper around GetInterfaceForPrefix(), called on the Ipv4
+// of the root of the SPF tree.
 // If no such interface is found, return -1 (note:  unit test framework
 // for routing assumes -1 to be a legal return value)
 //
@@ -1819,67 +2385,31 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId(Ipv4Address a, Ipv4Mask amask)
 {
     NS_LOG_FUNCTION(this << a << amask);
     //
-    // We have an IP address <a> and a vertex ID of the root of the SPF tree.
-    // The question is what interface index does this address correspond to.
-    // The answer is a little complicated since we have to find a pointer to
-    // the node corresponding to the vertex ID, find the Ipv4 interface on that
-    // node in order to iterate the interfaces and find the one corresponding to
-    // the address in question.
+    // We have got an IP address for a link on a router.  The Ipv4 interface of
+    // the root of the SPF tree has been looked up when the calculation started;
+    // we ask it for the interface associated with the address.
     //
     Ipv4Address routerId = m_spfroot->GetVertexId();
+    if (!m_spfrootIpv4)
+    {
+        NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node " << routerId);
+        return -1;
+    }
     //
-    // Walk the list of nodes in the system looking for the one corresponding to
-    // the node at the root of the SPF tree.  This is the node for which we are
-    // building the routing table.
+    // Look through the interfaces on this node for one that has the IP address
+    // we're looking for.  If we find one, return the corresponding interface
+    // index, or -1 if not found.
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
-    {
-        Ptr<Node> node = *i;
-
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-        //
-        // If the node doesn't have a GlobalRouter interface it can't be the one
-        // we're interested in.
-        //
-        if (!rtr)
-        {
-            continue;
-        }
-
-        if (rtr->GetRouterId() == routerId)
-        {
-            //
-            // This is the node we're building the routing table for.  We're going to need
-            // the Ipv4 interface to look for the ipv4 interface index.  Since this node
-            // is participating in routing IP version 4 packets, it certainly must have
-            // an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Look through the interfaces on this node for one that has the IP address
-            // we're looking for.  If we find one, return the corresponding interface
-            // index, or -1 if not found.
-            //
-            int32_t interface = ipv4->GetInterfaceForPrefix(a, amask);
+    int32_t interface = m_spfrootIpv4->GetInterfaceForPrefix(a, amask);
 
 #if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif
-            return interface;
-        }
+    if (interface < 0)
+    {
+        NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
+                        "Expected an interface associated with address a:" << a);
     }
-    //
-    // Couldn't find it.
-    //
-    NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node " << routerId);
-    return -1;
+#endif
+    return interface;
 }
 
 //
@@ -1906,137 +2436,88 @@ GlobalRouteManagerImpl::SPFIntraAddRouter(SPFVertex* v)
     NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
     //
     // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // going to write the actual routing table entries.  Its global routing
+    // protocol has been looked up when the calculation started.
     //
     Ipv4Address routerId = m_spfroot->GetVertexId();
 
     NS_LOG_LOGIC("Vertex ID = " << routerId);
+    if (!m_spfrootRouting)
+    {
+        NS_LOG_LOGIC("Can't find root node " << routerId);
+        return;
+    }
+    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+    NS_LOG_LOGIC("Setting routes for router " << routerId);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                  "Expected valid LSA in SPFVertex* v");
+
+    uint32_t nLinkRecords = lsa->GetNLinkRecords();
+    //
+    // Iterate through the link records on the vertex to which we're going to add
+    // routes.  To make sure we're being clear, we're going to add routing table
+    // entries to the tables on the node corresponding to the root of the SPF tree.
+    // These entries will have routes to the IP addresses we find from looking at
+    // the local side of the point-to-point links found on the node described by
+    // the vertex <v>.
+    //
+    NS_LOG_LOGIC(" Router " << routerId << " found " << nLinkRecords
+                            << " link records in LSA " << lsa << "with LinkStateId "
+                            << lsa->GetLinkStateId());
+    for (uint32_t j = 0; j < nLinkRecords; ++j)
     {
-        Ptr<Node> node = *i;
         //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
+        // We are only concerned about point-to-point links
         //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+        if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
             continue;
         }
         //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
+        // Here's why we did all of that work.  We're going to add a host route to the
+        // host address found in the m_linkData field of the point-to-point link
+        // record.  In the case of a point-to-point link, this is the local IP address
+        // of the node connected to the link.  Each of these point-to-point links
+        // will correspond to a local interface that has an IP address to which
+        // the node at the root of the SPF tree can send packets.  The vertex <v>
+        // (corresponding to the node that has these links and interfaces) has
+        // an m_nextHop address precalculated for us that is the address to which the
+        // root node should send packets to be forwarded to these IP addresses.
+        // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
+        // which the packets should be send for forwarding.
         //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        // walk through all available exit directions due to ECMP,
+        // and add host route for each of the exit direction toward
+        // the vertex 'v'
+        for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-
-            uint32_t nLinkRecords = lsa->GetNLinkRecords();
-            //
-            // Iterate through the link records on the vertex to which we're going to add
-            // routes.  To make sure we're being clear, we're going to add routing table
-            // entries to the tables on the node corresponding to the root of the SPF tree.
-            // These entries will have routes to the IP addresses we find from looking at
-            // the local side of the point-to-point links found on the node described by
-            // the vertex <v>.
-            //
-            NS_LOG_LOGIC(" Node " << node->GetId() << " found " << nLinkRecords
-                                  << " link records in LSA " << lsa << "with LinkStateId "
-                                  << lsa->GetLinkStateId());
-            for (uint32_t j = 0; j < nLinkRecords; ++j)
+            SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+            Ipv4Address nextHop = exit.first;
+            int32_t outIf = exit.second;
+            if (outIf >= 0)
             {
-                //
-                // We are only concerned about point-to-point links
-                //
-                GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
-                if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                    continue;
-                }
-                //
-                // Here's why we did all of that work.  We're going to add a host route to the
-                // host address found in the m_linkData field of the point-to-point link
-                // record.  In the case of a point-to-point link, this is the local IP address
-                // of the node connected to the link.  Each of these point-to-point links
-                // will correspond to a local interface that has an IP address to which
-                // the node at the root of the SPF tree can send packets.  The vertex <v>
-                // (corresponding to the node that has these links and interfaces) has
-                // an m_nextHop address precalculated for us that is the address to which the
-                // root node should send packets to be forwarded to these IP addresses.
-                // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-                // which the packets should be send for forwarding.
-                //
-                Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-                if (!router)
-                {
-                    continue;
-                }
-                Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                NS_ASSERT(gr);
-                // walk through all available exit directions due to ECMP,
-                // and add host route for each of the exit direction toward
-                // the vertex 'v'
-                for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-                {
-                    SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                    Ipv4Address nextHop = exit.first;
-                    int32_t outIf = exit.second;
-                    if (outIf >= 0)
-                    {
-                        gr->AddHostRouteTo(lr->GetLinkData(), nextHop, outIf);
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " adding host route to " << lr->GetLinkData()
-                                               << " using next hop " << nextHop
-                                               << " and outgoing interface " << outIf);
-                    }
-                    else
-                    {
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " NOT able to add host route to "
-                                               << lr->GetLinkData() << " using next hop " << nextHop
-                                               << " since outgoing interface id is negative "
-                                               << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
+                gr->AddHostRouteTo(lr->GetLinkData(), nextHop, outIf);
+                NS_LOG_LOGIC("(Route " << i << ") Router " << routerId << " adding host route to "
+                                       << lr->GetLinkData() << " using next hop " << nextHop
+                                       << " and outgoing interface " << outIf);
             }
-            //
-            // Done adding the routes for the selected node.
-            //
-            return;
-        }
+            else
+            {
+                NS_LOG_LOGIC("(Route " << i << ") Router " << routerId
+                                       << " NOT able to add host route to " << lr->GetLinkData()
+                                       << " using next hop " << nextHop
+                                       << " since outgoing interface id is negative " << outIf);
+            }
+        } // for all routes from the root the vertex 'v'
     }
 }
 
@@ -2048,98 +2529,54 @@ GlobalRouteManagerImpl::SPFIntraAddTransit(SPFVertex* v)
     NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
     //
     // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // going to write the actual routing table entries.  Its global routing
+    // protocol has been looked up when the calculation started.
     //
     Ipv4Address routerId = m_spfroot->GetVertexId();
 
     NS_LOG_LOGIC("Vertex ID = " << routerId);
+    if (!m_spfrootRouting)
+    {
+        NS_LOG_LOGIC("Can't find root node " << routerId);
+        return;
+    }
+    Ptr<Ipv4GlobalRouting> gr = m_spfrootRouting;
+    NS_LOG_LOGIC("Setting routes for router " << routerId);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = lsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
+    // walk through all available exit directions due to ECMP,
+    // and add host route for each of the exit direction toward
+    // the vertex 'v'
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
 
-        if (!rtr)
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Router " << routerId << " add network route to "
+                                   << tempip << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = lsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all available exit directions due to ECMP,
-            // and add host route for each of the exit direction toward
-            // the vertex 'v'
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative " << outIf);
-                }
-            }
+            NS_LOG_LOGIC("(Route " << i << ") Router " << routerId
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative " << outIf);
         }
     }
 }
@@ -21,8 +21,10 @@
 #ifndef GLOBAL_ROUTE_MANAGER_IMPL_H
 #define GLOBAL_ROUTE_MANAGER_IMPL_H
 
+#include "global-route-manager.h"
 #include "global-router-interface.h"
 
+#include "ns3/flat-hash-map.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/object.h"
 #include "ns3/ptr.h"
@@ -31,6 +33,7 @@
 #include <map>
 #include <queue>
 #include <stdint.h>
+#include <tuple>
 #include <vector>
 
 namespace ns3
@@ -39,6 +42,7 @@ namespace ns3
 const uint32_t SPF_INFINITY = 0xffffffff; //!< "infinite" distance between nodes
 
 class CandidateQueue;
+class Ipv4;
 class Ipv4GlobalRouting;
 
 /**
@@ -639,6 +643,37 @@ class GlobalRouteManagerLSDB
      */
     GlobalRoutingLSA* GetLSAByLinkData(Ipv4Address addr) const;
 
+    /**
+     * @brief Get the number of Link State Advertisements, External Link State
+     * Advertisements excluded.
+     *
+     * @returns the number of Link State Advertisements.
+     */
+    uint32_t GetNumLSAs() const;
+
+    /**
+     * @brief Look up the index of the Link State Advertisement associated with
+     * the given link state ID (address).
+     *
+     * The Link State Advertisements (External ones excluded) are numbered from
+     * zero in the order they were inserted, so that the SPF calculation can keep
+     * per-LSA state in vectors.
+     *
+     * @param addr The IP address associated with the LSA.  Typically the Router
+     * ID.
+     * @returns The index of the LSA, or GetNumLSAs () if there is no such LSA.
+     */
+    uint32_t GetLSAIndex(Ipv4Address addr) const;
+
+    /**
+     * @brief Look up a Link State Advertisement by index.
+     *
+     * @see GetLSAIndex
+     * @param index the index of the LSA, lower than GetNumLSAs ().
+     * @returns A pointer to the Link State Advertisement.
+     */
+    GlobalRoutingLSA* GetLSAByIndex(uint32_t index) const;
+
     /**
      * @brief Set all LSA flags to an initialized state, for SPF computation
      *
@@ -681,6 +716,11 @@ class GlobalRouteManagerLSDB
     LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
     std::vector<GlobalRoutingLSA*>
         m_extdatabase; //!< database of External Link State Advertisements
+    std::vector<GlobalRoutingLSA*> m_lsas;         //!< Link State Advertisements, by index
+    FlatHashMap<Ipv4Address, uint32_t> m_lsaIndex; //!< indexes of the LSAs, by link state ID
+    /// LSAs having a TransitNetwork link record, by link data (the first LSA in
+    /// link state ID order if several)
+    FlatHashMap<Ipv4Address, GlobalRoutingLSA*> m_linkDataIndex;
 };
 
 /**
@@ -693,6 +733,21 @@ class GlobalRouteManagerLSDB
  * and finally configure each of the node's forwarding tables.
  *
  * The design is guided by OSPFv2 \RFC{2328} section 16.1.1 and quagga ospfd.
+ *
+ * The SPF calculations of the different routers only read the LSDB and
+ * write the routing table of their own router, so that they can be run by
+ * several threads (see the "GlobalRoutingThreads" global value).
+ *
+ * In incremental mode (see the "GlobalRoutingIncremental" global value),
+ * the distances from each router to the vertices of its shortest path tree
+ * are kept after the SPF calculations.  RecomputeRoutes () then compares the
+ * new LSDB with the previous one, and calculates again only the trees that
+ * may have changed: those of the routers whose LSA changed or is referred to
+ * by a changed link record, and those which used (or, with a new link, could
+ * use) a changed link on a shortest path.  In the other routers, only the
+ * routes derived from the changed LSAs are replaced.  Changes to network or
+ * AS external LSAs, or to the set of LSAs, make all the trees be calculated
+ * again.  Keeping the distances needs four bytes per router and per LSA.
  */
 class GlobalRouteManagerImpl
 {
@@ -725,6 +780,23 @@ class GlobalRouteManagerImpl
      */
     virtual void InitializeRoutes();
 
+    /**
+     * @brief Recompute the routes after a change of the topology
+     *
+     * This is equivalent to calling DeleteGlobalRoutes (),
+     * BuildGlobalRoutingDatabase () and InitializeRoutes (), unless the
+     * incremental mode is enabled and the routes have been calculated in
+     * this mode before: then only the shortest path trees affected by the
+     * changes of the LSDB are calculated again.
+     */
+    virtual void RecomputeRoutes();
+
+    /**
+     * @brief Get the statistics of the last route computation.
+     * @returns the statistics
+     */
+    GlobalRouteManager::Statistics GetStatistics() const;
+
     /**
      * @brief Debugging routine; allow client code to supply a pre-built LSDB
      * @param lsdb the pre-built LSDB
@@ -738,8 +810,129 @@ class GlobalRouteManagerImpl
     void DebugSPFCalculate(Ipv4Address root);
 
   private:
-    SPFVertex* m_spfroot;           //!< the root node
+    /// A router whose shortest path tree is to be calculated
+    struct SPFRoot
+    {
+        Ipv4Address routerId;           //!< the router ID
+        Ptr<Ipv4> ipv4;                 //!< the Ipv4 of the router
+        Ptr<Ipv4GlobalRouting> routing; //!< the global routing protocol of the router
+    };
+
+    /**
+     * \brief Construct a worker calculating shortest path trees on the LSDB
+     * of another instance, which keeps the ownership of the LSDB.
+     *
+     * \param lsdb the LSDB
+     */
+    GlobalRouteManagerImpl(GlobalRouteManagerLSDB* lsdb);
+
+    SPFVertex* m_spfroot;                    //!< the root node
+    Ptr<Ipv4> m_spfrootIpv4;                 //!< the Ipv4 of the root node
+    Ptr<Ipv4GlobalRouting> m_spfrootRouting; //!< the global routing protocol of the root node
+    /// SPF status of the LSAs during a calculation, by LSA index
+    std::vector<GlobalRoutingLSA::SPFStatus> m_lsaStatus;
+    /// Distances of the LSAs from the root, by LSA index, if recorded during a calculation
+    std::vector<uint32_t>* m_spfDistances;
     GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+    bool m_ownLsdb;                 //!< whether the LSDB is deleted with this object
+    /// Distances of the LSAs from each router, by router ID, in incremental mode
+    /// (empty for the routers found to be stubs)
+    FlatHashMap<Ipv4Address, std::vector<uint32_t>> m_distances;
+    GlobalRouteManager::Statistics m_statistics; //!< statistics of the last route computation
+
+    /**
+     * \brief Delete the routes added to a router by the global route manager
+     *
+     * \param routing the global routing protocol of the router
+     */
+    static void DeleteRoutes(Ptr<Ipv4GlobalRouting> routing);
+
+    /**
+     * \brief Get the routers participating in global routing which are
+     * assigned to this system
+     *
+     * \returns the routers
+     */
+    std::vector<SPFRoot> GetSPFRoots() const;
+
+    /**
+     * \brief Calculate the shortest path trees of some routers and add the
+     * routes to their routing tables, using the configured number of threads.
+     *
+     * \param roots the routers
+     */
+    void CalculateRoutes(const std::vector<SPFRoot>& roots);
+
+    /// A link between router LSAs: (LSA index, target LSA index, metric)
+    typedef std::tuple<uint32_t, uint32_t, uint32_t> SPFLink;
+
+    /// The link records which differ between two versions of a router LSA
+    struct LSAChange
+    {
+        uint32_t index;                                //!< the LSA index
+        GlobalRoutingLSA* oldLsa;                      //!< the previous version of the LSA
+        std::vector<GlobalRoutingLinkRecord*> removed; //!< the records of the previous version only
+        std::vector<GlobalRoutingLinkRecord*> added;   //!< the records of the new version only
+    };
+
+    /**
+     * \brief Get the changes of the router LSAs between two LSDBs
+     *
+     * \param oldLsdb the previous LSDB
+     * \param newLsdb the new LSDB
+     * \param changes the changes of the router LSAs
+     * \returns false if the LSDBs differ in other ways, which cannot be
+     * handled incrementally
+     */
+    static bool GetLSAChanges(const GlobalRouteManagerLSDB& oldLsdb,
+                              const GlobalRouteManagerLSDB& newLsdb,
+                              std::vector<LSAChange>& changes);
+
+    /**
+     * \brief Test whether the shortest path tree of a router may be affected
+     * by a change of the LSDB
+     *
+     * The removal of a link on a shortest path leaves the tree unchanged if
+     * the target of the link keeps other parents at the same distance whose
+     * next hops, read from the host routes of the router, are together the
+     * same as those of the target.
+     *
+     * \param root the router
+     * \param index the LSA index of the router
+     * \param distances the distances of the LSAs from the router before the change
+     * \param touched whether each LSA has changed or is the target of a changed link
+     * \param removed the links removed
+     * \param added the links added
+     * \param remaining the links of the new LSDB towards the targets of the removed links
+     * \param oldLsdb the LSDB the routes of the router have been calculated from
+     * \returns true if the tree must be calculated again
+     */
+    bool IsTreeAffected(const SPFRoot& root,
+                        uint32_t index,
+                        const std::vector<uint32_t>& distances,
+                        const std::vector<bool>& touched,
+                        const std::vector<SPFLink>& removed,
+                        const std::vector<SPFLink>& added,
+                        const std::vector<SPFLink>& remaining,
+                        const GlobalRouteManagerLSDB& oldLsdb) const;
+
+    /**
+     * \brief Replace the routes derived from changed router LSAs in the
+     * routing table of a router whose shortest path tree is unchanged
+     *
+     * The next hops of the router towards the advertising router of a changed
+     * LSA are those of the host routes to the first point-to-point address of
+     * the previous version of the LSA.
+     *
+     * \param root the router
+     * \param distances the distances of the LSAs from the router
+     * \param changes the changes of the router LSAs
+     * \returns false if the next hops towards an advertising router could not
+     * be found, in which case the routing table is left unchanged
+     */
+    bool UpdateRoutes(const SPFRoot& root,
+                      const std::vector<uint32_t>& distances,
+                      const std::vector<LSAChange>& changes);
 
     /**
      * \brief Test if a node is a stub, from an OSPF sense.
@@ -761,6 +954,21 @@ class GlobalRouteManagerImpl
      */
     void SPFCalculate(Ipv4Address root);
 
+    /**
+     * \brief Calculate the shortest path first (SPF) tree of a router
+     *
+     * \param root the root router
+     */
+    void SPFCalculate(const SPFRoot& root);
+
+    /**
+     * \brief Mark a vertex as being in the SPF tree, and record its distance
+     * from the root if requested
+     *
+     * \param v the vertex
+     */
+    void SetInSPFTree(SPFVertex* v);
+
     /**
      * \brief Process Stub nodes
      *
@@ -910,8 +1118,8 @@ class GlobalRouteManagerImpl
     /**
      * \brief Return the interface number corresponding to a given IP address and mask
      *
-     * This is a wrapper around GetInterfaceForPrefix(), but we first
-     * have to find the right node pointer to pass to that function.
+     * This is a wrapper around GetInterfaceForPrefix(), called on the Ipv4
+     * of the root of the SPF tree.
      * If no such interface is found, return -1 (note:  unit test framework
      * for routing assumes -1 to be a legal return value)
      *
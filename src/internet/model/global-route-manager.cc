@@ -57,6 +57,20 @@ GlobalRouteManager::InitializeRoutes()
     SimulationSingleton<GlobalRouteManagerImpl>::Get()->InitializeRoutes();
 }
 
+void
+GlobalRouteManager::RecomputeRoutes()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    SimulationSingleton<GlobalRouteManagerImpl>::Get()->RecomputeRoutes();
+}
+
+GlobalRouteManager::Statistics
+GlobalRouteManager::GetStatistics()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    return SimulationSingleton<GlobalRouteManagerImpl>::Get()->GetStatistics();
+}
+
 uint32_t
 GlobalRouteManager::AllocateRouterId()
 {
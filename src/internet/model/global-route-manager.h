@@ -38,10 +38,32 @@ namespace ns3
  * and finally configure each of the node's forwarding tables.
  *
  * The design is guided by OSPFv2 \RFC{2328} section 16.1.1 and quagga ospfd.
+ *
+ * The number of threads calculating the routes is set by the
+ * "GlobalRoutingThreads" global value, and the incremental recomputation of
+ * the routes after a change of the topology is enabled by the
+ * "GlobalRoutingIncremental" global value.
  */
 class GlobalRouteManager
 {
   public:
+    /**
+     * @brief Statistics of the last route computation.
+     *
+     * Durations are wall clock times, in milliseconds.
+     */
+    struct Statistics
+    {
+        int64_t deleteTime{0};   //!< time spent deleting the routes
+        int64_t databaseTime{0}; //!< time spent building the LSDB
+        int64_t compareTime{0};  //!< time spent comparing the LSDB with the previous one
+        int64_t updateTime{0};   //!< time spent updating the routes of unaffected routers
+        int64_t spfTime{0};      //!< time spent calculating SPF trees and adding the routes
+        uint32_t nRouters{0};    //!< number of routers
+        uint32_t nCalculated{0}; //!< number of SPF trees calculated
+        uint32_t nUpdated{0};    //!< number of routers whose routes were kept or updated in place
+    };
+
     // Delete copy constructor and assignment operator to avoid misuse
     GlobalRouteManager(const GlobalRouteManager&) = delete;
     GlobalRouteManager& operator=(const GlobalRouteManager&) = delete;
@@ -70,6 +92,26 @@ class GlobalRouteManager
      * per-node forwarding tables
      */
     static void InitializeRoutes();
+
+    /**
+     * @brief Recompute the routes after a change of the topology.
+     *
+     * This is equivalent to calling DeleteGlobalRoutes (),
+     * BuildGlobalRoutingDatabase () and InitializeRoutes (), except in
+     * incremental mode, where only the routes affected by the changes are
+     * recomputed.
+     */
+    static void RecomputeRoutes();
+
+    /**
+     * @brief Get the statistics of the last route computation.
+     *
+     * DeleteGlobalRoutes (), BuildGlobalRoutingDatabase () and
+     * InitializeRoutes () each update the statistics of their own phase;
+     * RecomputeRoutes () resets all of them.
+     * @returns the statistics
+     */
+    static Statistics GetStatistics();
 };
 
 } // namespace ns3
@@ -1724,6 +1724,15 @@ Icmpv6L4Protocol::Lookup(Ipv6Address dst,
     if (cache)
     {
         NdiscCache::Entry* entry = cache->Lookup(dst);
+        if (!entry && cache->GetSharedTable())
+        {
+            const Address* macAddress = cache->GetSharedTable()->Lookup(dst);
+            if (macAddress)
+            {
+                *hardwareDestination = *macAddress;
+                return true;
+            }
+        }
         if (entry)
         {
             if (entry->IsReachable() || entry->IsDelay() || entry->IsPermanent() ||
@@ -1765,6 +1774,16 @@ Icmpv6L4Protocol::Lookup(Ptr<Packet> p,
     }
 
     NdiscCache::Entry* entry = cache->Lookup(dst);
+    if (!entry && cache->GetSharedTable())
+    {
+        const Address* macAddress = cache->GetSharedTable()->Lookup(dst);
+        if (macAddress)
+        {
+            /* entry shared on the channel, send packet */
+            *hardwareDestination = *macAddress;
+            return true;
+        }
+    }
     if (entry)
     {
         if (entry->IsReachable() || entry->IsDelay() || entry->IsPermanent() ||
@@ -24,6 +24,8 @@
 
 #include "ns3/log.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -43,29 +45,133 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux()
     for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
     {
         Ipv4EndPoint* endPoint = *i;
+        endPoint->m_demux = nullptr;
         delete endPoint;
     }
     m_endPoints.clear();
+    m_positions.clear();
+    m_ports.clear();
+    m_connected.clear();
+}
+
+uint64_t
+Ipv4EndPointDemux::GetConnectedKey(Ipv4Address peerAddress, uint16_t peerPort, uint16_t localPort)
+{
+    return (static_cast<uint64_t>(peerAddress.Get()) << 32) |
+           (static_cast<uint64_t>(peerPort) << 16) | localPort;
 }
 
 bool
-Ipv4EndPointDemux::LookupPortLocal(uint16_t port)
+Ipv4EndPointDemux::IsConnected(Ipv4Address peerAddress, uint16_t peerPort)
 {
-    NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    return peerPort != 0 && peerAddress != Ipv4Address::GetAny();
+}
+
+const std::vector<Ipv4EndPoint*>&
+Ipv4EndPointDemux::GetConnected(Ipv4Address peerAddress,
+                                uint16_t peerPort,
+                                uint16_t localPort) const
+{
+    static const std::vector<Ipv4EndPoint*> none;
+    auto found = m_connected.find(GetConnectedKey(peerAddress, peerPort, localPort));
+    return found != m_connected.end() ? found->second : none;
+}
+
+const std::vector<Ipv4EndPoint*>&
+Ipv4EndPointDemux::GetWildcards(uint16_t localPort) const
+{
+    static const std::vector<Ipv4EndPoint*> none;
+    auto found = m_ports.find(localPort);
+    return found != m_ports.end() ? found->second.wildcards : none;
+}
+
+void
+Ipv4EndPointDemux::Insert(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    m_endPoints.push_back(endPoint);
+    m_positions[endPoint] = std::prev(m_endPoints.end());
+    endPoint->m_demux = this;
+    Index(endPoint);
+}
+
+void
+Ipv4EndPointDemux::Index(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    PortEndPoints& port = m_ports[endPoint->GetLocalPort()];
+    port.count++;
+    if (IsConnected(endPoint->GetPeerAddress(), endPoint->GetPeerPort()))
+    {
+        m_connected[GetConnectedKey(endPoint->GetPeerAddress(),
+                                    endPoint->GetPeerPort(),
+                                    endPoint->GetLocalPort())]
+            .push_back(endPoint);
+    }
+    else
     {
-        if ((*i)->GetLocalPort() == port)
+        port.wildcards.push_back(endPoint);
+    }
+}
+
+void
+Ipv4EndPointDemux::Unindex(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    auto port = m_ports.find(endPoint->GetLocalPort());
+    NS_ASSERT(port != m_ports.end());
+    if (IsConnected(endPoint->GetPeerAddress(), endPoint->GetPeerPort()))
+    {
+        auto connected = m_connected.find(GetConnectedKey(endPoint->GetPeerAddress(),
+                                                          endPoint->GetPeerPort(),
+                                                          endPoint->GetLocalPort()));
+        NS_ASSERT(connected != m_connected.end());
+        std::vector<Ipv4EndPoint*>& endPoints = connected->second;
+        endPoints.erase(std::find(endPoints.begin(), endPoints.end(), endPoint));
+        if (endPoints.empty())
         {
-            return true;
+            m_connected.erase(connected);
         }
     }
-    return false;
+    else
+    {
+        std::vector<Ipv4EndPoint*>& wildcards = port->second.wildcards;
+        wildcards.erase(std::find(wildcards.begin(), wildcards.end(), endPoint));
+    }
+    if (--port->second.count == 0)
+    {
+        m_ports.erase(port);
+    }
+}
+
+bool
+Ipv4EndPointDemux::LookupPortLocal(uint16_t port)
+{
+    NS_LOG_FUNCTION(this << port);
+    return m_ports.count(port) != 0;
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
+    auto found = m_ports.find(port);
+    if (found == m_ports.end())
+    {
+        return false;
+    }
+    for (const auto endPoint : found->second.wildcards)
+    {
+        if (endPoint->GetLocalAddress() == addr && endPoint->GetBoundNetDevice() == boundNetDevice)
+        {
+            return true;
+        }
+    }
+    if (found->second.count == found->second.wildcards.size())
+    {
+        return false;
+    }
+    // the connected endpoints are not indexed by local port alone
     for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
     {
         if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
@@ -88,7 +194,7 @@ Ipv4EndPointDemux::Allocate()
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(Ipv4Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -104,7 +210,7 @@ Ipv4EndPointDemux::Allocate(Ipv4Address address)
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -127,7 +233,7 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv4Address address,
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -140,7 +246,11 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    // a duplicate has the same peer, hence is indexed in the same way
+    const std::vector<Ipv4EndPoint*>& candidates =
+        IsConnected(peerAddress, peerPort) ? GetConnected(peerAddress, peerPort, localPort)
+                                           : GetWildcards(localPort);
+    for (auto i = candidates.begin(); i != candidates.end(); i++)
     {
         if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
             (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
@@ -152,7 +262,7 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
     }
     auto endPoint = new Ipv4EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
 
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
 
@@ -163,14 +273,14 @@ void
 Ipv4EndPointDemux::DeAllocate(Ipv4EndPoint* endPoint)
 {
     NS_LOG_FUNCTION(this << endPoint);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto position = m_positions.find(endPoint);
+    if (position != m_positions.end())
     {
-        if (*i == endPoint)
-        {
-            delete endPoint;
-            m_endPoints.erase(i);
-            break;
-        }
+        Unindex(endPoint);
+        m_endPoints.erase(position->second);
+        m_positions.erase(position);
+        endPoint->m_demux = nullptr;
+        delete endPoint;
     }
 }
 
@@ -211,9 +321,13 @@ Ipv4EndPointDemux::Lookup(Ipv4Address daddr,
     EndPoints retval4; // Exact match on all 4
 
     NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr << ":" << dport);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    // Only the endpoints connected to the source of the packet, and the ones
+    // bound to the destination port without being connected, may match.
+    const std::vector<Ipv4EndPoint*>& connected = GetConnected(saddr, sport, dport);
+    const std::vector<Ipv4EndPoint*>& wildcards = GetWildcards(dport);
+    for (std::size_t i = 0; i < connected.size() + wildcards.size(); i++)
     {
-        Ipv4EndPoint* endP = *i;
+        Ipv4EndPoint* endP = i < connected.size() ? connected[i] : wildcards[i - connected.size()];
 
         NS_LOG_DEBUG("Looking at endpoint dport="
                      << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
@@ -372,6 +486,18 @@ Ipv4EndPointDemux::SimpleLookup(Ipv4Address daddr,
 {
     NS_LOG_FUNCTION(this << daddr << dport << saddr << sport);
 
+    // an exact match is indexed like any endpoint with the same peer
+    const std::vector<Ipv4EndPoint*>& candidates =
+        IsConnected(saddr, sport) ? GetConnected(saddr, sport, dport) : GetWildcards(dport);
+    for (const auto endPoint : candidates)
+    {
+        if (endPoint->GetLocalPort() == dport && endPoint->GetLocalAddress() == daddr &&
+            endPoint->GetPeerPort() == sport && endPoint->GetPeerAddress() == saddr)
+        {
+            return endPoint;
+        }
+    }
+
     // this code is a copy/paste version of an old BSD ip stack lookup
     // function.
     uint32_t genericity = 3;
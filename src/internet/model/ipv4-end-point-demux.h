@@ -22,10 +22,12 @@
 
 #include "ipv4-interface.h"
 
+#include "ns3/flat-hash-map.h"
 #include "ns3/ipv4-address.h"
 
 #include <list>
 #include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
@@ -42,6 +44,10 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints connected to a peer are indexed by their peer address,
+ * peer port and local port, and the other ones by their local port, so that
+ * a lookup only examines the endpoints which may match.
  */
 
 class Ipv4EndPointDemux
@@ -171,6 +177,70 @@ class Ipv4EndPointDemux
     void DeAllocate(Ipv4EndPoint* endPoint);
 
   private:
+    friend class Ipv4EndPoint;
+
+    /**
+     * \brief The endpoints bound to a local port.
+     */
+    struct PortEndPoints
+    {
+        uint32_t count{0};                    //!< the number of endpoints
+        std::vector<Ipv4EndPoint*> wildcards; //!< the endpoints not connected to a peer
+    };
+
+    /**
+     * \brief Get the key of the endpoints connected to a peer.
+     * \param peerAddress the peer address
+     * \param peerPort the peer port
+     * \param localPort the local port
+     * \returns the key
+     */
+    static uint64_t GetConnectedKey(Ipv4Address peerAddress, uint16_t peerPort, uint16_t localPort);
+
+    /**
+     * \brief Check whether an endpoint is connected to a peer.
+     * \param peerAddress the peer address of the endpoint
+     * \param peerPort the peer port of the endpoint
+     * \returns true if both the peer address and the peer port are set
+     */
+    static bool IsConnected(Ipv4Address peerAddress, uint16_t peerPort);
+
+    /**
+     * \brief Get the endpoints connected to a peer.
+     * \param peerAddress the peer address
+     * \param peerPort the peer port
+     * \param localPort the local port
+     * \returns the endpoints
+     */
+    const std::vector<Ipv4EndPoint*>& GetConnected(Ipv4Address peerAddress,
+                                                   uint16_t peerPort,
+                                                   uint16_t localPort) const;
+
+    /**
+     * \brief Get the endpoints bound to a local port and not connected to a peer.
+     * \param localPort the local port
+     * \returns the endpoints
+     */
+    const std::vector<Ipv4EndPoint*>& GetWildcards(uint16_t localPort) const;
+
+    /**
+     * \brief Add an endpoint to the container and to the indexes.
+     * \param endPoint the endpoint
+     */
+    void Insert(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Add an endpoint to the port and connection indexes.
+     * \param endPoint the endpoint
+     */
+    void Index(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Remove an endpoint from the port and connection indexes.
+     * \param endPoint the endpoint
+     */
+    void Unindex(Ipv4EndPoint* endPoint);
+
     /**
      * \brief Allocate an ephemeral port.
      * \returns the ephemeral port
@@ -196,6 +266,22 @@ class Ipv4EndPointDemux
      * \brief A list of IPv4 end points.
      */
     EndPoints m_endPoints;
+
+    /**
+     * \brief The position of the end points in the list.
+     */
+    FlatHashMap<Ipv4EndPoint*, EndPointsI> m_positions;
+
+    /**
+     * \brief The end points bound to each local port.
+     */
+    FlatHashMap<uint16_t, PortEndPoints> m_ports;
+
+    /**
+     * \brief The end points connected to a peer, by peer address, peer port
+     * and local port.
+     */
+    FlatHashMap<uint64_t, std::vector<Ipv4EndPoint*>> m_connected;
 };
 
 } // namespace ns3
@@ -33,6 +33,7 @@ namespace ns3
 {
 
 class Header;
+class Ipv4EndPointDemux;
 class Packet;
 
 /**
@@ -191,6 +192,8 @@ class Ipv4EndPoint
     bool IsRxEnabled() const;
 
   private:
+    friend class Ipv4EndPointDemux;
+
     /**
      * \brief The local address.
      */
@@ -235,6 +238,11 @@ class Ipv4EndPoint
      * \brief true if the endpoint can receive packets.
      */
     bool m_rxEnabled;
+
+    /**
+     * \brief The demux indexing this endpoint, if any.
+     */
+    Ipv4EndPointDemux* m_demux;
 };
 
 } // namespace ns3
@@ -30,7 +30,9 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
+#include <iterator>
 #include <vector>
 
 namespace ns3
@@ -64,7 +66,9 @@ Ipv4GlobalRouting::GetTypeId()
 
 Ipv4GlobalRouting::Ipv4GlobalRouting()
     : m_randomEcmpRouting(false),
-      m_respondToInterfaceEvents(false)
+      m_respondToInterfaceEvents(false),
+      m_prefixRouteSerial(0),
+      m_nonContiguousRoutes(0)
 {
     NS_LOG_FUNCTION(this);
 
@@ -82,7 +86,7 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_
     NS_LOG_FUNCTION(this << dest << nextHop << interface);
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, nextHop, interface);
-    m_hostRoutes.push_back(route);
+    InsertHostRoute(route);
 }
 
 void
@@ -91,7 +95,7 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, uint32_t interface)
     NS_LOG_FUNCTION(this << dest << interface);
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, interface);
-    m_hostRoutes.push_back(route);
+    InsertHostRoute(route);
 }
 
 void
@@ -103,7 +107,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network,
     NS_LOG_FUNCTION(this << network << networkMask << nextHop << interface);
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
-    m_networkRoutes.push_back(route);
+    InsertPrefixRoute(m_networkRoutes, m_networkRoutesTrie, route);
 }
 
 void
@@ -112,7 +116,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkMask,
     NS_LOG_FUNCTION(this << network << networkMask << interface);
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface);
-    m_networkRoutes.push_back(route);
+    InsertPrefixRoute(m_networkRoutes, m_networkRoutesTrie, route);
 }
 
 void
@@ -124,7 +128,85 @@ Ipv4GlobalRouting::AddASExternalRouteTo(Ipv4Address network,
     NS_LOG_FUNCTION(this << network << networkMask << nextHop << interface);
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
-    m_ASexternalRoutes.push_back(route);
+    InsertPrefixRoute(m_ASexternalRoutes, m_ASexternalRoutesTrie, route);
+}
+
+/**
+ * \brief Check whether a mask is made of contiguous leading ones.
+ * \param mask the mask
+ * \return true if the mask is contiguous
+ */
+static bool
+IsContiguous(Ipv4Mask mask)
+{
+    uint32_t inverse = ~mask.Get();
+    return (inverse & (inverse + 1)) == 0;
+}
+
+void
+Ipv4GlobalRouting::InsertHostRoute(Ipv4RoutingTableEntry* route)
+{
+    NotifyRoutesChanged();
+    m_hostRoutes.push_back(route);
+    m_hostRoutesIndex[route->GetDest()].push_back(std::prev(m_hostRoutes.end()));
+}
+
+Ipv4GlobalRouting::HostRoutesI
+Ipv4GlobalRouting::EraseHostRoute(HostRoutesI it)
+{
+    NotifyRoutesChanged();
+    auto found = m_hostRoutesIndex.find((*it)->GetDest());
+    NS_ASSERT(found != m_hostRoutesIndex.end());
+    std::vector<HostRoutesI>& routes = found->second;
+    routes.erase(std::find(routes.begin(), routes.end(), it));
+    if (routes.empty())
+    {
+        m_hostRoutesIndex.erase(found);
+    }
+    delete *it;
+    return m_hostRoutes.erase(it);
+}
+
+void
+Ipv4GlobalRouting::InsertPrefixRoute(NetworkRoutes& routes,
+                                     PrefixRoutesTrie& trie,
+                                     Ipv4RoutingTableEntry* route)
+{
+    NotifyRoutesChanged();
+    routes.push_back(route);
+    Ipv4Mask mask = route->GetDestNetworkMask();
+    if (IsContiguous(mask))
+    {
+        trie.Insert(PrefixRoutesTrie::GetKey(route->GetDestNetwork()),
+                    mask.GetPrefixLength(),
+                    PrefixRouteRef(m_prefixRouteSerial++, std::prev(routes.end())));
+    }
+    else
+    {
+        m_nonContiguousRoutes++;
+    }
+}
+
+Ipv4GlobalRouting::NetworkRoutesI
+Ipv4GlobalRouting::ErasePrefixRoute(NetworkRoutes& routes,
+                                    PrefixRoutesTrie& trie,
+                                    NetworkRoutesI it)
+{
+    NotifyRoutesChanged();
+    Ipv4Mask mask = (*it)->GetDestNetworkMask();
+    if (IsContiguous(mask))
+    {
+        bool removed = trie.RemoveIf(PrefixRoutesTrie::GetKey((*it)->GetDestNetwork()),
+                                     mask.GetPrefixLength(),
+                                     [it](const PrefixRouteRef& ref) { return ref.second == it; });
+        NS_ASSERT(removed);
+    }
+    else
+    {
+        m_nonContiguousRoutes--;
+    }
+    delete *it;
+    return routes.erase(it);
 }
 
 Ptr<Ipv4Route>
@@ -138,11 +220,12 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
     RouteVec_t allRoutes;
 
     NS_LOG_LOGIC("Number of m_hostRoutes = " << m_hostRoutes.size());
-    for (auto i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i++)
+    auto hostRoutes = m_hostRoutesIndex.find(dest);
+    if (hostRoutes != m_hostRoutesIndex.end())
     {
-        NS_ASSERT((*i)->IsHost());
-        if ((*i)->GetDest() == dest)
+        for (HostRoutesI i : hostRoutes->second)
         {
+            NS_ASSERT((*i)->IsHost());
             if (oif)
             {
                 if (oif != m_ipv4->GetNetDevice((*i)->GetInterface()))
@@ -155,7 +238,39 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
             NS_LOG_LOGIC(allRoutes.size() << "Found global host route" << *i);
         }
     }
-    if (allRoutes.empty()) // if no host route is found
+    // the routes to networks and to external AS can be looked up in the
+    // tries unless some masks are not contiguous
+    bool indexed = (m_nonContiguousRoutes == 0);
+    if (allRoutes.empty() && indexed) // if no host route is found
+    {
+        NS_LOG_LOGIC("Number of m_networkRoutes" << m_networkRoutes.size());
+        // collect the matching routes of all prefix lengths, and sort them
+        // back in the order of the forwarding table
+        std::vector<PrefixRouteRef> matches;
+        m_networkRoutesTrie.Match(
+            PrefixRoutesTrie::GetKey(dest),
+            [this, &matches, oif](uint16_t, const std::vector<PrefixRouteRef>& routes) {
+                for (const auto& ref : routes)
+                {
+                    if (!oif || oif == m_ipv4->GetNetDevice((*ref.second)->GetInterface()))
+                    {
+                        matches.push_back(ref);
+                    }
+                }
+                return false;
+            });
+        std::sort(matches.begin(),
+                  matches.end(),
+                  [](const PrefixRouteRef& a, const PrefixRouteRef& b) {
+                      return a.first < b.first;
+                  });
+        for (const auto& ref : matches)
+        {
+            allRoutes.push_back(*ref.second);
+            NS_LOG_LOGIC(allRoutes.size() << "Found global network route" << *ref.second);
+        }
+    }
+    else if (allRoutes.empty()) // if no host route is found
     {
         NS_LOG_LOGIC("Number of m_networkRoutes" << m_networkRoutes.size());
         for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
@@ -177,7 +292,33 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
             }
         }
     }
-    if (allRoutes.empty()) // consider external if no host/network found
+    if (allRoutes.empty() && indexed) // consider external if no host/network found
+    {
+        // select the first matching route in the order of the forwarding table
+        const PrefixRouteRef* first = nullptr;
+        m_ASexternalRoutesTrie.Match(
+            PrefixRoutesTrie::GetKey(dest),
+            [this, &first, oif](uint16_t, const std::vector<PrefixRouteRef>& routes) {
+                for (const auto& ref : routes)
+                {
+                    if (!oif || oif == m_ipv4->GetNetDevice((*ref.second)->GetInterface()))
+                    {
+                        if (!first || ref.first < first->first)
+                        {
+                            first = &ref;
+                        }
+                        break;
+                    }
+                }
+                return false;
+            });
+        if (first)
+        {
+            NS_LOG_LOGIC("Found external route" << *first->second);
+            allRoutes.push_back(*first->second);
+        }
+    }
+    else if (allRoutes.empty()) // consider external if no host/network found
     {
         for (auto k = m_ASexternalRoutes.begin(); k != m_ASexternalRoutes.end(); k++)
         {
@@ -297,8 +438,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
             if (tmp == index)
             {
                 NS_LOG_LOGIC("Removing route " << index << "; size = " << m_hostRoutes.size());
-                delete *i;
-                m_hostRoutes.erase(i);
+                EraseHostRoute(i);
                 NS_LOG_LOGIC("Done removing host route "
                              << index << "; host route remaining size = " << m_hostRoutes.size());
                 return;
@@ -313,8 +453,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
         if (tmp == index)
         {
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_networkRoutes.size());
-            delete *j;
-            m_networkRoutes.erase(j);
+            ErasePrefixRoute(m_networkRoutes, m_networkRoutesTrie, j);
             NS_LOG_LOGIC("Done removing network route "
                          << index << "; network route remaining size = " << m_networkRoutes.size());
             return;
@@ -328,8 +467,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
         if (tmp == index)
         {
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_ASexternalRoutes.size());
-            delete *k;
-            m_ASexternalRoutes.erase(k);
+            ErasePrefixRoute(m_ASexternalRoutes, m_ASexternalRoutesTrie, k);
             NS_LOG_LOGIC("Done removing network route "
                          << index << "; network route remaining size = " << m_networkRoutes.size());
             return;
@@ -339,6 +477,89 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
     NS_ASSERT(false);
 }
 
+std::vector<Ipv4RoutingTableEntry>
+Ipv4GlobalRouting::GetHostRoutesTo(Ipv4Address dest) const
+{
+    NS_LOG_FUNCTION(this << dest);
+    std::vector<Ipv4RoutingTableEntry> routes;
+    auto found = m_hostRoutesIndex.find(dest);
+    if (found != m_hostRoutesIndex.end())
+    {
+        for (HostRoutesI i : found->second)
+        {
+            routes.push_back(**i);
+        }
+    }
+    return routes;
+}
+
+bool
+Ipv4GlobalRouting::RemoveHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_t interface)
+{
+    NS_LOG_FUNCTION(this << dest << nextHop << interface);
+    auto found = m_hostRoutesIndex.find(dest);
+    if (found == m_hostRoutesIndex.end())
+    {
+        return false;
+    }
+    for (HostRoutesI i : found->second)
+    {
+        if ((*i)->GetGateway() == nextHop && (*i)->GetInterface() == interface)
+        {
+            EraseHostRoute(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+Ipv4GlobalRouting::RemoveNetworkRouteTo(Ipv4Address network,
+                                        Ipv4Mask networkMask,
+                                        Ipv4Address nextHop,
+                                        uint32_t interface)
+{
+    NS_LOG_FUNCTION(this << network << networkMask << nextHop << interface);
+    auto isMatch = [network, networkMask, nextHop, interface](const Ipv4RoutingTableEntry* r) {
+        return r->GetDestNetwork() == network && r->GetDestNetworkMask() == networkMask &&
+               r->GetGateway() == nextHop && r->GetInterface() == interface;
+    };
+    if (!IsContiguous(networkMask))
+    {
+        for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+        {
+            if (isMatch(*j))
+            {
+                ErasePrefixRoute(m_networkRoutes, m_networkRoutesTrie, j);
+                return true;
+            }
+        }
+        return false;
+    }
+    const std::vector<PrefixRouteRef>* refs =
+        m_networkRoutesTrie.Find(PrefixRoutesTrie::GetKey(network),
+                                 networkMask.GetPrefixLength());
+    if (!refs)
+    {
+        return false;
+    }
+    // the first matching route in the order of the routing table
+    const PrefixRouteRef* first = nullptr;
+    for (const auto& ref : *refs)
+    {
+        if (isMatch(*ref.second) && (!first || ref.first < first->first))
+        {
+            first = &ref;
+        }
+    }
+    if (!first)
+    {
+        return false;
+    }
+    ErasePrefixRoute(m_networkRoutes, m_networkRoutesTrie, first->second);
+    return true;
+}
+
 int64_t
 Ipv4GlobalRouting::AssignStreams(int64_t stream)
 {
@@ -364,6 +585,10 @@ Ipv4GlobalRouting::DoDispose()
     {
         delete (*l);
     }
+    m_hostRoutesIndex.clear();
+    m_networkRoutesTrie.Clear();
+    m_ASexternalRoutesTrie.Clear();
+    m_nonContiguousRoutes = 0;
 
     Ipv4RoutingProtocol::DoDispose();
 }
@@ -532,9 +757,7 @@ Ipv4GlobalRouting::NotifyInterfaceUp(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::RecomputeRoutes();
     }
 }
 
@@ -544,9 +767,7 @@ Ipv4GlobalRouting::NotifyInterfaceDown(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::RecomputeRoutes();
     }
 }
 
@@ -556,9 +777,7 @@ Ipv4GlobalRouting::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress add
     NS_LOG_FUNCTION(this << interface << address);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::RecomputeRoutes();
     }
 }
 
@@ -568,12 +787,17 @@ Ipv4GlobalRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
     NS_LOG_FUNCTION(this << interface << address);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::RecomputeRoutes();
     }
 }
 
+bool
+Ipv4GlobalRouting::IsRouteCacheable() const
+{
+    // the routes chosen at random among equal cost routes vary per packet
+    return !m_randomEcmpRouting;
+}
+
 void
 Ipv4GlobalRouting::SetIpv4(Ptr<Ipv4> ipv4)
 {
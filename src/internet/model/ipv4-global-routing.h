@@ -23,12 +23,16 @@
 #include "ipv4-routing-protocol.h"
 #include "ipv4.h"
 
+#include "ns3/flat-hash-map.h"
 #include "ns3/ipv4-address.h"
+#include "ns3/prefix-trie.h"
 #include "ns3/ptr.h"
 #include "ns3/random-variable-stream.h"
 
 #include <list>
 #include <stdint.h>
+#include <utility>
+#include <vector>
 
 namespace ns3
 {
@@ -66,6 +70,11 @@ class Node;
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * The routes are kept in lists, which define the route indexes (see
+ * GetRoute), and indexed by destination (host routes) or by a prefix trie
+ * (network and AS external routes), so that the cost of a lookup does not
+ * grow with the number of routes.
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -108,6 +117,7 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     void SetIpv4(Ptr<Ipv4> ipv4) override;
     void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                            Time::Unit unit = Time::S) const override;
+    bool IsRouteCacheable() const override;
 
     /**
      * \brief Add a host route to the global routing table.
@@ -222,6 +232,43 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
      */
     void RemoveRoute(uint32_t i);
 
+    /**
+     * \brief Get the host routes to a destination, in the order of the
+     * routing table.
+     *
+     * \param dest The destination address.
+     * \return the host routes to the destination
+     */
+    std::vector<Ipv4RoutingTableEntry> GetHostRoutesTo(Ipv4Address dest) const;
+
+    /**
+     * \brief Remove a host route from the global unicast routing table.
+     *
+     * Only the first matching route is removed.
+     *
+     * \param dest The destination address of the route.
+     * \param nextHop The next hop of the route.
+     * \param interface The network interface index of the route.
+     * \return true if a route has been removed
+     */
+    bool RemoveHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_t interface);
+
+    /**
+     * \brief Remove a network route from the global unicast routing table.
+     *
+     * Only the first matching route is removed.
+     *
+     * \param network The network of the route.
+     * \param networkMask The network mask of the route.
+     * \param nextHop The next hop of the route.
+     * \param interface The network interface index of the route.
+     * \return true if a route has been removed
+     */
+    bool RemoveNetworkRouteTo(Ipv4Address network,
+                              Ipv4Mask networkMask,
+                              Ipv4Address nextHop,
+                              uint32_t interface);
+
     /**
      * Assign a fixed random variable stream number to the random variables
      * used by this model.  Return the number of streams (possibly zero) that
@@ -266,6 +313,49 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
     typedef std::list<Ipv4RoutingTableEntry*>::iterator ASExternalRoutesI;
 
+    /// index of the host routes by destination address
+    typedef FlatHashMap<Ipv4Address, std::vector<HostRoutesI>> HostRoutesIndex;
+
+    /// serial number and position of a route to a network or to an external AS
+    typedef std::pair<uint64_t, NetworkRoutesI> PrefixRouteRef;
+
+    /// longest prefix match index of the routes to networks or to an external AS
+    typedef PrefixTrie<PrefixRouteRef, 4> PrefixRoutesTrie;
+
+    /**
+     * \brief Append a route to the routes to hosts.
+     * \param route the route (ownership is transferred to the table)
+     */
+    void InsertHostRoute(Ipv4RoutingTableEntry* route);
+
+    /**
+     * \brief Remove a route from the routes to hosts.
+     * \param it iterator to the route
+     * \return iterator to the following route
+     */
+    HostRoutesI EraseHostRoute(HostRoutesI it);
+
+    /**
+     * \brief Append a route to the routes to networks or to external AS.
+     * \param routes the routes to networks or to external AS
+     * \param trie the index of the routes
+     * \param route the route (ownership is transferred to the table)
+     */
+    void InsertPrefixRoute(NetworkRoutes& routes,
+                           PrefixRoutesTrie& trie,
+                           Ipv4RoutingTableEntry* route);
+
+    /**
+     * \brief Remove a route from the routes to networks or to external AS.
+     * \param routes the routes to networks or to external AS
+     * \param trie the index of the routes
+     * \param it iterator to the route
+     * \return iterator to the following route
+     */
+    NetworkRoutesI ErasePrefixRoute(NetworkRoutes& routes,
+                                    PrefixRoutesTrie& trie,
+                                    NetworkRoutesI it);
+
     /**
      * \brief Lookup in the forwarding table for destination.
      * \param dest destination address
@@ -278,6 +368,12 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     NetworkRoutes m_networkRoutes;       //!< Routes to networks
     ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+    HostRoutesIndex m_hostRoutesIndex;       //!< Index of the routes to hosts
+    PrefixRoutesTrie m_networkRoutesTrie;    //!< Index of the routes to networks
+    PrefixRoutesTrie m_ASexternalRoutesTrie; //!< Index of the external routes
+    uint64_t m_prefixRouteSerial;            //!< Serial number of the next prefix route
+    uint32_t m_nonContiguousRoutes;          //!< Number of prefix routes with non-contiguous masks
+
     Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
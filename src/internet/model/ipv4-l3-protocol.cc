@@ -36,12 +36,15 @@
 #include "ns3/node.h"
 #include "ns3/object-vector.h"
 #include "ns3/packet.h"
+#include "ns3/segment-offload-tag.h"
 #include "ns3/socket.h"
 #include "ns3/string.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/traffic-control-layer.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -87,6 +90,12 @@ Ipv4L3Protocol::GetTypeId()
                           TimeValue(Seconds(1)),
                           MakeTimeAccessor(&Ipv4L3Protocol::m_purge),
                           MakeTimeChecker(Seconds(0)))
+            .AddAttribute("RouteCacheSize",
+                          "Maximum number of unicast routes cached per destination and "
+                          "interface, when the routing protocol allows it, 0 disables the cache",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&Ipv4L3Protocol::m_routeCacheSize),
+                          MakeUintegerChecker<uint32_t>())
             .AddTraceSource("Tx",
                             "Send ipv4 packet to outgoing interface.",
                             MakeTraceSourceAccessor(&Ipv4L3Protocol::m_txTrace),
@@ -125,15 +134,25 @@ Ipv4L3Protocol::GetTypeId()
                             "and it is being forward up the stack",
                             MakeTraceSourceAccessor(&Ipv4L3Protocol::m_localDeliverTrace),
                             "ns3::Ipv4L3Protocol::SentTracedCallback")
+            .AddTraceSource("RouteCache",
+                            "A unicast route was looked up in the route cache",
+                            MakeTraceSourceAccessor(&Ipv4L3Protocol::m_routeCacheTrace),
+                            "ns3::Ipv4L3Protocol::RouteCacheTracedCallback")
 
         ;
     return tid;
 }
 
 Ipv4L3Protocol::Ipv4L3Protocol()
+    : m_routeCacheSize(0),
+      m_routeCacheVersion(0),
+      m_routeCacheInputKey(0),
+      m_routeCacheInput(false),
+      m_routeCacheOldest(0)
 {
     NS_LOG_FUNCTION(this);
     m_ucb = MakeCallback(&Ipv4L3Protocol::IpForward, this);
+    m_cacheUcb = MakeCallback(&Ipv4L3Protocol::IpForwardCached, this);
     m_mcb = MakeCallback(&Ipv4L3Protocol::IpMulticastForward, this);
     m_lcb = MakeCallback(&Ipv4L3Protocol::LocalDeliver, this);
     m_ecb = MakeCallback(&Ipv4L3Protocol::RouteInputError, this);
@@ -297,6 +316,7 @@ Ipv4L3Protocol::SetRoutingProtocol(Ptr<Ipv4RoutingProtocol> routingProtocol)
     NS_LOG_FUNCTION(this << routingProtocol);
     m_routingProtocol = routingProtocol;
     m_routingProtocol->SetIpv4(this);
+    FlushRouteCache();
 }
 
 Ptr<Ipv4RoutingProtocol>
@@ -325,6 +345,7 @@ Ipv4L3Protocol::DoDispose()
     m_sockets.clear();
     m_node = nullptr;
     m_routingProtocol = nullptr;
+    FlushRouteCache();
 
     for (auto it = m_fragments.begin(); it != m_fragments.end(); it++)
     {
@@ -659,13 +680,134 @@ Ipv4L3Protocol::Receive(Ptr<NetDevice> device,
     }
 
     NS_ASSERT_MSG(m_routingProtocol, "Need a routing protocol object to process packets");
-    if (!m_routingProtocol->RouteInput(packet, ipHeader, device, m_ucb, m_mcb, m_lcb, m_ecb))
+    Ipv4Address destination = ipHeader.GetDestination();
+    bool cacheRoute =
+        !destination.IsMulticast() && !destination.IsBroadcast() && IsRouteCacheEnabled();
+    if (cacheRoute)
+    {
+        // the packets of a destination whose route is cached are forwarded
+        // without being routed: they were not for this node when it was cached
+        uint64_t key = GetRouteCacheKey(destination, interface, true);
+        Ptr<Ipv4Route> route = LookupRouteCache(key);
+        if (route)
+        {
+            m_routeCacheTrace(destination, true);
+            IpForward(route, packet, ipHeader);
+            return;
+        }
+        m_routeCacheInputKey = key;
+        m_routeCacheInput = true;
+    }
+    bool routed = m_routingProtocol->RouteInput(packet,
+                                                ipHeader,
+                                                device,
+                                                cacheRoute ? m_cacheUcb : m_ucb,
+                                                m_mcb,
+                                                m_lcb,
+                                                m_ecb);
+    m_routeCacheInput = false;
+    if (!routed)
     {
         NS_LOG_WARN("No route found for forwarding packet.  Drop.");
         m_dropTrace(ipHeader, packet, DROP_NO_ROUTE, this, interface);
     }
 }
 
+Ptr<Ipv4Route>
+Ipv4L3Protocol::RouteOutput(Ptr<Packet> p,
+                            const Ipv4Header& header,
+                            Ptr<NetDevice> oif,
+                            Socket::SocketErrno& sockerr)
+{
+    NS_LOG_FUNCTION(this << p << header << oif);
+    NS_ASSERT_MSG(m_routingProtocol, "Need a routing protocol object to route packets");
+    Ipv4Address destination = header.GetDestination();
+    if (destination.IsMulticast() || destination.IsBroadcast() || !IsRouteCacheEnabled())
+    {
+        return m_routingProtocol->RouteOutput(p, header, oif, sockerr);
+    }
+    uint64_t key = GetRouteCacheKey(destination, oif ? GetInterfaceForDevice(oif) : -1, false);
+    Ptr<Ipv4Route> route = LookupRouteCache(key);
+    m_routeCacheTrace(destination, bool(route));
+    if (route)
+    {
+        sockerr = Socket::ERROR_NOTERROR;
+        return route;
+    }
+    route = m_routingProtocol->RouteOutput(p, header, oif, sockerr);
+    if (route)
+    {
+        AddRouteCache(key, route);
+    }
+    return route;
+}
+
+bool
+Ipv4L3Protocol::IsRouteCacheEnabled() const
+{
+    return m_routeCacheSize > 0 && m_routingProtocol && m_routingProtocol->IsRouteCacheable();
+}
+
+uint64_t
+Ipv4L3Protocol::GetRouteCacheKey(Ipv4Address destination, int32_t interface, bool input)
+{
+    // the interface is shifted so that -1 (any interface) is 0
+    return (uint64_t(destination.Get()) << 32) | (uint64_t(uint32_t(interface + 1)) << 1) |
+           uint64_t(input);
+}
+
+Ptr<Ipv4Route>
+Ipv4L3Protocol::LookupRouteCache(uint64_t key)
+{
+    uint64_t version = m_routingProtocol->GetRoutesVersion();
+    if (version != m_routeCacheVersion)
+    {
+        NS_LOG_LOGIC("Routes changed, flushing " << m_routeCache.size() << " cached routes");
+        FlushRouteCache();
+        m_routeCacheVersion = version;
+        return nullptr;
+    }
+    auto it = m_routeCache.find(key);
+    return it != m_routeCache.end() ? it->second : nullptr;
+}
+
+void
+Ipv4L3Protocol::AddRouteCache(uint64_t key, Ptr<Ipv4Route> route)
+{
+    uint64_t version = m_routingProtocol->GetRoutesVersion();
+    if (version != m_routeCacheVersion || m_routeCacheKeys.size() > m_routeCacheSize)
+    {
+        // the routes changed, or the cache was made smaller
+        NS_LOG_LOGIC("Flushing " << m_routeCache.size() << " cached routes");
+        FlushRouteCache();
+        m_routeCacheVersion = version;
+    }
+    auto [it, inserted] = m_routeCache.insert({key, route});
+    if (!inserted)
+    {
+        it->second = route;
+        return;
+    }
+    // the routes are evicted in the order they were cached
+    if (m_routeCacheKeys.size() < m_routeCacheSize)
+    {
+        m_routeCacheKeys.push_back(key);
+        return;
+    }
+    NS_LOG_LOGIC("Route cache full, evicting the oldest route");
+    m_routeCache.erase(m_routeCacheKeys[m_routeCacheOldest]);
+    m_routeCacheKeys[m_routeCacheOldest] = key;
+    m_routeCacheOldest = (m_routeCacheOldest + 1) % m_routeCacheKeys.size();
+}
+
+void
+Ipv4L3Protocol::FlushRouteCache()
+{
+    m_routeCache.clear();
+    m_routeCacheKeys.clear();
+    m_routeCacheOldest = 0;
+}
+
 Ptr<Icmpv4L4Protocol>
 Ipv4L3Protocol::GetIcmp() const
 {
@@ -773,6 +915,15 @@ Ipv4L3Protocol::Send(Ptr<Packet> packet,
     Ipv4Header ipHeader =
         BuildHeader(source, destination, protocol, packet->GetSize(), ttl, tos, mayFragment);
 
+    // each segment of a super-segment carries its own IP header
+    SegmentOffloadTag offloadTag;
+    if (packet->RemovePacketTag(offloadTag))
+    {
+        packet->AddPacketTag(
+            SegmentOffloadTag(offloadTag.GetSegments(),
+                              offloadTag.GetHeaderSize() + ipHeader.GetSerializedSize()));
+    }
+
     // Handle a few cases:
     // 1) packet is passed in with a route entry
     // 1a) packet is passed in with a route entry but route->GetGateway is not set (e.g., on-demand)
@@ -880,7 +1031,7 @@ Ipv4L3Protocol::Send(Ptr<Packet> packet,
     Ptr<Ipv4Route> newRoute;
     if (m_routingProtocol)
     {
-        newRoute = m_routingProtocol->RouteOutput(pktCopyWithTags, ipHeader, oif, errno_);
+        newRoute = RouteOutput(pktCopyWithTags, ipHeader, oif, errno_);
     }
     else
     {
@@ -991,7 +1142,10 @@ Ipv4L3Protocol::SendRealOut(Ptr<Ipv4Route> route, Ptr<Packet> packet, const Ipv4
     if (outInterface->IsUp())
     {
         NS_LOG_LOGIC("Send to " << targetLabel << " " << target);
-        if (packet->GetSize() + ipHeader.GetSerializedSize() > outInterface->GetDevice()->GetMtu())
+        // super-segments are not fragmented by the devices supporting segmentation offload
+        SegmentOffloadTag offloadTag;
+        if (packet->GetSize() + ipHeader.GetSerializedSize() > outDev->GetMtu() &&
+            !(outDev->SupportsSegmentOffload() && packet->PeekPacketTag(offloadTag)))
         {
             std::list<Ipv4PayloadHeaderPair> listFragments;
             DoFragmentation(packet, ipHeader, outInterface->GetDevice()->GetMtu(), listFragments);
@@ -1085,6 +1239,21 @@ Ipv4L3Protocol::IpForward(Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ipv
     SendRealOut(rtentry, packet, ipHeader);
 }
 
+void
+Ipv4L3Protocol::IpForwardCached(Ptr<Ipv4Route> rtentry,
+                                Ptr<const Packet> p,
+                                const Ipv4Header& header)
+{
+    NS_LOG_FUNCTION(this << rtentry << p << header);
+    if (m_routeCacheInput)
+    {
+        m_routeCacheInput = false;
+        m_routeCacheTrace(header.GetDestination(), false);
+        AddRouteCache(m_routeCacheInputKey, rtentry);
+    }
+    IpForward(rtentry, p, header);
+}
+
 void
 Ipv4L3Protocol::LocalDeliver(Ptr<const Packet> packet, const Ipv4Header& ip, uint32_t iif)
 {
@@ -1157,6 +1326,7 @@ Ipv4L3Protocol::AddAddress(uint32_t i, Ipv4InterfaceAddress address)
     if (m_routingProtocol)
     {
         m_routingProtocol->NotifyAddAddress(i, address);
+        m_routingProtocol->NotifyRoutesChanged();
     }
     return retVal;
 }
@@ -1186,6 +1356,7 @@ Ipv4L3Protocol::RemoveAddress(uint32_t i, uint32_t addressIndex)
         if (m_routingProtocol)
         {
             m_routingProtocol->NotifyRemoveAddress(i, address);
+            m_routingProtocol->NotifyRoutesChanged();
         }
         return true;
     }
@@ -1209,6 +1380,7 @@ Ipv4L3Protocol::RemoveAddress(uint32_t i, Ipv4Address address)
         if (m_routingProtocol)
         {
             m_routingProtocol->NotifyRemoveAddress(i, ifAddr);
+            m_routingProtocol->NotifyRoutesChanged();
         }
         return true;
     }
@@ -1350,6 +1522,7 @@ Ipv4L3Protocol::SetUp(uint32_t i)
         if (m_routingProtocol)
         {
             m_routingProtocol->NotifyInterfaceUp(i);
+            m_routingProtocol->NotifyRoutesChanged();
         }
     }
     else
@@ -1371,6 +1544,7 @@ Ipv4L3Protocol::SetDown(uint32_t ifaceIndex)
     if (m_routingProtocol)
     {
         m_routingProtocol->NotifyInterfaceDown(ifaceIndex);
+        m_routingProtocol->NotifyRoutesChanged();
     }
 }
 
@@ -1388,6 +1562,10 @@ Ipv4L3Protocol::SetForwarding(uint32_t i, bool val)
     NS_LOG_FUNCTION(this << i);
     Ptr<Ipv4Interface> interface = GetInterface(i);
     interface->SetForwarding(val);
+    if (m_routingProtocol)
+    {
+        m_routingProtocol->NotifyRoutesChanged();
+    }
 }
 
 Ptr<NetDevice>
@@ -1405,6 +1583,10 @@ Ipv4L3Protocol::SetIpForward(bool forward)
     {
         (*i)->SetForwarding(forward);
     }
+    if (m_routingProtocol)
+    {
+        m_routingProtocol->NotifyRoutesChanged();
+    }
 }
 
 bool
@@ -1418,6 +1600,10 @@ Ipv4L3Protocol::SetWeakEsModel(bool model)
 {
     NS_LOG_FUNCTION(this << model);
     m_strongEndSystemModel = !model;
+    if (m_routingProtocol)
+    {
+        m_routingProtocol->NotifyRoutesChanged();
+    }
 }
 
 bool
@@ -1431,6 +1617,10 @@ Ipv4L3Protocol::SetStrongEndSystemModel(bool model)
 {
     NS_LOG_FUNCTION(this << model);
     m_strongEndSystemModel = model;
+    if (m_routingProtocol)
+    {
+        m_routingProtocol->NotifyRoutesChanged();
+    }
 }
 
 bool
@@ -1522,11 +1712,6 @@ Ipv4L3Protocol::DoFragmentation(Ptr<Packet> packet,
         NS_LOG_LOGIC("Fragment check - " << fragmentHeader.GetFragmentOffset());
 
         NS_LOG_LOGIC("New fragment Header " << fragmentHeader);
-
-        std::ostringstream oss;
-        oss << fragmentHeader;
-        fragment->Print(oss);
-
         NS_LOG_LOGIC("New fragment " << *fragment);
 
         listFragments.emplace_back(fragment, fragmentHeader);
@@ -1598,14 +1783,16 @@ Ipv4L3Protocol::Fragments::AddFragment(Ptr<Packet> fragment,
 {
     NS_LOG_FUNCTION(this << fragment << fragmentOffset << moreFragment);
 
-    std::list<std::pair<Ptr<Packet>, uint16_t>>::iterator it;
-
-    for (it = m_fragments.begin(); it != m_fragments.end(); it++)
+    // the fragments mostly arrive in order: look for the position from the end
+    auto it = m_fragments.end();
+    if (!m_fragments.empty() && m_fragments.back().second > fragmentOffset)
     {
-        if (it->second > fragmentOffset)
-        {
-            break;
-        }
+        it = std::upper_bound(m_fragments.begin(),
+                              m_fragments.end(),
+                              fragmentOffset,
+                              [](uint16_t offset, const std::pair<Ptr<Packet>, uint16_t>& f) {
+                                  return offset < f.second;
+                              });
     }
 
     if (it == m_fragments.end())
@@ -1614,6 +1801,25 @@ Ipv4L3Protocol::Fragments::AddFragment(Ptr<Packet> fragment,
     }
 
     m_fragments.insert(it, std::pair<Ptr<Packet>, uint16_t>(fragment, fragmentOffset));
+
+    // merge the bytes of the fragment with the intervals received, fragments
+    // might overlap in strange ways
+    uint32_t start = fragmentOffset;
+    uint32_t end = start + fragment->GetSize();
+    auto next = m_received.upper_bound(start);
+    if (next != m_received.begin() && std::prev(next)->second >= start)
+    {
+        --next;
+        start = next->first;
+        end = std::max(end, next->second);
+        next = m_received.erase(next);
+    }
+    while (next != m_received.end() && next->first <= end)
+    {
+        end = std::max(end, next->second);
+        next = m_received.erase(next);
+    }
+    m_received.emplace_hint(next, start, end);
 }
 
 bool
@@ -1621,29 +1827,8 @@ Ipv4L3Protocol::Fragments::IsEntire() const
 {
     NS_LOG_FUNCTION(this);
 
-    bool ret = !m_moreFragment && !m_fragments.empty();
-
-    if (ret)
-    {
-        uint16_t lastEndOffset = 0;
-
-        for (auto it = m_fragments.begin(); it != m_fragments.end(); it++)
-        {
-            // overlapping fragments do exist
-            NS_LOG_LOGIC("Checking overlaps " << lastEndOffset << " - " << it->second);
-
-            if (lastEndOffset < it->second)
-            {
-                ret = false;
-                break;
-            }
-            // fragments might overlap in strange ways
-            uint16_t fragmentEnd = it->first->GetSize() + it->second;
-            lastEndOffset = std::max(lastEndOffset, fragmentEnd);
-        }
-    }
-
-    return ret;
+    // the packet is entire when the bytes received have no gap
+    return !m_moreFragment && m_received.size() == 1 && m_received.begin()->first == 0;
 }
 
 Ptr<Packet>
@@ -1731,6 +1916,12 @@ Ipv4L3Protocol::Fragments::GetTimeoutIter()
     return m_timeoutIter;
 }
 
+std::size_t
+Ipv4L3Protocol::FragmentKeyHash::operator()(const FragmentKey_t& key) const
+{
+    return static_cast<std::size_t>(FlatHashMix(key.first ^ FlatHashMix(key.second)));
+}
+
 void
 Ipv4L3Protocol::HandleFragmentsTimeout(FragmentKey_t key, Ipv4Header& ipHeader, uint32_t iif)
 {
@@ -1812,7 +2003,7 @@ Ipv4L3Protocol::UpdateDuplicate(Ptr<const Packet> p, const Ipv4Header& header)
                            << std::get<3>(key) << ")");
 
     // place a new entry, on collision the existing entry iterator is returned
-    auto [iter, inserted] = m_dups.emplace(key, Seconds(0));
+    auto [iter, inserted] = m_dups.insert({key, Seconds(0)});
     bool isDup = !inserted && iter->second > Simulator::Now();
 
     // set the expiration event
@@ -1820,6 +2011,14 @@ Ipv4L3Protocol::UpdateDuplicate(Ptr<const Packet> p, const Ipv4Header& header)
     return isDup;
 }
 
+std::size_t
+Ipv4L3Protocol::DupTupleHash::operator()(const DupTuple_t& tuple) const
+{
+    const auto& [hash, proto, src, dst] = tuple;
+    uint64_t addresses = uint64_t(src.Get()) << 32 | dst.Get();
+    return static_cast<std::size_t>(FlatHashMix(hash ^ FlatHashMix(addresses ^ proto)));
+}
+
 void
 Ipv4L3Protocol::RemoveDuplicates()
 {
@@ -1827,8 +2026,8 @@ Ipv4L3Protocol::RemoveDuplicates()
 
     DupMap_t::size_type n = 0;
     Time expire = Simulator::Now();
-    auto iter = m_dups.cbegin();
-    while (iter != m_dups.cend())
+    auto iter = m_dups.begin();
+    while (iter != m_dups.end())
     {
         if (iter->second < expire)
         {
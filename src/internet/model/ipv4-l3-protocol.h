@@ -25,6 +25,7 @@
 #include "ipv4.h"
 
 #include "ns3/deprecated.h"
+#include "ns3/flat-hash-map.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/net-device.h"
 #include "ns3/nstime.h"
@@ -236,6 +237,36 @@ class Ipv4L3Protocol : public Ipv4
      */
     bool IsUnicast(Ipv4Address ad) const;
 
+    /**
+     * \brief Look up the route of a locally generated packet.
+     *
+     * When the RouteCacheSize attribute is not null and the routing protocol
+     * can cache its routes (see Ipv4RoutingProtocol::IsRouteCacheable), the
+     * unicast routes are cached per destination and output device, and
+     * reused until the routes change. Otherwise, the route is looked up by
+     * the routing protocol.
+     *
+     * \param p packet
+     * \param header IPv4 header of the packet
+     * \param oif output device, or nullptr for any device
+     * \param sockerr output parameter; socket errno
+     * \return the route, or nullptr if there is no route
+     */
+    Ptr<Ipv4Route> RouteOutput(Ptr<Packet> p,
+                               const Ipv4Header& header,
+                               Ptr<NetDevice> oif,
+                               Socket::SocketErrno& sockerr);
+
+    /**
+     * \brief Check if the routes can be cached.
+     *
+     * A cached route remains valid as long as the
+     * Ipv4RoutingProtocol::GetRoutesVersion() of the routing protocol does
+     * not change.
+     * \return true if the route cache is enabled and the routes are cacheable
+     */
+    bool IsRouteCacheEnabled() const;
+
     /**
      * TracedCallback signature for packet send, forward, or local deliver events.
      *
@@ -277,6 +308,14 @@ class Ipv4L3Protocol : public Ipv4
                                        Ptr<Ipv4> ipv4,
                                        uint32_t interface);
 
+    /**
+     * TracedCallback signature for route cache lookups.
+     *
+     * \param [in] destination the destination looked up
+     * \param [in] hit true if the route was found in the cache
+     */
+    typedef void (*RouteCacheTracedCallback)(Ipv4Address destination, bool hit);
+
   protected:
     void DoDispose() override;
     /**
@@ -358,6 +397,46 @@ class Ipv4L3Protocol : public Ipv4
                             Ptr<const Packet> p,
                             const Ipv4Header& header);
 
+    /**
+     * \brief Forward a packet and cache its route.
+     *
+     * Unicast forward callback of the routing protocol when the route
+     * of the packet being routed is to be cached.
+     *
+     * \param rtentry route
+     * \param p packet to forward
+     * \param header IPv4 header to add to the packet
+     */
+    void IpForwardCached(Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ipv4Header& header);
+
+    /**
+     * \brief Get the key of a route in the route cache.
+     * \param destination the destination
+     * \param interface the output (or input) interface, or -1 for any
+     * \param input true for the routes of forwarded packets
+     * \return the key
+     */
+    static uint64_t GetRouteCacheKey(Ipv4Address destination, int32_t interface, bool input);
+
+    /**
+     * \brief Look up a route in the route cache, flushing the stale routes.
+     * \param key the key of the route
+     * \return the route, or nullptr if not cached
+     */
+    Ptr<Ipv4Route> LookupRouteCache(uint64_t key);
+
+    /**
+     * \brief Add a route to the route cache, evicting the oldest route if it is full.
+     * \param key the key of the route
+     * \param route the route
+     */
+    void AddRouteCache(uint64_t key, Ptr<Ipv4Route> route);
+
+    /**
+     * \brief Remove all the routes from the route cache.
+     */
+    void FlushRouteCache();
+
     /**
      * \brief Deliver a packet.
      * \param p packet delivered
@@ -509,6 +588,18 @@ class Ipv4L3Protocol : public Ipv4
     /// Key identifying a fragmented packet
     typedef std::pair<uint64_t, uint32_t> FragmentKey_t;
 
+    /**
+     * \brief Hash functor of the keys of the fragmented packets.
+     */
+    struct FragmentKeyHash
+    {
+        /**
+         * \param key the key to hash
+         * \returns the hash value
+         */
+        std::size_t operator()(const FragmentKey_t& key) const;
+    };
+
     /// Container for fragment timeouts.
     typedef std::list<std::tuple<Time, FragmentKey_t, Ipv4Header, uint32_t>>
         FragmentsTimeoutsList_t;
@@ -598,9 +689,15 @@ class Ipv4L3Protocol : public Ipv4
         bool m_moreFragment;
 
         /**
-         * \brief The current fragments.
+         * \brief The current fragments, sorted by offset.
+         */
+        std::vector<std::pair<Ptr<Packet>, uint16_t>> m_fragments;
+
+        /**
+         * \brief The bytes received, as disjoint [start, end) intervals
+         *        indexed by their start.
          */
-        std::list<std::pair<Ptr<Packet>, uint16_t>> m_fragments;
+        std::map<uint32_t, uint32_t> m_received;
 
         /**
          * \brief Timeout iterator to "event" handler
@@ -609,7 +706,7 @@ class Ipv4L3Protocol : public Ipv4
     };
 
     /// Container of fragments, stored as pairs(src+dst addr, src+dst port) / fragment
-    typedef std::map<FragmentKey_t, Ptr<Fragments>> MapFragments_t;
+    typedef FlatHashMap<FragmentKey_t, Ptr<Fragments>, FragmentKeyHash> MapFragments_t;
 
     MapFragments_t m_fragments;       //!< Fragmented packets.
     Time m_fragmentExpirationTimeout; //!< Expiration timeout
@@ -618,8 +715,21 @@ class Ipv4L3Protocol : public Ipv4
     /// RFC 6621 recommended duplicate packet tuple: {IPV hash, IP protocol, IP source address, IP
     /// destination address}
     typedef std::tuple<uint64_t, uint8_t, Ipv4Address, Ipv4Address> DupTuple_t;
+
+    /**
+     * \brief Hash functor of the duplicate packet tuples.
+     */
+    struct DupTupleHash
+    {
+        /**
+         * \param tuple the tuple to hash
+         * \returns the hash value
+         */
+        std::size_t operator()(const DupTuple_t& tuple) const;
+    };
+
     /// Maps packet duplicate tuple to expiration time
-    typedef std::map<DupTuple_t, Time> DupMap_t;
+    typedef FlatHashMap<DupTuple_t, Time, DupTupleHash> DupMap_t;
 
     /**
      * Registers duplicate entry, return false if new
@@ -643,6 +753,24 @@ class Ipv4L3Protocol : public Ipv4
     Ipv4RoutingProtocol::MulticastForwardCallback m_mcb; ///< Multicast forward callback
     Ipv4RoutingProtocol::LocalDeliverCallback m_lcb;     ///< Local delivery callback
     Ipv4RoutingProtocol::ErrorCallback m_ecb;            ///< Error callback
+
+    /// Container of the cached routes, indexed by GetRouteCacheKey
+    typedef FlatHashMap<uint64_t, Ptr<Ipv4Route>> RouteCache_t;
+
+    uint32_t m_routeCacheSize;     //!< Maximum number of cached routes, 0 to disable the cache
+    RouteCache_t m_routeCache;     //!< Cached routes
+    uint64_t m_routeCacheVersion;  //!< Version of the routes when they were cached
+    uint64_t m_routeCacheInputKey; //!< Key of the route of the packet being routed
+    bool m_routeCacheInput;        //!< True if the route of the packet being routed is cached
+    Ipv4RoutingProtocol::UnicastForwardCallback m_cacheUcb; ///< Caching unicast forward callback
+
+    /// Keys of the cached routes, a circular buffer in the order they were cached
+    std::vector<uint64_t> m_routeCacheKeys;
+    /// Index in m_routeCacheKeys of the oldest key, once the cache is full
+    std::size_t m_routeCacheOldest;
+
+    /// Trace of the route cache lookups
+    TracedCallback<Ipv4Address, bool> m_routeCacheTrace;
 };
 
 } // Namespace ns3
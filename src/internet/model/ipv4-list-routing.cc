@@ -24,6 +24,8 @@
 #include "ns3/log.h"
 #include "ns3/node.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -234,6 +236,26 @@ Ipv4ListRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress ad
     }
 }
 
+bool
+Ipv4ListRouting::IsRouteCacheable() const
+{
+    return std::all_of(m_routingProtocols.begin(),
+                       m_routingProtocols.end(),
+                       [](const auto& protocol) { return protocol.second->IsRouteCacheable(); });
+}
+
+uint64_t
+Ipv4ListRouting::GetRoutesVersion() const
+{
+    // the versions only increase, so their sum changes with any of them
+    uint64_t version = Ipv4RoutingProtocol::GetRoutesVersion();
+    for (const auto& protocol : m_routingProtocols)
+    {
+        version += protocol.second->GetRoutesVersion();
+    }
+    return version;
+}
+
 void
 Ipv4ListRouting::SetIpv4(Ptr<Ipv4> ipv4)
 {
@@ -257,6 +279,7 @@ Ipv4ListRouting::AddRoutingProtocol(Ptr<Ipv4RoutingProtocol> routingProtocol, in
     {
         routingProtocol->SetIpv4(m_ipv4);
     }
+    NotifyRoutesChanged();
 }
 
 uint32_t
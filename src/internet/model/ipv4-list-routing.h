@@ -100,6 +100,12 @@ class Ipv4ListRouting : public Ipv4RoutingProtocol
     void SetIpv4(Ptr<Ipv4> ipv4) override;
     void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                            Time::Unit unit = Time::S) const override;
+    bool IsRouteCacheable() const override;
+    /**
+     * \brief Get the version of the routes.
+     * \return a number changed whenever the routes of any of the protocols change
+     */
+    uint64_t GetRoutesVersion() const override;
 
   protected:
     void DoDispose() override;
@@ -22,6 +22,8 @@
 
 #include "ns3/log.h"
 
+#include <cstring>
+
 namespace ns3
 {
 
@@ -33,7 +35,10 @@ Ipv4QueueDiscItem::Ipv4QueueDiscItem(Ptr<Packet> p,
                                      const Ipv4Header& header)
     : QueueDiscItem(p, addr, protocol),
       m_header(header),
-      m_headerAdded(false)
+      m_headerAdded(false),
+      m_hashValid(false),
+      m_hashPerturbation(0),
+      m_hash(0)
 {
 }
 
@@ -120,42 +125,23 @@ Ipv4QueueDiscItem::Hash(uint32_t perturbation) const
 {
     NS_LOG_FUNCTION(this << perturbation);
 
-    Ipv4Address src = m_header.GetSource();
-    Ipv4Address dest = m_header.GetDestination();
-    uint8_t prot = m_header.GetProtocol();
-    uint16_t fragOffset = m_header.GetFragmentOffset();
-
-    TcpHeader tcpHdr;
-    UdpHeader udpHdr;
-    uint16_t srcPort = 0;
-    uint16_t destPort = 0;
-
-    if (prot == 6 && fragOffset == 0) // TCP
+    if (m_hashValid && m_hashPerturbation == perturbation)
     {
-        GetPacket()->PeekHeader(tcpHdr);
-        srcPort = tcpHdr.GetSourcePort();
-        destPort = tcpHdr.GetDestinationPort();
-    }
-    else if (prot == 17 && fragOffset == 0) // UDP
-    {
-        GetPacket()->PeekHeader(udpHdr);
-        srcPort = udpHdr.GetSourcePort();
-        destPort = udpHdr.GetDestinationPort();
-    }
-    if (prot != 6 && prot != 17)
-    {
-        NS_LOG_WARN("Unknown transport protocol, no port number included in hash computation");
+        return m_hash;
     }
 
+    const FiveTuple* tuple = GetFiveTuple();
+    NS_ASSERT(tuple);
+
     /* serialize the 5-tuple and the perturbation in buf */
     uint8_t buf[17];
-    src.Serialize(buf);
-    dest.Serialize(buf + 4);
-    buf[8] = prot;
-    buf[9] = (srcPort >> 8) & 0xff;
-    buf[10] = srcPort & 0xff;
-    buf[11] = (destPort >> 8) & 0xff;
-    buf[12] = destPort & 0xff;
+    std::memcpy(buf, tuple->source, 4);
+    std::memcpy(buf + 4, tuple->destination, 4);
+    buf[8] = tuple->protocol;
+    buf[9] = (tuple->sourcePort >> 8) & 0xff;
+    buf[10] = tuple->sourcePort & 0xff;
+    buf[11] = (tuple->destinationPort >> 8) & 0xff;
+    buf[12] = tuple->destinationPort & 0xff;
     buf[13] = (perturbation >> 24) & 0xff;
     buf[14] = (perturbation >> 16) & 0xff;
     buf[15] = (perturbation >> 8) & 0xff;
@@ -163,11 +149,45 @@ Ipv4QueueDiscItem::Hash(uint32_t perturbation) const
 
     // Linux calculates jhash2 (jenkins hash), we calculate murmur3 because it is
     // already available in ns-3
-    uint32_t hash = Hash32((char*)buf, 17);
+    m_hash = Hash32((char*)buf, 17);
+    m_hashPerturbation = perturbation;
+    m_hashValid = true;
 
-    NS_LOG_DEBUG("Hash value " << hash);
+    NS_LOG_DEBUG("Hash value " << m_hash);
 
-    return hash;
+    return m_hash;
+}
+
+bool
+Ipv4QueueDiscItem::ParseFiveTuple(FiveTuple& tuple) const
+{
+    NS_LOG_FUNCTION(this);
+
+    m_header.GetSource().Serialize(tuple.source);
+    m_header.GetDestination().Serialize(tuple.destination);
+    tuple.version = 4;
+    tuple.protocol = m_header.GetProtocol();
+    bool firstFragment = (m_header.GetFragmentOffset() == 0);
+
+    if (tuple.protocol == 6 && firstFragment) // TCP
+    {
+        TcpHeader tcpHdr;
+        GetPacket()->PeekHeader(tcpHdr);
+        tuple.sourcePort = tcpHdr.GetSourcePort();
+        tuple.destinationPort = tcpHdr.GetDestinationPort();
+    }
+    else if (tuple.protocol == 17 && firstFragment) // UDP
+    {
+        UdpHeader udpHdr;
+        GetPacket()->PeekHeader(udpHdr);
+        tuple.sourcePort = udpHdr.GetSourcePort();
+        tuple.destinationPort = udpHdr.GetDestinationPort();
+    }
+    if (tuple.protocol != 6 && tuple.protocol != 17)
+    {
+        NS_LOG_WARN("Unknown transport protocol, no port number included in the 5-tuple");
+    }
+    return true;
 }
 
 } // namespace ns3
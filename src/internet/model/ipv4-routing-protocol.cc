@@ -35,4 +35,23 @@ Ipv4RoutingProtocol::GetTypeId()
     return tid;
 }
 
+bool
+Ipv4RoutingProtocol::IsRouteCacheable() const
+{
+    return false;
+}
+
+void
+Ipv4RoutingProtocol::NotifyRoutesChanged()
+{
+    // the global routes of a node are computed by a single thread
+    m_routesVersion++;
+}
+
+uint64_t
+Ipv4RoutingProtocol::GetRoutesVersion() const
+{
+    return m_routesVersion;
+}
+
 } // namespace ns3
@@ -181,6 +181,36 @@ class Ipv4RoutingProtocol : public Object
      */
     virtual void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                                    Time::Unit unit = Time::S) const = 0;
+
+    /**
+     * \brief Check if the routes of this protocol can be cached.
+     *
+     * Ipv4L3Protocol can cache the unicast routes returned by RouteOutput()
+     * and passed to the unicast forward callback of RouteInput(), per
+     * destination and interface, if they depend on nothing else and the
+     * protocol calls NotifyRoutesChanged() whenever its routes change.
+     *
+     * \return true if the routes can be cached (false by default)
+     */
+    virtual bool IsRouteCacheable() const;
+
+    /**
+     * \brief Invalidate the routes cached by Ipv4L3Protocol.
+     *
+     * To be called by the cacheable protocols whenever their routes change,
+     * and by Ipv4L3Protocol whenever its interfaces change. Only the routes
+     * cached by the node of this protocol are invalidated.
+     */
+    void NotifyRoutesChanged();
+
+    /**
+     * \brief Get the version of the routes.
+     * \return a number changed by each call to NotifyRoutesChanged()
+     */
+    virtual uint64_t GetRoutesVersion() const;
+
+  private:
+    uint64_t m_routesVersion{0}; //!< Version of the routes, see GetRoutesVersion
 };
 
 } // namespace ns3
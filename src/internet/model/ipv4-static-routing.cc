@@ -36,7 +36,9 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
+#include <iterator>
 
 using std::make_pair;
 
@@ -47,6 +49,18 @@ NS_LOG_COMPONENT_DEFINE("Ipv4StaticRouting");
 
 NS_OBJECT_ENSURE_REGISTERED(Ipv4StaticRouting);
 
+/**
+ * \brief Check whether a mask is made of contiguous leading ones.
+ * \param mask the mask
+ * \return true if the mask is contiguous
+ */
+static bool
+IsContiguous(Ipv4Mask mask)
+{
+    uint32_t inverse = ~mask.Get();
+    return (inverse & (inverse + 1)) == 0;
+}
+
 TypeId
 Ipv4StaticRouting::GetTypeId()
 {
@@ -58,7 +72,8 @@ Ipv4StaticRouting::GetTypeId()
 }
 
 Ipv4StaticRouting::Ipv4StaticRouting()
-    : m_ipv4(nullptr)
+    : m_nonContiguousRoutes(0),
+      m_ipv4(nullptr)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -78,8 +93,7 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
 
     if (!LookupRoute(route, metric))
     {
-        auto routePtr = new Ipv4RoutingTableEntry(route);
-        m_networkRoutes.emplace_back(routePtr, metric);
+        InsertNetworkRoute(new Ipv4RoutingTableEntry(route), metric);
     }
 }
 
@@ -95,9 +109,7 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
         Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface);
     if (!LookupRoute(route, metric))
     {
-        auto routePtr = new Ipv4RoutingTableEntry(route);
-
-        m_networkRoutes.emplace_back(routePtr, metric);
+        InsertNetworkRoute(new Ipv4RoutingTableEntry(route), metric);
     }
 }
 
@@ -152,7 +164,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv4Address network("224.0.0.0");
     Ipv4Mask networkMask("240.0.0.0");
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
-    m_networkRoutes.emplace_back(route, 0);
+    InsertNetworkRoute(route, 0);
 }
 
 uint32_t
@@ -221,22 +233,68 @@ Ipv4StaticRouting::RemoveMulticastRoute(uint32_t index)
     }
 }
 
-bool
-Ipv4StaticRouting::LookupRoute(const Ipv4RoutingTableEntry& route, uint32_t metric)
+void
+Ipv4StaticRouting::InsertNetworkRoute(Ipv4RoutingTableEntry* route, uint32_t metric)
 {
-    for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+    NotifyRoutesChanged();
+    m_networkRoutes.emplace_back(route, metric);
+    Ipv4Mask mask = route->GetDestNetworkMask();
+    if (IsContiguous(mask))
+    {
+        m_networkRoutesTrie.Insert(NetworkRoutesTrie::GetKey(route->GetDestNetwork()),
+                                   mask.GetPrefixLength(),
+                                   std::prev(m_networkRoutes.end()));
+    }
+    else
     {
-        Ipv4RoutingTableEntry* rtentry = j->first;
+        m_nonContiguousRoutes++;
+    }
+}
 
-        if (rtentry->GetDest() == route.GetDest() &&
-            rtentry->GetDestNetworkMask() == route.GetDestNetworkMask() &&
-            rtentry->GetGateway() == route.GetGateway() &&
-            rtentry->GetInterface() == route.GetInterface() && j->second == metric)
-        {
-            return true;
-        }
+Ipv4StaticRouting::NetworkRoutesI
+Ipv4StaticRouting::EraseNetworkRoute(NetworkRoutesI it)
+{
+    NotifyRoutesChanged();
+    Ipv4Mask mask = it->first->GetDestNetworkMask();
+    if (IsContiguous(mask))
+    {
+        bool removed =
+            m_networkRoutesTrie.Remove(NetworkRoutesTrie::GetKey(it->first->GetDestNetwork()),
+                                       mask.GetPrefixLength(),
+                                       it);
+        NS_ASSERT(removed);
     }
-    return false;
+    else
+    {
+        m_nonContiguousRoutes--;
+    }
+    delete it->first;
+    return m_networkRoutes.erase(it);
+}
+
+bool
+Ipv4StaticRouting::LookupRoute(const Ipv4RoutingTableEntry& route, uint32_t metric)
+{
+    auto isSame = [&route, metric](const std::pair<Ipv4RoutingTableEntry*, uint32_t>& j) {
+        Ipv4RoutingTableEntry* rtentry = j.first;
+        return rtentry->GetDest() == route.GetDest() &&
+               rtentry->GetDestNetworkMask() == route.GetDestNetworkMask() &&
+               rtentry->GetGateway() == route.GetGateway() &&
+               rtentry->GetInterface() == route.GetInterface() && j.second == metric;
+    };
+
+    Ipv4Mask mask = route.GetDestNetworkMask();
+    if (IsContiguous(mask))
+    {
+        // identical routes have the same prefix
+        const std::vector<NetworkRoutesI>* routes =
+            m_networkRoutesTrie.Find(NetworkRoutesTrie::GetKey(route.GetDestNetwork()),
+                                     mask.GetPrefixLength());
+        return routes && std::any_of(routes->begin(), routes->end(), [&isSame](NetworkRoutesI j) {
+                   return isSame(*j);
+               });
+    }
+    return std::any_of(m_networkRoutes.begin(), m_networkRoutes.end(), isSame);
 }
 
 Ptr<Ipv4Route>
@@ -244,8 +302,6 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
 {
     NS_LOG_FUNCTION(this << dest << " " << oif);
     Ptr<Ipv4Route> rtentry = nullptr;
-    uint16_t longest_mask = 0;
-    uint32_t shortest_metric = 0xffffffff;
     /* when sending on local multicast, there have to be interface specified */
     if (dest.IsLocalMulticast())
     {
@@ -261,56 +317,99 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
         return rtentry;
     }
 
-    for (auto i = m_networkRoutes.begin(); i != m_networkRoutes.end(); i++)
+    Ipv4RoutingTableEntry* route = nullptr;
+    if (m_nonContiguousRoutes == 0)
     {
-        Ipv4RoutingTableEntry* j = i->first;
-        uint32_t metric = i->second;
-        Ipv4Mask mask = (j)->GetDestNetworkMask();
-        uint16_t masklen = mask.GetPrefixLength();
-        Ipv4Address entry = (j)->GetDestNetwork();
-        NS_LOG_LOGIC("Searching for route to " << dest << ", checking against route to " << entry
-                                               << "/" << masklen);
-        if (mask.IsMatch(dest, entry))
+        // The trie enumerates the matching prefixes from the longest one; the
+        // routes of a prefix are in the order of the forwarding table
+        m_networkRoutesTrie.Match(
+            NetworkRoutesTrie::GetKey(dest),
+            [this, &route, oif](uint16_t masklen, const std::vector<NetworkRoutesI>& routes) {
+                uint32_t shortest_metric = 0xffffffff;
+                for (NetworkRoutesI i : routes)
+                {
+                    Ipv4RoutingTableEntry* j = i->first;
+                    uint32_t metric = i->second;
+                    NS_LOG_LOGIC("Found global network route " << j << ", mask length " << masklen
+                                                               << ", metric " << metric);
+                    if (oif && oif != m_ipv4->GetNetDevice(j->GetInterface()))
+                    {
+                        NS_LOG_LOGIC("Not on requested interface, skipping");
+                        continue;
+                    }
+                    if (metric > shortest_metric)
+                    {
+                        NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
+                        continue;
+                    }
+                    shortest_metric = metric;
+                    route = j;
+                    if (masklen == 32)
+                    {
+                        break;
+                    }
+                }
+                return route != nullptr;
+            });
+    }
+    else
+    {
+        uint16_t longest_mask = 0;
+        uint32_t shortest_metric = 0xffffffff;
+        for (auto i = m_networkRoutes.begin(); i != m_networkRoutes.end(); i++)
         {
-            NS_LOG_LOGIC("Found global network route " << j << ", mask length " << masklen
-                                                       << ", metric " << metric);
-            if (oif)
+            Ipv4RoutingTableEntry* j = i->first;
+            uint32_t metric = i->second;
+            Ipv4Mask mask = (j)->GetDestNetworkMask();
+            uint16_t masklen = mask.GetPrefixLength();
+            Ipv4Address entry = (j)->GetDestNetwork();
+            NS_LOG_LOGIC("Searching for route to " << dest << ", checking against route to "
+                                                   << entry << "/" << masklen);
+            if (mask.IsMatch(dest, entry))
             {
-                if (oif != m_ipv4->GetNetDevice(j->GetInterface()))
+                NS_LOG_LOGIC("Found global network route " << j << ", mask length " << masklen
+                                                           << ", metric " << metric);
+                if (oif)
                 {
-                    NS_LOG_LOGIC("Not on requested interface, skipping");
+                    if (oif != m_ipv4->GetNetDevice(j->GetInterface()))
+                    {
+                        NS_LOG_LOGIC("Not on requested interface, skipping");
+                        continue;
+                    }
+                }
+                if (masklen < longest_mask) // Not interested if got shorter mask
+                {
+                    NS_LOG_LOGIC("Previous match longer, skipping");
                     continue;
                 }
-            }
-            if (masklen < longest_mask) // Not interested if got shorter mask
-            {
-                NS_LOG_LOGIC("Previous match longer, skipping");
-                continue;
-            }
-            if (masklen > longest_mask) // Reset metric if longer masklen
-            {
-                shortest_metric = 0xffffffff;
-            }
-            longest_mask = masklen;
-            if (metric > shortest_metric)
-            {
-                NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
-                continue;
-            }
-            shortest_metric = metric;
-            Ipv4RoutingTableEntry* route = (j);
-            uint32_t interfaceIdx = route->GetInterface();
-            rtentry = Create<Ipv4Route>();
-            rtentry->SetDestination(route->GetDest());
-            rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
-            rtentry->SetGateway(route->GetGateway());
-            rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
-            if (masklen == 32)
-            {
-                break;
+                if (masklen > longest_mask) // Reset metric if longer masklen
+                {
+                    shortest_metric = 0xffffffff;
+                }
+                longest_mask = masklen;
+                if (metric > shortest_metric)
+                {
+                    NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
+                    continue;
+                }
+                shortest_metric = metric;
+                route = j;
+                if (masklen == 32)
+                {
+                    break;
+                }
             }
         }
     }
+    if (route)
+    {
+        uint32_t interfaceIdx = route->GetInterface();
+        rtentry = Create<Ipv4Route>();
+        rtentry->SetDestination(route->GetDest());
+        rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
+        rtentry->SetGateway(route->GetGateway());
+        rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
+    }
     if (rtentry)
     {
         NS_LOG_LOGIC("Matching route via " << rtentry->GetGateway() << " at the end");
@@ -457,8 +556,7 @@ Ipv4StaticRouting::RemoveRoute(uint32_t index)
     {
         if (tmp == index)
         {
-            delete j->first;
-            m_networkRoutes.erase(j);
+            EraseNetworkRoute(j);
             return;
         }
         tmp++;
@@ -592,6 +690,8 @@ Ipv4StaticRouting::DoDispose()
     {
         delete (j->first);
     }
+    m_networkRoutesTrie.Clear();
+    m_nonContiguousRoutes = 0;
     for (auto i = m_multicastRoutes.begin(); i != m_multicastRoutes.end();
          i = m_multicastRoutes.erase(i))
     {
@@ -631,8 +731,7 @@ Ipv4StaticRouting::NotifyInterfaceDown(uint32_t i)
     {
         if (it->first->GetInterface() == i)
         {
-            delete it->first;
-            it = m_networkRoutes.erase(it);
+            it = EraseNetworkRoute(it);
         }
         else
         {
@@ -676,8 +775,7 @@ Ipv4StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
             it->first->GetDestNetwork() == networkAddress &&
             it->first->GetDestNetworkMask() == networkMask)
         {
-            delete it->first;
-            it = m_networkRoutes.erase(it);
+            it = EraseNetworkRoute(it);
         }
         else
         {
@@ -686,6 +784,12 @@ Ipv4StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
     }
 }
 
+bool
+Ipv4StaticRouting::IsRouteCacheable() const
+{
+    return true;
+}
+
 void
 Ipv4StaticRouting::SetIpv4(Ptr<Ipv4> ipv4)
 {
@@ -26,6 +26,7 @@
 #include "ipv4.h"
 
 #include "ns3/ipv4-address.h"
+#include "ns3/prefix-trie.h"
 #include "ns3/ptr.h"
 #include "ns3/socket.h"
 
@@ -56,6 +57,12 @@ class Node;
  * Ipv4ListRouting protocol but can be used also as a standalone
  * protocol.
  *
+ * The network routes are kept in a list, which defines the route indexes
+ * (see GetRoute), and indexed by a longest prefix match trie, so that the
+ * cost of a lookup does not grow with the number of routes. Among the
+ * matching routes with the longest prefix, the route with the lowest
+ * metric is selected.
+ *
  * The Ipv4StaticRouting class inherits from the abstract base class
  * Ipv4RoutingProtocol that defines the interface methods that a routing
  * protocol must support.
@@ -96,6 +103,7 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
     void SetIpv4(Ptr<Ipv4> ipv4) override;
     void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
                            Time::Unit unit = Time::S) const override;
+    bool IsRouteCacheable() const override;
 
     /**
      * \brief Add a network route to the static routing table.
@@ -381,6 +389,23 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
     /// Iterator for container for the multicast routes
     typedef std::list<Ipv4MulticastRoutingTableEntry*>::iterator MulticastRoutesI;
 
+    /// Longest prefix match index of the network routes
+    typedef PrefixTrie<NetworkRoutesI, 4> NetworkRoutesTrie;
+
+    /**
+     * \brief Append a route to the forwarding table for network.
+     * \param route the route (ownership is transferred to the table)
+     * \param metric metric of route
+     */
+    void InsertNetworkRoute(Ipv4RoutingTableEntry* route, uint32_t metric);
+
+    /**
+     * \brief Remove a route from the forwarding table for network.
+     * \param it iterator to the route
+     * \return iterator to the following route
+     */
+    NetworkRoutesI EraseNetworkRoute(NetworkRoutesI it);
+
     /**
      * \brief Checks if a route is already present in the forwarding table.
      * \param route route
@@ -411,6 +436,19 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
      */
     NetworkRoutes m_networkRoutes;
 
+    /**
+     * \brief Index of the network routes by destination prefix.
+     *
+     * Routes whose mask is not contiguous can not be indexed: while there
+     * are any, lookups scan the whole forwarding table.
+     */
+    NetworkRoutesTrie m_networkRoutesTrie;
+
+    /**
+     * \brief Number of network routes whose mask is not contiguous.
+     */
+    uint32_t m_nonContiguousRoutes;
+
     /**
      * \brief the forwarding table for multicast.
      */
@@ -23,6 +23,8 @@
 
 #include "ns3/log.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -42,29 +44,137 @@ Ipv6EndPointDemux::~Ipv6EndPointDemux()
     for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
     {
         Ipv6EndPoint* endPoint = *i;
+        endPoint->m_demux = nullptr;
         delete endPoint;
     }
     m_endPoints.clear();
+    m_positions.clear();
+    m_ports.clear();
+    m_connected.clear();
 }
 
 bool
-Ipv6EndPointDemux::LookupPortLocal(uint16_t port)
+Ipv6EndPointDemux::ConnectedKey::operator==(const ConnectedKey& other) const
 {
-    NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    return peerAddress == other.peerAddress && peerPort == other.peerPort &&
+           localPort == other.localPort;
+}
+
+std::size_t
+Ipv6EndPointDemux::ConnectedKeyHash::operator()(const ConnectedKey& key) const
+{
+    return FlatHash<Ipv6Address>()(key.peerAddress) ^
+           static_cast<std::size_t>(FlatHashMix((key.peerPort << 16) | key.localPort));
+}
+
+bool
+Ipv6EndPointDemux::IsConnected(Ipv6Address peerAddress, uint16_t peerPort)
+{
+    return peerPort != 0 && peerAddress != Ipv6Address::GetAny();
+}
+
+const std::vector<Ipv6EndPoint*>&
+Ipv6EndPointDemux::GetConnected(Ipv6Address peerAddress,
+                                uint16_t peerPort,
+                                uint16_t localPort) const
+{
+    static const std::vector<Ipv6EndPoint*> none;
+    auto found = m_connected.find({peerAddress, peerPort, localPort});
+    return found != m_connected.end() ? found->second : none;
+}
+
+const std::vector<Ipv6EndPoint*>&
+Ipv6EndPointDemux::GetWildcards(uint16_t localPort) const
+{
+    static const std::vector<Ipv6EndPoint*> none;
+    auto found = m_ports.find(localPort);
+    return found != m_ports.end() ? found->second.wildcards : none;
+}
+
+void
+Ipv6EndPointDemux::Insert(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    m_endPoints.push_back(endPoint);
+    m_positions[endPoint] = std::prev(m_endPoints.end());
+    endPoint->m_demux = this;
+    Index(endPoint);
+}
+
+void
+Ipv6EndPointDemux::Index(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    PortEndPoints& port = m_ports[endPoint->GetLocalPort()];
+    port.count++;
+    if (IsConnected(endPoint->GetPeerAddress(), endPoint->GetPeerPort()))
+    {
+        m_connected[{endPoint->GetPeerAddress(), endPoint->GetPeerPort(), endPoint->GetLocalPort()}]
+            .push_back(endPoint);
+    }
+    else
     {
-        if ((*i)->GetLocalPort() == port)
+        port.wildcards.push_back(endPoint);
+    }
+}
+
+void
+Ipv6EndPointDemux::Unindex(Ipv6EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    auto port = m_ports.find(endPoint->GetLocalPort());
+    NS_ASSERT(port != m_ports.end());
+    if (IsConnected(endPoint->GetPeerAddress(), endPoint->GetPeerPort()))
+    {
+        auto connected = m_connected.find(
+            {endPoint->GetPeerAddress(), endPoint->GetPeerPort(), endPoint->GetLocalPort()});
+        NS_ASSERT(connected != m_connected.end());
+        std::vector<Ipv6EndPoint*>& endPoints = connected->second;
+        endPoints.erase(std::find(endPoints.begin(), endPoints.end(), endPoint));
+        if (endPoints.empty())
         {
-            return true;
+            m_connected.erase(connected);
         }
     }
-    return false;
+    else
+    {
+        std::vector<Ipv6EndPoint*>& wildcards = port->second.wildcards;
+        wildcards.erase(std::find(wildcards.begin(), wildcards.end(), endPoint));
+    }
+    if (--port->second.count == 0)
+    {
+        m_ports.erase(port);
+    }
+}
+
+bool
+Ipv6EndPointDemux::LookupPortLocal(uint16_t port)
+{
+    NS_LOG_FUNCTION(this << port);
+    return m_ports.count(port) != 0;
 }
 
 bool
 Ipv6EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv6Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
+    auto found = m_ports.find(port);
+    if (found == m_ports.end())
+    {
+        return false;
+    }
+    for (const auto endPoint : found->second.wildcards)
+    {
+        if (endPoint->GetLocalAddress() == addr && endPoint->GetBoundNetDevice() == boundNetDevice)
+        {
+            return true;
+        }
+    }
+    if (found->second.count == found->second.wildcards.size())
+    {
+        return false;
+    }
+    // the connected endpoints are not indexed by local port alone
     for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
     {
         if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
@@ -87,7 +197,7 @@ Ipv6EndPointDemux::Allocate()
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(Ipv6Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -103,7 +213,7 @@ Ipv6EndPointDemux::Allocate(Ipv6Address address)
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -126,7 +236,7 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv6Address address,
         return nullptr;
     }
     auto endPoint = new Ipv6EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -139,7 +249,11 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << boundNetDevice << localAddress << localPort << peerAddress << peerPort);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    // a duplicate has the same peer, hence is indexed in the same way
+    const std::vector<Ipv6EndPoint*>& candidates =
+        IsConnected(peerAddress, peerPort) ? GetConnected(peerAddress, peerPort, localPort)
+                                           : GetWildcards(localPort);
+    for (auto i = candidates.begin(); i != candidates.end(); i++)
     {
         if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
             (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
@@ -151,7 +265,7 @@ Ipv6EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
     }
     auto endPoint = new Ipv6EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
 
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
 
@@ -162,14 +276,14 @@ void
 Ipv6EndPointDemux::DeAllocate(Ipv6EndPoint* endPoint)
 {
     NS_LOG_FUNCTION(this);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto position = m_positions.find(endPoint);
+    if (position != m_positions.end())
     {
-        if (*i == endPoint)
-        {
-            delete endPoint;
-            m_endPoints.erase(i);
-            break;
-        }
+        Unindex(endPoint);
+        m_endPoints.erase(position->second);
+        m_positions.erase(position);
+        endPoint->m_demux = nullptr;
+        delete endPoint;
     }
 }
 
@@ -193,9 +307,13 @@ Ipv6EndPointDemux::Lookup(Ipv6Address daddr,
     EndPoints retval4; /* Exact match on all 4 */
 
     NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    // Only the endpoints connected to the source of the packet, and the ones
+    // bound to the destination port without being connected, may match.
+    const std::vector<Ipv6EndPoint*>& connected = GetConnected(saddr, sport, dport);
+    const std::vector<Ipv6EndPoint*>& wildcards = GetWildcards(dport);
+    for (std::size_t i = 0; i < connected.size() + wildcards.size(); i++)
     {
-        Ipv6EndPoint* endP = *i;
+        Ipv6EndPoint* endP = i < connected.size() ? connected[i] : wildcards[i - connected.size()];
 
         NS_LOG_DEBUG("Looking at endpoint dport="
                      << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
@@ -310,6 +428,18 @@ Ipv6EndPointDemux::Lookup(Ipv6Address daddr,
 Ipv6EndPoint*
 Ipv6EndPointDemux::SimpleLookup(Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport)
 {
+    // an exact match is indexed like any endpoint with the same peer
+    const std::vector<Ipv6EndPoint*>& candidates =
+        IsConnected(src, sport) ? GetConnected(src, sport, dport) : GetWildcards(dport);
+    for (const auto endPoint : candidates)
+    {
+        if (endPoint->GetLocalPort() == dport && endPoint->GetLocalAddress() == dst &&
+            endPoint->GetPeerPort() == sport && endPoint->GetPeerAddress() == src)
+        {
+            return endPoint;
+        }
+    }
+
     uint32_t genericity = 3;
     Ipv6EndPoint* generic = nullptr;
 
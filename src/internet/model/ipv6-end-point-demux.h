@@ -22,10 +22,12 @@
 
 #include "ipv6-interface.h"
 
+#include "ns3/flat-hash-map.h"
 #include "ns3/ipv6-address.h"
 
 #include <list>
 #include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
@@ -36,6 +38,10 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The endpoints connected to a peer are indexed by their peer address,
+ * peer port and local port, and the other ones by their local port, so that
+ * a lookup only examines the endpoints which may match.
  */
 class Ipv6EndPointDemux
 {
@@ -161,6 +167,89 @@ class Ipv6EndPointDemux
     EndPoints GetEndPoints() const;
 
   private:
+    friend class Ipv6EndPoint;
+
+    /**
+     * \brief The endpoints bound to a local port.
+     */
+    struct PortEndPoints
+    {
+        uint32_t count{0};                    //!< the number of endpoints
+        std::vector<Ipv6EndPoint*> wildcards; //!< the endpoints not connected to a peer
+    };
+
+    /**
+     * \brief The key of the endpoints connected to a peer.
+     */
+    struct ConnectedKey
+    {
+        Ipv6Address peerAddress; //!< the peer address
+        uint16_t peerPort{0};    //!< the peer port
+        uint16_t localPort{0};   //!< the local port
+
+        /**
+         * \param other the key to compare with
+         * \returns true if the keys are equal
+         */
+        bool operator==(const ConnectedKey& other) const;
+    };
+
+    /**
+     * \brief Hash functor of the keys of the endpoints connected to a peer.
+     */
+    struct ConnectedKeyHash
+    {
+        /**
+         * \param key the key to hash
+         * \returns the hash value
+         */
+        std::size_t operator()(const ConnectedKey& key) const;
+    };
+
+    /**
+     * \brief Check whether an endpoint is connected to a peer.
+     * \param peerAddress the peer address of the endpoint
+     * \param peerPort the peer port of the endpoint
+     * \returns true if both the peer address and the peer port are set
+     */
+    static bool IsConnected(Ipv6Address peerAddress, uint16_t peerPort);
+
+    /**
+     * \brief Get the endpoints connected to a peer.
+     * \param peerAddress the peer address
+     * \param peerPort the peer port
+     * \param localPort the local port
+     * \returns the endpoints
+     */
+    const std::vector<Ipv6EndPoint*>& GetConnected(Ipv6Address peerAddress,
+                                                   uint16_t peerPort,
+                                                   uint16_t localPort) const;
+
+    /**
+     * \brief Get the endpoints bound to a local port and not connected to a peer.
+     * \param localPort the local port
+     * \returns the endpoints
+     */
+    const std::vector<Ipv6EndPoint*>& GetWildcards(uint16_t localPort) const;
+
+    /**
+     * \brief Add an endpoint to the container and to the indexes.
+     * \param endPoint the endpoint
+     */
+    void Insert(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Add an endpoint to the port and connection indexes.
+     * \param endPoint the endpoint
+     */
+    void Index(Ipv6EndPoint* endPoint);
+
+    /**
+     * \brief Remove an endpoint from the port and connection indexes.
+     * \param endPoint the endpoint
+     */
+    void Unindex(Ipv6EndPoint* endPoint);
+
     /**
      * \brief Allocate a ephemeral port.
      * \return a port
@@ -186,6 +275,22 @@ class Ipv6EndPointDemux
      * \brief A list of IPv6 end points.
      */
     EndPoints m_endPoints;
+
+    /**
+     * \brief The position of the end points in the list.
+     */
+    FlatHashMap<Ipv6EndPoint*, EndPointsI> m_positions;
+
+    /**
+     * \brief The end points bound to each local port.
+     */
+    FlatHashMap<uint16_t, PortEndPoints> m_ports;
+
+    /**
+     * \brief The end points connected to a peer, by peer address, peer port
+     * and local port.
+     */
+    FlatHashMap<ConnectedKey, std::vector<Ipv6EndPoint*>, ConnectedKeyHash> m_connected;
 };
 
 } /* namespace ns3 */
@@ -19,6 +19,8 @@
 
 #include "ipv6-end-point.h"
 
+#include "ipv6-end-point-demux.h"
+
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
@@ -33,7 +35,8 @@ Ipv6EndPoint::Ipv6EndPoint(Ipv6Address addr, uint16_t port)
       m_localPort(port),
       m_peerAddr(Ipv6Address::GetAny()),
       m_peerPort(0),
-      m_rxEnabled(true)
+      m_rxEnabled(true),
+      m_demux(nullptr)
 {
 }
 
@@ -69,7 +72,15 @@ Ipv6EndPoint::GetLocalPort() const
 void
 Ipv6EndPoint::SetLocalPort(uint16_t port)
 {
+    if (m_demux)
+    {
+        m_demux->Unindex(this);
+    }
     m_localPort = port;
+    if (m_demux)
+    {
+        m_demux->Index(this);
+    }
 }
 
 Ipv6Address
@@ -99,8 +110,16 @@ Ipv6EndPoint::GetBoundNetDevice() const
 void
 Ipv6EndPoint::SetPeer(Ipv6Address addr, uint16_t port)
 {
+    if (m_demux)
+    {
+        m_demux->Unindex(this);
+    }
     m_peerAddr = addr;
     m_peerPort = port;
+    if (m_demux)
+    {
+        m_demux->Index(this);
+    }
 }
 
 void
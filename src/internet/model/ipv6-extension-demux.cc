@@ -64,6 +64,7 @@ Ipv6ExtensionDemux::DoDispose()
         *it = nullptr;
     }
     m_extensions.clear();
+    m_extensionNumbers.reset();
     m_node = nullptr;
     Object::DoDispose();
 }
@@ -78,11 +79,16 @@ void
 Ipv6ExtensionDemux::Insert(Ptr<Ipv6Extension> extension)
 {
     m_extensions.push_back(extension);
+    m_extensionNumbers.set(extension->GetExtensionNumber());
 }
 
 Ptr<Ipv6Extension>
 Ipv6ExtensionDemux::GetExtension(uint8_t extensionNumber)
 {
+    if (!m_extensionNumbers.test(extensionNumber))
+    {
+        return nullptr;
+    }
     for (auto i = m_extensions.begin(); i != m_extensions.end(); ++i)
     {
         if ((*i)->GetExtensionNumber() == extensionNumber)
@@ -97,6 +103,11 @@ void
 Ipv6ExtensionDemux::Remove(Ptr<Ipv6Extension> extension)
 {
     m_extensions.remove(extension);
+    m_extensionNumbers.reset();
+    for (const auto& ext : m_extensions)
+    {
+        m_extensionNumbers.set(ext->GetExtensionNumber());
+    }
 }
 
 } /* namespace ns3 */
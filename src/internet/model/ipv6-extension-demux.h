@@ -23,6 +23,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 
+#include <bitset>
 #include <list>
 
 namespace ns3
@@ -97,6 +98,14 @@ class Ipv6ExtensionDemux : public Object
      */
     Ipv6ExtensionList_t m_extensions;
 
+    /**
+     * \brief Extension numbers of m_extensions.
+     *
+     * Lets GetExtension reject the other next header values, most often
+     * the layer 4 protocols, without walking the list.
+     */
+    std::bitset<256> m_extensionNumbers;
+
     /**
      * \brief The node.
      */
@@ -325,6 +325,20 @@ Ipv6Interface::GetNAddresses() const
     return m_addresses.size();
 }
 
+bool
+Ipv6Interface::HasAddress(Ipv6Address address) const
+{
+    NS_LOG_FUNCTION(this << address);
+    for (const auto& addr : m_addresses)
+    {
+        if (addr.first.GetAddress() == address)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 Ipv6InterfaceAddress
 Ipv6Interface::RemoveAddress(uint32_t index)
 {
@@ -413,8 +427,6 @@ Ipv6Interface::Send(Ptr<Packet> p, const Ipv6Header& hdr, Ipv6Address dest)
         return;
     }
 
-    Ptr<Ipv6L3Protocol> ipv6 = m_node->GetObject<Ipv6L3Protocol>();
-
     /* check if destination is localhost (::1), if yes we don't pass through
      * traffic control layer */
     if (DynamicCast<LoopbackNetDevice>(m_device))
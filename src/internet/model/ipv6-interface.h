@@ -241,6 +241,13 @@ class Ipv6Interface : public Object
      */
     uint32_t GetNAddresses() const;
 
+    /**
+     * \brief Checks if an address is one of the addresses of this interface.
+     * \param address the address to check
+     * \return true if the interface has the address
+     */
+    bool HasAddress(Ipv6Address address) const;
+
     /**
      * \brief Remove an address from interface.
      * \param index index to remove
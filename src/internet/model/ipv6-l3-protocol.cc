@@ -40,6 +40,7 @@
 #include "ns3/mac64-address.h"
 #include "ns3/node.h"
 #include "ns3/object-vector.h"
+#include "ns3/segment-offload-tag.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/traffic-control-layer.h"
 #include "ns3/uinteger.h"
@@ -177,6 +178,7 @@ Ipv6L3Protocol::DoDispose()
     m_node = nullptr;
     m_routingProtocol = nullptr;
     m_pmtuCache = nullptr;
+    m_extensionDemux = nullptr;
     Object::DoDispose();
 }
 
@@ -254,15 +256,9 @@ Ipv6L3Protocol::GetInterfaceForAddress(Ipv6Address address) const
 
     for (auto it = m_interfaces.begin(); it != m_interfaces.end(); it++)
     {
-        uint32_t j = 0;
-        uint32_t max = (*it)->GetNAddresses();
-
-        for (j = 0; j < max; j++)
+        if ((*it)->HasAddress(address))
         {
-            if ((*it)->GetAddress(j).GetAddress() == address)
-            {
-                return index;
-            }
+            return index;
         }
         index++;
     }
@@ -937,6 +933,15 @@ Ipv6L3Protocol::Send(Ptr<Packet> packet,
         tclass = tclassTag.GetTclass();
     }
 
+    // each segment of a super-segment carries its own IPv6 header
+    SegmentOffloadTag offloadTag;
+    if (packet->RemovePacketTag(offloadTag))
+    {
+        packet->AddPacketTag(
+            SegmentOffloadTag(offloadTag.GetSegments(),
+                              offloadTag.GetHeaderSize() + hdr.GetSerializedSize()));
+    }
+
     /* Handle 3 cases:
      * 1) Packet is passed in with a route entry
      * 2) Packet is passed in with a route entry but route->GetGateway is not set (e.g., same
@@ -1068,7 +1073,6 @@ Ipv6L3Protocol::Receive(Ptr<NetDevice> device,
         socket->ForwardUp(packet, hdr, device);
     }
 
-    Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux>();
     Ptr<Ipv6Extension> ipv6Extension = nullptr;
     uint8_t nextHeader = hdr.GetNextHeader();
     bool stopProcessing = false;
@@ -1077,7 +1081,7 @@ Ipv6L3Protocol::Receive(Ptr<NetDevice> device,
 
     if (nextHeader == Ipv6Header::IPV6_EXT_HOP_BY_HOP)
     {
-        ipv6Extension = ipv6ExtensionDemux->GetExtension(nextHeader);
+        ipv6Extension = GetExtensionDemux()->GetExtension(nextHeader);
 
         if (ipv6Extension)
         {
@@ -1121,43 +1125,34 @@ Ipv6L3Protocol::Receive(Ptr<NetDevice> device,
         }
     }
 
-    for (uint32_t j = 0; j < GetNInterfaces(); j++)
+    Ipv6Address addr = hdr.GetDestination();
+    int32_t addrInterface = GetInterfaceForAddress(addr);
+    if (addrInterface == static_cast<int32_t>(interface))
+    {
+        NS_LOG_LOGIC("For me (destination " << addr << " match)");
+        LocalDeliver(packet, hdr, interface);
+        return;
+    }
+    else if (addrInterface >= 0)
     {
-        for (uint32_t i = 0; i < GetNAddresses(j); i++)
+        if (!GetStrongEndSystemModel())
         {
-            Ipv6InterfaceAddress iaddr = GetAddress(j, i);
-            Ipv6Address addr = iaddr.GetAddress();
-            if (addr == hdr.GetDestination())
-            {
-                if (j == interface)
-                {
-                    NS_LOG_LOGIC("For me (destination " << addr << " match)");
-                    LocalDeliver(packet, hdr, interface);
-                    return;
-                }
-                else if (!GetStrongEndSystemModel())
-                {
-                    NS_LOG_LOGIC("For me (destination "
-                                 << addr
-                                 << " match) on another interface with Weak End System Model"
-                                 << hdr.GetDestination());
-                    LocalDeliver(packet, hdr, interface);
-                    return;
-                }
-                else
-                {
-                    NS_LOG_LOGIC(
-                        "For me (destination "
-                        << addr
-                        << " match) on another interface with Strong End System Model - discarding"
-                        << hdr.GetDestination());
-                    m_dropTrace(hdr, packet, DROP_NO_ROUTE, this, interface);
-                    return;
-                }
-            }
-            NS_LOG_LOGIC("Address " << addr << " not a match");
+            NS_LOG_LOGIC("For me (destination "
+                         << addr << " match) on another interface with Weak End System Model");
+            LocalDeliver(packet, hdr, interface);
+            return;
+        }
+        else
+        {
+            NS_LOG_LOGIC(
+                "For me (destination "
+                << addr
+                << " match) on another interface with Strong End System Model - discarding");
+            m_dropTrace(hdr, packet, DROP_NO_ROUTE, this, interface);
+            return;
         }
     }
+    NS_LOG_LOGIC("Address " << addr << " not a match");
 
     if (!m_routingProtocol->RouteInput(packet, hdr, device, m_ucb, m_mcb, m_lcb, m_ecb))
     {
@@ -1203,18 +1198,7 @@ Ipv6L3Protocol::SendRealOut(Ptr<Ipv6Route> route, Ptr<Packet> packet, const Ipv6
     std::list<Ipv6ExtensionFragment::Ipv6PayloadHeaderPair> fragments;
 
     // Check if this is the source of the packet
-    bool fromMe = false;
-    for (uint32_t i = 0; i < GetNInterfaces(); i++)
-    {
-        for (uint32_t j = 0; j < GetNAddresses(i); j++)
-        {
-            if (GetAddress(i, j).GetAddress() == ipHeader.GetSource())
-            {
-                fromMe = true;
-                break;
-            }
-        }
-    }
+    bool fromMe = GetInterfaceForAddress(ipHeader.GetSource()) >= 0;
 
     size_t targetMtu = 0;
 
@@ -1230,9 +1214,13 @@ Ipv6L3Protocol::SendRealOut(Ptr<Ipv6Route> route, Ptr<Packet> packet, const Ipv6
         targetMtu = dev->GetMtu();
     }
 
-    if (packet->GetSize() + ipHeader.GetSerializedSize() > targetMtu)
+    // super-segments are not fragmented by the devices supporting segmentation offload
+    SegmentOffloadTag offloadTag;
+    if (packet->GetSize() + ipHeader.GetSerializedSize() > targetMtu &&
+        !(dev->SupportsSegmentOffload() && packet->PeekPacketTag(offloadTag)))
     {
-        // Router => drop
+        // Router => drop. This includes the super-segments which the output
+        // device cannot transmit as separate segments: they are too big
         if (!fromMe)
         {
             Ptr<Icmpv6L4Protocol> icmpv6 = GetIcmpv6();
@@ -1244,11 +1232,9 @@ Ipv6L3Protocol::SendRealOut(Ptr<Ipv6Route> route, Ptr<Packet> packet, const Ipv6
             return;
         }
 
-        Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux>();
-
         // To get specific method GetFragments from Ipv6ExtensionFragmentation
         Ipv6ExtensionFragment* ipv6Fragment = dynamic_cast<Ipv6ExtensionFragment*>(
-            PeekPointer(ipv6ExtensionDemux->GetExtension(Ipv6Header::IPV6_EXT_FRAGMENTATION)));
+            PeekPointer(GetExtensionDemux()->GetExtension(Ipv6Header::IPV6_EXT_FRAGMENTATION)));
         NS_ASSERT(ipv6Fragment != nullptr);
         ipv6Fragment->GetFragments(packet, ipHeader, targetMtu, fragments);
     }
@@ -1444,7 +1430,7 @@ Ipv6L3Protocol::LocalDeliver(Ptr<const Packet> packet, const Ipv6Header& ip, uin
     NS_LOG_FUNCTION(this << packet << ip << iif);
     Ptr<Packet> p = packet->Copy();
     Ptr<IpL4Protocol> protocol = nullptr;
-    Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = m_node->GetObject<Ipv6ExtensionDemux>();
+    Ptr<Ipv6ExtensionDemux> ipv6ExtensionDemux = GetExtensionDemux();
     Ptr<Ipv6Extension> ipv6Extension = nullptr;
     Ipv6Address src = ip.GetSource();
     Ipv6Address dst = ip.GetDestination();
@@ -1452,6 +1438,7 @@ Ipv6L3Protocol::LocalDeliver(Ptr<const Packet> packet, const Ipv6Header& ip, uin
     uint8_t nextHeaderPosition = 0;
     bool isDropped = false;
     bool stopProcessing = false;
+    bool isExtensionProcessed = false;
     DropReason dropReason;
 
     // check for a malformed hop-by-hop extension
@@ -1477,6 +1464,7 @@ Ipv6L3Protocol::LocalDeliver(Ptr<const Packet> packet, const Ipv6Header& ip, uin
         {
             uint8_t nextHeaderStep = 0;
             uint8_t curHeader = nextHeader;
+            isExtensionProcessed = true;
             nextHeaderStep = ipv6Extension->Process(p,
                                                     nextHeaderPosition,
                                                     ip,
@@ -1541,7 +1529,9 @@ Ipv6L3Protocol::LocalDeliver(Ptr<const Packet> packet, const Ipv6Header& ip, uin
                 newIpHeader.SetPayloadLength(p->GetSize());
 
                 /* L4 protocol */
-                Ptr<Packet> copy = p->Copy();
+                // Keep the packet for an ICMPv6 error. Without extensions, the packet
+                // received is identical, and it is copied only if the error is sent.
+                Ptr<Packet> copy = isExtensionProcessed ? p->Copy() : nullptr;
 
                 m_localDeliverTrace(newIpHeader, p, iif);
 
@@ -1561,6 +1551,10 @@ Ipv6L3Protocol::LocalDeliver(Ptr<const Packet> packet, const Ipv6Header& ip, uin
                         break;
                     }
 
+                    if (!copy)
+                    {
+                        copy = packet->Copy();
+                    }
                     copy->AddHeader(newIpHeader);
                     GetIcmpv6()->SendErrorDestinationUnreachable(
                         copy,
@@ -1572,6 +1566,16 @@ Ipv6L3Protocol::LocalDeliver(Ptr<const Packet> packet, const Ipv6Header& ip, uin
     } while (ipv6Extension);
 }
 
+Ptr<Ipv6ExtensionDemux>
+Ipv6L3Protocol::GetExtensionDemux()
+{
+    if (!m_extensionDemux)
+    {
+        m_extensionDemux = m_node->GetObject<Ipv6ExtensionDemux>();
+    }
+    return m_extensionDemux;
+}
+
 void
 Ipv6L3Protocol::RouteInputError(Ptr<const Packet> p,
                                 const Ipv6Header& ipHeader,
@@ -42,6 +42,7 @@ class IpL4Protocol;
 class Ipv6Route;
 class Ipv6MulticastRoute;
 class Ipv6RawSocketImpl;
+class Ipv6ExtensionDemux;
 class Icmpv6L4Protocol;
 class Ipv6AutoconfiguredPrefix;
 
@@ -659,6 +660,15 @@ class Ipv6L3Protocol : public Ipv6
                          const Ipv6Header& ipHeader,
                          Socket::SocketErrno sockErrno);
 
+    /**
+     * \brief Get the IPv6 extension demultiplexer aggregated to the node.
+     *
+     * The demultiplexer is looked up once, then kept for the next packets.
+     *
+     * \return the IPv6 extension demultiplexer
+     */
+    Ptr<Ipv6ExtensionDemux> GetExtensionDemux();
+
     /**
      * \brief Add an IPv6 interface to the stack.
      * \param interface interface to add
@@ -730,6 +740,11 @@ class Ipv6L3Protocol : public Ipv6
      */
     Ptr<Ipv6PmtuCache> m_pmtuCache;
 
+    /**
+     * \brief IPv6 extension demultiplexer, see GetExtensionDemux.
+     */
+    Ptr<Ipv6ExtensionDemux> m_extensionDemux;
+
     /**
      * \brief List of transport protocol.
      */
@@ -22,6 +22,8 @@
 
 #include "ns3/log.h"
 
+#include <cstring>
+
 namespace ns3
 {
 
@@ -33,7 +35,10 @@ Ipv6QueueDiscItem::Ipv6QueueDiscItem(Ptr<Packet> p,
                                      const Ipv6Header& header)
     : QueueDiscItem(p, addr, protocol),
       m_header(header),
-      m_headerAdded(false)
+      m_headerAdded(false),
+      m_hashValid(false),
+      m_hashPerturbation(0),
+      m_hash(0)
 {
 }
 
@@ -120,41 +125,23 @@ Ipv6QueueDiscItem::Hash(uint32_t perturbation) const
 {
     NS_LOG_FUNCTION(this << perturbation);
 
-    Ipv6Address src = m_header.GetSource();
-    Ipv6Address dest = m_header.GetDestination();
-    uint8_t prot = m_header.GetNextHeader();
-
-    TcpHeader tcpHdr;
-    UdpHeader udpHdr;
-    uint16_t srcPort = 0;
-    uint16_t destPort = 0;
-
-    if (prot == 6) // TCP
+    if (m_hashValid && m_hashPerturbation == perturbation)
     {
-        GetPacket()->PeekHeader(tcpHdr);
-        srcPort = tcpHdr.GetSourcePort();
-        destPort = tcpHdr.GetDestinationPort();
-    }
-    else if (prot == 17) // UDP
-    {
-        GetPacket()->PeekHeader(udpHdr);
-        srcPort = udpHdr.GetSourcePort();
-        destPort = udpHdr.GetDestinationPort();
-    }
-    if (prot != 6 && prot != 17)
-    {
-        NS_LOG_WARN("Unknown transport protocol, no port number included in hash computation");
+        return m_hash;
     }
 
+    const FiveTuple* tuple = GetFiveTuple();
+    NS_ASSERT(tuple);
+
     /* serialize the 5-tuple and the perturbation in buf */
     uint8_t buf[41];
-    src.Serialize(buf);
-    dest.Serialize(buf + 16);
-    buf[32] = prot;
-    buf[33] = (srcPort >> 8) & 0xff;
-    buf[34] = srcPort & 0xff;
-    buf[35] = (destPort >> 8) & 0xff;
-    buf[36] = destPort & 0xff;
+    std::memcpy(buf, tuple->source, 16);
+    std::memcpy(buf + 16, tuple->destination, 16);
+    buf[32] = tuple->protocol;
+    buf[33] = (tuple->sourcePort >> 8) & 0xff;
+    buf[34] = tuple->sourcePort & 0xff;
+    buf[35] = (tuple->destinationPort >> 8) & 0xff;
+    buf[36] = tuple->destinationPort & 0xff;
     buf[37] = (perturbation >> 24) & 0xff;
     buf[38] = (perturbation >> 16) & 0xff;
     buf[39] = (perturbation >> 8) & 0xff;
@@ -162,11 +149,44 @@ Ipv6QueueDiscItem::Hash(uint32_t perturbation) const
 
     // Linux calculates jhash2 (jenkins hash), we calculate murmur3 because it is
     // already available in ns-3
-    uint32_t hash = Hash32((char*)buf, 41);
+    m_hash = Hash32((char*)buf, 41);
+    m_hashPerturbation = perturbation;
+    m_hashValid = true;
 
-    NS_LOG_DEBUG("Found Ipv6 packet; hash of the five tuple " << hash);
+    NS_LOG_DEBUG("Found Ipv6 packet; hash of the five tuple " << m_hash);
 
-    return hash;
+    return m_hash;
+}
+
+bool
+Ipv6QueueDiscItem::ParseFiveTuple(FiveTuple& tuple) const
+{
+    NS_LOG_FUNCTION(this);
+
+    m_header.GetSource().Serialize(tuple.source);
+    m_header.GetDestination().Serialize(tuple.destination);
+    tuple.version = 6;
+    tuple.protocol = m_header.GetNextHeader();
+
+    if (tuple.protocol == 6) // TCP
+    {
+        TcpHeader tcpHdr;
+        GetPacket()->PeekHeader(tcpHdr);
+        tuple.sourcePort = tcpHdr.GetSourcePort();
+        tuple.destinationPort = tcpHdr.GetDestinationPort();
+    }
+    else if (tuple.protocol == 17) // UDP
+    {
+        UdpHeader udpHdr;
+        GetPacket()->PeekHeader(udpHdr);
+        tuple.sourcePort = udpHdr.GetSourcePort();
+        tuple.destinationPort = udpHdr.GetDestinationPort();
+    }
+    if (tuple.protocol != 6 && tuple.protocol != 17)
+    {
+        NS_LOG_WARN("Unknown transport protocol, no port number included in the 5-tuple");
+    }
+    return true;
 }
 
 } // namespace ns3
@@ -105,9 +105,24 @@ class Ipv6QueueDiscItem : public QueueDiscItem
      */
     uint32_t Hash(uint32_t perturbation) const override;
 
+  protected:
+    /**
+     * \brief Parse the 5-tuple of the packet
+     *
+     * The source and destination ports are peeked from the payload if the
+     * transport protocol is either UDP or TCP.
+     *
+     * \param tuple the 5-tuple to fill
+     * \return true
+     */
+    bool ParseFiveTuple(FiveTuple& tuple) const override;
+
   private:
-    Ipv6Header m_header; //!< The IPv6 header.
-    bool m_headerAdded;  //!< True if the header has already been added to the packet.
+    Ipv6Header m_header;                 //!< The IPv6 header.
+    bool m_headerAdded;                  //!< True if the header has been added to the packet.
+    mutable bool m_hashValid;            //!< True if m_hash holds the last computed hash
+    mutable uint32_t m_hashPerturbation; //!< Perturbation used to compute m_hash
+    mutable uint32_t m_hash;             //!< The last computed hash
 };
 
 } // namespace ns3
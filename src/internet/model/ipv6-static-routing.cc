@@ -29,7 +29,10 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
+#include <iterator>
 
 namespace ns3
 {
@@ -38,6 +41,21 @@ NS_LOG_COMPONENT_DEFINE("Ipv6StaticRouting");
 
 NS_OBJECT_ENSURE_REGISTERED(Ipv6StaticRouting);
 
+/**
+ * \brief Check whether a prefix is made of contiguous leading ones.
+ * \param prefix the prefix
+ * \return true if the prefix is contiguous
+ */
+static bool
+IsContiguous(Ipv6Prefix prefix)
+{
+    uint8_t bytes[16];
+    uint8_t expected[16];
+    prefix.GetBytes(bytes);
+    Ipv6Prefix(prefix.GetPrefixLength()).GetBytes(expected);
+    return std::memcmp(bytes, expected, 16) == 0;
+}
+
 TypeId
 Ipv6StaticRouting::GetTypeId()
 {
@@ -49,7 +67,8 @@ Ipv6StaticRouting::GetTypeId()
 }
 
 Ipv6StaticRouting::Ipv6StaticRouting()
-    : m_ipv6(nullptr)
+    : m_nonContiguousRoutes(0),
+      m_ipv6(nullptr)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -181,8 +200,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
 
     if (!LookupRoute(route, metric))
     {
-        auto routePtr = new Ipv6RoutingTableEntry(route);
-        m_networkRoutes.emplace_back(routePtr, metric);
+        InsertNetworkRoute(new Ipv6RoutingTableEntry(route), metric);
     }
 }
 
@@ -208,8 +226,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
                                                                               prefixToUse);
     if (!LookupRoute(route, metric))
     {
-        auto routePtr = new Ipv6RoutingTableEntry(route);
-        m_networkRoutes.emplace_back(routePtr, metric);
+        InsertNetworkRoute(new Ipv6RoutingTableEntry(route), metric);
     }
 }
 
@@ -225,8 +242,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
         Ipv6RoutingTableEntry::CreateNetworkRouteTo(network, networkPrefix, interface);
     if (!LookupRoute(route, metric))
     {
-        auto routePtr = new Ipv6RoutingTableEntry(route);
-        m_networkRoutes.emplace_back(routePtr, metric);
+        InsertNetworkRoute(new Ipv6RoutingTableEntry(route), metric);
     }
 }
 
@@ -268,7 +284,7 @@ Ipv6StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv6Address network = Ipv6Address("ff00::"); /* RFC 3513 */
     Ipv6Prefix networkMask = Ipv6Prefix(8);
     *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
-    m_networkRoutes.emplace_back(route, 0);
+    InsertNetworkRoute(route, 0);
 }
 
 uint32_t
@@ -338,11 +354,64 @@ Ipv6StaticRouting::RemoveMulticastRoute(uint32_t index)
     }
 }
 
+void
+Ipv6StaticRouting::InsertNetworkRoute(Ipv6RoutingTableEntry* route, uint32_t metric)
+{
+    m_networkRoutes.emplace_back(route, metric);
+    Ipv6Prefix prefix = route->GetDestNetworkPrefix();
+    if (IsContiguous(prefix))
+    {
+        m_networkRoutesTrie.Insert(NetworkRoutesTrie::GetKey(route->GetDestNetwork()),
+                                   prefix.GetPrefixLength(),
+                                   std::prev(m_networkRoutes.end()));
+    }
+    else
+    {
+        m_nonContiguousRoutes++;
+    }
+}
+
+Ipv6StaticRouting::NetworkRoutesI
+Ipv6StaticRouting::EraseNetworkRoute(NetworkRoutesI it)
+{
+    Ipv6Prefix prefix = it->first->GetDestNetworkPrefix();
+    if (IsContiguous(prefix))
+    {
+        bool removed =
+            m_networkRoutesTrie.Remove(NetworkRoutesTrie::GetKey(it->first->GetDestNetwork()),
+                                       prefix.GetPrefixLength(),
+                                       it);
+        NS_ASSERT(removed);
+    }
+    else
+    {
+        m_nonContiguousRoutes--;
+    }
+    delete it->first;
+    return m_networkRoutes.erase(it);
+}
+
 bool
 Ipv6StaticRouting::HasNetworkDest(Ipv6Address network, uint32_t interfaceIndex)
 {
     NS_LOG_FUNCTION(this << network << interfaceIndex);
 
+    if (m_nonContiguousRoutes == 0)
+    {
+        bool found = false;
+        m_networkRoutesTrie.Match(
+            NetworkRoutesTrie::GetKey(network),
+            [&found, interfaceIndex](uint16_t, const std::vector<NetworkRoutesI>& routes) {
+                found = std::any_of(routes.begin(),
+                                    routes.end(),
+                                    [interfaceIndex](NetworkRoutesI j) {
+                                        return j->first->GetInterface() == interfaceIndex;
+                                    });
+                return found;
+            });
+        return found;
+    }
+
     /* in the network table */
     for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
     {
@@ -363,20 +432,27 @@ Ipv6StaticRouting::HasNetworkDest(Ipv6Address network, uint32_t interfaceIndex)
 bool
 Ipv6StaticRouting::LookupRoute(const Ipv6RoutingTableEntry& route, uint32_t metric)
 {
-    for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+    auto isSame = [&route, metric](const std::pair<Ipv6RoutingTableEntry*, uint32_t>& j) {
+        Ipv6RoutingTableEntry* rtentry = j.first;
+        return rtentry->GetDest() == route.GetDest() &&
+               rtentry->GetDestNetworkPrefix() == route.GetDestNetworkPrefix() &&
+               rtentry->GetGateway() == route.GetGateway() &&
+               rtentry->GetInterface() == route.GetInterface() &&
+               rtentry->GetPrefixToUse() == route.GetPrefixToUse() && j.second == metric;
+    };
+
+    Ipv6Prefix prefix = route.GetDestNetworkPrefix();
+    if (IsContiguous(prefix))
     {
-        Ipv6RoutingTableEntry* rtentry = j->first;
-
-        if (rtentry->GetDest() == route.GetDest() &&
-            rtentry->GetDestNetworkPrefix() == route.GetDestNetworkPrefix() &&
-            rtentry->GetGateway() == route.GetGateway() &&
-            rtentry->GetInterface() == route.GetInterface() &&
-            rtentry->GetPrefixToUse() == route.GetPrefixToUse() && j->second == metric)
-        {
-            return true;
-        }
+        // identical routes have the same prefix
+        const std::vector<NetworkRoutesI>* routes =
+            m_networkRoutesTrie.Find(NetworkRoutesTrie::GetKey(route.GetDestNetwork()),
+                                     prefix.GetPrefixLength());
+        return routes && std::any_of(routes->begin(), routes->end(), [&isSame](NetworkRoutesI j) {
+                   return isSame(*j);
+               });
     }
-    return false;
+    return std::any_of(m_networkRoutes.begin(), m_networkRoutes.end(), isSame);
 }
 
 Ptr<Ipv6Route>
@@ -384,8 +460,6 @@ Ipv6StaticRouting::LookupStatic(Ipv6Address dst, Ptr<NetDevice> interface)
 {
     NS_LOG_FUNCTION(this << dst << interface);
     Ptr<Ipv6Route> rtentry = nullptr;
-    uint16_t longestMask = 0;
-    uint32_t shortestMetric = 0xffffffff;
 
     /* when sending on link-local multicast, there have to be interface specified */
     if (dst.IsLinkLocalMulticast())
@@ -402,72 +476,114 @@ Ipv6StaticRouting::LookupStatic(Ipv6Address dst, Ptr<NetDevice> interface)
         return rtentry;
     }
 
-    for (auto it = m_networkRoutes.begin(); it != m_networkRoutes.end(); it++)
+    Ipv6RoutingTableEntry* route = nullptr;
+    if (m_nonContiguousRoutes == 0)
     {
-        Ipv6RoutingTableEntry* j = it->first;
-        uint32_t metric = it->second;
-        Ipv6Prefix mask = j->GetDestNetworkPrefix();
-        uint16_t maskLen = mask.GetPrefixLength();
-        Ipv6Address entry = j->GetDestNetwork();
-
-        NS_LOG_LOGIC("Searching for route to " << dst << ", mask length " << maskLen << ", metric "
-                                               << metric);
-
-        if (mask.IsMatch(dst, entry))
-        {
-            NS_LOG_LOGIC("Found global network route " << *j << ", mask length " << maskLen
-                                                       << ", metric " << metric);
-
-            /* if interface is given, check the route will output on this interface */
-            if (!interface || interface == m_ipv6->GetNetDevice(j->GetInterface()))
-            {
-                if (maskLen < longestMask)
+        // The trie enumerates the matching prefixes from the longest one; the
+        // routes of a prefix are in the order of the forwarding table
+        m_networkRoutesTrie.Match(
+            NetworkRoutesTrie::GetKey(dst),
+            [this, &route, interface](uint16_t maskLen, const std::vector<NetworkRoutesI>& routes) {
+                uint32_t shortestMetric = 0xffffffff;
+                for (NetworkRoutesI it : routes)
                 {
-                    NS_LOG_LOGIC("Previous match longer, skipping");
-                    continue;
+                    Ipv6RoutingTableEntry* j = it->first;
+                    uint32_t metric = it->second;
+                    NS_LOG_LOGIC("Found global network route " << *j << ", mask length " << maskLen
+                                                               << ", metric " << metric);
+                    if (interface && interface != m_ipv6->GetNetDevice(j->GetInterface()))
+                    {
+                        continue;
+                    }
+                    if (metric > shortestMetric)
+                    {
+                        NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
+                        continue;
+                    }
+                    shortestMetric = metric;
+                    route = j;
+                    if (maskLen == 128)
+                    {
+                        break;
+                    }
                 }
+                return route != nullptr;
+            });
+    }
+    else
+    {
+        uint16_t longestMask = 0;
+        uint32_t shortestMetric = 0xffffffff;
+        for (auto it = m_networkRoutes.begin(); it != m_networkRoutes.end(); it++)
+        {
+            Ipv6RoutingTableEntry* j = it->first;
+            uint32_t metric = it->second;
+            Ipv6Prefix mask = j->GetDestNetworkPrefix();
+            uint16_t maskLen = mask.GetPrefixLength();
+            Ipv6Address entry = j->GetDestNetwork();
 
-                if (maskLen > longestMask)
-                {
-                    shortestMetric = 0xffffffff;
-                }
+            NS_LOG_LOGIC("Searching for route to " << dst << ", mask length " << maskLen
+                                                   << ", metric " << metric);
+
+            if (mask.IsMatch(dst, entry))
+            {
+                NS_LOG_LOGIC("Found global network route " << *j << ", mask length " << maskLen
+                                                           << ", metric " << metric);
 
-                longestMask = maskLen;
-                if (metric > shortestMetric)
+                /* if interface is given, check the route will output on this interface */
+                if (!interface || interface == m_ipv6->GetNetDevice(j->GetInterface()))
                 {
-                    NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
-                    continue;
-                }
+                    if (maskLen < longestMask)
+                    {
+                        NS_LOG_LOGIC("Previous match longer, skipping");
+                        continue;
+                    }
 
-                shortestMetric = metric;
-                Ipv6RoutingTableEntry* route = j;
-                uint32_t interfaceIdx = route->GetInterface();
-                rtentry = Create<Ipv6Route>();
+                    if (maskLen > longestMask)
+                    {
+                        shortestMetric = 0xffffffff;
+                    }
 
-                if (route->GetGateway().IsAny() || !route->GetDest().IsAny())
-                {
-                    rtentry->SetSource(
-                        m_ipv6->SourceAddressSelection(interfaceIdx, route->GetDest()));
-                }
-                else
-                {
-                    // Default route
-                    rtentry->SetSource(m_ipv6->SourceAddressSelection(
-                        interfaceIdx,
-                        route->GetPrefixToUse().IsAny() ? dst : route->GetPrefixToUse()));
-                }
+                    longestMask = maskLen;
+                    if (metric > shortestMetric)
+                    {
+                        NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
+                        continue;
+                    }
 
-                rtentry->SetDestination(route->GetDest());
-                rtentry->SetGateway(route->GetGateway());
-                rtentry->SetOutputDevice(m_ipv6->GetNetDevice(interfaceIdx));
-                if (maskLen == 128)
-                {
-                    break;
+                    shortestMetric = metric;
+                    route = j;
+                    if (maskLen == 128)
+                    {
+                        break;
+                    }
                 }
             }
         }
     }
 
+    if (route)
+    {
+        uint32_t interfaceIdx = route->GetInterface();
+        rtentry = Create<Ipv6Route>();
+
+        if (route->GetGateway().IsAny() || !route->GetDest().IsAny())
+        {
+            rtentry->SetSource(m_ipv6->SourceAddressSelection(interfaceIdx, route->GetDest()));
+        }
+        else
+        {
+            // Default route
+            rtentry->SetSource(m_ipv6->SourceAddressSelection(
+                interfaceIdx,
+                route->GetPrefixToUse().IsAny() ? dst : route->GetPrefixToUse()));
+        }
+
+        rtentry->SetDestination(route->GetDest());
+        rtentry->SetGateway(route->GetGateway());
+        rtentry->SetOutputDevice(m_ipv6->GetNetDevice(interfaceIdx));
+    }
+
     if (rtentry)
     {
         NS_LOG_LOGIC("Matching route via " << rtentry->GetDestination() << " (Through "
@@ -486,6 +602,8 @@ Ipv6StaticRouting::DoDispose()
         delete j->first;
     }
     m_networkRoutes.clear();
+    m_networkRoutesTrie.Clear();
+    m_nonContiguousRoutes = 0;
 
     for (auto i = m_multicastRoutes.begin(); i != m_multicastRoutes.end();
          i = m_multicastRoutes.erase(i))
@@ -643,8 +761,7 @@ Ipv6StaticRouting::RemoveRoute(uint32_t index)
     {
         if (tmp == index)
         {
-            delete it->first;
-            m_networkRoutes.erase(it);
+            EraseNetworkRoute(it);
             return;
         }
         tmp++;
@@ -666,8 +783,7 @@ Ipv6StaticRouting::RemoveRoute(Ipv6Address network,
         if (network == rtentry->GetDest() && rtentry->GetInterface() == ifIndex &&
             rtentry->GetPrefixToUse() == prefixToUse)
         {
-            delete it->first;
-            m_networkRoutes.erase(it);
+            EraseNetworkRoute(it);
             return;
         }
     }
@@ -808,8 +924,7 @@ Ipv6StaticRouting::NotifyInterfaceDown(uint32_t i)
     {
         if (it->first->GetInterface() == i)
         {
-            delete it->first;
-            it = m_networkRoutes.erase(it);
+            it = EraseNetworkRoute(it);
         }
         else
         {
@@ -846,8 +961,7 @@ Ipv6StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv6InterfaceAddress
             it->first->GetDestNetwork() == networkAddress &&
             it->first->GetDestNetworkPrefix() == networkMask)
         {
-            delete it->first;
-            it = m_networkRoutes.erase(it);
+            it = EraseNetworkRoute(it);
         }
         else
         {
@@ -904,8 +1018,7 @@ Ipv6StaticRouting::NotifyRemoveRoute(Ipv6Address dst,
 
             if (dst == entry && prefix == mask && rtentry->GetInterface() == interface)
             {
-                delete j->first;
-                j = m_networkRoutes.erase(j);
+                j = EraseNetworkRoute(j);
             }
             else
             {
@@ -25,6 +25,7 @@
 #include "ipv6.h"
 
 #include "ns3/ipv6-address.h"
+#include "ns3/prefix-trie.h"
 #include "ns3/ptr.h"
 
 #include <list>
@@ -52,6 +53,10 @@ class Ipv6MulticastRoutingTableEntry;
  * Ipv6ListRouting protocol but can be used also as a standalone
  * protocol.
  *
+ * The network routes are kept in a list, which defines the route indexes
+ * (see GetRoute), and indexed by a longest prefix match trie, so that the
+ * cost of a lookup does not grow with the number of routes.
+ *
  * The Ipv6StaticRouting class inherits from the abstract base class
  * Ipv6RoutingProtocol that defines the interface methods that a routing
  * protocol must support.
@@ -306,6 +311,23 @@ class Ipv6StaticRouting : public Ipv6RoutingProtocol
     /// Iterator for container for the multicast routes
     typedef std::list<Ipv6MulticastRoutingTableEntry*>::iterator MulticastRoutesI;
 
+    /// Longest prefix match index of the network routes
+    typedef PrefixTrie<NetworkRoutesI, 16> NetworkRoutesTrie;
+
+    /**
+     * \brief Append a route to the forwarding table for network.
+     * \param route the route (ownership is transferred to the table)
+     * \param metric metric of route
+     */
+    void InsertNetworkRoute(Ipv6RoutingTableEntry* route, uint32_t metric);
+
+    /**
+     * \brief Remove a route from the forwarding table for network.
+     * \param it iterator to the route
+     * \return iterator to the following route
+     */
+    NetworkRoutesI EraseNetworkRoute(NetworkRoutesI it);
+
     /**
      * \brief Checks if a route is already present in the forwarding table.
      * \param route route
@@ -336,6 +358,19 @@ class Ipv6StaticRouting : public Ipv6RoutingProtocol
      */
     NetworkRoutes m_networkRoutes;
 
+    /**
+     * \brief Index of the network routes by destination prefix.
+     *
+     * Routes whose prefix is not made of contiguous leading ones can not be
+     * indexed: while there are any, lookups scan the whole forwarding table.
+     */
+    NetworkRoutesTrie m_networkRoutesTrie;
+
+    /**
+     * \brief Number of network routes whose prefix is not contiguous.
+     */
+    uint32_t m_nonContiguousRoutes;
+
     /**
      * \brief the forwarding table for multicast.
      */
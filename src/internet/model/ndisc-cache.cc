@@ -28,6 +28,8 @@
 #include "ns3/node.h"
 #include "ns3/uinteger.h"
 
+#include <map>
+
 namespace ns3
 {
 
@@ -68,6 +70,7 @@ NdiscCache::DoDispose()
     m_device = nullptr;
     m_interface = nullptr;
     m_icmpv6 = nullptr;
+    m_sharedTable = nullptr;
     Object::DoDispose();
 }
 
@@ -101,9 +104,10 @@ NdiscCache::Lookup(Ipv6Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
 
-    if (m_ndCache.find(dst) != m_ndCache.end())
+    auto it = m_ndCache.find(dst);
+    if (it != m_ndCache.end())
     {
-        NdiscCache::Entry* entry = m_ndCache[dst];
+        NdiscCache::Entry* entry = it->second;
         NS_LOG_LOGIC("Found an entry: " << *entry);
 
         return entry;
@@ -127,6 +131,9 @@ NdiscCache::LookupInverse(Address dst)
             entryList.push_back(entry);
         }
     }
+    entryList.sort([](NdiscCache::Entry* a, NdiscCache::Entry* b) {
+        return a->GetIpv6Address() < b->GetIpv6Address();
+    });
     return entryList;
 }
 
@@ -147,15 +154,12 @@ NdiscCache::Remove(NdiscCache::Entry* entry)
 {
     NS_LOG_FUNCTION(this << entry);
 
-    for (auto i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    auto i = m_ndCache.find(entry->GetIpv6Address());
+    if (i != m_ndCache.end() && (*i).second == entry)
     {
-        if ((*i).second == entry)
-        {
-            m_ndCache.erase(i);
-            entry->ClearWaitingPacket();
-            delete entry;
-            return;
-        }
+        m_ndCache.erase(i);
+        entry->ClearWaitingPacket();
+        delete entry;
     }
 }
 
@@ -169,7 +173,7 @@ NdiscCache::Flush()
         delete (*i).second; /* delete the pointer NdiscCache::Entry */
     }
 
-    m_ndCache.erase(m_ndCache.begin(), m_ndCache.end());
+    m_ndCache.clear();
 }
 
 void
@@ -192,7 +196,32 @@ NdiscCache::PrintNdiscCache(Ptr<OutputStreamWrapper> stream)
     NS_LOG_FUNCTION(this << stream);
     std::ostream* os = stream->GetStream();
 
-    for (auto i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    std::map<Ipv6Address, NdiscCache::Entry*> sorted(m_ndCache.begin(), m_ndCache.end());
+    if (m_sharedTable)
+    {
+        // the shared entries are printed as the auto-generated entries of the
+        // neighbors in the subnets of the interface, without an Entry
+        for (auto it = m_sharedTable->Begin(); it != m_sharedTable->End(); it++)
+        {
+            bool neighbor = it->first.IsLinkLocal();
+            for (uint32_t j = 0; j < m_interface->GetNAddresses(); j++)
+            {
+                Ipv6InterfaceAddress ifAddr = m_interface->GetAddress(j);
+                if (ifAddr.GetAddress() == it->first)
+                {
+                    neighbor = false;
+                    break;
+                }
+                neighbor = neighbor || (ifAddr.GetScope() == Ipv6InterfaceAddress::GLOBAL &&
+                                        ifAddr.IsInSameSubnet(it->first));
+            }
+            if (neighbor)
+            {
+                sorted.insert({it->first, nullptr});
+            }
+        }
+    }
+    for (auto i = sorted.begin(); i != sorted.end(); i++)
     {
         *os << i->first << " dev ";
         std::string found = Names::FindName(m_device);
@@ -205,6 +234,12 @@ NdiscCache::PrintNdiscCache(Ptr<OutputStreamWrapper> stream)
             *os << static_cast<int>(m_device->GetIfIndex());
         }
 
+        if (!i->second)
+        {
+            *os << " lladdr " << *m_sharedTable->Lookup(i->first) << " STATIC_AUTOGENERATED\n";
+            continue;
+        }
+
         *os << " lladdr " << i->second->GetMacAddress();
 
         if (i->second->IsReachable())
@@ -723,11 +758,25 @@ NdiscCache::RemoveAutoGeneratedEntries()
         {
             i->second->ClearWaitingPacket();
             delete i->second;
-            m_ndCache.erase(i++);
+            i = m_ndCache.erase(i);
             continue;
         }
         i++;
     }
+    m_sharedTable = nullptr;
+}
+
+void
+NdiscCache::SetSharedTable(Ptr<SharedNeighborTable<Ipv6Address>> table)
+{
+    NS_LOG_FUNCTION(this << table);
+    m_sharedTable = table;
+}
+
+Ptr<SharedNeighborTable<Ipv6Address>>
+NdiscCache::GetSharedTable() const
+{
+    return m_sharedTable;
 }
 
 std::ostream&
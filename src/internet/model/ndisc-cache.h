@@ -20,12 +20,14 @@
 #ifndef NDISC_CACHE_H
 #define NDISC_CACHE_H
 
+#include "ns3/flat-hash-map.h"
 #include "ns3/ipv6-address.h"
 #include "ns3/net-device.h"
 #include "ns3/nstime.h"
 #include "ns3/output-stream-wrapper.h"
 #include "ns3/packet.h"
 #include "ns3/ptr.h"
+#include "ns3/shared-neighbor-table.h"
 #include "ns3/timer.h"
 
 #include <list>
@@ -149,10 +151,28 @@ class NdiscCache : public Object
     void PrintNdiscCache(Ptr<OutputStreamWrapper> stream);
 
     /**
-     * \brief Clear the NDISC cache of all Auto-Generated entries
+     * \brief Clear the NDISC cache of all Auto-Generated entries, including the
+     * shared neighbor table, if any.
      */
     void RemoveAutoGeneratedEntries();
 
+    /**
+     * \brief Set the neighbor table shared with the other interfaces of the channel.
+     *
+     * The addresses missing from the cache are looked up in the shared table
+     * before being resolved by Neighbor Discovery. Flush does not remove the
+     * shared table.
+     *
+     * \param table the shared table, or nullptr to remove it
+     */
+    void SetSharedTable(Ptr<SharedNeighborTable<Ipv6Address>> table);
+
+    /**
+     * \brief Get the neighbor table shared with the other interfaces of the channel.
+     * \return the shared table, or nullptr if none
+     */
+    Ptr<SharedNeighborTable<Ipv6Address>> GetSharedTable() const;
+
     /**
      * \brief Pair of a packet and an Ipv4 header.
      */
@@ -457,11 +477,11 @@ class NdiscCache : public Object
     /**
      * \brief Neighbor Discovery Cache container
      */
-    typedef std::map<Ipv6Address, NdiscCache::Entry*> Cache;
+    typedef FlatHashMap<Ipv6Address, NdiscCache::Entry*> Cache;
     /**
      * \brief Neighbor Discovery Cache container iterator
      */
-    typedef std::map<Ipv6Address, NdiscCache::Entry*>::iterator CacheI;
+    typedef Cache::iterator CacheI;
 
     /**
      * \brief A list of Entry.
@@ -488,6 +508,11 @@ class NdiscCache : public Object
      * \brief Max number of packet stored in m_waiting.
      */
     uint32_t m_unresQlen;
+
+    /**
+     * \brief The neighbor table shared with the other interfaces of the channel.
+     */
+    Ptr<SharedNeighborTable<Ipv6Address>> m_sharedTable;
 };
 
 /**
@@ -197,7 +197,7 @@ void
 RipHeader::Print(std::ostream& os) const
 {
     os << "command " << int(m_command);
-    for (auto iter = m_rteList.begin(); iter != m_rteList.end(); iter++)
+    for (auto iter = m_rtes.begin(); iter != m_rtes.end(); iter++)
     {
         os << " | ";
         iter->Print(os);
@@ -208,7 +208,7 @@ uint32_t
 RipHeader::GetSerializedSize() const
 {
     RipRte rte;
-    return 4 + m_rteList.size() * rte.GetSerializedSize();
+    return 4 + m_rtes.size() * rte.GetSerializedSize();
 }
 
 void
@@ -220,7 +220,7 @@ RipHeader::Serialize(Buffer::Iterator start) const
     i.WriteU8(2);
     i.WriteU16(0);
 
-    for (auto iter = m_rteList.begin(); iter != m_rteList.end(); iter++)
+    for (auto iter = m_rtes.begin(); iter != m_rtes.end(); iter++)
     {
         iter->Serialize(i);
         i.Next(iter->GetSerializedSize());
@@ -256,11 +256,12 @@ RipHeader::Deserialize(Buffer::Iterator start)
     }
 
     uint8_t rteNumber = i.GetRemainingSize() / 20;
+    m_rtes.reserve(m_rtes.size() + rteNumber);
     for (uint8_t n = 0; n < rteNumber; n++)
     {
         RipRte rte;
         i.Next(rte.Deserialize(i));
-        m_rteList.push_back(rte);
+        m_rtes.push_back(rte);
     }
 
     return GetSerializedSize();
@@ -281,25 +282,31 @@ RipHeader::GetCommand() const
 void
 RipHeader::AddRte(RipRte rte)
 {
-    m_rteList.push_back(rte);
+    m_rtes.push_back(rte);
 }
 
 void
 RipHeader::ClearRtes()
 {
-    m_rteList.clear();
+    m_rtes.clear();
 }
 
 uint16_t
 RipHeader::GetRteNumber() const
 {
-    return m_rteList.size();
+    return m_rtes.size();
 }
 
 std::list<RipRte>
 RipHeader::GetRteList() const
 {
-    return m_rteList;
+    return std::list<RipRte>(m_rtes.begin(), m_rtes.end());
+}
+
+const std::vector<RipRte>&
+RipHeader::GetRtes() const
+{
+    return m_rtes;
 }
 
 std::ostream&
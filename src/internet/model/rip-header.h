@@ -27,6 +27,7 @@
 #include "ns3/packet.h"
 
 #include <list>
+#include <vector>
 
 namespace ns3
 {
@@ -236,9 +237,15 @@ class RipHeader : public Header
      */
     std::list<RipRte> GetRteList() const;
 
+    /**
+     * \brief Get the RTEs included in the message, without copying them
+     * \returns the RTEs in the message
+     */
+    const std::vector<RipRte>& GetRtes() const;
+
   private:
-    uint8_t m_command;           //!< command type
-    std::list<RipRte> m_rteList; //!< list of the RTEs in the message
+    uint8_t m_command;          //!< command type
+    std::vector<RipRte> m_rtes; //!< RTEs in the message
 };
 
 /**
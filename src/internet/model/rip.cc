@@ -34,7 +34,9 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <iomanip>
+#include <iterator>
 
 #define RIP_ALL_NODE "224.0.0.9"
 #define RIP_PORT 520
@@ -46,8 +48,21 @@ NS_LOG_COMPONENT_DEFINE("Rip");
 
 NS_OBJECT_ENSURE_REGISTERED(Rip);
 
+/**
+ * \brief Check whether a mask is made of contiguous leading ones.
+ * \param mask the mask
+ * \return true if the mask is contiguous
+ */
+static bool
+IsContiguous(Ipv4Mask mask)
+{
+    uint32_t inverse = ~mask.Get();
+    return (inverse & (inverse + 1)) == 0;
+}
+
 Rip::Rip()
-    : m_ipv4(nullptr),
+    : m_nonContiguousRoutes(0),
+      m_ipv4(nullptr),
       m_splitHorizonStrategy(Rip::POISON_REVERSE),
       m_initialized(false)
 {
@@ -597,6 +612,9 @@ Rip::DoDispose()
         delete j->first;
     }
     m_routes.clear();
+    m_routesTrie.Clear();
+    m_nonContiguousRoutes = 0;
+    m_changedRoutes.clear();
 
     m_nextTriggeredUpdate.Cancel();
     m_nextUnsolicitedUpdate.Cancel();
@@ -623,7 +641,6 @@ Rip::Lookup(Ipv4Address dst, bool setSource, Ptr<NetDevice> interface)
     NS_LOG_FUNCTION(this << dst << interface);
 
     Ptr<Ipv4Route> rtentry = nullptr;
-    uint16_t longestMask = 0;
 
     /* when sending on local multicast, there have to be interface specified */
     if (dst.IsLocalMulticast())
@@ -639,57 +656,83 @@ Rip::Lookup(Ipv4Address dst, bool setSource, Ptr<NetDevice> interface)
         return rtentry;
     }
 
-    for (auto it = m_routes.begin(); it != m_routes.end(); it++)
+    RipRoutingTableEntry* route = nullptr;
+    if (m_nonContiguousRoutes == 0)
     {
-        RipRoutingTableEntry* j = it->first;
-
-        if (j->GetRouteStatus() == RipRoutingTableEntry::RIP_VALID)
+        // The trie enumerates the matching prefixes from the longest one; among
+        // the valid routes of a prefix, the last one of the table is used
+        m_routesTrie.Match(
+            RoutesTrie::GetKey(dst),
+            [this, &route, interface](uint16_t maskLen, const std::vector<RoutesI>& routes) {
+                for (RoutesI it : routes)
+                {
+                    RipRoutingTableEntry* j = it->first;
+                    /* if interface is given, check the route will output on this interface */
+                    if (j->GetRouteStatus() == RipRoutingTableEntry::RIP_VALID &&
+                        (!interface || interface == m_ipv4->GetNetDevice(j->GetInterface())))
+                    {
+                        NS_LOG_LOGIC("Found global network route " << j << ", mask length "
+                                                                   << maskLen);
+                        route = j;
+                    }
+                }
+                return route != nullptr;
+            });
+    }
+    else
+    {
+        uint16_t longestMask = 0;
+        for (auto it = m_routes.begin(); it != m_routes.end(); it++)
         {
-            Ipv4Mask mask = j->GetDestNetworkMask();
-            uint16_t maskLen = mask.GetPrefixLength();
-            Ipv4Address entry = j->GetDestNetwork();
+            RipRoutingTableEntry* j = it->first;
 
-            NS_LOG_LOGIC("Searching for route to " << dst << ", mask length " << maskLen);
-
-            if (mask.IsMatch(dst, entry))
+            if (j->GetRouteStatus() == RipRoutingTableEntry::RIP_VALID)
             {
-                NS_LOG_LOGIC("Found global network route " << j << ", mask length " << maskLen);
+                Ipv4Mask mask = j->GetDestNetworkMask();
+                uint16_t maskLen = mask.GetPrefixLength();
+                Ipv4Address entry = j->GetDestNetwork();
+
+                NS_LOG_LOGIC("Searching for route to " << dst << ", mask length " << maskLen);
 
                 /* if interface is given, check the route will output on this interface */
-                if (!interface || interface == m_ipv4->GetNetDevice(j->GetInterface()))
+                if (mask.IsMatch(dst, entry) &&
+                    (!interface || interface == m_ipv4->GetNetDevice(j->GetInterface())))
                 {
+                    NS_LOG_LOGIC("Found global network route " << j << ", mask length "
+                                                               << maskLen);
                     if (maskLen < longestMask)
                     {
                         NS_LOG_LOGIC("Previous match longer, skipping");
                         continue;
                     }
-
                     longestMask = maskLen;
+                    route = j;
+                }
+            }
+        }
+    }
 
-                    Ipv4RoutingTableEntry* route = j;
-                    uint32_t interfaceIdx = route->GetInterface();
-                    rtentry = Create<Ipv4Route>();
-
-                    if (setSource)
-                    {
-                        if (route->GetDest().IsAny()) /* default route */
-                        {
-                            rtentry->SetSource(
-                                m_ipv4->SourceAddressSelection(interfaceIdx, route->GetGateway()));
-                        }
-                        else
-                        {
-                            rtentry->SetSource(
-                                m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
-                        }
-                    }
+    if (route)
+    {
+        uint32_t interfaceIdx = route->GetInterface();
+        rtentry = Create<Ipv4Route>();
 
-                    rtentry->SetDestination(route->GetDest());
-                    rtentry->SetGateway(route->GetGateway());
-                    rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
-                }
+        if (setSource)
+        {
+            if (route->GetDest().IsAny()) /* default route */
+            {
+                rtentry->SetSource(
+                    m_ipv4->SourceAddressSelection(interfaceIdx, route->GetGateway()));
+            }
+            else
+            {
+                rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
             }
         }
+
+        rtentry->SetDestination(route->GetDest());
+        rtentry->SetGateway(route->GetGateway());
+        rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
     }
 
     if (rtentry)
@@ -713,7 +756,7 @@ Rip::AddNetworkRouteTo(Ipv4Address network,
     route->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
     route->SetRouteChanged(true);
 
-    m_routes.emplace_back(route, EventId());
+    InsertRoute(route, false);
 }
 
 void
@@ -726,7 +769,7 @@ Rip::AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkPrefix, uint32_t int
     route->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
     route->SetRouteChanged(true);
 
-    m_routes.emplace_back(route, EventId());
+    InsertRoute(route, false);
 }
 
 void
@@ -734,23 +777,17 @@ Rip::InvalidateRoute(RipRoutingTableEntry* route)
 {
     NS_LOG_FUNCTION(this << *route);
 
-    for (auto it = m_routes.begin(); it != m_routes.end(); it++)
+    auto it = FindRoute(route);
+    NS_ABORT_MSG_IF(it == m_routes.end(), "RIP::InvalidateRoute - cannot find the route to update");
+
+    MarkRouteChanged(it);
+    route->SetRouteStatus(RipRoutingTableEntry::RIP_INVALID);
+    route->SetRouteMetric(m_linkDown);
+    if (it->second.IsPending())
     {
-        if (it->first == route)
-        {
-            route->SetRouteStatus(RipRoutingTableEntry::RIP_INVALID);
-            route->SetRouteMetric(m_linkDown);
-            route->SetRouteChanged(true);
-            if (it->second.IsPending())
-            {
-                it->second.Cancel();
-            }
-            it->second =
-                Simulator::Schedule(m_garbageCollectionDelay, &Rip::DeleteRoute, this, route);
-            return;
-        }
+        it->second.Cancel();
     }
-    NS_ABORT_MSG("RIP::InvalidateRoute - cannot find the route to update");
+    it->second = Simulator::Schedule(m_garbageCollectionDelay, &Rip::DeleteRoute, this, route);
 }
 
 void
@@ -758,16 +795,96 @@ Rip::DeleteRoute(RipRoutingTableEntry* route)
 {
     NS_LOG_FUNCTION(this << *route);
 
-    for (auto it = m_routes.begin(); it != m_routes.end(); it++)
+    auto it = FindRoute(route);
+    NS_ABORT_MSG_IF(it == m_routes.end(), "RIP::DeleteRoute - cannot find the route to delete");
+
+    if (route->IsRouteChanged())
+    {
+        m_changedRoutes.erase(std::find(m_changedRoutes.begin(), m_changedRoutes.end(), it));
+    }
+    Ipv4Mask mask = route->GetDestNetworkMask();
+    if (IsContiguous(mask))
+    {
+        bool removed = m_routesTrie.Remove(RoutesTrie::GetKey(route->GetDestNetwork()),
+                                           mask.GetPrefixLength(),
+                                           it);
+        NS_ASSERT(removed);
+    }
+    else
+    {
+        m_nonContiguousRoutes--;
+    }
+    delete route;
+    m_routes.erase(it);
+}
+
+Rip::RoutesI
+Rip::InsertRoute(RipRoutingTableEntry* route, bool front)
+{
+    RoutesI it;
+    if (front)
+    {
+        m_routes.emplace_front(route, EventId());
+        it = m_routes.begin();
+    }
+    else
+    {
+        m_routes.emplace_back(route, EventId());
+        it = std::prev(m_routes.end());
+    }
+    Ipv4Mask mask = route->GetDestNetworkMask();
+    if (IsContiguous(mask))
+    {
+        m_routesTrie.Insert(RoutesTrie::GetKey(route->GetDestNetwork()),
+                            mask.GetPrefixLength(),
+                            it);
+    }
+    else
+    {
+        m_nonContiguousRoutes++;
+    }
+    if (route->IsRouteChanged())
+    {
+        m_changedRoutes.push_back(it);
+    }
+    return it;
+}
+
+Rip::RoutesI
+Rip::FindRoute(RipRoutingTableEntry* route)
+{
+    Ipv4Mask mask = route->GetDestNetworkMask();
+    if (IsContiguous(mask))
     {
-        if (it->first == route)
+        const std::vector<RoutesI>* routes =
+            m_routesTrie.Find(RoutesTrie::GetKey(route->GetDestNetwork()), mask.GetPrefixLength());
+        if (routes)
         {
-            delete route;
-            m_routes.erase(it);
-            return;
+            for (RoutesI it : *routes)
+            {
+                if (it->first == route)
+                {
+                    return it;
+                }
+            }
         }
+        return m_routes.end();
+    }
+    return std::find_if(m_routes.begin(),
+                        m_routes.end(),
+                        [route](const std::pair<RipRoutingTableEntry*, EventId>& j) {
+                            return j.first == route;
+                        });
+}
+
+void
+Rip::MarkRouteChanged(RoutesI it)
+{
+    if (!it->first->IsRouteChanged())
+    {
+        it->first->SetRouteChanged(true);
+        m_changedRoutes.push_back(it);
     }
-    NS_ABORT_MSG("RIP::DeleteRoute - cannot find the route to delete");
 }
 
 void
@@ -1014,7 +1131,7 @@ Rip::HandleRequests(RipHeader requestHdr,
 }
 
 void
-Rip::HandleResponses(RipHeader hdr,
+Rip::HandleResponses(const RipHeader& hdr,
                      Ipv4Address senderAddress,
                      uint32_t incomingInterface,
                      uint8_t hopLimit)
@@ -1028,7 +1145,7 @@ Rip::HandleResponses(RipHeader hdr,
         return;
     }
 
-    std::list<RipRte> rtes = hdr.GetRteList();
+    const std::vector<RipRte>& rtes = hdr.GetRtes();
 
     // validate the RTEs before processing
     for (auto iter = rtes.begin(); iter != rtes.end(); iter++)
@@ -1061,94 +1178,46 @@ Rip::HandleResponses(RipHeader hdr,
         {
             interfaceMetric = m_interfaceMetrics[incomingInterface];
         }
-        uint64_t rteMetric = iter->GetRouteMetric() + interfaceMetric;
+        uint32_t rteMetric = iter->GetRouteMetric() + interfaceMetric;
         if (rteMetric > m_linkDown)
         {
             rteMetric = m_linkDown;
         }
 
-        RoutesI it;
         bool found = false;
-        for (it = m_routes.begin(); it != m_routes.end(); it++)
+        if (IsContiguous(rtePrefixMask))
         {
-            if (it->first->GetDestNetwork() == rteAddr &&
-                it->first->GetDestNetworkMask() == rtePrefixMask)
+            const std::vector<RoutesI>* routes =
+                m_routesTrie.Find(RoutesTrie::GetKey(rteAddr), rtePrefixMask.GetPrefixLength());
+            if (routes)
             {
-                found = true;
-                if (rteMetric < it->first->GetRouteMetric())
-                {
-                    if (senderAddress != it->first->GetGateway())
-                    {
-                        auto route = new RipRoutingTableEntry(rteAddr,
-                                                              rtePrefixMask,
-                                                              senderAddress,
-                                                              incomingInterface);
-                        delete it->first;
-                        it->first = route;
-                    }
-                    it->first->SetRouteMetric(rteMetric);
-                    it->first->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
-                    it->first->SetRouteTag(iter->GetRouteTag());
-                    it->first->SetRouteChanged(true);
-                    it->second.Cancel();
-                    it->second =
-                        Simulator::Schedule(m_timeoutDelay, &Rip::InvalidateRoute, this, it->first);
-                    changed = true;
-                }
-                else if (rteMetric == it->first->GetRouteMetric())
+                for (RoutesI it : *routes)
                 {
-                    if (senderAddress == it->first->GetGateway())
+                    if (it->first->GetDestNetwork() == rteAddr)
                     {
-                        it->second.Cancel();
-                        it->second = Simulator::Schedule(m_timeoutDelay,
-                                                         &Rip::InvalidateRoute,
-                                                         this,
-                                                         it->first);
-                    }
-                    else
-                    {
-                        if (Simulator::GetDelayLeft(it->second) < m_timeoutDelay / 2)
-                        {
-                            auto route = new RipRoutingTableEntry(rteAddr,
-                                                                  rtePrefixMask,
-                                                                  senderAddress,
-                                                                  incomingInterface);
-                            route->SetRouteMetric(rteMetric);
-                            route->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
-                            route->SetRouteTag(iter->GetRouteTag());
-                            route->SetRouteChanged(true);
-                            delete it->first;
-                            it->first = route;
-                            it->second.Cancel();
-                            it->second = Simulator::Schedule(m_timeoutDelay,
-                                                             &Rip::InvalidateRoute,
-                                                             this,
-                                                             route);
-                            changed = true;
-                        }
+                        found = true;
+                        changed |= HandleResponseRte(it,
+                                                     *iter,
+                                                     rteMetric,
+                                                     senderAddress,
+                                                     incomingInterface);
                     }
                 }
-                else if (rteMetric > it->first->GetRouteMetric() &&
-                         senderAddress == it->first->GetGateway())
+            }
+        }
+        else
+        {
+            for (auto it = m_routes.begin(); it != m_routes.end(); it++)
+            {
+                if (it->first->GetDestNetwork() == rteAddr &&
+                    it->first->GetDestNetworkMask() == rtePrefixMask)
                 {
-                    it->second.Cancel();
-                    if (rteMetric < m_linkDown)
-                    {
-                        it->first->SetRouteMetric(rteMetric);
-                        it->first->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
-                        it->first->SetRouteTag(iter->GetRouteTag());
-                        it->first->SetRouteChanged(true);
-                        it->second.Cancel();
-                        it->second = Simulator::Schedule(m_timeoutDelay,
-                                                         &Rip::InvalidateRoute,
-                                                         this,
-                                                         it->first);
-                    }
-                    else
-                    {
-                        InvalidateRoute(it->first);
-                    }
-                    changed = true;
+                    found = true;
+                    changed |= HandleResponseRte(it,
+                                                 *iter,
+                                                 rteMetric,
+                                                 senderAddress,
+                                                 incomingInterface);
                 }
             }
         }
@@ -1161,10 +1230,8 @@ Rip::HandleResponses(RipHeader hdr,
             route->SetRouteMetric(rteMetric);
             route->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
             route->SetRouteChanged(true);
-            m_routes.emplace_front(route, EventId());
-            EventId invalidateEvent =
-                Simulator::Schedule(m_timeoutDelay, &Rip::InvalidateRoute, this, route);
-            (m_routes.begin())->second = invalidateEvent;
+            auto it = InsertRoute(route, true);
+            it->second = Simulator::Schedule(m_timeoutDelay, &Rip::InvalidateRoute, this, route);
             changed = true;
         }
     }
@@ -1175,99 +1242,189 @@ Rip::HandleResponses(RipHeader hdr,
     }
 }
 
+bool
+Rip::HandleResponseRte(RoutesI it,
+                       const RipRte& rte,
+                       uint32_t rteMetric,
+                       Ipv4Address senderAddress,
+                       uint32_t incomingInterface)
+{
+    bool changed = false;
+    if (rteMetric < it->first->GetRouteMetric())
+    {
+        MarkRouteChanged(it);
+        if (senderAddress != it->first->GetGateway())
+        {
+            auto route = new RipRoutingTableEntry(it->first->GetDestNetwork(),
+                                                  it->first->GetDestNetworkMask(),
+                                                  senderAddress,
+                                                  incomingInterface);
+            delete it->first;
+            it->first = route;
+        }
+        it->first->SetRouteMetric(rteMetric);
+        it->first->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
+        it->first->SetRouteTag(rte.GetRouteTag());
+        it->first->SetRouteChanged(true);
+        it->second.Cancel();
+        it->second = Simulator::Schedule(m_timeoutDelay, &Rip::InvalidateRoute, this, it->first);
+        changed = true;
+    }
+    else if (rteMetric == it->first->GetRouteMetric())
+    {
+        if (senderAddress == it->first->GetGateway())
+        {
+            it->second.Cancel();
+            it->second =
+                Simulator::Schedule(m_timeoutDelay, &Rip::InvalidateRoute, this, it->first);
+        }
+        else
+        {
+            if (Simulator::GetDelayLeft(it->second) < m_timeoutDelay / 2)
+            {
+                MarkRouteChanged(it);
+                auto route = new RipRoutingTableEntry(it->first->GetDestNetwork(),
+                                                      it->first->GetDestNetworkMask(),
+                                                      senderAddress,
+                                                      incomingInterface);
+                route->SetRouteMetric(rteMetric);
+                route->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
+                route->SetRouteTag(rte.GetRouteTag());
+                route->SetRouteChanged(true);
+                delete it->first;
+                it->first = route;
+                it->second.Cancel();
+                it->second =
+                    Simulator::Schedule(m_timeoutDelay, &Rip::InvalidateRoute, this, route);
+                changed = true;
+            }
+        }
+    }
+    else if (rteMetric > it->first->GetRouteMetric() && senderAddress == it->first->GetGateway())
+    {
+        it->second.Cancel();
+        if (rteMetric < m_linkDown)
+        {
+            MarkRouteChanged(it);
+            it->first->SetRouteMetric(rteMetric);
+            it->first->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
+            it->first->SetRouteTag(rte.GetRouteTag());
+            it->second.Cancel();
+            it->second =
+                Simulator::Schedule(m_timeoutDelay, &Rip::InvalidateRoute, this, it->first);
+        }
+        else
+        {
+            InvalidateRoute(it->first);
+        }
+        changed = true;
+    }
+    return changed;
+}
+
 void
 Rip::DoSendRouteUpdate(bool periodic)
 {
     NS_LOG_FUNCTION(this << (periodic ? " periodic" : " triggered"));
 
+    // The routes to send are the same on every interface, but for split horizon:
+    // the whole table for a periodic update, only the changed routes otherwise
+    std::vector<RipRoutingTableEntry*> routes;
+    routes.reserve(periodic ? m_routes.size() : m_changedRoutes.size());
+    auto addRoute = [&routes](RipRoutingTableEntry* route) {
+        Ipv4InterfaceAddress rtDestAddr =
+            Ipv4InterfaceAddress(route->GetDestNetwork(), route->GetDestNetworkMask());
+
+        NS_LOG_DEBUG("Processing RT " << rtDestAddr << " " << int(route->IsRouteChanged()));
+
+        // note: the default route has a global scope too
+        if (rtDestAddr.GetScope() == Ipv4InterfaceAddress::GLOBAL)
+        {
+            routes.push_back(route);
+        }
+    };
+    if (periodic)
+    {
+        for (auto rtIter = m_routes.begin(); rtIter != m_routes.end(); rtIter++)
+        {
+            addRoute(rtIter->first);
+        }
+    }
+    else
+    {
+        for (RoutesI rtIter : m_changedRoutes)
+        {
+            addRoute(rtIter->first);
+        }
+    }
+
     for (auto iter = m_unicastSocketList.begin(); iter != m_unicastSocketList.end(); iter++)
     {
         uint32_t interface = iter->second;
 
-        if (m_interfaceExclusions.find(interface) == m_interfaceExclusions.end())
+        if (m_interfaceExclusions.find(interface) == m_interfaceExclusions.end() &&
+            !routes.empty())
         {
             uint16_t mtu = m_ipv4->GetMtu(interface);
             uint16_t maxRte = (mtu - Ipv4Header().GetSerializedSize() -
                                UdpHeader().GetSerializedSize() - RipHeader().GetSerializedSize()) /
                               RipRte().GetSerializedSize();
 
-            Ptr<Packet> p = Create<Packet>();
-            SocketIpTtlTag tag;
-            tag.SetTtl(1);
-            p->AddPacketTag(tag);
+            std::vector<Ipv4Address> networks;
+            for (uint32_t index = 0; index < m_ipv4->GetNAddresses(interface); index++)
+            {
+                Ipv4InterfaceAddress addr = m_ipv4->GetAddress(interface, index);
+                networks.push_back(addr.GetLocal().CombineMask(addr.GetMask()));
+            }
 
             RipHeader hdr;
             hdr.SetCommand(RipHeader::RESPONSE);
 
-            for (auto rtIter = m_routes.begin(); rtIter != m_routes.end(); rtIter++)
+            for (std::size_t n = 0; n < routes.size(); n++)
             {
-                bool splitHorizoning = (rtIter->first->GetInterface() == interface);
-                Ipv4InterfaceAddress rtDestAddr =
-                    Ipv4InterfaceAddress(rtIter->first->GetDestNetwork(),
-                                         rtIter->first->GetDestNetworkMask());
-
-                NS_LOG_DEBUG("Processing RT " << rtDestAddr << " "
-                                              << int(rtIter->first->IsRouteChanged()));
-
-                bool isGlobal = (rtDestAddr.GetScope() == Ipv4InterfaceAddress::GLOBAL);
-                bool isDefaultRoute =
-                    ((rtIter->first->GetDestNetwork() == Ipv4Address::GetAny()) &&
-                     (rtIter->first->GetDestNetworkMask() == Ipv4Mask::GetZero()) &&
-                     (rtIter->first->GetInterface() != interface));
+                RipRoutingTableEntry* route = routes[n];
+                bool splitHorizoning = (route->GetInterface() == interface);
+                bool sameNetwork = std::find(networks.begin(),
+                                             networks.end(),
+                                             route->GetDestNetwork()) != networks.end();
 
-                bool sameNetwork = false;
-                for (uint32_t index = 0; index < m_ipv4->GetNAddresses(interface); index++)
-                {
-                    Ipv4InterfaceAddress addr = m_ipv4->GetAddress(interface, index);
-                    if (addr.GetLocal().CombineMask(addr.GetMask()) ==
-                        rtIter->first->GetDestNetwork())
-                    {
-                        sameNetwork = true;
-                    }
-                }
-
-                if ((isGlobal || isDefaultRoute) && (periodic || rtIter->first->IsRouteChanged()) &&
-                    !sameNetwork)
+                if (!sameNetwork && (m_splitHorizonStrategy != SPLIT_HORIZON || !splitHorizoning))
                 {
                     RipRte rte;
-                    rte.SetPrefix(rtIter->first->GetDestNetwork());
-                    rte.SetSubnetMask(rtIter->first->GetDestNetworkMask());
+                    rte.SetPrefix(route->GetDestNetwork());
+                    rte.SetSubnetMask(route->GetDestNetworkMask());
                     if (m_splitHorizonStrategy == POISON_REVERSE && splitHorizoning)
                     {
                         rte.SetRouteMetric(m_linkDown);
                     }
                     else
                     {
-                        rte.SetRouteMetric(rtIter->first->GetRouteMetric());
-                    }
-                    rte.SetRouteTag(rtIter->first->GetRouteTag());
-                    if ((m_splitHorizonStrategy == SPLIT_HORIZON && !splitHorizoning) ||
-                        (m_splitHorizonStrategy != SPLIT_HORIZON))
-                    {
-                        hdr.AddRte(rte);
+                        rte.SetRouteMetric(route->GetRouteMetric());
                     }
+                    rte.SetRouteTag(route->GetRouteTag());
+                    hdr.AddRte(rte);
                 }
-                if (hdr.GetRteNumber() == maxRte)
+                // each full message, and the last one, goes in a packet of its own
+                if (hdr.GetRteNumber() == maxRte ||
+                    (n + 1 == routes.size() && hdr.GetRteNumber() > 0))
                 {
+                    Ptr<Packet> p = Create<Packet>();
+                    SocketIpTtlTag tag;
+                    tag.SetTtl(1);
+                    p->AddPacketTag(tag);
                     p->AddHeader(hdr);
                     NS_LOG_DEBUG("SendTo: " << *p);
                     iter->first->SendTo(p, 0, InetSocketAddress(RIP_ALL_NODE, RIP_PORT));
-                    p->RemoveHeader(hdr);
                     hdr.ClearRtes();
                 }
             }
-            if (hdr.GetRteNumber() > 0)
-            {
-                p->AddHeader(hdr);
-                NS_LOG_DEBUG("SendTo: " << *p);
-                iter->first->SendTo(p, 0, InetSocketAddress(RIP_ALL_NODE, RIP_PORT));
-            }
         }
     }
-    for (auto rtIter = m_routes.begin(); rtIter != m_routes.end(); rtIter++)
+    for (RoutesI rtIter : m_changedRoutes)
     {
         rtIter->first->SetRouteChanged(false);
     }
+    m_changedRoutes.clear();
 }
 
 void
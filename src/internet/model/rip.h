@@ -27,9 +27,11 @@
 #include "rip-header.h"
 
 #include "ns3/inet-socket-address.h"
+#include "ns3/prefix-trie.h"
 #include "ns3/random-variable-stream.h"
 
 #include <list>
+#include <vector>
 
 namespace ns3
 {
@@ -283,6 +285,9 @@ class Rip : public Ipv4RoutingProtocol
     /// Iterator for container for the network routes
     typedef std::list<std::pair<RipRoutingTableEntry*, EventId>>::iterator RoutesI;
 
+    /// Longest prefix match index of the routes
+    typedef PrefixTrie<RoutesI, 4> RoutesTrie;
+
     /**
      * \brief Receive RIP packets.
      *
@@ -313,11 +318,27 @@ class Rip : public Ipv4RoutingProtocol
      * \param incomingInterface incoming interface
      * \param hopLimit packet's hop limit
      */
-    void HandleResponses(RipHeader hdr,
+    void HandleResponses(const RipHeader& hdr,
                          Ipv4Address senderAddress,
                          uint32_t incomingInterface,
                          uint8_t hopLimit);
 
+    /**
+     * \brief Update a route with a RTE of a RIP response.
+     *
+     * \param it the route, whose destination is the one of the RTE
+     * \param rte the RTE
+     * \param rteMetric the metric of the RTE, plus the metric of the incoming interface
+     * \param senderAddress sender address
+     * \param incomingInterface incoming interface
+     * \return true if the route has changed
+     */
+    bool HandleResponseRte(RoutesI it,
+                           const RipRte& rte,
+                           uint32_t rteMetric,
+                           Ipv4Address senderAddress,
+                           uint32_t incomingInterface);
+
     /**
      * \brief Lookup in the forwarding table for destination.
      * \param dest destination address
@@ -391,7 +412,53 @@ class Rip : public Ipv4RoutingProtocol
      */
     void DeleteRoute(RipRoutingTableEntry* route);
 
+    /**
+     * \brief Add a route to the forwarding table and to its index.
+     * \param route the route (ownership is transferred to the table), to be sent
+     * by the next Triggered Update if its changed flag is set
+     * \param front true to add the route at the beginning of the table
+     * \return iterator to the route
+     */
+    RoutesI InsertRoute(RipRoutingTableEntry* route, bool front);
+
+    /**
+     * \brief Find a route in the forwarding table.
+     * \param route the route
+     * \return iterator to the route, or m_routes.end () if not found
+     */
+    RoutesI FindRoute(RipRoutingTableEntry* route);
+
+    /**
+     * \brief Mark a route as changed, so that the next Triggered Update sends it.
+     *
+     * The setters of a route set its changed flag too: this must be called
+     * before modifying a route of the table.
+     *
+     * \param it the route
+     */
+    void MarkRouteChanged(RoutesI it);
+
     Routes m_routes;                //!<  the forwarding table for network.
+
+    /**
+     * \brief Index of the routes by destination prefix.
+     *
+     * The routes of a prefix are in the order of the forwarding table, as a
+     * route is only added at the beginning of the table for a new prefix.
+     * Routes whose mask is not contiguous can not be indexed: while there
+     * are any, lookups scan the whole forwarding table.
+     */
+    RoutesTrie m_routesTrie;
+
+    uint32_t m_nonContiguousRoutes; //!< Number of routes whose mask is not contiguous
+
+    /**
+     * \brief Routes changed since the last update, in the order of their changes.
+     *
+     * A route is in this list if and only if its changed flag is set.
+     */
+    std::vector<RoutesI> m_changedRoutes;
+
     Ptr<Ipv4> m_ipv4;               //!< IPv4 reference
     Time m_startupDelay;            //!< Random delay before protocol startup.
     Time m_minTriggeredUpdateDelay; //!< Min cooldown delay after a Triggered Update.
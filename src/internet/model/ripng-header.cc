@@ -179,7 +179,7 @@ void
 RipNgHeader::Print(std::ostream& os) const
 {
     os << "command " << int(m_command);
-    for (auto iter = m_rteList.begin(); iter != m_rteList.end(); iter++)
+    for (auto iter = m_rtes.begin(); iter != m_rtes.end(); iter++)
     {
         os << " | ";
         iter->Print(os);
@@ -190,7 +190,7 @@ uint32_t
 RipNgHeader::GetSerializedSize() const
 {
     RipNgRte rte;
-    return 4 + m_rteList.size() * rte.GetSerializedSize();
+    return 4 + m_rtes.size() * rte.GetSerializedSize();
 }
 
 void
@@ -202,7 +202,7 @@ RipNgHeader::Serialize(Buffer::Iterator start) const
     i.WriteU8(1);
     i.WriteU16(0);
 
-    for (auto iter = m_rteList.begin(); iter != m_rteList.end(); iter++)
+    for (auto iter = m_rtes.begin(); iter != m_rtes.end(); iter++)
     {
         iter->Serialize(i);
         i.Next(iter->GetSerializedSize());
@@ -238,11 +238,12 @@ RipNgHeader::Deserialize(Buffer::Iterator start)
     }
 
     uint8_t rteNumber = i.GetRemainingSize() / 20;
+    m_rtes.reserve(m_rtes.size() + rteNumber);
     for (uint8_t n = 0; n < rteNumber; n++)
     {
         RipNgRte rte;
         i.Next(rte.Deserialize(i));
-        m_rteList.push_back(rte);
+        m_rtes.push_back(rte);
     }
 
     return GetSerializedSize();
@@ -263,25 +264,31 @@ RipNgHeader::GetCommand() const
 void
 RipNgHeader::AddRte(RipNgRte rte)
 {
-    m_rteList.push_back(rte);
+    m_rtes.push_back(rte);
 }
 
 void
 RipNgHeader::ClearRtes()
 {
-    m_rteList.clear();
+    m_rtes.clear();
 }
 
 uint16_t
 RipNgHeader::GetRteNumber() const
 {
-    return m_rteList.size();
+    return m_rtes.size();
 }
 
 std::list<RipNgRte>
 RipNgHeader::GetRteList() const
 {
-    return m_rteList;
+    return std::list<RipNgRte>(m_rtes.begin(), m_rtes.end());
+}
+
+const std::vector<RipNgRte>&
+RipNgHeader::GetRtes() const
+{
+    return m_rtes;
 }
 
 std::ostream&
@@ -27,6 +27,7 @@
 #include "ns3/packet.h"
 
 #include <list>
+#include <vector>
 
 namespace ns3
 {
@@ -225,9 +226,15 @@ class RipNgHeader : public Header
      */
     std::list<RipNgRte> GetRteList() const;
 
+    /**
+     * \brief Get the RTEs included in the message, without copying them
+     * \returns the RTEs in the message
+     */
+    const std::vector<RipNgRte>& GetRtes() const;
+
   private:
-    uint8_t m_command;             //!< command type
-    std::list<RipNgRte> m_rteList; //!< list of the RTEs in the message
+    uint8_t m_command;            //!< command type
+    std::vector<RipNgRte> m_rtes; //!< RTEs in the message
 };
 
 /**
@@ -34,7 +34,9 @@
 #include "ns3/simulator.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <iomanip>
+#include <iterator>
 
 #define RIPNG_ALL_NODE "ff02::9"
 #define RIPNG_PORT 521
@@ -581,6 +583,8 @@ RipNg::DoDispose()
         delete j->first;
     }
     m_routes.clear();
+    m_routesTrie.Clear();
+    m_changedRoutes.clear();
 
     m_nextTriggeredUpdate.Cancel();
     m_nextUnsolicitedUpdate.Cancel();
@@ -607,7 +611,6 @@ RipNg::Lookup(Ipv6Address dst, bool setSource, Ptr<NetDevice> interface)
     NS_LOG_FUNCTION(this << dst << interface);
 
     Ptr<Ipv6Route> rtentry = nullptr;
-    uint16_t longestMask = 0;
 
     /* when sending on link-local multicast, there have to be interface specified */
     if (dst.IsLinkLocalMulticast())
@@ -624,64 +627,55 @@ RipNg::Lookup(Ipv6Address dst, bool setSource, Ptr<NetDevice> interface)
         return rtentry;
     }
 
-    for (auto it = m_routes.begin(); it != m_routes.end(); it++)
-    {
-        RipNgRoutingTableEntry* j = it->first;
-
-        if (j->GetRouteStatus() == RipNgRoutingTableEntry::RIPNG_VALID)
-        {
-            Ipv6Prefix mask = j->GetDestNetworkPrefix();
-            uint16_t maskLen = mask.GetPrefixLength();
-            Ipv6Address entry = j->GetDestNetwork();
-
-            NS_LOG_LOGIC("Searching for route to " << dst << ", mask length " << maskLen);
-
-            if (mask.IsMatch(dst, entry))
+    // The trie enumerates the matching prefixes from the longest one; among the
+    // valid routes of a prefix, the last one of the table is used
+    RipNgRoutingTableEntry* route = nullptr;
+    m_routesTrie.Match(
+        RoutesTrie::GetKey(dst),
+        [this, &route, interface](uint16_t maskLen, const std::vector<RoutesI>& routes) {
+            for (RoutesI it : routes)
             {
-                NS_LOG_LOGIC("Found global network route " << j << ", mask length " << maskLen);
-
+                RipNgRoutingTableEntry* j = it->first;
                 /* if interface is given, check the route will output on this interface */
-                if (!interface || interface == m_ipv6->GetNetDevice(j->GetInterface()))
+                if (j->GetRouteStatus() == RipNgRoutingTableEntry::RIPNG_VALID &&
+                    (!interface || interface == m_ipv6->GetNetDevice(j->GetInterface())))
                 {
-                    if (maskLen < longestMask)
-                    {
-                        NS_LOG_LOGIC("Previous match longer, skipping");
-                        continue;
-                    }
-
-                    longestMask = maskLen;
-
-                    Ipv6RoutingTableEntry* route = j;
-                    uint32_t interfaceIdx = route->GetInterface();
-                    rtentry = Create<Ipv6Route>();
+                    NS_LOG_LOGIC("Found global network route " << j << ", mask length "
+                                                               << maskLen);
+                    route = j;
+                }
+            }
+            return route != nullptr;
+        });
 
-                    if (setSource)
-                    {
-                        // GetGateway().IsAny() means that the destination is reachable without a
-                        // gateway (is on-link). GetDest().IsAny() means that the route is the
-                        // default route. Having both true is very strange, but possible.
-                        // If the RT entry is specific for a destination, use that as a hint for the
-                        // source address to be used. Else, use the destination or the prefix to be
-                        // used stated in the RT entry.
-                        if (!route->GetDest().IsAny())
-                        {
-                            rtentry->SetSource(
-                                m_ipv6->SourceAddressSelection(interfaceIdx, route->GetDest()));
-                        }
-                        else
-                        {
-                            rtentry->SetSource(m_ipv6->SourceAddressSelection(
-                                interfaceIdx,
-                                route->GetPrefixToUse().IsAny() ? dst : route->GetPrefixToUse()));
-                        }
-                    }
+    if (route)
+    {
+        uint32_t interfaceIdx = route->GetInterface();
+        rtentry = Create<Ipv6Route>();
 
-                    rtentry->SetDestination(route->GetDest());
-                    rtentry->SetGateway(route->GetGateway());
-                    rtentry->SetOutputDevice(m_ipv6->GetNetDevice(interfaceIdx));
-                }
+        if (setSource)
+        {
+            // GetGateway().IsAny() means that the destination is reachable without a
+            // gateway (is on-link). GetDest().IsAny() means that the route is the
+            // default route. Having both true is very strange, but possible.
+            // If the RT entry is specific for a destination, use that as a hint for the
+            // source address to be used. Else, use the destination or the prefix to be
+            // used stated in the RT entry.
+            if (!route->GetDest().IsAny())
+            {
+                rtentry->SetSource(m_ipv6->SourceAddressSelection(interfaceIdx, route->GetDest()));
+            }
+            else
+            {
+                rtentry->SetSource(m_ipv6->SourceAddressSelection(
+                    interfaceIdx,
+                    route->GetPrefixToUse().IsAny() ? dst : route->GetPrefixToUse()));
             }
         }
+
+        rtentry->SetDestination(route->GetDest());
+        rtentry->SetGateway(route->GetGateway());
+        rtentry->SetOutputDevice(m_ipv6->GetNetDevice(interfaceIdx));
     }
 
     if (rtentry)
@@ -712,7 +706,7 @@ RipNg::AddNetworkRouteTo(Ipv6Address network,
     route->SetRouteStatus(RipNgRoutingTableEntry::RIPNG_VALID);
     route->SetRouteChanged(true);
 
-    m_routes.emplace_back(route, EventId());
+    InsertRoute(route, false);
 }
 
 void
@@ -725,7 +719,7 @@ RipNg::AddNetworkRouteTo(Ipv6Address network, Ipv6Prefix networkPrefix, uint32_t
     route->SetRouteStatus(RipNgRoutingTableEntry::RIPNG_VALID);
     route->SetRouteChanged(true);
 
-    m_routes.emplace_back(route, EventId());
+    InsertRoute(route, false);
 }
 
 void
@@ -733,23 +727,18 @@ RipNg::InvalidateRoute(RipNgRoutingTableEntry* route)
 {
     NS_LOG_FUNCTION(this << *route);
 
-    for (auto it = m_routes.begin(); it != m_routes.end(); it++)
+    auto it = FindRoute(route);
+    NS_ABORT_MSG_IF(it == m_routes.end(),
+                    "Ripng::InvalidateRoute - cannot find the route to update");
+
+    MarkRouteChanged(it);
+    route->SetRouteStatus(RipNgRoutingTableEntry::RIPNG_INVALID);
+    route->SetRouteMetric(m_linkDown);
+    if (it->second.IsPending())
     {
-        if (it->first == route)
-        {
-            route->SetRouteStatus(RipNgRoutingTableEntry::RIPNG_INVALID);
-            route->SetRouteMetric(m_linkDown);
-            route->SetRouteChanged(true);
-            if (it->second.IsPending())
-            {
-                it->second.Cancel();
-            }
-            it->second =
-                Simulator::Schedule(m_garbageCollectionDelay, &RipNg::DeleteRoute, this, route);
-            return;
-        }
+        it->second.Cancel();
     }
-    NS_ABORT_MSG("Ripng::InvalidateRoute - cannot find the route to update");
+    it->second = Simulator::Schedule(m_garbageCollectionDelay, &RipNg::DeleteRoute, this, route);
 }
 
 void
@@ -757,16 +746,72 @@ RipNg::DeleteRoute(RipNgRoutingTableEntry* route)
 {
     NS_LOG_FUNCTION(this << *route);
 
-    for (auto it = m_routes.begin(); it != m_routes.end(); it++)
+    auto it = FindRoute(route);
+    NS_ABORT_MSG_IF(it == m_routes.end(), "Ripng::DeleteRoute - cannot find the route to delete");
+
+    if (route->IsRouteChanged())
+    {
+        m_changedRoutes.erase(std::find(m_changedRoutes.begin(), m_changedRoutes.end(), it));
+    }
+    bool removed = m_routesTrie.Remove(RoutesTrie::GetKey(route->GetDestNetwork()),
+                                       route->GetDestNetworkPrefix().GetPrefixLength(),
+                                       it);
+    NS_ASSERT(removed);
+    delete route;
+    m_routes.erase(it);
+}
+
+RipNg::RoutesI
+RipNg::InsertRoute(RipNgRoutingTableEntry* route, bool front)
+{
+    RoutesI it;
+    if (front)
     {
-        if (it->first == route)
+        m_routes.emplace_front(route, EventId());
+        it = m_routes.begin();
+    }
+    else
+    {
+        m_routes.emplace_back(route, EventId());
+        it = std::prev(m_routes.end());
+    }
+    m_routesTrie.Insert(RoutesTrie::GetKey(route->GetDestNetwork()),
+                        route->GetDestNetworkPrefix().GetPrefixLength(),
+                        it);
+    if (route->IsRouteChanged())
+    {
+        m_changedRoutes.push_back(it);
+    }
+    return it;
+}
+
+RipNg::RoutesI
+RipNg::FindRoute(RipNgRoutingTableEntry* route)
+{
+    const std::vector<RoutesI>* routes =
+        m_routesTrie.Find(RoutesTrie::GetKey(route->GetDestNetwork()),
+                          route->GetDestNetworkPrefix().GetPrefixLength());
+    if (routes)
+    {
+        for (RoutesI it : *routes)
         {
-            delete route;
-            m_routes.erase(it);
-            return;
+            if (it->first == route)
+            {
+                return it;
+            }
         }
     }
-    NS_ABORT_MSG("Ripng::DeleteRoute - cannot find the route to delete");
+    return m_routes.end();
+}
+
+void
+RipNg::MarkRouteChanged(RoutesI it)
+{
+    if (!it->first->IsRouteChanged())
+    {
+        it->first->SetRouteChanged(true);
+        m_changedRoutes.push_back(it);
+    }
 }
 
 void
@@ -1002,7 +1047,7 @@ RipNg::HandleRequests(RipNgHeader requestHdr,
 }
 
 void
-RipNg::HandleResponses(RipNgHeader hdr,
+RipNg::HandleResponses(const RipNgHeader& hdr,
                        Ipv6Address senderAddress,
                        uint32_t incomingInterface,
                        uint8_t hopLimit)
@@ -1028,7 +1073,7 @@ RipNg::HandleResponses(RipNgHeader hdr,
         return;
     }
 
-    std::list<RipNgRte> rtes = hdr.GetRteList();
+    const std::vector<RipNgRte>& rtes = hdr.GetRtes();
 
     // validate the RTEs before processing
     for (auto iter = rtes.begin(); iter != rtes.end(); iter++)
@@ -1072,92 +1117,18 @@ RipNg::HandleResponses(RipNgHeader hdr,
         {
             rteMetric = m_linkDown;
         }
-        RoutesI it;
         bool found = false;
-        for (it = m_routes.begin(); it != m_routes.end(); it++)
+        const std::vector<RoutesI>* routes =
+            m_routesTrie.Find(RoutesTrie::GetKey(rteAddr), rtePrefix.GetPrefixLength());
+        if (routes)
         {
-            if (it->first->GetDestNetwork() == rteAddr &&
-                it->first->GetDestNetworkPrefix() == rtePrefix)
+            for (RoutesI it : *routes)
             {
-                found = true;
-                if (rteMetric < it->first->GetRouteMetric())
-                {
-                    if (senderAddress != it->first->GetGateway())
-                    {
-                        auto route = new RipNgRoutingTableEntry(rteAddr,
-                                                                rtePrefix,
-                                                                senderAddress,
-                                                                incomingInterface,
-                                                                Ipv6Address::GetAny());
-                        delete it->first;
-                        it->first = route;
-                    }
-                    it->first->SetRouteMetric(rteMetric);
-                    it->first->SetRouteStatus(RipNgRoutingTableEntry::RIPNG_VALID);
-                    it->first->SetRouteTag(iter->GetRouteTag());
-                    it->first->SetRouteChanged(true);
-                    it->second.Cancel();
-                    it->second = Simulator::Schedule(m_timeoutDelay,
-                                                     &RipNg::InvalidateRoute,
-                                                     this,
-                                                     it->first);
-                    changed = true;
-                }
-                else if (rteMetric == it->first->GetRouteMetric())
-                {
-                    if (senderAddress == it->first->GetGateway())
-                    {
-                        it->second.Cancel();
-                        it->second = Simulator::Schedule(m_timeoutDelay,
-                                                         &RipNg::InvalidateRoute,
-                                                         this,
-                                                         it->first);
-                    }
-                    else
-                    {
-                        if (Simulator::GetDelayLeft(it->second) < m_timeoutDelay / 2)
-                        {
-                            auto route = new RipNgRoutingTableEntry(rteAddr,
-                                                                    rtePrefix,
-                                                                    senderAddress,
-                                                                    incomingInterface,
-                                                                    Ipv6Address::GetAny());
-                            route->SetRouteMetric(rteMetric);
-                            route->SetRouteStatus(RipNgRoutingTableEntry::RIPNG_VALID);
-                            route->SetRouteTag(iter->GetRouteTag());
-                            route->SetRouteChanged(true);
-                            delete it->first;
-                            it->first = route;
-                            it->second.Cancel();
-                            it->second = Simulator::Schedule(m_timeoutDelay,
-                                                             &RipNg::InvalidateRoute,
-                                                             this,
-                                                             route);
-                            changed = true;
-                        }
-                    }
-                }
-                else if (rteMetric > it->first->GetRouteMetric() &&
-                         senderAddress == it->first->GetGateway())
+                if (it->first->GetDestNetwork() == rteAddr)
                 {
-                    it->second.Cancel();
-                    if (rteMetric < m_linkDown)
-                    {
-                        it->first->SetRouteMetric(rteMetric);
-                        it->first->SetRouteStatus(RipNgRoutingTableEntry::RIPNG_VALID);
-                        it->first->SetRouteTag(iter->GetRouteTag());
-                        it->first->SetRouteChanged(true);
-                        it->second.Cancel();
-                        it->second = Simulator::Schedule(m_timeoutDelay,
-                                                         &RipNg::InvalidateRoute,
-                                                         this,
-                                                         it->first);
-                    }
-                    else
-                    {
-                        InvalidateRoute(it->first);
-                    }
-                    changed = true;
+                    found = true;
+                    changed |=
+                        HandleResponseRte(it, *iter, rteMetric, senderAddress, incomingInterface);
                 }
             }
         }
@@ -1173,10 +1144,8 @@ RipNg::HandleResponses(RipNgHeader hdr,
             route->SetRouteMetric(rteMetric);
             route->SetRouteStatus(RipNgRoutingTableEntry::RIPNG_VALID);
             route->SetRouteChanged(true);
-            m_routes.emplace_front(route, EventId());
-            EventId invalidateEvent =
-                Simulator::Schedule(m_timeoutDelay, &RipNg::InvalidateRoute, this, route);
-            (m_routes.begin())->second = invalidateEvent;
+            auto it = InsertRoute(route, true);
+            it->second = Simulator::Schedule(m_timeoutDelay, &RipNg::InvalidateRoute, this, route);
             changed = true;
         }
     }
@@ -1187,16 +1156,130 @@ RipNg::HandleResponses(RipNgHeader hdr,
     }
 }
 
+bool
+RipNg::HandleResponseRte(RoutesI it,
+                         const RipNgRte& rte,
+                         uint16_t rteMetric,
+                         Ipv6Address senderAddress,
+                         uint32_t incomingInterface)
+{
+    bool changed = false;
+    if (rteMetric < it->first->GetRouteMetric())
+    {
+        MarkRouteChanged(it);
+        if (senderAddress != it->first->GetGateway())
+        {
+            auto route = new RipNgRoutingTableEntry(it->first->GetDestNetwork(),
+                                                    it->first->GetDestNetworkPrefix(),
+                                                    senderAddress,
+                                                    incomingInterface,
+                                                    Ipv6Address::GetAny());
+            delete it->first;
+            it->first = route;
+        }
+        it->first->SetRouteMetric(rteMetric);
+        it->first->SetRouteStatus(RipNgRoutingTableEntry::RIPNG_VALID);
+        it->first->SetRouteTag(rte.GetRouteTag());
+        it->first->SetRouteChanged(true);
+        it->second.Cancel();
+        it->second = Simulator::Schedule(m_timeoutDelay, &RipNg::InvalidateRoute, this, it->first);
+        changed = true;
+    }
+    else if (rteMetric == it->first->GetRouteMetric())
+    {
+        if (senderAddress == it->first->GetGateway())
+        {
+            it->second.Cancel();
+            it->second =
+                Simulator::Schedule(m_timeoutDelay, &RipNg::InvalidateRoute, this, it->first);
+        }
+        else
+        {
+            if (Simulator::GetDelayLeft(it->second) < m_timeoutDelay / 2)
+            {
+                MarkRouteChanged(it);
+                auto route = new RipNgRoutingTableEntry(it->first->GetDestNetwork(),
+                                                        it->first->GetDestNetworkPrefix(),
+                                                        senderAddress,
+                                                        incomingInterface,
+                                                        Ipv6Address::GetAny());
+                route->SetRouteMetric(rteMetric);
+                route->SetRouteStatus(RipNgRoutingTableEntry::RIPNG_VALID);
+                route->SetRouteTag(rte.GetRouteTag());
+                route->SetRouteChanged(true);
+                delete it->first;
+                it->first = route;
+                it->second.Cancel();
+                it->second =
+                    Simulator::Schedule(m_timeoutDelay, &RipNg::InvalidateRoute, this, route);
+                changed = true;
+            }
+        }
+    }
+    else if (rteMetric > it->first->GetRouteMetric() && senderAddress == it->first->GetGateway())
+    {
+        it->second.Cancel();
+        if (rteMetric < m_linkDown)
+        {
+            MarkRouteChanged(it);
+            it->first->SetRouteMetric(rteMetric);
+            it->first->SetRouteStatus(RipNgRoutingTableEntry::RIPNG_VALID);
+            it->first->SetRouteTag(rte.GetRouteTag());
+            it->second.Cancel();
+            it->second =
+                Simulator::Schedule(m_timeoutDelay, &RipNg::InvalidateRoute, this, it->first);
+        }
+        else
+        {
+            InvalidateRoute(it->first);
+        }
+        changed = true;
+    }
+    return changed;
+}
+
 void
 RipNg::DoSendRouteUpdate(bool periodic)
 {
     NS_LOG_FUNCTION(this << (periodic ? " periodic" : " triggered"));
 
+    // The routes to send are the same on every interface, but for split horizon:
+    // the whole table for a periodic update, only the changed routes otherwise
+    std::vector<RipNgRoutingTableEntry*> routes;
+    routes.reserve(periodic ? m_routes.size() : m_changedRoutes.size());
+    auto addRoute = [&routes](RipNgRoutingTableEntry* route) {
+        Ipv6InterfaceAddress rtDestAddr =
+            Ipv6InterfaceAddress(route->GetDestNetwork(), route->GetDestNetworkPrefix());
+
+        NS_LOG_DEBUG("Processing RT " << rtDestAddr << " " << int(route->IsRouteChanged()));
+
+        // note: the default route has a global scope too
+        if (rtDestAddr.GetScope() == Ipv6InterfaceAddress::GLOBAL)
+        {
+            routes.push_back(route);
+        }
+    };
+    if (periodic)
+    {
+        for (auto rtIter = m_routes.begin(); rtIter != m_routes.end(); rtIter++)
+        {
+            addRoute(rtIter->first);
+        }
+    }
+    else
+    {
+        for (RoutesI rtIter : m_changedRoutes)
+        {
+            addRoute(rtIter->first);
+        }
+    }
+
     for (auto iter = m_unicastSocketList.begin(); iter != m_unicastSocketList.end(); iter++)
     {
         uint32_t interface = iter->second;
 
-        if (m_interfaceExclusions.find(interface) == m_interfaceExclusions.end())
+        if (m_interfaceExclusions.find(interface) == m_interfaceExclusions.end() &&
+            !routes.empty())
         {
             uint16_t mtu = m_ipv6->GetMtu(interface);
             uint16_t maxRte =
@@ -1204,71 +1287,51 @@ RipNg::DoSendRouteUpdate(bool periodic)
                  RipNgHeader().GetSerializedSize()) /
                 RipNgRte().GetSerializedSize();
 
-            Ptr<Packet> p = Create<Packet>();
-            SocketIpv6HopLimitTag tag;
-            tag.SetHopLimit(255);
-            p->AddPacketTag(tag);
-
             RipNgHeader hdr;
             hdr.SetCommand(RipNgHeader::RESPONSE);
 
-            for (auto rtIter = m_routes.begin(); rtIter != m_routes.end(); rtIter++)
+            for (std::size_t n = 0; n < routes.size(); n++)
             {
-                bool splitHorizoning = (rtIter->first->GetInterface() == interface);
-                Ipv6InterfaceAddress rtDestAddr =
-                    Ipv6InterfaceAddress(rtIter->first->GetDestNetwork(),
-                                         rtIter->first->GetDestNetworkPrefix());
-
-                NS_LOG_DEBUG("Processing RT " << rtDestAddr << " "
-                                              << int(rtIter->first->IsRouteChanged()));
-
-                bool isGlobal = (rtDestAddr.GetScope() == Ipv6InterfaceAddress::GLOBAL);
-                bool isDefaultRoute =
-                    ((rtIter->first->GetDestNetwork() == Ipv6Address::GetAny()) &&
-                     (rtIter->first->GetDestNetworkPrefix() == Ipv6Prefix::GetZero()) &&
-                     (rtIter->first->GetInterface() != interface));
+                RipNgRoutingTableEntry* route = routes[n];
+                bool splitHorizoning = (route->GetInterface() == interface);
 
-                if ((isGlobal || isDefaultRoute) && (periodic || rtIter->first->IsRouteChanged()))
+                if (m_splitHorizonStrategy != SPLIT_HORIZON || !splitHorizoning)
                 {
                     RipNgRte rte;
-                    rte.SetPrefix(rtIter->first->GetDestNetwork());
-                    rte.SetPrefixLen(rtIter->first->GetDestNetworkPrefix().GetPrefixLength());
+                    rte.SetPrefix(route->GetDestNetwork());
+                    rte.SetPrefixLen(route->GetDestNetworkPrefix().GetPrefixLength());
                     if (m_splitHorizonStrategy == POISON_REVERSE && splitHorizoning)
                     {
                         rte.SetRouteMetric(m_linkDown);
                     }
                     else
                     {
-                        rte.SetRouteMetric(rtIter->first->GetRouteMetric());
-                    }
-                    rte.SetRouteTag(rtIter->first->GetRouteTag());
-                    if ((m_splitHorizonStrategy == SPLIT_HORIZON && !splitHorizoning) ||
-                        (m_splitHorizonStrategy != SPLIT_HORIZON))
-                    {
-                        hdr.AddRte(rte);
+                        rte.SetRouteMetric(route->GetRouteMetric());
                     }
+                    rte.SetRouteTag(route->GetRouteTag());
+                    hdr.AddRte(rte);
                 }
-                if (hdr.GetRteNumber() == maxRte)
+                // each full message, and the last one, goes in a packet of its own
+                if (hdr.GetRteNumber() == maxRte ||
+                    (n + 1 == routes.size() && hdr.GetRteNumber() > 0))
                 {
+                    Ptr<Packet> p = Create<Packet>();
+                    SocketIpv6HopLimitTag tag;
+                    tag.SetHopLimit(255);
+                    p->AddPacketTag(tag);
                     p->AddHeader(hdr);
                     NS_LOG_DEBUG("SendTo: " << *p);
                     iter->first->SendTo(p, 0, Inet6SocketAddress(RIPNG_ALL_NODE, RIPNG_PORT));
-                    p->RemoveHeader(hdr);
                     hdr.ClearRtes();
                 }
             }
-            if (hdr.GetRteNumber() > 0)
-            {
-                p->AddHeader(hdr);
-                NS_LOG_DEBUG("SendTo: " << *p);
-                iter->first->SendTo(p, 0, Inet6SocketAddress(RIPNG_ALL_NODE, RIPNG_PORT));
-            }
         }
     }
-    for (auto rtIter = m_routes.begin(); rtIter != m_routes.end(); rtIter++)
+    for (RoutesI rtIter : m_changedRoutes)
     {
         rtIter->first->SetRouteChanged(false);
     }
+    m_changedRoutes.clear();
 }
 
 void
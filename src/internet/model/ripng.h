@@ -27,9 +27,11 @@
 #include "ripng-header.h"
 
 #include "ns3/inet6-socket-address.h"
+#include "ns3/prefix-trie.h"
 #include "ns3/random-variable-stream.h"
 
 #include <list>
+#include <vector>
 
 namespace ns3
 {
@@ -295,6 +297,9 @@ class RipNg : public Ipv6RoutingProtocol
     /// Iterator for container for the network routes
     typedef std::list<std::pair<RipNgRoutingTableEntry*, EventId>>::iterator RoutesI;
 
+    /// Longest prefix match index of the routes
+    typedef PrefixTrie<RoutesI, 16> RoutesTrie;
+
     /**
      * \brief Receive RIPng packets.
      *
@@ -325,11 +330,27 @@ class RipNg : public Ipv6RoutingProtocol
      * \param incomingInterface incoming interface
      * \param hopLimit packet's hop limit
      */
-    void HandleResponses(RipNgHeader hdr,
+    void HandleResponses(const RipNgHeader& hdr,
                          Ipv6Address senderAddress,
                          uint32_t incomingInterface,
                          uint8_t hopLimit);
 
+    /**
+     * \brief Update a route with a RTE of a RIPng response.
+     *
+     * \param it the route, whose destination is the one of the RTE
+     * \param rte the RTE
+     * \param rteMetric the metric of the RTE, plus the metric of the incoming interface
+     * \param senderAddress sender address
+     * \param incomingInterface incoming interface
+     * \return true if the route has changed
+     */
+    bool HandleResponseRte(RoutesI it,
+                           const RipNgRte& rte,
+                           uint16_t rteMetric,
+                           Ipv6Address senderAddress,
+                           uint32_t incomingInterface);
+
     /**
      * \brief Lookup in the forwarding table for destination.
      * \param dest destination address
@@ -405,7 +426,49 @@ class RipNg : public Ipv6RoutingProtocol
      */
     void DeleteRoute(RipNgRoutingTableEntry* route);
 
+    /**
+     * \brief Add a route to the forwarding table and to its index.
+     * \param route the route (ownership is transferred to the table), to be sent
+     * by the next Triggered Update if its changed flag is set
+     * \param front true to add the route at the beginning of the table
+     * \return iterator to the route
+     */
+    RoutesI InsertRoute(RipNgRoutingTableEntry* route, bool front);
+
+    /**
+     * \brief Find a route in the forwarding table.
+     * \param route the route
+     * \return iterator to the route, or m_routes.end () if not found
+     */
+    RoutesI FindRoute(RipNgRoutingTableEntry* route);
+
+    /**
+     * \brief Mark a route as changed, so that the next Triggered Update sends it.
+     *
+     * The setters of a route set its changed flag too: this must be called
+     * before modifying a route of the table.
+     *
+     * \param it the route
+     */
+    void MarkRouteChanged(RoutesI it);
+
     Routes m_routes;                //!<  the forwarding table for network.
+
+    /**
+     * \brief Index of the routes by destination prefix.
+     *
+     * The routes of a prefix are in the order of the forwarding table, as a
+     * route is only added at the beginning of the table for a new prefix.
+     */
+    RoutesTrie m_routesTrie;
+
+    /**
+     * \brief Routes changed since the last update, in the order of their changes.
+     *
+     * A route is in this list if and only if its changed flag is set.
+     */
+    std::vector<RoutesI> m_changedRoutes;
+
     Ptr<Ipv6> m_ipv6;               //!< IPv6 reference
     Time m_startupDelay;            //!< Random delay before protocol startup.
     Time m_minTriggeredUpdateDelay; //!< Min cooldown delay after a Triggered Update.
@@ -0,0 +1,241 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "rule-table-packet-filter.h"
+
+#include "ns3/abort.h"
+#include "ns3/hash.h"
+#include "ns3/log.h"
+
+#include <cstring>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("RuleTablePacketFilter");
+
+NS_OBJECT_ENSURE_REGISTERED(RuleTablePacketFilter);
+
+TypeId
+RuleTablePacketFilter::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::RuleTablePacketFilter")
+                            .SetParent<PacketFilter>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<RuleTablePacketFilter>();
+    return tid;
+}
+
+RuleTablePacketFilter::RuleTablePacketFilter()
+    : m_nRules(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+RuleTablePacketFilter::~RuleTablePacketFilter()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+RuleTablePacketFilter::AddRule(Ipv4Address source,
+                               Ipv4Mask sourceMask,
+                               Ipv4Address destination,
+                               Ipv4Mask destinationMask,
+                               int32_t protocol,
+                               int32_t sourcePort,
+                               int32_t destinationPort,
+                               int32_t cls)
+{
+    NS_LOG_FUNCTION(this << source << sourceMask << destination << destinationMask << protocol
+                         << sourcePort << destinationPort << cls);
+
+    Key key{};
+    Key mask{};
+    key.version = 4;
+    mask.version = 0xff;
+    source.Serialize(key.source);
+    Ipv4Address(sourceMask.Get()).Serialize(mask.source);
+    destination.Serialize(key.destination);
+    Ipv4Address(destinationMask.Get()).Serialize(mask.destination);
+    SetTransport(key, mask, protocol, sourcePort, destinationPort);
+    DoAddRule(key, mask, cls);
+}
+
+void
+RuleTablePacketFilter::AddRule(Ipv6Address source,
+                               Ipv6Prefix sourcePrefix,
+                               Ipv6Address destination,
+                               Ipv6Prefix destinationPrefix,
+                               int32_t protocol,
+                               int32_t sourcePort,
+                               int32_t destinationPort,
+                               int32_t cls)
+{
+    NS_LOG_FUNCTION(this << source << sourcePrefix << destination << destinationPrefix << protocol
+                         << sourcePort << destinationPort << cls);
+
+    Key key{};
+    Key mask{};
+    key.version = 6;
+    mask.version = 0xff;
+    source.Serialize(key.source);
+    sourcePrefix.GetBytes(mask.source);
+    destination.Serialize(key.destination);
+    destinationPrefix.GetBytes(mask.destination);
+    SetTransport(key, mask, protocol, sourcePort, destinationPort);
+    DoAddRule(key, mask, cls);
+}
+
+uint32_t
+RuleTablePacketFilter::GetNRules() const
+{
+    return m_nRules;
+}
+
+uint32_t
+RuleTablePacketFilter::GetNRuleGroups() const
+{
+    return m_groups.size();
+}
+
+void
+RuleTablePacketFilter::SetTransport(Key& key,
+                                    Key& mask,
+                                    int32_t protocol,
+                                    int32_t sourcePort,
+                                    int32_t destinationPort)
+{
+    NS_ABORT_MSG_IF(protocol < ANY || protocol > 0xff, "Invalid protocol " << protocol);
+    NS_ABORT_MSG_IF(sourcePort < ANY || sourcePort > 0xffff, "Invalid port " << sourcePort);
+    NS_ABORT_MSG_IF(destinationPort < ANY || destinationPort > 0xffff,
+                    "Invalid port " << destinationPort);
+
+    if (protocol != ANY)
+    {
+        key.protocol = protocol;
+        mask.protocol = 0xff;
+    }
+    if (sourcePort != ANY)
+    {
+        key.sourcePort = sourcePort;
+        mask.sourcePort = 0xffff;
+    }
+    if (destinationPort != ANY)
+    {
+        key.destinationPort = destinationPort;
+        mask.destinationPort = 0xffff;
+    }
+}
+
+void
+RuleTablePacketFilter::DoAddRule(Key key, const Key& mask, int32_t cls)
+{
+    NS_ABORT_MSG_IF(cls < 0, "The class of a rule must be non-negative");
+
+    key = Apply(key, mask);
+    uint32_t index = m_nRules++;
+
+    for (auto& group : m_groups)
+    {
+        if (KeyEqual()(group.mask, mask))
+        {
+            // a rule added before with the same key hides this one
+            group.rules.emplace(key, Rule{index, cls});
+            return;
+        }
+    }
+    // groups are created by their first rule, hence they are sorted by first rule
+    m_groups.push_back(RuleGroup{mask, index, {}});
+    m_groups.back().rules.emplace(key, Rule{index, cls});
+}
+
+RuleTablePacketFilter::Key
+RuleTablePacketFilter::Apply(const Key& tuple, const Key& mask)
+{
+    Key key{};
+    for (uint8_t i = 0; i < 16; i++)
+    {
+        key.source[i] = tuple.source[i] & mask.source[i];
+        key.destination[i] = tuple.destination[i] & mask.destination[i];
+    }
+    key.version = tuple.version & mask.version;
+    key.protocol = tuple.protocol & mask.protocol;
+    key.sourcePort = tuple.sourcePort & mask.sourcePort;
+    key.destinationPort = tuple.destinationPort & mask.destinationPort;
+    return key;
+}
+
+bool
+RuleTablePacketFilter::KeyEqual::operator()(const Key& a, const Key& b) const
+{
+    return a.version == b.version && a.protocol == b.protocol && a.sourcePort == b.sourcePort &&
+           a.destinationPort == b.destinationPort &&
+           std::memcmp(a.source, b.source, 16) == 0 &&
+           std::memcmp(a.destination, b.destination, 16) == 0;
+}
+
+std::size_t
+RuleTablePacketFilter::KeyHash::operator()(const Key& key) const
+{
+    uint8_t buf[38];
+    std::memcpy(buf, key.source, 16);
+    std::memcpy(buf + 16, key.destination, 16);
+    buf[32] = key.version;
+    buf[33] = key.protocol;
+    std::memcpy(buf + 34, &key.sourcePort, 2);
+    std::memcpy(buf + 36, &key.destinationPort, 2);
+    return Hash32((char*)buf, 38);
+}
+
+bool
+RuleTablePacketFilter::CheckProtocol(Ptr<QueueDiscItem> item) const
+{
+    NS_LOG_FUNCTION(this << item);
+    return item->GetFiveTuple() != nullptr;
+}
+
+int32_t
+RuleTablePacketFilter::DoClassify(Ptr<QueueDiscItem> item) const
+{
+    NS_LOG_FUNCTION(this << item);
+
+    const QueueDiscItem::FiveTuple* tuple = item->GetFiveTuple();
+    NS_ASSERT(tuple);
+
+    uint32_t best = std::numeric_limits<uint32_t>::max();
+    int32_t cls = PF_NO_MATCH;
+
+    for (const auto& group : m_groups)
+    {
+        if (group.first >= best)
+        {
+            // neither this group nor the next ones have a rule added before the match
+            break;
+        }
+        auto it = group.rules.find(Apply(*tuple, group.mask));
+        if (it != group.rules.end() && it->second.index < best)
+        {
+            best = it->second.index;
+            cls = it->second.cls;
+        }
+    }
+
+    NS_LOG_DEBUG("Class " << cls);
+    return cls;
+}
+
+} // namespace ns3
@@ -0,0 +1,197 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RULE_TABLE_PACKET_FILTER_H
+#define RULE_TABLE_PACKET_FILTER_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/packet-filter.h"
+#include "ns3/queue-item.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ * \ingroup traffic-control
+ *
+ * \brief Packet filter classifying IPv4 and IPv6 packets through a table of
+ *        5-tuple rules.
+ *
+ * Each rule matches a source prefix, a destination prefix and, optionally, a
+ * transport protocol, a source port and a destination port, and gives its
+ * class to the packets it matches. When several rules match a packet, the
+ * rule added first wins, just as with a chain of filters each matching one
+ * rule, which queue discs try in the order they were added.
+ *
+ * Instead of trying the rules in turn, the rules sharing the same prefix
+ * lengths and wildcards are stored in a hash table indexed by their masked
+ * 5-tuple (tuple space search): a packet is looked up once per such group
+ * of rules, and the groups whose first rule comes after a matching rule are
+ * skipped. The 5-tuple of the packet is taken from QueueDiscItem::GetFiveTuple,
+ * hence the headers are parsed once however many filters classify the packet.
+ */
+class RuleTablePacketFilter : public PacketFilter
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    RuleTablePacketFilter();
+    ~RuleTablePacketFilter() override;
+
+    /// Value of the protocol and port arguments of AddRule that matches any value
+    static constexpr int32_t ANY = -1;
+
+    /**
+     * \brief Add a rule matching IPv4 packets
+     * \param source the source address
+     * \param sourceMask the mask applied to the source address
+     * \param destination the destination address
+     * \param destinationMask the mask applied to the destination address
+     * \param protocol the transport protocol number, or ANY
+     * \param sourcePort the source port, or ANY
+     * \param destinationPort the destination port, or ANY
+     * \param cls the (non-negative) class of the packets matching the rule
+     */
+    void AddRule(Ipv4Address source,
+                 Ipv4Mask sourceMask,
+                 Ipv4Address destination,
+                 Ipv4Mask destinationMask,
+                 int32_t protocol,
+                 int32_t sourcePort,
+                 int32_t destinationPort,
+                 int32_t cls);
+
+    /**
+     * \brief Add a rule matching IPv6 packets
+     * \param source the source address
+     * \param sourcePrefix the prefix applied to the source address
+     * \param destination the destination address
+     * \param destinationPrefix the prefix applied to the destination address
+     * \param protocol the transport protocol number, or ANY
+     * \param sourcePort the source port, or ANY
+     * \param destinationPort the destination port, or ANY
+     * \param cls the (non-negative) class of the packets matching the rule
+     */
+    void AddRule(Ipv6Address source,
+                 Ipv6Prefix sourcePrefix,
+                 Ipv6Address destination,
+                 Ipv6Prefix destinationPrefix,
+                 int32_t protocol,
+                 int32_t sourcePort,
+                 int32_t destinationPort,
+                 int32_t cls);
+
+    /**
+     * \brief Get the number of rules
+     * \return the number of rules
+     */
+    uint32_t GetNRules() const;
+
+    /**
+     * \brief Get the number of groups of rules sharing their prefix lengths and wildcards
+     * \return the number of hash tables looked up to classify a packet, at most
+     */
+    uint32_t GetNRuleGroups() const;
+
+  private:
+    bool CheckProtocol(Ptr<QueueDiscItem> item) const override;
+    int32_t DoClassify(Ptr<QueueDiscItem> item) const override;
+
+    /// The masked 5-tuple of a packet or of a rule
+    using Key = QueueDiscItem::FiveTuple;
+
+    /// Equality of keys
+    struct KeyEqual
+    {
+        /**
+         * \param a the first key
+         * \param b the second key
+         * \return true if the keys are equal
+         */
+        bool operator()(const Key& a, const Key& b) const;
+    };
+
+    /// Hash of keys
+    struct KeyHash
+    {
+        /**
+         * \param key the key
+         * \return the hash of the key
+         */
+        std::size_t operator()(const Key& key) const;
+    };
+
+    /// Index and class of a rule
+    struct Rule
+    {
+        uint32_t index; //!< Index of the rule, in the order the rules were added
+        int32_t cls;    //!< Class of the packets matching the rule
+    };
+
+    /// The rules sharing their prefix lengths and wildcards
+    struct RuleGroup
+    {
+        Key mask;       //!< Mask applied to the 5-tuple of the packets
+        uint32_t first; //!< Index of the first rule of the group
+        /// The first rule added for each masked 5-tuple
+        std::unordered_map<Key, Rule, KeyHash, KeyEqual> rules;
+    };
+
+    /**
+     * \brief Add a rule
+     * \param key the 5-tuple of the rule, not masked yet
+     * \param mask the mask of the rule
+     * \param cls the class of the packets matching the rule
+     */
+    void DoAddRule(Key key, const Key& mask, int32_t cls);
+
+    /**
+     * \brief Fill the protocol and ports of the 5-tuple and of the mask of a rule
+     * \param key the 5-tuple of the rule
+     * \param mask the mask of the rule
+     * \param protocol the transport protocol number, or ANY
+     * \param sourcePort the source port, or ANY
+     * \param destinationPort the destination port, or ANY
+     */
+    static void SetTransport(Key& key,
+                             Key& mask,
+                             int32_t protocol,
+                             int32_t sourcePort,
+                             int32_t destinationPort);
+
+    /**
+     * \brief Mask a 5-tuple
+     * \param tuple the 5-tuple
+     * \param mask the mask
+     * \return the masked 5-tuple
+     */
+    static Key Apply(const Key& tuple, const Key& mask);
+
+    std::vector<RuleGroup> m_groups; //!< Groups of rules, by index of their first rule
+    uint32_t m_nRules;               //!< Number of rules
+};
+
+} // namespace ns3
+
+#endif /* RULE_TABLE_PACKET_FILTER_H */
@@ -0,0 +1,110 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SHARED_NEIGHBOR_TABLE_H
+#define SHARED_NEIGHBOR_TABLE_H
+
+#include "ns3/address.h"
+#include "ns3/flat-hash-map.h"
+#include "ns3/simple-ref-count.h"
+
+#include <stdint.h>
+
+namespace ns3
+{
+
+/**
+ * \ingroup internet
+ *
+ * \brief A table of the MAC addresses of the interfaces attached to a channel.
+ *
+ * The neighbor caches (ArpCache, NdiscCache) of all the interfaces attached
+ * to a channel can share one such table, populated once by
+ * NeighborCacheHelper, instead of holding one entry per neighbor each: the
+ * entries of the table behave as the auto-generated entries of the caches,
+ * and the addresses missing from it are resolved by ARP or NDISC as usual.
+ *
+ * \tparam T the network address type (Ipv4Address or Ipv6Address)
+ */
+template <typename T>
+class SharedNeighborTable : public SimpleRefCount<SharedNeighborTable<T>>
+{
+  public:
+    /// Container of the entries
+    typedef FlatHashMap<T, Address> Table;
+
+    /**
+     * \brief Add an entry, replacing any entry of the same network address.
+     * \param address the network address
+     * \param macAddress the MAC address of the interface holding it
+     */
+    void Add(const T& address, const Address& macAddress)
+    {
+        m_table[address] = macAddress;
+    }
+
+    /**
+     * \brief Remove the entry of a network address, if any.
+     * \param address the network address
+     */
+    void Remove(const T& address)
+    {
+        m_table.erase(address);
+    }
+
+    /**
+     * \brief Look up the MAC address of a network address.
+     * \param address the network address
+     * \return the MAC address, or nullptr if the address is not in the table
+     */
+    const Address* Lookup(const T& address) const
+    {
+        auto it = m_table.find(address);
+        return it != m_table.end() ? &it->second : nullptr;
+    }
+
+    /**
+     * \brief Reserve room for a number of entries.
+     * \param count the number of entries
+     */
+    void Reserve(uint32_t count)
+    {
+        m_table.reserve(count);
+    }
+
+    /// \return the number of entries
+    uint32_t GetSize() const
+    {
+        return m_table.size();
+    }
+
+    /// \return a const iterator to the first entry
+    typename Table::const_iterator Begin() const
+    {
+        return m_table.begin();
+    }
+
+    /// \return a const iterator past the last entry
+    typename Table::const_iterator End() const
+    {
+        return m_table.end();
+    }
+
+  private:
+    Table m_table; //!< MAC address of each network address
+};
+
+} // namespace ns3
+
+#endif /* SHARED_NEIGHBOR_TABLE_H */
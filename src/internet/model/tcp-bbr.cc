@@ -256,13 +256,19 @@ TcpBbr::InFlight(Ptr<TcpSocketState> tcb, double gain)
         return tcb->m_initialCWnd * tcb->m_segmentSize;
     }
     double quanta = 3 * m_sendQuantum;
-    double estimatedBdp = m_maxBwFilter.GetBest() * m_minRtt / 8.0;
+    // InFlight is called several times per ACK, while the estimates seldom change
+    if (m_maxBwFilter.GetBest() != m_bdpBandwidth || m_minRtt != m_bdpMinRtt)
+    {
+        m_bdpBandwidth = m_maxBwFilter.GetBest();
+        m_bdpMinRtt = m_minRtt;
+        m_estimatedBdp = m_bdpBandwidth * m_bdpMinRtt / 8.0;
+    }
 
     if (m_state == BbrMode_t::BBR_PROBE_BW && m_cycleIndex == 0)
     {
-        return (gain * estimatedBdp) + quanta + (2 * tcb->m_segmentSize);
+        return (gain * m_estimatedBdp) + quanta + (2 * tcb->m_segmentSize);
     }
-    return (gain * estimatedBdp) + quanta;
+    return (gain * m_estimatedBdp) + quanta;
 }
 
 void
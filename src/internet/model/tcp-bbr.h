@@ -402,6 +402,9 @@ class TcpBbr : public TcpCongestionOps
     bool m_hasSeenRtt{false};        //!< Have we seen RTT sample yet?
     double m_pacingMargin{0.01}; //!< BBR intentionally reduces the pacing rate by 1% to drain any
                                  //!< standing queues. See `bbr_rate_bytes_per_sec` in Linux.
+    DataRate m_bdpBandwidth{0};    //!< Maximum bandwidth m_estimatedBdp was computed for
+    Time m_bdpMinRtt{Time::Max()}; //!< Minimum RTT m_estimatedBdp was computed for
+    double m_estimatedBdp{0};      //!< Estimated BDP (bytes), cached by InFlight
 };
 
 } // namespace ns3
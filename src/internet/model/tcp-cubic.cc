@@ -131,7 +131,9 @@ TcpCubic::TcpCubic()
       m_lastAck(Time::Min()),
       m_cubicDelta(Time::Min()),
       m_currRtt(Time::Min()),
-      m_sampleCnt(0)
+      m_sampleCnt(0),
+      m_friendlinessBeta(-1.0),
+      m_friendlinessScale(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -162,7 +164,9 @@ TcpCubic::TcpCubic(const TcpCubic& sock)
       m_lastAck(sock.m_lastAck),
       m_cubicDelta(sock.m_cubicDelta),
       m_currRtt(sock.m_currRtt),
-      m_sampleCnt(sock.m_sampleCnt)
+      m_sampleCnt(sock.m_sampleCnt),
+      m_friendlinessBeta(sock.m_friendlinessBeta),
+      m_friendlinessScale(sock.m_friendlinessScale)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -278,25 +282,26 @@ TcpCubic::Update(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
     }
 
     t = Simulator::Now() + m_delayMin - m_epochStart;
+    double tSeconds = t.GetSeconds();
 
-    if (t.GetSeconds() < m_bicK) /* t - K */
+    if (tSeconds < m_bicK) /* t - K */
     {
-        offs = m_bicK - t.GetSeconds();
-        NS_LOG_DEBUG("t=" << t.GetSeconds() << " <k: offs=" << offs);
+        offs = m_bicK - tSeconds;
+        NS_LOG_DEBUG("t=" << tSeconds << " <k: offs=" << offs);
     }
     else
     {
-        offs = t.GetSeconds() - m_bicK;
-        NS_LOG_DEBUG("t=" << t.GetSeconds() << " >= k: offs=" << offs);
+        offs = tSeconds - m_bicK;
+        NS_LOG_DEBUG("t=" << tSeconds << " >= k: offs=" << offs);
     }
 
     /* Constant value taken from Experimental Evaluation of Cubic Tcp, available at
      * eprints.nuim.ie/1716/1/Hamiltonpfldnet2007_cubic_final.pdf */
-    delta = m_c * std::pow(offs, 3);
+    delta = m_c * (offs * offs * offs);
 
     NS_LOG_DEBUG("delta: " << delta);
 
-    if (t.GetSeconds() < m_bicK)
+    if (tSeconds < m_bicK)
     {
         // below origin
         bicTarget = m_bicOriginPoint - delta;
@@ -330,8 +335,14 @@ TcpCubic::Update(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
 
     if (m_tcpFriendliness)
     {
-        auto scale = static_cast<uint32_t>(8 * (1024 + m_beta * 1024) / 3 / (1024 - m_beta * 1024));
-        delta = (segCwnd * scale) >> 3;
+        if (m_beta != m_friendlinessBeta)
+        {
+            // the scale only depends on beta, hence it is computed when beta changes
+            m_friendlinessBeta = m_beta;
+            m_friendlinessScale =
+                static_cast<uint32_t>(8 * (1024 + m_beta * 1024) / 3 / (1024 - m_beta * 1024));
+        }
+        delta = (segCwnd * m_friendlinessScale) >> 3;
         while (m_ackCnt > delta)
         {
             m_ackCnt -= delta;
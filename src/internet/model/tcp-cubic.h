@@ -138,6 +138,9 @@ class TcpCubic : public TcpCongestionOps
     uint32_t m_ackCnt;         //!<  Count the number of ACKed packets
     uint32_t m_tcpCwnd;        //!<  Estimated tcp cwnd (for Reno-friendliness)
 
+    double m_friendlinessBeta;    //!< Beta the Reno-friendliness scale was computed for
+    uint32_t m_friendlinessScale; //!< Reno-friendliness scale (8 times the cwnd ratio per ACK)
+
   private:
     /**
      * \brief Reset HyStart parameters
@@ -21,10 +21,13 @@
 
 #include "tcp-option.h"
 
+#include "ns3/abort.h"
 #include "ns3/address-utils.h"
 #include "ns3/buffer.h"
 #include "ns3/log.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <stdint.h>
 
@@ -267,7 +270,8 @@ TcpHeader::Print(std::ostream& os) const
 
     os << " Seq=" << m_sequenceNumber << " Ack=" << m_ackNumber << " Win=" << m_windowSize;
 
-    for (auto op = m_options.begin(); op != m_options.end(); ++op)
+    const TcpOptionList& options = GetOptionList();
+    for (auto op = options.begin(); op != options.end(); ++op)
     {
         os << " " << (*op)->GetInstanceTypeId().GetName() << "(";
         (*op)->Print(os);
@@ -297,14 +301,8 @@ TcpHeader::Serialize(Buffer::Iterator start) const
     // Serialize options if they exist
     // This implementation does not presently try to align options on word
     // boundaries using NOP options
-    uint32_t optionLen = 0;
-
-    for (auto op = m_options.begin(); op != m_options.end(); ++op)
-    {
-        optionLen += (*op)->GetSerializedSize();
-        (*op)->Serialize(i);
-        i.Next((*op)->GetSerializedSize());
-    }
+    uint32_t optionLen = m_optionsDataLen;
+    i.Write(m_optionsData, m_optionsDataLen);
 
     // padding to word alignment; add ENDs and/or pad values (they are the same)
     while (optionLen % 4)
@@ -343,56 +341,87 @@ TcpHeader::Deserialize(Buffer::Iterator start)
     m_urgentPointer = i.ReadNtohU16();
 
     // Deserialize options if they exist
+    m_optionsDataLen = 0;
     m_options.clear();
+    m_optionsListed = true;
     uint32_t optionLen = (m_length - 5) * 4;
     if (optionLen > m_maxOptionsLen)
     {
         NS_LOG_ERROR("Illegal TCP option length " << optionLen << "; options discarded");
         return 20;
     }
-    while (optionLen)
+    uint8_t data[m_maxOptionsLen];
+    i.Read(data, optionLen);
+    uint32_t offset = 0;
+    while (offset < optionLen)
     {
-        uint8_t kind = i.PeekU8();
-        Ptr<TcpOption> op;
+        // check each option as its TcpOption::Deserialize does
+        uint8_t kind = data[offset];
+        uint32_t left = optionLen - offset;
         uint32_t optionSize;
-        if (TcpOption::IsKindKnown(kind))
+        if (kind == TcpOption::END || kind == TcpOption::NOP)
         {
-            op = TcpOption::CreateOption(kind);
+            optionSize = 1;
+        }
+        else if (left < 2)
+        {
+            NS_LOG_ERROR("Option exceeds TCP option space; option discarded");
+            break;
         }
         else
         {
-            op = TcpOption::CreateOption(TcpOption::UNKNOWN);
-            NS_LOG_WARN("Option kind " << static_cast<int>(kind) << " unknown, skipping.");
+            uint8_t size = data[offset + 1];
+            switch (kind)
+            {
+            case TcpOption::MSS:
+                NS_ABORT_IF(size != 4);
+                optionSize = 4;
+                break;
+            case TcpOption::WINSCALE:
+                optionSize = (size == 3) ? 3 : 0;
+                break;
+            case TcpOption::SACKPERMITTED:
+                optionSize = (size == 2) ? 2 : 0;
+                break;
+            case TcpOption::SACK:
+                // the blocks beyond the last full one are ignored
+                optionSize = 2 + (size < 2 ? 0 : (size - 2) / 8 * 8);
+                break;
+            case TcpOption::TS:
+                optionSize = (size == 10) ? 10 : 0;
+                break;
+            default:
+                NS_LOG_WARN("Option kind " << static_cast<int>(kind) << " unknown, skipping.");
+                optionSize = (size < 2 || size > m_maxOptionsLen) ? 0 : size;
+                break;
+            }
         }
-        optionSize = op->Deserialize(i);
-        if (optionSize != op->GetSerializedSize())
+        if (optionSize == 0)
         {
             NS_LOG_ERROR("Option did not deserialize correctly");
             break;
         }
-        if (optionLen >= optionSize)
-        {
-            optionLen -= optionSize;
-            i.Next(optionSize);
-            m_options.emplace_back(op);
-            m_optionsLen += optionSize;
-        }
-        else
+        if (left < optionSize)
         {
             NS_LOG_ERROR("Option exceeds TCP option space; option discarded");
             break;
         }
-        if (op->GetKind() == TcpOption::END)
+        std::memcpy(m_optionsData + m_optionsDataLen, data + offset, optionSize);
+        if (kind == TcpOption::SACK)
         {
-            while (optionLen)
-            {
-                // Discard padding bytes without adding to option list
-                i.Next(1);
-                --optionLen;
-                ++m_optionsLen;
-            }
+            m_optionsData[m_optionsDataLen + 1] = optionSize;
+        }
+        m_optionsDataLen += optionSize;
+        m_optionsLen += optionSize;
+        offset += optionSize;
+        if (kind == TcpOption::END)
+        {
+            // Discard padding bytes without adding them to the options
+            m_optionsLen += optionLen - offset;
+            break;
         }
     }
+    m_optionsListed = (m_optionsDataLen == 0);
 
     if (m_length != CalculateHeaderLength())
     {
@@ -414,12 +443,8 @@ TcpHeader::Deserialize(Buffer::Iterator start)
 uint8_t
 TcpHeader::CalculateHeaderLength() const
 {
-    uint32_t len = 20;
+    uint32_t len = 20 + m_optionsDataLen;
 
-    for (auto i = m_options.begin(); i != m_options.end(); ++i)
-    {
-        len += (*i)->GetSerializedSize();
-    }
     // Option list may not include padding; need to pad up to word boundary
     if (len % 4)
     {
@@ -441,11 +466,11 @@ TcpHeader::AppendOption(Ptr<const TcpOption> option)
 
         if (option->GetKind() != TcpOption::END)
         {
-            m_options.push_back(option);
-            m_optionsLen += option->GetSerializedSize();
-
-            uint32_t totalLen = 20 + 3 + m_optionsLen;
-            m_length = totalLen >> 2;
+            uint32_t size = option->GetSerializedSize();
+            Buffer buffer;
+            buffer.AddAtStart(size);
+            option->Serialize(buffer.Begin());
+            buffer.CopyData(ReserveOption(size), size);
         }
 
         return true;
@@ -454,16 +479,174 @@ TcpHeader::AppendOption(Ptr<const TcpOption> option)
     return false;
 }
 
+bool
+TcpHeader::AppendTimestampOption(uint32_t timestamp, uint32_t echo)
+{
+    uint8_t* data = ReserveOption(10);
+    if (data == nullptr)
+    {
+        return false;
+    }
+    data[0] = TcpOption::TS;
+    data[1] = 10;
+    for (uint8_t j = 0; j < 4; j++)
+    {
+        data[2 + j] = timestamp >> (24 - 8 * j);
+        data[6 + j] = echo >> (24 - 8 * j);
+    }
+    return true;
+}
+
+bool
+TcpHeader::GetTimestampOption(uint32_t& timestamp, uint32_t& echo) const
+{
+    const uint8_t* data = FindOption(TcpOption::TS);
+    if (data == nullptr)
+    {
+        return false;
+    }
+    timestamp = 0;
+    echo = 0;
+    for (uint8_t j = 0; j < 4; j++)
+    {
+        timestamp = (timestamp << 8) | data[2 + j];
+        echo = (echo << 8) | data[6 + j];
+    }
+    return true;
+}
+
+bool
+TcpHeader::AppendWinScaleOption(uint8_t scale)
+{
+    uint8_t* data = ReserveOption(3);
+    if (data == nullptr)
+    {
+        return false;
+    }
+    data[0] = TcpOption::WINSCALE;
+    data[1] = 3;
+    data[2] = scale;
+    return true;
+}
+
+bool
+TcpHeader::GetWinScaleOption(uint8_t& scale) const
+{
+    const uint8_t* data = FindOption(TcpOption::WINSCALE);
+    if (data == nullptr)
+    {
+        return false;
+    }
+    scale = data[2];
+    return true;
+}
+
+bool
+TcpHeader::AppendSackPermittedOption()
+{
+    uint8_t* data = ReserveOption(2);
+    if (data == nullptr)
+    {
+        return false;
+    }
+    data[0] = TcpOption::SACKPERMITTED;
+    data[1] = 2;
+    return true;
+}
+
+uint32_t
+TcpHeader::AppendSackOption(const TcpOptionSack::SackList& list)
+{
+    if (m_optionsLen + 2 > m_maxOptionsLen)
+    {
+        return 0;
+    }
+    auto nBlocks = static_cast<uint32_t>(
+        std::min<std::size_t>(list.size(), (m_maxOptionsLen - m_optionsLen - 2) / 8));
+    if (nBlocks == 0)
+    {
+        return 0;
+    }
+    uint8_t* data = ReserveOption(2 + 8 * nBlocks);
+    data[0] = TcpOption::SACK;
+    data[1] = 2 + 8 * nBlocks;
+    data += 2;
+    auto block = list.begin();
+    for (uint32_t n = 0; n < nBlocks; n++, block++)
+    {
+        uint32_t left = block->first.GetValue();
+        uint32_t right = block->second.GetValue();
+        for (uint8_t j = 0; j < 4; j++)
+        {
+            data[j] = left >> (24 - 8 * j);
+            data[4 + j] = right >> (24 - 8 * j);
+        }
+        data += 8;
+    }
+    return nBlocks;
+}
+
+bool
+TcpHeader::GetSackOption(TcpOptionSack::SackList& list) const
+{
+    const uint8_t* data = FindOption(TcpOption::SACK);
+    if (data == nullptr)
+    {
+        return false;
+    }
+    list.resize((data[1] - 2) / 8);
+    data += 2;
+    for (auto& block : list)
+    {
+        uint32_t left = 0;
+        uint32_t right = 0;
+        for (uint8_t j = 0; j < 4; j++)
+        {
+            left = (left << 8) | data[j];
+            right = (right << 8) | data[4 + j];
+        }
+        block = TcpOptionSack::SackBlock(SequenceNumber32(left), SequenceNumber32(right));
+        data += 8;
+    }
+    return true;
+}
+
 const TcpHeader::TcpOptionList&
 TcpHeader::GetOptionList() const
 {
+    if (!m_optionsListed)
+    {
+        m_options.clear();
+        Buffer buffer;
+        buffer.AddAtStart(m_optionsDataLen);
+        buffer.Begin().Write(m_optionsData, m_optionsDataLen);
+        Buffer::Iterator i = buffer.Begin();
+        uint32_t offset = 0;
+        while (offset < m_optionsDataLen)
+        {
+            uint8_t kind = m_optionsData[offset];
+            Ptr<TcpOption> op =
+                TcpOption::CreateOption(TcpOption::IsKindKnown(kind) ? kind : TcpOption::UNKNOWN);
+            uint32_t size = op->Deserialize(i);
+            i.Next(size);
+            offset += size;
+            m_options.emplace_back(op);
+        }
+        m_optionsListed = true;
+    }
     return m_options;
 }
 
 Ptr<const TcpOption>
 TcpHeader::GetOption(uint8_t kind) const
 {
-    for (auto i = m_options.begin(); i != m_options.end(); ++i)
+    if (FindOption(kind) == nullptr)
+    {
+        return nullptr;
+    }
+
+    const TcpOptionList& options = GetOptionList();
+    for (auto i = options.begin(); i != options.end(); ++i)
     {
         if ((*i)->GetKind() == kind)
         {
@@ -477,15 +660,40 @@ TcpHeader::GetOption(uint8_t kind) const
 bool
 TcpHeader::HasOption(uint8_t kind) const
 {
-    for (auto i = m_options.begin(); i != m_options.end(); ++i)
+    return FindOption(kind) != nullptr;
+}
+
+const uint8_t*
+TcpHeader::FindOption(uint8_t kind) const
+{
+    uint32_t offset = 0;
+    while (offset < m_optionsDataLen)
     {
-        if ((*i)->GetKind() == kind)
+        const uint8_t* data = m_optionsData + offset;
+        if (data[0] == kind)
         {
-            return true;
+            return data;
         }
+        // the options were checked when stored, hence their size is valid
+        offset += (data[0] == TcpOption::END || data[0] == TcpOption::NOP) ? 1 : data[1];
     }
+    return nullptr;
+}
 
-    return false;
+uint8_t*
+TcpHeader::ReserveOption(uint8_t size)
+{
+    if (m_optionsLen + size > m_maxOptionsLen)
+    {
+        return nullptr;
+    }
+    uint8_t* data = m_optionsData + m_optionsDataLen;
+    m_optionsDataLen += size;
+    m_optionsLen += size;
+    m_length = (20 + 3 + m_optionsLen) >> 2;
+    m_options.clear();
+    m_optionsListed = false;
+    return data;
 }
 
 bool
@@ -20,6 +20,7 @@
 #ifndef TCP_HEADER_H
 #define TCP_HEADER_H
 
+#include "tcp-option-sack.h"
 #include "tcp-option.h"
 #include "tcp-socket-factory.h"
 
@@ -41,6 +42,12 @@ namespace ns3
  * This class has fields corresponding to those in a network TCP header
  * (port numbers, sequence and acknowledgement numbers, flags, etc) as well
  * as methods for serialization to and deserialization from a byte buffer.
+ *
+ * The options are stored inline, in their serialized form. The timestamp,
+ * window scale, SACK-permitted and SACK options can be appended and read
+ * through typed methods (e.g., AppendTimestampOption and GetTimestampOption),
+ * which do not allocate any TcpOption; the TcpOption objects returned by
+ * GetOption and GetOptionList are only created when these methods are called.
  */
 
 class TcpHeader : public Header
@@ -218,6 +225,64 @@ class TcpHeader : public Header
      */
     bool AppendOption(Ptr<const TcpOption> option);
 
+    /**
+     * \brief Append a timestamp option (TcpOptionTS) to the TCP header
+     * \param timestamp the timestamp value
+     * \param echo the timestamp echo reply
+     * \return true if the option has been appended, false otherwise
+     */
+    bool AppendTimestampOption(uint32_t timestamp, uint32_t echo);
+
+    /**
+     * \brief Get the values of the timestamp option (TcpOptionTS)
+     * \param [out] timestamp the timestamp value
+     * \param [out] echo the timestamp echo reply
+     * \return true if the header has a timestamp option, false otherwise
+     */
+    bool GetTimestampOption(uint32_t& timestamp, uint32_t& echo) const;
+
+    /**
+     * \brief Append a window scale option (TcpOptionWinScale) to the TCP header
+     * \param scale the window scale
+     * \return true if the option has been appended, false otherwise
+     */
+    bool AppendWinScaleOption(uint8_t scale);
+
+    /**
+     * \brief Get the value of the window scale option (TcpOptionWinScale)
+     * \param [out] scale the window scale
+     * \return true if the header has a window scale option, false otherwise
+     */
+    bool GetWinScaleOption(uint8_t& scale) const;
+
+    /**
+     * \brief Append a SACK-permitted option (TcpOptionSackPermitted) to the TCP header
+     * \return true if the option has been appended, false otherwise
+     */
+    bool AppendSackPermittedOption();
+
+    /**
+     * \brief Append a SACK option (TcpOptionSack) to the TCP header
+     *
+     * The option holds the first blocks of the list, as many as fit in the
+     * option space left.
+     *
+     * \param list the SACK blocks
+     * \return the number of blocks appended (0 if no option has been appended)
+     */
+    uint32_t AppendSackOption(const TcpOptionSack::SackList& list);
+
+    /**
+     * \brief Get the blocks of the SACK option (TcpOptionSack)
+     *
+     * The elements of the list are overwritten, hence a list reused across
+     * calls is only reallocated when its number of blocks changes.
+     *
+     * \param [out] list the SACK blocks
+     * \return true if the header has a SACK option, false otherwise
+     */
+    bool GetSackOption(TcpOptionSack::SackList& list) const;
+
     /**
      * \brief Initialize the TCP checksum.
      *
@@ -329,6 +394,20 @@ class TcpHeader : public Header
      */
     uint8_t CalculateHeaderLength() const;
 
+    /**
+     * \brief Find an option in the serialized options
+     * \param kind the kind of the option
+     * \return a pointer to the first byte of the option, or nullptr if there is none
+     */
+    const uint8_t* FindOption(uint8_t kind) const;
+
+    /**
+     * \brief Reserve space at the end of the serialized options for an option
+     * \param size the size of the option
+     * \return a pointer to the space reserved, or nullptr if the option does not fit
+     */
+    uint8_t* ReserveOption(uint8_t size);
+
     uint16_t m_sourcePort{0};             //!< Source port
     uint16_t m_destinationPort{0};        //!< Destination port
     SequenceNumber32 m_sequenceNumber{0}; //!< Sequence number
@@ -346,8 +425,11 @@ class TcpHeader : public Header
     bool m_goodChecksum{true};  //!< Flag to indicate that checksum is correct
 
     static const uint8_t m_maxOptionsLen = 40; //!< Maximum options length
-    TcpOptionList m_options;                   //!< TcpOption present in the header
+    uint8_t m_optionsData[m_maxOptionsLen]{};  //!< Options present in the header, serialized
+    uint8_t m_optionsDataLen{0};               //!< Length of m_optionsData (padding excluded)
     uint8_t m_optionsLen{0};                   //!< Tcp options length.
+    mutable TcpOptionList m_options;           //!< TcpOption objects, created on demand
+    mutable bool m_optionsListed{true};        //!< Whether m_options matches m_optionsData
 };
 
 } // namespace ns3
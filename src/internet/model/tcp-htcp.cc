@@ -76,7 +76,8 @@ TcpHtcp::TcpHtcp()
       m_maxRtt(Time::Min()),
       m_throughput(0),
       m_lastThroughput(0),
-      m_dataSent(0)
+      m_dataSent(0),
+      m_lastAck(Time::Min())
 {
     NS_LOG_FUNCTION(this);
 }
@@ -94,7 +95,8 @@ TcpHtcp::TcpHtcp(const TcpHtcp& sock)
       m_maxRtt(sock.m_maxRtt),
       m_throughput(sock.m_throughput),
       m_lastThroughput(sock.m_lastThroughput),
-      m_dataSent(sock.m_dataSent)
+      m_dataSent(sock.m_dataSent),
+      m_lastAck(sock.m_lastAck)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -176,6 +178,13 @@ TcpHtcp::GetSsThresh(Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight)
 {
     NS_LOG_FUNCTION(this << tcb << bytesInFlight);
 
+    // the throughput is only needed here, hence it is computed as of the last ACK
+    // rather than on every ACK
+    if (m_lastAck != Time::Min())
+    {
+        m_throughput =
+            static_cast<uint32_t>(m_dataSent / (m_lastAck.GetSeconds() - m_lastCon.GetSeconds()));
+    }
     m_lastCon = Simulator::Now();
 
     UpdateBeta();
@@ -189,6 +198,7 @@ TcpHtcp::GetSsThresh(Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight)
     m_lastThroughput = m_throughput;
     m_throughput = 0;
     m_dataSent = 0;
+    m_lastAck = Time::Min();
     NS_LOG_DEBUG(this << " ssThresh: " << ssThresh << " m_beta: " << m_beta);
     return ssThresh;
 }
@@ -203,8 +213,7 @@ TcpHtcp::PktsAcked(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked, const Time&
         m_dataSent += segmentsAcked * tcb->m_segmentSize;
     }
 
-    m_throughput = static_cast<uint32_t>(m_dataSent /
-                                         (Simulator::Now().GetSeconds() - m_lastCon.GetSeconds()));
+    m_lastAck = Simulator::Now();
 
     UpdateAlpha();
     if (rtt < m_minRtt)
@@ -98,6 +98,7 @@ class TcpHtcp : public TcpNewReno
     uint32_t m_throughput; //!< Current throughput since last congestion
     uint32_t m_lastThroughput; //!< Throughput in last congestion period
     uint32_t m_dataSent;       //!< Current amount of data sent since last congestion
+    Time m_lastAck; //!< Time of the last ACK since last congestion, or Time::Min() if none
 };
 
 } // namespace ns3
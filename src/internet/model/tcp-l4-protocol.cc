@@ -21,6 +21,7 @@
 
 #include "ipv4-end-point-demux.h"
 #include "ipv4-end-point.h"
+#include "ipv4-l3-protocol.h"
 #include "ipv4-route.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv6-end-point-demux.h"
@@ -617,9 +618,12 @@ TcpL4Protocol::SendPacketV4(Ptr<Packet> packet,
         header.SetProtocol(PROT_NUMBER);
         Socket::SocketErrno errno_;
         Ptr<Ipv4Route> route;
+        Ptr<Ipv4L3Protocol> ipv4L3 = DynamicCast<Ipv4L3Protocol>(ipv4);
         if (ipv4->GetRoutingProtocol())
         {
-            route = ipv4->GetRoutingProtocol()->RouteOutput(packet, header, oif, errno_);
+            // Ipv4L3Protocol caches the route when the routing protocol allows it
+            route = ipv4L3 ? ipv4L3->RouteOutput(packet, header, oif, errno_)
+                           : ipv4->GetRoutingProtocol()->RouteOutput(packet, header, oif, errno_);
         }
         else
         {
@@ -171,16 +171,20 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
             headSeq = tailSeq;
         }
     }
-    // Remove overlapped bytes from packet
-    auto i = m_data.begin();
+    // Remove overlapped bytes from packet, starting from the block before headSeq
+    auto i = m_data.upper_bound(headSeq);
+    if (i != m_data.begin())
+    {
+        --i;
+    }
     while (i != m_data.end() && i->first <= tailSeq)
     {
-        SequenceNumber32 lastByteSeq = i->first + SequenceNumber32(i->second->GetSize());
+        SequenceNumber32 lastByteSeq = i->second.m_end;
         if (lastByteSeq > headSeq)
         {
             if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-                m_size -= i->second->GetSize();
+            { // Rare case: Existing block is embedded fully in the new packet
+                m_size -= lastByteSeq - i->first;
                 m_data.erase(i++);
                 continue;
             }
@@ -208,31 +212,42 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
         p = p->CreateFragment(start, length);
         NS_ASSERT(length == p->GetSize());
     }
-    // Insert packet into buffer
-    NS_ASSERT(m_data.find(headSeq) == m_data.end()); // Shouldn't be there yet
-    m_data[headSeq] = p;
+    // Insert packet into buffer, appending it to the block ending at headSeq
+    auto next = m_data.lower_bound(headSeq);
+    NS_ASSERT(next == m_data.end() || next->first >= tailSeq); // Shouldn't be there yet
+    BufIterator block;
+    if (next != m_data.begin() && std::prev(next)->second.m_end == headSeq)
+    {
+        block = std::prev(next);
+        block->second.m_packets.push_back(p);
+        block->second.m_end = tailSeq;
+    }
+    else
+    {
+        block = m_data.emplace_hint(next, headSeq, DataBlock{tailSeq, {p}});
+    }
+    // and merging the block starting at tailSeq
+    if (next != m_data.end() && next->first == tailSeq)
+    {
+        block->second.m_packets.splice(block->second.m_packets.end(), next->second.m_packets);
+        block->second.m_end = next->second.m_end;
+        m_data.erase(next);
+    }
 
     if (headSeq > m_nextRxSeq)
     {
         // Generate a new SACK block
-        UpdateSackList(headSeq, tailSeq);
+        UpdateSackList(block->first, block->second.m_end);
     }
 
     NS_LOG_LOGIC("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize());
     // Update variables
     m_size += p->GetSize(); // Occupancy
-    for (i = m_data.begin(); i != m_data.end(); ++i)
+    if (block->first <= m_nextRxSeq)
     {
-        if (i->first < m_nextRxSeq)
-        {
-            continue;
-        }
-        else if (i->first > m_nextRxSeq)
-        {
-            break;
-        };
-        m_nextRxSeq = i->first + SequenceNumber32(i->second->GetSize());
-        m_availBytes += i->second->GetSize();
+        // The block holding the packet ends with the in-sequence data
+        m_availBytes += block->second.m_end - m_nextRxSeq;
+        m_nextRxSeq = block->second.m_end;
         ClearSackList(m_nextRxSeq);
     }
     NS_LOG_LOGIC("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
@@ -287,65 +302,19 @@ TcpRxBuffer::UpdateSackList(const SequenceNumber32& head, const SequenceNumber32
     //     following SACK blocks in the SACK option may be listed in
     //     arbitrary order.
 
+    // The block "current" holds all the data contiguous to the segment, so
+    // the blocks it includes are not distinct anymore
+    m_sackList.remove_if([&current](const TcpOptionSack::SackBlock& block) {
+        return current.first <= block.first && block.second <= current.second;
+    });
     m_sackList.push_front(current);
 
-    // We have inserted the block at the beginning of the list. Now, we should
-    // check if any existing blocks overlap with that.
-    bool updated = false;
-    auto it = m_sackList.begin();
-    TcpOptionSack::SackBlock begin = *it;
-    TcpOptionSack::SackBlock merged;
-    ++it;
-
-    // Iterates until we examined all blocks in the list (maximum 4)
-    while (it != m_sackList.end())
-    {
-        current = *it;
-
-        // This is a left merge:
-        // [current_first; current_second] [beg_first; beg_second]
-        if (begin.first == current.second)
-        {
-            NS_ASSERT(current.first < begin.second);
-            merged = TcpOptionSack::SackBlock(current.first, begin.second);
-            updated = true;
-        }
-        // while this is a right merge
-        // [begin_first; begin_second] [current_first; current_second]
-        else if (begin.second == current.first)
-        {
-            NS_ASSERT(begin.first < current.second);
-            merged = TcpOptionSack::SackBlock(begin.first, current.second);
-            updated = true;
-        }
-
-        // If we have merged the blocks (and the result is in merged) we should
-        // delete the current block (it), the first block, and insert the merged
-        // one at the beginning.
-        if (updated)
-        {
-            m_sackList.erase(it);
-            m_sackList.pop_front();
-            m_sackList.push_front(merged);
-            it = m_sackList.begin();
-            begin = *it;
-            updated = false;
-        }
-
-        ++it;
-    }
-
     // Since the maximum blocks that fits into a TCP header are 4, there's no
     // point on maintaining the others.
     if (m_sackList.size() > 4)
     {
         m_sackList.pop_back();
     }
-
-    // Please note that, if a block b is discarded and then a block contiguous
-    // to b is received, only that new block (without the b part) is reported.
-    // This is perfectly fine for the RFC point (a), given that we do not report any
-    // overlapping blocks shortly after.
 }
 
 void
@@ -369,7 +338,7 @@ TcpRxBuffer::ClearSackList(const SequenceNumber32& seq)
     }
 }
 
-TcpOptionSack::SackList
+const TcpOptionSack::SackList&
 TcpRxBuffer::GetSackList() const
 {
     return m_sackList;
@@ -387,41 +356,59 @@ TcpRxBuffer::Extract(uint32_t maxSize)
     {
         return nullptr; // No contiguous block to return
     }
-    NS_ASSERT(!m_data.empty());            // At least we have something to extract
-    Ptr<Packet> outPkt = Create<Packet>(); // The packet that contains all the data to return
-    BufIterator i;
-    while (extractSize)
+    NS_ASSERT(!m_data.empty()); // At least we have something to extract
+    auto i = m_data.begin();
+    NS_ASSERT(i->first <= m_nextRxSeq); // in-sequence data expected
+    DataBlock& block = i->second;
+    Ptr<Packet> outPkt; // The packet that contains all the data to return
+    uint32_t extracted = 0;
+    while (extracted < extractSize)
     { // Check the buffered data for delivery
-        i = m_data.begin();
-        NS_ASSERT(i->first <= m_nextRxSeq); // in-sequence data expected
+        NS_ASSERT(!block.m_packets.empty());
+        Ptr<Packet> piece = block.m_packets.front();
         // Check if we send the whole pkt or just a partial
-        uint32_t pktSize = i->second->GetSize();
-        if (pktSize <= extractSize)
+        uint32_t pktSize = piece->GetSize();
+        if (pktSize <= extractSize - extracted)
         { // Whole packet is extracted
-            outPkt->AddAtEnd(i->second);
-            m_data.erase(i);
-            m_size -= pktSize;
-            m_availBytes -= pktSize;
-            extractSize -= pktSize;
+            block.m_packets.pop_front();
         }
         else
         { // Partial is extracted and done
-            outPkt->AddAtEnd(i->second->CreateFragment(0, extractSize));
-            m_data[i->first + SequenceNumber32(extractSize)] =
-                i->second->CreateFragment(extractSize, pktSize - extractSize);
-            m_data.erase(i);
-            m_size -= extractSize;
-            m_availBytes -= extractSize;
-            extractSize = 0;
+            pktSize = extractSize - extracted;
+            block.m_packets.front() = piece->CreateFragment(pktSize, piece->GetSize() - pktSize);
+            piece = piece->CreateFragment(0, pktSize);
         }
+        // The first segment becomes the packet returned, without copying its
+        // data. The packet tags added by the lower layers are not returned
+        if (!outPkt)
+        {
+            outPkt = piece->Copy();
+            outPkt->RemoveAllPacketTags();
+        }
+        else
+        {
+            outPkt->AddAtEnd(piece);
+        }
+        extracted += pktSize;
     }
+    m_size -= extracted;
+    m_availBytes -= extracted;
+
+    // The block now starts after the data extracted
+    auto node = m_data.extract(i);
+    if (!node.mapped().m_packets.empty())
+    {
+        node.key() += extracted;
+        m_data.insert(m_data.begin(), std::move(node));
+    }
+
     if (outPkt->GetSize() == 0)
     {
         NS_LOG_LOGIC("Nothing extracted.");
         return nullptr;
     }
     NS_LOG_LOGIC("Extracted " << outPkt->GetSize() << " bytes, bufsize=" << m_size
-                              << ", num pkts in buffer=" << m_data.size());
+                              << ", num blocks in buffer=" << m_data.size());
     return outPkt;
 }
 
@@ -28,6 +28,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/traced-value.h"
 
+#include <list>
 #include <map>
 
 namespace ns3
@@ -55,6 +56,13 @@ class Packet;
  * To store data, use Add; for retrieving a certain amount of ordered data, use
  * the method Extract.
  *
+ * The data is stored as a set of blocks of contiguous sequence numbers: a
+ * segment adjacent to a block stored is appended to it, merging the blocks
+ * it fills the gap between, so that a lookup or an insertion depends on the
+ * number of holes, not on the number of segments stored. The segments are
+ * kept as received, and Extract returns them without copying the data when
+ * the amount requested is a single segment.
+ *
  * SACK list
  * ---------
  *
@@ -166,9 +174,9 @@ class TcpRxBuffer : public Object
      * The sack list can be empty, and it is updated each time Add or Extract
      * are called through the private method UpdateSackList.
      *
-     * \return a list of isolated blocks
+     * \return a reference to the list of isolated blocks
      */
-    TcpOptionSack::SackList GetSackList() const;
+    const TcpOptionSack::SackList& GetSackList() const;
 
     /**
      * \brief Get the size of Sack list
@@ -190,6 +198,10 @@ class TcpRxBuffer : public Object
     /**
      * \brief Update the sack list, with the block seq starting at the beginning
      *
+     * The block is the block of contiguous data holding the segment just
+     * received: the blocks of the list it includes, since it was merged with
+     * them, are removed.
+     *
      * Note: the maximum size of the block list is 4. Caller is free to
      * drop blocks at the end to accommodate header size; from RFC 2018:
      *
@@ -222,8 +234,17 @@ class TcpRxBuffer : public Object
 
     TcpOptionSack::SackList m_sackList; //!< Sack list (updated constantly)
 
-    /// container for data stored in the buffer
-    typedef std::map<SequenceNumber32, Ptr<Packet>>::iterator BufIterator;
+    /**
+     * \brief A block of contiguous data
+     */
+    struct DataBlock
+    {
+        SequenceNumber32 m_end;            //!< Sequence number following the block
+        std::list<Ptr<Packet>> m_packets; //!< Segments of the block, in order
+    };
+
+    /// container for data stored in the buffer, indexed by the start of the blocks
+    typedef std::map<SequenceNumber32, DataBlock>::iterator BufIterator;
     TracedValue<SequenceNumber32>
         m_nextRxSeq;           //!< Seqnum of the first missing byte in data (RCV.NXT)
     SequenceNumber32 m_finSeq; //!< Seqnum of the FIN packet
@@ -231,7 +252,7 @@ class TcpRxBuffer : public Object
     uint32_t m_size;       //!< Number of total data bytes in the buffer, not necessarily contiguous
     uint32_t m_maxBuffer;  //!< Upper bound of the number of data bytes in buffer (RCV.WND)
     uint32_t m_availBytes; //!< Number of bytes available to read, i.e. contiguous block at head
-    std::map<SequenceNumber32, Ptr<Packet>> m_data; //!< Corresponding data (may be null)
+    std::map<SequenceNumber32, DataBlock> m_data; //!< Blocks of contiguous data
 };
 
 } // namespace ns3
@@ -57,6 +57,7 @@
 #include "ns3/object.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/segment-offload-tag.h"
 #include "ns3/simulation-singleton.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
@@ -166,6 +167,15 @@ TcpSocketBase::GetTypeId()
                           BooleanValue(true),
                           MakeBooleanAccessor(&TcpSocketBase::m_limitedTx),
                           MakeBooleanChecker())
+            .AddAttribute("OffloadSegments",
+                          "Maximum number of segments of new data sent in one super-segment, "
+                          "which a device supporting segmentation offload transmits as "
+                          "separate segments (1 to disable). An IPv6 router whose device "
+                          "does not support segmentation offload drops the super-segments "
+                          "larger than its MTU",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&TcpSocketBase::m_offloadSegments),
+                          MakeUintegerChecker<uint32_t>(1, 64))
             .AddAttribute("UseEcn",
                           "Parameter to set ECN functionality",
                           EnumValue(TcpSocketState::Off),
@@ -381,6 +391,7 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
       m_recoverActive(sock.m_recoverActive),
       m_retxThresh(sock.m_retxThresh),
       m_limitedTx(sock.m_limitedTx),
+      m_offloadSegments(sock.m_offloadSegments),
       m_isFirstPartialAck(sock.m_isFirstPartialAck),
       m_txTrace(sock.m_txTrace),
       m_rxTrace(sock.m_rxTrace),
@@ -1381,8 +1392,7 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
         // When receiving a <SYN> or <SYN-ACK> we should adapt TS to the other end
         if (tcpHeader.HasOption(TcpOption::TS) && m_timestampEnabled)
         {
-            ProcessOptionTimestamp(tcpHeader.GetOption(TcpOption::TS),
-                                   tcpHeader.GetSequenceNumber());
+            ProcessOptionTimestamp(tcpHeader);
         }
         else
         {
@@ -1415,8 +1425,7 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
             }
             else
             {
-                ProcessOptionTimestamp(tcpHeader.GetOption(TcpOption::TS),
-                                       tcpHeader.GetSequenceNumber());
+                ProcessOptionTimestamp(tcpHeader);
             }
         }
 
@@ -1610,17 +1619,10 @@ TcpSocketBase::ReadOptions(const TcpHeader& tcpHeader, uint32_t* bytesSacked)
 {
     NS_LOG_FUNCTION(this << tcpHeader);
 
-    for (const auto& option : tcpHeader.GetOptionList())
+    // Check only for ACK options here
+    if (tcpHeader.HasOption(TcpOption::SACK))
     {
-        // Check only for ACK options here
-        switch (option->GetKind())
-        {
-        case TcpOption::SACK:
-            *bytesSacked = ProcessOptionSack(option);
-            break;
-        default:
-            continue;
-        }
+        *bytesSacked = ProcessOptionSack(tcpHeader);
     }
 }
 
@@ -3220,6 +3222,14 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     header.SetWindowSize(AdvertisedWindowSize());
     AddOptions(header);
 
+    if (sz > m_tcb->m_segmentSize)
+    {
+        // A super-segment: the device accounts for the headers of each segment.
+        // The network layer adds the size of its own header to the tag
+        uint16_t segments = (sz + m_tcb->m_segmentSize - 1) / m_tcb->m_segmentSize;
+        p->AddPacketTag(SegmentOffloadTag(segments, header.GetSerializedSize()));
+    }
+
     if (m_retxEvent.IsExpired())
     {
         // Schedules retransmit timeout. m_rto should be already doubled.
@@ -3395,6 +3405,14 @@ TcpSocketBase::SendPendingData(bool withAck)
             auto maxSizeToSend = static_cast<uint32_t>(nextHigh - next);
             s = std::min(s, maxSizeToSend);
 
+            // With segmentation offload, new data is sent in a super-segment of
+            // several full segments that the device accounts for as separate
+            // segments on transmission
+            if (m_offloadSegments > 1 && next == m_tcb->m_highTxMark && s == m_tcb->m_segmentSize)
+            {
+                s = GetOffloadSize(next, availableWindow, availableData);
+            }
+
             // (C.2) If any of the data octets sent in (C.1) are below HighData,
             //       HighRxt MUST be set to the highest sequence number of the
             //       retransmitted segment unless NextSeg () rule (4) was
@@ -3468,6 +3486,29 @@ TcpSocketBase::SendPendingData(bool withAck)
     return nPacketsSent;
 }
 
+uint32_t
+TcpSocketBase::GetOffloadSize(SequenceNumber32 next,
+                              uint32_t availableWindow,
+                              uint32_t availableData) const
+{
+    NS_LOG_FUNCTION(this << next << availableWindow << availableData);
+    // the IP payload of a super-segment is limited to 64 KB, less the
+    // largest IP and TCP headers
+    const uint32_t maxOffloadSize = 65535 - 60 - 60;
+    SequenceNumber32 rightEdge = m_highRxAckMark.Get() + SequenceNumber32(m_rWnd.Get());
+    uint32_t size = std::min({availableWindow,
+                              availableData,
+                              m_offloadSegments * m_tcb->m_segmentSize,
+                              maxOffloadSize,
+                              static_cast<uint32_t>(rightEdge - next)});
+    if (size < availableData)
+    {
+        // only the last super-segment of the data may end with a partial segment
+        size -= size % m_tcb->m_segmentSize;
+    }
+    return std::max(size, m_tcb->m_segmentSize);
+}
+
 uint32_t
 TcpSocketBase::UnAckDataCount() const
 {
@@ -3548,6 +3589,11 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
     NS_LOG_DEBUG("Data segment, seq=" << tcpHeader.GetSequenceNumber()
                                       << " pkt size=" << p->GetSize());
 
+    // A super-segment counts as all of its segments. The tag only concerns
+    // this hop, so it is removed before the data is buffered
+    SegmentOffloadTag offloadTag;
+    uint32_t segments = p->RemovePacketTag(offloadTag) ? offloadTag.GetSegments() : 1;
+
     // Put into Rx buffer
     SequenceNumber32 expectedSeq = m_tcb->m_rxBuffer->NextRxSequence();
     if (!m_tcb->m_rxBuffer->Add(p, tcpHeader))
@@ -3604,7 +3650,9 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
     }
     else
     { // In-sequence packet: ACK if delayed ack count allows
-        if (++m_delAckCount >= m_delAckMaxCount)
+        // A super-segment is acked at once, as a coalesced segment is after GRO
+        m_delAckCount += segments;
+        if (m_delAckCount >= m_delAckMaxCount)
         {
             m_delAckEvent.Cancel();
             m_delAckCount = 0;
@@ -3648,11 +3696,11 @@ TcpSocketBase::CalculateRttSample(const TcpHeader& tcpHeader, const RttHistory&
 
     if (!rttHistory.retx && ackSeq >= (rttHistory.seq + SequenceNumber32(rttHistory.count)))
     { // Ok to use this sample
-        if (m_timestampEnabled && tcpHeader.HasOption(TcpOption::TS))
+        uint32_t timestamp;
+        uint32_t echo;
+        if (m_timestampEnabled && tcpHeader.GetTimestampOption(timestamp, echo))
         {
-            Ptr<const TcpOptionTS> ts;
-            ts = DynamicCast<const TcpOptionTS>(tcpHeader.GetOption(TcpOption::TS));
-            rtt = TcpOptionTS::ElapsedTimeFromTsValue(ts->GetEcho());
+            rtt = TcpOptionTS::ElapsedTimeFromTsValue(echo);
             if (rtt.IsZero())
             {
                 NS_LOG_LOGIC("TcpSocketBase::EstimateRtt - RTT calculated from TcpOption::TS "
@@ -4320,12 +4368,12 @@ TcpSocketBase::AddOptionWScale(TcpHeader& header)
 }
 
 uint32_t
-TcpSocketBase::ProcessOptionSack(const Ptr<const TcpOption> option)
+TcpSocketBase::ProcessOptionSack(const TcpHeader& tcpHeader)
 {
-    NS_LOG_FUNCTION(this << option);
+    NS_LOG_FUNCTION(this << tcpHeader);
 
-    Ptr<const TcpOptionSack> s = DynamicCast<const TcpOptionSack>(option);
-    return m_txBuffer->Update(s->GetSackList(), MakeCallback(&TcpRateOps::SkbDelivered, m_rateOps));
+    tcpHeader.GetSackOption(m_rxSackList);
+    return m_txBuffer->Update(m_rxSackList, MakeCallback(&TcpRateOps::SkbDelivered, m_rateOps));
 }
 
 void
@@ -4359,7 +4407,7 @@ TcpSocketBase::AddOptionSack(TcpHeader& header)
     uint8_t optionLenAvail = header.GetMaxOptionLength() - header.GetOptionLength();
     uint8_t allowedSackBlocks = (optionLenAvail - 2) / 8;
 
-    TcpOptionSack::SackList sackList = m_tcb->m_rxBuffer->GetSackList();
+    const TcpOptionSack::SackList& sackList = m_tcb->m_rxBuffer->GetSackList();
     if (allowedSackBlocks == 0 || sackList.empty())
     {
         NS_LOG_LOGIC("No space available or sack list empty, not adding sack blocks");
@@ -4367,44 +4415,37 @@ TcpSocketBase::AddOptionSack(TcpHeader& header)
     }
 
     // Append the allowed number of SACK blocks
-    Ptr<TcpOptionSack> option = CreateObject<TcpOptionSack>();
-
-    for (auto i = sackList.begin(); allowedSackBlocks > 0 && i != sackList.end(); ++i)
-    {
-        option->AddSackBlock(*i);
-        allowedSackBlocks--;
-    }
-
-    header.AppendOption(option);
-    NS_LOG_INFO(m_node->GetId() << " Add option SACK " << *option);
+    uint32_t nBlocks = header.AppendSackOption(sackList);
+    NS_LOG_INFO(m_node->GetId() << " Add option SACK with " << nBlocks << " blocks");
 }
 
 void
-TcpSocketBase::ProcessOptionTimestamp(const Ptr<const TcpOption> option,
-                                      const SequenceNumber32& seq)
+TcpSocketBase::ProcessOptionTimestamp(const TcpHeader& tcpHeader)
 {
-    NS_LOG_FUNCTION(this << option);
+    NS_LOG_FUNCTION(this << tcpHeader);
 
-    Ptr<const TcpOptionTS> ts = DynamicCast<const TcpOptionTS>(option);
+    uint32_t timestamp;
+    uint32_t echo;
+    tcpHeader.GetTimestampOption(timestamp, echo);
+    SequenceNumber32 seq = tcpHeader.GetSequenceNumber();
 
     // This is valid only when no overflow occurs. It happens
     // when a connection last longer than 50 days.
-    if (m_tcb->m_rcvTimestampValue > ts->GetTimestamp())
+    if (m_tcb->m_rcvTimestampValue > timestamp)
     {
         // Do not save a smaller timestamp (probably there is reordering)
         return;
     }
 
-    m_tcb->m_rcvTimestampValue = ts->GetTimestamp();
-    m_tcb->m_rcvTimestampEchoReply = ts->GetEcho();
+    m_tcb->m_rcvTimestampValue = timestamp;
+    m_tcb->m_rcvTimestampEchoReply = echo;
 
     if (seq == m_tcb->m_rxBuffer->NextRxSequence() && seq <= m_highTxAck)
     {
-        m_timestampToEcho = ts->GetTimestamp();
+        m_timestampToEcho = timestamp;
     }
 
-    NS_LOG_INFO(m_node->GetId() << " Got timestamp=" << m_timestampToEcho
-                                << " and Echo=" << ts->GetEcho());
+    NS_LOG_INFO(m_node->GetId() << " Got timestamp=" << m_timestampToEcho << " and Echo=" << echo);
 }
 
 void
@@ -4412,13 +4453,9 @@ TcpSocketBase::AddOptionTimestamp(TcpHeader& header)
 {
     NS_LOG_FUNCTION(this << header);
 
-    Ptr<TcpOptionTS> option = CreateObject<TcpOptionTS>();
-
-    option->SetTimestamp(TcpOptionTS::NowToTsValue());
-    option->SetEcho(m_timestampToEcho);
-
-    header.AppendOption(option);
-    NS_LOG_INFO(m_node->GetId() << " Add option TS, ts=" << option->GetTimestamp()
+    uint32_t timestamp = TcpOptionTS::NowToTsValue();
+    header.AppendTimestampOption(timestamp, m_timestampToEcho);
+    NS_LOG_INFO(m_node->GetId() << " Add option TS, ts=" << timestamp
                                 << " echo=" << m_timestampToEcho);
 }
 
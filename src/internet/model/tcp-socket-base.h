@@ -1004,6 +1004,21 @@ class TcpSocketBase : public TcpSocket
      */
     virtual uint32_t AvailableWindow() const;
 
+    /**
+     * \brief Get the size of a super-segment of new data sent with segmentation offload
+     *
+     * The size is limited by the windows, the data available and the OffloadSegments
+     * attribute, and is a multiple of the segment size unless it ends the data.
+     *
+     * \param next the sequence number of the first byte of the super-segment
+     * \param availableWindow the available window
+     * \param availableData the data available from the sequence number
+     * \returns the size of the super-segment, at least one segment
+     */
+    uint32_t GetOffloadSize(SequenceNumber32 next,
+                            uint32_t availableWindow,
+                            uint32_t availableData) const;
+
     /**
      * \brief The amount of Rx window announced to the peer
      * \param scale indicate if the window should be scaled. True for
@@ -1213,10 +1228,10 @@ class TcpSocketBase : public TcpSocket
     /**
      * \brief Read the SACK option
      *
-     * \param option SACK option from the header
+     * \param tcpHeader Header of the segment, which has a SACK option
      * \returns the number of bytes sacked by this option
      */
-    uint32_t ProcessOptionSack(const Ptr<const TcpOption> option);
+    uint32_t ProcessOptionSack(const TcpHeader& tcpHeader);
 
     /**
      * \brief Add the SACK PERMITTED option to the header
@@ -1239,10 +1254,9 @@ class TcpSocketBase : public TcpSocket
      * to utilize later to calculate RTT.
      *
      * \see EstimateRtt
-     * \param option Option from the segment
-     * \param seq Sequence number of the segment
+     * \param tcpHeader Header of the segment, which has a timestamp option
      */
-    void ProcessOptionTimestamp(const Ptr<const TcpOption> option, const SequenceNumber32& seq);
+    void ProcessOptionTimestamp(const TcpHeader& tcpHeader);
     /**
      * \brief Add the timestamp option to the header
      *
@@ -1376,6 +1390,8 @@ class TcpSocketBase : public TcpSocket
     uint8_t m_sndWindShift{0};      //!< Window shift to apply to incoming segments
     bool m_timestampEnabled{true};  //!< Timestamp option enabled
     uint32_t m_timestampToEcho{0};  //!< Timestamp to echo
+    /// SACK blocks of the last segment received, whose elements are reused for the next ones
+    TcpOptionSack::SackList m_rxSackList;
 
     EventId m_sendPendingDataEvent{}; //!< micro-delay event to send pending data
 
@@ -1388,6 +1404,9 @@ class TcpSocketBase : public TcpSocket
     uint32_t m_retxThresh{3};    //!< Fast Retransmit threshold
     bool m_limitedTx{true};      //!< perform limited transmit
 
+    // Segmentation offload
+    uint32_t m_offloadSegments{1}; //!< Maximum number of segments in a super-segment
+
     // Transmission Control Block
     Ptr<TcpSocketState> m_tcb;                 //!< Congestion control information
     Ptr<TcpCongestionOps> m_congestionControl; //!< Congestion control
@@ -296,7 +296,7 @@ TcpTxBuffer::GetNewSegment(uint32_t numBytes)
     NS_ASSERT(it != m_appList.end());
 
     m_appList.erase(it);
-    m_sentList.insert(m_sentList.end(), item);
+    IndexItem(m_sentList.insert(m_sentList.end(), item));
     m_sentSize += item->m_packet->GetSize();
 
     return item;
@@ -310,37 +310,33 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     NS_ASSERT(numBytes <= m_sentSize);
     NS_ASSERT(!m_sentList.empty());
 
-    auto it = m_sentList.begin();
     bool listEdited = false;
     uint32_t s = numBytes;
 
     // Avoid to merge different packet for this retransmission if flags are
     // different.
-    for (; it != m_sentList.end(); ++it)
+    auto found = m_sentIndex.find(seq);
+    if (found != m_sentIndex.end())
     {
-        if ((*it)->m_startSeq == seq)
+        auto it = *found;
+        auto next = std::next(it);
+        if (next != m_sentList.end())
         {
-            auto next = it;
-            next++;
-            if (next != m_sentList.end())
+            // Next is not sacked and have the same value for m_lost ... there is the
+            // possibility to merge
+            if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
             {
-                // Next is not sacked and have the same value for m_lost ... there is the
-                // possibility to merge
-                if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
-                {
-                    s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
-                }
-                else
-                {
-                    // Next is sacked... better to retransmit only the first segment
-                    s = std::min(s, (*it)->m_packet->GetSize());
-                }
+                s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
             }
             else
             {
+                // Next is sacked... better to retransmit only the first segment
                 s = std::min(s, (*it)->m_packet->GetSize());
             }
-            break;
+        }
+        else
+        {
+            s = std::min(s, (*it)->m_packet->GetSize());
         }
     }
 
@@ -350,6 +346,7 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     {
         m_retrans += item->m_packet->GetSize();
         item->m_retrans = true;
+        UpdateItemIndex(item);
     }
 
     return item;
@@ -360,21 +357,13 @@ TcpTxBuffer::FindHighestSacked() const
 {
     NS_LOG_FUNCTION(this);
 
-    SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
-    auto ret = std::make_pair(m_sentList.end(), SequenceNumber32(0));
-
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    if (m_sackedIndex.empty())
     {
-        const TcpTxItem* item = *it;
-        if (item->m_sacked)
-        {
-            ret = std::make_pair(it, beginOfCurrentPacket);
-        }
-        beginOfCurrentPacket += item->m_packet->GetSize();
+        return std::make_pair(m_sentList.cend(), SequenceNumber32(0));
     }
 
-    return ret;
+    PacketList::const_iterator it = *m_sackedIndex.rbegin();
+    return std::make_pair(it, (*it)->m_startSeq);
 }
 
 void
@@ -402,7 +391,7 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                                const SequenceNumber32& listStartFrom,
                                uint32_t numBytes,
                                const SequenceNumber32& seq,
-                               bool* listEdited) const
+                               bool* listEdited)
 {
     NS_LOG_FUNCTION(this << numBytes << seq);
 
@@ -436,14 +425,26 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
     Ptr<Packet> currentPacket = nullptr;
     TcpTxItem* currentItem = nullptr;
     TcpTxItem* outItem = nullptr;
+    bool isSentList = &list == &m_sentList;
     auto it = list.begin();
     SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
+    if (isSentList)
+    {
+        // Skip directly to the item holding seq
+        auto found = FindSentItem(seq);
+        if (found != m_sentIndex.end())
+        {
+            it = *found;
+            beginOfCurrentPacket = (*it)->m_startSeq;
+        }
+    }
+
     while (it != list.end())
     {
         currentItem = *it;
         currentPacket = currentItem->m_packet;
-        NS_ASSERT_MSG(list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+        NS_ASSERT_MSG(!isSentList || currentItem->m_startSeq >= m_firstByteSeq,
                       "start: " << m_firstByteSeq
                                 << " currentItem start: " << currentItem->m_startSeq);
 
@@ -472,7 +473,11 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                 SplitItems(firstPart, currentItem, seq - beginOfCurrentPacket);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto firstPartIt = list.insert(it, firstPart);
+                if (isSentList)
+                {
+                    IndexItem(firstPartIt);
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -518,6 +523,10 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                     NS_ASSERT(it != list.begin());
                     TcpTxItem* previous = *(--it);
 
+                    if (isSentList)
+                    {
+                        UnindexItem(it);
+                    }
                     list.erase(it);
 
                     MergeItems(previous, currentItem);
@@ -538,7 +547,11 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                 SplitItems(firstPart, currentItem, numBytes);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto firstPartIt = list.insert(it, firstPart);
+                if (isSentList)
+                {
+                    IndexItem(firstPartIt);
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -566,7 +579,16 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
             TcpTxItem* next = (*it); // Please remember we have incremented it
                                      // in the previous if
 
+            if (isSentList)
+            {
+                UnindexItem(it);
+            }
             MergeItems(currentItem, next);
+            if (isSentList)
+            {
+                // the merge may have cleared the retransmitted flag
+                UpdateItemIndex(std::prev(it));
+            }
             list.erase(it);
 
             delete next;
@@ -585,7 +607,7 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
 }
 
 void
-TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2) const
+TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2)
 {
     NS_ASSERT(t1 != nullptr && t2 != nullptr);
     NS_LOG_FUNCTION(this << *t1 << *t2);
@@ -602,15 +624,13 @@ TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2) const
     {
         if (t1->m_retrans)
         {
-            auto self = const_cast<TcpTxBuffer*>(this);
-            self->m_retrans -= t1->m_packet->GetSize();
+            m_retrans -= t1->m_packet->GetSize();
             t1->m_retrans = false;
         }
         else
         {
             NS_ASSERT(t2->m_retrans);
-            auto self = const_cast<TcpTxBuffer*>(this);
-            self->m_retrans -= t2->m_packet->GetSize();
+            m_retrans -= t2->m_packet->GetSize();
             t2->m_retrans = false;
         }
     }
@@ -651,16 +671,15 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked(const SequenceNumber32& ack) const
 {
     NS_LOG_FUNCTION(this);
-    for (const auto& it : m_sentList)
+    // Only the item ending at ack can match
+    auto found = FindSentItem(ack - 1);
+    if (found == m_sentIndex.end())
     {
-        TcpTxItem* item = it;
-        Ptr<Packet> p = item->m_packet;
-        if (item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans)
-        {
-            return true;
-        }
+        return false;
     }
-    return false;
+    const TcpTxItem* item = *(*found);
+    return item->m_startSeq + item->m_packet->GetSize() == ack && !item->m_sacked &&
+           item->m_retrans;
 }
 
 void
@@ -708,6 +727,7 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
 
             RemoveFromCounts(item, pktSize);
 
+            UnindexItem(i);
             i = m_sentList.erase(i);
             NS_LOG_INFO("Removed " << *item << " lost: " << m_lostOut << " retrans: " << m_retrans
                                    << " sacked: " << m_sackedOut << ". Remaining data " << m_size);
@@ -756,6 +776,7 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
             // when adding Reno dupacks in the count.
             head->m_sacked = false;
             m_sackedOut -= head->m_packet->GetSize();
+            UpdateItemIndex(m_sentList.begin());
             NS_LOG_INFO("Moving the SACK flag from the HEAD to another segment");
             AddRenoSack();
             MarkHeadAsLost();
@@ -790,15 +811,21 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
 
     for (auto option_it = list.begin(); option_it != list.end(); ++option_it)
     {
-        auto item_it = m_sentList.begin();
-        SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
         if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
             NS_LOG_INFO("Not updating scoreboard, the option block is outside the sent list");
             return bytesSacked;
         }
 
+        // Only the items starting inside the block can be sacked
+        auto first = m_sentIndex.lower_bound((*option_it).first);
+        if (first == m_sentIndex.end())
+        {
+            continue;
+        }
+        auto item_it = *first;
+        SequenceNumber32 beginOfCurrentPacket = (*item_it)->m_startSeq;
+
         while (item_it != m_sentList.end())
         {
             uint32_t pktSize = (*item_it)->m_packet->GetSize();
@@ -829,6 +856,7 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
                     (*item_it)->m_sacked = true;
                     m_sackedOut += (*item_it)->m_packet->GetSize();
                     bytesSacked += (*item_it)->m_packet->GetSize();
+                    UpdateItemIndex(item_it);
 
                     if (m_highestSack.first == m_sentList.end() ||
                         m_highestSack.second <= beginOfCurrentPacket + pktSize)
@@ -879,12 +907,12 @@ void
 TcpTxBuffer::UpdateLostCount()
 {
     NS_LOG_FUNCTION(this);
-    uint32_t sacked = 0;
-    SequenceNumber32 beginOfCurrentPacket = m_highestSack.second;
+    auto highest = m_highestSack.first;
     if (m_highestSack.first == m_sentList.end())
     {
         NS_LOG_INFO("Status before the update: " << *this
                                                  << ", will start from the latest sent item");
+        highest = std::prev(m_sentList.end());
     }
     else
     {
@@ -892,32 +920,39 @@ TcpTxBuffer::UpdateLostCount()
                                                  << *(*m_highestSack.first));
     }
 
-    for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
+    // The segments below the "Dupack thresh"-th sacked segment, counting down
+    // from the highest sacked one and excluding the head, are lost
+    SequenceNumber32 lostBelow = (*highest)->m_startSeq;
+    uint32_t sacked = 0;
+    for (auto it = m_sackedIndex.upper_bound(lostBelow);
+         sacked < m_dupAckThresh && it != m_sackedIndex.begin();)
     {
-        TcpTxItem* item = *it;
-        if (item->m_sacked)
-        {
-            sacked++;
-        }
-
-        if (sacked >= m_dupAckThresh)
+        --it;
+        if (*it == m_sentList.begin())
         {
-            if (!item->m_sacked && !item->m_lost)
-            {
-                item->m_lost = true;
-                m_lostOut += item->m_packet->GetSize();
-            }
+            break;
         }
-        beginOfCurrentPacket -= item->m_packet->GetSize();
+        lostBelow = (*(*it))->m_startSeq;
+        sacked++;
     }
 
     if (sacked >= m_dupAckThresh)
     {
+        while (!m_unmarkedIndex.empty() &&
+               (*(*m_unmarkedIndex.begin()))->m_startSeq <= lostBelow)
+        {
+            auto it = *m_unmarkedIndex.begin();
+            (*it)->m_lost = true;
+            m_lostOut += (*it)->m_packet->GetSize();
+            UpdateItemIndex(it);
+        }
+
         TcpTxItem* item = *m_sentList.begin();
         if (!item->m_lost)
         {
             item->m_lost = true;
             m_lostOut += item->m_packet->GetSize();
+            UpdateItemIndex(m_sentList.begin());
         }
     }
     NS_LOG_INFO("Status after the update: " << *this);
@@ -934,25 +969,11 @@ TcpTxBuffer::IsLost(const SequenceNumber32& seq) const
         return false;
     }
 
-    // In theory, using a map and hints when inserting elements can improve
-    // performance
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    auto found = FindSentItem(seq);
+    if (found != m_sentIndex.end() && (*(*found))->m_lost)
     {
-        // Search for the right iterator before calling IsLost()
-        if ((*it)->m_startSeq <= seq && seq < (*it)->m_startSeq + (*it)->m_packet->GetSize())
-        {
-            if ((*it)->m_lost)
-            {
-                NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
-                return true;
-            }
-
-            if ((*it)->m_sacked)
-            {
-                NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
-                return false;
-            }
-        }
+        NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
+        return true;
     }
 
     return false;
@@ -976,36 +997,18 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
      *
      *     (1.c) IsLost (S2) returns true.
      */
-    TcpTxItem* item;
-    SequenceNumber32 seqPerRule3;
-    bool isSeqPerRule3Valid = false;
-    SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
+    // Condition 1.a and 1.b
+    auto isCandidate = [this](PacketList::iterator it) {
+        return !m_sackSeen || (*it)->m_startSeq < m_highestSack.second;
+    };
 
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // Condition 1.c: the lowest segment lost and neither sacked nor retransmitted
+    if (!m_lostIndex.empty() && isCandidate(*m_lostIndex.begin()))
     {
-        item = *it;
-
-        // Condition 1.a , 1.b , and 1.c
-        if (!item->m_retrans && !item->m_sacked &&
-            ((m_sackSeen && item->m_startSeq < m_highestSack.second) || !m_sackSeen))
-        {
-            if (item->m_lost)
-            {
-                NS_LOG_INFO("IsLost, returning" << beginOfCurrentPkt);
-                *seq = beginOfCurrentPkt;
-                *seqHigh = *seq + m_segmentSize;
-                return true;
-            }
-            else if (seqPerRule3.GetValue() == 0 && isRecovery)
-            {
-                NS_LOG_INFO("Saving for rule 3 the seq " << beginOfCurrentPkt);
-                isSeqPerRule3Valid = true;
-                seqPerRule3 = beginOfCurrentPkt;
-            }
-        }
-
-        // Nothing found, iterate
-        beginOfCurrentPkt += item->m_packet->GetSize();
+        *seq = (*(*m_lostIndex.begin()))->m_startSeq;
+        NS_LOG_INFO("IsLost, returning" << *seq);
+        *seqHigh = *seq + m_segmentSize;
+        return true;
     }
 
     /* (2) If no sequence number 'S2' per rule (1) exists but there
@@ -1040,6 +1043,18 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
      *     (specifically excluding step (1.c)), then one segment of up to
      *     SMSS octets starting with S3 SHOULD be returned.
      */
+    SequenceNumber32 seqPerRule3;
+    bool isSeqPerRule3Valid = false;
+
+    for (auto it = m_holeIndex.begin();
+         isRecovery && seqPerRule3.GetValue() == 0 && it != m_holeIndex.end() && isCandidate(*it);
+         ++it)
+    {
+        NS_LOG_INFO("Saving for rule 3 the seq " << (*(*it))->m_startSeq);
+        isSeqPerRule3Valid = true;
+        seqPerRule3 = (*(*it))->m_startSeq;
+    }
+
     if (isSeqPerRule3Valid)
     {
         NS_LOG_INFO("Rule3 valid. " << seqPerRule3);
@@ -1211,9 +1226,11 @@ TcpTxBuffer::ResetRenoSack()
     NS_LOG_FUNCTION(this);
 
     m_sackedOut = 0;
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    while (!m_sackedIndex.empty())
     {
+        auto it = *m_sackedIndex.begin();
         (*it)->m_sacked = false;
+        UpdateItemIndex(it);
     }
 
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
@@ -1233,6 +1250,12 @@ TcpTxBuffer::ResetSentList()
     NS_LOG_FUNCTION(this);
     TcpTxItem* item;
 
+    m_sentIndex.clear();
+    m_sackedIndex.clear();
+    m_lostIndex.clear();
+    m_holeIndex.clear();
+    m_unmarkedIndex.clear();
+
     // Keep the head items; they will then marked as lost
     while (!m_sentList.empty())
     {
@@ -1258,6 +1281,7 @@ TcpTxBuffer::ResetLastSegmentSent()
     {
         TcpTxItem* item = m_sentList.back();
 
+        UnindexItem(std::prev(m_sentList.end()));
         m_sentList.pop_back();
         m_sentSize -= item->m_packet->GetSize();
         if (item->m_retrans)
@@ -1310,6 +1334,7 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
         }
 
         (*it)->m_retrans = false;
+        UpdateItemIndex(it);
     }
 
     NS_LOG_INFO("Set sent list lost, status: " << *this);
@@ -1344,6 +1369,7 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead()
     {
         m_sentList.front()->m_retrans = false;
         m_retrans -= m_sentList.front()->m_packet->GetSize();
+        UpdateItemIndex(m_sentList.begin());
     }
     ConsistencyCheck();
 }
@@ -1373,6 +1399,7 @@ TcpTxBuffer::MarkHeadAsLost()
             m_sentList.front()->m_lost = true;
             m_lostOut += m_sentList.front()->m_packet->GetSize();
         }
+        UpdateItemIndex(m_sentList.begin());
     }
     ConsistencyCheck();
 }
@@ -1407,6 +1434,7 @@ TcpTxBuffer::AddRenoSack()
     {
         (*it)->m_sacked = true;
         m_sackedOut += (*it)->m_packet->GetSize();
+        UpdateItemIndex(it);
         m_sackSeen = true;
         m_highestSack = std::make_pair(it, (*it)->m_startSeq);
         NS_LOG_INFO("Added a Reno SACK, status: " << *this);
@@ -1420,6 +1448,76 @@ TcpTxBuffer::AddRenoSack()
     ConsistencyCheck();
 }
 
+void
+TcpTxBuffer::IndexItem(PacketList::iterator it)
+{
+    m_sentIndex.insert(it);
+    UpdateItemIndex(it);
+}
+
+void
+TcpTxBuffer::UnindexItem(PacketList::iterator it)
+{
+    m_sentIndex.erase(it);
+    m_sackedIndex.erase(it);
+    m_lostIndex.erase(it);
+    m_holeIndex.erase(it);
+    m_unmarkedIndex.erase(it);
+}
+
+void
+TcpTxBuffer::UpdateItemIndex(PacketList::iterator it)
+{
+    const TcpTxItem* item = *it;
+    m_sackedIndex.erase(it);
+    m_lostIndex.erase(it);
+    m_holeIndex.erase(it);
+    m_unmarkedIndex.erase(it);
+
+    if (item->m_sacked)
+    {
+        m_sackedIndex.insert(it);
+        return;
+    }
+    if (!item->m_retrans)
+    {
+        m_holeIndex.insert(it);
+        if (item->m_lost)
+        {
+            m_lostIndex.insert(it);
+        }
+    }
+    if (!item->m_lost)
+    {
+        m_unmarkedIndex.insert(it);
+    }
+}
+
+void
+TcpTxBuffer::UpdateItemIndex(TcpTxItem* item)
+{
+    auto found = FindSentItem(item->m_startSeq);
+    NS_ASSERT(found != m_sentIndex.end() && *(*found) == item);
+    UpdateItemIndex(*found);
+}
+
+TcpTxBuffer::ItemIndex::const_iterator
+TcpTxBuffer::FindSentItem(const SequenceNumber32& seq) const
+{
+    auto it = m_sentIndex.upper_bound(seq);
+    if (it == m_sentIndex.begin())
+    {
+        return m_sentIndex.end();
+    }
+    --it;
+    const TcpTxItem* item = *(*it);
+    if (seq < item->m_startSeq + item->m_packet->GetSize())
+    {
+        return it;
+    }
+    return m_sentIndex.end();
+}
+
 void
 TcpTxBuffer::ConsistencyCheck() const
 {
@@ -1455,6 +1553,8 @@ TcpTxBuffer::ConsistencyCheck() const
     NS_ASSERT_MSG(lost == m_lostOut, " Counted lost: " << lost << " stored lost: " << m_lostOut);
     NS_ASSERT_MSG(retrans == m_retrans,
                   " Counted retrans: " << retrans << " stored retrans: " << m_retrans);
+    NS_ASSERT_MSG(m_sentIndex.size() == m_sentList.size(),
+                  " Indexed items: " << m_sentIndex.size() << " sent items: " << m_sentList.size());
 }
 
 std::ostream&
@@ -28,6 +28,10 @@
 #include "ns3/sequence-number.h"
 #include "ns3/traced-value.h"
 
+#include <set>
+
+class TcpTxBufferIndexTestCase;
+
 namespace ns3
 {
 class Packet;
@@ -71,8 +75,16 @@ class Packet;
  * associated with every segment sent. This is done through the use of the
  * class TcpTxItem: instead of storing a list of packets, we store a list of
  * TcpTxItem. Each item has different flags (check the corresponding
- * documentation) and maintaining the scoreboard is a matter of travelling the
- * list and set the SACK flag on the corresponding segment sent.
+ * documentation) and maintaining the scoreboard is a matter of finding the
+ * segments sent covered by a SACK block and setting their SACK flag.
+ *
+ * To avoid walking the list of sent segments, which holds a whole window of
+ * data, the items of the SentList are indexed by sequence number, and the
+ * items having the flags looked for by the scoreboard (sacked, lost and not
+ * retransmitted, ...) are indexed in separate ordered sets. Finding the
+ * segment holding a sequence number, the next segment to retransmit, or the
+ * segments to mark as lost takes a logarithmic time in the number of
+ * segments sent.
  *
  * Item properties
  * ---------------
@@ -411,8 +423,91 @@ class TcpTxBuffer : public Object
   private:
     friend std::ostream& operator<<(std::ostream& os, const TcpTxBuffer& tcpTxBuf);
 
+    /**
+     * \brief TcpTxBufferIndexTestCase test case.
+     * \relates TcpTxBufferIndexTestCase
+     */
+    friend class ::TcpTxBufferIndexTestCase;
+
     typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
 
+    /**
+     * \brief Order the items of the SentList by sequence number
+     *
+     * The comparison also accepts sequence numbers, to look up the items.
+     */
+    struct SentItemLess
+    {
+        using is_transparent = void; //!< Enable the lookups by sequence number
+
+        /**
+         * \brief Compare two items
+         * \param a first item
+         * \param b second item
+         * \return true if a starts before b
+         */
+        bool operator()(PacketList::iterator a, PacketList::iterator b) const
+        {
+            return (*a)->m_startSeq < (*b)->m_startSeq;
+        }
+
+        /**
+         * \brief Compare an item and a sequence number
+         * \param a item
+         * \param seq sequence number
+         * \return true if a starts before seq
+         */
+        bool operator()(PacketList::iterator a, const SequenceNumber32& seq) const
+        {
+            return (*a)->m_startSeq < seq;
+        }
+
+        /**
+         * \brief Compare a sequence number and an item
+         * \param seq sequence number
+         * \param b item
+         * \return true if seq is before the start of b
+         */
+        bool operator()(const SequenceNumber32& seq, PacketList::iterator b) const
+        {
+            return seq < (*b)->m_startSeq;
+        }
+    };
+
+    typedef std::set<PacketList::iterator, SentItemLess>
+        ItemIndex; //!< items of the SentList ordered by sequence number
+
+    /**
+     * \brief Index an item added to the SentList
+     * \param it the item
+     */
+    void IndexItem(PacketList::iterator it);
+
+    /**
+     * \brief Remove from the indexes an item to be removed from the SentList
+     * \param it the item
+     */
+    void UnindexItem(PacketList::iterator it);
+
+    /**
+     * \brief Update the indexes of the scoreboard after a change of the flags of an item
+     * \param it the item
+     */
+    void UpdateItemIndex(PacketList::iterator it);
+
+    /**
+     * \brief Update the indexes of the scoreboard after a change of the flags of an item
+     * \param item the item, which must be in the SentList
+     */
+    void UpdateItemIndex(TcpTxItem* item);
+
+    /**
+     * \brief Find the item of the SentList holding a sequence number
+     * \param seq the sequence number
+     * \return the item in m_sentIndex, or the end of m_sentIndex if no item holds seq
+     */
+    ItemIndex::const_iterator FindSentItem(const SequenceNumber32& seq) const;
+
     /**
      * \brief Update the lost count
      *
@@ -428,8 +523,8 @@ class TcpTxBuffer : public Object
      * The {New}Reno cases, for now, are managed in TcpSocketBase through the
      * call to MarkHeadAsLost.
      * This function is, therefore, called after a SACK option has been received,
-     * and updates the lost count. It can be probably optimized by not walking
-     * the entire list, but a subset.
+     * and updates the lost count. It only visits the "Dupack thresh" sacked
+     * segments below the highest sacked one, and the segments it marks as lost.
      *
      */
     void UpdateLostCount();
@@ -553,6 +648,9 @@ class TcpTxBuffer : public Object
      * MSS can change, but it is stable, and retransmissions do not happen for
      * each segment).
      *
+     * The walk in the SentList starts from the item holding the requested
+     * sequence, found through the index.
+     *
      * \param list List to extract block from
      * \param startingSeq Starting sequence of the list
      * \param numBytes Bytes to extract, starting from requestedSeq
@@ -564,7 +662,7 @@ class TcpTxBuffer : public Object
                                  const SequenceNumber32& startingSeq,
                                  uint32_t numBytes,
                                  const SequenceNumber32& requestedSeq,
-                                 bool* listEdited = nullptr) const;
+                                 bool* listEdited = nullptr);
 
     /**
      * \brief Merge two TcpTxItem
@@ -576,7 +674,7 @@ class TcpTxBuffer : public Object
      * \param t1 first item
      * \param t2 second item
      */
-    void MergeItems(TcpTxItem* t1, TcpTxItem* t2) const;
+    void MergeItems(TcpTxItem* t1, TcpTxItem* t2);
 
     /**
      * \brief Split one TcpTxItem
@@ -613,6 +711,12 @@ class TcpTxBuffer : public Object
         m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
     std::pair<PacketList::const_iterator, SequenceNumber32> m_highestSack; //!< Highest SACK byte
 
+    ItemIndex m_sentIndex;     //!< Items of the SentList
+    ItemIndex m_sackedIndex;   //!< Sacked items
+    ItemIndex m_lostIndex;     //!< Lost items, neither sacked nor retransmitted
+    ItemIndex m_holeIndex;     //!< Items neither sacked nor retransmitted
+    ItemIndex m_unmarkedIndex; //!< Items neither sacked nor lost
+
     uint32_t m_lostOut{0};   //!< Number of lost bytes
     uint32_t m_sackedOut{0}; //!< Number of sacked bytes
     uint32_t m_retrans{0};   //!< Number of retransmitted bytes
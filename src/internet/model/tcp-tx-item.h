@@ -22,6 +22,8 @@
 #include "ns3/packet.h"
 #include "ns3/sequence-number.h"
 
+class TcpTxBufferIndexTestCase;
+
 namespace ns3
 {
 /**
@@ -107,6 +109,11 @@ class TcpTxItem
     // Only TcpTxBuffer is allowed to touch this part of the TcpTxItem, to manage
     // its internal lists and counters
     friend class TcpTxBuffer;
+    /**
+     * \brief TcpTxBufferIndexTestCase test case.
+     * \relates TcpTxBufferIndexTestCase
+     */
+    friend class ::TcpTxBufferIndexTestCase;
 
     SequenceNumber32 m_startSeq{0}; //!< Sequence number of the item (if transmitted)
     Ptr<Packet> m_packet{nullptr};  //!< Application packet (can be null)
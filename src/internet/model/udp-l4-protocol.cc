@@ -382,10 +382,14 @@ UdpL4Protocol::Receive(Ptr<Packet> packet, const Ipv4Header& header, Ptr<Ipv4Int
     }
 
     packet->RemoveHeader(udpHeader);
+    // the packet is a copy made by the IP layer: only the other endpoints need their own copy
+    Ipv4EndPoint* last = endPoints.back();
+    endPoints.pop_back();
     for (auto endPoint = endPoints.begin(); endPoint != endPoints.end(); endPoint++)
     {
         (*endPoint)->ForwardUp(packet->Copy(), header, udpHeader.GetSourcePort(), interface);
     }
+    last->ForwardUp(packet, header, udpHeader.GetSourcePort(), interface);
     return IpL4Protocol::RX_OK;
 }
 
@@ -461,6 +465,14 @@ UdpL4Protocol::Send(Ptr<Packet> packet,
 {
     NS_LOG_FUNCTION(this << packet << saddr << daddr << sport << dport << route);
 
+    Send(packet, MakeHeader(saddr, daddr, sport, dport), saddr, daddr, route);
+}
+
+UdpHeader
+UdpL4Protocol::MakeHeader(Ipv4Address saddr, Ipv4Address daddr, uint16_t sport, uint16_t dport)
+{
+    NS_LOG_FUNCTION(saddr << daddr << sport << dport);
+
     UdpHeader udpHeader;
     if (Node::ChecksumEnabled())
     {
@@ -469,8 +481,19 @@ UdpL4Protocol::Send(Ptr<Packet> packet,
     }
     udpHeader.SetDestinationPort(dport);
     udpHeader.SetSourcePort(sport);
+    return udpHeader;
+}
 
-    packet->AddHeader(udpHeader);
+void
+UdpL4Protocol::Send(Ptr<Packet> packet,
+                    const UdpHeader& header,
+                    Ipv4Address saddr,
+                    Ipv4Address daddr,
+                    Ptr<Ipv4Route> route)
+{
+    NS_LOG_FUNCTION(this << packet << saddr << daddr << route);
+
+    packet->AddHeader(header);
 
     m_downTarget(packet, saddr, daddr, PROT_NUMBER, route);
 }
@@ -21,6 +21,7 @@
 #define UDP_L4_PROTOCOL_H
 
 #include "ip-l4-protocol.h"
+#include "udp-header.h"
 
 #include "ns3/packet.h"
 #include "ns3/ptr.h"
@@ -221,6 +222,34 @@ class UdpL4Protocol : public IpL4Protocol
               uint16_t sport,
               uint16_t dport,
               Ptr<Ipv4Route> route);
+    /**
+     * \brief Build the UDP header of the packets sent between two endpoints (IPv4)
+     *
+     * The header can be reused to send all the packets with the same addresses
+     * and ports.
+     * \param saddr The source Ipv4Address
+     * \param daddr The destination Ipv4Address
+     * \param sport The source port number
+     * \param dport The destination port number
+     * \return the UDP header
+     */
+    static UdpHeader MakeHeader(Ipv4Address saddr,
+                                Ipv4Address daddr,
+                                uint16_t sport,
+                                uint16_t dport);
+    /**
+     * \brief Send a packet via UDP (IPv4) with a prebuilt UDP header
+     * \param packet The packet to send
+     * \param header The UDP header, built by MakeHeader with the same addresses
+     * \param saddr The source Ipv4Address
+     * \param daddr The destination Ipv4Address
+     * \param route The route
+     */
+    void Send(Ptr<Packet> packet,
+              const UdpHeader& header,
+              Ipv4Address saddr,
+              Ipv4Address daddr,
+              Ptr<Ipv4Route> route);
     /**
      * \brief Send a packet via UDP (IPv6)
      * \param packet The packet to send
@@ -21,6 +21,7 @@
 
 #include "ipv4-end-point.h"
 #include "ipv4-header.h"
+#include "ipv4-l3-protocol.h"
 #include "ipv4-packet-info-tag.h"
 #include "ipv4-route.h"
 #include "ipv4-routing-protocol.h"
@@ -543,8 +544,6 @@ UdpSocketImpl::DoSendTo(Ptr<Packet> p, Ipv4Address dest, uint16_t port, uint8_t
         p->ReplacePacketTag(priorityTag);
     }
 
-    Ptr<Ipv4> ipv4 = m_node->GetObject<Ipv4>();
-
     // Locally override the IP TTL for this socket
     // We cannot directly modify the TTL at this stage, so we set a Packet tag
     // The destination can be either multicast, unicast/anycast, or
@@ -586,6 +585,7 @@ UdpSocketImpl::DoSendTo(Ptr<Packet> p, Ipv4Address dest, uint16_t port, uint8_t
     // out of the "default" interface; here we send it out all interfaces
     if (dest.IsBroadcast())
     {
+        Ptr<Ipv4> ipv4 = m_node->GetObject<Ipv4>();
         if (!m_allowBroadcast)
         {
             m_errno = ERROR_OPNOTSUPP;
@@ -629,7 +629,7 @@ UdpSocketImpl::DoSendTo(Ptr<Packet> p, Ipv4Address dest, uint16_t port, uint8_t
         NotifySend(GetTxAvailable());
         return p->GetSize();
     }
-    else if (ipv4->GetRoutingProtocol())
+    else if (Ptr<Ipv4> ipv4 = m_node->GetObject<Ipv4>(); ipv4->GetRoutingProtocol())
     {
         Ipv4Header header;
         header.SetDestination(dest);
@@ -637,34 +637,58 @@ UdpSocketImpl::DoSendTo(Ptr<Packet> p, Ipv4Address dest, uint16_t port, uint8_t
         Socket::SocketErrno errno_;
         Ptr<Ipv4Route> route;
         Ptr<NetDevice> oif = m_boundnetdevice; // specify non-zero if bound to a specific device
-        // TBD-- we could cache the route and just check its validity
-        route = ipv4->GetRoutingProtocol()->RouteOutput(p, header, oif, errno_);
+        // Ipv4L3Protocol caches the route when the routing protocol allows it
+        Ptr<Ipv4L3Protocol> ipv4L3 = DynamicCast<Ipv4L3Protocol>(ipv4);
+        route = ipv4L3 ? ipv4L3->RouteOutput(p, header, oif, errno_)
+                       : ipv4->GetRoutingProtocol()->RouteOutput(p, header, oif, errno_);
         if (route)
         {
             NS_LOG_LOGIC("Route exists");
-            if (!m_allowBroadcast)
+            if (route == m_cachedRoute && dest == m_cachedDestination &&
+                port == m_cachedHeader.GetDestinationPort() &&
+                m_endPoint->GetLocalPort() == m_cachedHeader.GetSourcePort())
+            {
+                // Ipv4L3Protocol returned the same cached route as for the
+                // previous datagram: the destination is still unicast, and the
+                // source address and the UDP header are unchanged
+                NS_LOG_LOGIC("Cached route exists");
+                m_udp->Send(p->Copy(), m_cachedHeader, route->GetSource(), dest, route);
+                NotifyDataSent(p->GetSize());
+                return p->GetSize();
+            }
+
+            // Here we try to route subnet-directed broadcasts
+            bool subnetBroadcast = false;
+            uint32_t outputIfIndex = ipv4->GetInterfaceForDevice(route->GetOutputDevice());
+            uint32_t ifNAddr = ipv4->GetNAddresses(outputIfIndex);
+            for (uint32_t addrI = 0; addrI < ifNAddr; ++addrI)
             {
-                // Here we try to route subnet-directed broadcasts
-                uint32_t outputIfIndex = ipv4->GetInterfaceForDevice(route->GetOutputDevice());
-                uint32_t ifNAddr = ipv4->GetNAddresses(outputIfIndex);
-                for (uint32_t addrI = 0; addrI < ifNAddr; ++addrI)
+                Ipv4InterfaceAddress ifAddr = ipv4->GetAddress(outputIfIndex, addrI);
+                if (dest == ifAddr.GetBroadcast())
                 {
-                    Ipv4InterfaceAddress ifAddr = ipv4->GetAddress(outputIfIndex, addrI);
-                    if (dest == ifAddr.GetBroadcast())
-                    {
-                        m_errno = ERROR_OPNOTSUPP;
-                        return -1;
-                    }
+                    subnetBroadcast = true;
+                    break;
                 }
             }
+            if (subnetBroadcast && !m_allowBroadcast)
+            {
+                m_errno = ERROR_OPNOTSUPP;
+                return -1;
+            }
 
             header.SetSource(route->GetSource());
-            m_udp->Send(p->Copy(),
-                        header.GetSource(),
-                        header.GetDestination(),
-                        m_endPoint->GetLocalPort(),
-                        port,
-                        route);
+            UdpHeader udpHeader = UdpL4Protocol::MakeHeader(header.GetSource(),
+                                                            header.GetDestination(),
+                                                            m_endPoint->GetLocalPort(),
+                                                            port);
+            if (!subnetBroadcast && !dest.IsMulticast() && ipv4L3 && ipv4L3->IsRouteCacheEnabled())
+            {
+                // keep the header for the next datagrams to the same unicast destination
+                m_cachedRoute = route;
+                m_cachedDestination = dest;
+                m_cachedHeader = udpHeader;
+            }
+            m_udp->Send(p->Copy(), udpHeader, header.GetSource(), header.GetDestination(), route);
             NotifyDataSent(p->GetSize());
             return p->GetSize();
         }
@@ -979,6 +1003,7 @@ UdpSocketImpl::BindToNetDevice(Ptr<NetDevice> netdevice)
     Ptr<NetDevice> oldBoundNetDevice = m_boundnetdevice;
 
     Socket::BindToNetDevice(netdevice); // Includes sanity check
+    m_cachedRoute = nullptr;
     if (m_endPoint != nullptr)
     {
         m_endPoint->BindToNetDevice(netdevice);
@@ -1065,8 +1090,7 @@ UdpSocketImpl::ForwardUp(Ptr<Packet> packet,
 
     if ((m_rxAvailable + packet->GetSize()) <= m_rcvBufSize)
     {
-        Address address = InetSocketAddress(header.GetSource(), port);
-        m_deliveryQueue.emplace(packet, address);
+        m_deliveryQueue.emplace(packet, InetSocketAddress(header.GetSource(), port));
         m_rxAvailable += packet->GetSize();
         NotifyDataRecv();
     }
@@ -1239,6 +1263,7 @@ bool
 UdpSocketImpl::SetAllowBroadcast(bool allowBroadcast)
 {
     m_allowBroadcast = allowBroadcast;
+    m_cachedRoute = nullptr;
     return true;
 }
 
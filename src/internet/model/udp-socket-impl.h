@@ -21,6 +21,7 @@
 
 #include "icmpv4.h"
 #include "ipv4-interface.h"
+#include "udp-header.h"
 #include "udp-socket.h"
 
 #include "ns3/callback.h"
@@ -36,6 +37,7 @@ namespace ns3
 {
 
 class Ipv4EndPoint;
+class Ipv4Route;
 class Ipv6EndPoint;
 class Node;
 class Packet;
@@ -268,6 +270,12 @@ class UdpSocketImpl : public UdpSocket
     bool m_connected;            //!< Connection established
     bool m_allowBroadcast;       //!< Allow send broadcast packets
 
+    // UDP header of the last unicast IPv4 destination, reused while
+    // Ipv4L3Protocol returns the same cached route to it
+    Ptr<Ipv4Route> m_cachedRoute;    //!< Cached route, or nullptr
+    Ipv4Address m_cachedDestination; //!< Destination of the cached route
+    UdpHeader m_cachedHeader;        //!< UDP header of the datagrams to the cached destination
+
     std::queue<std::pair<Ptr<Packet>, Address>> m_deliveryQueue; //!< Queue for incoming packets
     uint32_t m_rxAvailable; //!< Number of available bytes to be received
 
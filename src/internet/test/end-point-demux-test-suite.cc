@@ -0,0 +1,306 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/test.h"
+
+#include <set>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv4EndPointDemux lookups with listening and connected endpoints.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+  public:
+    Ipv4EndPointDemuxTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Look up the endpoint receiving a packet.
+     * \param demux the demux
+     * \param daddr destination address
+     * \param dport destination port
+     * \param saddr source address
+     * \param sport source port
+     * \return the endpoint found, or nullptr
+     */
+    Ipv4EndPoint* Lookup(Ipv4EndPointDemux& demux,
+                         Ipv4Address daddr,
+                         uint16_t dport,
+                         Ipv4Address saddr,
+                         uint16_t sport);
+
+    Ptr<Ipv4Interface> m_interface; //!< the incoming interface
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase()
+    : TestCase("Ipv4EndPointDemux lookups")
+{
+}
+
+Ipv4EndPoint*
+Ipv4EndPointDemuxTestCase::Lookup(Ipv4EndPointDemux& demux,
+                                  Ipv4Address daddr,
+                                  uint16_t dport,
+                                  Ipv4Address saddr,
+                                  uint16_t sport)
+{
+    Ipv4EndPointDemux::EndPoints endPoints =
+        demux.Lookup(daddr, dport, saddr, sport, m_interface);
+    return endPoints.empty() ? nullptr : endPoints.front();
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun()
+{
+    m_interface = CreateObject<Ipv4Interface>();
+    Ipv4Address server("10.0.0.1");
+    Ipv4Address other("10.0.0.2");
+    Ipv4Address client("10.1.0.1");
+    Ipv4EndPointDemux demux;
+
+    Ipv4EndPoint* any = demux.Allocate(nullptr, 80);
+    Ipv4EndPoint* listening = demux.Allocate(nullptr, server, 80);
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate(nullptr, server, 80),
+                          nullptr,
+                          "Duplicated endpoints must be refused");
+    NS_TEST_ASSERT_MSG_EQ(Lookup(demux, server, 80, client, 1000),
+                          listening,
+                          "The endpoint bound to the address must be preferred");
+    NS_TEST_ASSERT_MSG_EQ(Lookup(demux, other, 80, client, 1000),
+                          any,
+                          "The endpoint bound to any address must match");
+    NS_TEST_ASSERT_MSG_EQ(Lookup(demux, server, 81, client, 1000),
+                          nullptr,
+                          "No endpoint is bound to the port");
+
+    // connections accepted by the listening endpoint
+    std::vector<Ipv4EndPoint*> connected;
+    for (uint16_t port = 1000; port < 1100; port++)
+    {
+        connected.push_back(demux.Allocate(nullptr, server, 80, client, port));
+    }
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate(nullptr, server, 80, client, 1000),
+                          nullptr,
+                          "Duplicated connections must be refused");
+    for (uint16_t port = 1000; port < 1100; port++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(Lookup(demux, server, 80, client, port),
+                              connected[port - 1000],
+                              "The connected endpoint must be preferred");
+        NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(server, 80, client, port),
+                              connected[port - 1000],
+                              "The connected endpoint must be an exact match");
+    }
+    NS_TEST_ASSERT_MSG_EQ(Lookup(demux, server, 80, client, 2000),
+                          listening,
+                          "The listening endpoint must match the other peers");
+    connected[0]->SetRxEnabled(false);
+    NS_TEST_ASSERT_MSG_EQ(Lookup(demux, server, 80, client, 1000),
+                          listening,
+                          "An endpoint which can not receive must be skipped");
+
+    // a connection from an ephemeral port, whose peer is set afterwards
+    Ipv4EndPoint* outgoing = demux.Allocate(server);
+    NS_TEST_ASSERT_MSG_NE(outgoing, nullptr, "An ephemeral port must be allocated");
+    uint16_t ephemeral = outgoing->GetLocalPort();
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupPortLocal(ephemeral), true, "The port must be in use");
+    outgoing->SetPeer(client, 80);
+    NS_TEST_ASSERT_MSG_EQ(Lookup(demux, server, ephemeral, client, 80),
+                          outgoing,
+                          "The endpoint must be found after its peer is set");
+    NS_TEST_ASSERT_MSG_EQ(Lookup(demux, server, ephemeral, other, 80),
+                          nullptr,
+                          "The endpoint must not match another peer");
+
+    // the ephemeral ports in use are not allocated again
+    std::set<uint16_t> ports{ephemeral};
+    std::vector<Ipv4EndPoint*> clients;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        clients.push_back(demux.Allocate());
+        NS_TEST_ASSERT_MSG_EQ(ports.insert(clients.back()->GetLocalPort()).second,
+                              true,
+                              "Ephemeral ports must be unique");
+    }
+    for (const auto endPoint : clients)
+    {
+        demux.DeAllocate(endPoint);
+    }
+
+    // the connected endpoints are found by the local address and port
+    demux.DeAllocate(listening);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupLocal(nullptr, server, 80),
+                          true,
+                          "The connected endpoints are bound to the address and port");
+    NS_TEST_ASSERT_MSG_EQ(Lookup(demux, server, 80, client, 2000),
+                          any,
+                          "The endpoint bound to any address must match the other peers");
+    for (const auto endPoint : connected)
+    {
+        demux.DeAllocate(endPoint);
+    }
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupLocal(nullptr, server, 80),
+                          false,
+                          "No endpoint is bound to the address any more");
+    demux.DeAllocate(any);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupPortLocal(80), false, "The port must be free");
+    NS_TEST_ASSERT_MSG_EQ(demux.GetAllEndPoints().size(), 1U, "Only one endpoint must remain");
+    NS_TEST_ASSERT_MSG_EQ(demux.GetAllEndPoints().front(), outgoing, "Wrong remaining endpoint");
+    m_interface = nullptr;
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv6EndPointDemux lookups with listening and connected endpoints.
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+  public:
+    Ipv6EndPointDemuxTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Look up the endpoint receiving a packet.
+     * \param demux the demux
+     * \param daddr destination address
+     * \param dport destination port
+     * \param saddr source address
+     * \param sport source port
+     * \return the endpoint found, or nullptr
+     */
+    Ipv6EndPoint* Lookup(Ipv6EndPointDemux& demux,
+                         Ipv6Address daddr,
+                         uint16_t dport,
+                         Ipv6Address saddr,
+                         uint16_t sport);
+
+    Ptr<Ipv6Interface> m_interface; //!< the incoming interface
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase()
+    : TestCase("Ipv6EndPointDemux lookups")
+{
+}
+
+Ipv6EndPoint*
+Ipv6EndPointDemuxTestCase::Lookup(Ipv6EndPointDemux& demux,
+                                  Ipv6Address daddr,
+                                  uint16_t dport,
+                                  Ipv6Address saddr,
+                                  uint16_t sport)
+{
+    Ipv6EndPointDemux::EndPoints endPoints =
+        demux.Lookup(daddr, dport, saddr, sport, m_interface);
+    return endPoints.empty() ? nullptr : endPoints.front();
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun()
+{
+    m_interface = CreateObject<Ipv6Interface>();
+    Ipv6Address server("2001:db8::1");
+    Ipv6Address other("2001:db8::2");
+    Ipv6Address client("2001:db8:1::1");
+    Ipv6EndPointDemux demux;
+
+    Ipv6EndPoint* any = demux.Allocate(nullptr, 80);
+    Ipv6EndPoint* listening = demux.Allocate(nullptr, server, 80);
+    NS_TEST_ASSERT_MSG_EQ(Lookup(demux, server, 80, client, 1000),
+                          listening,
+                          "The endpoint bound to the address must be preferred");
+    NS_TEST_ASSERT_MSG_EQ(Lookup(demux, other, 80, client, 1000),
+                          any,
+                          "The endpoint bound to any address must match");
+
+    std::vector<Ipv6EndPoint*> connected;
+    for (uint16_t port = 1000; port < 1100; port++)
+    {
+        connected.push_back(demux.Allocate(nullptr, server, 80, client, port));
+    }
+    NS_TEST_ASSERT_MSG_EQ(demux.Allocate(nullptr, server, 80, client, 1000),
+                          nullptr,
+                          "Duplicated connections must be refused");
+    for (uint16_t port = 1000; port < 1100; port++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(Lookup(demux, server, 80, client, port),
+                              connected[port - 1000],
+                              "The connected endpoint must be preferred");
+        NS_TEST_ASSERT_MSG_EQ(demux.SimpleLookup(server, 80, client, port),
+                              connected[port - 1000],
+                              "The connected endpoint must be an exact match");
+    }
+    NS_TEST_ASSERT_MSG_EQ(Lookup(demux, server, 80, client, 2000),
+                          listening,
+                          "The listening endpoint must match the other peers");
+
+    Ipv6EndPoint* outgoing = demux.Allocate(server);
+    NS_TEST_ASSERT_MSG_NE(outgoing, nullptr, "An ephemeral port must be allocated");
+    uint16_t ephemeral = outgoing->GetLocalPort();
+    outgoing->SetPeer(client, 80);
+    NS_TEST_ASSERT_MSG_EQ(Lookup(demux, server, ephemeral, client, 80),
+                          outgoing,
+                          "The endpoint must be found after its peer is set");
+
+    demux.DeAllocate(listening);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupLocal(nullptr, server, 80),
+                          true,
+                          "The connected endpoints are bound to the address and port");
+    for (const auto endPoint : connected)
+    {
+        demux.DeAllocate(endPoint);
+    }
+    NS_TEST_ASSERT_MSG_EQ(Lookup(demux, server, 80, client, 1000),
+                          any,
+                          "The endpoint bound to any address must match");
+    demux.DeAllocate(any);
+    NS_TEST_ASSERT_MSG_EQ(demux.LookupPortLocal(80), false, "The port must be free");
+    NS_TEST_ASSERT_MSG_EQ(demux.GetEndPoints().size(), 1U, "Only one endpoint must remain");
+    m_interface = nullptr;
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv4EndPointDemux and Ipv6EndPointDemux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+  public:
+    EndPointDemuxTestSuite();
+};
+
+EndPointDemuxTestSuite::EndPointDemuxTestSuite()
+    : TestSuite("end-point-demux", Type::UNIT)
+{
+    AddTestCase(new Ipv4EndPointDemuxTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new Ipv6EndPointDemuxTestCase, TestCase::Duration::QUICK);
+}
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
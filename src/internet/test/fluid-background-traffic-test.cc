@@ -0,0 +1,495 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/codel-queue-disc.h"
+#include "ns3/data-rate.h"
+#include "ns3/enum.h"
+#include "ns3/fluid-background-traffic.h"
+#include "ns3/fq-codel-queue-disc.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/node-container.h"
+#include "ns3/queue-disc.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/test.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/udp-socket-factory.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the max-min fair shares of the fluid background traffic.
+ *
+ * On a chain A - B - C of 10 Mbps and 2 Mbps, two flows from A to C share
+ * the 2 Mbps link, and three flows from A to B share the 8 Mbps left on the
+ * first link. The devices must be slowed down by the background rates while
+ * the model runs, and restored when it stops.
+ */
+class FluidBackgroundMaxMinTestCase : public TestCase
+{
+  public:
+    FluidBackgroundMaxMinTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+FluidBackgroundMaxMinTestCase::FluidBackgroundMaxMinTestCase()
+    : TestCase("Max-min fair shares of the fluid background traffic")
+{
+}
+
+void
+FluidBackgroundMaxMinTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(3);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    simpleHelper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(5)));
+    simpleHelper.SetDeviceAttribute("DataRate", DataRateValue(DataRate("10Mbps")));
+    NetDeviceContainer devicesAB = simpleHelper.Install(NodeContainer(nodes.Get(0), nodes.Get(1)));
+    simpleHelper.SetDeviceAttribute("DataRate", DataRateValue(DataRate("2Mbps")));
+    NetDeviceContainer devicesBC = simpleHelper.Install(NodeContainer(nodes.Get(1), nodes.Get(2)));
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfacesAB = ipv4.Assign(devicesAB);
+    ipv4.SetBase("10.0.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfacesBC = ipv4.Assign(devicesBC);
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    Ptr<FluidBackgroundTraffic> background = CreateObject<FluidBackgroundTraffic>();
+    background->SetAttribute("Model", EnumValue(FluidBackgroundTraffic::MAX_MIN));
+    uint32_t toC = background->AddFlows(nodes.Get(0), interfacesBC.GetAddress(1), 2);
+    uint32_t toB = background->AddFlows(nodes.Get(0), interfacesAB.GetAddress(1), 3);
+    background->Start(Seconds(0));
+    background->Stop(Seconds(2));
+
+    DataRateValue runningRateAB;
+    DataRateValue runningRateBC;
+    Simulator::Schedule(Seconds(1), [&]() {
+        NS_TEST_EXPECT_MSG_EQ_TOL(background->GetFlowRate(toC).GetBitRate(),
+                                  1e6,
+                                  1e3,
+                                  "Wrong share of the 2 Mbps link");
+        NS_TEST_EXPECT_MSG_EQ_TOL(background->GetFlowRate(toB).GetBitRate(),
+                                  8e6 / 3,
+                                  1e3,
+                                  "Wrong share of the 8 Mbps left on the 10 Mbps link");
+        NS_TEST_EXPECT_MSG_EQ_TOL(background->GetBackgroundRate(devicesAB.Get(0)).GetBitRate(),
+                                  10e6,
+                                  1e3,
+                                  "The 10 Mbps link is not saturated");
+        NS_TEST_EXPECT_MSG_EQ(background->GetBackgroundRate(devicesAB.Get(1)).GetBitRate(),
+                              0,
+                              "No flow goes from B to A");
+        NS_TEST_EXPECT_MSG_EQ(background->GetQueueDelay(devicesBC.Get(0)),
+                              Time(0),
+                              "No queue in the max-min model");
+        devicesAB.Get(0)->GetAttribute("DataRate", runningRateAB);
+        devicesBC.Get(0)->GetAttribute("DataRate", runningRateBC);
+    });
+    Simulator::Stop(Seconds(3));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ_TOL(runningRateAB.Get().GetBitRate(),
+                              0.5e6,
+                              1e3,
+                              "The foreground should get the minimum share of the 10 Mbps link");
+    NS_TEST_EXPECT_MSG_EQ_TOL(runningRateBC.Get().GetBitRate(),
+                              0.1e6,
+                              1e3,
+                              "The foreground should get the minimum share of the 2 Mbps link");
+    DataRateValue rate;
+    devicesAB.Get(0)->GetAttribute("DataRate", rate);
+    NS_TEST_EXPECT_MSG_EQ(rate.Get(), DataRate("10Mbps"), "The 10 Mbps link is not restored");
+    devicesBC.Get(0)->GetAttribute("DataRate", rate);
+    NS_TEST_EXPECT_MSG_EQ(rate.Get(), DataRate("2Mbps"), "The 2 Mbps link is not restored");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the Reno fluid model on a bottleneck shared with foreground packets.
+ *
+ * Twenty background flows cross a 10 Mbps link with a buffer of 100
+ * segments, which a UDP flow crosses as well. The background flows must use
+ * the capacity left by the UDP flow, and the UDP packets must be delayed by
+ * the background queue and dropped with its loss probability.
+ */
+class FluidBackgroundRenoTestCase : public TestCase
+{
+  public:
+    FluidBackgroundRenoTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Send a UDP packet carrying its sending time.
+     * \param socket The sending socket.
+     */
+    void Send(Ptr<Socket> socket);
+    /**
+     * \brief Receive the UDP packets.
+     * \param socket The receiving socket.
+     */
+    void Recv(Ptr<Socket> socket);
+    /// Sample the state of the bottleneck
+    void Sample();
+
+    Ptr<FluidBackgroundTraffic> m_background; //!< The background traffic
+    Ptr<NetDevice> m_bottleneck;              //!< The device sending on the bottleneck
+    uint32_t m_sent{0};                       //!< UDP packets sent
+    uint32_t m_received{0};                   //!< UDP packets received
+    Time m_delay;                             //!< Total one-way delay of the UDP packets
+    uint32_t m_samples{0};                    //!< Samples of the bottleneck
+    double m_backgroundRate{0};               //!< Total background rate sampled (bit/s)
+    Time m_queueDelay;                        //!< Total queueing delay sampled
+    Time m_maxQueueDelay;                     //!< Maximum queueing delay sampled
+    double m_maxLoss{0};                      //!< Maximum loss probability sampled
+};
+
+FluidBackgroundRenoTestCase::FluidBackgroundRenoTestCase()
+    : TestCase("Reno fluid model on a bottleneck shared with foreground packets")
+{
+}
+
+void
+FluidBackgroundRenoTestCase::Send(Ptr<Socket> socket)
+{
+    int64_t now = Simulator::Now().GetTimeStep();
+    uint8_t payload[500] = {};
+    std::memcpy(payload, &now, sizeof(now));
+    socket->Send(Create<Packet>(payload, sizeof(payload)));
+    m_sent++;
+    Simulator::Schedule(MilliSeconds(10), &FluidBackgroundRenoTestCase::Send, this, socket);
+}
+
+void
+FluidBackgroundRenoTestCase::Recv(Ptr<Socket> socket)
+{
+    while (Ptr<Packet> packet = socket->Recv())
+    {
+        int64_t sent;
+        packet->CopyData(reinterpret_cast<uint8_t*>(&sent), sizeof(sent));
+        m_delay += Simulator::Now() - Time(sent);
+        m_received++;
+    }
+}
+
+void
+FluidBackgroundRenoTestCase::Sample()
+{
+    m_samples++;
+    m_backgroundRate += m_background->GetBackgroundRate(m_bottleneck).GetBitRate();
+    Time queueDelay = m_background->GetQueueDelay(m_bottleneck);
+    m_queueDelay += queueDelay;
+    m_maxQueueDelay = Max(m_maxQueueDelay, queueDelay);
+    m_maxLoss = std::max(m_maxLoss, m_background->GetLossProbability(m_bottleneck));
+    Simulator::Schedule(MilliSeconds(10), &FluidBackgroundRenoTestCase::Sample, this);
+}
+
+void
+FluidBackgroundRenoTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    simpleHelper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(10)));
+    simpleHelper.SetDeviceAttribute("DataRate", DataRateValue(DataRate("10Mbps")));
+    NetDeviceContainer devices = simpleHelper.Install(nodes);
+    m_bottleneck = devices.Get(0);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    // the time held in the root queue disc counts as sojourn time for an AQM
+    TrafficControlHelper tch;
+    tch.SetRootQueueDisc("ns3::FifoQueueDisc");
+    QueueDiscContainer queueDiscs = tch.Install(devices);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    m_background = CreateObject<FluidBackgroundTraffic>();
+    m_background->AddFlows(nodes.Get(0), interfaces.GetAddress(1), 20);
+    m_background->Start(Seconds(0));
+    m_background->Stop(Seconds(30));
+
+    Ptr<Socket> sink = Socket::CreateSocket(nodes.Get(1), UdpSocketFactory::GetTypeId());
+    sink->Bind(InetSocketAddress(Ipv4Address::GetAny(), 9));
+    sink->SetRecvCallback(MakeCallback(&FluidBackgroundRenoTestCase::Recv, this));
+    Ptr<Socket> source = Socket::CreateSocket(nodes.Get(0), UdpSocketFactory::GetTypeId());
+    source->Connect(InetSocketAddress(interfaces.GetAddress(1), 9));
+    Simulator::Schedule(Seconds(10), &FluidBackgroundRenoTestCase::Send, this, source);
+    Simulator::Schedule(Seconds(10), &FluidBackgroundRenoTestCase::Sample, this);
+    Simulator::Stop(Seconds(30));
+    Simulator::Run();
+
+    // 400 kbps of UDP payload, about 430 kbps with the headers, of which the
+    // share lost with the background packets is left to the background
+    double meanRate = m_backgroundRate / m_samples;
+    NS_TEST_EXPECT_MSG_GT(meanRate, 0.9 * (10e6 - 430e3), "The capacity left is not used");
+    NS_TEST_EXPECT_MSG_LT(meanRate, 10e6 - 430e3 / 2, "The background uses the UDP share");
+    Time buffer = DataRate("10Mbps").CalculateBytesTxTime(100 * 1448);
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(m_maxQueueDelay, buffer, "The queue exceeds the buffer");
+    NS_TEST_EXPECT_MSG_GT(m_maxLoss, 0, "No loss with a full buffer");
+
+    uint64_t drops = queueDiscs.Get(0)->GetStats().GetNDroppedPackets(
+        QueueDisc::EXTERNAL_LOAD_DROP);
+    NS_TEST_EXPECT_MSG_GT(drops, 0, "No UDP packet dropped by the background load");
+    NS_TEST_EXPECT_MSG_GT(m_received, m_sent * 9 / 10, "Too many UDP packets lost");
+    Time meanQueueDelay = m_queueDelay / m_samples;
+    NS_TEST_EXPECT_MSG_GT(meanQueueDelay, MilliSeconds(10), "No background queue");
+    NS_TEST_EXPECT_MSG_GT(m_delay / m_received,
+                          MilliSeconds(10) + meanQueueDelay / 2,
+                          "The UDP packets are not delayed by the background queue");
+
+    DataRateValue rate;
+    m_bottleneck->GetAttribute("DataRate", rate);
+    NS_TEST_EXPECT_MSG_EQ(rate.Get(), DataRate("10Mbps"), "The bottleneck is not restored");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the packets held by the default root queue disc for the fluid load.
+ *
+ * The Reno test case above uses a FIFO root queue disc. Here, the default
+ * FqCoDel root queue disc holds the packets of a UDP flow for the queueing
+ * delay of the background flows. Every UDP packet must reach the receiver
+ * intact, with its IPv4 header, unless the queue disc drops it.
+ */
+class FluidBackgroundDefaultQueueDiscTestCase : public TestCase
+{
+  public:
+    FluidBackgroundDefaultQueueDiscTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Send a UDP packet carrying its sending time.
+     * \param socket The sending socket.
+     */
+    void Send(Ptr<Socket> socket);
+    /**
+     * \brief Receive the UDP packets.
+     * \param socket The receiving socket.
+     */
+    void Recv(Ptr<Socket> socket);
+
+    uint32_t m_sent{0};     //!< UDP packets sent
+    uint32_t m_received{0}; //!< UDP packets received intact
+    uint32_t m_damaged{0};  //!< UDP packets received with a wrong size or content
+};
+
+FluidBackgroundDefaultQueueDiscTestCase::FluidBackgroundDefaultQueueDiscTestCase()
+    : TestCase("Packets held by the default root queue disc for the fluid background traffic")
+{
+}
+
+void
+FluidBackgroundDefaultQueueDiscTestCase::Send(Ptr<Socket> socket)
+{
+    int64_t now = Simulator::Now().GetTimeStep();
+    uint8_t payload[500] = {};
+    std::memcpy(payload, &now, sizeof(now));
+    socket->Send(Create<Packet>(payload, sizeof(payload)));
+    m_sent++;
+}
+
+void
+FluidBackgroundDefaultQueueDiscTestCase::Recv(Ptr<Socket> socket)
+{
+    while (Ptr<Packet> packet = socket->Recv())
+    {
+        int64_t sent = 0;
+        packet->CopyData(reinterpret_cast<uint8_t*>(&sent), sizeof(sent));
+        // the packets cross a 10 ms link after the queueing delay
+        if (packet->GetSize() == 500 && Simulator::Now() - Time(sent) >= MilliSeconds(10))
+        {
+            m_received++;
+        }
+        else
+        {
+            m_damaged++;
+        }
+    }
+}
+
+void
+FluidBackgroundDefaultQueueDiscTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    simpleHelper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(10)));
+    simpleHelper.SetDeviceAttribute("DataRate", DataRateValue(DataRate("10Mbps")));
+    NetDeviceContainer devices = simpleHelper.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    // the address helper installs the default root queue disc
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    Ptr<QueueDisc> rootQueueDisc =
+        nodes.Get(0)->GetObject<TrafficControlLayer>()->GetRootQueueDiscOnDevice(devices.Get(0));
+    NS_TEST_ASSERT_MSG_NE(DynamicCast<FqCoDelQueueDisc>(rootQueueDisc),
+                          nullptr,
+                          "The default root queue disc is expected to be FqCoDel");
+
+    Ptr<FluidBackgroundTraffic> background = CreateObject<FluidBackgroundTraffic>();
+    background->AddFlows(nodes.Get(0), interfaces.GetAddress(1), 20);
+    background->Start(Seconds(0));
+    background->Stop(Seconds(30));
+
+    Ptr<Socket> sink = Socket::CreateSocket(nodes.Get(1), UdpSocketFactory::GetTypeId());
+    sink->Bind(InetSocketAddress(Ipv4Address::GetAny(), 9));
+    sink->SetRecvCallback(MakeCallback(&FluidBackgroundDefaultQueueDiscTestCase::Recv, this));
+    Ptr<Socket> source = Socket::CreateSocket(nodes.Get(0), UdpSocketFactory::GetTypeId());
+    source->Connect(InetSocketAddress(interfaces.GetAddress(1), 9));
+    for (Time t = Seconds(10); t < Seconds(25); t += MilliSeconds(10))
+    {
+        Simulator::Schedule(t, &FluidBackgroundDefaultQueueDiscTestCase::Send, this, source);
+    }
+    Simulator::Stop(Seconds(30));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_damaged, 0, "UDP packets were received damaged");
+    NS_TEST_EXPECT_MSG_GT(m_received, 0, "No UDP packet was received");
+    NS_TEST_EXPECT_MSG_EQ(m_received + rootQueueDisc->GetStats().nTotalDroppedPackets,
+                          m_sent,
+                          "The UDP packets not dropped by the queue disc were not all received");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the IPv4 packets held for the external load by a queue disc peeked at.
+ *
+ * A CoDel queue disc, which relies on the base QueueDisc::DoPeek, holds the
+ * IPv4 packets enqueued at 0, 0.2 and 0.4 ms for the 1 ms delay of an
+ * external load, and is peeked at before its last run. Every packet must be
+ * sent 1 ms after it was enqueued, with its IPv4 header.
+ */
+class ExternalLoadIpv4HeaderTestCase : public TestCase
+{
+  public:
+    ExternalLoadIpv4HeaderTestCase();
+
+  private:
+    void DoRun() override;
+
+    std::vector<Time> m_sendTimes; //!< Times the packets were sent to the device
+    uint32_t m_headers{0};         //!< Packets sent with the expected IPv4 header
+};
+
+ExternalLoadIpv4HeaderTestCase::ExternalLoadIpv4HeaderTestCase()
+    : TestCase("IPv4 packets held for the external load keep their header")
+{
+}
+
+void
+ExternalLoadIpv4HeaderTestCase::DoRun()
+{
+    Ptr<QueueDisc> qdisc = CreateObject<CoDelQueueDisc>();
+    qdisc->Initialize();
+    qdisc->SetExternalLoad(0, MilliSeconds(1));
+    qdisc->SetNetDeviceQueueInterface(CreateObject<NetDeviceQueueInterface>());
+    qdisc->SetSendCallback([this](Ptr<QueueDiscItem> item) {
+        m_sendTimes.push_back(Simulator::Now());
+        Ipv4Header header;
+        if (item->GetPacket()->GetSize() == 100 + header.GetSerializedSize() &&
+            item->GetPacket()->PeekHeader(header) &&
+            header.GetDestination() == Ipv4Address("10.0.0.2"))
+        {
+            m_headers++;
+        }
+    });
+
+    for (Time t : {MilliSeconds(0), MicroSeconds(200), MicroSeconds(400)})
+    {
+        Simulator::Schedule(t, [qdisc]() {
+            Ipv4Header header;
+            header.SetSource(Ipv4Address("10.0.0.1"));
+            header.SetDestination(Ipv4Address("10.0.0.2"));
+            header.SetProtocol(17);
+            header.SetPayloadSize(100);
+            qdisc->Enqueue(
+                Create<Ipv4QueueDiscItem>(Create<Packet>(100), Address(), 0x0800, header));
+            qdisc->Run();
+        });
+    }
+    // the peeked packet is kept by the queue disc until it is sent
+    Simulator::Schedule(MicroSeconds(1300), [qdisc]() {
+        qdisc->Peek();
+        qdisc->Run();
+    });
+    Simulator::Run();
+
+    std::vector<Time> expected{MilliSeconds(1), MicroSeconds(1200), MicroSeconds(1400)};
+    NS_TEST_EXPECT_MSG_EQ((m_sendTimes == expected), true, "Unexpected times of sending");
+    NS_TEST_EXPECT_MSG_EQ(m_headers, 3, "Packets were sent without their IPv4 header");
+    NS_TEST_EXPECT_MSG_EQ(qdisc->GetNPackets(), 0, "The queue disc must be empty");
+
+    qdisc->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief TestSuite for the fluid background traffic.
+ */
+class FluidBackgroundTrafficTestSuite : public TestSuite
+{
+  public:
+    FluidBackgroundTrafficTestSuite()
+        : TestSuite("fluid-background-traffic", Type::UNIT)
+    {
+        AddTestCase(new FluidBackgroundMaxMinTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new FluidBackgroundRenoTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new FluidBackgroundDefaultQueueDiscTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new ExternalLoadIpv4HeaderTestCase(), TestCase::Duration::QUICK);
+    }
+};
+
+static FluidBackgroundTrafficTestSuite
+    g_fluidBackgroundTrafficTestSuite; //!< Static variable for test initialization
@@ -22,12 +22,14 @@
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv4-routing-helper.h"
 #include "ns3/ipv4-static-routing.h"
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/simple-channel.h"
+#include "ns3/simple-net-device-helper.h"
 #include "ns3/simple-net-device.h"
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
@@ -36,6 +38,7 @@
 #include "ns3/traffic-control-layer.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
 
 #include <limits>
 #include <string>
@@ -224,6 +227,150 @@ Ipv4ForwardingTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 route cache Test
+ *
+ * A sender sends UDP packets to a receiver through a router: the routes
+ * looked up by the sender and the router are cached, and flushed when the
+ * routes of the router change, but not those of the sender. A full cache
+ * evicts only its oldest route.
+ */
+class Ipv4RouteCacheTest : public TestCase
+{
+    uint32_t m_received; //!< Number of received packets
+
+    /**
+     * \brief Send a packet and run the simulation.
+     * \param socket The sending socket.
+     * \param to Destination address.
+     */
+    void SendData(Ptr<Socket> socket, Ipv4Address to);
+
+    /**
+     * \brief Receive data.
+     * \param socket The receiving socket.
+     */
+    void ReceivePkt(Ptr<Socket> socket);
+
+  public:
+    void DoRun() override;
+    Ipv4RouteCacheTest();
+};
+
+Ipv4RouteCacheTest::Ipv4RouteCacheTest()
+    : TestCase("IPv4 route cache"),
+      m_received(0)
+{
+}
+
+void
+Ipv4RouteCacheTest::ReceivePkt(Ptr<Socket> socket)
+{
+    while (socket->Recv())
+    {
+        m_received++;
+    }
+}
+
+void
+Ipv4RouteCacheTest::SendData(Ptr<Socket> socket, Ipv4Address to)
+{
+    Simulator::ScheduleWithContext(socket->GetNode()->GetId(), Seconds(0), [socket, to]() {
+        socket->SendTo(Create<Packet>(123), 0, InetSocketAddress(to, 1234));
+    });
+    Simulator::Run();
+}
+
+void
+Ipv4RouteCacheTest::DoRun()
+{
+    // sender - router - receiver
+    NodeContainer nodes;
+    nodes.Create(3);
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(nodes);
+    SimpleNetDeviceHelper simpleHelper;
+    NetDeviceContainer txDevices = simpleHelper.Install(NodeContainer(nodes.Get(0), nodes.Get(1)));
+    NetDeviceContainer rxDevices = simpleHelper.Install(NodeContainer(nodes.Get(1), nodes.Get(2)));
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer txInterfaces = ipv4.Assign(txDevices);
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer rxInterfaces = ipv4.Assign(rxDevices);
+    Ipv4RoutingHelper::GetRouting<Ipv4StaticRouting>(
+        nodes.Get(0)->GetObject<Ipv4>()->GetRoutingProtocol())
+        ->SetDefaultRoute(txInterfaces.GetAddress(1), txInterfaces.Get(0).second);
+    Ptr<Ipv4StaticRouting> routerRouting = Ipv4RoutingHelper::GetRouting<Ipv4StaticRouting>(
+        nodes.Get(1)->GetObject<Ipv4>()->GetRoutingProtocol());
+
+    uint32_t hits[2] = {0, 0};
+    uint32_t misses[2] = {0, 0};
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        nodes.Get(i)->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+            "RouteCache",
+            Callback<void, Ipv4Address, bool>(
+                [&hits, &misses, i](Ipv4Address, bool hit) { hit ? hits[i]++ : misses[i]++; }));
+    }
+
+    Ptr<Socket> rxSocket = nodes.Get(2)->GetObject<UdpSocketFactory>()->CreateSocket();
+    NS_TEST_EXPECT_MSG_EQ(rxSocket->Bind(InetSocketAddress(rxInterfaces.GetAddress(1), 1234)),
+                          0,
+                          "trivial");
+    rxSocket->SetRecvCallback(MakeCallback(&Ipv4RouteCacheTest::ReceivePkt, this));
+    Ptr<Socket> txSocket = nodes.Get(0)->GetObject<UdpSocketFactory>()->CreateSocket();
+
+    Ipv4Address destination = rxInterfaces.GetAddress(1);
+    SendData(txSocket, destination);
+    SendData(txSocket, destination);
+    SendData(txSocket, destination);
+    NS_TEST_EXPECT_MSG_EQ(m_received, 3, "Packets not received");
+    NS_TEST_EXPECT_MSG_EQ(misses[0], 1, "The route of the sender was not cached");
+    NS_TEST_EXPECT_MSG_EQ(hits[0], 2, "The cached route of the sender was not used");
+    NS_TEST_EXPECT_MSG_EQ(misses[1], 1, "The route of the router was not cached");
+    NS_TEST_EXPECT_MSG_EQ(hits[1], 2, "The cached route of the router was not used");
+
+    // a host route to a missing gateway takes precedence: the packets are lost
+    routerRouting->AddHostRouteTo(destination, Ipv4Address("10.0.0.3"), rxInterfaces.Get(0).second);
+    SendData(txSocket, destination);
+    NS_TEST_EXPECT_MSG_EQ(m_received, 3, "Stale route used after a route change");
+    NS_TEST_EXPECT_MSG_EQ(misses[1], 2, "Cached routes not flushed after a route change");
+    NS_TEST_EXPECT_MSG_EQ(misses[0], 1, "Routes of the sender flushed by a change of the router");
+
+    routerRouting->RemoveRoute(routerRouting->GetNRoutes() - 1);
+    SendData(txSocket, destination);
+    SendData(txSocket, destination);
+    NS_TEST_EXPECT_MSG_EQ(m_received, 5, "Stale route used after a route removal");
+    NS_TEST_EXPECT_MSG_EQ(misses[1], 3, "Cached routes not flushed after a route removal");
+    NS_TEST_EXPECT_MSG_EQ(hits[1], 3, "The cached route of the router was not used");
+
+    // without cache, the routes are looked up for every packet
+    nodes.Get(1)->GetObject<Ipv4L3Protocol>()->SetAttribute("RouteCacheSize", UintegerValue(0));
+    SendData(txSocket, destination);
+    NS_TEST_EXPECT_MSG_EQ(m_received, 6, "Packet not received without cache");
+    NS_TEST_EXPECT_MSG_EQ(misses[1] + hits[1], 6, "Route cache used while disabled");
+
+    // the sender caches the route to the receiver and to two router addresses
+    nodes.Get(0)->GetObject<Ipv4L3Protocol>()->SetAttribute("RouteCacheSize", UintegerValue(2));
+    uint32_t senderHits = hits[0];
+    uint32_t senderMisses = misses[0];
+    SendData(txSocket, rxInterfaces.GetAddress(0));
+    SendData(txSocket, txInterfaces.GetAddress(1));
+    NS_TEST_EXPECT_MSG_EQ(misses[0], senderMisses + 2, "Routes to the router found in the cache");
+    SendData(txSocket, rxInterfaces.GetAddress(0));
+    NS_TEST_EXPECT_MSG_EQ(hits[0], senderHits + 1, "Newest route evicted from a full cache");
+    SendData(txSocket, destination);
+    NS_TEST_EXPECT_MSG_EQ(misses[0],
+                          senderMisses + 3,
+                          "Oldest route not evicted from a full cache");
+    NS_TEST_EXPECT_MSG_EQ(m_received, 7, "Packet not received after an eviction");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -241,6 +388,7 @@ Ipv4ForwardingTestSuite::Ipv4ForwardingTestSuite()
     : TestSuite("ipv4-forwarding", Type::UNIT)
 {
     AddTestCase(new Ipv4ForwardingTest, TestCase::Duration::QUICK);
+    AddTestCase(new Ipv4RouteCacheTest, TestCase::Duration::QUICK);
 }
 
 static Ipv4ForwardingTestSuite
@@ -50,8 +50,10 @@
 #include <netinet/in.h>
 #endif
 
+#include <algorithm>
 #include <limits>
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -575,6 +577,141 @@ Ipv4FragmentationTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 reassembly of fragments received out of order
+ *
+ * The fragments of two datagrams are handed to the receiver interleaved and
+ * in random order, along with overlapping and duplicate fragments. The
+ * datagram whose fragments all arrive must be delivered once, with its
+ * original content, and the datagram missing a fragment must not.
+ */
+class Ipv4ReassemblyOutOfOrderTest : public TestCase
+{
+  public:
+    Ipv4ReassemblyOutOfOrderTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create a fragment of a datagram.
+     * \param data The payload of the datagram.
+     * \param id The identification of the datagram.
+     * \param offset The offset of the fragment.
+     * \param length The length of the fragment.
+     * \returns The fragment, with its IPv4 header.
+     */
+    Ptr<Packet> CreateFragment(const std::vector<uint8_t>& data,
+                               uint16_t id,
+                               uint32_t offset,
+                               uint32_t length) const;
+
+    Ipv4Address m_source;                       //!< Source of the datagrams.
+    Ipv4Address m_destination;                  //!< Destination of the datagrams.
+    std::vector<Ptr<const Packet>> m_delivered; //!< Datagrams delivered.
+};
+
+Ipv4ReassemblyOutOfOrderTest::Ipv4ReassemblyOutOfOrderTest()
+    : TestCase("Reassembly of fragments received out of order"),
+      m_source("10.0.0.1"),
+      m_destination("10.0.0.2")
+{
+}
+
+Ptr<Packet>
+Ipv4ReassemblyOutOfOrderTest::CreateFragment(const std::vector<uint8_t>& data,
+                                             uint16_t id,
+                                             uint32_t offset,
+                                             uint32_t length) const
+{
+    Ipv4Header header;
+    header.SetSource(m_source);
+    header.SetDestination(m_destination);
+    header.SetProtocol(253);
+    header.SetIdentification(id);
+    header.SetTtl(64);
+    header.SetFragmentOffset(offset);
+    if (offset + length < data.size())
+    {
+        header.SetMoreFragments();
+    }
+    else
+    {
+        header.SetLastFragment();
+    }
+    header.SetPayloadSize(length);
+    Ptr<Packet> fragment = Create<Packet>(data.data() + offset, length);
+    fragment->AddHeader(header);
+    return fragment;
+}
+
+void
+Ipv4ReassemblyOutOfOrderTest::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+    device->SetAddress(Mac48Address::ConvertFrom(Mac48Address::Allocate()));
+    node->AddDevice(device);
+    InternetStackHelper internet;
+    internet.Install(node);
+    Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol>();
+    uint32_t interface = ipv4->AddInterface(device);
+    ipv4->AddAddress(interface, Ipv4InterfaceAddress(m_destination, Ipv4Mask("255.255.255.0")));
+    ipv4->SetUp(interface);
+    ipv4->TraceConnectWithoutContext(
+        "LocalDeliver",
+        Callback<void, const Ipv4Header&, Ptr<const Packet>, uint32_t>(
+            [this](const Ipv4Header&, Ptr<const Packet> p, uint32_t) {
+                m_delivered.push_back(p);
+            }));
+
+    std::vector<uint8_t> data(10000);
+    for (std::size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = i % 251;
+    }
+    std::vector<Ptr<Packet>> fragments;
+    for (uint32_t offset = 0; offset < data.size(); offset += 1480)
+    {
+        uint32_t length = std::min<uint32_t>(1480, data.size() - offset);
+        fragments.push_back(CreateFragment(data, 1, offset, length));
+        // the second datagram misses its third fragment
+        if (offset != 2960)
+        {
+            fragments.push_back(CreateFragment(data, 2, offset, length));
+        }
+    }
+    // overlapping and duplicate fragments
+    fragments.push_back(CreateFragment(data, 1, 1000, 3000));
+    fragments.push_back(CreateFragment(data, 1, 8880, 1120));
+    fragments.push_back(CreateFragment(data, 2, 2000, 960));
+    // a deterministic shuffle
+    for (std::size_t i = 1; i < fragments.size(); i++)
+    {
+        std::swap(fragments[i], fragments[(i * 7) % fragments.size()]);
+    }
+
+    for (const auto& fragment : fragments)
+    {
+        ipv4->Receive(device,
+                      fragment,
+                      Ipv4L3Protocol::PROT_NUMBER,
+                      device->GetBroadcast(),
+                      device->GetAddress(),
+                      NetDevice::PACKET_HOST);
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(m_delivered.size(), 1, "Exactly one datagram must be reassembled");
+    NS_TEST_ASSERT_MSG_EQ(m_delivered[0]->GetSize(), data.size(), "Wrong size of the datagram");
+    std::vector<uint8_t> received(data.size());
+    m_delivered[0]->CopyData(received.data(), received.size());
+    NS_TEST_EXPECT_MSG_EQ((received == data), true, "Wrong content of the datagram");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -591,6 +728,7 @@ Ipv4FragmentationTestSuite::Ipv4FragmentationTestSuite()
 {
     AddTestCase(new Ipv4FragmentationTest(false), TestCase::Duration::QUICK);
     AddTestCase(new Ipv4FragmentationTest(true), TestCase::Duration::QUICK);
+    AddTestCase(new Ipv4ReassemblyOutOfOrderTest(), TestCase::Duration::QUICK);
 }
 
 static Ipv4FragmentationTestSuite
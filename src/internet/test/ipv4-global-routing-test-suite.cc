@@ -16,6 +16,7 @@
 #include "ns3/boolean.h"
 #include "ns3/bridge-helper.h"
 #include "ns3/config.h"
+#include "ns3/global-route-manager.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
@@ -41,6 +42,9 @@
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <sstream>
+#include <string>
 #include <vector>
 
 using namespace ns3;
@@ -1311,6 +1315,173 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting test of the multi-threaded and incremental
+ * computation of the routes.
+ *
+ * A ring of seven routers, with a host attached to one of them, is changed
+ * several times; after each change, the routes recomputed incrementally
+ * must be the same as the routes computed from scratch.
+ */
+class Ipv4GlobalRoutingIncrementalTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingIncrementalTestCase();
+
+  private:
+    void DoRun() override;
+
+    /// The routes of each node, as sorted strings
+    typedef std::vector<std::vector<std::string>> Routes;
+
+    /**
+     * \brief Get the global routes of all the nodes.
+     * \return the routes of each node
+     */
+    Routes GetRoutes() const;
+
+    /**
+     * \brief Recompute the routes incrementally, then from scratch, and
+     * compare them.
+     * \param step the name of the change, for the messages
+     * \return the statistics of the incremental computation
+     */
+    GlobalRouteManager::Statistics CheckRecompute(const std::string& step);
+
+    NodeContainer m_nodes; //!< Nodes used in the test.
+};
+
+Ipv4GlobalRoutingIncrementalTestCase::Ipv4GlobalRoutingIncrementalTestCase()
+    : TestCase("Global routing computed by several threads and incrementally")
+{
+}
+
+Ipv4GlobalRoutingIncrementalTestCase::Routes
+Ipv4GlobalRoutingIncrementalTestCase::GetRoutes() const
+{
+    Routes routes;
+    for (uint32_t i = 0; i < m_nodes.GetN(); i++)
+    {
+        Ptr<Ipv4GlobalRouting> globalRouting =
+            m_nodes.Get(i)->GetObject<Ipv4>()->GetRoutingProtocol()->GetObject<Ipv4GlobalRouting>();
+        std::vector<std::string> nodeRoutes;
+        for (uint32_t j = 0; j < globalRouting->GetNRoutes(); j++)
+        {
+            std::ostringstream oss;
+            oss << *globalRouting->GetRoute(j);
+            nodeRoutes.push_back(oss.str());
+        }
+        std::sort(nodeRoutes.begin(), nodeRoutes.end());
+        routes.push_back(nodeRoutes);
+    }
+    return routes;
+}
+
+GlobalRouteManager::Statistics
+Ipv4GlobalRoutingIncrementalTestCase::CheckRecompute(const std::string& step)
+{
+    Config::SetGlobal("GlobalRoutingIncremental", BooleanValue(true));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    GlobalRouteManager::Statistics statistics = GlobalRouteManager::GetStatistics();
+    Routes incremental = GetRoutes();
+
+    Config::SetGlobal("GlobalRoutingIncremental", BooleanValue(false));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ((GetRoutes() == incremental),
+                          true,
+                          "Incremental routes differ after " << step);
+
+    // compute the routes again with their distances, for the next change
+    Config::SetGlobal("GlobalRoutingIncremental", BooleanValue(true));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    return statistics;
+}
+
+void
+Ipv4GlobalRoutingIncrementalTestCase::DoRun()
+{
+    const uint32_t nRouters = 7;
+    m_nodes.Create(nRouters + 1);
+
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    std::vector<NetDeviceContainer> links;
+    for (uint32_t i = 0; i < nRouters; i++)
+    {
+        Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+        NetDeviceContainer net = simpleHelper.Install(m_nodes.Get(i), channel);
+        net.Add(simpleHelper.Install(m_nodes.Get((i + 1) % nRouters), channel));
+        links.push_back(net);
+    }
+    // a host attached to router 3
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    NetDeviceContainer net = simpleHelper.Install(m_nodes.Get(3), channel);
+    net.Add(simpleHelper.Install(m_nodes.Get(nRouters), channel));
+    links.push_back(net);
+
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(m_nodes);
+
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.252");
+    for (const auto& link : links)
+    {
+        ipv4.Assign(link);
+        ipv4.NewNetwork();
+    }
+
+    // routes calculated by one thread, then by two threads
+    Config::SetGlobal("GlobalRoutingThreads", UintegerValue(1));
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    Routes serial = GetRoutes();
+    Config::SetGlobal("GlobalRoutingThreads", UintegerValue(2));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ((GetRoutes() == serial), true, "Routes differ with two threads");
+    NS_TEST_EXPECT_MSG_EQ(GlobalRouteManager::GetStatistics().nCalculated,
+                          nRouters + 1,
+                          "Wrong number of SPF calculations");
+
+    // no change at all
+    Config::SetGlobal("GlobalRoutingIncremental", BooleanValue(true));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    GlobalRouteManager::Statistics statistics = CheckRecompute("no change");
+    NS_TEST_EXPECT_MSG_EQ(statistics.nCalculated, 0, "No SPF calculation expected");
+    NS_TEST_EXPECT_MSG_EQ(statistics.nUpdated, nRouters + 1, "All routers should be kept");
+
+    // link 0-1 fails: router 4 is at the same distance from both ends
+    Ptr<Ipv4> ipv4Router0 = m_nodes.Get(0)->GetObject<Ipv4>();
+    uint32_t interface = ipv4Router0->GetInterfaceForDevice(links[0].Get(0));
+    ipv4Router0->SetDown(interface);
+    statistics = CheckRecompute("link down");
+    NS_TEST_EXPECT_MSG_GT(statistics.nUpdated, 0, "Some routers should be updated");
+    NS_TEST_EXPECT_MSG_EQ(statistics.nCalculated + statistics.nUpdated,
+                          nRouters + 1,
+                          "Wrong number of routers");
+
+    // link 0-1 is restored
+    ipv4Router0->SetUp(interface);
+    statistics = CheckRecompute("link up");
+    NS_TEST_EXPECT_MSG_GT(statistics.nUpdated, 0, "Some routers should be updated");
+
+    // the metric of link 5-6 changes
+    Ptr<Ipv4> ipv4Router5 = m_nodes.Get(5)->GetObject<Ipv4>();
+    ipv4Router5->SetMetric(ipv4Router5->GetInterfaceForDevice(links[5].Get(0)), 10);
+    CheckRecompute("metric change");
+
+    // the host is disconnected
+    Ptr<Ipv4> ipv4Router3 = m_nodes.Get(3)->GetObject<Ipv4>();
+    ipv4Router3->SetDown(ipv4Router3->GetInterfaceForDevice(links[nRouters].Get(0)));
+    CheckRecompute("host link down");
+
+    Config::SetGlobal("GlobalRoutingIncremental", BooleanValue(false));
+    Config::SetGlobal("GlobalRoutingThreads", UintegerValue(1));
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1333,6 +1504,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite()
     AddTestCase(new TwoBridgeTest, TestCase::Duration::QUICK);
     AddTestCase(new Ipv4DynamicGlobalRoutingTestCase, TestCase::Duration::QUICK);
     AddTestCase(new Ipv4GlobalRoutingSlash32TestCase, TestCase::Duration::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingIncrementalTestCase, TestCase::Duration::QUICK);
 }
 
 static Ipv4GlobalRoutingTestSuite
@@ -20,11 +20,14 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/node-container.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simple-channel.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simple-net-device.h"
@@ -207,6 +210,179 @@ Ipv4StaticRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 StaticRouting longest prefix match Test
+ *
+ * Routes with random prefixes, metrics and interfaces are added to and
+ * removed from a node, and the result of each lookup is compared with the
+ * route selected by a linear scan of the forwarding table.
+ */
+class Ipv4StaticRoutingLongestPrefixMatchTestCase : public TestCase
+{
+  public:
+    Ipv4StaticRoutingLongestPrefixMatchTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Select a route by scanning the forwarding table.
+     * \param routing the static routing protocol
+     * \param ipv4 the Ipv4 of the node
+     * \param dest the destination address
+     * \param oif the output device, if any
+     * \return the index of the selected route, or -1 if none
+     */
+    static int32_t LinearLookup(Ptr<Ipv4StaticRouting> routing,
+                                Ptr<Ipv4> ipv4,
+                                Ipv4Address dest,
+                                Ptr<NetDevice> oif);
+
+    /**
+     * \brief Compare a lookup with the linear scan.
+     * \param routing the static routing protocol
+     * \param ipv4 the Ipv4 of the node
+     * \param dest the destination address
+     * \param oif the output device, if any
+     */
+    void CheckLookup(Ptr<Ipv4StaticRouting> routing,
+                     Ptr<Ipv4> ipv4,
+                     Ipv4Address dest,
+                     Ptr<NetDevice> oif);
+};
+
+Ipv4StaticRoutingLongestPrefixMatchTestCase::Ipv4StaticRoutingLongestPrefixMatchTestCase()
+    : TestCase("Longest prefix match against a linear scan of the routes")
+{
+}
+
+int32_t
+Ipv4StaticRoutingLongestPrefixMatchTestCase::LinearLookup(Ptr<Ipv4StaticRouting> routing,
+                                                          Ptr<Ipv4> ipv4,
+                                                          Ipv4Address dest,
+                                                          Ptr<NetDevice> oif)
+{
+    int32_t selected = -1;
+    uint16_t longestMask = 0;
+    uint32_t shortestMetric = 0xffffffff;
+    for (uint32_t i = 0; i < routing->GetNRoutes(); i++)
+    {
+        Ipv4RoutingTableEntry route = routing->GetRoute(i);
+        uint32_t metric = routing->GetMetric(i);
+        Ipv4Mask mask = route.GetDestNetworkMask();
+        uint16_t maskLen = mask.GetPrefixLength();
+        if (!mask.IsMatch(dest, route.GetDestNetwork()) ||
+            (oif && oif != ipv4->GetNetDevice(route.GetInterface())) || maskLen < longestMask)
+        {
+            continue;
+        }
+        if (maskLen > longestMask)
+        {
+            shortestMetric = 0xffffffff;
+        }
+        longestMask = maskLen;
+        if (metric > shortestMetric)
+        {
+            continue;
+        }
+        shortestMetric = metric;
+        selected = i;
+        if (maskLen == 32)
+        {
+            break;
+        }
+    }
+    return selected;
+}
+
+void
+Ipv4StaticRoutingLongestPrefixMatchTestCase::CheckLookup(Ptr<Ipv4StaticRouting> routing,
+                                                         Ptr<Ipv4> ipv4,
+                                                         Ipv4Address dest,
+                                                         Ptr<NetDevice> oif)
+{
+    Ipv4Header header;
+    header.SetDestination(dest);
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> route = routing->RouteOutput(Create<Packet>(), header, oif, sockerr);
+    int32_t expected = LinearLookup(routing, ipv4, dest, oif);
+    NS_TEST_ASSERT_MSG_EQ(bool(route), (expected >= 0), "Route found for " << dest);
+    if (route)
+    {
+        Ipv4RoutingTableEntry entry = routing->GetRoute(expected);
+        NS_TEST_ASSERT_MSG_EQ(route->GetGateway(), entry.GetGateway(), "Wrong gateway");
+        NS_TEST_ASSERT_MSG_EQ(route->GetOutputDevice(),
+                              ipv4->GetNetDevice(entry.GetInterface()),
+                              "Wrong output device");
+    }
+}
+
+void
+Ipv4StaticRoutingLongestPrefixMatchTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.Install(node);
+    SimpleNetDeviceHelper devHelper;
+    NetDeviceContainer devices;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        devices.Add(devHelper.Install(node));
+    }
+    Ipv4AddressHelper ipv4Helper("192.168.0.0", "255.255.255.0");
+    for (uint32_t i = 0; i < devices.GetN(); i++)
+    {
+        ipv4Helper.Assign(NetDeviceContainer(devices.Get(i)));
+        ipv4Helper.NewNetwork();
+    }
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    Ipv4StaticRoutingHelper ipv4RoutingHelper;
+    Ptr<Ipv4StaticRouting> routing = ipv4RoutingHelper.GetStaticRouting(ipv4);
+
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    // destinations are drawn in 10.0.0.0/16, so that prefixes are nested
+    auto randomAddress = [&rng]() {
+        return Ipv4Address(0x0a000000 | rng->GetInteger(0, 0xff) << 8 |
+                           (rng->GetInteger(0, 3) == 0 ? rng->GetInteger(0, 0xff) : 0));
+    };
+    for (uint32_t step = 0; step < 2000; step++)
+    {
+        if (routing->GetNRoutes() <= 3 || rng->GetInteger(0, 3) != 0)
+        {
+            uint32_t length = rng->GetInteger(0, 32);
+            Ipv4Mask mask(length == 0 ? 0 : 0xffffffff << (32 - length));
+            uint32_t interface = rng->GetInteger(1, 3);
+            Ipv4Address gateway(0xc0a80000 | (interface - 1) << 8 | rng->GetInteger(2, 5));
+            routing->AddNetworkRouteTo(randomAddress().CombineMask(mask),
+                                       mask,
+                                       gateway,
+                                       interface,
+                                       rng->GetInteger(0, 3));
+        }
+        else
+        {
+            routing->RemoveRoute(rng->GetInteger(0, routing->GetNRoutes() - 1));
+        }
+        CheckLookup(routing, ipv4, randomAddress(), nullptr);
+        CheckLookup(routing, ipv4, randomAddress(), devices.Get(rng->GetInteger(0, 2)));
+    }
+
+    // a non-contiguous mask disables the trie lookup
+    routing->AddNetworkRouteTo(Ipv4Address("10.0.0.1"),
+                               Ipv4Mask("255.0.0.255"),
+                               Ipv4Address("192.168.0.2"),
+                               1);
+    for (uint32_t step = 0; step < 200; step++)
+    {
+        CheckLookup(routing, ipv4, randomAddress(), nullptr);
+    }
+    CheckLookup(routing, ipv4, Ipv4Address("10.200.200.1"), nullptr);
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -222,6 +398,7 @@ Ipv4StaticRoutingTestSuite::Ipv4StaticRoutingTestSuite()
     : TestSuite("ipv4-static-routing", Type::UNIT)
 {
     AddTestCase(new Ipv4StaticRoutingSlash32TestCase, TestCase::Duration::QUICK);
+    AddTestCase(new Ipv4StaticRoutingLongestPrefixMatchTestCase, TestCase::Duration::QUICK);
 }
 
 static Ipv4StaticRoutingTestSuite
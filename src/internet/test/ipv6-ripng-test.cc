@@ -39,7 +39,11 @@
 #include "ns3/udp-socket-factory.h"
 
 #include <limits>
+#include <map>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -693,6 +697,203 @@ Ipv6RipngSplitHorizonStrategyTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv6 RIPng Triggered Update Test
+ *
+ * A fake neighbor sends responses to a router, whose triggered updates are
+ * received by a listener on another link. The triggered updates must hold
+ * the RTEs of the routes changed since the previous update, with their
+ * current metric: after a route is learned, after its metric changes and
+ * after it is invalidated. A route deleted while it is waiting to be sent
+ * must not be sent.
+ */
+class Ipv6RipngTriggeredUpdateTest : public TestCase
+{
+  public:
+    Ipv6RipngTriggeredUpdateTest();
+
+  private:
+    /// Prefixes and metrics of the RTEs of a message
+    typedef std::vector<std::pair<Ipv6Address, uint32_t>> Rtes;
+
+    void DoRun() override;
+
+    /**
+     * \brief Send a response from the fake neighbor.
+     * \param socket The sending socket.
+     * \param rtes The RTEs of the response.
+     */
+    void SendResponse(Ptr<Socket> socket, Rtes rtes);
+
+    /**
+     * \brief Receive an update from the router.
+     * \param socket The receiving socket.
+     */
+    void ReceivePkt(Ptr<Socket> socket);
+
+    std::map<Time, Rtes> m_updates; //!< RTEs of the updates, by reception time
+};
+
+Ipv6RipngTriggeredUpdateTest::Ipv6RipngTriggeredUpdateTest()
+    : TestCase("RIPng triggered updates")
+{
+}
+
+void
+Ipv6RipngTriggeredUpdateTest::SendResponse(Ptr<Socket> socket, Rtes rtes)
+{
+    RipNgHeader hdr;
+    hdr.SetCommand(RipNgHeader::RESPONSE);
+    for (const auto& [prefix, metric] : rtes)
+    {
+        RipNgRte rte;
+        rte.SetPrefix(prefix);
+        rte.SetPrefixLen(64);
+        rte.SetRouteMetric(metric);
+        hdr.AddRte(rte);
+    }
+    Ptr<Packet> p = Create<Packet>();
+    // RIPng only accepts the responses of a neighbor on the link
+    SocketIpv6HopLimitTag tag;
+    tag.SetHopLimit(255);
+    p->AddPacketTag(tag);
+    p->AddHeader(hdr);
+    socket->SendTo(p, 0, Inet6SocketAddress(Ipv6Address("ff02::9"), 521));
+}
+
+void
+Ipv6RipngTriggeredUpdateTest::ReceivePkt(Ptr<Socket> socket)
+{
+    Ptr<Packet> packet = socket->Recv();
+    RipNgHeader hdr;
+    packet->RemoveHeader(hdr);
+    Rtes& rtes = m_updates[Simulator::Now()];
+    for (const auto& rte : hdr.GetRteList())
+    {
+        rtes.emplace_back(rte.GetPrefix(), rte.GetRouteMetric());
+    }
+}
+
+void
+Ipv6RipngTriggeredUpdateTest::DoRun()
+{
+    Ptr<Node> fakeNeighbor = CreateObject<Node>();
+    Ptr<Node> router = CreateObject<Node>();
+    Ptr<Node> listener = CreateObject<Node>();
+
+    // fixed delays, so that the contents of each triggered update are known
+    RipNgHelper ripRouting;
+    ripRouting.Set("MinTriggeredCooldown", TimeValue(Seconds(2)));
+    ripRouting.Set("MaxTriggeredCooldown", TimeValue(Seconds(2)));
+    ripRouting.Set("GarbageCollectionDelay", TimeValue(Seconds(1)));
+    ripRouting.Set("UnsolicitedRoutingUpdate", TimeValue(Seconds(100)));
+
+    InternetStackHelper internetRouters;
+    internetRouters.SetRoutingHelper(ripRouting);
+    internetRouters.Install(router);
+
+    InternetStackHelper internetNodes;
+    internetNodes.Install(NodeContainer(fakeNeighbor, listener));
+
+    NetDeviceContainer net0;
+    NetDeviceContainer net1;
+    Ptr<SimpleChannel> channel0 = CreateObject<SimpleChannel>();
+    Ptr<SimpleChannel> channel1 = CreateObject<SimpleChannel>();
+    for (auto [node, channel, net] : {std::make_tuple(fakeNeighbor, channel0, &net0),
+                                      std::make_tuple(router, channel0, &net0),
+                                      std::make_tuple(router, channel1, &net1),
+                                      std::make_tuple(listener, channel1, &net1)})
+    {
+        Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice>();
+        dev->SetAddress(Mac48Address::Allocate());
+        dev->SetChannel(channel);
+        node->AddDevice(dev);
+        net->Add(dev);
+    }
+
+    Ipv6AddressHelper ipv6;
+    ipv6.SetBase(Ipv6Address("2001:1::"), Ipv6Prefix(64));
+    Ipv6InterfaceContainer iic0 = ipv6.Assign(net0);
+    iic0.SetForwarding(1, true);
+    ipv6.SetBase(Ipv6Address("2001:2::"), Ipv6Prefix(64));
+    Ipv6InterfaceContainer iic1 = ipv6.Assign(net1);
+    iic1.SetForwarding(0, true);
+
+    Ptr<Socket> txSocket = fakeNeighbor->GetObject<UdpSocketFactory>()->CreateSocket();
+    txSocket->BindToNetDevice(net0.Get(0));
+    NS_TEST_EXPECT_MSG_EQ(txSocket->Bind(Inet6SocketAddress(iic0.GetLinkLocalAddress(0), 521)),
+                          0,
+                          "trivial");
+
+    Ptr<Socket> rxSocket = listener->GetObject<UdpSocketFactory>()->CreateSocket();
+    rxSocket->BindToNetDevice(net1.Get(1));
+    NS_TEST_EXPECT_MSG_EQ(rxSocket->Bind(Inet6SocketAddress(Ipv6Address("ff02::9"), 521)),
+                          0,
+                          "trivial");
+    rxSocket->SetRecvCallback(MakeCallback(&Ipv6RipngTriggeredUpdateTest::ReceivePkt, this));
+
+    Ipv6Address a("2001:10::");
+    Ipv6Address b("2001:20::");
+    Ipv6Address c("2001:30::");
+    // the scenario starts once the messages sent at startup are over
+    // a and b are learned, then sent at 14 s
+    Simulator::Schedule(Seconds(12),
+                        &Ipv6RipngTriggeredUpdateTest::SendResponse,
+                        this,
+                        txSocket,
+                        Rtes{{a, 1}, {b, 1}});
+    // the metric of a changes and b is invalidated, then both are sent at 18 s
+    Simulator::Schedule(Seconds(16),
+                        &Ipv6RipngTriggeredUpdateTest::SendResponse,
+                        this,
+                        txSocket,
+                        Rtes{{a, 3}});
+    Simulator::Schedule(Seconds(17.5),
+                        &Ipv6RipngTriggeredUpdateTest::SendResponse,
+                        this,
+                        txSocket,
+                        Rtes{{b, 16}});
+    // c is learned, then sent at 22 s
+    Simulator::Schedule(Seconds(20),
+                        &Ipv6RipngTriggeredUpdateTest::SendResponse,
+                        this,
+                        txSocket,
+                        Rtes{{c, 1}});
+    // c is invalidated and deleted at 24 s, before the update at 25 s, which
+    // only holds the new metric of a
+    Simulator::Schedule(Seconds(23),
+                        &Ipv6RipngTriggeredUpdateTest::SendResponse,
+                        this,
+                        txSocket,
+                        Rtes{{c, 16}});
+    Simulator::Schedule(Seconds(23.5),
+                        &Ipv6RipngTriggeredUpdateTest::SendResponse,
+                        this,
+                        txSocket,
+                        Rtes{{a, 2}});
+
+    Simulator::Stop(Seconds(30));
+    Simulator::Run();
+
+    // ignore the messages sent at startup
+    m_updates.erase(m_updates.begin(), m_updates.lower_bound(Seconds(12)));
+    std::map<Time, Rtes> expected{{Seconds(14), {{a, 2}, {b, 2}}},
+                                  {Seconds(18), {{a, 4}, {b, 16}}},
+                                  {Seconds(22), {{c, 2}}},
+                                  {Seconds(25), {{a, 3}}}};
+    NS_TEST_EXPECT_MSG_EQ(m_updates.size(), expected.size(), "Unexpected number of updates");
+    for (const auto& [time, rtes] : expected)
+    {
+        NS_TEST_EXPECT_MSG_EQ((m_updates[time] == rtes),
+                              true,
+                              "Unexpected RTEs in the update at " << time.As(Time::S));
+    }
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -712,6 +913,7 @@ class Ipv6RipngTestSuite : public TestSuite
                     TestCase::Duration::QUICK);
         AddTestCase(new Ipv6RipngSplitHorizonStrategyTest(RipNg::NO_SPLIT_HORIZON),
                     TestCase::Duration::QUICK);
+        AddTestCase(new Ipv6RipngTriggeredUpdateTest, TestCase::Duration::QUICK);
     }
 };
 
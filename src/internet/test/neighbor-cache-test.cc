@@ -1221,6 +1221,167 @@ DynamicPartialTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief Shared Neighbor Cache Test
+ */
+class SharedTableTest : public TestCase
+{
+  public:
+    void DoRun() override;
+    SharedTableTest();
+
+  private:
+    /**
+     * \brief Receive a packet.
+     * \param socket The receiving socket.
+     */
+    void ReceivePkt(Ptr<Socket> socket);
+
+    NodeContainer m_nodes;  //!< Nodes used in the test.
+    uint32_t m_received{0}; //!< Number of packets received.
+};
+
+SharedTableTest::SharedTableTest()
+    : TestCase("The SharedTableTest checks that the interfaces of a channel share one neighbor "
+               "table, used without ARP or NDISC resolution and updated with the addresses.")
+{
+}
+
+void
+SharedTableTest::ReceivePkt(Ptr<Socket> socket)
+{
+    while (socket->Recv())
+    {
+        m_received++;
+    }
+}
+
+void
+SharedTableTest::DoRun()
+{
+    m_nodes.Create(3);
+
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    SimpleNetDeviceHelper simpleHelper;
+    NetDeviceContainer net = simpleHelper.Install(m_nodes, channel);
+
+    InternetStackHelper internet;
+    internet.Install(m_nodes);
+
+    // Setup IPv4 addresses
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer i = ipv4.Assign(net);
+
+    // Setup IPv6 addresses
+    Ipv6AddressHelper ipv6;
+    ipv6.SetBase(Ipv6Address("2001:0::"), Ipv6Prefix(64));
+    Ipv6InterfaceContainer icv6 = ipv6.Assign(net);
+
+    // Populate one shared table per channel, updated by the address changes
+    NeighborCacheHelper neighborCache;
+    neighborCache.SetSharedNeighborCache(true);
+    neighborCache.SetDynamicNeighborCache(true);
+    neighborCache.PopulateNeighborCache();
+
+    std::vector<Ptr<Ipv4Interface>> ipv4Interfaces;
+    std::vector<Ptr<Ipv6Interface>> ipv6Interfaces;
+    for (uint32_t n = 0; n < 3; n++)
+    {
+        ipv4Interfaces.push_back(
+            DynamicCast<Ipv4L3Protocol>(i.Get(n).first)->GetInterface(i.Get(n).second));
+        ipv6Interfaces.push_back(
+            DynamicCast<Ipv6L3Protocol>(icv6.Get(n).first)->GetInterface(icv6.Get(n).second));
+    }
+    Ptr<SharedNeighborTable<Ipv4Address>> ipv4Table =
+        ipv4Interfaces[0]->GetArpCache()->GetSharedTable();
+    Ptr<SharedNeighborTable<Ipv6Address>> ipv6Table =
+        ipv6Interfaces[0]->GetNdiscCache()->GetSharedTable();
+    NS_TEST_ASSERT_MSG_NE(ipv4Table, nullptr, "No shared ARP table.");
+    NS_TEST_ASSERT_MSG_NE(ipv6Table, nullptr, "No shared NDISC table.");
+    for (uint32_t n = 1; n < 3; n++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(ipv4Interfaces[n]->GetArpCache()->GetSharedTable(),
+                              ipv4Table,
+                              "The ARP table is not shared.");
+        NS_TEST_EXPECT_MSG_EQ(ipv6Interfaces[n]->GetNdiscCache()->GetSharedTable(),
+                              ipv6Table,
+                              "The NDISC table is not shared.");
+    }
+    NS_TEST_EXPECT_MSG_EQ(ipv4Table->GetSize(), 3, "Wrong number of IPv4 addresses.");
+    NS_TEST_EXPECT_MSG_EQ(ipv6Table->GetSize(), 6, "Wrong number of IPv6 addresses.");
+
+    std::ostringstream stringStream1v4;
+    Ptr<OutputStreamWrapper> arpStream = Create<OutputStreamWrapper>(&stringStream1v4);
+    std::ostringstream stringStream1v6;
+    Ptr<OutputStreamWrapper> ndiscStream = Create<OutputStreamWrapper>(&stringStream1v6);
+
+    // Print cache.
+    Ipv4RoutingHelper::PrintNeighborCacheAt(Seconds(0), m_nodes.Get(0), arpStream);
+    Ipv6RoutingHelper::PrintNeighborCacheAt(Seconds(0), m_nodes.Get(0), ndiscStream);
+
+    // Send a packet to node 2 over IPv4 and IPv6, then remove the IPv4 address of node 2
+    TypeId tid = TypeId::LookupByName("ns3::UdpSocketFactory");
+    Ptr<Socket> rxSocketv4 = Socket::CreateSocket(m_nodes.Get(2), tid);
+    rxSocketv4->Bind(InetSocketAddress(Ipv4Address::GetAny(), 1234));
+    rxSocketv4->SetRecvCallback(MakeCallback(&SharedTableTest::ReceivePkt, this));
+    Ptr<Socket> rxSocketv6 = Socket::CreateSocket(m_nodes.Get(2), tid);
+    rxSocketv6->Bind(Inet6SocketAddress(Ipv6Address::GetAny(), 1234));
+    rxSocketv6->SetRecvCallback(MakeCallback(&SharedTableTest::ReceivePkt, this));
+    Ptr<Socket> txSocket = Socket::CreateSocket(m_nodes.Get(0), tid);
+    Ipv4Address ipv4Address = i.GetAddress(2);
+    Address ipv4To = InetSocketAddress(ipv4Address, 1234);
+    Address ipv6To = Inet6SocketAddress(icv6.GetAddress(2, 1), 1234);
+    Simulator::Schedule(Seconds(2), [=]() { txSocket->SendTo(Create<Packet>(123), 0, ipv4To); });
+    Simulator::Schedule(Seconds(2), [=]() { txSocket->SendTo(Create<Packet>(123), 0, ipv6To); });
+    Ptr<Ipv4Interface> ipv4Interface = ipv4Interfaces[2];
+    Simulator::Schedule(Seconds(3), [=]() { ipv4Interface->RemoveAddress(0); });
+
+    Simulator::Run();
+
+    // Check if the neighbors are in the shared table, printed as the auto-generated entries
+    constexpr auto arpCache =
+        "ARP Cache of node 0 at time 0\n"
+        "10.1.1.2 dev 0 lladdr 04-06-00:00:00:00:00:02 STATIC_AUTOGENERATED\n"
+        "10.1.1.3 dev 0 lladdr 04-06-00:00:00:00:00:03 STATIC_AUTOGENERATED\n";
+    NS_TEST_EXPECT_MSG_EQ(stringStream1v4.str(), arpCache, "Arp cache is incorrect.");
+
+    constexpr auto NdiscCache =
+        "NDISC Cache of node 0 at time +0s\n"
+        "2001::200:ff:fe00:2 dev 0 lladdr 04-06-00:00:00:00:00:02 STATIC_AUTOGENERATED\n"
+        "2001::200:ff:fe00:3 dev 0 lladdr 04-06-00:00:00:00:00:03 STATIC_AUTOGENERATED\n"
+        "fe80::200:ff:fe00:2 dev 0 lladdr 04-06-00:00:00:00:00:02 STATIC_AUTOGENERATED\n"
+        "fe80::200:ff:fe00:3 dev 0 lladdr 04-06-00:00:00:00:00:03 STATIC_AUTOGENERATED\n";
+    NS_TEST_EXPECT_MSG_EQ(stringStream1v6.str(), NdiscCache, "Ndisc cache is incorrect.");
+
+    // Check that the packets were sent without resolving the addresses
+    NS_TEST_EXPECT_MSG_EQ(m_received, 2, "The packets were not received.");
+    NS_TEST_EXPECT_MSG_EQ(ipv4Interfaces[0]->GetArpCache()->Lookup(ipv4Address),
+                          nullptr,
+                          "An ARP entry was created.");
+    NS_TEST_EXPECT_MSG_EQ(ipv6Interfaces[0]->GetNdiscCache()->Lookup(icv6.GetAddress(2, 1)),
+                          nullptr,
+                          "A NDISC entry was created.");
+
+    // Check if the removed address left the shared table
+    NS_TEST_EXPECT_MSG_EQ(ipv4Table->GetSize(), 2, "The removed address is still in the table.");
+    NS_TEST_EXPECT_MSG_EQ(ipv4Table->Lookup(ipv4Address),
+                          nullptr,
+                          "The removed address is still in the table.");
+
+    // Check that flushing the auto-generated entries removes the shared tables
+    neighborCache.FlushAutoGenerated();
+    NS_TEST_EXPECT_MSG_EQ(ipv4Interfaces[1]->GetArpCache()->GetSharedTable(),
+                          nullptr,
+                          "The shared ARP table was not flushed.");
+    NS_TEST_EXPECT_MSG_EQ(ipv6Interfaces[1]->GetNdiscCache()->GetSharedTable(),
+                          nullptr,
+                          "The shared NDISC table was not flushed.");
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1239,6 +1400,7 @@ class NeighborCacheTestSuite : public TestSuite
         AddTestCase(new FlushTest, TestCase::Duration::QUICK);
         AddTestCase(new DuplicateTest, TestCase::Duration::QUICK);
         AddTestCase(new DynamicPartialTest, TestCase::Duration::QUICK);
+        AddTestCase(new SharedTableTest, TestCase::Duration::QUICK);
     }
 };
 
@@ -0,0 +1,349 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/arp-header.h"
+#include "ns3/arp-queue-disc-item.h"
+#include "ns3/hash.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/ipv6-queue-disc-item.h"
+#include "ns3/rule-table-packet-filter.h"
+#include "ns3/tcp-header.h"
+#include "ns3/test.h"
+#include "ns3/udp-header.h"
+
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Create an IPv4 queue disc item carrying a UDP or TCP segment.
+ * \param src source address
+ * \param dst destination address
+ * \param protocol transport protocol number (6 for TCP, 17 for UDP)
+ * \param sport source port
+ * \param dport destination port
+ * \return the item
+ */
+static Ptr<Ipv4QueueDiscItem>
+CreateIpv4Item(Ipv4Address src, Ipv4Address dst, uint8_t protocol, uint16_t sport, uint16_t dport)
+{
+    Ptr<Packet> p = Create<Packet>(100);
+    if (protocol == 6)
+    {
+        TcpHeader tcp;
+        tcp.SetSourcePort(sport);
+        tcp.SetDestinationPort(dport);
+        p->AddHeader(tcp);
+    }
+    else if (protocol == 17)
+    {
+        UdpHeader udp;
+        udp.SetSourcePort(sport);
+        udp.SetDestinationPort(dport);
+        p->AddHeader(udp);
+    }
+    Ipv4Header header;
+    header.SetSource(src);
+    header.SetDestination(dst);
+    header.SetProtocol(protocol);
+    header.SetPayloadSize(p->GetSize());
+    return Create<Ipv4QueueDiscItem>(p, Address(), 0x0800, header);
+}
+
+/**
+ * Create an IPv6 queue disc item carrying a UDP datagram.
+ * \param src source address
+ * \param dst destination address
+ * \param sport source port
+ * \param dport destination port
+ * \return the item
+ */
+static Ptr<Ipv6QueueDiscItem>
+CreateIpv6Item(Ipv6Address src, Ipv6Address dst, uint16_t sport, uint16_t dport)
+{
+    Ptr<Packet> p = Create<Packet>(100);
+    UdpHeader udp;
+    udp.SetSourcePort(sport);
+    udp.SetDestinationPort(dport);
+    p->AddHeader(udp);
+    Ipv6Header header;
+    header.SetSource(src);
+    header.SetDestination(dst);
+    header.SetNextHeader(17);
+    header.SetPayloadLength(p->GetSize());
+    return Create<Ipv6QueueDiscItem>(p, Address(), 0x86DD, header);
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief The 5-tuple cached by the queue disc items and the hash computed from it.
+ */
+class QueueDiscItemFiveTupleTestCase : public TestCase
+{
+  public:
+    QueueDiscItemFiveTupleTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+QueueDiscItemFiveTupleTestCase::QueueDiscItemFiveTupleTestCase()
+    : TestCase("5-tuple of the queue disc items")
+{
+}
+
+void
+QueueDiscItemFiveTupleTestCase::DoRun()
+{
+    Ptr<Ipv4QueueDiscItem> item =
+        CreateIpv4Item(Ipv4Address("10.0.0.1"), Ipv4Address("10.0.1.2"), 6, 1234, 80);
+    const QueueDiscItem::FiveTuple* tuple = item->GetFiveTuple();
+    NS_TEST_ASSERT_MSG_NE(tuple, nullptr, "An IPv4 packet has a 5-tuple");
+    NS_TEST_ASSERT_MSG_EQ(tuple, item->GetFiveTuple(), "The 5-tuple must be parsed once");
+    NS_TEST_EXPECT_MSG_EQ(+tuple->version, 4, "Unexpected IP version");
+    NS_TEST_EXPECT_MSG_EQ(+tuple->protocol, 6, "Unexpected protocol");
+    NS_TEST_EXPECT_MSG_EQ(tuple->sourcePort, 1234, "Unexpected source port");
+    NS_TEST_EXPECT_MSG_EQ(tuple->destinationPort, 80, "Unexpected destination port");
+    NS_TEST_EXPECT_MSG_EQ(Ipv4Address::Deserialize(tuple->destination),
+                          Ipv4Address("10.0.1.2"),
+                          "Unexpected destination address");
+
+    // the hash is unchanged by the cache: murmur3 of the serialized 5-tuple and perturbation
+    uint8_t buf[17] = {10, 0, 0, 1, 10, 0, 1, 2, 6, 0x04, 0xd2, 0, 80, 0, 0, 0x30, 0x39};
+    uint32_t hash = Hash32((char*)buf, 17);
+    NS_TEST_EXPECT_MSG_EQ(item->Hash(12345), hash, "Unexpected hash of the 5-tuple");
+    NS_TEST_EXPECT_MSG_EQ(item->Hash(12345), hash, "The hash must not change");
+    NS_TEST_EXPECT_MSG_NE(item->Hash(54321), hash, "The hash depends on the perturbation");
+    NS_TEST_EXPECT_MSG_EQ(item->Hash(12345), hash, "The hash must not change");
+
+    // the ports of the non-first fragments are not parsed
+    Ipv4Header header = item->GetHeader();
+    header.SetFragmentOffset(1480);
+    Ptr<Ipv4QueueDiscItem> fragment =
+        Create<Ipv4QueueDiscItem>(Create<Packet>(100), Address(), 0x0800, header);
+    NS_TEST_EXPECT_MSG_EQ(fragment->GetFiveTuple()->sourcePort, 0, "Unexpected source port");
+    NS_TEST_EXPECT_MSG_EQ(fragment->GetFiveTuple()->destinationPort,
+                          0,
+                          "Unexpected destination port");
+
+    Ptr<Ipv6QueueDiscItem> item6 =
+        CreateIpv6Item(Ipv6Address("2001:db8::1"), Ipv6Address("2001:db8::2"), 5000, 53);
+    tuple = item6->GetFiveTuple();
+    NS_TEST_ASSERT_MSG_NE(tuple, nullptr, "An IPv6 packet has a 5-tuple");
+    NS_TEST_EXPECT_MSG_EQ(+tuple->version, 6, "Unexpected IP version");
+    NS_TEST_EXPECT_MSG_EQ(+tuple->protocol, 17, "Unexpected protocol");
+    NS_TEST_EXPECT_MSG_EQ(tuple->sourcePort, 5000, "Unexpected source port");
+    NS_TEST_EXPECT_MSG_EQ(tuple->destinationPort, 53, "Unexpected destination port");
+    NS_TEST_EXPECT_MSG_EQ(Ipv6Address::Deserialize(tuple->source),
+                          Ipv6Address("2001:db8::1"),
+                          "Unexpected source address");
+
+    Ptr<ArpQueueDiscItem> arp =
+        Create<ArpQueueDiscItem>(Create<Packet>(), Address(), 0x0806, ArpHeader());
+    NS_TEST_EXPECT_MSG_EQ(arp->GetFiveTuple(), nullptr, "An ARP packet has no 5-tuple");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Classification of packets by RuleTablePacketFilter.
+ */
+class RuleTablePacketFilterTestCase : public TestCase
+{
+  public:
+    RuleTablePacketFilterTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+RuleTablePacketFilterTestCase::RuleTablePacketFilterTestCase()
+    : TestCase("Classification by RuleTablePacketFilter")
+{
+}
+
+void
+RuleTablePacketFilterTestCase::DoRun()
+{
+    const int32_t ANY = RuleTablePacketFilter::ANY;
+    Ptr<RuleTablePacketFilter> filter = CreateObject<RuleTablePacketFilter>();
+    // rule 0: TCP from 10.0.0.0/24 to port 80
+    filter->AddRule(Ipv4Address("10.0.0.0"),
+                    Ipv4Mask("/24"),
+                    Ipv4Address::GetAny(),
+                    Ipv4Mask::GetZero(),
+                    6,
+                    ANY,
+                    80,
+                    1);
+    // rule 1: anything to 10.0.1.0/24, hidden by rule 0 for TCP packets to port 80
+    filter->AddRule(Ipv4Address::GetAny(),
+                    Ipv4Mask::GetZero(),
+                    Ipv4Address("10.0.1.0"),
+                    Ipv4Mask("/24"),
+                    ANY,
+                    ANY,
+                    ANY,
+                    2);
+    // rule 2: TCP from 10.0.0.0/24 to port 443, in the group of rule 0
+    filter->AddRule(Ipv4Address("10.0.0.0"),
+                    Ipv4Mask("/24"),
+                    Ipv4Address::GetAny(),
+                    Ipv4Mask::GetZero(),
+                    6,
+                    ANY,
+                    443,
+                    3);
+    // rule 3: UDP to 2001:db8::/32 port 53
+    filter->AddRule(Ipv6Address::GetAny(),
+                    Ipv6Prefix(uint8_t(0)),
+                    Ipv6Address("2001:db8::"),
+                    Ipv6Prefix(32),
+                    17,
+                    ANY,
+                    53,
+                    4);
+    NS_TEST_EXPECT_MSG_EQ(filter->GetNRules(), 4, "Unexpected number of rules");
+    NS_TEST_EXPECT_MSG_EQ(filter->GetNRuleGroups(), 3, "Unexpected number of groups of rules");
+
+    Ipv4Address client("10.0.0.7");
+    Ipv4Address server("10.0.1.9");
+    NS_TEST_EXPECT_MSG_EQ(filter->Classify(CreateIpv4Item(client, server, 6, 1000, 80)),
+                          1,
+                          "The first matching rule must win");
+    NS_TEST_EXPECT_MSG_EQ(filter->Classify(CreateIpv4Item(client, server, 17, 1000, 80)),
+                          2,
+                          "Rule 0 only matches TCP packets");
+    NS_TEST_EXPECT_MSG_EQ(filter->Classify(CreateIpv4Item(client, server, 6, 1000, 443)),
+                          2,
+                          "Rule 1 comes before rule 2");
+    NS_TEST_EXPECT_MSG_EQ(
+        filter->Classify(CreateIpv4Item(client, Ipv4Address("10.0.2.9"), 6, 1000, 443)),
+        3,
+        "Rule 2 must match");
+    NS_TEST_EXPECT_MSG_EQ(
+        filter->Classify(CreateIpv4Item(Ipv4Address("10.0.3.7"), Ipv4Address("10.0.2.9"), 6, 1, 8)),
+        PacketFilter::PF_NO_MATCH,
+        "No rule matches");
+    NS_TEST_EXPECT_MSG_EQ(
+        filter->Classify(
+            CreateIpv6Item(Ipv6Address("2001:db9::1"), Ipv6Address("2001:db8:1::1"), 1000, 53)),
+        4,
+        "Rule 3 must match");
+    NS_TEST_EXPECT_MSG_EQ(
+        filter->Classify(
+            CreateIpv6Item(Ipv6Address("2001:db9::1"), Ipv6Address("2001:db9::1"), 1000, 53)),
+        PacketFilter::PF_NO_MATCH,
+        "No rule matches");
+    Ptr<ArpQueueDiscItem> arp =
+        Create<ArpQueueDiscItem>(Create<Packet>(), Address(), 0x0806, ArpHeader());
+    NS_TEST_EXPECT_MSG_EQ(filter->Classify(arp),
+                          PacketFilter::PF_NO_MATCH,
+                          "ARP packets are not classified");
+
+    // random rules and packets, compared to trying the rules in turn
+    struct Rule
+    {
+        uint32_t src;
+        uint32_t srcMask;
+        uint32_t dst;
+        uint32_t dstMask;
+        int32_t protocol;
+        int32_t sport;
+        int32_t dport;
+    };
+
+    std::mt19937 rng(1);
+    auto randomMask = [&rng]() {
+        static const uint32_t lengths[] = {0, 8, 16, 24, 32};
+        uint32_t length = lengths[rng() % 5];
+        return length == 0 ? 0 : ~0U << (32 - length);
+    };
+    filter = CreateObject<RuleTablePacketFilter>();
+    std::vector<Rule> rules;
+    for (int32_t i = 0; i < 500; i++)
+    {
+        Rule rule;
+        rule.srcMask = randomMask();
+        rule.src = (0x0a000000 | (rng() & 0x3ff)) & rule.srcMask;
+        rule.dstMask = randomMask();
+        rule.dst = (0x0a000000 | (rng() & 0x3ff)) & rule.dstMask;
+        rule.protocol = (rng() % 2) ? ANY : (rng() % 2 ? 6 : 17);
+        rule.sport = (rng() % 2) ? ANY : rng() % 4;
+        rule.dport = (rng() % 2) ? ANY : rng() % 4;
+        rules.push_back(rule);
+        filter->AddRule(Ipv4Address(rule.src),
+                        Ipv4Mask(rule.srcMask),
+                        Ipv4Address(rule.dst),
+                        Ipv4Mask(rule.dstMask),
+                        rule.protocol,
+                        rule.sport,
+                        rule.dport,
+                        i);
+    }
+
+    for (uint32_t n = 0; n < 2000; n++)
+    {
+        uint32_t src = 0x0a000000 | (rng() & 0x3ff);
+        uint32_t dst = 0x0a000000 | (rng() & 0x3ff);
+        uint8_t protocol = rng() % 2 ? 6 : 17;
+        uint16_t sport = rng() % 4;
+        uint16_t dport = rng() % 4;
+
+        int32_t expected = PacketFilter::PF_NO_MATCH;
+        for (std::size_t i = 0; i < rules.size(); i++)
+        {
+            const Rule& rule = rules[i];
+            if ((src & rule.srcMask) == rule.src && (dst & rule.dstMask) == rule.dst &&
+                (rule.protocol == ANY || rule.protocol == protocol) &&
+                (rule.sport == ANY || rule.sport == sport) &&
+                (rule.dport == ANY || rule.dport == dport))
+            {
+                expected = i;
+                break;
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(filter->Classify(CreateIpv4Item(Ipv4Address(src),
+                                                               Ipv4Address(dst),
+                                                               protocol,
+                                                               sport,
+                                                               dport)),
+                              expected,
+                              "The rule table must match the first matching rule");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief RuleTablePacketFilter TestSuite
+ */
+class RuleTablePacketFilterTestSuite : public TestSuite
+{
+  public:
+    RuleTablePacketFilterTestSuite();
+};
+
+RuleTablePacketFilterTestSuite::RuleTablePacketFilterTestSuite()
+    : TestSuite("rule-table-packet-filter", Type::UNIT)
+{
+    AddTestCase(new QueueDiscItemFiveTupleTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new RuleTablePacketFilterTestCase, TestCase::Duration::QUICK);
+}
+
+static RuleTablePacketFilterTestSuite
+    g_ruleTablePacketFilterTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,250 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/object-factory.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-bbr.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-rate-ops.h"
+#include "ns3/tcp-socket-state.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the cwnd and ssthresh trajectories of a congestion control algorithm.
+ *
+ * The flows are driven by the synthetic ACK streams of the
+ * bench-tcp-congestion-ops program, outside of any socket: every 100 us, each
+ * flow receives an ACK of one segment, and each flow goes through a fast
+ * recovery every 500 ACKs. The RTT of a flow grows with its window beyond its
+ * BDP. The cwnd and ssthresh of every flow after every ACK are hashed, and the
+ * hash must match the reference obtained before the per-ACK computations of
+ * the algorithm were optimized.
+ */
+class TcpCongOpsTrajectoryTest : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param congestionControl TypeId name of the congestion control algorithm.
+     * \param checksum Reference hash of the trajectories.
+     * \param cWnds Reference sum of the final cwnd of the flows (segments).
+     */
+    TcpCongOpsTrajectoryTest(const std::string& congestionControl,
+                             uint64_t checksum,
+                             uint64_t cWnds);
+
+  private:
+    void DoRun() override;
+
+    /// A flow driven by the synthetic ACK stream
+    struct Flow
+    {
+        Ptr<TcpSocketState> tcb;          //!< Socket state
+        Ptr<TcpCongestionOps> cc;         //!< Congestion control
+        TcpRateOps::TcpRateConnection rc; //!< Connection rate, for CongControl
+        TcpRateOps::TcpRateSample rs;     //!< Rate sample, for CongControl
+        Time baseRtt;                     //!< RTT without queueing
+        uint32_t bdp;                     //!< Bandwidth-delay product (bytes)
+        uint32_t acks{0};                 //!< ACKs received
+    };
+
+    /**
+     * \brief Deliver an ACK of one segment to a flow.
+     * \param flow The flow.
+     * \param index The index of the flow.
+     */
+    void AckFlow(Flow& flow, uint32_t index);
+    /**
+     * \brief Deliver an ACK to every flow and reschedule itself.
+     * \param round The number of ACKs delivered to each flow so far.
+     */
+    void AckAll(uint32_t round);
+
+    std::string m_congestionControl; //!< TypeId name of the congestion control algorithm
+    uint64_t m_expectedChecksum;     //!< Reference hash of the trajectories
+    uint64_t m_expectedCwnds;        //!< Reference sum of the final cwnd of the flows
+    std::vector<Flow> m_flows;       //!< The flows
+    uint64_t m_checksum{0};          //!< Hash of the trajectories of the flows
+};
+
+TcpCongOpsTrajectoryTest::TcpCongOpsTrajectoryTest(const std::string& congestionControl,
+                                                   uint64_t checksum,
+                                                   uint64_t cWnds)
+    : TestCase("Trajectories of " + congestionControl + " driven by synthetic ACK streams"),
+      m_congestionControl(congestionControl),
+      m_expectedChecksum(checksum),
+      m_expectedCwnds(cWnds)
+{
+}
+
+void
+TcpCongOpsTrajectoryTest::AckFlow(Flow& flow, uint32_t index)
+{
+    Ptr<TcpSocketState> tcb = flow.tcb;
+    uint32_t cWnd = tcb->m_cWnd;
+    Time rtt = flow.baseRtt;
+    if (cWnd > flow.bdp)
+    {
+        rtt += NanoSeconds(flow.baseRtt.GetNanoSeconds() * (cWnd - flow.bdp) / flow.bdp);
+    }
+    tcb->m_lastRtt = rtt;
+    tcb->m_minRtt = std::min(tcb->m_minRtt, rtt);
+    tcb->m_srtt = rtt;
+    tcb->m_bytesInFlight = cWnd;
+    tcb->m_lastAckedSackedBytes = tcb->m_segmentSize;
+    tcb->m_isCwndLimited = true;
+    tcb->m_lastAckedSeq += tcb->m_segmentSize;
+    tcb->m_nextTxSequence = tcb->m_lastAckedSeq + cWnd;
+    tcb->m_highTxMark = tcb->m_nextTxSequence.Get();
+    flow.acks++;
+
+    if (tcb->m_congState == TcpSocketState::CA_RECOVERY)
+    {
+        // the ACK following a loss ends the recovery
+        flow.cc->PktsAcked(tcb, 1, rtt);
+        if (!flow.cc->HasCongControl())
+        {
+            tcb->m_cWnd = tcb->m_ssThresh.Get();
+        }
+        flow.cc->CwndEvent(tcb, TcpSocketState::CA_EVENT_COMPLETE_CWR);
+        flow.cc->CongestionStateSet(tcb, TcpSocketState::CA_OPEN);
+        tcb->m_congState = TcpSocketState::CA_OPEN;
+    }
+    else if ((flow.acks + index) % 500 == 0)
+    {
+        flow.cc->CongestionStateSet(tcb, TcpSocketState::CA_RECOVERY);
+        tcb->m_congState = TcpSocketState::CA_RECOVERY;
+        tcb->m_ssThresh = flow.cc->GetSsThresh(tcb, cWnd);
+        if (!flow.cc->HasCongControl())
+        {
+            tcb->m_cWnd = tcb->m_ssThresh.Get();
+        }
+    }
+    else
+    {
+        flow.cc->PktsAcked(tcb, 1, rtt);
+        if (flow.cc->HasCongControl())
+        {
+            // a window of data is delivered per RTT, at most at the bottleneck rate
+            uint32_t delivered = std::min(cWnd, flow.bdp);
+            flow.rc.m_delivered += tcb->m_segmentSize;
+            flow.rc.m_deliveredTime = Simulator::Now();
+            TcpRateOps::TcpRateSample& rs = flow.rs;
+            rs.m_interval = rtt;
+            rs.m_delivered = delivered;
+            rs.m_deliveryRate =
+                DataRate(static_cast<uint64_t>(delivered) * 8 * 1000000000 / rtt.GetNanoSeconds());
+            rs.m_priorDelivered = static_cast<uint32_t>(
+                flow.rc.m_delivered - std::min<uint64_t>(flow.rc.m_delivered, delivered));
+            rs.m_priorInFlight = cWnd;
+            rs.m_ackedSacked = tcb->m_segmentSize;
+            flow.cc->CongControl(tcb, flow.rc, rs);
+        }
+        else
+        {
+            flow.cc->IncreaseWindow(tcb, 1);
+        }
+    }
+
+    uint64_t state = (static_cast<uint64_t>(tcb->m_cWnd.Get()) << 32) | tcb->m_ssThresh.Get();
+    m_checksum = (m_checksum ^ state) * 1099511628211ULL;
+}
+
+void
+TcpCongOpsTrajectoryTest::AckAll(uint32_t round)
+{
+    for (uint32_t i = 0; i < m_flows.size(); i++)
+    {
+        AckFlow(m_flows[i], i);
+    }
+    if (round + 1 < 3000)
+    {
+        Simulator::Schedule(MicroSeconds(100), &TcpCongOpsTrajectoryTest::AckAll, this, round + 1);
+    }
+}
+
+void
+TcpCongOpsTrajectoryTest::DoRun()
+{
+    const uint32_t segmentSize = 1448;
+    ObjectFactory factory;
+    factory.SetTypeId(m_congestionControl);
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        Flow flow;
+        flow.tcb = CreateObject<TcpSocketState>();
+        flow.tcb->m_segmentSize = segmentSize;
+        flow.tcb->m_initialCWnd = 10;
+        flow.tcb->m_cWnd = 10 * segmentSize;
+        flow.tcb->m_cWndInfl = flow.tcb->m_cWnd;
+        flow.tcb->m_initialSsThresh = UINT32_MAX;
+        flow.tcb->m_ssThresh = UINT32_MAX;
+        flow.tcb->m_maxPacingRate = DataRate("100Gbps");
+        flow.cc = factory.Create<TcpCongestionOps>();
+        // the gain cycle of BBR starts at a random phase
+        if (Ptr<TcpBbr> bbr = DynamicCast<TcpBbr>(flow.cc))
+        {
+            bbr->SetStream(i);
+        }
+        flow.baseRtt = MilliSeconds(20 + i % 8);
+        flow.bdp = (50 + (i % 8) * 25) * segmentSize;
+        flow.cc->Init(flow.tcb);
+        m_flows.push_back(flow);
+    }
+    Simulator::Schedule(MicroSeconds(100), &TcpCongOpsTrajectoryTest::AckAll, this, 0);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    uint64_t cWnds = 0;
+    for (const auto& flow : m_flows)
+    {
+        cWnds += flow.tcb->m_cWnd / segmentSize;
+    }
+    m_flows.clear();
+
+    NS_TEST_EXPECT_MSG_EQ(m_checksum, m_expectedChecksum, "The trajectories changed");
+    NS_TEST_EXPECT_MSG_EQ(cWnds, m_expectedCwnds, "The final windows changed");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief TestSuite for the trajectories of the congestion control algorithms.
+ */
+class TcpCongOpsTrajectoryTestSuite : public TestSuite
+{
+  public:
+    TcpCongOpsTrajectoryTestSuite()
+        : TestSuite("tcp-cong-ops-trajectory", Type::UNIT)
+    {
+        AddTestCase(new TcpCongOpsTrajectoryTest("ns3::TcpCubic", 12745106112503775684ULL, 762),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpCongOpsTrajectoryTest("ns3::TcpHtcp", 775757779099703937ULL, 318),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpCongOpsTrajectoryTest("ns3::TcpBbr", 8944061150359957816ULL, 5899),
+                    TestCase::Duration::QUICK);
+    }
+};
+
+static TcpCongOpsTrajectoryTestSuite
+    g_tcpCongOpsTrajectoryTestSuite; //!< Static variable for test initialization
@@ -21,6 +21,9 @@
 #include "ns3/core-module.h"
 #include "ns3/tcp-header.h"
 #include "ns3/tcp-option-rfc793.h"
+#include "ns3/tcp-option-sack.h"
+#include "ns3/tcp-option-ts.h"
+#include "ns3/tcp-option-winscale.h"
 #include "ns3/test.h"
 
 #include <stdint.h>
@@ -451,6 +454,92 @@ TcpHeaderFlagsToString::DoRun()
     NS_TEST_ASSERT_MSG_EQ(str, target, "str " << str << " does not equal target " << target);
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief TCP header typed options test.
+ */
+class TcpHeaderTypedOptionsTestCase : public TestCase
+{
+  public:
+    TcpHeaderTypedOptionsTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+TcpHeaderTypedOptionsTestCase::TcpHeaderTypedOptionsTestCase()
+    : TestCase("Test the options appended and read without TcpOption objects")
+{
+}
+
+void
+TcpHeaderTypedOptionsTestCase::DoRun()
+{
+    TcpOptionSack::SackList sackList;
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        sackList.emplace_back(SequenceNumber32(1000 * i + 100), SequenceNumber32(1000 * i + 500));
+    }
+
+    TcpHeader source;
+    NS_TEST_ASSERT_MSG_EQ(source.AppendWinScaleOption(7), true, "Window scale not appended");
+    NS_TEST_ASSERT_MSG_EQ(source.AppendTimestampOption(0x01020304, 0xa0b0c0d0),
+                          true,
+                          "Timestamp not appended");
+    // 40 - 3 - 10 bytes are left, i.e., room for 3 blocks
+    NS_TEST_ASSERT_MSG_EQ(source.AppendSackOption(sackList), 3, "Wrong number of SACK blocks");
+    NS_TEST_ASSERT_MSG_EQ(source.AppendSackPermittedOption(), false, "No room left for the option");
+    NS_TEST_ASSERT_MSG_EQ(source.GetOptionLength(), 39, "Wrong length of the options");
+    NS_TEST_ASSERT_MSG_EQ(source.GetLength(), 15, "Wrong length of the header");
+
+    Buffer buffer;
+    buffer.AddAtStart(source.GetSerializedSize());
+    source.Serialize(buffer.Begin());
+    TcpHeader destination;
+    NS_TEST_ASSERT_MSG_EQ(destination.Deserialize(buffer.Begin()), 60, "Wrong size");
+
+    uint8_t scale = 0;
+    NS_TEST_ASSERT_MSG_EQ(destination.GetWinScaleOption(scale), true, "Window scale not found");
+    NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(scale), 7, "Wrong window scale");
+    uint32_t timestamp = 0;
+    uint32_t echo = 0;
+    NS_TEST_ASSERT_MSG_EQ(destination.GetTimestampOption(timestamp, echo),
+                          true,
+                          "Timestamp not found");
+    NS_TEST_ASSERT_MSG_EQ(timestamp, 0x01020304, "Wrong timestamp");
+    NS_TEST_ASSERT_MSG_EQ(echo, 0xa0b0c0d0, "Wrong echo");
+    // the list is reused: its extra elements are removed
+    TcpOptionSack::SackList received = sackList;
+    NS_TEST_ASSERT_MSG_EQ(destination.GetSackOption(received), true, "SACK not found");
+    sackList.resize(3);
+    NS_TEST_ASSERT_MSG_EQ((received == sackList), true, "Wrong SACK blocks");
+    NS_TEST_ASSERT_MSG_EQ(destination.HasOption(TcpOption::SACKPERMITTED),
+                          false,
+                          "Unexpected SACK-permitted option");
+
+    // the options are also available as TcpOption objects, with the END padding
+    NS_TEST_ASSERT_MSG_EQ(destination.GetOptionList().size(), 4, "Wrong number of options");
+    auto ts = DynamicCast<const TcpOptionTS>(destination.GetOption(TcpOption::TS));
+    NS_TEST_ASSERT_MSG_NE(ts, nullptr, "Timestamp not found");
+    NS_TEST_ASSERT_MSG_EQ(ts->GetTimestamp(), 0x01020304, "Wrong timestamp");
+    NS_TEST_ASSERT_MSG_EQ(ts->GetEcho(), 0xa0b0c0d0, "Wrong echo");
+    auto sack = DynamicCast<const TcpOptionSack>(destination.GetOption(TcpOption::SACK));
+    NS_TEST_ASSERT_MSG_NE(sack, nullptr, "SACK not found");
+    NS_TEST_ASSERT_MSG_EQ((sack->GetSackList() == sackList), true, "Wrong SACK blocks");
+
+    // and the options appended as TcpOption objects are available to the typed methods
+    TcpHeader header;
+    auto option = CreateObject<TcpOptionWinScale>();
+    option->SetScale(3);
+    header.AppendOption(option);
+    NS_TEST_ASSERT_MSG_EQ(header.GetWinScaleOption(scale), true, "Window scale not found");
+    NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(scale), 3, "Wrong window scale");
+    NS_TEST_ASSERT_MSG_EQ(header.GetTimestampOption(timestamp, echo),
+                          false,
+                          "Unexpected timestamp");
+}
+
 /**
  * \ingroup internet-test
  *
@@ -467,6 +556,7 @@ class TcpHeaderTestSuite : public TestSuite
                     TestCase::Duration::QUICK);
         AddTestCase(new TcpHeaderFlagsToString("Test flags to string function"),
                     TestCase::Duration::QUICK);
+        AddTestCase(new TcpHeaderTypedOptionsTestCase(), TestCase::Duration::QUICK);
     }
 };
 
@@ -16,6 +16,7 @@
 
 #include "ns3/log.h"
 #include "ns3/packet.h"
+#include "ns3/socket.h"
 #include "ns3/tcp-rx-buffer.h"
 #include "ns3/test.h"
 
@@ -42,6 +43,18 @@ class TcpRxBufferTestCase : public TestCase
      * \brief Test the SACK list update.
      */
     void TestUpdateSACKList();
+    /**
+     * \brief Test the SACK block of data contiguous to a block no longer in the SACK list.
+     */
+    void TestSackContiguousData();
+    /**
+     * \brief Test the extraction of data received out of order.
+     */
+    void TestExtract();
+    /**
+     * \brief Test that the extracted data carries no packet tags.
+     */
+    void TestExtractPacketTags();
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase()
@@ -53,6 +66,9 @@ void
 TcpRxBufferTestCase::DoRun()
 {
     TestUpdateSACKList();
+    TestSackContiguousData();
+    TestExtract();
+    TestExtractPacketTags();
 }
 
 void
@@ -288,6 +304,130 @@ TcpRxBufferTestCase::TestUpdateSACKList()
     NS_TEST_ASSERT_MSG_EQ(sackList.size(), 0, "SACK list should contain no element");
 }
 
+void
+TcpRxBufferTestCase::TestSackContiguousData()
+{
+    TcpRxBuffer rxBuf;
+    Ptr<Packet> p = Create<Packet>(100);
+    TcpHeader h;
+    rxBuf.SetNextRxSequence(SequenceNumber32(1));
+
+    // five isolated blocks: the first one is dropped from the SACK list
+    for (uint32_t seq = 201; seq <= 1001; seq += 200)
+    {
+        h.SetSequenceNumber(SequenceNumber32(seq));
+        rxBuf.Add(p, h);
+    }
+    TcpOptionSack::SackList sackList = rxBuf.GetSackList();
+    NS_TEST_ASSERT_MSG_EQ(sackList.size(), 4, "SACK list should contain four element");
+    NS_TEST_ASSERT_MSG_EQ(sackList.back().first,
+                          SequenceNumber32(401),
+                          "SACK block different than expected");
+
+    // a segment contiguous to the dropped block is reported with it
+    h.SetSequenceNumber(SequenceNumber32(301));
+    rxBuf.Add(p, h);
+
+    sackList = rxBuf.GetSackList();
+    NS_TEST_ASSERT_MSG_EQ(sackList.size(), 4, "SACK list should contain four element");
+    auto it = sackList.begin();
+    NS_TEST_ASSERT_MSG_EQ(it->first, SequenceNumber32(201), "SACK block different than expected");
+    NS_TEST_ASSERT_MSG_EQ(it->second, SequenceNumber32(501), "SACK block different than expected");
+    ++it;
+    NS_TEST_ASSERT_MSG_EQ(it->first, SequenceNumber32(1001), "SACK block different than expected");
+    NS_TEST_ASSERT_MSG_EQ(it->second, SequenceNumber32(1101), "SACK block different than expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 600, "Buffer size different than expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 0, "Available data different than expected");
+}
+
+void
+TcpRxBufferTestCase::TestExtract()
+{
+    TcpRxBuffer rxBuf;
+    TcpHeader h;
+    rxBuf.SetNextRxSequence(SequenceNumber32(1));
+
+    // segments of 100 bytes, each filled with its index, received in reverse order
+    for (uint8_t i = 5; i > 0; i--)
+    {
+        std::vector<uint8_t> data(100, i - 1);
+        h.SetSequenceNumber(SequenceNumber32(1 + (i - 1) * 100));
+        rxBuf.Add(Create<Packet>(data.data(), data.size()), h);
+    }
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(501),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 500, "Available data different than expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackListSize(), 0, "SACK list should contain no element");
+
+    // overlapping the stored data and beyond it
+    std::vector<uint8_t> data(200, 5);
+    h.SetSequenceNumber(SequenceNumber32(401));
+    rxBuf.Add(Create<Packet>(data.data(), data.size()), h);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 600, "Available data different than expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 600, "Buffer size different than expected");
+
+    // a single segment, then parts of segments
+    std::vector<uint32_t> sizes = {100, 150, 200, 150};
+    std::vector<uint8_t> out(600);
+    uint32_t offset = 0;
+    for (uint32_t size : sizes)
+    {
+        Ptr<Packet> extracted = rxBuf.Extract(size);
+        NS_TEST_ASSERT_MSG_EQ(extracted->GetSize(), size, "Extracted size different than expected");
+        extracted->CopyData(out.data() + offset, size);
+        offset += size;
+    }
+    for (uint32_t i = 0; i < out.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(out[i]),
+                              i / 100,
+                              "Extracted data different than expected at " << i);
+    }
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 0, "Buffer size different than expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 0, "Available data different than expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Extract(100), nullptr, "No data should be extracted");
+}
+
+void
+TcpRxBufferTestCase::TestExtractPacketTags()
+{
+    TcpRxBuffer rxBuf;
+    TcpHeader h;
+    rxBuf.SetNextRxSequence(SequenceNumber32(1));
+
+    std::vector<Ptr<Packet>> segments;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(100);
+        SocketPriorityTag tag;
+        tag.SetPriority(i + 1);
+        p->AddPacketTag(tag);
+        h.SetSequenceNumber(SequenceNumber32(1 + 100 * i));
+        rxBuf.Add(p, h);
+        segments.push_back(p);
+    }
+
+    // a whole segment, then a segment and a half, then the rest
+    for (uint32_t size : {100, 150, 50})
+    {
+        Ptr<Packet> extracted = rxBuf.Extract(size);
+        NS_TEST_ASSERT_MSG_EQ(extracted->GetSize(), size, "Extracted size different than expected");
+        SocketPriorityTag tag;
+        NS_TEST_ASSERT_MSG_EQ(extracted->PeekPacketTag(tag),
+                              false,
+                              "The extracted data must carry no packet tags");
+    }
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 0, "Buffer size different than expected");
+
+    // the segments given to the buffer are left unchanged
+    for (const auto& p : segments)
+    {
+        SocketPriorityTag tag;
+        NS_TEST_ASSERT_MSG_EQ(p->PeekPacketTag(tag), true, "The segment must keep its tags");
+    }
+}
+
 void
 TcpRxBufferTestCase::DoTeardown()
 {
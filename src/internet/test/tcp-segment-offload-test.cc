@@ -0,0 +1,464 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check a bulk transfer with TCP segmentation offload.
+ *
+ * The same amount of data is transferred between two nodes over a
+ * point-to-point SimpleNetDevice link, first with one segment per packet,
+ * then with super-segments. With offload, all the data must be received,
+ * in far fewer IP packets and ACKs, and about as fast as without offload,
+ * since the link accounts for the headers of each segment of a super-segment.
+ */
+class TcpSegmentOffloadTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param desc Test description.
+     * \param v6 True to use IPv6.
+     */
+    TcpSegmentOffloadTestCase(std::string desc, bool v6);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Statistics of a transfer.
+     */
+    struct Transfer
+    {
+        uint32_t received{0};    //!< Bytes received
+        uint32_t dataPackets{0}; //!< IP packets sent by the sender
+        uint32_t ackPackets{0};  //!< IP packets sent by the receiver
+        Time completion;         //!< Time at which all the data was received
+    };
+
+    /**
+     * \brief Run a transfer.
+     * \param offloadSegments the OffloadSegments attribute of the sender
+     * \returns the statistics of the transfer
+     */
+    Transfer RunTransfer(uint32_t offloadSegments);
+
+    /**
+     * \brief Handle an incoming connection.
+     * \param socket The receiving socket.
+     * \param from The sender address.
+     */
+    void HandleAccept(Ptr<Socket> socket, const Address& from);
+    /**
+     * \brief Handle a connection establishment.
+     * \param socket The sending socket.
+     */
+    void HandleConnect(Ptr<Socket> socket);
+    /**
+     * \brief Receive data.
+     * \param socket The receiving socket.
+     */
+    void Recv(Ptr<Socket> socket);
+    /**
+     * \brief Send data as the buffer allows.
+     * \param socket The sending socket.
+     * \param available The space available in the buffer.
+     */
+    void Send(Ptr<Socket> socket, uint32_t available);
+
+    bool m_v6;             //!< True to use IPv6
+    uint32_t m_totalBytes; //!< Bytes to transfer
+    uint32_t m_sent{0};    //!< Bytes sent
+    Transfer m_transfer;   //!< Statistics of the current transfer
+};
+
+TcpSegmentOffloadTestCase::TcpSegmentOffloadTestCase(std::string desc, bool v6)
+    : TestCase(desc),
+      m_v6(v6),
+      m_totalBytes(2000000)
+{
+}
+
+void
+TcpSegmentOffloadTestCase::HandleAccept(Ptr<Socket> socket, const Address& from)
+{
+    socket->SetRecvCallback(MakeCallback(&TcpSegmentOffloadTestCase::Recv, this));
+}
+
+void
+TcpSegmentOffloadTestCase::HandleConnect(Ptr<Socket> socket)
+{
+    Send(socket, socket->GetTxAvailable());
+}
+
+void
+TcpSegmentOffloadTestCase::Recv(Ptr<Socket> socket)
+{
+    while (Ptr<Packet> packet = socket->Recv())
+    {
+        m_transfer.received += packet->GetSize();
+    }
+    if (m_transfer.received == m_totalBytes)
+    {
+        m_transfer.completion = Simulator::Now();
+    }
+}
+
+void
+TcpSegmentOffloadTestCase::Send(Ptr<Socket> socket, uint32_t available)
+{
+    while (m_sent < m_totalBytes && socket->GetTxAvailable() > 0)
+    {
+        uint32_t size = std::min(m_totalBytes - m_sent, socket->GetTxAvailable());
+        int sent = socket->Send(Create<Packet>(size));
+        if (sent <= 0)
+        {
+            break;
+        }
+        m_sent += sent;
+    }
+    if (m_sent == m_totalBytes)
+    {
+        socket->Close();
+    }
+}
+
+TcpSegmentOffloadTestCase::Transfer
+TcpSegmentOffloadTestCase::RunTransfer(uint32_t offloadSegments)
+{
+    m_sent = 0;
+    m_transfer = Transfer();
+    // HyStart detects the end of slow start from the spacing of the ACKs,
+    // which differs when a super-segment is acknowledged at once
+    Config::SetDefault("ns3::TcpCubic::HyStart", BooleanValue(false));
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    simpleHelper.SetDeviceAttribute("DataRate", DataRateValue(DataRate("1Gbps")));
+    simpleHelper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
+    NetDeviceContainer devices = simpleHelper.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    if (m_v6)
+    {
+        nodes.Get(0)->GetObject<Icmpv6L4Protocol>()->SetAttribute("DAD", BooleanValue(false));
+        nodes.Get(1)->GetObject<Icmpv6L4Protocol>()->SetAttribute("DAD", BooleanValue(false));
+    }
+
+    Address sinkAddress;
+    if (!m_v6)
+    {
+        Ipv4AddressHelper ipv4;
+        ipv4.SetBase("10.0.0.0", "255.255.255.0");
+        Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+        sinkAddress = InetSocketAddress(interfaces.GetAddress(1), 9);
+        nodes.Get(0)->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+            "Tx",
+            Callback<void, Ptr<const Packet>, Ptr<Ipv4>, uint32_t>(
+                [this](Ptr<const Packet>, Ptr<Ipv4>, uint32_t) { m_transfer.dataPackets++; }));
+        nodes.Get(1)->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+            "Tx",
+            Callback<void, Ptr<const Packet>, Ptr<Ipv4>, uint32_t>(
+                [this](Ptr<const Packet>, Ptr<Ipv4>, uint32_t) { m_transfer.ackPackets++; }));
+    }
+    else
+    {
+        Ipv6AddressHelper ipv6;
+        ipv6.SetBase(Ipv6Address("2001:db8::"), Ipv6Prefix(64));
+        Ipv6InterfaceContainer interfaces = ipv6.Assign(devices);
+        interfaces.SetForwarding(0, false);
+        sinkAddress = Inet6SocketAddress(interfaces.GetAddress(1, 1), 9);
+        nodes.Get(0)->GetObject<Ipv6L3Protocol>()->TraceConnectWithoutContext(
+            "Tx",
+            Callback<void, Ptr<const Packet>, Ptr<Ipv6>, uint32_t>(
+                [this](Ptr<const Packet>, Ptr<Ipv6>, uint32_t) { m_transfer.dataPackets++; }));
+        nodes.Get(1)->GetObject<Ipv6L3Protocol>()->TraceConnectWithoutContext(
+            "Tx",
+            Callback<void, Ptr<const Packet>, Ptr<Ipv6>, uint32_t>(
+                [this](Ptr<const Packet>, Ptr<Ipv6>, uint32_t) { m_transfer.ackPackets++; }));
+    }
+
+    TypeId tid = TcpSocketFactory::GetTypeId();
+    Ptr<Socket> sink = Socket::CreateSocket(nodes.Get(1), tid);
+    sink->SetAttribute("RcvBufSize", UintegerValue(1 << 20));
+    if (!m_v6)
+    {
+        sink->Bind(InetSocketAddress(Ipv4Address::GetAny(), 9));
+    }
+    else
+    {
+        sink->Bind(Inet6SocketAddress(Ipv6Address::GetAny(), 9));
+    }
+    sink->Listen();
+    sink->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                            MakeCallback(&TcpSegmentOffloadTestCase::HandleAccept, this));
+
+    Ptr<Socket> source = Socket::CreateSocket(nodes.Get(0), tid);
+    source->SetAttribute("SndBufSize", UintegerValue(1 << 20));
+    source->SetAttribute("SegmentSize", UintegerValue(1400));
+    source->SetAttribute("OffloadSegments", UintegerValue(offloadSegments));
+    source->SetConnectCallback(MakeCallback(&TcpSegmentOffloadTestCase::HandleConnect, this),
+                               MakeNullCallback<void, Ptr<Socket>>());
+    source->SetSendCallback(MakeCallback(&TcpSegmentOffloadTestCase::Send, this));
+    source->Bind();
+    Simulator::Schedule(Seconds(0), &Socket::Connect, source, sinkAddress);
+
+    Simulator::Run();
+    Simulator::Destroy();
+    return m_transfer;
+}
+
+void
+TcpSegmentOffloadTestCase::DoRun()
+{
+    Transfer perSegment = RunTransfer(1);
+    Transfer offload = RunTransfer(16);
+
+    NS_TEST_ASSERT_MSG_EQ(perSegment.received, m_totalBytes, "Data lost without offload");
+    NS_TEST_ASSERT_MSG_EQ(offload.received, m_totalBytes, "Data lost with offload");
+    NS_TEST_ASSERT_MSG_GT(perSegment.dataPackets,
+                          4 * offload.dataPackets,
+                          "Super-segments are not sent");
+    NS_TEST_ASSERT_MSG_GT(perSegment.ackPackets,
+                          2 * offload.ackPackets,
+                          "Super-segments are not acknowledged at once");
+    NS_TEST_ASSERT_MSG_EQ_TOL(offload.completion.GetSeconds(),
+                              perSegment.completion.GetSeconds(),
+                              0.05 * perSegment.completion.GetSeconds(),
+                              "The transfer time differs with offload");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief A SimpleNetDevice which does not support segmentation offload.
+ */
+class NoOffloadNetDevice : public SimpleNetDevice
+{
+  public:
+    bool SupportsSegmentOffload() const override
+    {
+        return false;
+    }
+};
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the super-segments forwarded by an IPv6 router.
+ *
+ * The sender reaches the receiver through a router, over SimpleNetDevice
+ * links with an MTU of 1500 bytes. The device of the router towards the
+ * receiver does not support segmentation offload. IPv6 routers do not
+ * fragment, so the router drops the super-segments and answers with an
+ * ICMPv6 Packet Too Big, whereas the segments sent one by one are forwarded.
+ */
+class TcpSegmentOffloadRouterTestCase : public TestCase
+{
+  public:
+    TcpSegmentOffloadRouterTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Statistics of a transfer.
+     */
+    struct Transfer
+    {
+        uint32_t received{0};     //!< Bytes received
+        uint32_t packetTooBig{0}; //!< ICMPv6 Packet Too Big received by the sender
+        uint32_t oversized{0};    //!< Packets larger than the MTU sent to the receiver
+    };
+
+    /**
+     * \brief Run a transfer.
+     * \param offloadSegments the OffloadSegments attribute of the sender
+     * \returns the statistics of the transfer
+     */
+    Transfer RunTransfer(uint32_t offloadSegments);
+
+    /**
+     * \brief Receive data.
+     * \param socket The receiving socket.
+     */
+    void Recv(Ptr<Socket> socket);
+
+    uint32_t m_totalBytes; //!< Bytes to transfer
+    Transfer m_transfer;   //!< Statistics of the current transfer
+};
+
+TcpSegmentOffloadRouterTestCase::TcpSegmentOffloadRouterTestCase()
+    : TestCase("Super-segments dropped by an IPv6 router without offload"),
+      m_totalBytes(100000)
+{
+}
+
+void
+TcpSegmentOffloadRouterTestCase::Recv(Ptr<Socket> socket)
+{
+    while (Ptr<Packet> packet = socket->Recv())
+    {
+        m_transfer.received += packet->GetSize();
+    }
+}
+
+TcpSegmentOffloadRouterTestCase::Transfer
+TcpSegmentOffloadRouterTestCase::RunTransfer(uint32_t offloadSegments)
+{
+    m_transfer = Transfer();
+    const uint16_t mtu = 1500;
+
+    NodeContainer nodes;
+    nodes.Create(3);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    simpleHelper.SetDeviceAttribute("DataRate", DataRateValue(DataRate("100Mbps")));
+    simpleHelper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
+    NetDeviceContainer senderDevices =
+        simpleHelper.Install(NodeContainer(nodes.Get(0), nodes.Get(1)));
+
+    NetDeviceContainer receiverDevices;
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    channel->SetAttribute("Delay", TimeValue(MilliSeconds(1)));
+    for (uint32_t i = 1; i < 3; i++)
+    {
+        Ptr<NoOffloadNetDevice> device = CreateObject<NoOffloadNetDevice>();
+        device->SetAttribute("DataRate", DataRateValue(DataRate("100Mbps")));
+        device->SetAttribute("PointToPointMode", BooleanValue(true));
+        device->SetAddress(Mac48Address::Allocate());
+        device->SetChannel(channel);
+        nodes.Get(i)->AddDevice(device);
+        receiverDevices.Add(device);
+    }
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        senderDevices.Get(i)->SetMtu(mtu);
+        receiverDevices.Get(i)->SetMtu(mtu);
+    }
+
+    InternetStackHelper internet;
+    internet.SetIpv4StackInstall(false);
+    internet.Install(nodes);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        nodes.Get(i)->GetObject<Icmpv6L4Protocol>()->SetAttribute("DAD", BooleanValue(false));
+    }
+
+    Ipv6AddressHelper ipv6;
+    ipv6.SetBase(Ipv6Address("2001:1::"), Ipv6Prefix(64));
+    Ipv6InterfaceContainer senderInterfaces = ipv6.Assign(senderDevices);
+    senderInterfaces.SetForwarding(1, true);
+    senderInterfaces.SetDefaultRouteInAllNodes(1);
+    ipv6.SetBase(Ipv6Address("2001:2::"), Ipv6Prefix(64));
+    Ipv6InterfaceContainer receiverInterfaces = ipv6.Assign(receiverDevices);
+    receiverInterfaces.SetForwarding(0, true);
+    receiverInterfaces.SetDefaultRouteInAllNodes(0);
+
+    Ptr<Ipv6L3Protocol> router = nodes.Get(1)->GetObject<Ipv6L3Protocol>();
+    uint32_t routerInterface = router->GetInterfaceForDevice(receiverDevices.Get(0));
+    router->TraceConnectWithoutContext(
+        "Tx",
+        Callback<void, Ptr<const Packet>, Ptr<Ipv6>, uint32_t>(
+            [this, mtu, routerInterface](Ptr<const Packet> packet, Ptr<Ipv6>, uint32_t interface) {
+                if (interface == routerInterface && packet->GetSize() > mtu)
+                {
+                    m_transfer.oversized++;
+                }
+            }));
+
+    TypeId tid = TcpSocketFactory::GetTypeId();
+    Ptr<Socket> sink = Socket::CreateSocket(nodes.Get(2), tid);
+    sink->Bind(Inet6SocketAddress(Ipv6Address::GetAny(), 9));
+    sink->Listen();
+    sink->SetAcceptCallback(
+        MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+        Callback<void, Ptr<Socket>, const Address&>([this](Ptr<Socket> socket, const Address&) {
+            socket->SetRecvCallback(MakeCallback(&TcpSegmentOffloadRouterTestCase::Recv, this));
+        }));
+
+    Ptr<Socket> source = Socket::CreateSocket(nodes.Get(0), tid);
+    source->SetAttribute("SegmentSize", UintegerValue(1400));
+    source->SetAttribute("OffloadSegments", UintegerValue(offloadSegments));
+    source->SetAttribute(
+        "IcmpCallback6",
+        CallbackValue(Callback<void, Ipv6Address, uint8_t, uint8_t, uint8_t, uint32_t>(
+            [this](Ipv6Address, uint8_t, uint8_t type, uint8_t, uint32_t) {
+                if (type == Icmpv6Header::ICMPV6_ERROR_PACKET_TOO_BIG)
+                {
+                    m_transfer.packetTooBig++;
+                }
+            })));
+    source->SetConnectCallback(Callback<void, Ptr<Socket>>([this](Ptr<Socket> socket) {
+                                   socket->Send(Create<Packet>(m_totalBytes));
+                                   socket->Close();
+                               }),
+                               MakeNullCallback<void, Ptr<Socket>>());
+    source->Bind6();
+    Simulator::Schedule(Seconds(0),
+                        &Socket::Connect,
+                        source,
+                        Inet6SocketAddress(receiverInterfaces.GetAddress(1, 1), 9));
+
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+    Simulator::Destroy();
+    return m_transfer;
+}
+
+void
+TcpSegmentOffloadRouterTestCase::DoRun()
+{
+    Transfer perSegment = RunTransfer(1);
+    Transfer offload = RunTransfer(16);
+
+    NS_TEST_ASSERT_MSG_EQ(perSegment.received, m_totalBytes, "Data lost without offload");
+    NS_TEST_ASSERT_MSG_EQ(perSegment.packetTooBig, 0, "Segments dropped by the router");
+    NS_TEST_ASSERT_MSG_GT(offload.packetTooBig, 0, "Super-segments forwarded by the router");
+    NS_TEST_ASSERT_MSG_EQ(offload.oversized, 0, "Super-segments sent by the router");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief TestSuite for the TCP segmentation offload.
+ */
+class TcpSegmentOffloadTestSuite : public TestSuite
+{
+  public:
+    TcpSegmentOffloadTestSuite()
+        : TestSuite("tcp-segment-offload", Type::UNIT)
+    {
+        AddTestCase(new TcpSegmentOffloadTestCase("Segmentation offload IPv4", false),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpSegmentOffloadTestCase("Segmentation offload IPv6", true),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpSegmentOffloadRouterTestCase(), TestCase::Duration::QUICK);
+    }
+};
+
+static TcpSegmentOffloadTestSuite
+    g_tcpSegmentOffloadTestSuite; //!< Static variable for test initialization
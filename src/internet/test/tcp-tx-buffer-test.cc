@@ -20,7 +20,10 @@
 #include "ns3/tcp-tx-buffer.h"
 #include "ns3/test.h"
 
+#include <algorithm>
 #include <limits>
+#include <set>
+#include <string>
 
 using namespace ns3;
 
@@ -430,6 +433,359 @@ TcpTxBufferTestCase::DoTeardown()
 {
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the indexes of the TcpTxBuffer scoreboard against linear scans
+ *
+ * The sent items are indexed by sequence number in ordered sets kept in sync
+ * with their flags. Segments are sent, SACKed, marked lost, retransmitted,
+ * split, merged and discarded, and after each step NextSeg(), IsLost(),
+ * BytesInFlight(), the highest SACK and the lost, SACKed and retransmitted
+ * counts must match the results of the linear scans of the sent list that the
+ * indexes replaced, and each index must hold exactly the items whose flags
+ * it selects.
+ */
+class TcpTxBufferIndexTestCase : public TestCase
+{
+  public:
+    /** \brief Constructor */
+    TcpTxBufferIndexTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Compare the scoreboard of a buffer with linear scans of its sent list
+     * \param txBuf the buffer
+     * \param step the description of the last step
+     */
+    void Check(Ptr<TcpTxBuffer> txBuf, const std::string& step);
+    /**
+     * \brief NextSeg() as a linear scan of the sent list
+     * \param txBuf the buffer
+     * \param seq [out] the first sequence number of the segment
+     * \param seqHigh [out] the end of the segment
+     * \param isRecovery whether the socket is in recovery
+     * \return true if a segment is returned
+     */
+    bool ScanNextSeg(Ptr<TcpTxBuffer> txBuf,
+                     SequenceNumber32* seq,
+                     SequenceNumber32* seqHigh,
+                     bool isRecovery) const;
+    /**
+     * \brief IsLost() as a linear scan of the sent list
+     * \param txBuf the buffer
+     * \param seq the sequence number
+     * \return true if seq is lost
+     */
+    bool ScanIsLost(Ptr<TcpTxBuffer> txBuf, const SequenceNumber32& seq) const;
+    /**
+     * \brief Callback to provide a value of receiver window
+     * \returns the receiver window size
+     */
+    uint32_t GetRWnd() const;
+
+    bool m_sackLossOnly{true}; //!< Whether every lost mark comes from the SACKs
+};
+
+TcpTxBufferIndexTestCase::TcpTxBufferIndexTestCase()
+    : TestCase("TcpTxBuffer scoreboard indexes against linear scans")
+{
+}
+
+uint32_t
+TcpTxBufferIndexTestCase::GetRWnd() const
+{
+    return 100000;
+}
+
+bool
+TcpTxBufferIndexTestCase::ScanNextSeg(Ptr<TcpTxBuffer> txBuf,
+                                      SequenceNumber32* seq,
+                                      SequenceNumber32* seqHigh,
+                                      bool isRecovery) const
+{
+    // RFC 6675 rules (1), (2) and (3), walking the whole sent list
+    SequenceNumber32 seqPerRule3;
+    bool isSeqPerRule3Valid = false;
+    SequenceNumber32 beginOfCurrentPkt = txBuf->m_firstByteSeq;
+    for (const TcpTxItem* item : txBuf->m_sentList)
+    {
+        if (!item->m_retrans && !item->m_sacked &&
+            ((txBuf->m_sackSeen && item->m_startSeq < txBuf->m_highestSack.second) ||
+             !txBuf->m_sackSeen))
+        {
+            if (item->m_lost)
+            {
+                *seq = beginOfCurrentPkt;
+                *seqHigh = *seq + txBuf->m_segmentSize;
+                return true;
+            }
+            else if (seqPerRule3.GetValue() == 0 && isRecovery)
+            {
+                isSeqPerRule3Valid = true;
+                seqPerRule3 = beginOfCurrentPkt;
+            }
+        }
+        beginOfCurrentPkt += item->m_packet->GetSize();
+    }
+
+    if (txBuf->SizeFromSequence(txBuf->m_firstByteSeq + txBuf->m_sentSize) > 0)
+    {
+        if (txBuf->m_sentSize < GetRWnd())
+        {
+            *seq = txBuf->m_firstByteSeq + txBuf->m_sentSize;
+            *seqHigh =
+                *seq + std::min<uint32_t>(txBuf->m_segmentSize, GetRWnd() - txBuf->m_sentSize);
+            return true;
+        }
+        return false;
+    }
+
+    if (isSeqPerRule3Valid)
+    {
+        *seq = seqPerRule3;
+        *seqHigh = *seq + txBuf->m_segmentSize;
+        return true;
+    }
+    return false;
+}
+
+bool
+TcpTxBufferIndexTestCase::ScanIsLost(Ptr<TcpTxBuffer> txBuf, const SequenceNumber32& seq) const
+{
+    if (seq >= txBuf->m_highestSack.second)
+    {
+        return false;
+    }
+    for (const TcpTxItem* item : txBuf->m_sentList)
+    {
+        if (item->m_startSeq <= seq && seq < item->m_startSeq + item->m_packet->GetSize())
+        {
+            return item->m_lost;
+        }
+    }
+    return false;
+}
+
+void
+TcpTxBufferIndexTestCase::Check(Ptr<TcpTxBuffer> txBuf, const std::string& step)
+{
+    uint32_t sacked = 0;
+    uint32_t lost = 0;
+    uint32_t retrans = 0;
+    uint32_t sentSize = 0;
+    SequenceNumber32 beginOfCurrentPkt = txBuf->m_firstByteSeq;
+    auto highestSack = txBuf->m_sentList.end();
+    TcpTxBuffer::ItemIndex sentIndex;
+    TcpTxBuffer::ItemIndex sackedIndex;
+    TcpTxBuffer::ItemIndex lostIndex;
+    TcpTxBuffer::ItemIndex holeIndex;
+    TcpTxBuffer::ItemIndex unmarkedIndex;
+    for (auto it = txBuf->m_sentList.begin(); it != txBuf->m_sentList.end(); ++it)
+    {
+        const TcpTxItem* item = *it;
+        uint32_t size = item->m_packet->GetSize();
+        NS_TEST_ASSERT_MSG_EQ(item->m_startSeq, beginOfCurrentPkt, step << ": bad item start");
+        NS_TEST_ASSERT_MSG_EQ((item->m_sacked && item->m_lost), false, step << ": sacked and lost");
+        sacked += item->m_sacked ? size : 0;
+        lost += item->m_lost ? size : 0;
+        retrans += item->m_retrans ? size : 0;
+        sentSize += size;
+        if (item->m_sacked)
+        {
+            highestSack = it;
+        }
+
+        sentIndex.insert(it);
+        if (item->m_sacked)
+        {
+            sackedIndex.insert(it);
+        }
+        if (item->m_lost && !item->m_sacked && !item->m_retrans)
+        {
+            lostIndex.insert(it);
+        }
+        if (!item->m_sacked && !item->m_retrans)
+        {
+            holeIndex.insert(it);
+        }
+        if (!item->m_sacked && !item->m_lost)
+        {
+            unmarkedIndex.insert(it);
+        }
+        beginOfCurrentPkt += size;
+    }
+
+    NS_TEST_EXPECT_MSG_EQ(sentSize, txBuf->m_sentSize, step << ": bad sent size");
+    NS_TEST_EXPECT_MSG_EQ(txBuf->GetSacked(), sacked, step << ": bad sacked count");
+    NS_TEST_EXPECT_MSG_EQ(txBuf->GetLost(), lost, step << ": bad lost count");
+    NS_TEST_EXPECT_MSG_EQ(txBuf->GetRetransmitsCount(), retrans, step << ": bad retrans count");
+    NS_TEST_EXPECT_MSG_EQ(txBuf->BytesInFlight(),
+                          sentSize - sacked - lost + retrans,
+                          step << ": bad bytes in flight");
+    if (highestSack != txBuf->m_sentList.end())
+    {
+        NS_TEST_EXPECT_MSG_EQ((txBuf->m_highestSack.first == highestSack),
+                              true,
+                              step << ": bad highest sacked item");
+        NS_TEST_EXPECT_MSG_EQ(txBuf->m_highestSack.second,
+                              (*highestSack)->m_startSeq,
+                              step << ": bad highest sack");
+    }
+
+    NS_TEST_EXPECT_MSG_EQ((txBuf->m_sentIndex == sentIndex), true, step << ": bad sent index");
+    NS_TEST_EXPECT_MSG_EQ((txBuf->m_sackedIndex == sackedIndex),
+                          true,
+                          step << ": bad sacked index");
+    NS_TEST_EXPECT_MSG_EQ((txBuf->m_lostIndex == lostIndex), true, step << ": bad lost index");
+    NS_TEST_EXPECT_MSG_EQ((txBuf->m_holeIndex == holeIndex), true, step << ": bad hole index");
+    NS_TEST_EXPECT_MSG_EQ((txBuf->m_unmarkedIndex == unmarkedIndex),
+                          true,
+                          step << ": bad unmarked index");
+
+    for (bool isRecovery : {false, true})
+    {
+        SequenceNumber32 seq;
+        SequenceNumber32 seqHigh;
+        SequenceNumber32 scanSeq;
+        SequenceNumber32 scanSeqHigh;
+        bool found = txBuf->NextSeg(&seq, &seqHigh, isRecovery);
+        NS_TEST_EXPECT_MSG_EQ(found,
+                              ScanNextSeg(txBuf, &scanSeq, &scanSeqHigh, isRecovery),
+                              step << ": NextSeg differs from the scan");
+        if (found)
+        {
+            NS_TEST_EXPECT_MSG_EQ(seq, scanSeq, step << ": NextSeg differs from the scan");
+            NS_TEST_EXPECT_MSG_EQ(seqHigh, scanSeqHigh, step << ": NextSeg differs from the scan");
+        }
+    }
+
+    for (const TcpTxItem* item : txBuf->m_sentList)
+    {
+        for (uint32_t offset : {0U, item->m_packet->GetSize() / 2})
+        {
+            SequenceNumber32 seq = item->m_startSeq + offset;
+            NS_TEST_EXPECT_MSG_EQ(txBuf->IsLost(seq),
+                                  ScanIsLost(txBuf, seq),
+                                  step << ": IsLost(" << seq << ") differs from the scan");
+        }
+    }
+
+    // UpdateLostCount walked down from the highest sacked item, marking lost the
+    // items below the "Dupack thresh"-th sacked one, and the head
+    if (m_sackLossOnly && txBuf->m_sackSeen)
+    {
+        uint32_t sackedSeen = 0;
+        std::set<const TcpTxItem*> lostItems;
+        for (auto it = txBuf->m_highestSack.first; it != txBuf->m_sentList.begin(); --it)
+        {
+            sackedSeen += (*it)->m_sacked ? 1 : 0;
+            if (sackedSeen >= txBuf->m_dupAckThresh && !(*it)->m_sacked)
+            {
+                lostItems.insert(*it);
+            }
+        }
+        if (sackedSeen >= txBuf->m_dupAckThresh)
+        {
+            lostItems.insert(txBuf->m_sentList.front());
+        }
+        for (const TcpTxItem* item : txBuf->m_sentList)
+        {
+            NS_TEST_EXPECT_MSG_EQ(item->m_lost,
+                                  (lostItems.count(item) == 1),
+                                  step << ": the lost marks differ from the scan at "
+                                       << item->m_startSeq);
+        }
+    }
+}
+
+void
+TcpTxBufferIndexTestCase::DoRun()
+{
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetRWndCallback(MakeCallback(&TcpTxBufferIndexTestCase::GetRWnd, this));
+    txBuf->SetHeadSequence(SequenceNumber32(1));
+    txBuf->SetSegmentSize(1000);
+    txBuf->SetDupAckThresh(3);
+    txBuf->SetSackEnabled(true);
+    txBuf->Add(Create<Packet>(20000));
+
+    // ten segments [1;1001) ... [9001;10001)
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        txBuf->CopyFromSequence(1000, SequenceNumber32(1 + 1000 * i));
+    }
+    Check(txBuf, "Sent ten segments");
+
+    auto sack = [txBuf](uint32_t begin, uint32_t end) {
+        TcpOptionSack::SackList list;
+        list.emplace_back(SequenceNumber32(begin), SequenceNumber32(end));
+        txBuf->Update(list);
+    };
+
+    sack(3001, 5001);
+    Check(txBuf, "SACK of two segments");
+    sack(6001, 7001);
+    sack(8001, 9001);
+    Check(txBuf, "SACKs marking the first three segments lost");
+    NS_TEST_EXPECT_MSG_EQ(txBuf->GetLost(), 3000, "The first three segments must be lost");
+
+    // the first two lost segments are merged for the retransmission
+    txBuf->CopyFromSequence(2000, SequenceNumber32(1));
+    Check(txBuf, "Retransmission merging two lost segments");
+
+    // split a segment that is neither sacked nor lost, then merge it again
+    txBuf->CopyFromSequence(500, SequenceNumber32(5001));
+    Check(txBuf, "Retransmission splitting a segment");
+    txBuf->CopyFromSequence(1000, SequenceNumber32(5001));
+    Check(txBuf, "Retransmission merging a retransmitted and a new part");
+
+    // the retransmitted segment gets marked lost
+    sack(9001, 10001);
+    Check(txBuf, "SACK marking a retransmitted segment lost");
+    NS_TEST_EXPECT_MSG_EQ(txBuf->IsLost(SequenceNumber32(5001)), true, "[5001;6001) must be lost");
+
+    // split a segment in three, and sack its first part
+    txBuf->CopyFromSequence(300, SequenceNumber32(7501));
+    Check(txBuf, "Retransmission in the middle of a segment");
+    sack(7001, 7501);
+    Check(txBuf, "SACK of the first part of a split segment");
+    NS_TEST_EXPECT_MSG_EQ(txBuf->m_sentList.size(), 11, "Unexpected number of items");
+
+    // sack the retransmitted and lost segment
+    sack(5001, 6001);
+    Check(txBuf, "SACK of a retransmitted lost segment");
+
+    // discard up to the middle of the retransmitted head, then of the lost segment
+    txBuf->DiscardUpTo(SequenceNumber32(1501));
+    Check(txBuf, "Discard splitting the retransmitted head");
+    txBuf->DiscardUpTo(SequenceNumber32(2501));
+    Check(txBuf, "Discard splitting a lost segment");
+
+    // new segments after the recovery
+    txBuf->CopyFromSequence(1000, SequenceNumber32(10001));
+    txBuf->CopyFromSequence(1000, SequenceNumber32(11001));
+    Check(txBuf, "New segments");
+
+    // a retransmission timeout marks everything lost, and the retransmissions
+    // merge the lost segments again
+    m_sackLossOnly = false;
+    txBuf->SetSentListLost(false);
+    Check(txBuf, "Retransmission timeout");
+    txBuf->CopyFromSequence(1000, txBuf->HeadSequence());
+    Check(txBuf, "Retransmission of the head after the timeout");
+    txBuf->CopyFromSequence(1500, SequenceNumber32(10001));
+    Check(txBuf, "Retransmission merging lost segments after the timeout");
+    NS_TEST_EXPECT_MSG_EQ(txBuf->GetRetransmitsCount(), 2000, "Unexpected retransmitted bytes");
+    txBuf->ResetSentList();
+    Check(txBuf, "Reset of the sent list");
+    txBuf->DiscardUpTo(SequenceNumber32(12001));
+    Check(txBuf, "Discard of every sent segment");
+}
+
 /**
  * \ingroup internet-test
  *
@@ -442,6 +798,7 @@ class TcpTxBufferTestSuite : public TestSuite
         : TestSuite("tcp-tx-buffer", Type::UNIT)
     {
         AddTestCase(new TcpTxBufferTestCase, TestCase::Duration::QUICK);
+        AddTestCase(new TcpTxBufferIndexTestCase, TestCase::Duration::QUICK);
     }
 };
 
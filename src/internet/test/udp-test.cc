@@ -31,6 +31,7 @@
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/ipv4-static-routing.h"
 #include "ns3/ipv6-address-helper.h"
 #include "ns3/ipv6-l3-protocol.h"
@@ -760,6 +761,116 @@ Udp6SocketImplTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief UDP Socket over IPv4 Test of the route cached by the connected sockets
+ */
+class UdpSocketCachedRouteTest : public TestCase
+{
+    Address m_receivedFrom; //!< Source address of the last received packet.
+
+    /**
+     * \brief Send a packet from a socket and return its source address.
+     * \param socket The sending socket.
+     * \returns The source address of the packet at the receiver.
+     */
+    Ipv4Address SendData(Ptr<Socket> socket);
+
+    /**
+     * \brief Receive packets.
+     * \param socket The receiving socket.
+     */
+    void ReceivePkt(Ptr<Socket> socket);
+
+  public:
+    void DoRun() override;
+    UdpSocketCachedRouteTest();
+};
+
+UdpSocketCachedRouteTest::UdpSocketCachedRouteTest()
+    : TestCase("UDP socket route cache")
+{
+}
+
+void
+UdpSocketCachedRouteTest::ReceivePkt(Ptr<Socket> socket)
+{
+    socket->RecvFrom(m_receivedFrom);
+}
+
+Ipv4Address
+UdpSocketCachedRouteTest::SendData(Ptr<Socket> socket)
+{
+    m_receivedFrom = Address();
+    Simulator::ScheduleWithContext(socket->GetNode()->GetId(), Seconds(0), [this, socket]() {
+        NS_TEST_EXPECT_MSG_EQ(socket->Send(Create<Packet>(123)), 123, "the packet was not sent");
+    });
+    Simulator::Run();
+    if (!InetSocketAddress::IsMatchingType(m_receivedFrom))
+    {
+        NS_TEST_EXPECT_MSG_EQ(true, false, "the packet was not received");
+        return Ipv4Address();
+    }
+    return InetSocketAddress::ConvertFrom(m_receivedFrom).GetIpv4();
+}
+
+void
+UdpSocketCachedRouteTest::DoRun()
+{
+    // Two nodes connected by two links
+    Ptr<Node> rxNode = CreateObject<Node>();
+    Ptr<Node> txNode = CreateObject<Node>();
+    NodeContainer nodes(rxNode, txNode);
+
+    SimpleNetDeviceHelper helperChannel;
+    helperChannel.SetNetDevicePointToPointMode(true);
+    NetDeviceContainer net1 = helperChannel.Install(nodes);
+    NetDeviceContainer net2 = helperChannel.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+
+    const char* addresses[2][2] = {{"10.0.0.1", "10.0.1.1"}, {"10.0.0.2", "10.0.1.2"}};
+    for (uint32_t n = 0; n < 2; n++)
+    {
+        Ptr<Ipv4> ipv4 = nodes.Get(n)->GetObject<Ipv4>();
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            uint32_t index = ipv4->AddInterface((i == 0 ? net1 : net2).Get(n));
+            ipv4->AddAddress(index, Ipv4InterfaceAddress(Ipv4Address(addresses[n][i]), "/24"));
+            ipv4->SetUp(index);
+        }
+    }
+
+    Ptr<Socket> rxSocket = rxNode->GetObject<UdpSocketFactory>()->CreateSocket();
+    NS_TEST_EXPECT_MSG_EQ(rxSocket->Bind(InetSocketAddress(Ipv4Address::GetAny(), 1234)),
+                          0,
+                          "trivial");
+    rxSocket->SetRecvCallback(MakeCallback(&UdpSocketCachedRouteTest::ReceivePkt, this));
+
+    Ptr<Socket> txSocket = txNode->GetObject<UdpSocketFactory>()->CreateSocket();
+    NS_TEST_EXPECT_MSG_EQ(txSocket->Connect(InetSocketAddress("10.0.0.1", 1234)),
+                          0,
+                          "the connect operation failed");
+
+    // the first packet looks up the route, the second one reuses it
+    NS_TEST_EXPECT_MSG_EQ(SendData(txSocket), Ipv4Address("10.0.0.2"), "wrong source address");
+    NS_TEST_EXPECT_MSG_EQ(SendData(txSocket), Ipv4Address("10.0.0.2"), "wrong source address");
+
+    // a host route through the second link replaces the cached route
+    Ptr<Ipv4StaticRouting> routing =
+        Ipv4StaticRoutingHelper().GetStaticRouting(txNode->GetObject<Ipv4>());
+    routing->AddHostRouteTo("10.0.0.1", "10.0.1.1", 2);
+    NS_TEST_EXPECT_MSG_EQ(SendData(txSocket), Ipv4Address("10.0.1.2"), "wrong source address");
+    NS_TEST_EXPECT_MSG_EQ(SendData(txSocket), Ipv4Address("10.0.1.2"), "wrong source address");
+
+    routing->RemoveRoute(routing->GetNRoutes() - 1);
+    NS_TEST_EXPECT_MSG_EQ(SendData(txSocket), Ipv4Address("10.0.0.2"), "wrong source address");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -773,6 +884,7 @@ class UdpTestSuite : public TestSuite
     {
         AddTestCase(new UdpSocketImplTest, TestCase::Duration::QUICK);
         AddTestCase(new UdpSocketLoopbackTest, TestCase::Duration::QUICK);
+        AddTestCase(new UdpSocketCachedRouteTest, TestCase::Duration::QUICK);
         AddTestCase(new Udp6SocketImplTest, TestCase::Duration::QUICK);
         AddTestCase(new Udp6SocketLoopbackTest, TestCase::Duration::QUICK);
     }
@@ -19,6 +19,9 @@
 
 #include "ns3/abort.h"
 #include "ns3/assert.h"
+#include "ns3/binary-trace-file.h"
+#include "ns3/enum.h"
+#include "ns3/global-value.h"
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/net-device.h"
@@ -35,6 +38,22 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("TraceHelper");
 
+/**
+ * \relates AsciiTraceHelper
+ * \anchor GlobalValueAsciiTraceFormat
+ * \brief The format of the files created by AsciiTraceHelper::CreateFileStream().
+ */
+static GlobalValue g_asciiTraceFormat =
+    GlobalValue("AsciiTraceFormat",
+                "The format of the ascii trace files: Text, Binary or BinaryWithPackets",
+                EnumValue(AsciiTraceHelper::TEXT),
+                MakeEnumChecker(AsciiTraceHelper::TEXT,
+                                "Text",
+                                AsciiTraceHelper::BINARY,
+                                "Binary",
+                                AsciiTraceHelper::BINARY_WITH_PACKETS,
+                                "BinaryWithPackets"));
+
 PcapHelper::PcapHelper()
 {
     NS_LOG_FUNCTION_NOARGS();
@@ -194,6 +213,13 @@ AsciiTraceHelper::CreateFileStream(std::string filename, std::ios::openmode file
 {
     NS_LOG_FUNCTION(filename << filemode);
 
+    EnumValue<Format> format;
+    g_asciiTraceFormat.GetValue(format);
+    if (format.Get() != TEXT)
+    {
+        return CreateBinaryFileStream(filename, filemode, format.Get() == BINARY_WITH_PACKETS);
+    }
+
     Ptr<OutputStreamWrapper> StreamWrapper = Create<OutputStreamWrapper>(filename, filemode);
 
     //
@@ -210,6 +236,23 @@ AsciiTraceHelper::CreateFileStream(std::string filename, std::ios::openmode file
     return StreamWrapper;
 }
 
+Ptr<OutputStreamWrapper>
+AsciiTraceHelper::CreateBinaryFileStream(std::string filename,
+                                         std::ios::openmode filemode,
+                                         bool capturePackets)
+{
+    NS_LOG_FUNCTION(filename << filemode << capturePackets);
+
+    Ptr<BinaryTraceFile> file = Create<BinaryTraceFile>();
+    file->Open(filename, filemode, capturePackets);
+    NS_ABORT_MSG_IF(file->Fail(),
+                    "AsciiTraceHelper::CreateBinaryFileStream():  Unable to Open "
+                        << filename << " for mode " << filemode);
+
+    // the stream wrapper owns the file, see CreateFileStream()
+    return Create<OutputStreamWrapper>(file);
+}
+
 std::string
 AsciiTraceHelper::GetFilenameFromDevice(std::string prefix,
                                         Ptr<NetDevice> device,
@@ -314,6 +357,11 @@ AsciiTraceHelper::DefaultEnqueueSinkWithoutContext(Ptr<OutputStreamWrapper> stre
                                                    Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
+    if (Ptr<BinaryTraceFile> file = stream->GetBinaryTraceFile())
+    {
+        file->Write(BinaryTraceFile::ENQUEUE, Simulator::Now(), std::string(), p);
+        return;
+    }
     *stream->GetStream() << "+ " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
 }
 
@@ -323,6 +371,11 @@ AsciiTraceHelper::DefaultEnqueueSinkWithContext(Ptr<OutputStreamWrapper> stream,
                                                 Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
+    if (Ptr<BinaryTraceFile> file = stream->GetBinaryTraceFile())
+    {
+        file->Write(BinaryTraceFile::ENQUEUE, Simulator::Now(), context, p);
+        return;
+    }
     *stream->GetStream() << "+ " << Simulator::Now().GetSeconds() << " " << context << " " << *p
                          << std::endl;
 }
@@ -344,6 +397,11 @@ AsciiTraceHelper::DefaultDropSinkWithoutContext(Ptr<OutputStreamWrapper> stream,
                                                 Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
+    if (Ptr<BinaryTraceFile> file = stream->GetBinaryTraceFile())
+    {
+        file->Write(BinaryTraceFile::DROP, Simulator::Now(), std::string(), p);
+        return;
+    }
     *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
 }
 
@@ -353,6 +411,11 @@ AsciiTraceHelper::DefaultDropSinkWithContext(Ptr<OutputStreamWrapper> stream,
                                              Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
+    if (Ptr<BinaryTraceFile> file = stream->GetBinaryTraceFile())
+    {
+        file->Write(BinaryTraceFile::DROP, Simulator::Now(), context, p);
+        return;
+    }
     *stream->GetStream() << "d " << Simulator::Now().GetSeconds() << " " << context << " " << *p
                          << std::endl;
 }
@@ -375,6 +438,11 @@ AsciiTraceHelper::DefaultDequeueSinkWithoutContext(Ptr<OutputStreamWrapper> stre
                                                    Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
+    if (Ptr<BinaryTraceFile> file = stream->GetBinaryTraceFile())
+    {
+        file->Write(BinaryTraceFile::DEQUEUE, Simulator::Now(), std::string(), p);
+        return;
+    }
     *stream->GetStream() << "- " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
 }
 
@@ -384,6 +452,11 @@ AsciiTraceHelper::DefaultDequeueSinkWithContext(Ptr<OutputStreamWrapper> stream,
                                                 Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
+    if (Ptr<BinaryTraceFile> file = stream->GetBinaryTraceFile())
+    {
+        file->Write(BinaryTraceFile::DEQUEUE, Simulator::Now(), context, p);
+        return;
+    }
     *stream->GetStream() << "- " << Simulator::Now().GetSeconds() << " " << context << " " << *p
                          << std::endl;
 }
@@ -403,6 +476,11 @@ AsciiTraceHelper::DefaultReceiveSinkWithoutContext(Ptr<OutputStreamWrapper> stre
                                                    Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
+    if (Ptr<BinaryTraceFile> file = stream->GetBinaryTraceFile())
+    {
+        file->Write(BinaryTraceFile::RECEIVE, Simulator::Now(), std::string(), p);
+        return;
+    }
     *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << *p << std::endl;
 }
 
@@ -412,6 +490,11 @@ AsciiTraceHelper::DefaultReceiveSinkWithContext(Ptr<OutputStreamWrapper> stream,
                                                 Ptr<const Packet> p)
 {
     NS_LOG_FUNCTION(stream << p);
+    if (Ptr<BinaryTraceFile> file = stream->GetBinaryTraceFile())
+    {
+        file->Write(BinaryTraceFile::RECEIVE, Simulator::Now(), context, p);
+        return;
+    }
     *stream->GetStream() << "r " << Simulator::Now().GetSeconds() << " " << context << " " << *p
                          << std::endl;
 }
@@ -173,6 +173,19 @@ PcapHelper::HookDefaultSink(Ptr<T> object, std::string tracename, Ptr<PcapFileWr
 class AsciiTraceHelper
 {
   public:
+    /**
+     * @brief Formats of the trace files created by CreateFileStream().
+     *
+     * The format is selected by the "AsciiTraceFormat" global value, so that
+     * all the EnableAscii* helper methods create files of the same format.
+     */
+    enum Format
+    {
+        TEXT,                //!< One text line per event
+        BINARY,              //!< BinaryTraceFile records
+        BINARY_WITH_PACKETS, //!< BinaryTraceFile records holding the serialized packets
+    };
+
     /**
      * @brief Create an ascii trace helper.
      */
@@ -238,6 +251,24 @@ class AsciiTraceHelper
     Ptr<OutputStreamWrapper> CreateFileStream(std::string filename,
                                               std::ios::openmode filemode = std::ios::out);
 
+    /**
+     * @brief Create an output stream object writing a binary trace file,
+     * regardless of the "AsciiTraceFormat" global value.
+     *
+     * The default trace sinks write compact BinaryTraceFile records to
+     * the file instead of text lines; BinaryTraceFile::ConvertToAscii()
+     * renders the file as text offline.
+     *
+     * @param filename file name
+     * @param filemode file mode
+     * @param capturePackets whether to store the serialized packets, so that
+     *        the packet contents can be printed when the file is converted
+     * @returns a smart pointer to the output stream
+     */
+    Ptr<OutputStreamWrapper> CreateBinaryFileStream(std::string filename,
+                                                    std::ios::openmode filemode = std::ios::out,
+                                                    bool capturePackets = false);
+
     /**
      * @brief Hook a trace source to the default enqueue operation trace sink that
      * does not accept nor log a trace context.
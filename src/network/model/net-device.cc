@@ -20,6 +20,8 @@
 #include "net-device.h"
 
 #include "ns3/log.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/packet-burst.h"
 
 namespace ns3
 {
@@ -40,4 +42,34 @@ NetDevice::~NetDevice()
     NS_LOG_FUNCTION(this);
 }
 
+uint32_t
+NetDevice::SendBurst(Ptr<PacketBurst> burst, const Address& dest, uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(this << burst << dest << protocolNumber);
+    // the transmission queue of the packets is only known to a single queue device
+    Ptr<NetDeviceQueue> txQueue;
+    Ptr<NetDeviceQueueInterface> ndqi = GetObject<NetDeviceQueueInterface>();
+    if (ndqi && ndqi->GetNTxQueues() == 1)
+    {
+        txQueue = ndqi->GetTxQueue(0);
+    }
+    uint32_t taken = 0;
+    for (auto it = burst->Begin(); it != burst->End(); ++it, ++taken)
+    {
+        if (txQueue && txQueue->IsStopped())
+        {
+            break;
+        }
+        Send(*it, dest, protocolNumber);
+    }
+    return taken;
+}
+
+bool
+NetDevice::SupportsSegmentOffload() const
+{
+    NS_LOG_FUNCTION(this);
+    return false;
+}
+
 } // namespace ns3
@@ -36,6 +36,7 @@ namespace ns3
 
 class Node;
 class Channel;
+class PacketBurst;
 
 /**
  * \ingroup network
@@ -264,6 +265,28 @@ class NetDevice : public Object
                           const Address& source,
                           const Address& dest,
                           uint16_t protocolNumber) = 0;
+    /**
+     * \param burst packets sent from above down to Network Device
+     * \param dest mac address of the destination (already resolved)
+     * \param protocolNumber identifies the type of payload contained in
+     *        the packets of the burst.
+     *
+     *  Called from higher layer to send several packets to the same
+     *  destination in a single call. Devices may override this method to
+     *  amortize the per-packet work (link state checks, transmitter start);
+     *  the default implementation calls Send for each packet in turn.
+     *  Traces are fired for every packet as if it had been sent on its own.
+     *  A device with a single transmission queue stops taking the packets of
+     *  the burst once that queue is stopped (see NetDeviceQueue), so that the
+     *  caller can drop the packets left as it drops the packets sent one by
+     *  one to a stopped queue.
+     *
+     * \return the number of leading packets of the burst taken by the device,
+     *         whether they were queued or dropped
+     */
+    virtual uint32_t SendBurst(Ptr<PacketBurst> burst,
+                               const Address& dest,
+                               uint16_t protocolNumber);
     /**
      * \returns the node base class which contains this network
      *          interface.
@@ -367,6 +390,16 @@ class NetDevice : public Object
      * \return true if this interface supports a bridging mode, false otherwise.
      */
     virtual bool SupportsSendFrom() const = 0;
+
+    /**
+     * Devices supporting segmentation offload transmit the packets carrying
+     * a SegmentOffloadTag in one go, even if they are larger than the MTU,
+     * and account for the headers of all the segments they stand for in the
+     * transmission time. The default implementation returns false.
+     *
+     * \return true if this interface supports segmentation offload, false otherwise.
+     */
+    virtual bool SupportsSegmentOffload() const;
 };
 
 } // namespace ns3
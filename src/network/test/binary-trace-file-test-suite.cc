@@ -0,0 +1,261 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/binary-trace-file.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/ethernet-trailer.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/trace-helper.h"
+
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the records written to a binary trace file are read back.
+ */
+class BinaryTraceFileRecordTest : public TestCase
+{
+  public:
+    BinaryTraceFileRecordTest();
+
+  private:
+    void DoRun() override;
+};
+
+BinaryTraceFileRecordTest::BinaryTraceFileRecordTest()
+    : TestCase("Write and read back binary trace records")
+{
+}
+
+void
+BinaryTraceFileRecordTest::DoRun()
+{
+    Packet::EnablePrinting();
+
+    Ptr<Packet> p = Create<Packet>(100);
+    p->AddHeader(LlcSnapHeader());
+    p->AddHeader(EthernetHeader());
+    p->AddTrailer(EthernetTrailer());
+
+    std::string filename = CreateTempDirFilename("binary-trace-record.tr");
+    BinaryTraceFile file;
+    file.Open(filename, std::ios::out);
+    NS_TEST_ASSERT_MSG_EQ(file.Fail(), false, "Unable to open " << filename);
+    std::string context = "/NodeList/3/DeviceList/1/$ns3::CsmaNetDevice/TxQueue/Enqueue";
+    file.Write(BinaryTraceFile::ENQUEUE, Seconds(1), context, p);
+    file.Write(BinaryTraceFile::DEQUEUE, Seconds(1.5), context, p);
+    file.WriteText("some text\n");
+    file.Write(BinaryTraceFile::DROP, Seconds(2), "", p);
+    file.Close();
+
+    // append a second run, with its own file header
+    file.Open(filename, std::ios::out | std::ios::app);
+    *file.GetTextStream() << "appended" << std::endl;
+    file.Write(BinaryTraceFile::RECEIVE, Seconds(0.5), context, p);
+    file.Close();
+
+    BinaryTraceFile reader;
+    reader.Open(filename, std::ios::in);
+    BinaryTraceFile::Record record;
+
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(record), true, "Missing record");
+    NS_TEST_EXPECT_MSG_EQ(record.type, BinaryTraceFile::ENQUEUE, "Bad type");
+    NS_TEST_EXPECT_MSG_EQ(record.time, Seconds(1).GetTimeStep(), "Bad time");
+    NS_TEST_EXPECT_MSG_EQ(record.seconds, 1.0, "Bad time in seconds");
+    NS_TEST_EXPECT_MSG_EQ(record.context, context, "Bad context");
+    NS_TEST_EXPECT_MSG_EQ(record.nodeId, 3, "Bad node id");
+    NS_TEST_EXPECT_MSG_EQ(record.deviceId, 1, "Bad device id");
+    NS_TEST_EXPECT_MSG_EQ(record.uid, p->GetUid(), "Bad uid");
+    NS_TEST_EXPECT_MSG_EQ(record.size, p->GetSize(), "Bad size");
+    NS_TEST_ASSERT_MSG_EQ(record.headers.size(), 3, "Bad number of headers");
+    NS_TEST_EXPECT_MSG_EQ(record.headers[0], "ns3::EthernetHeader", "Bad header");
+    NS_TEST_EXPECT_MSG_EQ(record.headers[1], "ns3::LlcSnapHeader", "Bad header");
+    NS_TEST_EXPECT_MSG_EQ(record.headers[2], "ns3::EthernetTrailer", "Bad trailer");
+    NS_TEST_EXPECT_MSG_EQ(record.packet.empty(), true, "Packet not captured expected");
+
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(record), true, "Missing record");
+    NS_TEST_EXPECT_MSG_EQ(record.type, BinaryTraceFile::DEQUEUE, "Bad type");
+    NS_TEST_EXPECT_MSG_EQ(record.seconds, 1.5, "Bad time in seconds");
+    NS_TEST_EXPECT_MSG_EQ(record.context, context, "Bad context");
+
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(record), true, "Missing record");
+    NS_TEST_EXPECT_MSG_EQ(record.type, BinaryTraceFile::TEXT, "Bad type");
+    NS_TEST_EXPECT_MSG_EQ(record.text, "some text\n", "Bad text");
+
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(record), true, "Missing record");
+    NS_TEST_EXPECT_MSG_EQ(record.type, BinaryTraceFile::DROP, "Bad type");
+    NS_TEST_EXPECT_MSG_EQ(record.seconds, 2.0, "Bad time in seconds");
+    NS_TEST_EXPECT_MSG_EQ(record.context, "", "Bad context");
+    NS_TEST_EXPECT_MSG_EQ(record.nodeId, BinaryTraceFile::NO_ID, "Bad node id");
+
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(record), true, "Missing record");
+    NS_TEST_EXPECT_MSG_EQ(record.type, BinaryTraceFile::TEXT, "Bad type");
+    NS_TEST_EXPECT_MSG_EQ(record.text, "appended\n", "Bad text");
+
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(record), true, "Missing record");
+    NS_TEST_EXPECT_MSG_EQ(record.type, BinaryTraceFile::RECEIVE, "Bad type");
+    NS_TEST_EXPECT_MSG_EQ(record.seconds, 0.5, "Bad time in seconds");
+    NS_TEST_EXPECT_MSG_EQ(record.context, context, "Bad context");
+    NS_TEST_EXPECT_MSG_EQ(record.headers.size(), 3, "Bad number of headers");
+
+    NS_TEST_EXPECT_MSG_EQ(reader.Read(record), false, "Unexpected record");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that a binary trace file holding the serialized packets is
+ * converted to the text written by the default ascii trace sinks.
+ */
+class BinaryTraceFileAsciiTest : public TestCase
+{
+  public:
+    BinaryTraceFileAsciiTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Hook the default sinks to a stream.
+     * \param stream the stream
+     * \param p the packet to trace
+     */
+    void TraceAll(Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p);
+};
+
+BinaryTraceFileAsciiTest::BinaryTraceFileAsciiTest()
+    : TestCase("Convert a binary trace file to ascii")
+{
+}
+
+void
+BinaryTraceFileAsciiTest::TraceAll(Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
+{
+    std::string context = "/NodeList/0/DeviceList/0/$ns3::CsmaNetDevice/TxQueue/Enqueue";
+    AsciiTraceHelper::DefaultEnqueueSinkWithContext(stream, context, p);
+    AsciiTraceHelper::DefaultDequeueSinkWithoutContext(stream, p);
+    *stream->GetStream() << "text written by another sink" << std::endl;
+    AsciiTraceHelper::DefaultDropSinkWithContext(stream, context, p);
+    AsciiTraceHelper::DefaultReceiveSinkWithoutContext(stream, p);
+}
+
+void
+BinaryTraceFileAsciiTest::DoRun()
+{
+    Packet::EnablePrinting();
+
+    Ptr<Packet> p = Create<Packet>(100);
+    p->AddHeader(LlcSnapHeader());
+    p->AddHeader(EthernetHeader());
+
+    std::ostringstream expected;
+    Simulator::Schedule(Seconds(1.25),
+                        &BinaryTraceFileAsciiTest::TraceAll,
+                        this,
+                        Create<OutputStreamWrapper>(&expected),
+                        p);
+
+    AsciiTraceHelper helper;
+    std::string filename = CreateTempDirFilename("binary-trace-ascii.tr");
+    Ptr<OutputStreamWrapper> stream = helper.CreateBinaryFileStream(filename, std::ios::out, true);
+    NS_TEST_ASSERT_MSG_NE(stream->GetBinaryTraceFile(), nullptr, "Not a binary file stream");
+    Simulator::Schedule(Seconds(1.25), &BinaryTraceFileAsciiTest::TraceAll, this, stream, p);
+    Simulator::Run();
+    Simulator::Destroy();
+    stream = nullptr; // close the file
+
+    std::ostringstream converted;
+    uint64_t n = BinaryTraceFile::ConvertToAscii(filename, converted);
+    NS_TEST_EXPECT_MSG_EQ(n, 5, "Bad number of records");
+    NS_TEST_EXPECT_MSG_EQ(converted.str(), expected.str(), "Converted text differs");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that the buffered records of a binary trace file are written
+ * when the streams are flushed on a fatal error.
+ */
+class BinaryTraceFileFatalFlushTest : public TestCase
+{
+  public:
+    BinaryTraceFileFatalFlushTest();
+
+  private:
+    void DoRun() override;
+};
+
+BinaryTraceFileFatalFlushTest::BinaryTraceFileFatalFlushTest()
+    : TestCase("Write the buffered binary trace records on a fatal error")
+{
+}
+
+void
+BinaryTraceFileFatalFlushTest::DoRun()
+{
+    std::string filename = CreateTempDirFilename("binary-trace-fatal.tr");
+    BinaryTraceFile file;
+    file.Open(filename, std::ios::out);
+    NS_TEST_ASSERT_MSG_EQ(file.Fail(), false, "Unable to open " << filename);
+    file.Write(BinaryTraceFile::ENQUEUE, Seconds(1), "", Create<Packet>(100));
+    *file.GetTextStream() << "pending text";
+
+    // what NS_FATAL_ERROR does before terminating the program
+    FatalImpl::FlushStreams();
+
+    BinaryTraceFile reader;
+    reader.Open(filename, std::ios::in);
+    BinaryTraceFile::Record record;
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(record), true, "Buffered record not written");
+    NS_TEST_EXPECT_MSG_EQ(record.type, BinaryTraceFile::ENQUEUE, "Bad type");
+    NS_TEST_EXPECT_MSG_EQ(record.size, 100, "Bad size");
+    NS_TEST_ASSERT_MSG_EQ(reader.Read(record), true, "Pending text not written");
+    NS_TEST_EXPECT_MSG_EQ(record.type, BinaryTraceFile::TEXT, "Bad type");
+    NS_TEST_EXPECT_MSG_EQ(record.text, "pending text", "Bad text");
+    NS_TEST_EXPECT_MSG_EQ(reader.Read(record), false, "Unexpected record");
+    file.Close();
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Binary trace file TestSuite
+ */
+class BinaryTraceFileTestSuite : public TestSuite
+{
+  public:
+    BinaryTraceFileTestSuite();
+};
+
+BinaryTraceFileTestSuite::BinaryTraceFileTestSuite()
+    : TestSuite("binary-trace-file", Type::UNIT)
+{
+    AddTestCase(new BinaryTraceFileRecordTest, TestCase::Duration::QUICK);
+    AddTestCase(new BinaryTraceFileAsciiTest, TestCase::Duration::QUICK);
+    AddTestCase(new BinaryTraceFileFatalFlushTest, TestCase::Duration::QUICK);
+}
+
+static BinaryTraceFileTestSuite g_binaryTraceFileTest; //!< Static variable for test initialization
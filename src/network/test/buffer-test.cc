@@ -22,6 +22,8 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/test.h"
 
+#include <algorithm>
+
 using namespace ns3;
 
 /**
@@ -395,6 +397,104 @@ BufferTest::DoRun()
     NS_TEST_ASSERT_MSG_EQ(val1, val2, "Bad ReadNtohU16()");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Buffer::Iterator::CalculateIpChecksum tests.
+ *
+ * The segment-wise checksum is compared against a byte-at-a-time reference
+ * over buffers whose virtual zero area sits at every alignment.
+ */
+class BufferChecksumTest : public TestCase
+{
+  private:
+    /**
+     * Compute the checksum one 16-bit word at a time (RFC 1071).
+     * \param i iterator pointing to the first byte to checksum
+     * \param size number of bytes to checksum
+     * \param initialChecksum initial value
+     * \return the checksum
+     */
+    uint16_t ReferenceChecksum(Buffer::Iterator i, uint16_t size, uint32_t initialChecksum);
+
+  public:
+    void DoRun() override;
+    BufferChecksumTest();
+};
+
+BufferChecksumTest::BufferChecksumTest()
+    : TestCase("Buffer IP checksum")
+{
+}
+
+uint16_t
+BufferChecksumTest::ReferenceChecksum(Buffer::Iterator i, uint16_t size, uint32_t initialChecksum)
+{
+    uint32_t sum = initialChecksum;
+    for (uint16_t j = 0; j < size / 2; j++)
+    {
+        sum += i.ReadU16();
+    }
+    if (size & 1)
+    {
+        sum += i.ReadU8();
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return ~sum;
+}
+
+void
+BufferChecksumTest::DoRun()
+{
+    Ptr<UniformRandomVariable> bytesRng = CreateObject<UniformRandomVariable>();
+    bytesRng->SetAttribute("Max", DoubleValue(255));
+
+    for (uint32_t before = 0; before < 40; before += 3)
+    {
+        for (uint32_t zeroes = 0; zeroes < 12; zeroes += 1)
+        {
+            for (uint32_t after = 0; after < 40; after += 5)
+            {
+                Buffer buffer(zeroes);
+                buffer.AddAtStart(before);
+                buffer.AddAtEnd(after);
+                Buffer::Iterator i = buffer.Begin();
+                for (uint32_t j = 0; j < before; j++)
+                {
+                    i.WriteU8(bytesRng->GetInteger());
+                }
+                i.Next(zeroes);
+                for (uint32_t j = 0; j < after; j++)
+                {
+                    i.WriteU8(bytesRng->GetInteger());
+                }
+
+                uint32_t total = buffer.GetSize();
+                for (uint32_t offset = 0; offset < std::min<uint32_t>(total, 3); offset++)
+                {
+                    uint16_t size = total - offset;
+                    uint32_t initial = bytesRng->GetInteger() * 0x1234;
+                    Buffer::Iterator ref = buffer.Begin();
+                    ref.Next(offset);
+                    Buffer::Iterator fast = ref;
+                    uint16_t expected = ReferenceChecksum(ref, size, initial);
+                    uint16_t actual = fast.CalculateIpChecksum(size, initial);
+                    NS_TEST_ASSERT_MSG_EQ(actual,
+                                          expected,
+                                          "Bad checksum (before=" << before << ", zeroes=" << zeroes
+                                                                  << ", after=" << after
+                                                                  << ", offset=" << offset << ")");
+                    NS_TEST_ASSERT_MSG_EQ(fast.IsEnd(), true, "Iterator not advanced to the end");
+                }
+            }
+        }
+    }
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -411,6 +511,7 @@ BufferTestSuite::BufferTestSuite()
     : TestSuite("buffer", Type::UNIT)
 {
     AddTestCase(new BufferTest, TestCase::Duration::QUICK);
+    AddTestCase(new BufferChecksumTest, TestCase::Duration::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite; //!< Static variable for test initialization
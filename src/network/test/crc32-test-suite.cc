@@ -0,0 +1,137 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/crc32.h"
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief CRC-32 known answer test.
+ */
+class Crc32KnownValueTest : public TestCase
+{
+  public:
+    Crc32KnownValueTest();
+
+  private:
+    void DoRun() override;
+};
+
+Crc32KnownValueTest::Crc32KnownValueTest()
+    : TestCase("CRC-32 known values")
+{
+}
+
+void
+Crc32KnownValueTest::DoRun()
+{
+    const char* check = "123456789";
+    auto data = reinterpret_cast<const uint8_t*>(check);
+    int length = strlen(check);
+    NS_TEST_ASSERT_MSG_EQ(CRC32Calculate(data, length), 0xCBF43926, "Bad CRC-32 check value");
+    NS_TEST_ASSERT_MSG_EQ(CRC32CalculateBytewise(data, length),
+                          0xCBF43926,
+                          "Bad bytewise CRC-32 check value");
+    NS_TEST_ASSERT_MSG_EQ(CRC32CalculateSliceBy8(data, length),
+                          0xCBF43926,
+                          "Bad slice-by-8 CRC-32 check value");
+    NS_TEST_ASSERT_MSG_EQ(CRC32Calculate(data, 0), 0, "Bad CRC-32 of an empty buffer");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that all the CRC-32 implementations agree.
+ *
+ * Lengths and alignments are chosen to exercise the transition between the
+ * 16-byte blocks handled by carry-less multiplication and the trailing bytes.
+ */
+class Crc32ImplementationsTest : public TestCase
+{
+  public:
+    Crc32ImplementationsTest();
+
+  private:
+    void DoRun() override;
+};
+
+Crc32ImplementationsTest::Crc32ImplementationsTest()
+    : TestCase("CRC-32 implementations agree")
+{
+}
+
+void
+Crc32ImplementationsTest::DoRun()
+{
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    rng->SetAttribute("Max", DoubleValue(255));
+    std::vector<uint8_t> data(2048);
+    for (auto& byte : data)
+    {
+        byte = rng->GetInteger();
+    }
+
+    for (int offset = 0; offset < 8; offset++)
+    {
+        for (int length = 0; length < 1600; length += (length < 200 ? 1 : 37))
+        {
+            const uint8_t* start = data.data() + offset;
+            uint32_t expected = CRC32CalculateBytewise(start, length);
+            NS_TEST_ASSERT_MSG_EQ(CRC32CalculateSliceBy8(start, length),
+                                  expected,
+                                  "Slice-by-8 mismatch (offset=" << offset
+                                                                 << ", length=" << length << ")");
+            NS_TEST_ASSERT_MSG_EQ(CRC32CalculateClmul(start, length),
+                                  expected,
+                                  "CLMUL mismatch (offset=" << offset << ", length=" << length
+                                                            << ")");
+            NS_TEST_ASSERT_MSG_EQ(CRC32Calculate(start, length),
+                                  expected,
+                                  "Dispatch mismatch (offset=" << offset << ", length=" << length
+                                                               << ")");
+        }
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief CRC-32 TestSuite
+ */
+class Crc32TestSuite : public TestSuite
+{
+  public:
+    Crc32TestSuite();
+};
+
+Crc32TestSuite::Crc32TestSuite()
+    : TestSuite("crc32", Type::UNIT)
+{
+    AddTestCase(new Crc32KnownValueTest, TestCase::Duration::QUICK);
+    AddTestCase(new Crc32ImplementationsTest, TestCase::Duration::QUICK);
+}
+
+static Crc32TestSuite g_crc32TestSuite; //!< Static variable for test initialization
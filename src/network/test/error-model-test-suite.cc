@@ -30,6 +30,7 @@
 #include "ns3/error-model.h"
 #include "ns3/mac48-address.h"
 #include "ns3/node.h"
+#include "ns3/packet-burst.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
 #include "ns3/queue.h"
@@ -288,6 +289,122 @@ BurstErrorModelSimple::DoRun()
     NS_TEST_ASSERT_MSG_EQ(m_drops, 260, "Wrong number of drops.");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Check that evaluating a burst of packets gives the same outcome as
+ * evaluating each packet in turn.
+ */
+class ErrorModelBurstEvaluation : public TestCase
+{
+  public:
+    ErrorModelBurstEvaluation();
+
+  private:
+    void DoRun() override;
+    /**
+     * Compare the burst evaluation of a model with the per-packet evaluation
+     * of an identical model.
+     * \param burstModel the model evaluating the burst
+     * \param packetModel the model evaluating each packet
+     * \param burst the packets
+     * \param what description of the models
+     */
+    void Compare(Ptr<ErrorModel> burstModel,
+                 Ptr<ErrorModel> packetModel,
+                 Ptr<PacketBurst> burst,
+                 std::string what);
+};
+
+ErrorModelBurstEvaluation::ErrorModelBurstEvaluation()
+    : TestCase("ErrorModel evaluation of packet bursts")
+{
+}
+
+void
+ErrorModelBurstEvaluation::Compare(Ptr<ErrorModel> burstModel,
+                                   Ptr<ErrorModel> packetModel,
+                                   Ptr<PacketBurst> burst,
+                                   std::string what)
+{
+    std::vector<bool> corrupt;
+    uint32_t n = burstModel->IsCorrupt(burst, corrupt);
+    NS_TEST_ASSERT_MSG_EQ(corrupt.size(), burst->GetNPackets(), what << ": bad number of flags");
+    uint32_t expected = 0;
+    std::size_t i = 0;
+    for (auto it = burst->Begin(); it != burst->End(); ++it, ++i)
+    {
+        bool isCorrupt = packetModel->IsCorrupt(*it);
+        NS_TEST_EXPECT_MSG_EQ(corrupt[i], isCorrupt, what << ": packet " << i << " differs");
+        expected += isCorrupt ? 1 : 0;
+    }
+    NS_TEST_EXPECT_MSG_EQ(n, expected, what << ": bad number of errored packets");
+}
+
+void
+ErrorModelBurstEvaluation::DoRun()
+{
+    Ptr<UniformRandomVariable> sizes = CreateObject<UniformRandomVariable>();
+    sizes->SetStream(10);
+    Ptr<PacketBurst> burst = CreateObject<PacketBurst>();
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        burst->AddPacket(Create<Packet>(sizes->GetInteger(40, 1500)));
+    }
+
+    Ptr<RateErrorModel> burstModel = CreateObject<RateErrorModel>();
+    Ptr<RateErrorModel> packetModel = CreateObject<RateErrorModel>();
+    burstModel->AssignStreams(20);
+    packetModel->AssignStreams(20);
+
+    burstModel->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+    packetModel->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+    burstModel->SetRate(0.1);
+    packetModel->SetRate(0.1);
+    Compare(burstModel, packetModel, burst, "packet unit");
+
+    burstModel->SetUnit(RateErrorModel::ERROR_UNIT_BYTE);
+    packetModel->SetUnit(RateErrorModel::ERROR_UNIT_BYTE);
+    burstModel->SetRate(1e-4);
+    packetModel->SetRate(1e-4);
+    Compare(burstModel, packetModel, burst, "byte unit");
+
+    // the packet error rates cached for the byte unit must not be reused
+    burstModel->SetUnit(RateErrorModel::ERROR_UNIT_BIT);
+    packetModel->SetUnit(RateErrorModel::ERROR_UNIT_BIT);
+    Compare(burstModel, packetModel, burst, "bit unit");
+    burstModel->SetAttribute("ErrorRate", DoubleValue(1e-5));
+    packetModel->SetAttribute("ErrorRate", DoubleValue(1e-5));
+    Compare(burstModel, packetModel, burst, "bit unit, new rate");
+
+    burstModel->Disable();
+    packetModel->Disable();
+    Compare(burstModel, packetModel, burst, "disabled");
+
+    std::list<uint64_t> uids;
+    std::size_t i = 0;
+    for (auto it = burst->Begin(); it != burst->End(); ++it, ++i)
+    {
+        if (i % 7 == 3)
+        {
+            uids.push_back((*it)->GetUid());
+        }
+    }
+    Ptr<ListErrorModel> listModel = CreateObject<ListErrorModel>();
+    listModel->SetList(uids);
+    Compare(listModel, listModel, burst, "list");
+    std::vector<bool> corrupt;
+    NS_TEST_EXPECT_MSG_EQ(listModel->IsCorrupt(burst, corrupt), uids.size(), "bad list outcome");
+    listModel->Reset();
+    NS_TEST_EXPECT_MSG_EQ(listModel->IsCorrupt(burst, corrupt), 0, "list not cleared");
+
+    // default implementation
+    Ptr<BinaryErrorModel> binaryBurst = CreateObject<BinaryErrorModel>();
+    Ptr<BinaryErrorModel> binaryPacket = CreateObject<BinaryErrorModel>();
+    Compare(binaryBurst, binaryPacket, burst, "binary");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -309,6 +426,7 @@ ErrorModelTestSuite::ErrorModelTestSuite()
 {
     AddTestCase(new ErrorModelSimple, TestCase::Duration::QUICK);
     AddTestCase(new BurstErrorModelSimple, TestCase::Duration::QUICK);
+    AddTestCase(new ErrorModelBurstEvaluation, TestCase::Duration::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
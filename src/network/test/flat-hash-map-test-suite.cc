@@ -0,0 +1,212 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/double.h"
+#include "ns3/flat-hash-map.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+#include <map>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief FlatHashMap basic operations test.
+ */
+class FlatHashMapBasicTest : public TestCase
+{
+  public:
+    FlatHashMapBasicTest();
+
+  private:
+    void DoRun() override;
+};
+
+FlatHashMapBasicTest::FlatHashMapBasicTest()
+    : TestCase("FlatHashMap basic operations")
+{
+}
+
+void
+FlatHashMapBasicTest::DoRun()
+{
+    FlatHashMap<Ipv4Address, uint32_t> map;
+    NS_TEST_ASSERT_MSG_EQ(map.empty(), true, "New map not empty");
+    NS_TEST_ASSERT_MSG_EQ((map.find(Ipv4Address("10.0.0.1")) == map.end()),
+                          true,
+                          "Found a key in an empty map");
+
+    map[Ipv4Address("10.0.0.1")] = 1;
+    auto [it, inserted] = map.insert({Ipv4Address("10.0.0.2"), 2});
+    NS_TEST_ASSERT_MSG_EQ(inserted, true, "Element not inserted");
+    NS_TEST_ASSERT_MSG_EQ(it->second, 2, "Wrong value inserted");
+    std::tie(it, inserted) = map.insert({Ipv4Address("10.0.0.2"), 3});
+    NS_TEST_ASSERT_MSG_EQ(inserted, false, "Duplicate key inserted");
+    NS_TEST_ASSERT_MSG_EQ(it->second, 2, "Existing value overwritten");
+    NS_TEST_ASSERT_MSG_EQ(map.size(), 2, "Wrong size");
+    NS_TEST_ASSERT_MSG_EQ(map.count(Ipv4Address("10.0.0.1")), 1, "Key not found");
+
+    NS_TEST_ASSERT_MSG_EQ(map.erase(Ipv4Address("10.0.0.1")), 1, "Key not erased");
+    NS_TEST_ASSERT_MSG_EQ(map.erase(Ipv4Address("10.0.0.1")), 0, "Key erased twice");
+    NS_TEST_ASSERT_MSG_EQ(map.size(), 1, "Wrong size after erase");
+    NS_TEST_ASSERT_MSG_EQ(map.begin()->first, Ipv4Address("10.0.0.2"), "Wrong remaining key");
+
+    map.clear();
+    NS_TEST_ASSERT_MSG_EQ(map.empty(), true, "Map not empty after clear");
+    NS_TEST_ASSERT_MSG_EQ((map.begin() == map.end()), true, "Iteration over an empty map");
+
+    // erasing while iterating visits every element exactly once
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        map[Ipv4Address(i)] = i;
+    }
+    uint32_t visited = 0;
+    for (auto i = map.begin(); i != map.end();)
+    {
+        visited++;
+        if (i->second % 2 == 0)
+        {
+            i = map.erase(i);
+            continue;
+        }
+        ++i;
+    }
+    NS_TEST_ASSERT_MSG_EQ(visited, 1000, "Wrong number of visited elements");
+    NS_TEST_ASSERT_MSG_EQ(map.size(), 500, "Wrong size after erasing while iterating");
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(map.count(Ipv4Address(i)), i % 2, "Wrong element erased");
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief FlatHashMap randomized comparison against std::map.
+ *
+ * \tparam Key the key type
+ */
+template <typename Key>
+class FlatHashMapRandomTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param name the test name
+     * \param makeKey function returning the key for an integer
+     */
+    FlatHashMapRandomTest(std::string name, Key (*makeKey)(uint32_t));
+
+  private:
+    void DoRun() override;
+
+    Key (*m_makeKey)(uint32_t); //!< function returning the key for an integer
+};
+
+template <typename Key>
+FlatHashMapRandomTest<Key>::FlatHashMapRandomTest(std::string name, Key (*makeKey)(uint32_t))
+    : TestCase(name),
+      m_makeKey(makeKey)
+{
+}
+
+template <typename Key>
+void
+FlatHashMapRandomTest<Key>::DoRun()
+{
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    rng->SetAttribute("Max", DoubleValue(3000));
+
+    FlatHashMap<Key, uint32_t> map;
+    std::map<Key, uint32_t> reference;
+    for (uint32_t step = 0; step < 50000; step++)
+    {
+        uint32_t n = rng->GetInteger();
+        Key key = m_makeKey(n);
+        switch (step % 3)
+        {
+        case 0:
+        case 1:
+            map[key] = step;
+            reference[key] = step;
+            break;
+        case 2:
+            NS_TEST_ASSERT_MSG_EQ(map.erase(key), reference.erase(key), "Erase mismatch");
+            break;
+        }
+        uint32_t probe = rng->GetInteger();
+        auto it = map.find(m_makeKey(probe));
+        auto ref = reference.find(m_makeKey(probe));
+        NS_TEST_ASSERT_MSG_EQ((it == map.end()), (ref == reference.end()), "Find mismatch");
+        if (ref != reference.end())
+        {
+            NS_TEST_ASSERT_MSG_EQ(it->second, ref->second, "Value mismatch");
+        }
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(map.size(), reference.size(), "Size mismatch");
+    std::map<Key, uint32_t> contents(map.begin(), map.end());
+    NS_TEST_ASSERT_MSG_EQ((contents == reference), true, "Contents mismatch");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief FlatHashMap TestSuite
+ */
+class FlatHashMapTestSuite : public TestSuite
+{
+  public:
+    FlatHashMapTestSuite();
+};
+
+FlatHashMapTestSuite::FlatHashMapTestSuite()
+    : TestSuite("flat-hash-map", Type::UNIT)
+{
+    AddTestCase(new FlatHashMapBasicTest, TestCase::Duration::QUICK);
+    AddTestCase(new FlatHashMapRandomTest<Ipv4Address>("FlatHashMap Ipv4Address keys",
+                                                       [](uint32_t n) { return Ipv4Address(n); }),
+                TestCase::Duration::QUICK);
+    AddTestCase(new FlatHashMapRandomTest<Ipv6Address>(
+                    "FlatHashMap Ipv6Address keys",
+                    [](uint32_t n) {
+                        uint8_t buf[16] = {0x20, 0x01, 0x0d, 0xb8};
+                        buf[12] = n >> 24;
+                        buf[13] = n >> 16;
+                        buf[14] = n >> 8;
+                        buf[15] = n;
+                        return Ipv6Address(buf);
+                    }),
+                TestCase::Duration::QUICK);
+    AddTestCase(new FlatHashMapRandomTest<Mac48Address>("FlatHashMap Mac48Address keys",
+                                                        [](uint32_t n) {
+                                                            uint8_t buf[6] = {0, 0, 0, 0, 0, 0};
+                                                            buf[2] = n >> 24;
+                                                            buf[3] = n >> 16;
+                                                            buf[4] = n >> 8;
+                                                            buf[5] = n;
+                                                            Mac48Address address;
+                                                            address.CopyFrom(buf);
+                                                            return address;
+                                                        }),
+                TestCase::Duration::QUICK);
+}
+
+static FlatHashMapTestSuite g_flatHashMapTestSuite; //!< Static variable for test initialization
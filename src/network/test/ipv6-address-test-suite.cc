@@ -95,6 +95,83 @@ Ipv6AddressTestCase::DoRun()
     // Please add more tests below
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Ipv6Address comparisons, predicates and prefixes.
+ */
+class Ipv6AddressComparisonTestCase : public TestCase
+{
+  public:
+    Ipv6AddressComparisonTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+Ipv6AddressComparisonTestCase::Ipv6AddressComparisonTestCase()
+    : TestCase("comparisons, predicates and prefixes")
+{
+}
+
+void
+Ipv6AddressComparisonTestCase::DoRun()
+{
+    // addresses differing in the high-order or in the low-order half
+    Ipv6Address a("2001:db8::1");
+    Ipv6Address b("2001:db8::2");
+    Ipv6Address c("2001:db9::1");
+    NS_TEST_ASSERT_MSG_EQ((a == Ipv6Address("2001:db8::1")), true, "Equal addresses");
+    NS_TEST_ASSERT_MSG_EQ((a != b), true, "Addresses differing in the low-order half");
+    NS_TEST_ASSERT_MSG_EQ((a != c), true, "Addresses differing in the high-order half");
+    NS_TEST_ASSERT_MSG_EQ((a < b && b < c && a < c), true, "Addresses compared byte by byte");
+    NS_TEST_ASSERT_MSG_EQ((Ipv6Address("::ff") < Ipv6Address("::100")), true, "Byte order");
+    NS_TEST_ASSERT_MSG_EQ(Ipv6AddressHash()(a),
+                          Ipv6AddressHash()(Ipv6Address("2001:db8::1")),
+                          "Equal addresses must have the same hash");
+    NS_TEST_ASSERT_MSG_NE(Ipv6AddressHash()(a), Ipv6AddressHash()(b), "Poor hash");
+
+    NS_TEST_ASSERT_MSG_EQ(Ipv6Address("::").IsAny(), true, "Any address");
+    NS_TEST_ASSERT_MSG_EQ(Ipv6Address("::1").IsAny(), false, "Not the any address");
+    NS_TEST_ASSERT_MSG_EQ(Ipv6Address("1::").IsAny(), false, "Not the any address");
+    NS_TEST_ASSERT_MSG_EQ(Ipv6Address("fe80::1").IsLinkLocal(), true, "Link-local address");
+    NS_TEST_ASSERT_MSG_EQ(Ipv6Address("fe80:0:0:1::1").IsLinkLocal(),
+                          false,
+                          "Not a link-local address");
+    NS_TEST_ASSERT_MSG_EQ(a.IsDocumentation(), true, "Documentation address");
+    NS_TEST_ASSERT_MSG_EQ(c.IsDocumentation(), false, "Not a documentation address");
+    NS_TEST_ASSERT_MSG_EQ(Ipv6Address::MakeSolicitedAddress(a).IsSolicitedMulticast(),
+                          true,
+                          "Solicited multicast address");
+    NS_TEST_ASSERT_MSG_EQ(Ipv6Address("ff02::1:fe00:1").IsSolicitedMulticast(),
+                          false,
+                          "Not a solicited multicast address");
+
+    Ipv6Prefix prefix(60);
+    NS_TEST_ASSERT_MSG_EQ(Ipv6Address("2001:db8:0:12::1").CombinePrefix(prefix),
+                          Ipv6Address("2001:db8:0:10::"),
+                          "Address combined with a prefix");
+    NS_TEST_ASSERT_MSG_EQ(prefix.IsMatch(Ipv6Address("2001:db8:0:12::1"),
+                                         Ipv6Address("2001:db8:0:1f::2")),
+                          true,
+                          "Addresses matching a prefix");
+    NS_TEST_ASSERT_MSG_EQ(prefix.IsMatch(Ipv6Address("2001:db8:0:12::1"),
+                                         Ipv6Address("2001:db8:0:22::1")),
+                          false,
+                          "Addresses not matching a prefix");
+    NS_TEST_ASSERT_MSG_EQ(Ipv6Prefix(128).IsMatch(a, b), false, "Host prefix");
+    NS_TEST_ASSERT_MSG_EQ(Ipv6Prefix::GetZero().IsMatch(a, c), true, "Empty prefix");
+    NS_TEST_ASSERT_MSG_EQ(Ipv6Address("ff02::1").HasPrefix(Ipv6Prefix(8)), true, "Prefix of ones");
+    NS_TEST_ASSERT_MSG_EQ(Ipv6Address("fe02::1").HasPrefix(Ipv6Prefix(8)),
+                          false,
+                          "Not a prefix of ones");
+    NS_TEST_ASSERT_MSG_EQ((Ipv6Prefix(64) == Ipv6Prefix("ffff:ffff:ffff:ffff::")),
+                          true,
+                          "Equal prefixes");
+    NS_TEST_ASSERT_MSG_EQ((Ipv6Prefix(64) != Ipv6Prefix(65)), true, "Different prefixes");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -112,6 +189,7 @@ Ipv6AddressTestSuite::Ipv6AddressTestSuite()
     : TestSuite("ipv6-address", Type::UNIT)
 {
     AddTestCase(new Ipv6AddressTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new Ipv6AddressComparisonTestCase, TestCase::Duration::QUICK);
 }
 
 static Ipv6AddressTestSuite ipv6AddressTestSuite; //!< Static variable for test initialization
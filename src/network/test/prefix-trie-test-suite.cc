@@ -0,0 +1,274 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/double.h"
+#include "ns3/prefix-trie.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PrefixTrie basic operations test.
+ */
+class PrefixTrieBasicTest : public TestCase
+{
+  public:
+    PrefixTrieBasicTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \param trie the trie
+     * \param address the address to match
+     * \return the lengths and first values of the matching prefixes, longest first
+     */
+    static std::vector<std::pair<uint16_t, uint32_t>> Matches(
+        const PrefixTrie<uint32_t, 4>& trie,
+        const char* address);
+};
+
+PrefixTrieBasicTest::PrefixTrieBasicTest()
+    : TestCase("PrefixTrie basic operations")
+{
+}
+
+std::vector<std::pair<uint16_t, uint32_t>>
+PrefixTrieBasicTest::Matches(const PrefixTrie<uint32_t, 4>& trie, const char* address)
+{
+    std::vector<std::pair<uint16_t, uint32_t>> matches;
+    trie.Match(PrefixTrie<uint32_t, 4>::GetKey(Ipv4Address(address)),
+               [&matches](uint16_t length, const std::vector<uint32_t>& values) {
+                   matches.emplace_back(length, values.front());
+                   return false;
+               });
+    return matches;
+}
+
+void
+PrefixTrieBasicTest::DoRun()
+{
+    typedef PrefixTrie<uint32_t, 4> Trie;
+    typedef std::vector<std::pair<uint16_t, uint32_t>> Matches_t;
+    Trie trie;
+    NS_TEST_ASSERT_MSG_EQ(Matches(trie, "10.1.2.3").empty(), true, "Match in an empty trie");
+
+    trie.Insert(Trie::GetKey(Ipv4Address("0.0.0.0")), 0, 1);
+    trie.Insert(Trie::GetKey(Ipv4Address("10.0.0.0")), 8, 2);
+    trie.Insert(Trie::GetKey(Ipv4Address("10.1.2.0")), 24, 3);
+    trie.Insert(Trie::GetKey(Ipv4Address("10.1.0.0")), 16, 4);
+    trie.Insert(Trie::GetKey(Ipv4Address("10.1.2.3")), 32, 5);
+    // bits beyond the length are ignored
+    trie.Insert(Trie::GetKey(Ipv4Address("10.128.255.255")), 9, 6);
+    NS_TEST_ASSERT_MSG_EQ(trie.GetNPrefixes(), 6, "Wrong number of prefixes");
+
+    NS_TEST_ASSERT_MSG_EQ((Matches(trie, "10.1.2.3") ==
+                           Matches_t{{32, 5}, {24, 3}, {16, 4}, {8, 2}, {0, 1}}),
+                          true,
+                          "Wrong matches for 10.1.2.3");
+    NS_TEST_ASSERT_MSG_EQ((Matches(trie, "10.1.3.1") == Matches_t{{16, 4}, {8, 2}, {0, 1}}),
+                          true,
+                          "Wrong matches for 10.1.3.1");
+    NS_TEST_ASSERT_MSG_EQ((Matches(trie, "10.200.0.1") == Matches_t{{9, 6}, {8, 2}, {0, 1}}),
+                          true,
+                          "Wrong matches for 10.200.0.1");
+    NS_TEST_ASSERT_MSG_EQ((Matches(trie, "192.168.0.1") == Matches_t{{0, 1}}),
+                          true,
+                          "Wrong matches for 192.168.0.1");
+
+    // values of a prefix are kept in insertion order
+    trie.Insert(Trie::GetKey(Ipv4Address("10.1.0.0")), 16, 7);
+    trie.Insert(Trie::GetKey(Ipv4Address("10.1.0.0")), 16, 8);
+    const std::vector<uint32_t>* values = trie.Find(Trie::GetKey(Ipv4Address("10.1.0.0")), 16);
+    NS_TEST_ASSERT_MSG_NE(values, nullptr, "Prefix not found");
+    NS_TEST_ASSERT_MSG_EQ((*values == std::vector<uint32_t>{4, 7, 8}), true, "Wrong values");
+    NS_TEST_ASSERT_MSG_EQ(trie.Remove(Trie::GetKey(Ipv4Address("10.1.0.0")), 16, 7),
+                          true,
+                          "Value not removed");
+    NS_TEST_ASSERT_MSG_EQ(trie.Remove(Trie::GetKey(Ipv4Address("10.1.0.0")), 16, 7),
+                          false,
+                          "Value removed twice");
+    NS_TEST_ASSERT_MSG_EQ((*values == std::vector<uint32_t>{4, 8}), true, "Wrong values");
+    NS_TEST_ASSERT_MSG_EQ(trie.Find(Trie::GetKey(Ipv4Address("10.1.0.0")), 15),
+                          nullptr,
+                          "Found a prefix not inserted");
+
+    // removing prefixes keeps the longer and shorter ones
+    trie.Remove(Trie::GetKey(Ipv4Address("10.1.0.0")), 16, 4);
+    trie.Remove(Trie::GetKey(Ipv4Address("10.1.0.0")), 16, 8);
+    trie.Remove(Trie::GetKey(Ipv4Address("10.0.0.0")), 8, 2);
+    NS_TEST_ASSERT_MSG_EQ(trie.GetNPrefixes(), 4, "Wrong number of prefixes after removal");
+    NS_TEST_ASSERT_MSG_EQ((Matches(trie, "10.1.2.3") == Matches_t{{32, 5}, {24, 3}, {0, 1}}),
+                          true,
+                          "Wrong matches after removal");
+    NS_TEST_ASSERT_MSG_EQ((Matches(trie, "10.200.0.1") == Matches_t{{9, 6}, {0, 1}}),
+                          true,
+                          "Wrong matches after removal");
+
+    // the enumeration stops when the visitor returns true
+    uint32_t visited = 0;
+    trie.Match(Trie::GetKey(Ipv4Address("10.1.2.3")),
+               [&visited](uint16_t, const std::vector<uint32_t>&) {
+                   visited++;
+                   return true;
+               });
+    NS_TEST_ASSERT_MSG_EQ(visited, 1, "Enumeration not stopped");
+
+    trie.Clear();
+    NS_TEST_ASSERT_MSG_EQ(trie.GetNPrefixes(), 0, "Trie not empty after clear");
+    NS_TEST_ASSERT_MSG_EQ(Matches(trie, "10.1.2.3").empty(), true, "Match after clear");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PrefixTrie randomized comparison against a linear scan.
+ *
+ * \tparam N the key size in bytes
+ */
+template <std::size_t N>
+class PrefixTrieRandomTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param name the test name
+     */
+    PrefixTrieRandomTest(std::string name);
+
+  private:
+    void DoRun() override;
+};
+
+template <std::size_t N>
+PrefixTrieRandomTest<N>::PrefixTrieRandomTest(std::string name)
+    : TestCase(name)
+{
+}
+
+template <std::size_t N>
+void
+PrefixTrieRandomTest<N>::DoRun()
+{
+    typedef PrefixTrie<uint32_t, N> Trie;
+    typedef typename Trie::Key Key;
+
+    /// A prefix of the reference table
+    struct Entry
+    {
+        Key key;         //!< the prefix key
+        uint16_t length; //!< the prefix length
+        uint32_t value;  //!< the value
+    };
+
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+
+    // keys share their first bytes, so that prefixes are nested
+    auto randomKey = [&rng]() {
+        Key key{};
+        key[0] = 0x20;
+        for (std::size_t i = 1; i < N; i++)
+        {
+            key[i] = rng->GetInteger(0, 3) == 0 ? rng->GetInteger(0, 255) : 0;
+        }
+        return key;
+    };
+    auto matches = [](const Key& prefix, uint16_t length, const Key& key) {
+        for (uint16_t bit = 0; bit < length; bit++)
+        {
+            uint8_t mask = 0x80 >> (bit % 8);
+            if ((prefix[bit / 8] & mask) != (key[bit / 8] & mask))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    Trie trie;
+    std::vector<Entry> reference;
+    for (uint32_t step = 0; step < 5000; step++)
+    {
+        if (reference.empty() || rng->GetInteger(0, 2) != 0)
+        {
+            Entry entry{randomKey(), static_cast<uint16_t>(rng->GetInteger(0, N * 8)), step};
+            trie.Insert(entry.key, entry.length, entry.value);
+            reference.push_back(entry);
+        }
+        else
+        {
+            auto it = reference.begin() + rng->GetInteger(0, reference.size() - 1);
+            NS_TEST_ASSERT_MSG_EQ(trie.Remove(it->key, it->length, it->value),
+                                  true,
+                                  "Value not removed");
+            reference.erase(it);
+        }
+
+        // the matching values, longest prefix first, in insertion order
+        Key key = randomKey();
+        std::vector<std::pair<uint16_t, uint32_t>> expected;
+        for (const auto& entry : reference)
+        {
+            if (matches(entry.key, entry.length, key))
+            {
+                expected.emplace_back(entry.length, entry.value);
+            }
+        }
+        std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) {
+            return a.first > b.first;
+        });
+        std::vector<std::pair<uint16_t, uint32_t>> found;
+        trie.Match(key, [&found](uint16_t length, const std::vector<uint32_t>& values) {
+            for (uint32_t value : values)
+            {
+                found.emplace_back(length, value);
+            }
+            return false;
+        });
+        NS_TEST_ASSERT_MSG_EQ((found == expected), true, "Match mismatch at step " << step);
+    }
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PrefixTrie TestSuite
+ */
+class PrefixTrieTestSuite : public TestSuite
+{
+  public:
+    PrefixTrieTestSuite();
+};
+
+PrefixTrieTestSuite::PrefixTrieTestSuite()
+    : TestSuite("prefix-trie", Type::UNIT)
+{
+    AddTestCase(new PrefixTrieBasicTest, TestCase::Duration::QUICK);
+    AddTestCase(new PrefixTrieRandomTest<4>("PrefixTrie 4 bytes keys"), TestCase::Duration::QUICK);
+    AddTestCase(new PrefixTrieRandomTest<16>("PrefixTrie 16 bytes keys"),
+                TestCase::Duration::QUICK);
+}
+
+static PrefixTrieTestSuite g_prefixTrieTestSuite; //!< Static variable for test initialization
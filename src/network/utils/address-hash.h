@@ -0,0 +1,143 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ADDRESS_HASH_H
+#define ADDRESS_HASH_H
+
+#include "ipv4-address.h"
+#include "ipv6-address.h"
+#include "mac48-address.h"
+
+#include <cstddef>
+#include <functional>
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup address
+ * Hash functors suitable for open addressing hash tables keyed by addresses.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup address
+ * \brief Mix the bits of a 64-bit value.
+ *
+ * This is the finalizer of MurmurHash3: every input bit affects every
+ * output bit, so that keys differing only in a few bits (e.g., consecutive
+ * addresses in a subnet) are spread over the whole table.
+ *
+ * \param key the value to mix
+ * \return the mixed value
+ */
+inline uint64_t
+FlatHashMix(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/**
+ * \ingroup address
+ * \brief Hash functor used by default by FlatHashMap.
+ *
+ * The generic version mixes the output of std::hash, which for integral
+ * types is the identity in common standard library implementations.
+ * Specializations are provided for the address types commonly used as keys.
+ *
+ * \tparam T the key type
+ */
+template <typename T>
+struct FlatHash
+{
+    /**
+     * \param key the key to hash
+     * \return the hash value
+     */
+    std::size_t operator()(const T& key) const
+    {
+        return static_cast<std::size_t>(FlatHashMix(std::hash<T>()(key)));
+    }
+};
+
+/**
+ * \ingroup address
+ * \brief Hash functor for Ipv4Address keys.
+ */
+template <>
+struct FlatHash<Ipv4Address>
+{
+    /**
+     * \param address the address to hash
+     * \return the hash value
+     */
+    std::size_t operator()(const Ipv4Address& address) const
+    {
+        return static_cast<std::size_t>(FlatHashMix(address.Get()));
+    }
+};
+
+/**
+ * \ingroup address
+ * \brief Hash functor for Ipv6Address keys.
+ */
+template <>
+struct FlatHash<Ipv6Address>
+{
+    /**
+     * \param address the address to hash
+     * \return the hash value
+     */
+    std::size_t operator()(const Ipv6Address& address) const
+    {
+        uint64_t words[2];
+        address.GetWords(words);
+        return static_cast<std::size_t>(FlatHashMix(words[0] ^ FlatHashMix(words[1])));
+    }
+};
+
+/**
+ * \ingroup address
+ * \brief Hash functor for Mac48Address keys.
+ */
+template <>
+struct FlatHash<Mac48Address>
+{
+    /**
+     * \param address the address to hash
+     * \return the hash value
+     */
+    std::size_t operator()(const Mac48Address& address) const
+    {
+        uint8_t buf[6];
+        address.CopyTo(buf);
+        uint64_t key = 0;
+        for (uint8_t byte : buf)
+        {
+            key = (key << 8) | byte;
+        }
+        return static_cast<std::size_t>(FlatHashMix(key));
+    }
+};
+
+} // namespace ns3
+
+#endif /* ADDRESS_HASH_H */
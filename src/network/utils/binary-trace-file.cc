@@ -0,0 +1,561 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-trace-file.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/int64x64.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+
+#include <cstring>
+#include <sstream>
+
+//
+// File layout: a sequence of records, each starting with its type byte.
+//
+//   'H' "ns3b" version stepsPerSecond flags     file header
+//   'S' index length bytes                      string definition
+//   't' length bytes                            text
+//   '+' '-' 'd' 'r' timeDelta context uid size nItems item... [length bytes]
+//
+// All the integers are LEB128 encoded. Indexes of strings start at 1, the
+// context index 0 means no context. The serialized packet is present only
+// if the flags of the file header have CAPTURE_PACKETS set. A file header
+// resets the string table and the time, so that files can be appended to.
+//
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BinaryTraceFile");
+
+namespace
+{
+const uint8_t FILE_HEADER = 'H';            //!< File header record type
+const uint8_t STRING_DEFINITION = 'S';      //!< String definition record type
+const char MAGIC[4] = {'n', 's', '3', 'b'}; //!< Magic bytes of the file header
+const uint64_t VERSION = 1;                 //!< Format version
+const uint64_t CAPTURE_PACKETS = 1;         //!< File header flag: packets are stored
+const std::size_t BUFFER_SIZE = 65536;      //!< Size of the blocks written to the file
+} // namespace
+
+BinaryTraceFile::TextBuffer::TextBuffer(BinaryTraceFile* file)
+    : m_file(file)
+{
+}
+
+void
+BinaryTraceFile::TextBuffer::WritePending()
+{
+    if (!m_pending.empty())
+    {
+        m_file->WriteText(m_pending);
+        m_pending.clear();
+    }
+}
+
+BinaryTraceFile::TextBuffer::int_type
+BinaryTraceFile::TextBuffer::overflow(int_type c)
+{
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        m_pending.push_back(traits_type::to_char_type(c));
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize
+BinaryTraceFile::TextBuffer::xsputn(const char* s, std::streamsize n)
+{
+    m_pending.append(s, n);
+    return n;
+}
+
+int
+BinaryTraceFile::TextBuffer::sync()
+{
+    WritePending();
+    return 0;
+}
+
+BinaryTraceFile::FlushBuffer::FlushBuffer(BinaryTraceFile* file)
+    : m_file(file)
+{
+}
+
+int
+BinaryTraceFile::FlushBuffer::sync()
+{
+    if (m_file->m_writing && m_file->m_file.is_open())
+    {
+        m_file->m_textBuffer.WritePending();
+        m_file->Flush();
+    }
+    return 0;
+}
+
+BinaryTraceFile::BinaryTraceFile()
+    : m_writing(false),
+      m_capturePackets(false),
+      m_lastTime(0),
+      m_nStrings(0),
+      m_stepsPerSecond(1),
+      m_textBuffer(this),
+      m_textStream(&m_textBuffer),
+      m_flushBuffer(this),
+      m_flushStream(&m_flushBuffer)
+{
+    NS_LOG_FUNCTION(this);
+    // write the buffered records if the program exits on a fatal error
+    FatalImpl::RegisterStream(&m_flushStream);
+}
+
+BinaryTraceFile::~BinaryTraceFile()
+{
+    NS_LOG_FUNCTION(this);
+    FatalImpl::UnregisterStream(&m_flushStream);
+    Close();
+}
+
+void
+BinaryTraceFile::Open(const std::string& filename, std::ios::openmode mode, bool capturePackets)
+{
+    NS_LOG_FUNCTION(this << filename << mode << capturePackets);
+    NS_ASSERT_MSG(!m_file.is_open(), "BinaryTraceFile::Open(): File already open");
+
+    m_writing = (mode & std::ios::out) != 0;
+    m_file.open(filename, mode | std::ios::binary);
+    if (m_file.fail())
+    {
+        return;
+    }
+    m_lastTime = 0;
+    m_nStrings = 0;
+    m_contexts.clear();
+    m_typeIds.clear();
+    m_strings.clear();
+    if (!m_writing)
+    {
+        return;
+    }
+
+    m_capturePackets = capturePackets;
+    m_stepsPerSecond = Seconds(1).GetTimeStep();
+    m_buffer.reserve(BUFFER_SIZE);
+    PutByte(FILE_HEADER);
+    for (char c : MAGIC)
+    {
+        PutByte(c);
+    }
+    PutVarint(VERSION);
+    PutVarint(m_stepsPerSecond);
+    PutVarint(m_capturePackets ? CAPTURE_PACKETS : 0);
+}
+
+void
+BinaryTraceFile::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    if (m_writing)
+    {
+        m_textBuffer.WritePending();
+        Flush();
+    }
+    m_file.close();
+}
+
+bool
+BinaryTraceFile::Fail() const
+{
+    return m_file.fail();
+}
+
+void
+BinaryTraceFile::Flush()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_buffer.empty())
+    {
+        m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+        m_buffer.clear();
+    }
+    m_file.flush();
+}
+
+void
+BinaryTraceFile::PutByte(uint8_t value)
+{
+    m_buffer.push_back(value);
+}
+
+void
+BinaryTraceFile::PutVarint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        m_buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    m_buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void
+BinaryTraceFile::PutString(uint32_t index, const std::string& s)
+{
+    PutByte(STRING_DEFINITION);
+    PutVarint(index);
+    PutVarint(s.size());
+    m_buffer.insert(m_buffer.end(), s.begin(), s.end());
+}
+
+void
+BinaryTraceFile::MaybeFlush()
+{
+    if (m_buffer.size() >= BUFFER_SIZE - 512)
+    {
+        m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+        m_buffer.clear();
+    }
+}
+
+uint32_t
+BinaryTraceFile::InternContext(const std::string& context)
+{
+    if (context.empty())
+    {
+        return 0;
+    }
+    uint32_t& index = m_contexts[context];
+    if (index == 0)
+    {
+        index = ++m_nStrings;
+        PutString(index, context);
+    }
+    return index;
+}
+
+uint32_t
+BinaryTraceFile::InternTypeId(uint16_t uid)
+{
+    if (uid >= m_typeIds.size())
+    {
+        m_typeIds.resize(uid + 1, 0);
+    }
+    if (m_typeIds[uid] == 0)
+    {
+        TypeId tid;
+        tid.SetUid(uid);
+        m_typeIds[uid] = ++m_nStrings;
+        PutString(m_typeIds[uid], tid.GetName());
+    }
+    return m_typeIds[uid];
+}
+
+void
+BinaryTraceFile::Write(RecordType type, Time time, const std::string& context, Ptr<const Packet> p)
+{
+    NS_LOG_FUNCTION(this << type << time << context << p);
+    NS_ASSERT_MSG(m_writing && m_file.is_open(), "BinaryTraceFile::Write(): File not open");
+    NS_ASSERT(type != TEXT);
+
+    // keep the order of the text written by other sinks
+    m_textBuffer.WritePending();
+
+    // define the strings before starting the record
+    uint32_t contextIndex = InternContext(context);
+    m_itemIds.clear();
+    PacketMetadata::ItemIterator i = p->BeginItem();
+    while (i.HasNext())
+    {
+        PacketMetadata::Item item = i.Next();
+        if (item.type != PacketMetadata::Item::PAYLOAD)
+        {
+            m_itemIds.push_back(InternTypeId(item.tid.GetUid()));
+        }
+    }
+
+    int64_t step = time.GetTimeStep();
+    NS_ASSERT_MSG(step >= m_lastTime, "BinaryTraceFile::Write(): Time going backwards");
+    PutByte(type);
+    PutVarint(step - m_lastTime);
+    m_lastTime = step;
+    PutVarint(contextIndex);
+    PutVarint(p->GetUid());
+    PutVarint(p->GetSize());
+    PutVarint(m_itemIds.size());
+    for (uint32_t id : m_itemIds)
+    {
+        PutVarint(id);
+    }
+    if (m_capturePackets)
+    {
+        m_serialized.resize(p->GetSerializedSize());
+        uint32_t ok = p->Serialize(m_serialized.data(), m_serialized.size());
+        NS_ASSERT(ok);
+        PutVarint(m_serialized.size());
+        m_buffer.insert(m_buffer.end(), m_serialized.begin(), m_serialized.end());
+    }
+    MaybeFlush();
+}
+
+void
+BinaryTraceFile::WriteText(const std::string& text)
+{
+    NS_LOG_FUNCTION(this << text);
+    NS_ASSERT_MSG(m_writing && m_file.is_open(), "BinaryTraceFile::WriteText(): File not open");
+    PutByte(TEXT);
+    PutVarint(text.size());
+    m_buffer.insert(m_buffer.end(), text.begin(), text.end());
+    MaybeFlush();
+}
+
+std::ostream*
+BinaryTraceFile::GetTextStream()
+{
+    return &m_textStream;
+}
+
+bool
+BinaryTraceFile::GetVarint(uint64_t& value)
+{
+    value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+        int c = m_file.get();
+        if (c == EOF)
+        {
+            return false;
+        }
+        value |= static_cast<uint64_t>(c & 0x7f) << shift;
+        if ((c & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+BinaryTraceFile::LookupString(uint64_t index, std::string& s) const
+{
+    if (index == 0 || index > m_strings.size())
+    {
+        return false;
+    }
+    s = m_strings[index - 1];
+    return true;
+}
+
+void
+BinaryTraceFile::ParseContext(Record& record)
+{
+    record.nodeId = NO_ID;
+    record.deviceId = NO_ID;
+    std::size_t pos = record.context.find("/NodeList/");
+    if (pos == std::string::npos)
+    {
+        return;
+    }
+    const char* s = record.context.c_str() + pos + std::strlen("/NodeList/");
+    char* end;
+    unsigned long id = std::strtoul(s, &end, 10);
+    if (end == s)
+    {
+        return;
+    }
+    record.nodeId = id;
+    if (std::strncmp(end, "/DeviceList/", std::strlen("/DeviceList/")) != 0)
+    {
+        return;
+    }
+    s = end + std::strlen("/DeviceList/");
+    id = std::strtoul(s, &end, 10);
+    if (end != s)
+    {
+        record.deviceId = id;
+    }
+}
+
+bool
+BinaryTraceFile::Read(Record& record)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(!m_writing && m_file.is_open(), "BinaryTraceFile::Read(): File not open");
+
+    while (true)
+    {
+        int type = m_file.get();
+        if (type == EOF)
+        {
+            return false;
+        }
+        uint64_t value;
+        uint64_t length;
+        switch (type)
+        {
+        case FILE_HEADER: {
+            char magic[sizeof(MAGIC)];
+            uint64_t flags;
+            if (!m_file.read(magic, sizeof(magic)) ||
+                std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !GetVarint(value) ||
+                value != VERSION || !GetVarint(value) || value == 0 || !GetVarint(flags))
+            {
+                NS_LOG_WARN("Invalid file header");
+                return false;
+            }
+            m_stepsPerSecond = value;
+            m_capturePackets = (flags & CAPTURE_PACKETS) != 0;
+            m_lastTime = 0;
+            m_strings.clear();
+            break;
+        }
+        case STRING_DEFINITION: {
+            if (!GetVarint(value) || value != m_strings.size() + 1 || !GetVarint(length))
+            {
+                NS_LOG_WARN("Invalid string definition");
+                return false;
+            }
+            std::string s(length, '\0');
+            if (!m_file.read(s.data(), length))
+            {
+                return false;
+            }
+            m_strings.push_back(std::move(s));
+            break;
+        }
+        case TEXT: {
+            if (!GetVarint(length))
+            {
+                return false;
+            }
+            record = Record();
+            record.type = TEXT;
+            record.time = m_lastTime;
+            record.seconds = (int64x64_t(m_lastTime) / int64x64_t(m_stepsPerSecond)).GetDouble();
+            record.nodeId = NO_ID;
+            record.deviceId = NO_ID;
+            record.text.resize(length);
+            return static_cast<bool>(m_file.read(record.text.data(), length));
+        }
+        case ENQUEUE:
+        case DEQUEUE:
+        case DROP:
+        case RECEIVE: {
+            uint64_t delta;
+            uint64_t context;
+            uint64_t nItems;
+            if (!GetVarint(delta) || !GetVarint(context) || !GetVarint(record.uid) ||
+                !GetVarint(value) || !GetVarint(nItems))
+            {
+                return false;
+            }
+            record.type = static_cast<RecordType>(type);
+            m_lastTime += delta;
+            record.time = m_lastTime;
+            record.seconds = (int64x64_t(m_lastTime) / int64x64_t(m_stepsPerSecond)).GetDouble();
+            record.size = value;
+            record.context.clear();
+            if (context != 0 && !LookupString(context, record.context))
+            {
+                NS_LOG_WARN("Undefined context " << context);
+                return false;
+            }
+            ParseContext(record);
+            record.headers.resize(nItems);
+            for (auto& header : record.headers)
+            {
+                if (!GetVarint(value) || !LookupString(value, header))
+                {
+                    NS_LOG_WARN("Undefined header name");
+                    return false;
+                }
+            }
+            record.packet.clear();
+            if (m_capturePackets)
+            {
+                if (!GetVarint(length))
+                {
+                    return false;
+                }
+                record.packet.resize(length);
+                if (!m_file.read(reinterpret_cast<char*>(record.packet.data()), length))
+                {
+                    return false;
+                }
+            }
+            record.text.clear();
+            return true;
+        }
+        default:
+            NS_LOG_WARN("Unknown record type " << type);
+            return false;
+        }
+    }
+}
+
+void
+BinaryTraceFile::PrintAscii(const Record& record, std::ostream& os)
+{
+    if (record.type == TEXT)
+    {
+        os << record.text;
+        return;
+    }
+    os << static_cast<char>(record.type) << " " << record.seconds << " ";
+    if (!record.context.empty())
+    {
+        os << record.context << " ";
+    }
+    if (!record.packet.empty())
+    {
+        Ptr<Packet> p = Create<Packet>(record.packet.data(), record.packet.size(), true);
+        os << *p;
+    }
+    else
+    {
+        for (const auto& header : record.headers)
+        {
+            os << header << " ";
+        }
+        os << "(uid=" << record.uid << " size=" << record.size << ")";
+    }
+    os << std::endl;
+}
+
+uint64_t
+BinaryTraceFile::ConvertToAscii(const std::string& filename, std::ostream& os)
+{
+    NS_LOG_FUNCTION(filename);
+    BinaryTraceFile file;
+    file.Open(filename, std::ios::in);
+    NS_ABORT_MSG_IF(file.Fail(), "BinaryTraceFile::ConvertToAscii(): Unable to open " << filename);
+    Record record;
+    uint64_t n = 0;
+    while (file.Read(record))
+    {
+        PrintAscii(record, os);
+        n++;
+    }
+    return n;
+}
+
+} // namespace ns3
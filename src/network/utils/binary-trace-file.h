@@ -0,0 +1,294 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include "flat-hash-map.h"
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+
+#include <fstream>
+#include <stdint.h>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class Packet;
+
+/**
+ * \brief A compact binary replacement for ascii trace files.
+ *
+ * The default ascii trace sinks print the whole packet (Packet::Print) for
+ * every enqueue, dequeue, drop and receive event, which on large simulations
+ * costs more than the simulation itself and produces huge files. A
+ * BinaryTraceFile instead stores, for each event, a small record holding:
+ * - the event type ('+', '-', 'd' or 'r');
+ * - the simulation time, as a delta from the previous record;
+ * - the trace context (from which node and device ids are recovered);
+ * - the packet uid and size;
+ * - the names of the headers and trailers of the packet, taken from the
+ *   packet metadata (if enabled) without deserializing them;
+ * - optionally, the serialized packet, so that the classic ascii text
+ *   can be rendered exactly when the file is converted.
+ *
+ * Strings (contexts and header names) are written once and then referred
+ * to by index, integers are variable-length encoded and records are
+ * accumulated in a memory buffer written to the file in large blocks.
+ * The buffered records are also written if the program exits on a fatal
+ * error (see FatalImpl::FlushStreams()).
+ *
+ * Text written to the stream returned by GetTextStream() is stored as text
+ * records, so that trace sinks not aware of the binary format (e.g., those
+ * of the internet stack) can share the file.
+ *
+ * ConvertToAscii() renders a binary trace file as ascii text offline.
+ */
+class BinaryTraceFile : public SimpleRefCount<BinaryTraceFile>
+{
+  public:
+    /// Record types
+    enum RecordType : uint8_t
+    {
+        ENQUEUE = '+', //!< Packet enqueued
+        DEQUEUE = '-', //!< Packet dequeued
+        DROP = 'd',    //!< Packet dropped
+        RECEIVE = 'r', //!< Packet received
+        TEXT = 't',    //!< Free text
+    };
+
+    /// Value of the node and device ids which cannot be recovered from the context
+    static const uint32_t NO_ID = 0xffffffff;
+
+    /// A trace record, as returned by Read()
+    struct Record
+    {
+        RecordType type;                  //!< record type
+        int64_t time;                     //!< time, in time steps
+        double seconds;                   //!< time, in seconds
+        std::string context;              //!< trace context (may be empty)
+        uint32_t nodeId;                  //!< node id parsed from the context, or NO_ID
+        uint32_t deviceId;                //!< device id parsed from the context, or NO_ID
+        uint64_t uid;                     //!< packet uid
+        uint32_t size;                    //!< packet size
+        std::vector<std::string> headers; //!< names of the packet headers and trailers
+        std::vector<uint8_t> packet;      //!< serialized packet, if captured
+        std::string text;                 //!< text of TEXT records
+    };
+
+    BinaryTraceFile();
+    ~BinaryTraceFile();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    BinaryTraceFile(const BinaryTraceFile&) = delete;
+    BinaryTraceFile& operator=(const BinaryTraceFile&) = delete;
+
+    /**
+     * Open a file for writing or for reading.
+     *
+     * When opened for writing (std::ios::out, optionally with
+     * std::ios::app), a file header is written; appending to an existing
+     * binary trace file is supported.
+     *
+     * \param filename file name
+     * \param mode std::ios::in to read, std::ios::out to write
+     * \param capturePackets whether to store the serialized packets, when writing
+     */
+    void Open(const std::string& filename, std::ios::openmode mode, bool capturePackets = false);
+
+    /**
+     * Write the buffered records and close the file.
+     */
+    void Close();
+
+    /**
+     * \return true if the 'fail' bit is set in the underlying stream
+     */
+    bool Fail() const;
+
+    /**
+     * Write the buffered records to the file.
+     */
+    void Flush();
+
+    /**
+     * Record a packet event.
+     * \param type the event type (not TEXT)
+     * \param time the time of the event
+     * \param context the trace context (may be empty)
+     * \param p the packet
+     */
+    void Write(RecordType type, Time time, const std::string& context, Ptr<const Packet> p);
+
+    /**
+     * Record free text.
+     * \param text the text
+     */
+    void WriteText(const std::string& text);
+
+    /**
+     * \return a stream whose output is recorded as text records each time
+     *         it is flushed (e.g., by std::endl)
+     */
+    std::ostream* GetTextStream();
+
+    /**
+     * Read the next record of a file opened for reading.
+     * \param record the record to fill
+     * \return false at the end of the file or if the file is corrupted
+     */
+    bool Read(Record& record);
+
+    /**
+     * Print a record in the format of the default ascii trace sinks.
+     *
+     * If the record holds the serialized packet, the output is identical to
+     * the one of the ascii trace sinks (provided that the types of the packet
+     * headers are available). Otherwise, the header names and the packet uid
+     * and size are printed instead of the packet contents.
+     *
+     * \param record the record
+     * \param os the output stream
+     */
+    static void PrintAscii(const Record& record, std::ostream& os);
+
+    /**
+     * Render a binary trace file as ascii text.
+     * \param filename the binary trace file name
+     * \param os the output stream
+     * \return the number of records converted
+     */
+    static uint64_t ConvertToAscii(const std::string& filename, std::ostream& os);
+
+  private:
+    /// Stream buffer recording its contents as text records when synced
+    class TextBuffer : public std::streambuf
+    {
+      public:
+        /**
+         * Constructor
+         * \param file the file to write the text records to
+         */
+        TextBuffer(BinaryTraceFile* file);
+
+        /// Write the pending text as a text record
+        void WritePending();
+
+      protected:
+        int_type overflow(int_type c) override;
+        std::streamsize xsputn(const char* s, std::streamsize n) override;
+        int sync() override;
+
+      private:
+        BinaryTraceFile* m_file; //!< the file
+        std::string m_pending;   //!< text not yet recorded
+    };
+
+    /// Stream buffer writing the buffered records of the file when synced
+    class FlushBuffer : public std::streambuf
+    {
+      public:
+        /**
+         * Constructor
+         * \param file the file whose records are written
+         */
+        FlushBuffer(BinaryTraceFile* file);
+
+      protected:
+        int sync() override;
+
+      private:
+        BinaryTraceFile* m_file; //!< the file
+    };
+
+    /**
+     * Append a byte to the write buffer.
+     * \param value the byte
+     */
+    void PutByte(uint8_t value);
+
+    /**
+     * Append a variable-length encoded integer to the write buffer.
+     * \param value the integer
+     */
+    void PutVarint(uint64_t value);
+
+    /**
+     * Append a string definition to the write buffer.
+     * \param index the string index
+     * \param s the string
+     */
+    void PutString(uint32_t index, const std::string& s);
+
+    /// Write the buffered records to the file if the buffer is nearly full
+    void MaybeFlush();
+
+    /**
+     * \param context the context
+     * \return the index of the context string, defining it if needed
+     */
+    uint32_t InternContext(const std::string& context);
+
+    /**
+     * \param uid the TypeId uid of a header or trailer
+     * \return the index of the TypeId name, defining it if needed
+     */
+    uint32_t InternTypeId(uint16_t uid);
+
+    /**
+     * \param value the integer to read
+     * \return false at the end of the file
+     */
+    bool GetVarint(uint64_t& value);
+
+    /**
+     * \param index the string index
+     * \param s the string to fill
+     * \return false if the index is not defined
+     */
+    bool LookupString(uint64_t index, std::string& s) const;
+
+    /**
+     * Parse the node and device ids from a context string.
+     * \param record the record whose context is parsed
+     */
+    static void ParseContext(Record& record);
+
+    std::fstream m_file;                           //!< the file
+    bool m_writing;                                //!< whether the file is open to write
+    bool m_capturePackets;                         //!< whether packets are stored
+    std::vector<uint8_t> m_buffer;                 //!< records not yet written
+    int64_t m_lastTime;                            //!< time of the last record
+    uint32_t m_nStrings;                           //!< number of strings defined
+    FlatHashMap<std::string, uint32_t> m_contexts; //!< indexes of the contexts
+    std::vector<uint32_t> m_typeIds;               //!< indexes of TypeId names, by uid
+    std::vector<uint32_t> m_itemIds;               //!< header indexes of a record
+    std::vector<uint8_t> m_serialized;             //!< serialized packet
+    std::vector<std::string> m_strings;            //!< strings read
+    int64_t m_stepsPerSecond;                      //!< time steps per second
+    TextBuffer m_textBuffer;                       //!< text stream buffer
+    std::ostream m_textStream;                     //!< text stream
+    FlushBuffer m_flushBuffer;                     //!< flush stream buffer
+    std::ostream m_flushStream;                    //!< stream flushed on fatal errors
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
@@ -24,8 +24,16 @@
  * COPYRIGHT (C) 1986 Gary S. Brown.  You may use this program, or
  * code or tables extracted from it, as desired without restriction.
  */
+#include "crc32.h"
+
+#include <cstddef>
 #include <stdint.h>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NS3_CRC32_CLMUL
+#include <immintrin.h>
+#endif
+
 namespace ns3
 {
 
@@ -67,16 +75,247 @@ static uint32_t crc32table[256] = {
     0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D,
 };
 
-uint32_t
-CRC32Calculate(const uint8_t* data, int length)
+/**
+ * Tables for the slice-by-8 CRC-32 algorithm.
+ *
+ * Row 0 is crc32table; row k holds the CRC of a byte followed by k zero bytes,
+ * so that eight input bytes can be folded into the CRC with eight independent
+ * table lookups.
+ */
+struct Crc32SliceBy8Tables
 {
-    uint32_t crc = 0xffffffff;
+    Crc32SliceBy8Tables()
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            table[0][i] = crc32table[i];
+        }
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            for (uint32_t k = 1; k < 8; k++)
+            {
+                uint32_t prev = table[k - 1][i];
+                table[k][i] = (prev >> 8) ^ crc32table[prev & 0xFF];
+            }
+        }
+    }
 
+    uint32_t table[8][256]; //!< slice-by-8 lookup tables
+};
+
+/**
+ * \returns the (lazily built) slice-by-8 tables
+ */
+static const Crc32SliceBy8Tables&
+GetCrc32SliceBy8Tables()
+{
+    static const Crc32SliceBy8Tables tables;
+    return tables;
+}
+
+/**
+ * Update a CRC-32 register one byte at a time.
+ *
+ * \param crc the current (non-inverted) CRC register
+ * \param data buffer to process
+ * \param length the length of the buffer (bytes)
+ * \returns the updated CRC register
+ */
+static uint32_t
+Crc32UpdateBytewise(uint32_t crc, const uint8_t* data, std::size_t length)
+{
     while (length--)
     {
         crc = (crc >> 8) ^ crc32table[(crc & 0xFF) ^ *data++];
     }
-    return ~crc;
+    return crc;
+}
+
+/**
+ * Update a CRC-32 register eight bytes at a time.
+ *
+ * \param crc the current (non-inverted) CRC register
+ * \param data buffer to process
+ * \param length the length of the buffer (bytes)
+ * \returns the updated CRC register
+ */
+static uint32_t
+Crc32UpdateSliceBy8(uint32_t crc, const uint8_t* data, std::size_t length)
+{
+    const auto& t = GetCrc32SliceBy8Tables().table;
+    while (length >= 8)
+    {
+        // Bytes are combined explicitly so that the result does not depend
+        // on the host byte order.
+        uint32_t lo = crc ^ (static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+                             (static_cast<uint32_t>(data[2]) << 16) |
+                             (static_cast<uint32_t>(data[3]) << 24));
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+        data += 8;
+        length -= 8;
+    }
+    return Crc32UpdateBytewise(crc, data, length);
+}
+
+#ifdef NS3_CRC32_CLMUL
+/**
+ * Update a CRC-32 register using carry-less multiplication (PCLMULQDQ).
+ *
+ * Implements the folding algorithm described in "Fast CRC Computation for
+ * Generic Polynomials Using PCLMULQDQ Instruction" (Intel, 2009), using the
+ * bit-reflected constants for the IEEE 802.3 polynomial.
+ *
+ * \param crc the current (non-inverted) CRC register
+ * \param data buffer to process; length must be at least 64 and a multiple of 16
+ * \param length the length of the buffer (bytes)
+ * \returns the updated CRC register
+ */
+__attribute__((target("pclmul,sse4.1"))) static uint32_t
+Crc32UpdateClmulBlocks(uint32_t crc, const uint8_t* data, std::size_t length)
+{
+    alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+    __m128i x0;
+    __m128i x1;
+    __m128i x2;
+    __m128i x3;
+    __m128i x4;
+    __m128i x5;
+    __m128i x6;
+    __m128i x7;
+    __m128i x8;
+
+    x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00));
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10));
+    x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20));
+    x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    data += 64;
+    length -= 64;
+
+    // Fold four 128-bit lanes in parallel
+    while (length >= 64)
+    {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 0x30)));
+        data += 64;
+        length -= 64;
+    }
+
+    // Fold the four lanes into a single 128-bit value
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // Fold any remaining 16-byte blocks
+    while (length >= 16)
+    {
+        x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        data += 16;
+        length -= 16;
+    }
+
+    // Fold 128 bits down to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+#endif /* NS3_CRC32_CLMUL */
+
+bool
+CRC32HasClmulSupport()
+{
+#ifdef NS3_CRC32_CLMUL
+    static const bool supported =
+        __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+uint32_t
+CRC32CalculateBytewise(const uint8_t* data, int length)
+{
+    return ~Crc32UpdateBytewise(0xffffffff, data, length);
+}
+
+uint32_t
+CRC32CalculateSliceBy8(const uint8_t* data, int length)
+{
+    return ~Crc32UpdateSliceBy8(0xffffffff, data, length);
+}
+
+uint32_t
+CRC32CalculateClmul(const uint8_t* data, int length)
+{
+    uint32_t crc = 0xffffffff;
+    std::size_t remaining = length;
+#ifdef NS3_CRC32_CLMUL
+    if (remaining >= CRC32_CLMUL_MIN_LENGTH && CRC32HasClmulSupport())
+    {
+        std::size_t blocks = remaining & ~static_cast<std::size_t>(15);
+        crc = Crc32UpdateClmulBlocks(crc, data, blocks);
+        data += blocks;
+        remaining -= blocks;
+    }
+#endif
+    return ~Crc32UpdateSliceBy8(crc, data, remaining);
+}
+
+uint32_t
+CRC32Calculate(const uint8_t* data, int length)
+{
+    if (length >= static_cast<int>(CRC32_CLMUL_MIN_LENGTH) && CRC32HasClmulSupport())
+    {
+        return CRC32CalculateClmul(data, length);
+    }
+    return CRC32CalculateSliceBy8(data, length);
 }
 
 } // namespace ns3
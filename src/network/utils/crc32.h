@@ -23,9 +23,19 @@
 namespace ns3
 {
 
+/**
+ * Minimum input length (bytes) for which the carry-less multiplication
+ * implementation is used; shorter inputs are handled by slice-by-8.
+ */
+constexpr uint32_t CRC32_CLMUL_MIN_LENGTH = 64;
+
 /**
  * Calculates the CRC-32 for a given input
  *
+ * The fastest implementation available on the host CPU is selected at
+ * runtime: carry-less multiplication (x86 PCLMULQDQ) for long inputs,
+ * slice-by-8 table lookup otherwise.
+ *
  * \param data buffer to calculate the checksum for
  * \param length the length of the buffer (bytes)
  * \returns the computed crc-32.
@@ -33,6 +43,44 @@ namespace ns3
  */
 uint32_t CRC32Calculate(const uint8_t* data, int length);
 
+/**
+ * Calculates the CRC-32 for a given input, one byte at a time.
+ *
+ * This is the reference implementation, kept for testing and benchmarking.
+ *
+ * \param data buffer to calculate the checksum for
+ * \param length the length of the buffer (bytes)
+ * \returns the computed crc-32.
+ */
+uint32_t CRC32CalculateBytewise(const uint8_t* data, int length);
+
+/**
+ * Calculates the CRC-32 for a given input, eight bytes at a time.
+ *
+ * \param data buffer to calculate the checksum for
+ * \param length the length of the buffer (bytes)
+ * \returns the computed crc-32.
+ */
+uint32_t CRC32CalculateSliceBy8(const uint8_t* data, int length);
+
+/**
+ * Calculates the CRC-32 for a given input using carry-less multiplication.
+ *
+ * Falls back to slice-by-8 when the CPU lacks PCLMULQDQ support and for the
+ * trailing bytes that do not fill a 16-byte block.
+ *
+ * \param data buffer to calculate the checksum for
+ * \param length the length of the buffer (bytes)
+ * \returns the computed crc-32.
+ */
+uint32_t CRC32CalculateClmul(const uint8_t* data, int length);
+
+/**
+ * \returns true if the host CPU supports the carry-less multiplication
+ * implementation of CRC-32.
+ */
+bool CRC32HasClmulSupport();
+
 } // namespace ns3
 
 #endif
@@ -66,17 +66,23 @@
 #include "ns3/double.h"
 #include "ns3/enum.h"
 #include "ns3/log.h"
+#include "ns3/packet-burst.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("ErrorModel");
 
+/// Largest packet size whose packet error rate is cached by RateErrorModel
+static const uint32_t PER_TABLE_MAX_SIZE = 65535;
+
 NS_OBJECT_ENSURE_REGISTERED(ErrorModel);
 
 TypeId
@@ -115,6 +121,26 @@ ErrorModel::IsCorrupt(Ptr<Packet> p)
     return result;
 }
 
+uint32_t
+ErrorModel::IsCorrupt(Ptr<const PacketBurst> burst, std::vector<bool>& corrupt)
+{
+    NS_LOG_FUNCTION(this << burst);
+    corrupt.assign(burst->GetNPackets(), false);
+    DoCorruptBurst(burst, corrupt);
+    return std::count(corrupt.begin(), corrupt.end(), true);
+}
+
+void
+ErrorModel::DoCorruptBurst(Ptr<const PacketBurst> burst, std::vector<bool>& corrupt)
+{
+    NS_LOG_FUNCTION(this << burst);
+    std::size_t i = 0;
+    for (auto it = burst->Begin(); it != burst->End(); ++it, ++i)
+    {
+        corrupt[i] = DoCorrupt(*it);
+    }
+}
+
 void
 ErrorModel::Reset()
 {
@@ -181,6 +207,8 @@ RateErrorModel::GetTypeId()
 }
 
 RateErrorModel::RateErrorModel()
+    : m_perTableUnit(ERROR_UNIT_PACKET),
+      m_perTableRate(0.0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -267,18 +295,69 @@ bool
 RateErrorModel::DoCorruptByte(Ptr<Packet> p)
 {
     NS_LOG_FUNCTION(this << p);
-    // compute pkt error rate, assume uniformly distributed byte error
-    double per = 1 - std::pow(1.0 - m_rate, static_cast<double>(p->GetSize()));
-    return (m_ranvar->GetValue() < per);
+    return (m_ranvar->GetValue() < GetPacketErrorRate(p->GetSize()));
 }
 
 bool
 RateErrorModel::DoCorruptBit(Ptr<Packet> p)
 {
     NS_LOG_FUNCTION(this << p);
-    // compute pkt error rate, assume uniformly distributed bit error
-    double per = 1 - std::pow(1.0 - m_rate, static_cast<double>(8 * p->GetSize()));
-    return (m_ranvar->GetValue() < per);
+    return (m_ranvar->GetValue() < GetPacketErrorRate(p->GetSize()));
+}
+
+double
+RateErrorModel::GetPacketErrorRate(uint32_t size)
+{
+    if (m_unit == ERROR_UNIT_PACKET)
+    {
+        return m_rate;
+    }
+    if (m_unit != m_perTableUnit || m_rate != m_perTableRate)
+    {
+        // the attributes changed since the table was filled
+        m_perTable.clear();
+        m_perTableUnit = m_unit;
+        m_perTableRate = m_rate;
+    }
+    if (size < m_perTable.size() && !std::isnan(m_perTable[size]))
+    {
+        return m_perTable[size];
+    }
+    // compute pkt error rate, assume uniformly distributed byte or bit error
+    double units = (m_unit == ERROR_UNIT_BIT) ? 8.0 * size : size;
+    double per = 1 - std::pow(1.0 - m_rate, units);
+    if (size <= PER_TABLE_MAX_SIZE)
+    {
+        if (size >= m_perTable.size())
+        {
+            m_perTable.resize(std::min(PER_TABLE_MAX_SIZE + 1, 2 * size + 1),
+                              std::numeric_limits<double>::quiet_NaN());
+        }
+        m_perTable[size] = per;
+    }
+    return per;
+}
+
+void
+RateErrorModel::DoCorruptBurst(Ptr<const PacketBurst> burst, std::vector<bool>& corrupt)
+{
+    NS_LOG_FUNCTION(this << burst);
+    if (!IsEnabled())
+    {
+        return;
+    }
+    // draw the random variates in a block, in the order in which DoCorrupt()
+    // would draw them for each packet in turn
+    m_draws.resize(corrupt.size());
+    for (auto& draw : m_draws)
+    {
+        draw = m_ranvar->GetValue();
+    }
+    std::size_t i = 0;
+    for (auto it = burst->Begin(); it != burst->End(); ++it, ++i)
+    {
+        corrupt[i] = m_draws[i] < GetPacketErrorRate((*it)->GetSize());
+    }
 }
 
 void
@@ -457,11 +536,10 @@ ListErrorModel::SetList(const std::list<uint64_t>& packetlist)
 {
     NS_LOG_FUNCTION(this << &packetlist);
     m_packetList = packetlist;
+    m_uids.clear();
+    m_uids.insert(m_packetList.begin(), m_packetList.end());
 }
 
-// When performance becomes a concern, the list provided could be
-// converted to a dynamically-sized array of uint32_t to avoid
-// list iteration below.
 bool
 ListErrorModel::DoCorrupt(Ptr<Packet> p)
 {
@@ -470,15 +548,7 @@ ListErrorModel::DoCorrupt(Ptr<Packet> p)
     {
         return false;
     }
-    auto uid = p->GetUid();
-    for (auto i = m_packetList.begin(); i != m_packetList.end(); i++)
-    {
-        if (uid == *i)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_uids.count(p->GetUid()) != 0;
 }
 
 void
@@ -486,6 +556,7 @@ ListErrorModel::DoReset()
 {
     NS_LOG_FUNCTION(this);
     m_packetList.clear();
+    m_uids.clear();
 }
 
 //
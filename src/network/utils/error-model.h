@@ -66,11 +66,14 @@
 #include "ns3/random-variable-stream.h"
 
 #include <list>
+#include <unordered_set>
+#include <vector>
 
 namespace ns3
 {
 
 class Packet;
+class PacketBurst;
 
 /**
  * \ingroup network
@@ -133,6 +136,19 @@ class ErrorModel : public Object
      * \param pkt Packet to apply error model to
      */
     bool IsCorrupt(Ptr<Packet> pkt);
+    /**
+     * Evaluate the packets of a burst, in order, as if IsCorrupt() was
+     * called for each of them in turn.
+     *
+     * Error models may implement this more efficiently than the
+     * corresponding sequence of IsCorrupt() calls; the outcome is the same.
+     *
+     * \param burst the packets to apply the error model to
+     * \param corrupt set to one flag per packet of the burst, true if the
+     *        packet is to be considered as errored/corrupted
+     * \returns the number of errored/corrupted packets
+     */
+    uint32_t IsCorrupt(Ptr<const PacketBurst> burst, std::vector<bool>& corrupt);
     /**
      * Reset any state associated with the error model
      */
@@ -157,6 +173,15 @@ class ErrorModel : public Object
      * \returns true if the packet is corrupted
      */
     virtual bool DoCorrupt(Ptr<Packet> p) = 0;
+    /**
+     * Corrupt the packets of a burst according to the specified model.
+     *
+     * The default implementation calls DoCorrupt() for each packet.
+     *
+     * \param burst the packets to corrupt
+     * \param corrupt the flags to set, already sized to the number of packets
+     */
+    virtual void DoCorruptBurst(Ptr<const PacketBurst> burst, std::vector<bool>& corrupt);
     /**
      * Re-initialize any state
      */
@@ -179,6 +204,12 @@ class ErrorModel : public Object
  * Reset() on this model will do nothing
  *
  * IsCorrupt() will not modify the packet data buffer
+ *
+ * The packet error rates derived from the bit or byte error rate are
+ * cached by packet size, and the random variates needed to evaluate a
+ * burst of packets are drawn in a block.
+ * Subclasses overriding DoCorruptPkt(), DoCorruptByte() or DoCorruptBit()
+ * should override DoCorruptBurst() as well.
  */
 class RateErrorModel : public ErrorModel
 {
@@ -255,12 +286,24 @@ class RateErrorModel : public ErrorModel
      * \returns true if the packet is corrupted
      */
     virtual bool DoCorruptBit(Ptr<Packet> p);
+    void DoCorruptBurst(Ptr<const PacketBurst> burst, std::vector<bool>& corrupt) override;
     void DoReset() override;
 
+    /**
+     * \param size the packet size, in bytes
+     * \return the probability that a packet of the given size is errored
+     */
+    double GetPacketErrorRate(uint32_t size);
+
     ErrorUnit m_unit; //!< Error rate unit
     double m_rate;    //!< Error rate
 
     Ptr<RandomVariableStream> m_ranvar; //!< rng stream
+
+    std::vector<double> m_perTable; //!< Packet error rates by size, NaN if not computed yet
+    ErrorUnit m_perTableUnit;       //!< Error rate unit of m_perTable
+    double m_perTableRate;          //!< Error rate of m_perTable
+    std::vector<double> m_draws;    //!< Random variates drawn for a burst
 };
 
 /**
@@ -356,10 +399,8 @@ class BurstErrorModel : public ErrorModel
  * \brief Provide a list of Packet uids to corrupt
  *
  * This object is used to flag packets as being lost/errored or not.
- * A note on performance:  the list is assumed to be unordered, and
- * in general, Packet uids received may be unordered.  Therefore,
- * each call to IsCorrupt() will result in a walk of the list with
- * the present underlying implementation.
+ * The uids of the list are also stored in a hash set, so that each call
+ * to IsCorrupt() takes constant time regardless of the list length.
  *
  * Note also that if one wants to target multiple packets from looking
  * at an (unerrored) trace file, the act of erroring a given packet may
@@ -405,7 +446,8 @@ class ListErrorModel : public ErrorModel
     /// Typedef: packet Uid list const iterator
     typedef std::list<uint64_t>::const_iterator PacketListCI;
 
-    PacketList m_packetList; //!< container of Uid of packets to corrupt
+    PacketList m_packetList;             //!< container of Uid of packets to corrupt
+    std::unordered_set<uint64_t> m_uids; //!< set of Uid of packets to corrupt
 };
 
 /**
@@ -0,0 +1,481 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include "address-hash.h"
+
+#include "ns3/assert.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdint.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup address
+ * ns3::FlatHashMap declaration and implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup address
+ * \brief Open addressing hash map storing its elements in a flat array.
+ *
+ * Elements are stored in a single power-of-two sized array and collisions
+ * are resolved by linear probing, so a lookup touches one or a few adjacent
+ * cache lines instead of following the pointers of a tree (std::map) or of
+ * a bucket list (std::unordered_map). Erased elements leave a tombstone,
+ * which keeps iterators to the other elements valid; tombstones are purged
+ * when the table is rehashed.
+ *
+ * The interface is a subset of the one of std::unordered_map. The main
+ * differences are:
+ * - Key and T must be default constructible and copy assignable;
+ * - the value_type is std::pair<Key, T>: keys must not be modified
+ *   through iterators;
+ * - any insertion may rehash the table, invalidating all iterators and
+ *   references;
+ * - the iteration order is unspecified (it depends on the hash values).
+ *
+ * \tparam Key the key type
+ * \tparam T the mapped type
+ * \tparam Hash the hash functor (FlatHash by default)
+ * \tparam KeyEqual the key comparison functor
+ */
+template <typename Key,
+          typename T,
+          typename Hash = FlatHash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap
+{
+  public:
+    /// Key type
+    typedef Key key_type;
+    /// Mapped type
+    typedef T mapped_type;
+    /// Element type
+    typedef std::pair<Key, T> value_type;
+    /// Size type
+    typedef std::size_t size_type;
+
+    /**
+     * \brief Forward iterator over the elements of a FlatHashMap.
+     * \tparam Const whether the iterator gives const access to the elements
+     */
+    template <bool Const>
+    class IteratorBase
+    {
+      public:
+        /// Iterator category
+        typedef std::forward_iterator_tag iterator_category;
+        /// Element type
+        typedef typename FlatHashMap::value_type value_type;
+        /// Difference type
+        typedef std::ptrdiff_t difference_type;
+        /// Pointer type
+        typedef std::conditional_t<Const, const value_type*, value_type*> pointer;
+        /// Reference type
+        typedef std::conditional_t<Const, const value_type&, value_type&> reference;
+        /// Map type
+        typedef std::conditional_t<Const, const FlatHashMap, FlatHashMap> map_type;
+
+        IteratorBase()
+            : m_map(nullptr),
+              m_index(0)
+        {
+        }
+
+        /**
+         * Constructor
+         * \param map the map to iterate over
+         * \param index the index of the slot the iterator points to
+         */
+        IteratorBase(map_type* map, std::size_t index)
+            : m_map(map),
+              m_index(index)
+        {
+        }
+
+        /**
+         * Conversion from a non-const iterator
+         * \param o the iterator to convert
+         */
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        IteratorBase(const IteratorBase<false>& o)
+            : m_map(o.m_map),
+              m_index(o.m_index)
+        {
+        }
+
+        /// \return a reference to the element
+        reference operator*() const
+        {
+            return m_map->m_slots[m_index];
+        }
+
+        /// \return a pointer to the element
+        pointer operator->() const
+        {
+            return &m_map->m_slots[m_index];
+        }
+
+        /// \return the iterator advanced to the next element
+        IteratorBase& operator++()
+        {
+            m_index = m_map->NextFull(m_index + 1);
+            return *this;
+        }
+
+        /// \return a copy of the iterator before advancing it to the next element
+        IteratorBase operator++(int)
+        {
+            IteratorBase tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        /**
+         * \param o the other iterator
+         * \return true if the iterators point to the same slot
+         */
+        bool operator==(const IteratorBase& o) const
+        {
+            return m_index == o.m_index && m_map == o.m_map;
+        }
+
+        /**
+         * \param o the other iterator
+         * \return true if the iterators point to different slots
+         */
+        bool operator!=(const IteratorBase& o) const
+        {
+            return !(*this == o);
+        }
+
+      private:
+        friend class FlatHashMap;
+        friend class IteratorBase<true>;
+
+        map_type* m_map;     //!< the map
+        std::size_t m_index; //!< the index of the slot
+    };
+
+    /// Iterator
+    typedef IteratorBase<false> iterator;
+    /// Const iterator
+    typedef IteratorBase<true> const_iterator;
+
+    FlatHashMap()
+        : m_size(0),
+          m_deleted(0)
+    {
+    }
+
+    /// \return an iterator to the first element
+    iterator begin()
+    {
+        return iterator(this, NextFull(0));
+    }
+
+    /// \return an iterator past the last element
+    iterator end()
+    {
+        return iterator(this, m_slots.size());
+    }
+
+    /// \return a const iterator to the first element
+    const_iterator begin() const
+    {
+        return const_iterator(this, NextFull(0));
+    }
+
+    /// \return a const iterator past the last element
+    const_iterator end() const
+    {
+        return const_iterator(this, m_slots.size());
+    }
+
+    /// \return true if the map contains no element
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /// \return the number of elements
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    /**
+     * \param key the key to look for
+     * \return an iterator to the element with the given key, or end()
+     */
+    iterator find(const Key& key)
+    {
+        return iterator(this, FindSlot(key));
+    }
+
+    /**
+     * \param key the key to look for
+     * \return a const iterator to the element with the given key, or end()
+     */
+    const_iterator find(const Key& key) const
+    {
+        return const_iterator(this, FindSlot(key));
+    }
+
+    /**
+     * \param key the key to look for
+     * \return 1 if an element with the given key exists, 0 otherwise
+     */
+    std::size_t count(const Key& key) const
+    {
+        return FindSlot(key) != m_slots.size() ? 1 : 0;
+    }
+
+    /**
+     * \param key the key to look for
+     * \return a reference to the value mapped to the key, inserting a default
+     *         constructed value if no such element exists
+     */
+    T& operator[](const Key& key)
+    {
+        return m_slots[InsertSlot(key).first].second;
+    }
+
+    /**
+     * Insert an element, if no element with the same key exists.
+     * \param value the element to insert
+     * \return an iterator to the element with the given key and whether the
+     *         element has been inserted
+     */
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        auto [index, inserted] = InsertSlot(value.first);
+        if (inserted)
+        {
+            m_slots[index].second = value.second;
+        }
+        return {iterator(this, index), inserted};
+    }
+
+    /**
+     * Erase an element.
+     * \param pos iterator to the element to erase
+     * \return an iterator to the element following the erased one
+     */
+    iterator erase(const_iterator pos)
+    {
+        NS_ASSERT(pos.m_map == this && pos.m_index < m_slots.size() &&
+                  m_states[pos.m_index] == FULL);
+        m_states[pos.m_index] = DELETED;
+        m_slots[pos.m_index] = value_type(); // release the resources held by the element
+        m_size--;
+        m_deleted++;
+        return iterator(this, NextFull(pos.m_index + 1));
+    }
+
+    /**
+     * Erase the element with the given key, if any.
+     * \param key the key to look for
+     * \return the number of erased elements (0 or 1)
+     */
+    std::size_t erase(const Key& key)
+    {
+        std::size_t index = FindSlot(key);
+        if (index == m_slots.size())
+        {
+            return 0;
+        }
+        erase(const_iterator(this, index));
+        return 1;
+    }
+
+    /// Erase all the elements, keeping the allocated storage.
+    void clear()
+    {
+        std::fill(m_states.begin(), m_states.end(), EMPTY);
+        std::fill(m_slots.begin(), m_slots.end(), value_type());
+        m_size = 0;
+        m_deleted = 0;
+    }
+
+    /**
+     * Allocate storage so that the given number of elements can be stored
+     * without rehashing.
+     * \param count the number of elements
+     */
+    void reserve(std::size_t count)
+    {
+        std::size_t capacity = MIN_CAPACITY;
+        while (!FitsLoad(count, capacity))
+        {
+            capacity *= 2;
+        }
+        if (capacity > m_slots.size())
+        {
+            Rehash(capacity);
+        }
+    }
+
+  private:
+    /// Slot states
+    enum SlotState : uint8_t
+    {
+        EMPTY,   //!< never used since the last rehash
+        FULL,    //!< holds an element
+        DELETED, //!< tombstone left by an erased element
+    };
+
+    /// Minimum table size
+    static constexpr std::size_t MIN_CAPACITY = 8;
+
+    /**
+     * \param used the number of used (full or deleted) slots
+     * \param capacity the table size
+     * \return whether the load factor stays within 7/8
+     */
+    static bool FitsLoad(std::size_t used, std::size_t capacity)
+    {
+        return used * 8 <= capacity * 7;
+    }
+
+    /**
+     * \param index the index to start from
+     * \return the index of the first full slot at or after the given index,
+     *         or the table size if none
+     */
+    std::size_t NextFull(std::size_t index) const
+    {
+        while (index < m_states.size() && m_states[index] != FULL)
+        {
+            index++;
+        }
+        return index;
+    }
+
+    /**
+     * \param key the key to look for
+     * \return the index of the slot holding the key, or the table size if none
+     */
+    std::size_t FindSlot(const Key& key) const
+    {
+        if (m_size == 0)
+        {
+            return m_slots.size();
+        }
+        std::size_t mask = m_slots.size() - 1;
+        for (std::size_t index = m_hash(key) & mask;; index = (index + 1) & mask)
+        {
+            if (m_states[index] == EMPTY)
+            {
+                return m_slots.size();
+            }
+            if (m_states[index] == FULL && m_equal(m_slots[index].first, key))
+            {
+                return index;
+            }
+        }
+    }
+
+    /**
+     * Find the slot holding the key, or allocate one for it.
+     * \param key the key to look for
+     * \return the index of the slot and whether it has been newly allocated
+     */
+    std::pair<std::size_t, bool> InsertSlot(const Key& key)
+    {
+        std::size_t found = FindSlot(key);
+        if (found != m_slots.size())
+        {
+            return {found, false};
+        }
+        if (m_slots.empty() || !FitsLoad(m_size + m_deleted + 1, m_slots.size()))
+        {
+            // grow if the elements alone would exceed half the maximum load,
+            // otherwise just purge the tombstones
+            std::size_t capacity = std::max(MIN_CAPACITY, m_slots.size());
+            while (!FitsLoad(2 * (m_size + 1), capacity))
+            {
+                capacity *= 2;
+            }
+            Rehash(capacity);
+        }
+        std::size_t mask = m_slots.size() - 1;
+        std::size_t index = m_hash(key) & mask;
+        while (m_states[index] == FULL)
+        {
+            index = (index + 1) & mask;
+        }
+        if (m_states[index] == DELETED)
+        {
+            m_deleted--;
+        }
+        m_states[index] = FULL;
+        m_slots[index].first = key;
+        m_size++;
+        return {index, true};
+    }
+
+    /**
+     * Move all the elements to a new table, dropping the tombstones.
+     * \param capacity the new table size (a power of two)
+     */
+    void Rehash(std::size_t capacity)
+    {
+        NS_ASSERT((capacity & (capacity - 1)) == 0);
+        std::vector<uint8_t> states(capacity, EMPTY);
+        std::vector<value_type> slots(capacity);
+        std::size_t mask = capacity - 1;
+        for (std::size_t i = 0; i < m_slots.size(); i++)
+        {
+            if (m_states[i] != FULL)
+            {
+                continue;
+            }
+            std::size_t index = m_hash(m_slots[i].first) & mask;
+            while (states[index] == FULL)
+            {
+                index = (index + 1) & mask;
+            }
+            states[index] = FULL;
+            slots[index] = std::move(m_slots[i]);
+        }
+        m_states.swap(states);
+        m_slots.swap(slots);
+        m_deleted = 0;
+    }
+
+    std::vector<uint8_t> m_states;   //!< the state of each slot
+    std::vector<value_type> m_slots; //!< the slots
+    std::size_t m_size;              //!< the number of elements
+    std::size_t m_deleted;           //!< the number of tombstones
+    Hash m_hash;                     //!< the hash functor
+    KeyEqual m_equal;                //!< the key comparison functor
+};
+
+} // namespace ns3
+
+#endif /* FLAT_HASH_MAP_H */
@@ -19,6 +19,7 @@
 
 #include "ipv6-address.h"
 
+#include "address-hash.h"
 #include "mac16-address.h"
 #include "mac48-address.h"
 #include "mac64-address.h"
@@ -41,120 +42,6 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Ipv6Address");
 
-#ifdef __cplusplus
-extern "C"
-{ /* } */
-#endif
-    /**
-     * \brief Mix hash keys in-place for lookuphash
-     *
-     * \param a first word of the hash key
-     * \param b second word of the hash key
-     * \param c third word of the hash key
-     */
-    void mixHashKey(uint32_t& a, uint32_t& b, uint32_t& c)
-    {
-        (a) -= (b);
-        (a) -= (c);
-        (a) ^= ((c) >> 13);
-        (b) -= (c);
-        (b) -= (a);
-        (b) ^= ((a) << 8);
-        (c) -= (a);
-        (c) -= (b);
-        (c) ^= ((b) >> 13);
-        (a) -= (b);
-        (a) -= (c);
-        (a) ^= ((c) >> 12);
-        (b) -= (c);
-        (b) -= (a);
-        (b) ^= ((a) << 16);
-        (c) -= (a);
-        (c) -= (b);
-        (c) ^= ((b) >> 5);
-        (a) -= (b);
-        (a) -= (c);
-        (a) ^= ((c) >> 3);
-        (b) -= (c);
-        (b) -= (a);
-        (b) ^= ((a) << 10);
-        (c) -= (a);
-        (c) -= (b);
-        (c) ^= ((b) >> 15);
-    }
-
-    /**
-     * \brief Get a hash key.
-     * \param k the key
-     * \param length the length of the key
-     * \param level the previous hash, or an arbitrary value
-     * \return hash
-     * \note Adapted from Jens Jakobsen implementation (chillispot).
-     */
-    static uint32_t lookuphash(unsigned char* k, uint32_t length, uint32_t level)
-    {
-        NS_LOG_FUNCTION(k << length << level);
-
-        typedef uint32_t ub4; /* unsigned 4-byte quantities */
-        uint32_t a = 0;
-        uint32_t b = 0;
-        uint32_t c = 0;
-        uint32_t len = 0;
-
-        /* Set up the internal state */
-        len = length;
-        a = b = 0x9e3779b9; /* the golden ratio; an arbitrary value */
-        c = level;          /* the previous hash value */
-
-        /* handle most of the key */
-        while (len >= 12)
-        {
-            a += (k[0] + ((ub4)k[1] << 8) + ((ub4)k[2] << 16) + ((ub4)k[3] << 24));
-            b += (k[4] + ((ub4)k[5] << 8) + ((ub4)k[6] << 16) + ((ub4)k[7] << 24));
-            c += (k[8] + ((ub4)k[9] << 8) + ((ub4)k[10] << 16) + ((ub4)k[11] << 24));
-            mixHashKey(a, b, c);
-            k += 12;
-            len -= 12;
-        }
-
-        /* handle the last 11 bytes */
-        c += length;
-        switch (len) /* all the case statements fall through */
-        {
-        case 11:
-            c += ((ub4)k[10] << 24);
-        case 10:
-            c += ((ub4)k[9] << 16);
-        case 9:
-            c += ((ub4)k[8] << 8); /* the first byte of c is reserved for the length */
-        case 8:
-            b += ((ub4)k[7] << 24);
-        case 7:
-            b += ((ub4)k[6] << 16);
-        case 6:
-            b += ((ub4)k[5] << 8);
-        case 5:
-            b += k[4];
-        case 4:
-            a += ((ub4)k[3] << 24);
-        case 3:
-            a += ((ub4)k[2] << 16);
-        case 2:
-            a += ((ub4)k[1] << 8);
-        case 1:
-            a += k[0];
-            /* case 0: nothing left to add */
-        }
-        mixHashKey(a, b, c);
-
-        /* report the result */
-        return c;
-    }
-
-#ifdef __cplusplus
-}
-#endif
-
 Ipv6Address::Ipv6Address()
 {
     NS_LOG_FUNCTION(this);
@@ -581,20 +468,16 @@ Ipv6Address
 Ipv6Address::CombinePrefix(const Ipv6Prefix& prefix) const
 {
     NS_LOG_FUNCTION(this << prefix);
-    Ipv6Address ipv6;
-    uint8_t addr[16];
-    uint8_t pref[16];
-    unsigned int i = 0;
+    uint64_t addr[2];
+    uint64_t pref[2];
+    GetWords(addr);
+    prefix.GetWords(pref);
+    addr[0] &= pref[0];
+    addr[1] &= pref[1];
 
-    memcpy(addr, m_address, 16);
-    ((Ipv6Prefix)prefix).GetBytes(pref);
-
-    /* a little bit ugly... */
-    for (i = 0; i < 16; i++)
-    {
-        addr[i] = addr[i] & pref[i];
-    }
-    ipv6.Set(addr);
+    Ipv6Address ipv6;
+    memcpy(ipv6.m_address, addr, 16);
+    ipv6.m_initialized = true;
     return ipv6;
 }
 
@@ -603,8 +486,8 @@ Ipv6Address::IsSolicitedMulticast() const
 {
     NS_LOG_FUNCTION(this);
 
-    static Ipv6Address documentation("ff02::1:ff00:0");
-    return CombinePrefix(Ipv6Prefix(104)) == documentation;
+    static const uint8_t solicited[13] = {0xff, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01, 0xff};
+    return memcmp(m_address, solicited, sizeof(solicited)) == 0;
 }
 
 bool
@@ -633,16 +516,17 @@ bool
 Ipv6Address::IsAny() const
 {
     NS_LOG_FUNCTION(this);
-    static Ipv6Address any("::");
-    return (*this == any);
+    uint64_t words[2];
+    GetWords(words);
+    return words[0] == 0 && words[1] == 0;
 }
 
 bool
 Ipv6Address::IsDocumentation() const
 {
     NS_LOG_FUNCTION(this);
-    static Ipv6Address documentation("2001:db8::0");
-    return CombinePrefix(Ipv6Prefix(32)) == documentation;
+    static const uint8_t documentation[4] = {0x20, 0x01, 0x0d, 0xb8};
+    return memcmp(m_address, documentation, sizeof(documentation)) == 0;
 }
 
 bool
@@ -650,10 +534,12 @@ Ipv6Address::HasPrefix(const Ipv6Prefix& prefix) const
 {
     NS_LOG_FUNCTION(this << prefix);
 
-    Ipv6Address masked = CombinePrefix(prefix);
-    Ipv6Address reference = Ipv6Address::GetOnes().CombinePrefix(prefix);
+    uint64_t addr[2];
+    uint64_t pref[2];
+    GetWords(addr);
+    prefix.GetWords(pref);
 
-    return masked == reference;
+    return (addr[0] & pref[0]) == pref[0] && (addr[1] & pref[1]) == pref[1];
 }
 
 bool
@@ -762,8 +648,8 @@ bool
 Ipv6Address::IsLinkLocal() const
 {
     NS_LOG_FUNCTION(this);
-    static Ipv6Address linkLocal("fe80::0");
-    return CombinePrefix(Ipv6Prefix(64)) == linkLocal;
+    static const uint8_t linkLocal[8] = {0xfe, 0x80, 0, 0, 0, 0, 0, 0};
+    return memcmp(m_address, linkLocal, sizeof(linkLocal)) == 0;
 }
 
 bool
@@ -899,22 +785,14 @@ bool
 Ipv6Prefix::IsMatch(Ipv6Address a, Ipv6Address b) const
 {
     NS_LOG_FUNCTION(this << a << b);
-    uint8_t addrA[16];
-    uint8_t addrB[16];
-    unsigned int i = 0;
-
-    a.GetBytes(addrA);
-    b.GetBytes(addrB);
+    uint64_t addrA[2];
+    uint64_t addrB[2];
+    uint64_t pref[2];
+    a.GetWords(addrA);
+    b.GetWords(addrB);
+    GetWords(pref);
 
-    /* a little bit ugly... */
-    for (i = 0; i < 16; i++)
-    {
-        if ((addrA[i] & m_prefix[i]) != (addrB[i] & m_prefix[i]))
-        {
-            return false;
-        }
-    }
-    return true;
+    return ((addrA[0] ^ addrB[0]) & pref[0]) == 0 && ((addrA[1] ^ addrB[1]) & pref[1]) == 0;
 }
 
 void
@@ -1028,11 +906,7 @@ operator>>(std::istream& is, Ipv6Prefix& prefix)
 size_t
 Ipv6AddressHash::operator()(const Ipv6Address& x) const
 {
-    uint8_t buf[16];
-
-    x.GetBytes(buf);
-
-    return lookuphash(buf, sizeof(buf), 0);
+    return FlatHash<Ipv6Address>()(x);
 }
 
 ATTRIBUTE_HELPER_CPP(Ipv6Address);
@@ -403,6 +403,16 @@ class Ipv6Address
      */
     void GetBytes(uint8_t buf[16]) const;
 
+    /**
+     * \brief Get the address as two 64-bit words.
+     *
+     * The words hold the bytes of the address in memory order: they are
+     * suited to equality tests, masking and hashing, not to arithmetic.
+     *
+     * \param words the words to store the address in
+     */
+    void GetWords(uint64_t words[2]) const;
+
   private:
     /**
      * \brief Return the Type of address.
@@ -531,6 +541,16 @@ class Ipv6Prefix
      */
     void GetBytes(uint8_t buf[16]) const;
 
+    /**
+     * \brief Get the prefix as two 64-bit words.
+     *
+     * The words hold the bytes of the prefix in memory order, as
+     * Ipv6Address::GetWords.
+     *
+     * \param words the words to store the prefix in
+     */
+    void GetWords(uint64_t words[2]) const;
+
     /**
      * \brief Convert the Prefix into an IPv6 Address.
      * \return an IPv6 address representing the prefix
@@ -651,16 +671,32 @@ std::istream& operator>>(std::istream& is, Ipv6Address& address);
  */
 std::istream& operator>>(std::istream& is, Ipv6Prefix& prefix);
 
+inline void
+Ipv6Address::GetWords(uint64_t words[2]) const
+{
+    std::memcpy(words, m_address, 16);
+}
+
+inline void
+Ipv6Prefix::GetWords(uint64_t words[2]) const
+{
+    std::memcpy(words, m_prefix, 16);
+}
+
 inline bool
 operator==(const Ipv6Address& a, const Ipv6Address& b)
 {
-    return !std::memcmp(a.m_address, b.m_address, 16);
+    uint64_t wordsA[2];
+    uint64_t wordsB[2];
+    a.GetWords(wordsA);
+    b.GetWords(wordsB);
+    return wordsA[0] == wordsB[0] && wordsA[1] == wordsB[1];
 }
 
 inline bool
 operator!=(const Ipv6Address& a, const Ipv6Address& b)
 {
-    return std::memcmp(a.m_address, b.m_address, 16);
+    return !(a == b);
 }
 
 inline bool
@@ -672,13 +708,17 @@ operator<(const Ipv6Address& a, const Ipv6Address& b)
 inline bool
 operator==(const Ipv6Prefix& a, const Ipv6Prefix& b)
 {
-    return !std::memcmp(a.m_prefix, b.m_prefix, 16);
+    uint64_t wordsA[2];
+    uint64_t wordsB[2];
+    a.GetWords(wordsA);
+    b.GetWords(wordsB);
+    return wordsA[0] == wordsB[0] && wordsA[1] == wordsB[1];
 }
 
 inline bool
 operator!=(const Ipv6Prefix& a, const Ipv6Prefix& b)
 {
-    return std::memcmp(a.m_prefix, b.m_prefix, 16);
+    return !(a == b);
 }
 
 /**
@@ -17,6 +17,8 @@
 
 #include "output-stream-wrapper.h"
 
+#include "binary-trace-file.h"
+
 #include "ns3/abort.h"
 #include "ns3/fatal-impl.h"
 #include "ns3/log.h"
@@ -50,6 +52,15 @@ OutputStreamWrapper::OutputStreamWrapper(std::ostream* os)
     NS_ABORT_MSG_UNLESS(m_ostream->good(), "Output stream is not valid for writing.");
 }
 
+OutputStreamWrapper::OutputStreamWrapper(Ptr<BinaryTraceFile> file)
+    : m_ostream(file->GetTextStream()),
+      m_destroyable(false),
+      m_binaryFile(file)
+{
+    NS_LOG_FUNCTION(this << file);
+    FatalImpl::RegisterStream(m_ostream);
+}
+
 OutputStreamWrapper::~OutputStreamWrapper()
 {
     NS_LOG_FUNCTION(this);
@@ -68,4 +79,10 @@ OutputStreamWrapper::GetStream()
     return m_ostream;
 }
 
+Ptr<BinaryTraceFile>
+OutputStreamWrapper::GetBinaryTraceFile() const
+{
+    return m_binaryFile;
+}
+
 } // namespace ns3
@@ -27,6 +27,8 @@
 namespace ns3
 {
 
+class BinaryTraceFile;
+
 /**
  * @brief A class encapsulating an output stream.
  *
@@ -82,6 +84,16 @@ class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
      * \param os output stream
      */
     OutputStreamWrapper(std::ostream* os);
+    /**
+     * Constructor of a wrapper writing to a binary trace file.
+     *
+     * Trace sinks aware of the binary trace format write their records
+     * directly to the file (see GetBinaryTraceFile()); text written to the
+     * stream returned by GetStream() is stored as text records.
+     *
+     * \param file binary trace file, open for writing
+     */
+    OutputStreamWrapper(Ptr<BinaryTraceFile> file);
     ~OutputStreamWrapper();
 
     /**
@@ -93,9 +105,16 @@ class OutputStreamWrapper : public SimpleRefCount<OutputStreamWrapper>
      */
     std::ostream* GetStream();
 
+    /**
+     * \returns the binary trace file written by this wrapper, or nullptr if
+     *          it writes to a plain output stream
+     */
+    Ptr<BinaryTraceFile> GetBinaryTraceFile() const;
+
   private:
-    std::ostream* m_ostream; //!< The output stream
-    bool m_destroyable;      //!< Can be destroyed
+    std::ostream* m_ostream;           //!< The output stream
+    bool m_destroyable;                //!< Can be destroyed
+    Ptr<BinaryTraceFile> m_binaryFile; //!< The binary trace file, if any
 };
 
 } // namespace ns3
@@ -0,0 +1,448 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PREFIX_TRIE_H
+#define PREFIX_TRIE_H
+
+#include "ipv4-address.h"
+#include "ipv6-address.h"
+
+#include "ns3/assert.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup address
+ * ns3::PrefixTrie declaration and implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup address
+ * \brief Path-compressed binary trie (Patricia trie) of address prefixes.
+ *
+ * Each prefix is a key of N bytes (in network order) together with a length
+ * in bits, and is associated with a list of values kept in insertion order.
+ * Chains of nodes having a single child and no value are collapsed, so that
+ * the trie holds at most two nodes per prefix and a lookup visits at most
+ * one node per distinct prefix length on the path to the key.
+ *
+ * Match() enumerates the prefixes matching a key from the longest to the
+ * shortest, which is what longest prefix match forwarding needs; the caller
+ * chooses among the values of a prefix (e.g., by metric) and decides whether
+ * to continue with the shorter prefixes.
+ *
+ * Nodes are stored in a vector and recycled, so that building a table of
+ * many prefixes does not allocate one heap block per node.
+ *
+ * \tparam T the value type
+ * \tparam N the key size in bytes (4 for IPv4, 16 for IPv6)
+ */
+template <typename T, std::size_t N>
+class PrefixTrie
+{
+  public:
+    /// Key type
+    typedef std::array<uint8_t, N> Key;
+
+    /// Number of bits of a key
+    static constexpr uint16_t KEY_BITS = N * 8;
+
+    PrefixTrie()
+        : m_root(NONE),
+          m_nPrefixes(0)
+    {
+    }
+
+    /**
+     * \param address an IPv4 address
+     * \return the key of the address
+     */
+    static Key GetKey(Ipv4Address address)
+    {
+        static_assert(N == 4, "IPv4 keys are 4 bytes long");
+        Key key;
+        address.Serialize(key.data());
+        return key;
+    }
+
+    /**
+     * \param address an IPv6 address
+     * \return the key of the address
+     */
+    static Key GetKey(Ipv6Address address)
+    {
+        static_assert(N == 16, "IPv6 keys are 16 bytes long");
+        Key key;
+        address.GetBytes(key.data());
+        return key;
+    }
+
+    /**
+     * Add a value to a prefix. The value is appended to the values already
+     * associated with the prefix, if any.
+     * \param key the prefix key (bits beyond the length are ignored)
+     * \param length the prefix length, in bits
+     * \param value the value
+     */
+    void Insert(const Key& key, uint16_t length, const T& value)
+    {
+        NS_ASSERT(length <= KEY_BITS);
+        Key masked = Mask(key, length);
+        uint32_t parent = NONE;
+        uint8_t bit = 0;
+        uint32_t current = m_root;
+        while (current != NONE)
+        {
+            uint16_t nodeLength = m_nodes[current].length;
+            uint16_t common =
+                CommonLength(m_nodes[current].key, masked, std::min(nodeLength, length));
+            if (common == nodeLength)
+            {
+                if (nodeLength == length)
+                {
+                    if (m_nodes[current].values.empty())
+                    {
+                        m_nPrefixes++;
+                    }
+                    m_nodes[current].values.push_back(value);
+                    return;
+                }
+                parent = current;
+                bit = GetBit(masked, nodeLength);
+                current = m_nodes[current].child[bit];
+                continue;
+            }
+            // the prefix of the current node is not a prefix of the new one:
+            // insert the new prefix, or a branching node, above the current node
+            uint8_t currentBit = GetBit(m_nodes[current].key, common);
+            uint32_t inner = NewNode(Mask(masked, common), common);
+            if (common == length)
+            {
+                m_nodes[inner].values.push_back(value);
+                m_nPrefixes++;
+            }
+            else
+            {
+                uint32_t leaf = NewNode(masked, length);
+                m_nodes[leaf].values.push_back(value);
+                m_nPrefixes++;
+                Link(inner, 1 - currentBit, leaf);
+            }
+            Link(inner, currentBit, current);
+            Link(parent, bit, inner);
+            return;
+        }
+        uint32_t leaf = NewNode(masked, length);
+        m_nodes[leaf].values.push_back(value);
+        m_nPrefixes++;
+        Link(parent, bit, leaf);
+    }
+
+    /**
+     * Remove the first occurrence of a value from a prefix.
+     * \param key the prefix key (bits beyond the length are ignored)
+     * \param length the prefix length, in bits
+     * \param value the value
+     * \return true if the value has been found and removed
+     */
+    bool Remove(const Key& key, uint16_t length, const T& value)
+    {
+        return RemoveIf(key, length, [&value](const T& v) { return v == value; });
+    }
+
+    /**
+     * Remove the first value of a prefix satisfying a predicate.
+     * \tparam P the predicate type
+     * \param key the prefix key (bits beyond the length are ignored)
+     * \param length the prefix length, in bits
+     * \param pred the predicate
+     * \return true if a value has been found and removed
+     */
+    template <typename P>
+    bool RemoveIf(const Key& key, uint16_t length, P pred)
+    {
+        uint32_t index = FindNode(key, length);
+        if (index == NONE)
+        {
+            return false;
+        }
+        std::vector<T>& values = m_nodes[index].values;
+        auto it = std::find_if(values.begin(), values.end(), pred);
+        if (it == values.end())
+        {
+            return false;
+        }
+        values.erase(it);
+        if (values.empty())
+        {
+            m_nPrefixes--;
+            Prune(index);
+        }
+        return true;
+    }
+
+    /**
+     * \param key the prefix key (bits beyond the length are ignored)
+     * \param length the prefix length, in bits
+     * \return the values associated with the prefix, or nullptr if none
+     */
+    const std::vector<T>* Find(const Key& key, uint16_t length) const
+    {
+        uint32_t index = FindNode(key, length);
+        if (index == NONE || m_nodes[index].values.empty())
+        {
+            return nullptr;
+        }
+        return &m_nodes[index].values;
+    }
+
+    /**
+     * Visit the prefixes matching a key, from the longest to the shortest.
+     *
+     * The visitor is called as f(length, values), where values are the
+     * values of the prefix in insertion order, and returns true to stop the
+     * enumeration.
+     *
+     * \tparam F the visitor type
+     * \param key the key to match
+     * \param f the visitor
+     */
+    template <typename F>
+    void Match(const Key& key, F f) const
+    {
+        uint32_t matches[KEY_BITS + 1];
+        std::size_t nMatches = 0;
+        uint32_t current = m_root;
+        while (current != NONE)
+        {
+            const Node& node = m_nodes[current];
+            if (CommonLength(node.key, key, node.length) != node.length)
+            {
+                break;
+            }
+            if (!node.values.empty())
+            {
+                matches[nMatches++] = current;
+            }
+            if (node.length == KEY_BITS)
+            {
+                break;
+            }
+            current = node.child[GetBit(key, node.length)];
+        }
+        while (nMatches > 0)
+        {
+            const Node& node = m_nodes[matches[--nMatches]];
+            if (f(node.length, node.values))
+            {
+                return;
+            }
+        }
+    }
+
+    /// Remove all the prefixes.
+    void Clear()
+    {
+        m_nodes.clear();
+        m_free.clear();
+        m_root = NONE;
+        m_nPrefixes = 0;
+    }
+
+    /// \return the number of prefixes having at least one value
+    std::size_t GetNPrefixes() const
+    {
+        return m_nPrefixes;
+    }
+
+  private:
+    /// Index of no node
+    static constexpr uint32_t NONE = 0xffffffff;
+
+    /// Trie node
+    struct Node
+    {
+        Key key;               //!< the prefix, with the bits beyond the length cleared
+        uint16_t length;       //!< the prefix length
+        uint32_t parent;       //!< index of the parent node
+        uint32_t child[2];     //!< indexes of the children, by value of the next bit
+        std::vector<T> values; //!< the values (empty for branching nodes)
+    };
+
+    /**
+     * \param key a key
+     * \param bit the bit index, from the most significant bit of the first byte
+     * \return the value of the bit
+     */
+    static uint8_t GetBit(const Key& key, uint16_t bit)
+    {
+        return (key[bit / 8] >> (7 - bit % 8)) & 1;
+    }
+
+    /**
+     * \param key a key
+     * \param length a length, in bits
+     * \return the key with the bits beyond the length cleared
+     */
+    static Key Mask(Key key, uint16_t length)
+    {
+        for (std::size_t i = length / 8; i < N; i++)
+        {
+            uint16_t keep = (i == length / 8) ? length % 8 : 0;
+            key[i] &= static_cast<uint8_t>(0xff00 >> keep);
+        }
+        return key;
+    }
+
+    /**
+     * \param a a key
+     * \param b another key
+     * \param max the maximum length to compare, in bits
+     * \return the length of the common prefix of the keys, up to max
+     */
+    static uint16_t CommonLength(const Key& a, const Key& b, uint16_t max)
+    {
+        for (std::size_t i = 0; i * 8 < max; i++)
+        {
+            uint8_t diff = a[i] ^ b[i];
+            if (diff != 0)
+            {
+                return std::min<uint16_t>(i * 8 + std::countl_zero(diff), max);
+            }
+        }
+        return max;
+    }
+
+    /**
+     * \param key a key
+     * \param length a length, in bits
+     * \return the index of the node of the prefix, or NONE
+     */
+    uint32_t FindNode(const Key& key, uint16_t length) const
+    {
+        Key masked = Mask(key, length);
+        uint32_t current = m_root;
+        while (current != NONE)
+        {
+            const Node& node = m_nodes[current];
+            if (node.length > length || CommonLength(node.key, masked, node.length) != node.length)
+            {
+                return NONE;
+            }
+            if (node.length == length)
+            {
+                return current;
+            }
+            current = node.child[GetBit(masked, node.length)];
+        }
+        return NONE;
+    }
+
+    /**
+     * Allocate a node without children nor values.
+     * \param key the prefix key, already masked
+     * \param length the prefix length
+     * \return the index of the node
+     */
+    uint32_t NewNode(const Key& key, uint16_t length)
+    {
+        uint32_t index;
+        if (!m_free.empty())
+        {
+            index = m_free.back();
+            m_free.pop_back();
+        }
+        else
+        {
+            index = m_nodes.size();
+            m_nodes.emplace_back();
+        }
+        Node& node = m_nodes[index];
+        node.key = key;
+        node.length = length;
+        node.parent = NONE;
+        node.child[0] = NONE;
+        node.child[1] = NONE;
+        return index;
+    }
+
+    /**
+     * Make a node the child of another node (or the root).
+     * \param parent the index of the parent node, or NONE for the root
+     * \param bit the child slot of the parent
+     * \param child the index of the child node, or NONE
+     */
+    void Link(uint32_t parent, uint8_t bit, uint32_t child)
+    {
+        if (parent == NONE)
+        {
+            m_root = child;
+        }
+        else
+        {
+            m_nodes[parent].child[bit] = child;
+        }
+        if (child != NONE)
+        {
+            m_nodes[child].parent = parent;
+        }
+    }
+
+    /**
+     * Remove the nodes which became useless after the values of a node
+     * have been removed.
+     * \param index the index of the node whose values have been removed
+     */
+    void Prune(uint32_t index)
+    {
+        while (index != NONE)
+        {
+            Node& node = m_nodes[index];
+            if (!node.values.empty() || (node.child[0] != NONE && node.child[1] != NONE))
+            {
+                return;
+            }
+            uint32_t child = (node.child[0] != NONE) ? node.child[0] : node.child[1];
+            uint32_t parent = node.parent;
+            uint8_t bit = (parent != NONE && m_nodes[parent].child[1] == index) ? 1 : 0;
+            Link(parent, bit, child);
+            node.values.shrink_to_fit();
+            m_free.push_back(index);
+            if (child != NONE)
+            {
+                return;
+            }
+            index = parent;
+        }
+    }
+
+    std::vector<Node> m_nodes;    //!< the nodes
+    std::vector<uint32_t> m_free; //!< indexes of the recycled nodes
+    uint32_t m_root;              //!< index of the root node
+    std::size_t m_nPrefixes;      //!< number of prefixes having values
+};
+
+} // namespace ns3
+
+#endif /* PREFIX_TRIE_H */
@@ -78,7 +78,8 @@ QueueDiscItem::QueueDiscItem(Ptr<Packet> p, const Address& addr, uint16_t protoc
     : QueueItem(p),
       m_address(addr),
       m_protocol(protocol),
-      m_txq(0)
+      m_txq(0),
+      m_fiveTupleState(FIVE_TUPLE_UNKNOWN)
 {
     NS_LOG_FUNCTION(this << p << addr << protocol);
 }
@@ -146,4 +147,23 @@ QueueDiscItem::Hash(uint32_t perturbation) const
     return 0;
 }
 
+const QueueDiscItem::FiveTuple*
+QueueDiscItem::GetFiveTuple() const
+{
+    NS_LOG_FUNCTION(this);
+    if (m_fiveTupleState == FIVE_TUPLE_UNKNOWN)
+    {
+        m_fiveTuple = FiveTuple();
+        m_fiveTupleState = ParseFiveTuple(m_fiveTuple) ? FIVE_TUPLE_VALID : FIVE_TUPLE_NONE;
+    }
+    return m_fiveTupleState == FIVE_TUPLE_VALID ? &m_fiveTuple : nullptr;
+}
+
+bool
+QueueDiscItem::ParseFiveTuple(FiveTuple& tuple) const
+{
+    NS_LOG_FUNCTION(this);
+    return false;
+}
+
 } // namespace ns3
@@ -217,11 +217,60 @@ class QueueDiscItem : public QueueItem
      */
     virtual uint32_t Hash(uint32_t perturbation = 0) const;
 
+    /**
+     * \brief The 5-tuple of a packet
+     *
+     * Addresses are stored in network byte order; IPv4 addresses only use the
+     * first 4 bytes and the remaining bytes are zero.
+     */
+    struct FiveTuple
+    {
+        uint8_t source[16];       //!< Source address
+        uint8_t destination[16];  //!< Destination address
+        uint8_t version;          //!< IP version (4 or 6)
+        uint8_t protocol;         //!< Transport protocol number
+        uint16_t sourcePort;      //!< Source port (0 if neither TCP nor UDP)
+        uint16_t destinationPort; //!< Destination port (0 if neither TCP nor UDP)
+    };
+
+    /**
+     * \brief Get the 5-tuple of the packet
+     *
+     * The packet headers are parsed (by calling ParseFiveTuple) the first time
+     * this method is called only, so that hashing the packet and classifying it
+     * through several packet filters do not parse the headers again.
+     *
+     * \return the 5-tuple of the packet, or a null pointer if the packet has none
+     */
+    const FiveTuple* GetFiveTuple() const;
+
+  protected:
+    /**
+     * \brief Parse the 5-tuple of the packet
+     *
+     * This method just returns false. Subclasses should parse the headers of
+     * their protocol type. The tuple is zero-initialized when this method is called.
+     *
+     * \param tuple the 5-tuple to fill
+     * \return true if the packet has a 5-tuple, false otherwise
+     */
+    virtual bool ParseFiveTuple(FiveTuple& tuple) const;
+
   private:
-    Address m_address;   //!< MAC destination address
-    uint16_t m_protocol; //!< L3 Protocol number
-    uint8_t m_txq;       //!< Transmission queue index
-    Time m_tstamp;       //!< timestamp when the packet was enqueued
+    /// State of the 5-tuple cache
+    enum FiveTupleState : uint8_t
+    {
+        FIVE_TUPLE_UNKNOWN = 0, //!< The headers have not been parsed yet
+        FIVE_TUPLE_NONE,        //!< The packet has no 5-tuple
+        FIVE_TUPLE_VALID        //!< m_fiveTuple holds the 5-tuple of the packet
+    };
+
+    Address m_address;                       //!< MAC destination address
+    uint16_t m_protocol;                     //!< L3 Protocol number
+    uint8_t m_txq;                           //!< Transmission queue index
+    mutable FiveTupleState m_fiveTupleState; //!< State of the 5-tuple cache
+    Time m_tstamp;                           //!< timestamp when the packet was enqueued
+    mutable FiveTuple m_fiveTuple;           //!< The 5-tuple, once parsed
 };
 
 } // namespace ns3
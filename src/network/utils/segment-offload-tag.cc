@@ -0,0 +1,113 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "segment-offload-tag.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SegmentOffloadTag");
+
+NS_OBJECT_ENSURE_REGISTERED(SegmentOffloadTag);
+
+TypeId
+SegmentOffloadTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::SegmentOffloadTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Network")
+                            .AddConstructor<SegmentOffloadTag>();
+    return tid;
+}
+
+TypeId
+SegmentOffloadTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+SegmentOffloadTag::GetSerializedSize() const
+{
+    NS_LOG_FUNCTION(this);
+    return 4;
+}
+
+void
+SegmentOffloadTag::Serialize(TagBuffer buf) const
+{
+    NS_LOG_FUNCTION(this << &buf);
+    buf.WriteU16(m_segments);
+    buf.WriteU16(m_headerSize);
+}
+
+void
+SegmentOffloadTag::Deserialize(TagBuffer buf)
+{
+    NS_LOG_FUNCTION(this << &buf);
+    m_segments = buf.ReadU16();
+    m_headerSize = buf.ReadU16();
+}
+
+void
+SegmentOffloadTag::Print(std::ostream& os) const
+{
+    NS_LOG_FUNCTION(this << &os);
+    os << "Segments=" << m_segments << " HeaderSize=" << m_headerSize;
+}
+
+SegmentOffloadTag::SegmentOffloadTag()
+    : Tag(),
+      m_segments(1),
+      m_headerSize(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SegmentOffloadTag::SegmentOffloadTag(uint16_t segments, uint16_t headerSize)
+    : Tag(),
+      m_segments(segments),
+      m_headerSize(headerSize)
+{
+    NS_LOG_FUNCTION(this << segments << headerSize);
+}
+
+uint16_t
+SegmentOffloadTag::GetSegments() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_segments;
+}
+
+uint16_t
+SegmentOffloadTag::GetHeaderSize() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_headerSize;
+}
+
+uint32_t
+SegmentOffloadTag::GetAdditionalBytes(uint32_t linkHeaderSize) const
+{
+    NS_LOG_FUNCTION(this << linkHeaderSize);
+    if (m_segments <= 1)
+    {
+        return 0;
+    }
+    return (m_segments - 1) * (m_headerSize + linkHeaderSize);
+}
+
+} // namespace ns3
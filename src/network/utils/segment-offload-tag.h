@@ -0,0 +1,90 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SEGMENT_OFFLOAD_TAG_H
+#define SEGMENT_OFFLOAD_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup network
+ *
+ * \brief Packet tag marking a super-segment sent with segmentation offload.
+ *
+ * A transport protocol using segmentation offload hands the devices a
+ * single packet standing for several segments, each of which would carry
+ * its own copy of the network and transport headers. The devices which
+ * support segmentation offload (see NetDevice::SupportsSegmentOffload)
+ * transmit such a packet in one go even if it is larger than their MTU,
+ * and account for the headers of the other segments in its transmission
+ * time, so that the link is occupied as long as by the segments.
+ *
+ * The transport protocol tags a super-segment with the size of its own
+ * header, and the network protocol adds the size of the header it builds.
+ */
+class SegmentOffloadTag : public Tag
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer buf) const override;
+    void Deserialize(TagBuffer buf) override;
+    void Print(std::ostream& os) const override;
+    SegmentOffloadTag();
+
+    /**
+     * Constructs a SegmentOffloadTag
+     *
+     * \param segments the number of segments the packet stands for
+     * \param headerSize the size of the headers repeated in each segment
+     */
+    SegmentOffloadTag(uint16_t segments, uint16_t headerSize);
+
+    /**
+     * \returns the number of segments the packet stands for
+     */
+    uint16_t GetSegments() const;
+
+    /**
+     * \returns the size of the network and transport headers repeated in
+     * each segment
+     */
+    uint16_t GetHeaderSize() const;
+
+    /**
+     * Get the number of bytes the segments would add to the packet on the
+     * wire, that is the headers of all the segments but the first one.
+     *
+     * \param linkHeaderSize the size of the link layer header and trailer
+     * of each frame
+     * \returns the number of additional bytes
+     */
+    uint32_t GetAdditionalBytes(uint32_t linkHeaderSize) const;
+
+  private:
+    uint16_t m_segments;   //!< the number of segments
+    uint16_t m_headerSize; //!< the size of the headers of each segment
+};
+
+} // namespace ns3
+
+#endif /* SEGMENT_OFFLOAD_TAG_H */
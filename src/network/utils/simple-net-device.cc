@@ -20,6 +20,7 @@
 
 #include "error-model.h"
 #include "queue.h"
+#include "segment-offload-tag.h"
 #include "simple-channel.h"
 
 #include "ns3/boolean.h"
@@ -433,7 +434,8 @@ SimpleNetDevice::SendFrom(Ptr<Packet> p,
                           uint16_t protocolNumber)
 {
     NS_LOG_FUNCTION(this << p << source << dest << protocolNumber);
-    if (p->GetSize() > GetMtu())
+    SegmentOffloadTag offloadTag;
+    if (p->GetSize() > GetMtu() && !p->PeekPacketTag(offloadTag))
     {
         return false;
     }
@@ -485,7 +487,14 @@ SimpleNetDevice::StartTransmission()
     Time txTime = Time(0);
     if (m_bps > DataRate(0))
     {
-        txTime = m_bps.CalculateBytesTxTime(packet->GetSize());
+        // A super-segment occupies the link as long as its segments
+        uint32_t size = packet->GetSize();
+        SegmentOffloadTag offloadTag;
+        if (packet->PeekPacketTag(offloadTag))
+        {
+            size += offloadTag.GetAdditionalBytes(0);
+        }
+        txTime = m_bps.CalculateBytesTxTime(size);
     }
     FinishTransmissionEvent =
         Simulator::Schedule(txTime, &SimpleNetDevice::FinishTransmission, this, packet);
@@ -565,4 +574,11 @@ SimpleNetDevice::SupportsSendFrom() const
     return true;
 }
 
+bool
+SimpleNetDevice::SupportsSegmentOffload() const
+{
+    NS_LOG_FUNCTION(this);
+    return true;
+}
+
 } // namespace ns3
@@ -137,6 +137,7 @@ class SimpleNetDevice : public NetDevice
 
     void SetPromiscReceiveCallback(PromiscReceiveCallback cb) override;
     bool SupportsSendFrom() const override;
+    bool SupportsSegmentOffload() const override;
 
   protected:
     void DoDispose() override;
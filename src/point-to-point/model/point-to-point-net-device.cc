@@ -24,8 +24,11 @@
 #include "ns3/llc-snap-header.h"
 #include "ns3/log.h"
 #include "ns3/mac48-address.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/packet-burst.h"
 #include "ns3/pointer.h"
 #include "ns3/queue.h"
+#include "ns3/segment-offload-tag.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
@@ -249,7 +252,14 @@ PointToPointNetDevice::TransmitStart(Ptr<Packet> p)
     m_currentPkt = p;
     m_phyTxBeginTrace(m_currentPkt);
 
-    Time txTime = m_bps.CalculateBytesTxTime(p->GetSize());
+    // A super-segment occupies the link as long as the frames of its segments
+    uint32_t size = p->GetSize();
+    SegmentOffloadTag offloadTag;
+    if (p->PeekPacketTag(offloadTag))
+    {
+        size += offloadTag.GetAdditionalBytes(PppHeader().GetSerializedSize());
+    }
+    Time txTime = m_bps.CalculateBytesTxTime(size);
     Time txCompleteTime = txTime + m_tInterframeGap;
 
     NS_LOG_LOGIC("Schedule TransmitCompleteEvent in " << txCompleteTime.As(Time::S));
@@ -559,6 +569,65 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
     return false;
 }
 
+uint32_t
+PointToPointNetDevice::SendBurst(Ptr<PacketBurst> burst,
+                                 const Address& dest,
+                                 uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(this << burst << dest << protocolNumber);
+    NS_LOG_LOGIC("burst of " << burst->GetNPackets() << " packets");
+
+    //
+    // The link state does not change while the burst is being queued, so
+    // check it once for all the packets.
+    //
+    if (!IsLinkUp())
+    {
+        for (auto it = burst->Begin(); it != burst->End(); ++it)
+        {
+            m_macTxDropTrace(*it);
+        }
+        return burst->GetNPackets();
+    }
+
+    //
+    // Stop taking the packets of the burst once the transmission queue is
+    // stopped; the caller drops the packets left (see NetDevice::SendBurst).
+    //
+    Ptr<NetDeviceQueueInterface> ndqi = GetObject<NetDeviceQueueInterface>();
+    uint32_t taken = 0;
+    for (auto it = burst->Begin(); it != burst->End(); ++it, ++taken)
+    {
+        if (ndqi && ndqi->GetTxQueue(0)->IsStopped())
+        {
+            break;
+        }
+        Ptr<Packet> packet = *it;
+        AddHeader(packet, protocolNumber);
+        m_macTxTrace(packet);
+
+        if (!m_queue->Enqueue(packet))
+        {
+            m_macTxDropTrace(packet);
+            continue;
+        }
+
+        //
+        // Start the transmitter as soon as the first packet is queued, so that
+        // the queue occupancy seen by the following packets is the same as if
+        // they had been sent one by one.
+        //
+        if (m_txMachineState == READY)
+        {
+            packet = m_queue->Dequeue();
+            m_snifferTrace(packet);
+            m_promiscSnifferTrace(packet);
+            TransmitStart(packet);
+        }
+    }
+    return taken;
+}
+
 bool
 PointToPointNetDevice::SendFrom(Ptr<Packet> packet,
                                 const Address& source,
@@ -608,6 +677,13 @@ PointToPointNetDevice::SupportsSendFrom() const
     return false;
 }
 
+bool
+PointToPointNetDevice::SupportsSegmentOffload() const
+{
+    NS_LOG_FUNCTION(this);
+    return true;
+}
+
 void
 PointToPointNetDevice::DoMpiReceive(Ptr<Packet> p)
 {
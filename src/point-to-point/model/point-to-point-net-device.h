@@ -185,6 +185,9 @@ class PointToPointNetDevice : public NetDevice
                   const Address& source,
                   const Address& dest,
                   uint16_t protocolNumber) override;
+    uint32_t SendBurst(Ptr<PacketBurst> burst,
+                       const Address& dest,
+                       uint16_t protocolNumber) override;
 
     Ptr<Node> GetNode() const override;
     void SetNode(Ptr<Node> node) override;
@@ -197,6 +200,7 @@ class PointToPointNetDevice : public NetDevice
 
     void SetPromiscReceiveCallback(PromiscReceiveCallback cb) override;
     bool SupportsSendFrom() const override;
+    bool SupportsSegmentOffload() const override;
 
   protected:
     /**
@@ -19,12 +19,15 @@
 
 #include "ns3/drop-tail-queue.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/packet-burst.h"
 #include "ns3/point-to-point-channel.h"
 #include "ns3/point-to-point-net-device.h"
+#include "ns3/queue-size.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -139,6 +142,161 @@ PointToPointTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \brief Test class for PointToPointNetDevice::SendBurst
+ *
+ * It sends a burst of packets larger than the device queue and checks
+ * that the same packets are accepted, dropped and received as when they
+ * are sent one by one.
+ */
+class PointToPointBurstTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointBurstTest();
+
+    /**
+     * \brief Run the test
+     */
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Send packets to the device specified
+     *
+     * \param device NetDevice to send to.
+     * \param nPackets number of packets to send
+     * \param burst whether to send the packets as a single burst
+     */
+    void SendPackets(Ptr<PointToPointNetDevice> device, uint32_t nPackets, bool burst);
+    /**
+     * \brief Callback function counting the received packets
+     *
+     * \param dev The receiving device.
+     * \param pkt The received packet.
+     * \param mode The protocol mode used.
+     * \param sender The sender address.
+     *
+     * \return A boolean indicating packet handled properly.
+     */
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+    /**
+     * \brief Run a simulation sending a number of packets
+     *
+     * \param nPackets number of packets to send
+     * \param burst whether to send the packets as a single burst
+     */
+    void RunOne(uint32_t nPackets, bool burst);
+
+    uint32_t m_accepted;             //!< number of packets accepted by the device
+    std::vector<uint32_t> m_rxSizes; //!< sizes of the received packets
+    uint32_t m_drops;                //!< number of MacTxDrop events
+};
+
+PointToPointBurstTest::PointToPointBurstTest()
+    : TestCase("PointToPoint burst send")
+{
+}
+
+void
+PointToPointBurstTest::SendPackets(Ptr<PointToPointNetDevice> device,
+                                   uint32_t nPackets,
+                                   bool burst)
+{
+    Ptr<PacketBurst> packets = CreateObject<PacketBurst>();
+    for (uint32_t i = 0; i < nPackets; i++)
+    {
+        packets->AddPacket(Create<Packet>(100 + i));
+    }
+    if (burst)
+    {
+        uint32_t taken = device->SendBurst(packets, device->GetBroadcast(), 0x800);
+        NS_TEST_EXPECT_MSG_EQ(taken, nPackets, "A device without flow control takes every packet");
+        m_accepted = taken - m_drops;
+        return;
+    }
+    m_accepted = 0;
+    for (auto it = packets->Begin(); it != packets->End(); ++it)
+    {
+        if (device->Send(*it, device->GetBroadcast(), 0x800))
+        {
+            m_accepted++;
+        }
+    }
+}
+
+bool
+PointToPointBurstTest::RxPacket(Ptr<NetDevice> dev,
+                                Ptr<const Packet> pkt,
+                                uint16_t mode,
+                                const Address& sender)
+{
+    m_rxSizes.push_back(pkt->GetSize());
+    return true;
+}
+
+void
+PointToPointBurstTest::RunOne(uint32_t nPackets, bool burst)
+{
+    m_accepted = 0;
+    m_drops = 0;
+    m_rxSizes.clear();
+
+    Ptr<Node> a = CreateObject<Node>();
+    Ptr<Node> b = CreateObject<Node>();
+    Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice>();
+    Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel>();
+
+    Ptr<DropTailQueue<Packet>> queue = CreateObject<DropTailQueue<Packet>>();
+    queue->SetMaxSize(QueueSize("5p"));
+    devA->Attach(channel);
+    devA->SetAddress(Mac48Address::Allocate());
+    devA->SetQueue(queue);
+    devB->Attach(channel);
+    devB->SetAddress(Mac48Address::Allocate());
+    devB->SetQueue(CreateObject<DropTailQueue<Packet>>());
+
+    a->AddDevice(devA);
+    b->AddDevice(devB);
+
+    devB->SetReceiveCallback(MakeCallback(&PointToPointBurstTest::RxPacket, this));
+    devA->TraceConnectWithoutContext(
+        "MacTxDrop",
+        Callback<void, Ptr<const Packet>>([this](Ptr<const Packet>) { m_drops++; }));
+
+    Simulator::Schedule(Seconds(1.0),
+                        &PointToPointBurstTest::SendPackets,
+                        this,
+                        devA,
+                        nPackets,
+                        burst);
+
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+void
+PointToPointBurstTest::DoRun()
+{
+    RunOne(10, false);
+    uint32_t accepted = m_accepted;
+    uint32_t drops = m_drops;
+    std::vector<uint32_t> rxSizes = m_rxSizes;
+
+    RunOne(10, true);
+    // one packet is being transmitted and five are queued
+    NS_TEST_EXPECT_MSG_EQ(m_accepted, 6, "Unexpected number of accepted packets");
+    NS_TEST_EXPECT_MSG_EQ(m_drops, 4, "Unexpected number of dropped packets");
+    NS_TEST_EXPECT_MSG_EQ(m_accepted, accepted, "Burst and single sends accept different packets");
+    NS_TEST_EXPECT_MSG_EQ(m_drops, drops, "Burst and single sends drop different packets");
+    NS_TEST_EXPECT_MSG_EQ((m_rxSizes == rxSizes),
+                          true,
+                          "Burst and single sends deliver different packets");
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -155,6 +313,7 @@ PointToPointTestSuite::PointToPointTestSuite()
     : TestSuite("devices-point-to-point", Type::UNIT)
 {
     AddTestCase(new PointToPointTest, TestCase::Duration::QUICK);
+    AddTestCase(new PointToPointBurstTest, TestCase::Duration::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -34,6 +34,9 @@
 #include "ns3/test.h"
 #include "ns3/udp-header.h"
 
+#include <sstream>
+#include <vector>
+
 using namespace ns3;
 
 /// Variable to assign g_hash to a new packet's flow
@@ -1756,6 +1759,147 @@ FqCoDelQueueDiscL4sMode::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup system-tests-tc
+ *
+ * \brief This class tests that the lightweight flows behave as the flow queues
+ * with a CoDel queue disc each: the same traffic, which makes the flow queues
+ * drop, mark and overflow, is sent through a queue disc of each kind and the
+ * dequeued packets and the statistics must be the same.
+ */
+class FqCoDelQueueDiscLightweightFlows : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param useEcn whether ECN is used (along with a CE threshold)
+     * \param useL4s whether L4S is used
+     * \param setAssociativeHash whether set associative hash is used
+     */
+    FqCoDelQueueDiscLightweightFlows(bool useEcn, bool useL4s, bool setAssociativeHash);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Send the traffic through a queue disc.
+     * \param lightweight whether the queue disc uses lightweight flows
+     * \param dequeued the identification of the dequeued packets
+     * \return the statistics of the queue disc
+     */
+    QueueDisc::Stats RunScenario(bool lightweight, std::vector<uint16_t>& dequeued);
+
+    bool m_useEcn;             //!< Whether ECN is used
+    bool m_useL4s;             //!< Whether L4S is used
+    bool m_setAssociativeHash; //!< Whether set associative hash is used
+};
+
+FqCoDelQueueDiscLightweightFlows::FqCoDelQueueDiscLightweightFlows(bool useEcn,
+                                                                   bool useL4s,
+                                                                   bool setAssociativeHash)
+    : TestCase(std::string("Test lightweight flows") + (useEcn ? " with ECN" : "") +
+               (useL4s ? " with L4S" : "") +
+               (setAssociativeHash ? " with set associative hash" : "")),
+      m_useEcn(useEcn),
+      m_useL4s(useL4s),
+      m_setAssociativeHash(setAssociativeHash)
+{
+}
+
+QueueDisc::Stats
+FqCoDelQueueDiscLightweightFlows::RunScenario(bool lightweight, std::vector<uint16_t>& dequeued)
+{
+    Ptr<FqCoDelQueueDisc> queueDisc = CreateObjectWithAttributes<FqCoDelQueueDisc>(
+        "MaxSize",
+        StringValue("400p"),
+        "Flows",
+        UintegerValue(64),
+        "UseEcn",
+        BooleanValue(m_useEcn),
+        "UseL4s",
+        BooleanValue(m_useL4s),
+        "CeThreshold",
+        TimeValue(m_useEcn || m_useL4s ? MilliSeconds(2) : Time::Max()),
+        "EnableSetAssociativeHash",
+        BooleanValue(m_setAssociativeHash),
+        "LightweightFlows",
+        BooleanValue(lightweight));
+    queueDisc->SetQuantum(1514);
+    queueDisc->Initialize();
+
+    // every half millisecond, three packets of random size are sent by random
+    // flows among 40 and two packets are dequeued, until the queue disc is drained
+    uint32_t random = 1;
+    uint16_t id = 0;
+    auto step = [&]() {
+        for (uint32_t i = 0; i < 3 && Simulator::Now() < Seconds(1); i++)
+        {
+            random = random * 1103515245 + 12345;
+            uint32_t flow = (random >> 16) % 40;
+            Ipv4Header hdr;
+            hdr.SetPayloadSize(100 + (random >> 8) % 1400);
+            hdr.SetSource(Ipv4Address("10.10.1.1"));
+            hdr.SetDestination(Ipv4Address(Ipv4Address("10.10.2.0").Get() + flow));
+            hdr.SetProtocol(7);
+            hdr.SetIdentification(id++);
+            hdr.SetEcn(flow % 4 == 0   ? Ipv4Header::ECN_NotECT
+                       : flow % 4 == 2 ? Ipv4Header::ECN_ECT1
+                                       : Ipv4Header::ECN_ECT0);
+            Ptr<Packet> p = Create<Packet>(hdr.GetPayloadSize());
+            queueDisc->Enqueue(Create<Ipv4QueueDiscItem>(p, Address(), 0, hdr));
+        }
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            Ptr<QueueDiscItem> item = queueDisc->Dequeue();
+            if (item)
+            {
+                dequeued.push_back(DynamicCast<Ipv4QueueDiscItem>(item)
+                                       ->GetHeader()
+                                       .GetIdentification());
+            }
+        }
+    };
+    for (uint32_t i = 0; i < 3000; i++)
+    {
+        Simulator::Schedule(MicroSeconds(500 * i), step);
+    }
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(queueDisc->GetNPackets(), 0, "The queue disc should be drained");
+    QueueDisc::Stats stats = queueDisc->GetStats();
+    Simulator::Destroy();
+    return stats;
+}
+
+void
+FqCoDelQueueDiscLightweightFlows::DoRun()
+{
+    std::vector<uint16_t> dequeued;
+    QueueDisc::Stats stats = RunScenario(false, dequeued);
+    std::vector<uint16_t> lightweightDequeued;
+    QueueDisc::Stats lightweightStats = RunScenario(true, lightweightDequeued);
+
+    NS_TEST_EXPECT_MSG_GT(stats.nTotalDroppedPacketsAfterDequeue,
+                          0,
+                          "The traffic should make the flow queues drop packets");
+    NS_TEST_ASSERT_MSG_EQ(lightweightDequeued.size(),
+                          dequeued.size(),
+                          "Unexpected number of packets dequeued from the lightweight flows");
+    for (std::size_t i = 0; i < dequeued.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(lightweightDequeued[i],
+                              dequeued[i],
+                              "Unexpected packet dequeued from the lightweight flows");
+    }
+    std::ostringstream expected;
+    std::ostringstream actual;
+    expected << stats;
+    actual << lightweightStats;
+    NS_TEST_EXPECT_MSG_EQ(actual.str(),
+                          expected.str(),
+                          "Unexpected statistics of the queue disc with lightweight flows");
+}
+
 /**
  * \ingroup system-tests-tc
  *
@@ -1778,6 +1922,14 @@ FqCoDelQueueDiscTestSuite::FqCoDelQueueDiscTestSuite()
     AddTestCase(new FqCoDelQueueDiscECNMarking, TestCase::Duration::QUICK);
     AddTestCase(new FqCoDelQueueDiscSetLinearProbing, TestCase::Duration::QUICK);
     AddTestCase(new FqCoDelQueueDiscL4sMode, TestCase::Duration::QUICK);
+    AddTestCase(new FqCoDelQueueDiscLightweightFlows(false, false, false),
+                TestCase::Duration::QUICK);
+    AddTestCase(new FqCoDelQueueDiscLightweightFlows(true, false, false),
+                TestCase::Duration::QUICK);
+    AddTestCase(new FqCoDelQueueDiscLightweightFlows(false, true, false),
+                TestCase::Duration::QUICK);
+    AddTestCase(new FqCoDelQueueDiscLightweightFlows(false, false, true),
+                TestCase::Duration::QUICK);
 }
 
 /// Do not forget to allocate an instance of this TestSuite.
@@ -43,6 +43,13 @@ NS_LOG_COMPONENT_DEFINE("CobaltQueueDisc");
 
 NS_OBJECT_ENSURE_REGISTERED(CobaltQueueDisc);
 
+const QueueDisc::ReasonId CobaltQueueDisc::TARGET_EXCEEDED_DROP_ID =
+    RegisterReason(TARGET_EXCEEDED_DROP);
+const QueueDisc::ReasonId CobaltQueueDisc::OVERLIMIT_DROP_ID = RegisterReason(OVERLIMIT_DROP);
+const QueueDisc::ReasonId CobaltQueueDisc::FORCED_MARK_ID = RegisterReason(FORCED_MARK);
+const QueueDisc::ReasonId CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK_ID =
+    RegisterReason(CE_THRESHOLD_EXCEEDED_MARK);
+
 TypeId
 CobaltQueueDisc::GetTypeId()
 {
@@ -339,7 +346,7 @@ CobaltQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         int64_t now = CoDelGetTime();
         // Call this to update Blue's drop probability
         CobaltQueueFull(now);
-        DropBeforeEnqueue(item, OVERLIMIT_DROP);
+        DropBeforeEnqueue(item, OVERLIMIT_DROP_ID);
         return false;
     }
 
@@ -385,7 +392,7 @@ CobaltQueueDisc::DoDequeue()
 
         if (drop)
         {
-            DropAfterDequeue(item, TARGET_EXCEEDED_DROP);
+            DropAfterDequeue(item, TARGET_EXCEEDED_DROP_ID);
         }
         else
         {
@@ -468,7 +475,7 @@ CobaltQueueDisc::CobaltShouldDrop(Ptr<QueueDiscItem> item, int64_t now)
                 NS_LOG_DEBUG("CE packet " << static_cast<uint16_t>(tosByte & 0x3));
             }
             if (CoDelTimeAfter(sojournTime, Time2CoDel(m_ceThreshold)) &&
-                Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
+                Mark(item, CE_THRESHOLD_EXCEEDED_MARK_ID))
             {
                 NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
             }
@@ -498,7 +505,7 @@ CobaltQueueDisc::CobaltShouldDrop(Ptr<QueueDiscItem> item, int64_t now)
         /* Check for marking possibility only if BLUE decides NOT to drop. */
         /* Check if router and packet, both have ECN enabled. Only if this is true, mark the packet.
          */
-        isMarked = (m_useEcn && Mark(item, FORCED_MARK));
+        isMarked = (m_useEcn && Mark(item, FORCED_MARK_ID));
         drop = !isMarked;
 
         m_count = std::max(m_count, m_count + 1);
@@ -524,7 +531,7 @@ CobaltQueueDisc::CobaltShouldDrop(Ptr<QueueDiscItem> item, int64_t now)
     // suppressed. If UseL4S attribute is enabled then ECT0 packets should not be marked.
     if (!isMarked && !m_useL4s && m_useEcn &&
         CoDelTimeAfter(sojournTime, Time2CoDel(m_ceThreshold)) &&
-        Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
+        Mark(item, CE_THRESHOLD_EXCEEDED_MARK_ID))
     {
         NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
     }
@@ -108,6 +108,11 @@ class CobaltQueueDisc : public QueueDisc
         "forcedMark"; //!< forced marks by Codel on ECN-enabled
     static constexpr const char* CE_THRESHOLD_EXCEEDED_MARK =
         "CE threshold exceeded mark"; //!< Sojourn time above CE threshold
+    // Identifiers of the reasons, interned once for this queue disc type
+    static const ReasonId TARGET_EXCEEDED_DROP_ID;       //!< Interned TARGET_EXCEEDED_DROP
+    static const ReasonId OVERLIMIT_DROP_ID;             //!< Interned OVERLIMIT_DROP
+    static const ReasonId FORCED_MARK_ID;                //!< Interned FORCED_MARK
+    static const ReasonId CE_THRESHOLD_EXCEEDED_MARK_ID; //!< Interned CE_THRESHOLD_EXCEEDED_MARK
 
     /**
      * \brief Get the drop probability of Blue
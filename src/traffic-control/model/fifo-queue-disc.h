@@ -51,6 +51,8 @@ class FifoQueueDisc : public QueueDisc
     // Reasons for dropping packets
     static constexpr const char* LIMIT_EXCEEDED_DROP =
         "Queue disc limit exceeded"; //!< Packet dropped due to queue disc limit exceeded
+    // Identifiers of the reasons, interned once for this queue disc type
+    static const ReasonId LIMIT_EXCEEDED_DROP_ID; //!< Interned LIMIT_EXCEEDED_DROP
 
   private:
     bool DoEnqueue(Ptr<QueueDiscItem> item) override;
@@ -113,6 +113,10 @@ FqCobaltFlow::GetIndex() const
 
 NS_OBJECT_ENSURE_REGISTERED(FqCobaltQueueDisc);
 
+const QueueDisc::ReasonId FqCobaltQueueDisc::UNCLASSIFIED_DROP_ID =
+    RegisterReason(UNCLASSIFIED_DROP);
+const QueueDisc::ReasonId FqCobaltQueueDisc::OVERLIMIT_DROP_ID = RegisterReason(OVERLIMIT_DROP);
+
 TypeId
 FqCobaltQueueDisc::GetTypeId()
 {
@@ -278,7 +282,7 @@ FqCobaltQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         else
         {
             NS_LOG_ERROR("No filter has been able to classify this packet, drop it.");
-            DropBeforeEnqueue(item, UNCLASSIFIED_DROP);
+            DropBeforeEnqueue(item, UNCLASSIFIED_DROP_ID);
             return false;
         }
     }
@@ -526,7 +530,7 @@ FqCobaltQueueDisc::FqCobaltDrop()
         NS_LOG_DEBUG("Drop packet (overflow); count: " << count << " len: " << len
                                                        << " threshold: " << threshold);
         item = qd->GetInternalQueue(0)->Dequeue();
-        DropAfterDequeue(item, OVERLIMIT_DROP);
+        DropAfterDequeue(item, OVERLIMIT_DROP_ID);
         len += item->GetSize();
     } while (++count < m_dropBatchSize && len < threshold);
 
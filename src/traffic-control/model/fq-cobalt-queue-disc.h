@@ -152,6 +152,9 @@ class FqCobaltQueueDisc : public QueueDisc
     static constexpr const char* UNCLASSIFIED_DROP =
         "Unclassified drop"; //!< No packet filter able to classify packet
     static constexpr const char* OVERLIMIT_DROP = "Overlimit drop"; //!< Overlimit dropped packets
+    // Identifiers of the reasons, interned once for this queue disc type
+    static const ReasonId UNCLASSIFIED_DROP_ID; //!< Interned UNCLASSIFIED_DROP
+    static const ReasonId OVERLIMIT_DROP_ID;    //!< Interned OVERLIMIT_DROP
 
   private:
     bool DoEnqueue(Ptr<QueueDiscItem> item) override;
@@ -26,6 +26,7 @@
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/queue.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 
 namespace ns3
 {
@@ -107,6 +108,21 @@ FqCoDelFlow::GetIndex() const
 
 NS_OBJECT_ENSURE_REGISTERED(FqCoDelQueueDisc);
 
+const QueueDisc::ReasonId FqCoDelQueueDisc::UNCLASSIFIED_DROP_ID =
+    RegisterReason(UNCLASSIFIED_DROP);
+const QueueDisc::ReasonId FqCoDelQueueDisc::OVERLIMIT_DROP_ID = RegisterReason(OVERLIMIT_DROP);
+
+// The lightweight flows drop and mark packets for the same reasons as the CoDel
+// queue discs of the flows, as seen by their parent
+static const QueueDisc::ReasonId CHILD_OVERLIMIT_DROP_ID = QueueDisc::RegisterReason(
+    std::string(QueueDisc::CHILD_QUEUE_DISC_DROP) + CoDelQueueDisc::OVERLIMIT_DROP);
+static const QueueDisc::ReasonId CHILD_TARGET_EXCEEDED_DROP_ID = QueueDisc::RegisterReason(
+    std::string(QueueDisc::CHILD_QUEUE_DISC_DROP) + CoDelQueueDisc::TARGET_EXCEEDED_DROP);
+static const QueueDisc::ReasonId CHILD_TARGET_EXCEEDED_MARK_ID = QueueDisc::RegisterReason(
+    std::string(QueueDisc::CHILD_QUEUE_DISC_MARK) + CoDelQueueDisc::TARGET_EXCEEDED_MARK);
+static const QueueDisc::ReasonId CHILD_CE_THRESHOLD_EXCEEDED_MARK_ID = QueueDisc::RegisterReason(
+    std::string(QueueDisc::CHILD_QUEUE_DISC_MARK) + CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK);
+
 TypeId
 FqCoDelQueueDisc::GetTypeId()
 {
@@ -170,13 +186,24 @@ FqCoDelQueueDisc::GetTypeId()
                           "True to use L4S (only ECT1 packets are marked at CE threshold)",
                           BooleanValue(false),
                           MakeBooleanAccessor(&FqCoDelQueueDisc::m_useL4s),
+                          MakeBooleanChecker())
+            .AddAttribute("LightweightFlows",
+                          "True to store the flow queues in plain structs rather than as "
+                          "classes with a CoDel queue disc each",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FqCoDelQueueDisc::m_lightweightFlows),
                           MakeBooleanChecker());
     return tid;
 }
 
 FqCoDelQueueDisc::FqCoDelQueueDisc()
     : QueueDisc(QueueDiscSizePolicy::MULTIPLE_QUEUES, QueueSizeUnit::PACKETS),
-      m_quantum(0)
+      m_quantum(0),
+      m_freePacket(NONE),
+      m_minBytes(0),
+      m_codelInterval(0),
+      m_codelTarget(0),
+      m_codelCeThreshold(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -186,6 +213,19 @@ FqCoDelQueueDisc::~FqCoDelQueueDisc()
     NS_LOG_FUNCTION(this);
 }
 
+void
+FqCoDelQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_flowTable.clear();
+    m_flowSlots.clear();
+    m_packets.clear();
+    m_freePacket = NONE;
+    m_newFlowList = FlowList();
+    m_oldFlowList = FlowList();
+    QueueDisc::DoDispose();
+}
+
 void
 FqCoDelQueueDisc::SetQuantum(uint32_t quantum)
 {
@@ -210,6 +250,23 @@ FqCoDelQueueDisc::SetAssociativeHash(uint32_t flowHash)
 
     for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
     {
+        if (m_lightweightFlows)
+        {
+            // the tag of a flow queue that has not been created yet is set
+            // when the flow queue is created
+            uint32_t slot = m_flowSlots[i];
+            if (slot == NONE || m_flowTable[slot].tag == flowHash ||
+                m_flowTable[slot].status == FqCoDelFlow::INACTIVE)
+            {
+                if (slot != NONE)
+                {
+                    m_flowTable[slot].tag = flowHash;
+                }
+                return i;
+            }
+            continue;
+        }
+
         auto it = m_flowsIndices.find(i);
 
         if (it == m_flowsIndices.end() ||
@@ -225,7 +282,14 @@ FqCoDelQueueDisc::SetAssociativeHash(uint32_t flowHash)
     }
 
     // all the queues of the set are used. Use the first queue of the set
-    m_tags[outerHash] = flowHash;
+    if (m_lightweightFlows)
+    {
+        m_flowTable[m_flowSlots[outerHash]].tag = flowHash;
+    }
+    else
+    {
+        m_tags[outerHash] = flowHash;
+    }
     return outerHash;
 }
 
@@ -252,7 +316,7 @@ FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         else
         {
             NS_LOG_ERROR("No filter has been able to classify this packet, drop it.");
-            DropBeforeEnqueue(item, UNCLASSIFIED_DROP);
+            DropBeforeEnqueue(item, UNCLASSIFIED_DROP_ID);
             return false;
         }
     }
@@ -266,6 +330,18 @@ FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         h = flowHash % m_flows;
     }
 
+    if (m_lightweightFlows)
+    {
+        LightweightEnqueue(item, h, flowHash);
+
+        if (GetCurrentSize() > GetMaxSize())
+        {
+            NS_LOG_DEBUG("Overload; enter LightweightDrop ()");
+            LightweightDrop();
+        }
+        return true;
+    }
+
     Ptr<FqCoDelFlow> flow;
     if (m_flowsIndices.find(h) == m_flowsIndices.end())
     {
@@ -317,6 +393,11 @@ FqCoDelQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
+    if (m_lightweightFlows)
+    {
+        return LightweightDequeue();
+    }
+
     Ptr<FqCoDelFlow> flow;
     Ptr<QueueDiscItem> item;
 
@@ -459,6 +540,20 @@ FqCoDelQueueDisc::InitializeParams()
     m_queueDiscFactory.Set("MaxSize", QueueSizeValue(GetMaxSize()));
     m_queueDiscFactory.Set("Interval", StringValue(m_interval));
     m_queueDiscFactory.Set("Target", StringValue(m_target));
+
+    if (m_lightweightFlows)
+    {
+        // the CoDel instances of the flows have the parameters of the CoDel
+        // queue discs that the factory creates for the flows otherwise
+        Ptr<CoDelQueueDisc> codel = m_queueDiscFactory.Create<CoDelQueueDisc>();
+        UintegerValue minBytes;
+        codel->GetAttribute("MinBytes", minBytes);
+        m_minBytes = minBytes.Get();
+        m_codelInterval = CoDelQueueDisc::Time2CoDel(codel->GetInterval());
+        m_codelTarget = CoDelQueueDisc::Time2CoDel(codel->GetTarget());
+        m_codelCeThreshold = CoDelQueueDisc::Time2CoDel(m_ceThreshold);
+        m_flowSlots.assign(m_flows, NONE);
+    }
 }
 
 uint32_t
@@ -494,11 +589,422 @@ FqCoDelQueueDisc::FqCoDelDrop()
         NS_LOG_DEBUG("Drop packet (overflow); count: " << count << " len: " << len
                                                        << " threshold: " << threshold);
         item = qd->GetInternalQueue(0)->Dequeue();
-        DropAfterDequeue(item, OVERLIMIT_DROP);
+        DropAfterDequeue(item, OVERLIMIT_DROP_ID);
+        len += item->GetSize();
+    } while (++count < m_dropBatchSize && len < threshold);
+
+    return index;
+}
+
+void
+FqCoDelQueueDisc::LightweightEnqueue(Ptr<QueueDiscItem> item, uint32_t h, uint32_t flowHash)
+{
+    NS_LOG_FUNCTION(this << item << h << flowHash);
+
+    uint32_t slot = m_flowSlots[h];
+    if (slot == NONE)
+    {
+        NS_LOG_DEBUG("Creating a new flow queue with index " << h);
+        slot = m_flowTable.size();
+        m_flowSlots[h] = slot;
+        Flow flow;
+        flow.index = h;
+        flow.tag = flowHash;
+        flow.status = FqCoDelFlow::INACTIVE;
+        flow.deficit = 0;
+        flow.next = NONE;
+        flow.head = NONE;
+        flow.tail = NONE;
+        flow.nPackets = 0;
+        flow.nBytes = 0;
+        flow.count = 0;
+        flow.lastCount = 0;
+        flow.firstAboveTime = 0;
+        flow.dropNext = 0;
+        flow.recInvSqrt = ~0U >> REC_INV_SQRT_SHIFT;
+        flow.dropping = false;
+        m_flowTable.push_back(flow);
+    }
+
+    Flow& flow = m_flowTable[slot];
+
+    if (flow.status == FqCoDelFlow::INACTIVE)
+    {
+        flow.status = FqCoDelFlow::NEW_FLOW;
+        flow.deficit = m_quantum;
+        PushFlow(m_newFlowList, slot);
+    }
+
+    // a flow queue holds at most as many packets (or bytes) as the queue disc,
+    // as the CoDel queue disc of a flow does
+    QueueSize maxSize = GetMaxSize();
+    if ((maxSize.GetUnit() == QueueSizeUnit::PACKETS && flow.nPackets + 1 > maxSize.GetValue()) ||
+        (maxSize.GetUnit() == QueueSizeUnit::BYTES &&
+         flow.nBytes + item->GetSize() > maxSize.GetValue()))
+    {
+        NS_LOG_LOGIC("Flow queue full -- dropping pkt");
+        DropBeforeEnqueue(item, CHILD_OVERLIMIT_DROP_ID);
+        return;
+    }
+
+    PushPacket(flow, item);
+
+    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << slot);
+}
+
+Ptr<QueueDiscItem>
+FqCoDelQueueDisc::LightweightDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t slot = NONE;
+    Ptr<QueueDiscItem> item;
+
+    do
+    {
+        bool found = false;
+
+        while (!found && m_newFlowList.head != NONE)
+        {
+            slot = m_newFlowList.head;
+            Flow& flow = m_flowTable[slot];
+
+            if (flow.deficit <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for new flow index " << flow.index);
+                flow.deficit += m_quantum;
+                flow.status = FqCoDelFlow::OLD_FLOW;
+                PushFlow(m_oldFlowList, PopFlow(m_newFlowList));
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found a new flow " << flow.index << " with positive deficit");
+                found = true;
+            }
+        }
+
+        while (!found && m_oldFlowList.head != NONE)
+        {
+            slot = m_oldFlowList.head;
+            Flow& flow = m_flowTable[slot];
+
+            if (flow.deficit <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for old flow index " << flow.index);
+                flow.deficit += m_quantum;
+                PushFlow(m_oldFlowList, PopFlow(m_oldFlowList));
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found an old flow " << flow.index << " with positive deficit");
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            NS_LOG_DEBUG("No flow found to dequeue a packet");
+            return nullptr;
+        }
+
+        item = CoDelDequeue(m_flowTable[slot]);
+
+        if (!item)
+        {
+            NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
+            if (m_newFlowList.head != NONE)
+            {
+                m_flowTable[slot].status = FqCoDelFlow::OLD_FLOW;
+                PushFlow(m_oldFlowList, PopFlow(m_newFlowList));
+            }
+            else
+            {
+                m_flowTable[slot].status = FqCoDelFlow::INACTIVE;
+                PopFlow(m_oldFlowList);
+            }
+        }
+        else
+        {
+            NS_LOG_DEBUG("Dequeued packet " << item->GetPacket());
+        }
+    } while (!item);
+
+    m_flowTable[slot].deficit -= item->GetSize();
+
+    return item;
+}
+
+uint32_t
+FqCoDelQueueDisc::LightweightDrop()
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t maxBacklog = 0;
+    uint32_t index = 0;
+
+    /* Queue is full! Find the fat flow and drop packet(s) from it */
+    for (uint32_t i = 0; i < m_flowTable.size(); i++)
+    {
+        if (m_flowTable[i].nBytes > maxBacklog)
+        {
+            maxBacklog = m_flowTable[i].nBytes;
+            index = i;
+        }
+    }
+
+    /* Our goal is to drop half of this fat flow backlog */
+    uint32_t len = 0;
+    uint32_t count = 0;
+    uint32_t threshold = maxBacklog >> 1;
+    Flow& flow = m_flowTable[index];
+    Ptr<QueueDiscItem> item;
+
+    do
+    {
+        NS_LOG_DEBUG("Drop packet (overflow); count: " << count << " len: " << len
+                                                       << " threshold: " << threshold);
+        item = PopPacket(flow);
+        DropAfterDequeue(item, OVERLIMIT_DROP_ID);
         len += item->GetSize();
     } while (++count < m_dropBatchSize && len < threshold);
 
     return index;
 }
 
+bool
+FqCoDelQueueDisc::CoDelOkToDrop(Flow& flow, Ptr<QueueDiscItem> item, uint32_t now)
+{
+    NS_LOG_FUNCTION(this << flow.index << item << now);
+
+    if (!item)
+    {
+        flow.firstAboveTime = 0;
+        return false;
+    }
+
+    uint32_t sojournTime = CoDelQueueDisc::Time2CoDel(Simulator::Now() - item->GetTimeStamp());
+
+    if (CoDelQueueDisc::CoDelTimeBefore(sojournTime, m_codelTarget) || flow.nBytes < m_minBytes)
+    {
+        // went below so we'll stay below for at least interval
+        flow.firstAboveTime = 0;
+        return false;
+    }
+    if (flow.firstAboveTime == 0)
+    {
+        // just went above from below. If we stay above for at least interval
+        // we'll say it's ok to drop
+        flow.firstAboveTime = now + m_codelInterval;
+        return false;
+    }
+    return CoDelQueueDisc::CoDelTimeAfter(now, flow.firstAboveTime);
+}
+
+Ptr<QueueDiscItem>
+FqCoDelQueueDisc::CoDelDequeue(Flow& flow)
+{
+    NS_LOG_FUNCTION(this << flow.index);
+
+    Ptr<QueueDiscItem> item = PopPacket(flow);
+    if (!item)
+    {
+        // Leave dropping state when queue is empty
+        flow.dropping = false;
+        return nullptr;
+    }
+
+    if (m_useL4s)
+    {
+        uint8_t tosByte = 0;
+        if (item->GetUint8Value(QueueItem::IP_DSFIELD, tosByte) &&
+            (((tosByte & 0x3) == 1) || (tosByte & 0x3) == 3))
+        {
+            uint32_t ldelay =
+                CoDelQueueDisc::Time2CoDel(Simulator::Now() - item->GetTimeStamp());
+            if (CoDelQueueDisc::CoDelTimeAfter(ldelay, m_codelCeThreshold) &&
+                Mark(item, CHILD_CE_THRESHOLD_EXCEEDED_MARK_ID))
+            {
+                NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
+            }
+            return item;
+        }
+    }
+
+    uint32_t now = CoDelQueueDisc::Time2CoDel(Simulator::Now());
+
+    // Determine if item should be dropped
+    bool okToDrop = CoDelOkToDrop(flow, item, now);
+    bool isMarked = false;
+
+    if (flow.dropping)
+    {
+        if (!okToDrop)
+        {
+            // sojourn time fell below target - leave dropping state
+            flow.dropping = false;
+        }
+        else
+        {
+            // drop (or mark) packets as long as it is time for the next drop
+            while (flow.dropping && CoDelQueueDisc::CoDelTimeAfterEq(now, flow.dropNext))
+            {
+                ++flow.count;
+                flow.recInvSqrt = CoDelQueueDisc::NewtonStep(flow.recInvSqrt, flow.count);
+                if (m_useEcn && Mark(item, CHILD_TARGET_EXCEEDED_MARK_ID))
+                {
+                    isMarked = true;
+                    flow.dropNext =
+                        CoDelQueueDisc::ControlLaw(now, m_codelInterval, flow.recInvSqrt);
+                    break;
+                }
+                DropAfterDequeue(item, CHILD_TARGET_EXCEEDED_DROP_ID);
+
+                item = PopPacket(flow);
+
+                if (!CoDelOkToDrop(flow, item, now))
+                {
+                    // leave dropping state
+                    flow.dropping = false;
+                }
+                else
+                {
+                    // schedule the next drop
+                    flow.dropNext =
+                        CoDelQueueDisc::ControlLaw(flow.dropNext, m_codelInterval, flow.recInvSqrt);
+                }
+            }
+        }
+    }
+    else if (okToDrop)
+    {
+        // Decide if we have to enter the dropping state and drop the first packet
+        if (m_useEcn && Mark(item, CHILD_TARGET_EXCEEDED_MARK_ID))
+        {
+            isMarked = true;
+        }
+        else
+        {
+            // Drop the first packet and enter dropping state unless the queue is empty
+            DropAfterDequeue(item, CHILD_TARGET_EXCEEDED_DROP_ID);
+            item = PopPacket(flow);
+            CoDelOkToDrop(flow, item, now);
+        }
+        flow.dropping = true;
+        // if min went above target close to when we last went below it, assume
+        // that the drop rate that controlled the queue on the last cycle is a
+        // good starting point to control it now
+        int delta = flow.count - flow.lastCount;
+        if (delta > 1 &&
+            CoDelQueueDisc::CoDelTimeBefore(now - flow.dropNext, 16 * m_codelInterval))
+        {
+            flow.count = delta;
+            flow.recInvSqrt = CoDelQueueDisc::NewtonStep(flow.recInvSqrt, flow.count);
+        }
+        else
+        {
+            flow.count = 1;
+            flow.recInvSqrt = ~0U >> REC_INV_SQRT_SHIFT;
+        }
+        flow.lastCount = flow.count;
+        flow.dropNext = CoDelQueueDisc::ControlLaw(now, m_codelInterval, flow.recInvSqrt);
+    }
+
+    // as CoDelQueueDisc does, do not mark a packet twice
+    if (!isMarked && item && !m_useL4s && m_useEcn &&
+        CoDelQueueDisc::CoDelTimeAfter(
+            CoDelQueueDisc::Time2CoDel(Simulator::Now() - item->GetTimeStamp()),
+            m_codelCeThreshold) &&
+        Mark(item, CHILD_CE_THRESHOLD_EXCEEDED_MARK_ID))
+    {
+        NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
+    }
+    return item;
+}
+
+void
+FqCoDelQueueDisc::PushPacket(Flow& flow, Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << flow.index << item);
+
+    uint32_t slot = m_freePacket;
+    if (slot == NONE)
+    {
+        slot = m_packets.size();
+        m_packets.push_back({item, NONE});
+    }
+    else
+    {
+        m_freePacket = m_packets[slot].next;
+        m_packets[slot] = {item, NONE};
+    }
+
+    if (flow.tail == NONE)
+    {
+        flow.head = slot;
+    }
+    else
+    {
+        m_packets[flow.tail].next = slot;
+    }
+    flow.tail = slot;
+    flow.nPackets++;
+    flow.nBytes += item->GetSize();
+
+    PacketEnqueued(item);
+}
+
+Ptr<QueueDiscItem>
+FqCoDelQueueDisc::PopPacket(Flow& flow)
+{
+    NS_LOG_FUNCTION(this << flow.index);
+
+    if (flow.head == NONE)
+    {
+        return nullptr;
+    }
+
+    uint32_t slot = flow.head;
+    Ptr<QueueDiscItem> item = m_packets[slot].item;
+    m_packets[slot].item = nullptr;
+    flow.head = m_packets[slot].next;
+    if (flow.head == NONE)
+    {
+        flow.tail = NONE;
+    }
+    m_packets[slot].next = m_freePacket;
+    m_freePacket = slot;
+    flow.nPackets--;
+    flow.nBytes -= item->GetSize();
+
+    PacketDequeued(item);
+    return item;
+}
+
+void
+FqCoDelQueueDisc::PushFlow(FlowList& list, uint32_t flow)
+{
+    m_flowTable[flow].next = NONE;
+    if (list.tail == NONE)
+    {
+        list.head = flow;
+    }
+    else
+    {
+        m_flowTable[list.tail].next = flow;
+    }
+    list.tail = flow;
+}
+
+uint32_t
+FqCoDelQueueDisc::PopFlow(FlowList& list)
+{
+    uint32_t flow = list.head;
+    list.head = m_flowTable[flow].next;
+    if (list.head == NONE)
+    {
+        list.tail = NONE;
+    }
+    return flow;
+}
+
 } // namespace ns3
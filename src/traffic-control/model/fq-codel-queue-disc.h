@@ -25,8 +25,10 @@
 
 #include "ns3/object-factory.h"
 
+#include <limits>
 #include <list>
 #include <map>
+#include <vector>
 
 namespace ns3
 {
@@ -109,6 +111,15 @@ class FqCoDelFlow : public QueueDiscClass
  * \ingroup traffic-control
  *
  * \brief A FqCoDel packet queue disc
+ *
+ * By default, each flow queue is a FqCoDelFlow class holding a CoDel queue
+ * disc. If the LightweightFlows attribute is set, the flow queues and the
+ * state of their CoDel instances are instead stored in plain structs in a
+ * single vector, the packets of all the flow queues are chained in a shared
+ * pool and the lists of new and old flows are linked through the flows
+ * themselves. The scheduling, the drops and the marks are identical, but no
+ * object is created per flow, hence the queue disc has no classes and the
+ * trace sources of the per-flow CoDel queue discs are not available.
  */
 
 class FqCoDelQueueDisc : public QueueDisc
@@ -146,8 +157,54 @@ class FqCoDelQueueDisc : public QueueDisc
     static constexpr const char* UNCLASSIFIED_DROP =
         "Unclassified drop"; //!< No packet filter able to classify packet
     static constexpr const char* OVERLIMIT_DROP = "Overlimit drop"; //!< Overlimit dropped packets
+    // Identifiers of the reasons, interned once for this queue disc type
+    static const ReasonId UNCLASSIFIED_DROP_ID; //!< Interned UNCLASSIFIED_DROP
+    static const ReasonId OVERLIMIT_DROP_ID;    //!< Interned OVERLIMIT_DROP
+
+  protected:
+    void DoDispose() override;
 
   private:
+    /// Index denoting the absence of a flow or of a packet
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * \brief A flow queue of the lightweight implementation, along with the
+     *        state of its CoDel instance
+     */
+    struct Flow
+    {
+        uint32_t index;                 //!< the index of the flow queue
+        uint32_t tag;                   //!< the tag used by set associative hash
+        FqCoDelFlow::FlowStatus status; //!< the status of the flow
+        int32_t deficit;                //!< the deficit of the flow
+        uint32_t next;                  //!< the next flow in the list of new or old flows
+        uint32_t head;                  //!< the first packet of the flow
+        uint32_t tail;                  //!< the last packet of the flow
+        uint32_t nPackets;              //!< the number of packets of the flow
+        uint32_t nBytes;                //!< the amount of bytes of the flow
+        uint32_t count;                 //!< CoDel count
+        uint32_t lastCount;             //!< CoDel last count
+        uint32_t firstAboveTime;        //!< CoDel time to declare sojourn time above target
+        uint32_t dropNext;              //!< CoDel time to drop next packet
+        uint16_t recInvSqrt;            //!< CoDel reciprocal inverse square root
+        bool dropping;                  //!< CoDel dropping state
+    };
+
+    /// A list of flows of the lightweight implementation, linked by Flow::next
+    struct FlowList
+    {
+        uint32_t head{NONE}; //!< the first flow
+        uint32_t tail{NONE}; //!< the last flow
+    };
+
+    /// A packet of the lightweight implementation, linked to the next packet of its flow
+    struct PacketSlot
+    {
+        Ptr<QueueDiscItem> item; //!< the packet
+        uint32_t next;           //!< the next packet of the flow or of the free list
+    };
+
     bool DoEnqueue(Ptr<QueueDiscItem> item) override;
     Ptr<QueueDiscItem> DoDequeue() override;
     bool CheckConfig() override;
@@ -159,6 +216,65 @@ class FqCoDelQueueDisc : public QueueDisc
      */
     uint32_t FqCoDelDrop();
 
+    /**
+     * \brief Enqueue a packet in a flow of the lightweight implementation
+     * \param item the packet
+     * \param h the index of the flow queue
+     * \param flowHash the hash of the flow
+     */
+    void LightweightEnqueue(Ptr<QueueDiscItem> item, uint32_t h, uint32_t flowHash);
+    /**
+     * \brief Dequeue a packet from the flows of the lightweight implementation
+     * \return the packet, or null if no packet is available
+     */
+    Ptr<QueueDiscItem> LightweightDequeue();
+    /**
+     * \brief Drop packets from the flow with the largest current byte count,
+     *        like FqCoDelDrop does for the lightweight implementation
+     * \return the index of the flow with the largest current byte count
+     */
+    uint32_t LightweightDrop();
+    /**
+     * \brief Dequeue a packet from a flow according to the CoDel algorithm,
+     *        like CoDelQueueDisc::DoDequeue does
+     * \param flow the flow
+     * \return the packet, or null if the flow is empty
+     */
+    Ptr<QueueDiscItem> CoDelDequeue(Flow& flow);
+    /**
+     * \brief Check whether the packet at the head of a flow may be dropped,
+     *        like CoDelQueueDisc::OkToDrop does
+     * \param flow the flow
+     * \param item the packet
+     * \param now the current CoDel time
+     * \return true if the packet may be dropped
+     */
+    bool CoDelOkToDrop(Flow& flow, Ptr<QueueDiscItem> item, uint32_t now);
+    /**
+     * \brief Add a packet at the tail of a flow and notify the enqueue
+     * \param flow the flow
+     * \param item the packet
+     */
+    void PushPacket(Flow& flow, Ptr<QueueDiscItem> item);
+    /**
+     * \brief Remove the packet at the head of a flow and notify the dequeue
+     * \param flow the flow
+     * \return the packet, or null if the flow is empty
+     */
+    Ptr<QueueDiscItem> PopPacket(Flow& flow);
+    /**
+     * \brief Add a flow at the tail of a list
+     * \param list the list
+     * \param flow the index of the flow in m_flowTable
+     */
+    void PushFlow(FlowList& list, uint32_t flow);
+    /**
+     * \brief Remove the flow at the head of a list
+     * \param list the list
+     * \return the index of the flow in m_flowTable
+     */
+    uint32_t PopFlow(FlowList& list);
+
     bool m_useEcn; //!< True if ECN is used (packets are marked instead of being dropped)
     /**
      * Compute the index of the queue for the flow having the given flowHash,
@@ -179,6 +295,7 @@ class FqCoDelQueueDisc : public QueueDisc
     Time m_ceThreshold;              //!< Threshold above which to CE mark
     bool m_enableSetAssociativeHash; //!< whether to enable set associative hash
     bool m_useL4s; //!< True if L4S is used (ECT1 packets are marked at CE threshold)
+    bool m_lightweightFlows; //!< True if the flows are stored without per-flow objects
 
     std::list<Ptr<FqCoDelFlow>> m_newFlows; //!< The list of new flows
     std::list<Ptr<FqCoDelFlow>> m_oldFlows; //!< The list of old flows
@@ -188,6 +305,18 @@ class FqCoDelQueueDisc : public QueueDisc
 
     ObjectFactory m_flowFactory;      //!< Factory to create a new flow
     ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
+
+    // Lightweight implementation
+    std::vector<Flow> m_flowTable;     //!< The flows, in order of creation
+    std::vector<uint32_t> m_flowSlots; //!< Index in the flow table of each flow queue
+    std::vector<PacketSlot> m_packets; //!< The packets of all the flows
+    uint32_t m_freePacket;             //!< The first free packet slot
+    FlowList m_newFlowList;            //!< The list of new flows
+    FlowList m_oldFlowList;            //!< The list of old flows
+    uint32_t m_minBytes;               //!< CoDel minimum bytes in queue to allow a drop
+    uint32_t m_codelInterval;          //!< CoDel interval, in CoDel time
+    uint32_t m_codelTarget;            //!< CoDel target, in CoDel time
+    uint32_t m_codelCeThreshold;       //!< CE threshold, in CoDel time
 };
 
 } // namespace ns3
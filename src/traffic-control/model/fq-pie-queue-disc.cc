@@ -112,6 +112,9 @@ FqPieFlow::GetIndex() const
 
 NS_OBJECT_ENSURE_REGISTERED(FqPieQueueDisc);
 
+const QueueDisc::ReasonId FqPieQueueDisc::UNCLASSIFIED_DROP_ID = RegisterReason(UNCLASSIFIED_DROP);
+const QueueDisc::ReasonId FqPieQueueDisc::OVERLIMIT_DROP_ID = RegisterReason(OVERLIMIT_DROP);
+
 TypeId
 FqPieQueueDisc::GetTypeId()
 {
@@ -307,7 +310,7 @@ FqPieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         else
         {
             NS_LOG_ERROR("No filter has been able to classify this packet, drop it.");
-            DropBeforeEnqueue(item, UNCLASSIFIED_DROP);
+            DropBeforeEnqueue(item, UNCLASSIFIED_DROP_ID);
             return false;
         }
     }
@@ -560,7 +563,7 @@ FqPieQueueDisc::FqPieDrop()
         NS_LOG_DEBUG("Drop packet (overflow); count: " << count << " len: " << len
                                                        << " threshold: " << threshold);
         item = qd->GetInternalQueue(0)->Dequeue();
-        DropAfterDequeue(item, OVERLIMIT_DROP);
+        DropAfterDequeue(item, OVERLIMIT_DROP_ID);
         len += item->GetSize();
     } while (++count < m_dropBatchSize && len < threshold);
 
@@ -41,6 +41,12 @@ NS_LOG_COMPONENT_DEFINE("PieQueueDisc");
 
 NS_OBJECT_ENSURE_REGISTERED(PieQueueDisc);
 
+const QueueDisc::ReasonId PieQueueDisc::UNFORCED_DROP_ID = RegisterReason(UNFORCED_DROP);
+const QueueDisc::ReasonId PieQueueDisc::FORCED_DROP_ID = RegisterReason(FORCED_DROP);
+const QueueDisc::ReasonId PieQueueDisc::UNFORCED_MARK_ID = RegisterReason(UNFORCED_MARK);
+const QueueDisc::ReasonId PieQueueDisc::CE_THRESHOLD_EXCEEDED_MARK_ID =
+    RegisterReason(CE_THRESHOLD_EXCEEDED_MARK);
+
 TypeId
 PieQueueDisc::GetTypeId()
 {
@@ -203,7 +209,7 @@ PieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
     if (nQueued + item > GetMaxSize())
     {
         // Drops due to queue limit: reactive
-        DropBeforeEnqueue(item, FORCED_DROP);
+        DropBeforeEnqueue(item, FORCED_DROP_ID);
         m_accuProb = 0;
         return false;
     }
@@ -212,10 +218,10 @@ PieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
     else if ((m_activeThreshold == Time::Max() || m_active) && !isEct1 &&
              DropEarly(item, nQueued.GetValue()))
     {
-        if (!m_useEcn || m_dropProb >= m_markEcnTh || !Mark(item, UNFORCED_MARK))
+        if (!m_useEcn || m_dropProb >= m_markEcnTh || !Mark(item, UNFORCED_MARK_ID))
         {
             // Early probability drop: proactive
-            DropBeforeEnqueue(item, UNFORCED_DROP);
+            DropBeforeEnqueue(item, UNFORCED_DROP_ID);
             m_accuProb = 0;
             return false;
         }
@@ -499,7 +505,7 @@ PieQueueDisc::DoDequeue()
                 NS_LOG_DEBUG("CE packet " << static_cast<uint16_t>(tosByte & 0x3));
             }
             if ((Now() - item->GetTimeStamp() > m_ceThreshold) &&
-                Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
+                Mark(item, CE_THRESHOLD_EXCEEDED_MARK_ID))
             {
                 NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
             }
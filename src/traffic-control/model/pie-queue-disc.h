@@ -105,6 +105,11 @@ class PieQueueDisc : public QueueDisc
         "Unforced mark"; //!< Early probability marks: proactive
     static constexpr const char* CE_THRESHOLD_EXCEEDED_MARK =
         "CE threshold exceeded mark"; //!< Early probability marks: proactive
+    // Identifiers of the reasons, interned once for this queue disc type
+    static const ReasonId UNFORCED_DROP_ID;              //!< Interned UNFORCED_DROP
+    static const ReasonId FORCED_DROP_ID;                //!< Interned FORCED_DROP
+    static const ReasonId UNFORCED_MARK_ID;              //!< Interned UNFORCED_MARK
+    static const ReasonId CE_THRESHOLD_EXCEEDED_MARK_ID; //!< Interned CE_THRESHOLD_EXCEEDED_MARK
 
   protected:
     /**
@@ -19,16 +19,23 @@
 #include "queue-disc.h"
 
 #include "ns3/abort.h"
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/object-vector.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/queue-limits.h"
 #include "ns3/queue.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simulator.h"
 #include "ns3/socket.h"
 #include "ns3/uinteger.h"
 
+#include <deque>
+#include <limits>
+#include <unordered_map>
+
 namespace ns3
 {
 
@@ -36,6 +43,58 @@ NS_LOG_COMPONENT_DEFINE("QueueDisc");
 
 NS_OBJECT_ENSURE_REGISTERED(QueueDiscClass);
 
+/**
+ * \ingroup traffic-control
+ * \brief The reasons for dropping or marking packets interned by QueueDisc
+ */
+struct QueueDiscReasonRegistry
+{
+    std::deque<std::string> reasons;                           //!< Reasons, indexed by identifier
+    std::unordered_map<std::string, QueueDisc::ReasonId> ids;  //!< Identifier of each reason
+    std::vector<QueueDisc::ReasonId> childDrops;               //!< Reason of a child drop, by id
+    std::vector<QueueDisc::ReasonId> childMarks;               //!< Reason of a child mark, by id
+};
+
+/**
+ * \brief Get the registry of the reasons, created when first used so that
+ *        queue disc types may register their reasons at static initialization
+ * \return the registry
+ */
+static QueueDiscReasonRegistry&
+GetQueueDiscReasonRegistry()
+{
+    static QueueDiscReasonRegistry registry;
+    return registry;
+}
+
+/**
+ * \brief Get the reason for a packet dropped or marked by a child queue disc
+ *
+ * The reason is the concatenation of the given prefix and of the reason of
+ * the child queue disc, interned once for each reason of the child.
+ *
+ * \param cache the identifiers interned so far, indexed by reason of the child
+ * \param prefix the prefix of the reason
+ * \param reason the reason of the child queue disc
+ * \return the identifier of the reason
+ */
+static QueueDisc::ReasonId
+GetChildQueueDiscReason(std::vector<QueueDisc::ReasonId>& cache,
+                        const char* prefix,
+                        QueueDisc::ReasonId reason)
+{
+    static constexpr QueueDisc::ReasonId unknown = std::numeric_limits<QueueDisc::ReasonId>::max();
+    if (reason >= cache.size())
+    {
+        cache.resize(reason + 1, unknown);
+    }
+    if (cache[reason] == unknown)
+    {
+        cache[reason] = QueueDisc::RegisterReason(prefix + QueueDisc::GetReasonString(reason));
+    }
+    return cache[reason];
+}
+
 TypeId
 QueueDiscClass::GetTypeId()
 {
@@ -257,6 +316,13 @@ QueueDisc::GetTypeId()
                           UintegerValue(DEFAULT_QUOTA),
                           MakeUintegerAccessor(&QueueDisc::SetQuota, &QueueDisc::GetQuota),
                           MakeUintegerChecker<uint32_t>())
+            .AddAttribute("BulkDequeue",
+                          "Whether to dequeue, at once, as many packets as the queue "
+                          "limits of the device transmission queue accept, and send "
+                          "them to the device in a single burst",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&QueueDisc::m_bulkDequeue),
+                          MakeBooleanChecker())
             .AddAttribute("InternalQueueList",
                           "The list of internal queues.",
                           ObjectVectorValue(),
@@ -300,6 +366,18 @@ QueueDisc::GetTypeId()
                             "Mark a packet stored in the queue disc",
                             MakeTraceSourceAccessor(&QueueDisc::m_traceMark),
                             "ns3::QueueDiscItem::TracedCallback")
+            .AddTraceSource("DropBeforeEnqueueReason",
+                            "Drop a packet before enqueue, for the identified reason",
+                            MakeTraceSourceAccessor(&QueueDisc::m_traceDropBeforeEnqueueReason),
+                            "ns3::QueueDisc::ReasonTracedCallback")
+            .AddTraceSource("DropAfterDequeueReason",
+                            "Drop a packet after dequeue, for the identified reason",
+                            MakeTraceSourceAccessor(&QueueDisc::m_traceDropAfterDequeueReason),
+                            "ns3::QueueDisc::ReasonTracedCallback")
+            .AddTraceSource("MarkReason",
+                            "Mark a packet stored in the queue disc, for the identified reason",
+                            MakeTraceSourceAccessor(&QueueDisc::m_traceMarkReason),
+                            "ns3::QueueDisc::ReasonTracedCallback")
             .AddTraceSource("PacketsInQueue",
                             "Number of packets currently stored in the queue disc",
                             MakeTraceSourceAccessor(&QueueDisc::m_nPackets),
@@ -319,6 +397,7 @@ QueueDisc::QueueDisc(QueueDiscSizePolicy policy)
     : m_nPackets(0),
       m_nBytes(0),
       m_maxSize(QueueSize("1p")), // to avoid that setting the mode at construction time is ignored
+      m_bulkDequeue(false),
       m_running(false),
       m_peeked(false),
       m_sizePolicy(policy),
@@ -331,32 +410,37 @@ QueueDisc::QueueDisc(QueueDiscSizePolicy policy)
     // is connected to the DropBeforeEnqueue and DropAfterDequeue traces of the
     // internal queues, the INTERNAL_QUEUE_DROP constant is passed as the reason
     // why the packet is dropped.
+    static const ReasonId internalQueueDrop = RegisterReason(INTERNAL_QUEUE_DROP);
     m_internalQueueDbeFunctor = [this](Ptr<const QueueDiscItem> item) {
-        return DropBeforeEnqueue(item, INTERNAL_QUEUE_DROP);
+        return DropBeforeEnqueue(item, internalQueueDrop);
     };
     m_internalQueueDadFunctor = [this](Ptr<const QueueDiscItem> item) {
-        return DropAfterDequeue(item, INTERNAL_QUEUE_DROP);
+        return DropAfterDequeue(item, internalQueueDrop);
     };
 
     // These lambdas call the DropBeforeEnqueue or DropAfterDequeue methods of this
     // QueueDisc object. Given that a callback to the operator() of these lambdas
-    // is connected to the DropBeforeEnqueue and DropAfterDequeue traces of the
-    // child queue discs, the concatenation of the CHILD_QUEUE_DISC_DROP constant
-    // and the second argument provided by such traces is passed as the reason why
-    // the packet is dropped.
-    m_childQueueDiscDbeFunctor = [this](Ptr<const QueueDiscItem> item, const char* r) {
-        return DropBeforeEnqueue(
-            item,
-            m_childQueueDiscDropMsg.assign(CHILD_QUEUE_DISC_DROP).append(r).data());
+    // is connected to the DropBeforeEnqueueReason and DropAfterDequeueReason traces
+    // of the child queue discs, the concatenation of the CHILD_QUEUE_DISC_DROP
+    // constant and the reason identified by such traces is passed as the reason why
+    // the packet is dropped. The concatenation is interned once per reason.
+    m_childQueueDiscDbeFunctor = [this](Ptr<const QueueDiscItem> item, ReasonId r) {
+        return DropBeforeEnqueue(item,
+                                 GetChildQueueDiscReason(GetQueueDiscReasonRegistry().childDrops,
+                                                         CHILD_QUEUE_DISC_DROP,
+                                                         r));
     };
-    m_childQueueDiscDadFunctor = [this](Ptr<const QueueDiscItem> item, const char* r) {
-        return DropAfterDequeue(
-            item,
-            m_childQueueDiscDropMsg.assign(CHILD_QUEUE_DISC_DROP).append(r).data());
+    m_childQueueDiscDadFunctor = [this](Ptr<const QueueDiscItem> item, ReasonId r) {
+        return DropAfterDequeue(item,
+                                GetChildQueueDiscReason(GetQueueDiscReasonRegistry().childDrops,
+                                                        CHILD_QUEUE_DISC_DROP,
+                                                        r));
     };
-    m_childQueueDiscMarkFunctor = [this](Ptr<const QueueDiscItem> item, const char* r) {
+    m_childQueueDiscMarkFunctor = [this](Ptr<const QueueDiscItem> item, ReasonId r) {
         return Mark(const_cast<QueueDiscItem*>(PeekPointer(item)),
-                    m_childQueueDiscMarkMsg.assign(CHILD_QUEUE_DISC_MARK).append(r).data());
+                    GetChildQueueDiscReason(GetQueueDiscReasonRegistry().childMarks,
+                                            CHILD_QUEUE_DISC_MARK,
+                                            r));
     };
 }
 
@@ -381,11 +465,17 @@ QueueDisc::DoDispose()
     m_classes.clear();
     m_devQueueIface = nullptr;
     m_send = nullptr;
+    m_sendBurst = nullptr;
+    m_burst.clear();
     m_requeued = nullptr;
+    m_externalLoadRng = nullptr;
+    m_externalLoadEvent.Cancel();
+    m_arrivals.clear();
     m_internalQueueDbeFunctor = nullptr;
     m_internalQueueDadFunctor = nullptr;
     m_childQueueDiscDbeFunctor = nullptr;
     m_childQueueDiscDadFunctor = nullptr;
+    m_childQueueDiscMarkFunctor = nullptr;
     Object::DoDispose();
 }
 
@@ -425,9 +515,68 @@ QueueDisc::GetStats()
                               (m_requeued ? m_requeued->GetSize() : 0) -
                               m_stats.nTotalDroppedBytesAfterDequeue;
 
+    // the per-reason statistics are counted by reason identifier and only
+    // converted here to the maps keyed by the reason strings
+    m_stats.nDroppedPacketsBeforeEnqueue.clear();
+    m_stats.nDroppedBytesBeforeEnqueue.clear();
+    m_stats.nDroppedPacketsAfterDequeue.clear();
+    m_stats.nDroppedBytesAfterDequeue.clear();
+    m_stats.nMarkedPackets.clear();
+    m_stats.nMarkedBytes.clear();
+    for (ReasonId id = 0; id < m_reasonCounters.size(); id++)
+    {
+        const ReasonCounters& counters = m_reasonCounters[id];
+        const std::string& reason = GetReasonString(id);
+        if (counters.droppedPacketsBeforeEnqueue > 0)
+        {
+            m_stats.nDroppedPacketsBeforeEnqueue[reason] = counters.droppedPacketsBeforeEnqueue;
+            m_stats.nDroppedBytesBeforeEnqueue[reason] = counters.droppedBytesBeforeEnqueue;
+        }
+        if (counters.droppedPacketsAfterDequeue > 0)
+        {
+            m_stats.nDroppedPacketsAfterDequeue[reason] = counters.droppedPacketsAfterDequeue;
+            m_stats.nDroppedBytesAfterDequeue[reason] = counters.droppedBytesAfterDequeue;
+        }
+        if (counters.markedPackets > 0)
+        {
+            m_stats.nMarkedPackets[reason] = counters.markedPackets;
+            m_stats.nMarkedBytes[reason] = counters.markedBytes;
+        }
+    }
+
     return m_stats;
 }
 
+QueueDisc::ReasonId
+QueueDisc::RegisterReason(const std::string& reason)
+{
+    QueueDiscReasonRegistry& registry = GetQueueDiscReasonRegistry();
+    auto [it, inserted] = registry.ids.try_emplace(reason, registry.reasons.size());
+    if (inserted)
+    {
+        registry.reasons.push_back(reason);
+    }
+    return it->second;
+}
+
+const std::string&
+QueueDisc::GetReasonString(ReasonId id)
+{
+    const QueueDiscReasonRegistry& registry = GetQueueDiscReasonRegistry();
+    NS_ASSERT_MSG(id < registry.reasons.size(), "Unknown reason identifier " << id);
+    return registry.reasons[id];
+}
+
+QueueDisc::ReasonCounters&
+QueueDisc::GetReasonCounters(ReasonId reason)
+{
+    if (reason >= m_reasonCounters.size())
+    {
+        m_reasonCounters.resize(reason + 1);
+    }
+    return m_reasonCounters[reason];
+}
+
 uint32_t
 QueueDisc::GetNPackets() const
 {
@@ -555,6 +704,20 @@ QueueDisc::GetSendCallback() const
     return m_send;
 }
 
+void
+QueueDisc::SetSendBurstCallback(SendBurstCallback func)
+{
+    NS_LOG_FUNCTION(this);
+    m_sendBurst = func;
+}
+
+QueueDisc::SendBurstCallback
+QueueDisc::GetSendBurstCallback() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_sendBurst;
+}
+
 void
 QueueDisc::SetQuota(const uint32_t quota)
 {
@@ -639,13 +802,13 @@ QueueDisc::AddQueueDiscClass(Ptr<QueueDiscClass> qdClass)
         "Dequeue",
         MakeCallback(&QueueDisc::PacketDequeued, this));
     qdClass->GetQueueDisc()->TraceConnectWithoutContext(
-        "DropBeforeEnqueue",
+        "DropBeforeEnqueueReason",
         MakeCallback(&ChildQueueDiscDropFunctor::operator(), &m_childQueueDiscDbeFunctor));
     qdClass->GetQueueDisc()->TraceConnectWithoutContext(
-        "DropAfterDequeue",
+        "DropAfterDequeueReason",
         MakeCallback(&ChildQueueDiscDropFunctor::operator(), &m_childQueueDiscDadFunctor));
     qdClass->GetQueueDisc()->TraceConnectWithoutContext(
-        "Mark",
+        "MarkReason",
         MakeCallback(&ChildQueueDiscMarkFunctor::operator(), &m_childQueueDiscMarkFunctor));
     m_classes.push_back(qdClass);
 }
@@ -682,6 +845,30 @@ QueueDisc::GetWakeMode() const
     return WAKE_ROOT;
 }
 
+void
+QueueDisc::SetExternalLoad(double dropProbability, Time delay)
+{
+    NS_LOG_FUNCTION(this << dropProbability << delay);
+    NS_ASSERT_MSG(dropProbability >= 0 && dropProbability <= 1, "Invalid drop probability");
+
+    // the random variable is only created when needed, not to change the
+    // streams assigned to the other random variables
+    if (dropProbability > 0 && !m_externalLoadRng)
+    {
+        m_externalLoadRng = CreateObject<UniformRandomVariable>();
+    }
+    m_externalDropProbability = dropProbability;
+    m_externalDelay = delay;
+
+    // from the first delay on, the arrival times of the packets are recorded.
+    // The packets already in the queue disc are not held
+    if (delay.IsStrictlyPositive() && !m_trackArrivals)
+    {
+        m_trackArrivals = true;
+        m_arrivals.assign(m_nPackets, Time(0));
+    }
+}
+
 void
 QueueDisc::PacketEnqueued(Ptr<const QueueDiscItem> item)
 {
@@ -689,6 +876,10 @@ QueueDisc::PacketEnqueued(Ptr<const QueueDiscItem> item)
     m_nBytes += item->GetSize();
     m_stats.nTotalEnqueuedPackets++;
     m_stats.nTotalEnqueuedBytes += item->GetSize();
+    if (m_trackArrivals)
+    {
+        m_arrivals.push_back(Simulator::Now());
+    }
 
     NS_LOG_LOGIC("m_traceEnqueue (p)");
     m_traceEnqueue(item);
@@ -708,6 +899,11 @@ QueueDisc::PacketDequeued(Ptr<const QueueDiscItem> item)
         m_nBytes -= item->GetSize();
         m_stats.nTotalDequeuedPackets++;
         m_stats.nTotalDequeuedBytes += item->GetSize();
+        if (m_trackArrivals)
+        {
+            NS_ASSERT(!m_arrivals.empty());
+            m_arrivals.pop_front();
+        }
 
         m_sojourn(Simulator::Now() - item->GetTimeStamp());
 
@@ -717,7 +913,7 @@ QueueDisc::PacketDequeued(Ptr<const QueueDiscItem> item)
 }
 
 void
-QueueDisc::DropBeforeEnqueue(Ptr<const QueueDiscItem> item, const char* reason)
+QueueDisc::DropBeforeEnqueue(Ptr<const QueueDiscItem> item, ReasonId reason)
 {
     NS_LOG_FUNCTION(this << item << reason);
 
@@ -726,37 +922,28 @@ QueueDisc::DropBeforeEnqueue(Ptr<const QueueDiscItem> item, const char* reason)
     m_stats.nTotalDroppedPacketsBeforeEnqueue++;
     m_stats.nTotalDroppedBytesBeforeEnqueue += item->GetSize();
 
-    // update the number of packets dropped for the given reason
-    auto itp = m_stats.nDroppedPacketsBeforeEnqueue.find(reason);
-    if (itp != m_stats.nDroppedPacketsBeforeEnqueue.end())
-    {
-        itp->second++;
-    }
-    else
-    {
-        m_stats.nDroppedPacketsBeforeEnqueue[reason] = 1;
-    }
-    // update the amount of bytes dropped for the given reason
-    auto itb = m_stats.nDroppedBytesBeforeEnqueue.find(reason);
-    if (itb != m_stats.nDroppedBytesBeforeEnqueue.end())
-    {
-        itb->second += item->GetSize();
-    }
-    else
-    {
-        m_stats.nDroppedBytesBeforeEnqueue[reason] = item->GetSize();
-    }
+    // update the number of packets and the amount of bytes dropped for the given reason
+    ReasonCounters& counters = GetReasonCounters(reason);
+    counters.droppedPacketsBeforeEnqueue++;
+    counters.droppedBytesBeforeEnqueue += item->GetSize();
 
     NS_LOG_DEBUG("Total packets/bytes dropped before enqueue: "
                  << m_stats.nTotalDroppedPacketsBeforeEnqueue << " / "
                  << m_stats.nTotalDroppedBytesBeforeEnqueue);
     NS_LOG_LOGIC("m_traceDropBeforeEnqueue (p)");
     m_traceDrop(item);
-    m_traceDropBeforeEnqueue(item, reason);
+    m_traceDropBeforeEnqueue(item, GetReasonString(reason).c_str());
+    m_traceDropBeforeEnqueueReason(item, reason);
 }
 
 void
-QueueDisc::DropAfterDequeue(Ptr<const QueueDiscItem> item, const char* reason)
+QueueDisc::DropBeforeEnqueue(Ptr<const QueueDiscItem> item, const char* reason)
+{
+    DropBeforeEnqueue(item, RegisterReason(reason));
+}
+
+void
+QueueDisc::DropAfterDequeue(Ptr<const QueueDiscItem> item, ReasonId reason)
 {
     NS_LOG_FUNCTION(this << item << reason);
 
@@ -765,26 +952,10 @@ QueueDisc::DropAfterDequeue(Ptr<const QueueDiscItem> item, const char* reason)
     m_stats.nTotalDroppedPacketsAfterDequeue++;
     m_stats.nTotalDroppedBytesAfterDequeue += item->GetSize();
 
-    // update the number of packets dropped for the given reason
-    auto itp = m_stats.nDroppedPacketsAfterDequeue.find(reason);
-    if (itp != m_stats.nDroppedPacketsAfterDequeue.end())
-    {
-        itp->second++;
-    }
-    else
-    {
-        m_stats.nDroppedPacketsAfterDequeue[reason] = 1;
-    }
-    // update the amount of bytes dropped for the given reason
-    auto itb = m_stats.nDroppedBytesAfterDequeue.find(reason);
-    if (itb != m_stats.nDroppedBytesAfterDequeue.end())
-    {
-        itb->second += item->GetSize();
-    }
-    else
-    {
-        m_stats.nDroppedBytesAfterDequeue[reason] = item->GetSize();
-    }
+    // update the number of packets and the amount of bytes dropped for the given reason
+    ReasonCounters& counters = GetReasonCounters(reason);
+    counters.droppedPacketsAfterDequeue++;
+    counters.droppedBytesAfterDequeue += item->GetSize();
 
     // if in the context of a peek request a dequeued packet is dropped, we need
     // to update the statistics and fire the dequeue trace before firing the drop
@@ -802,11 +973,18 @@ QueueDisc::DropAfterDequeue(Ptr<const QueueDiscItem> item, const char* reason)
                  << m_stats.nTotalDroppedBytesAfterDequeue);
     NS_LOG_LOGIC("m_traceDropAfterDequeue (p)");
     m_traceDrop(item);
-    m_traceDropAfterDequeue(item, reason);
+    m_traceDropAfterDequeue(item, GetReasonString(reason).c_str());
+    m_traceDropAfterDequeueReason(item, reason);
+}
+
+void
+QueueDisc::DropAfterDequeue(Ptr<const QueueDiscItem> item, const char* reason)
+{
+    DropAfterDequeue(item, RegisterReason(reason));
 }
 
 bool
-QueueDisc::Mark(Ptr<QueueDiscItem> item, const char* reason)
+QueueDisc::Mark(Ptr<QueueDiscItem> item, ReasonId reason)
 {
     NS_LOG_FUNCTION(this << item << reason);
 
@@ -820,33 +998,24 @@ QueueDisc::Mark(Ptr<QueueDiscItem> item, const char* reason)
     m_stats.nTotalMarkedPackets++;
     m_stats.nTotalMarkedBytes += item->GetSize();
 
-    // update the number of packets marked for the given reason
-    auto itp = m_stats.nMarkedPackets.find(reason);
-    if (itp != m_stats.nMarkedPackets.end())
-    {
-        itp->second++;
-    }
-    else
-    {
-        m_stats.nMarkedPackets[reason] = 1;
-    }
-    // update the amount of bytes marked for the given reason
-    auto itb = m_stats.nMarkedBytes.find(reason);
-    if (itb != m_stats.nMarkedBytes.end())
-    {
-        itb->second += item->GetSize();
-    }
-    else
-    {
-        m_stats.nMarkedBytes[reason] = item->GetSize();
-    }
+    // update the number of packets and the amount of bytes marked for the given reason
+    ReasonCounters& counters = GetReasonCounters(reason);
+    counters.markedPackets++;
+    counters.markedBytes += item->GetSize();
 
     NS_LOG_DEBUG("Total packets/bytes marked: " << m_stats.nTotalMarkedPackets << " / "
                                                 << m_stats.nTotalMarkedBytes);
-    m_traceMark(item, reason);
+    m_traceMark(item, GetReasonString(reason).c_str());
+    m_traceMarkReason(item, reason);
     return true;
 }
 
+bool
+QueueDisc::Mark(Ptr<QueueDiscItem> item, const char* reason)
+{
+    return Mark(item, RegisterReason(reason));
+}
+
 bool
 QueueDisc::Enqueue(Ptr<QueueDiscItem> item)
 {
@@ -855,6 +1024,14 @@ QueueDisc::Enqueue(Ptr<QueueDiscItem> item)
     m_stats.nTotalReceivedPackets++;
     m_stats.nTotalReceivedBytes += item->GetSize();
 
+    if (m_externalDropProbability > 0 &&
+        m_externalLoadRng->GetValue() < m_externalDropProbability)
+    {
+        static const ReasonId externalLoadDrop = RegisterReason(EXTERNAL_LOAD_DROP);
+        DropBeforeEnqueue(item, externalLoadDrop);
+        return false;
+    }
+
     bool retval = DoEnqueue(item);
 
     if (retval)
@@ -949,14 +1126,15 @@ QueueDisc::Run()
     if (RunBegin())
     {
         uint32_t quota = m_quota;
-        while (Restart())
+        uint32_t packets = 0;
+        while (Restart(packets))
         {
-            quota -= 1;
-            if (quota <= 0)
+            if (packets >= quota)
             {
                 /// \todo netif_schedule (q);
                 break;
             }
+            quota -= packets;
         }
         RunEnd();
     }
@@ -983,9 +1161,15 @@ QueueDisc::RunEnd()
 }
 
 bool
-QueueDisc::Restart()
+QueueDisc::Restart(uint32_t& packets)
 {
     NS_LOG_FUNCTION(this);
+
+    if (IsHeadHeld())
+    {
+        return false;
+    }
+
     Ptr<QueueDiscItem> item = DequeuePacket();
     if (!item)
     {
@@ -993,9 +1177,47 @@ QueueDisc::Restart()
         return false;
     }
 
+    packets = 1;
+    if (m_bulkDequeue && m_sendBurst)
+    {
+        return TransmitBulk(item, packets);
+    }
     return Transmit(item);
 }
 
+bool
+QueueDisc::IsHeadHeld()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_externalDelay.IsStrictlyPositive())
+    {
+        return false;
+    }
+
+    // A requeued packet already left the queue disc once
+    if ((m_requeued && !m_peeked) || m_arrivals.empty())
+    {
+        return false;
+    }
+
+    // Hold the next packet until the oldest packet spent the delay of the external
+    // load in the queue disc. The decision is taken from the recorded arrival times
+    // rather than by peeking at the head, which would make the queue disc dequeue
+    // the head (and possibly drop or mark it) ahead of time.
+    Time release = m_arrivals.front() + m_externalDelay;
+    if (release <= Simulator::Now())
+    {
+        return false;
+    }
+    if (!m_externalLoadEvent.IsPending())
+    {
+        m_externalLoadEvent =
+            Simulator::Schedule(release - Simulator::Now(), &QueueDisc::Run, this);
+    }
+    return true;
+}
+
 Ptr<QueueDiscItem>
 QueueDisc::DequeuePacket()
 {
@@ -1018,9 +1240,11 @@ QueueDisc::DequeuePacket()
             {
                 // If the packet was requeued because a peek operation was requested
                 // we need to explicitly call PacketDequeued to update statistics
-                // about dequeued packets and fire the dequeue trace.
+                // about dequeued packets and fire the dequeue trace. Such a packet
+                // was dequeued by DoPeek, which did not add its header.
                 m_peeked = false;
                 PacketDequeued(item);
+                item->AddHeader();
             }
         }
     }
@@ -1105,4 +1329,63 @@ QueueDisc::Transmit(Ptr<QueueDiscItem> item)
         (m_devQueueIface && m_devQueueIface->GetTxQueue(item->GetTxQueueIndex())->IsStopped()));
 }
 
+bool
+QueueDisc::TransmitBulk(Ptr<QueueDiscItem> item, uint32_t& packets)
+{
+    NS_LOG_FUNCTION(this << item);
+
+    std::size_t txq = item->GetTxQueueIndex();
+    Ptr<NetDeviceQueue> devQueue = m_devQueueIface ? m_devQueueIface->GetTxQueue(txq) : nullptr;
+    Ptr<QueueLimits> queueLimits = devQueue ? devQueue->GetQueueLimits() : nullptr;
+
+    // without queue limits, the room left in the device queue is unknown, hence
+    // packets are sent one at a time until the device queue is stopped
+    if (!queueLimits || devQueue->IsStopped())
+    {
+        return Transmit(item);
+    }
+
+    // dequeue packets as long as the queue limits accept bytes. As in Linux, the
+    // last packet may exceed the limit, which then stops the device queue
+    m_burst.push_back(item);
+    int64_t budget = static_cast<int64_t>(queueLimits->Available()) - item->GetSize();
+    while (budget > 0 && !IsHeadHeld())
+    {
+        Ptr<QueueDiscItem> next = DequeuePacket();
+        if (!next)
+        {
+            break;
+        }
+        if (next->GetTxQueueIndex() != txq)
+        {
+            // keep the packet for the next dequeue operation, which returns it first.
+            // The packet is not traced as requeued because it was never sent
+            m_requeued = next;
+            break;
+        }
+        budget -= next->GetSize();
+        m_burst.push_back(next);
+    }
+
+    // a single queue device makes no use of the priority tag
+    if (m_devQueueIface->GetNTxQueues() == 1)
+    {
+        for (const auto& burstItem : m_burst)
+        {
+            SocketPriorityTag priorityTag;
+            burstItem->GetPacket()->RemovePacketTag(priorityTag);
+        }
+    }
+
+    NS_LOG_LOGIC("Send a burst of " << m_burst.size() << " packets");
+    packets = m_burst.size();
+    m_sendBurst(m_burst);
+    m_burst.clear();
+
+    // as in Transmit, packets sent to the netdevice are assumed to be consumed.
+    // A packet kept for another transmission queue is served by the next restart,
+    // since no stop or wake event of its queue would run the queue disc again
+    return m_requeued || !(GetNPackets() == 0 || devQueue->IsStopped());
+}
+
 } // namespace ns3
@@ -21,6 +21,8 @@
 
 #include "packet-filter.h"
 
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
 #include "ns3/object.h"
 #include "ns3/queue-fwd.h"
 #include "ns3/queue-item.h"
@@ -28,6 +30,7 @@
 #include "ns3/traced-callback.h"
 #include "ns3/traced-value.h"
 
+#include <deque>
 #include <functional>
 #include <map>
 #include <string>
@@ -38,6 +41,7 @@ namespace ns3
 
 class QueueDisc;
 class NetDeviceQueueInterface;
+class UniformRandomVariable;
 
 /**
  * \ingroup traffic-control
@@ -151,6 +155,12 @@ enum QueueDiscSizePolicy
  * is room for another packet in its transmission queue, but the transmission queue
  * is stopped. Waking a queue disc is equivalent to make it run.
  *
+ * If the BulkDequeue attribute is set and the transmission queue of the netdevice
+ * has queue limits (e.g., DynamicQueueLimits), each dequeue operation of a run
+ * dequeues as many packets destined to that transmission queue as the queue limits
+ * accept and hands them to the netdevice at once, through the send burst callback,
+ * as Linux does when the device supports BQL.
+ *
  * Every queue disc collects statistics about the total number of packets/bytes
  * received from the upper layers (in case of root queue disc) or from the parent
  * queue disc (in case of child queue disc), enqueued, dequeued, requeued, dropped,
@@ -183,6 +193,15 @@ enum QueueDiscSizePolicy
 class QueueDisc : public Object
 {
   public:
+    /**
+     * Identifier of a reason for dropping or marking packets.
+     *
+     * Each reason string is interned once by RegisterReason, typically when the
+     * library defining the queue disc type is loaded, so that the per-reason
+     * counters and traces do not handle strings for each dropped or marked packet.
+     */
+    typedef uint32_t ReasonId;
+
     /// \brief Structure that keeps the queue disc statistics
     struct Stats
     {
@@ -206,21 +225,21 @@ class QueueDisc : public Object
         uint32_t nTotalDroppedPackets;
         /// Total packets dropped before enqueue
         uint32_t nTotalDroppedPacketsBeforeEnqueue;
-        /// Packets dropped before enqueue, for each reason
+        /// Packets dropped before enqueue, per reason -- not kept up to date, call GetStats first
         std::map<std::string, uint32_t, std::less<>> nDroppedPacketsBeforeEnqueue;
         /// Total packets dropped after dequeue
         uint32_t nTotalDroppedPacketsAfterDequeue;
-        /// Packets dropped after dequeue, for each reason
+        /// Packets dropped after dequeue, per reason -- not kept up to date, call GetStats first
         std::map<std::string, uint32_t, std::less<>> nDroppedPacketsAfterDequeue;
         /// Total dropped bytes
         uint64_t nTotalDroppedBytes;
         /// Total bytes dropped before enqueue
         uint64_t nTotalDroppedBytesBeforeEnqueue;
-        /// Bytes dropped before enqueue, for each reason
+        /// Bytes dropped before enqueue, per reason -- not kept up to date, call GetStats first
         std::map<std::string, uint64_t, std::less<>> nDroppedBytesBeforeEnqueue;
         /// Total bytes dropped after dequeue
         uint64_t nTotalDroppedBytesAfterDequeue;
-        /// Bytes dropped after dequeue, for each reason
+        /// Bytes dropped after dequeue, per reason -- not kept up to date, call GetStats first
         std::map<std::string, uint64_t, std::less<>> nDroppedBytesAfterDequeue;
         /// Total requeued packets
         uint32_t nTotalRequeuedPackets;
@@ -228,11 +247,11 @@ class QueueDisc : public Object
         uint64_t nTotalRequeuedBytes;
         /// Total marked packets
         uint32_t nTotalMarkedPackets;
-        /// Marked packets, for each reason
+        /// Marked packets, per reason -- not kept up to date, call GetStats first
         std::map<std::string, uint32_t, std::less<>> nMarkedPackets;
         /// Total marked bytes
         uint32_t nTotalMarkedBytes;
-        /// Marked bytes, for each reason
+        /// Marked bytes, per reason -- not kept up to date, call GetStats first
         std::map<std::string, uint64_t, std::less<>> nMarkedBytes;
 
         /// constructor
@@ -378,6 +397,23 @@ class QueueDisc : public Object
      */
     SendCallback GetSendCallback() const;
 
+    /// Callback invoked to send a burst of packets to the receiving object when Run is called
+    typedef std::function<void(const std::vector<Ptr<QueueDiscItem>>&)> SendBurstCallback;
+
+    /**
+     * \param func the callback to send a burst of packets to the receiving object.
+     *
+     * Set the callback used by the Run method to send the packets dequeued at
+     * once when bulk dequeue is enabled. If no such callback is set, packets
+     * are dequeued and sent one at a time.
+     */
+    void SetSendBurstCallback(SendBurstCallback func);
+
+    /**
+     * \return the callback to send a burst of packets to the receiving object.
+     */
+    SendBurstCallback GetSendBurstCallback() const;
+
     /**
      * \brief Set the maximum number of dequeue operations following a packet enqueue
      * \param quota the maximum number of dequeue operations following a packet enqueue.
@@ -518,6 +554,24 @@ class QueueDisc : public Object
      */
     virtual WakeMode GetWakeMode() const;
 
+    /**
+     * \brief Impose the loss and the queueing delay caused by traffic that is not
+     *        simulated at the packet level
+     *
+     * Packets are dropped before enqueue with the given probability, and the
+     * queue disc sends no more packets to the device than it received at least
+     * the given delay earlier, i.e., for a FIFO queue disc, the packet at the
+     * head is not sent before it spent the given delay in the queue disc. The
+     * packets already in the queue disc when a delay is first set are not held.
+     * This is meant to be called on root queue discs, typically by a fluid model
+     * of the background traffic. Both values set to zero (the default) disable
+     * the external load.
+     *
+     * \param dropProbability the probability of dropping a packet
+     * \param delay the minimum time spent by a packet in the queue disc
+     */
+    void SetExternalLoad(double dropProbability, Time delay);
+
     // Reasons for dropping packets
     static constexpr const char* INTERNAL_QUEUE_DROP =
         "Dropped by internal queue"; //!< Packet dropped by an internal queue
@@ -525,6 +579,35 @@ class QueueDisc : public Object
         "(Dropped by child queue disc) "; //!< Packet dropped by a child queue disc
     static constexpr const char* CHILD_QUEUE_DISC_MARK =
         "(Marked by child queue disc) "; //!< Packet marked by a child queue disc
+    static constexpr const char* EXTERNAL_LOAD_DROP =
+        "Dropped by external load"; //!< Packet dropped to impose the loss of an external load
+
+    /**
+     * \brief Intern a reason for dropping or marking packets
+     *
+     * Registering the same reason again returns the same identifier. Reasons are
+     * shared by all the queue disc types and never unregistered.
+     *
+     * \param reason the reason
+     * \return the identifier of the reason
+     */
+    static ReasonId RegisterReason(const std::string& reason);
+
+    /**
+     * \brief Get the reason identified by the given identifier
+     * \param id the identifier returned by RegisterReason
+     * \return the reason, which stays valid until the end of the program
+     */
+    static const std::string& GetReasonString(ReasonId id);
+
+    /**
+     * TracedCallback signature for packets dropped or marked for a reason
+     * identified by its ReasonId.
+     *
+     * \param [in] item The queue disc item.
+     * \param [in] reason The identifier of the reason.
+     */
+    typedef void (*ReasonTracedCallback)(Ptr<const QueueDiscItem> item, ReasonId reason);
 
   protected:
     /**
@@ -543,6 +626,24 @@ class QueueDisc : public Object
      */
     void DoInitialize() override;
 
+    /**
+     * \brief Perform the actions required when the queue disc is notified of
+     *        a packet enqueue
+     * \param item item that was enqueued
+     * This method is called by the internal queues and the child queue discs,
+     * and must be called by subclasses that store packets by themselves
+     */
+    void PacketEnqueued(Ptr<const QueueDiscItem> item);
+
+    /**
+     * \brief Perform the actions required when the queue disc is notified of
+     *        a packet dequeue
+     * \param item item that was dequeued
+     * This method is called by the internal queues and the child queue discs,
+     * and must be called by subclasses that store packets by themselves
+     */
+    void PacketDequeued(Ptr<const QueueDiscItem> item);
+
     /**
      * \brief Perform the actions required when the queue disc is notified of
      *        a packet dropped before enqueue
@@ -551,6 +652,18 @@ class QueueDisc : public Object
      * This method must be called by subclasses to record that a packet was
      * dropped before enqueue for the specified reason
      */
+    void DropBeforeEnqueue(Ptr<const QueueDiscItem> item, ReasonId reason);
+
+    /**
+     * \brief Perform the actions required when the queue disc is notified of
+     *        a packet dropped before enqueue
+     *
+     * The reason is interned by each call, hence subclasses should rather
+     * register their reasons once and pass their identifier.
+     *
+     * \param item item that was dropped
+     * \param reason the reason why the item was dropped
+     */
     void DropBeforeEnqueue(Ptr<const QueueDiscItem> item, const char* reason);
 
     /**
@@ -561,6 +674,18 @@ class QueueDisc : public Object
      * This method must be called by subclasses to record that a packet was
      * dropped after dequeue for the specified reason
      */
+    void DropAfterDequeue(Ptr<const QueueDiscItem> item, ReasonId reason);
+
+    /**
+     * \brief Perform the actions required when the queue disc is notified of
+     *        a packet dropped after dequeue
+     *
+     * The reason is interned by each call, hence subclasses should rather
+     * register their reasons once and pass their identifier.
+     *
+     * \param item item that was dropped
+     * \param reason the reason why the item was dropped
+     */
     void DropAfterDequeue(Ptr<const QueueDiscItem> item, const char* reason);
 
     /**
@@ -570,6 +695,19 @@ class QueueDisc : public Object
      * \param reason the reason why the item has to be marked
      * \return true if the item was successfully marked, false otherwise
      */
+    bool Mark(Ptr<QueueDiscItem> item, ReasonId reason);
+
+    /**
+     * \brief Marks the given packet and, if successful, updates the counters
+     *        associated with the given reason
+     *
+     * The reason is interned by each call, hence subclasses should rather
+     * register their reasons once and pass their identifier.
+     *
+     * \param item item that has to be marked
+     * \param reason the reason why the item has to be marked
+     * \return true if the item was successfully marked, false otherwise
+     */
     bool Mark(Ptr<QueueDiscItem> item, const char* reason);
 
   private:
@@ -643,10 +781,20 @@ class QueueDisc : public Object
 
     /**
      * Modelled after the Linux function qdisc_restart (net/sched/sch_generic.c)
-     * Dequeue a packet (by calling DequeuePacket) and send it to the device (by calling Transmit).
-     * \return true if a packet is successfully sent to the device.
+     * Dequeue a packet (by calling DequeuePacket) and send it to the device (by calling
+     * Transmit), or dequeue and send a burst of packets (by calling TransmitBulk).
+     * \param [out] packets the number of packets dequeued
+     * \return true if the packets are successfully sent to the device.
      */
-    bool Restart();
+    bool Restart(uint32_t& packets);
+
+    /**
+     * Check whether the next packet has to be held until the oldest packet of
+     * the queue disc spent the delay of the external load in it, and if so
+     * schedule a run of the queue disc at the end of the delay.
+     * \return true if the next packet has to be held
+     */
+    bool IsHeadHeld();
 
     /**
      * Modelled after the Linux function dequeue_skb (net/sched/sch_generic.c)
@@ -671,18 +819,35 @@ class QueueDisc : public Object
     bool Transmit(Ptr<QueueDiscItem> item);
 
     /**
-     * \brief Perform the actions required when the queue disc is notified of
-     *        a packet enqueue
-     * \param item item that was enqueued
+     * Modelled after the Linux function try_bulk_dequeue_skb (net/sched/sch_generic.c)
+     * Dequeue the packets destined to the same transmission queue as the given packet
+     * as long as the queue limits of the transmission queue accept bytes, then send
+     * all of them to the device at once. Falls back to Transmit if the transmission
+     * queue has no queue limits.
+     * \param item the first packet, already dequeued
+     * \param [out] packets the number of packets sent
+     * \return true if the device queue is not stopped and the queue disc is not empty,
+     *         or if a packet destined to another transmission queue is waiting
      */
-    void PacketEnqueued(Ptr<const QueueDiscItem> item);
+    bool TransmitBulk(Ptr<QueueDiscItem> item, uint32_t& packets);
+
+    /// \brief Packets and bytes dropped or marked for a reason
+    struct ReasonCounters
+    {
+        uint32_t droppedPacketsBeforeEnqueue{0}; //!< Packets dropped before enqueue
+        uint64_t droppedBytesBeforeEnqueue{0};   //!< Bytes dropped before enqueue
+        uint32_t droppedPacketsAfterDequeue{0};  //!< Packets dropped after dequeue
+        uint64_t droppedBytesAfterDequeue{0};    //!< Bytes dropped after dequeue
+        uint32_t markedPackets{0};               //!< Marked packets
+        uint64_t markedBytes{0};                 //!< Marked bytes
+    };
 
     /**
-     * \brief Perform the actions required when the queue disc is notified of
-     *        a packet dequeue
-     * \param item item that was dequeued
+     * \brief Get the counters of the given reason, creating them if needed
+     * \param reason the identifier of the reason
+     * \return the counters of the reason
      */
-    void PacketDequeued(Ptr<const QueueDiscItem> item);
+    ReasonCounters& GetReasonCounters(ReasonId reason);
 
     /// Default quota (as in /proc/sys/net/core/dev_weight)
     static const uint32_t DEFAULT_QUOTA = 64;
@@ -697,16 +862,24 @@ class QueueDisc : public Object
     QueueSize m_maxSize;              //!< max queue size
 
     Stats m_stats;    //!< The collected statistics
+    std::vector<ReasonCounters> m_reasonCounters; //!< Counters indexed by reason identifier
     uint32_t m_quota; //!< Maximum number of packets dequeued in a qdisc run
     Ptr<NetDeviceQueueInterface> m_devQueueIface; //!< NetDevice queue interface
     SendCallback m_send;           //!< Callback used to send a packet to the receiving object
+    SendBurstCallback m_sendBurst; //!< Callback used to send a burst of packets
+    bool m_bulkDequeue;            //!< Dequeue bursts up to the queue limits of the device
+    std::vector<Ptr<QueueDiscItem>> m_burst; //!< Packets of the burst being dequeued
     bool m_running;                //!< The queue disc is performing multiple dequeue operations
     Ptr<QueueDiscItem> m_requeued; //!< The last packet that failed to be transmitted
     bool m_peeked;                 //!< A packet was dequeued because Peek was called
-    std::string m_childQueueDiscDropMsg; //!< Reason why a packet was dropped by a child queue disc
-    std::string m_childQueueDiscMarkMsg; //!< Reason why a packet was marked by a child queue disc
     QueueDiscSizePolicy m_sizePolicy;    //!< The queue disc size policy
     bool m_prohibitChangeMode;           //!< True if changing mode is prohibited
+    double m_externalDropProbability{0}; //!< Probability of dropping a packet (external load)
+    Time m_externalDelay;                //!< Minimum time spent in the queue disc (external load)
+    Ptr<UniformRandomVariable> m_externalLoadRng; //!< Random variable for the external drops
+    EventId m_externalLoadEvent; //!< Run the queue disc when the head packet spent the delay
+    bool m_trackArrivals{false}; //!< Whether the arrival times of the packets are recorded
+    std::deque<Time> m_arrivals; //!< Arrival times of the packets in the queue disc, in order
 
     /// Traced callback: fired when a packet is enqueued
     TracedCallback<Ptr<const QueueDiscItem>> m_traceEnqueue;
@@ -722,13 +895,19 @@ class QueueDisc : public Object
     TracedCallback<Ptr<const QueueDiscItem>, const char*> m_traceDropAfterDequeue;
     /// Traced callback: fired when a packet is marked
     TracedCallback<Ptr<const QueueDiscItem>, const char*> m_traceMark;
+    /// Traced callback: fired when a packet is dropped before enqueue, with the reason identifier
+    TracedCallback<Ptr<const QueueDiscItem>, ReasonId> m_traceDropBeforeEnqueueReason;
+    /// Traced callback: fired when a packet is dropped after dequeue, with the reason identifier
+    TracedCallback<Ptr<const QueueDiscItem>, ReasonId> m_traceDropAfterDequeueReason;
+    /// Traced callback: fired when a packet is marked, with the reason identifier
+    TracedCallback<Ptr<const QueueDiscItem>, ReasonId> m_traceMarkReason;
 
     /// Type for the function objects notifying that a packet has been dropped by an internal queue
     typedef std::function<void(Ptr<const QueueDiscItem>)> InternalQueueDropFunctor;
     /// Type for the function objects notifying that a packet has been dropped by a child queue disc
-    typedef std::function<void(Ptr<const QueueDiscItem>, const char*)> ChildQueueDiscDropFunctor;
+    typedef std::function<void(Ptr<const QueueDiscItem>, ReasonId)> ChildQueueDiscDropFunctor;
     /// Type for the function objects notifying that a packet has been marked by a child queue disc
-    typedef std::function<void(Ptr<const QueueDiscItem>, const char*)> ChildQueueDiscMarkFunctor;
+    typedef std::function<void(Ptr<const QueueDiscItem>, ReasonId)> ChildQueueDiscMarkFunctor;
 
     /// Function object called when an internal queue dropped a packet before enqueue
     InternalQueueDropFunctor m_internalQueueDbeFunctor;
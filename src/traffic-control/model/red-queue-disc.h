@@ -199,6 +199,11 @@ class RedQueueDisc : public QueueDisc
     // Reasons for marking packets
     static constexpr const char* UNFORCED_MARK = "Unforced mark"; //!< Early probability marks
     static constexpr const char* FORCED_MARK = "Forced mark"; //!< Forced marks, m_qAvg > m_maxTh
+    // Identifiers of the reasons, interned once for this queue disc type
+    static const ReasonId UNFORCED_DROP_ID; //!< Interned UNFORCED_DROP
+    static const ReasonId FORCED_DROP_ID;   //!< Interned FORCED_DROP
+    static const ReasonId UNFORCED_MARK_ID; //!< Interned UNFORCED_MARK
+    static const ReasonId FORCED_MARK_ID;   //!< Interned FORCED_MARK
 
   protected:
     /**
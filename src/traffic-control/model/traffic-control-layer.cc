@@ -23,9 +23,11 @@
 #include "ns3/log.h"
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/object-map.h"
+#include "ns3/packet-burst.h"
 #include "ns3/packet.h"
 #include "ns3/socket.h"
 
+#include <algorithm>
 #include <tuple>
 
 namespace ns3
@@ -35,6 +37,34 @@ NS_LOG_COMPONENT_DEFINE("TrafficControlLayer");
 
 NS_OBJECT_ENSURE_REGISTERED(TrafficControlLayer);
 
+/**
+ * \brief Send a burst of items dequeued by a queue disc to a device
+ *
+ * Consecutive items having the same destination address and protocol are
+ * handed to the device with a single call to NetDevice::SendBurst.
+ *
+ * \param device the device
+ * \param items the items, whose header has already been added
+ */
+static void
+SendItemsToDevice(Ptr<NetDevice> device, const std::vector<Ptr<QueueDiscItem>>& items)
+{
+    std::size_t i = 0;
+    while (i < items.size())
+    {
+        const Address& address = items[i]->GetAddress();
+        uint16_t protocol = items[i]->GetProtocol();
+        Ptr<PacketBurst> burst = CreateObject<PacketBurst>();
+        for (; i < items.size() && items[i]->GetAddress() == address &&
+               items[i]->GetProtocol() == protocol;
+             i++)
+        {
+            burst->AddPacket(items[i]->GetPacket());
+        }
+        device->SendBurst(burst, address, protocol);
+    }
+}
+
 TypeId
 TrafficControlLayer::GetTypeId()
 {
@@ -212,6 +242,9 @@ TrafficControlLayer::ScanDevices()
                 q->SetSendCallback([dev](Ptr<QueueDiscItem> item) {
                     dev->Send(item->GetPacket(), item->GetAddress(), item->GetProtocol());
                 });
+                q->SetSendBurstCallback([dev](const std::vector<Ptr<QueueDiscItem>>& items) {
+                    SendItemsToDevice(dev, items);
+                });
             }
         }
     }
@@ -276,6 +309,7 @@ TrafficControlLayer::DeleteRootQueueDiscOnDevice(Ptr<NetDevice> device)
     {
         q->SetNetDeviceQueueInterface(nullptr);
         q->SetSendCallback(nullptr);
+        q->SetSendBurstCallback(nullptr);
     }
     ndi->second.m_queueDiscsToWake.clear();
 
@@ -420,4 +454,107 @@ TrafficControlLayer::Send(Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
     }
 }
 
+void
+TrafficControlLayer::SendBurst(Ptr<NetDevice> device, const std::vector<Ptr<QueueDiscItem>>& items)
+{
+    NS_LOG_FUNCTION(this << device << items.size());
+
+    NS_LOG_DEBUG("Send burst of " << items.size() << " packets to device " << device);
+
+    Ptr<NetDeviceQueueInterface> devQueueIface;
+    auto ndi = m_netDevices.find(device);
+
+    if (ndi != m_netDevices.end())
+    {
+        devQueueIface = ndi->second.m_ndqi;
+    }
+
+    // determine the transmission queue of the device where each packet will be
+    // enqueued (see Send)
+    std::vector<std::size_t> txqs(items.size(), 0);
+    if (devQueueIface && devQueueIface->GetNTxQueues() > 1)
+    {
+        for (std::size_t i = 0; i < items.size(); i++)
+        {
+            txqs[i] = devQueueIface->GetSelectQueueCallback()(items[i]);
+            NS_ASSERT(txqs[i] < devQueueIface->GetNTxQueues());
+        }
+    }
+
+    if (ndi == m_netDevices.end() || !ndi->second.m_rootQueueDisc)
+    {
+        // The device has no attached queue disc, thus add the header to the packets and
+        // send groups of packets directly to the device. The selected queue is checked
+        // before every packet: the device stops taking the packets of a group once the
+        // queue is stopped, and the packets left are dropped as Send drops them
+        bool singleQueue = !devQueueIface || devQueueIface->GetNTxQueues() == 1;
+        std::size_t i = 0;
+        while (i < items.size())
+        {
+            std::size_t txq = txqs[i];
+            const Address& address = items[i]->GetAddress();
+            uint16_t protocol = items[i]->GetProtocol();
+
+            // a multi-queue device does not know the queue selected for the packets of
+            // a burst, hence it is given one packet at a time
+            std::size_t end = i + 1;
+            while (singleQueue && end < items.size() && items[end]->GetAddress() == address &&
+                   items[end]->GetProtocol() == protocol)
+            {
+                end++;
+            }
+
+            for (std::size_t j = i; j < end; j++)
+            {
+                items[j]->AddHeader();
+                // a single queue device makes no use of the priority tag
+                if (singleQueue)
+                {
+                    SocketPriorityTag priorityTag;
+                    items[j]->GetPacket()->RemovePacketTag(priorityTag);
+                }
+            }
+
+            while (i < end)
+            {
+                if (devQueueIface && devQueueIface->GetTxQueue(txq)->IsStopped())
+                {
+                    m_dropped(items[i++]->GetPacket());
+                    continue;
+                }
+                Ptr<PacketBurst> burst = CreateObject<PacketBurst>();
+                for (std::size_t j = i; j < end; j++)
+                {
+                    burst->AddPacket(items[j]->GetPacket());
+                }
+                uint32_t taken = device->SendBurst(burst, address, protocol);
+                NS_ASSERT_MSG(taken > 0, "The device must take a packet sent to a running queue");
+                i += taken;
+            }
+        }
+        return;
+    }
+
+    // Enqueue all the packets in the queue discs associated with the netdevice queues
+    // selected for them, then try to dequeue packets from each of such queue discs
+    std::vector<Ptr<QueueDisc>> toRun;
+    for (std::size_t i = 0; i < items.size(); i++)
+    {
+        items[i]->SetTxQueueIndex(txqs[i]);
+
+        Ptr<QueueDisc> qDisc = ndi->second.m_queueDiscsToWake[txqs[i]];
+        NS_ASSERT(qDisc);
+        qDisc->Enqueue(items[i]);
+        if (std::find(toRun.begin(), toRun.end(), qDisc) == toRun.end())
+        {
+            toRun.push_back(qDisc);
+        }
+    }
+
+    for (auto& qDisc : toRun)
+    {
+        qDisc->Run();
+    }
+}
+
 } // namespace ns3
@@ -211,6 +211,24 @@ class TrafficControlLayer : public Object
      */
     virtual void Send(Ptr<NetDevice> device, Ptr<QueueDiscItem> item);
 
+    /**
+     * \brief Called from upper layer to queue several packets for the transmission.
+     *
+     * If a queue disc is installed on the device, all the items are enqueued
+     * before the queue disc is run, hence the queue disc is run once per burst
+     * rather than once per packet (and it observes the whole burst as backlog).
+     * Otherwise, consecutive items sharing the same transmission queue,
+     * destination address and protocol are handed to the device in a single
+     * NetDevice::SendBurst call. The state of the device transmission queue is
+     * checked before every item, as Send does: the items left when the queue
+     * gets stopped are dropped. Items for a device with multiple transmission
+     * queues are handed to the device one at a time.
+     *
+     * \param device the device the packets must be sent to
+     * \param items the queue items including the packets and additional information
+     */
+    virtual void SendBurst(Ptr<NetDevice> device, const std::vector<Ptr<QueueDiscItem>>& items);
+
   protected:
     void DoDispose() override;
     void DoInitialize() override;
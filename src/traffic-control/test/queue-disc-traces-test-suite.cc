@@ -25,6 +25,8 @@
 #include "ns3/test.h"
 
 #include <map>
+#include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -583,6 +585,101 @@ QueueDiscTracesTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Queue Disc Reasons Test Case
+ *
+ * This test case checks that the reasons for dropping packets are interned
+ * once, that the drops of the child queue disc are notified to the root queue
+ * disc with the identifier of the prefixed reason, and that the statistics
+ * per reason string are consistent with the reason identifier traces.
+ */
+class QueueDiscReasonsTestCase : public TestCase
+{
+  public:
+    QueueDiscReasonsTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * Record the reason why a packet has been dropped before enqueue
+     * \param item the dropped packet
+     * \param reason the identifier of the reason why the packet was dropped
+     */
+    void PacketDbe(Ptr<const QueueDiscItem> item, QueueDisc::ReasonId reason);
+
+    std::vector<QueueDisc::ReasonId> m_dbeReasons; //!< reasons of the root drops before enqueue
+};
+
+QueueDiscReasonsTestCase::QueueDiscReasonsTestCase()
+    : TestCase("Sanity check on the interned reasons for dropping packets")
+{
+}
+
+void
+QueueDiscReasonsTestCase::PacketDbe(Ptr<const QueueDiscItem> item, QueueDisc::ReasonId reason)
+{
+    m_dbeReasons.push_back(reason);
+}
+
+void
+QueueDiscReasonsTestCase::DoRun()
+{
+    Address dest;
+    uint32_t pktSizeUnit = 100;
+
+    QueueDisc::ReasonId beforeEnqueue =
+        QueueDisc::RegisterReason(TestChildQueueDisc::BEFORE_ENQUEUE);
+    NS_TEST_ASSERT_MSG_EQ(QueueDisc::RegisterReason(TestChildQueueDisc::BEFORE_ENQUEUE),
+                          beforeEnqueue,
+                          "A reason must be interned once");
+    NS_TEST_ASSERT_MSG_NE(QueueDisc::RegisterReason(TestChildQueueDisc::AFTER_DEQUEUE),
+                          beforeEnqueue,
+                          "Different reasons must have different identifiers");
+    NS_TEST_ASSERT_MSG_EQ(QueueDisc::GetReasonString(beforeEnqueue),
+                          TestChildQueueDisc::BEFORE_ENQUEUE,
+                          "The reason string does not match the identifier");
+
+    Ptr<QueueDisc> root = CreateObject<TestParentQueueDisc>();
+    root->Initialize();
+    Ptr<QueueDisc> child = root->GetQueueDiscClass(0)->GetQueueDisc();
+    root->TraceConnectWithoutContext(
+        "DropBeforeEnqueueReason",
+        MakeCallback(&QueueDiscReasonsTestCase::PacketDbe, this));
+
+    // The fifth and the sixth packets are dropped before enqueue by the child queue disc
+    for (uint16_t i = 1; i <= 6; i++)
+    {
+        root->Enqueue(Create<QdTestItem>(Create<Packet>(pktSizeUnit * i), dest));
+    }
+
+    std::string childReason =
+        std::string(QueueDisc::CHILD_QUEUE_DISC_DROP) + TestChildQueueDisc::BEFORE_ENQUEUE;
+    QueueDisc::ReasonId childDrop = QueueDisc::RegisterReason(childReason);
+    NS_TEST_ASSERT_MSG_EQ(m_dbeReasons.size(), 2, "Two drops must have been traced");
+    NS_TEST_ASSERT_MSG_EQ(m_dbeReasons[0], childDrop, "Unexpected reason of the first drop");
+    NS_TEST_ASSERT_MSG_EQ(m_dbeReasons[1], childDrop, "Unexpected reason of the second drop");
+
+    NS_TEST_ASSERT_MSG_EQ(root->GetStats().GetNDroppedPackets(childReason),
+                          2,
+                          "Verify the number of packets dropped by the child queue disc");
+    NS_TEST_ASSERT_MSG_EQ(root->GetStats().GetNDroppedBytes(childReason),
+                          pktSizeUnit * 11,
+                          "Verify the number of bytes dropped by the child queue disc");
+    NS_TEST_ASSERT_MSG_EQ(child->GetStats().GetNDroppedPackets(TestChildQueueDisc::BEFORE_ENQUEUE),
+                          2,
+                          "Verify the number of packets dropped before enqueue");
+    NS_TEST_ASSERT_MSG_EQ(child->GetStats().nDroppedPacketsBeforeEnqueue.size(),
+                          1,
+                          "Packets must have been dropped for a single reason");
+    NS_TEST_ASSERT_MSG_EQ(child->GetStats().GetNDroppedPackets(TestChildQueueDisc::AFTER_DEQUEUE),
+                          0,
+                          "No packet must have been dropped after dequeue");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup traffic-control-test
  *
@@ -595,5 +692,6 @@ static class QueueDiscTracesTestSuite : public TestSuite
         : TestSuite("queue-disc-traces", Type::UNIT)
     {
         AddTestCase(new QueueDiscTracesTestCase(), TestCase::Duration::QUICK);
+        AddTestCase(new QueueDiscReasonsTestCase(), TestCase::Duration::QUICK);
     }
 } g_queueDiscTracesTestSuite; ///< the test suite
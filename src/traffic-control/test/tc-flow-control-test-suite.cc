@@ -18,13 +18,17 @@
  *
  */
 
+#include "ns3/boolean.h"
 #include "ns3/config.h"
 #include "ns3/data-rate.h"
 #include "ns3/double.h"
+#include "ns3/fifo-queue-disc.h"
 #include "ns3/log.h"
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/node-container.h"
 #include "ns3/pointer.h"
+#include "ns3/queue-disc.h"
+#include "ns3/queue-limits.h"
 #include "ns3/queue.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simulator.h"
@@ -36,6 +40,8 @@
 
 #include <algorithm>
 #include <string>
+#include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -492,6 +498,443 @@ TcFlowControlTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Queue limits accepting a fixed amount of bytes
+ */
+class FixedQueueLimits : public QueueLimits
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param limit the amount of bytes accepted
+     */
+    FixedQueueLimits(int32_t limit);
+
+    void Reset() override;
+    void Completed(uint32_t count) override;
+    int32_t Available() const override;
+    void Queued(uint32_t count) override;
+
+  private:
+    int32_t m_limit;  //!< the amount of bytes accepted
+    int32_t m_queued; //!< the amount of bytes queued
+};
+
+FixedQueueLimits::FixedQueueLimits(int32_t limit)
+    : m_limit(limit),
+      m_queued(0)
+{
+}
+
+void
+FixedQueueLimits::Reset()
+{
+    m_queued = 0;
+}
+
+void
+FixedQueueLimits::Completed(uint32_t count)
+{
+    m_queued -= count;
+}
+
+int32_t
+FixedQueueLimits::Available() const
+{
+    return m_limit - m_queued;
+}
+
+void
+FixedQueueLimits::Queued(uint32_t count)
+{
+    m_queued += count;
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Traffic Control Bulk Dequeue Test Case
+ *
+ * Five packets of 1000 bytes are enqueued in a queue disc whose device
+ * transmission queue has queue limits accepting 2500 bytes. The device
+ * reports the bytes of the packets it receives to the queue limits, which
+ * stop the transmission queue after three packets. When the device reports
+ * the transmission of these packets, the queue disc is woken and sends the
+ * last two packets. With bulk dequeue, the packets of each run are sent in a
+ * single burst; otherwise, they are sent one at a time.
+ */
+class TcBulkDequeueTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param bulk whether bulk dequeue is enabled
+     */
+    TcBulkDequeueTestCase(bool bulk);
+
+  private:
+    void DoRun() override;
+    /**
+     * Record a packet sent to the device
+     * \param item the packet
+     */
+    void Send(Ptr<QueueDiscItem> item);
+    /**
+     * Record a burst of packets sent to the device
+     * \param items the packets
+     */
+    void SendBurst(const std::vector<Ptr<QueueDiscItem>>& items);
+
+    bool m_bulk;                       //!< whether bulk dequeue is enabled
+    Ptr<NetDeviceQueue> m_txQueue;     //!< the device transmission queue
+    std::vector<std::size_t> m_bursts; //!< the number of packets sent by each call
+};
+
+TcBulkDequeueTestCase::TcBulkDequeueTestCase(bool bulk)
+    : TestCase(std::string("Test the ") + (bulk ? "bulk" : "single") +
+               " dequeue of packets up to the queue limits"),
+      m_bulk(bulk)
+{
+}
+
+void
+TcBulkDequeueTestCase::Send(Ptr<QueueDiscItem> item)
+{
+    m_txQueue->NotifyQueuedBytes(item->GetSize());
+    m_bursts.push_back(1);
+}
+
+void
+TcBulkDequeueTestCase::SendBurst(const std::vector<Ptr<QueueDiscItem>>& items)
+{
+    for (const auto& item : items)
+    {
+        m_txQueue->NotifyQueuedBytes(item->GetSize());
+    }
+    m_bursts.push_back(items.size());
+}
+
+void
+TcBulkDequeueTestCase::DoRun()
+{
+    Ptr<QueueDisc> qdisc =
+        CreateObjectWithAttributes<FifoQueueDisc>("BulkDequeue", BooleanValue(m_bulk));
+    qdisc->Initialize();
+
+    Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface>();
+    m_txQueue = ndqi->GetTxQueue(0);
+    m_txQueue->SetQueueLimits(CreateObject<FixedQueueLimits>(2500));
+    m_txQueue->SetWakeCallback(MakeCallback(&QueueDisc::Run, qdisc));
+    qdisc->SetNetDeviceQueueInterface(ndqi);
+    qdisc->SetSendCallback([this](Ptr<QueueDiscItem> item) { Send(item); });
+    qdisc->SetSendBurstCallback(
+        [this](const std::vector<Ptr<QueueDiscItem>>& items) { SendBurst(items); });
+
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        qdisc->Enqueue(Create<QueueDiscTestItem>(Create<Packet>(1000)));
+    }
+    qdisc->Run();
+
+    std::vector<std::size_t> expected = m_bulk ? std::vector<std::size_t>{3}
+                                               : std::vector<std::size_t>{1, 1, 1};
+    NS_TEST_EXPECT_MSG_EQ((m_bursts == expected), true, "Unexpected packets sent by the first run");
+    NS_TEST_EXPECT_MSG_EQ(qdisc->GetNPackets(), 2, "Two packets must be left in the queue disc");
+    NS_TEST_EXPECT_MSG_EQ(m_txQueue->IsStopped(),
+                          true,
+                          "The queue limits must have stopped the transmission queue");
+
+    // the transmission of the packets wakes the queue disc
+    m_bursts.clear();
+    m_txQueue->NotifyTransmittedBytes(3000);
+
+    expected = m_bulk ? std::vector<std::size_t>{2} : std::vector<std::size_t>{1, 1};
+    NS_TEST_EXPECT_MSG_EQ((m_bursts == expected), true, "Unexpected packets sent by the wake");
+    NS_TEST_EXPECT_MSG_EQ(qdisc->GetNPackets(), 0, "The queue disc must be empty");
+    NS_TEST_EXPECT_MSG_EQ(qdisc->GetStats().nTotalSentPackets, 5, "Five packets must be sent");
+
+    m_txQueue = nullptr;
+    qdisc->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Traffic Control Bulk Dequeue Multi-Queue Test Case
+ *
+ * Three packets of 1000 bytes are enqueued in a queue disc with bulk dequeue
+ * whose device has two transmission queues, each with queue limits accepting
+ * 2500 bytes: two packets for the first transmission queue, then one for the
+ * second. The burst of the first transmission queue ends when the packet for
+ * the second one is dequeued. That packet must be sent by the same run, since
+ * neither transmission queue is stopped and no event would run the queue disc
+ * again.
+ */
+class TcBulkDequeueMultiQueueTestCase : public TestCase
+{
+  public:
+    TcBulkDequeueMultiQueueTestCase();
+
+  private:
+    void DoRun() override;
+    /**
+     * Record a burst of packets sent to the device
+     * \param items the packets
+     */
+    void SendBurst(const std::vector<Ptr<QueueDiscItem>>& items);
+
+    Ptr<NetDeviceQueueInterface> m_ndqi; //!< the device queue interface
+    /// the transmission queue and the number of packets of each burst
+    std::vector<std::pair<std::size_t, std::size_t>> m_bursts;
+};
+
+TcBulkDequeueMultiQueueTestCase::TcBulkDequeueMultiQueueTestCase()
+    : TestCase("Test the bulk dequeue of packets destined to several transmission queues")
+{
+}
+
+void
+TcBulkDequeueMultiQueueTestCase::SendBurst(const std::vector<Ptr<QueueDiscItem>>& items)
+{
+    std::size_t txq = items.front()->GetTxQueueIndex();
+    for (const auto& item : items)
+    {
+        NS_TEST_EXPECT_MSG_EQ(item->GetTxQueueIndex(),
+                              txq,
+                              "The packets of a burst must share their transmission queue");
+        m_ndqi->GetTxQueue(txq)->NotifyQueuedBytes(item->GetSize());
+    }
+    m_bursts.emplace_back(txq, items.size());
+}
+
+void
+TcBulkDequeueMultiQueueTestCase::DoRun()
+{
+    Ptr<QueueDisc> qdisc =
+        CreateObjectWithAttributes<FifoQueueDisc>("BulkDequeue", BooleanValue(true));
+    qdisc->Initialize();
+
+    m_ndqi = CreateObjectWithAttributes<NetDeviceQueueInterface>("NTxQueues", UintegerValue(2));
+    for (std::size_t i = 0; i < 2; i++)
+    {
+        m_ndqi->GetTxQueue(i)->SetQueueLimits(CreateObject<FixedQueueLimits>(2500));
+        m_ndqi->GetTxQueue(i)->SetWakeCallback(MakeCallback(&QueueDisc::Run, qdisc));
+    }
+    qdisc->SetNetDeviceQueueInterface(m_ndqi);
+    qdisc->SetSendCallback([](Ptr<QueueDiscItem>) {});
+    qdisc->SetSendBurstCallback(
+        [this](const std::vector<Ptr<QueueDiscItem>>& items) { SendBurst(items); });
+
+    for (std::size_t txq : {0, 0, 1})
+    {
+        Ptr<QueueDiscItem> item = Create<QueueDiscTestItem>(Create<Packet>(1000));
+        item->SetTxQueueIndex(txq);
+        qdisc->Enqueue(item);
+    }
+    qdisc->Run();
+
+    std::vector<std::pair<std::size_t, std::size_t>> expected{{0, 2}, {1, 1}};
+    NS_TEST_EXPECT_MSG_EQ((m_bursts == expected), true, "Unexpected packets sent by the run");
+    NS_TEST_EXPECT_MSG_EQ(qdisc->GetNPackets(), 0, "The queue disc must be empty");
+    NS_TEST_EXPECT_MSG_EQ(qdisc->GetStats().nTotalSentPackets, 3, "Three packets must be sent");
+
+    m_ndqi = nullptr;
+    qdisc->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Traffic Control Bulk Dequeue External Load Test Case
+ *
+ * A queue disc with bulk dequeue holds its packets for the 1 ms delay of an
+ * external load. Two packets are enqueued at 0 and 0.5 ms: the first one must
+ * be sent alone at 1 ms, since the second one still has to be held, and the
+ * second one at 1.5 ms.
+ */
+class TcBulkDequeueExternalLoadTestCase : public TestCase
+{
+  public:
+    TcBulkDequeueExternalLoadTestCase();
+
+  private:
+    void DoRun() override;
+    /**
+     * Record a burst of packets sent to the device
+     * \param items the packets
+     */
+    void SendBurst(const std::vector<Ptr<QueueDiscItem>>& items);
+
+    Ptr<NetDeviceQueue> m_txQueue; //!< the device transmission queue
+    /// the time and the number of packets of each burst
+    std::vector<std::pair<Time, std::size_t>> m_bursts;
+};
+
+TcBulkDequeueExternalLoadTestCase::TcBulkDequeueExternalLoadTestCase()
+    : TestCase("Test that the bulk dequeue holds every packet for the delay of the external load")
+{
+}
+
+void
+TcBulkDequeueExternalLoadTestCase::SendBurst(const std::vector<Ptr<QueueDiscItem>>& items)
+{
+    for (const auto& item : items)
+    {
+        m_txQueue->NotifyQueuedBytes(item->GetSize());
+    }
+    m_bursts.emplace_back(Simulator::Now(), items.size());
+}
+
+void
+TcBulkDequeueExternalLoadTestCase::DoRun()
+{
+    Ptr<QueueDisc> qdisc =
+        CreateObjectWithAttributes<FifoQueueDisc>("BulkDequeue", BooleanValue(true));
+    qdisc->Initialize();
+    qdisc->SetExternalLoad(0, MilliSeconds(1));
+
+    Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface>();
+    m_txQueue = ndqi->GetTxQueue(0);
+    m_txQueue->SetQueueLimits(CreateObject<FixedQueueLimits>(10000));
+    qdisc->SetNetDeviceQueueInterface(ndqi);
+    qdisc->SetSendCallback([](Ptr<QueueDiscItem>) {});
+    qdisc->SetSendBurstCallback(
+        [this](const std::vector<Ptr<QueueDiscItem>>& items) { SendBurst(items); });
+
+    for (Time t : {MilliSeconds(0), MicroSeconds(500)})
+    {
+        Simulator::Schedule(t, [qdisc]() {
+            qdisc->Enqueue(Create<QueueDiscTestItem>(Create<Packet>(1000)));
+            qdisc->Run();
+        });
+    }
+    Simulator::Run();
+
+    std::vector<std::pair<Time, std::size_t>> expected{{MilliSeconds(1), 1},
+                                                       {MicroSeconds(1500), 1}};
+    NS_TEST_EXPECT_MSG_EQ((m_bursts == expected), true, "Unexpected bursts sent");
+    NS_TEST_EXPECT_MSG_EQ(qdisc->GetNPackets(), 0, "The queue disc must be empty");
+
+    m_txQueue = nullptr;
+    qdisc->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Traffic Control Burst Without Queue Disc Test Case
+ *
+ * Ten packets are sent to a device with no queue disc and a device queue
+ * of five packets, either one by one or as a single burst. The first packet
+ * is being transmitted when the device queue gets full and stops the
+ * transmission queue: the last four packets must then be dropped by the
+ * traffic control layer in both cases, rather than by the device.
+ */
+class TcBurstNoQueueDiscTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param burst whether the packets are sent as a single burst
+     */
+    TcBurstNoQueueDiscTestCase(bool burst);
+
+  private:
+    void DoRun() override;
+    /**
+     * Send the packets to the device through the traffic control layer
+     * \param dev the device
+     * \param nPackets the number of packets to send
+     */
+    void SendPackets(Ptr<NetDevice> dev, uint32_t nPackets);
+
+    bool m_burst;         //!< whether the packets are sent as a single burst
+    uint32_t m_tcDrops;   //!< the number of packets dropped by the traffic control layer
+    uint32_t m_devDrops;  //!< the number of packets dropped by the device
+    uint32_t m_devQueued; //!< the number of packets in the device queue after the send
+};
+
+TcBurstNoQueueDiscTestCase::TcBurstNoQueueDiscTestCase(bool burst)
+    : TestCase(std::string("Test the flow control of packets sent ") +
+               (burst ? "as a burst" : "one by one") + " to a device without queue disc"),
+      m_burst(burst),
+      m_tcDrops(0),
+      m_devDrops(0),
+      m_devQueued(0)
+{
+}
+
+void
+TcBurstNoQueueDiscTestCase::SendPackets(Ptr<NetDevice> dev, uint32_t nPackets)
+{
+    Ptr<TrafficControlLayer> tc = dev->GetNode()->GetObject<TrafficControlLayer>();
+    std::vector<Ptr<QueueDiscItem>> items;
+    for (uint32_t i = 0; i < nPackets; i++)
+    {
+        items.push_back(Create<QueueDiscTestItem>(Create<Packet>(1000)));
+    }
+    if (m_burst)
+    {
+        tc->SendBurst(dev, items);
+    }
+    else
+    {
+        for (const auto& item : items)
+        {
+            tc->Send(dev, item);
+        }
+    }
+
+    PointerValue ptr;
+    dev->GetAttribute("TxQueue", ptr);
+    m_devQueued = ptr.Get<Queue<Packet>>()->GetNPackets();
+}
+
+void
+TcBurstNoQueueDiscTestCase::DoRun()
+{
+    NodeContainer n;
+    n.Create(2);
+
+    n.Get(0)->AggregateObject(CreateObject<TrafficControlLayer>());
+    n.Get(1)->AggregateObject(CreateObject<TrafficControlLayer>());
+
+    SimpleNetDeviceHelper simple;
+    NetDeviceContainer rxDevC = simple.Install(n.Get(1));
+
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("1Mb/s")));
+    simple.SetQueue("ns3::DropTailQueue", "MaxSize", StringValue("5p"));
+    Ptr<NetDevice> txDev =
+        simple.Install(n.Get(0), DynamicCast<SimpleChannel>(rxDevC.Get(0)->GetChannel())).Get(0);
+    txDev->SetMtu(2500);
+
+    n.Get(0)->GetObject<TrafficControlLayer>()->TraceConnectWithoutContext(
+        "TcDrop",
+        Callback<void, Ptr<const Packet>>([this](Ptr<const Packet>) { m_tcDrops++; }));
+    PointerValue ptr;
+    txDev->GetAttribute("TxQueue", ptr);
+    ptr.Get<Queue<Packet>>()->TraceConnectWithoutContext(
+        "Drop",
+        Callback<void, Ptr<const Packet>>([this](Ptr<const Packet>) { m_devDrops++; }));
+
+    Simulator::Schedule(Seconds(0), &TcBurstNoQueueDiscTestCase::SendPackets, this, txDev, 10);
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_devQueued, 5, "The device queue must be full");
+    NS_TEST_EXPECT_MSG_EQ(m_tcDrops, 4, "The traffic control layer must drop four packets");
+    NS_TEST_EXPECT_MSG_EQ(m_devDrops, 0, "The device must not drop any packet");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup traffic-control-test
  *
@@ -526,5 +969,12 @@ static class TcFlowControlTestSuite : public TestSuite
         // also be made parametric.
         AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::BYTES, 5000, 10),
                     TestCase::Duration::QUICK);
+
+        AddTestCase(new TcBulkDequeueTestCase(true), TestCase::Duration::QUICK);
+        AddTestCase(new TcBulkDequeueTestCase(false), TestCase::Duration::QUICK);
+        AddTestCase(new TcBulkDequeueExternalLoadTestCase, TestCase::Duration::QUICK);
+        AddTestCase(new TcBulkDequeueMultiQueueTestCase, TestCase::Duration::QUICK);
+        AddTestCase(new TcBurstNoQueueDiscTestCase(false), TestCase::Duration::QUICK);
+        AddTestCase(new TcBurstNoQueueDiscTestCase(true), TestCase::Duration::QUICK);
     }
 } g_tcFlowControlTestSuite; ///< the test suite
@@ -0,0 +1,175 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program compares the throughput of the CRC-32 implementations used
+// for Ethernet/Wi-Fi FCS and of the IP checksum computed over a Buffer.
+// Sample usage:  ./ns3 run 'bench-checksum --size=1500 --n=100000'
+
+#include "ns3/buffer.h"
+#include "ns3/command-line.h"
+#include "ns3/crc32.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace ns3;
+
+static uint32_t g_size = 1500;      //!< Size of each checksummed block (bytes)
+static std::vector<uint8_t> g_data; //!< Input data
+static Buffer g_buffer;             //!< Input data, stored in a Buffer
+static volatile uint32_t g_sink;    //!< Prevents the results from being optimized out
+
+/**
+ * Benchmark a CRC-32 implementation.
+ * \param crc the implementation to benchmark
+ * \param n number of blocks to process
+ */
+static void
+benchCrc(uint32_t (*crc)(const uint8_t*, int), uint32_t n)
+{
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        result ^= crc(g_data.data(), g_size);
+    }
+    g_sink = result;
+}
+
+/**
+ * Benchmark the per-byte IP checksum loop formerly used by Buffer::Iterator.
+ * \param n number of blocks to process
+ */
+static void
+benchChecksumBytewise(uint32_t n)
+{
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Buffer::Iterator it = g_buffer.Begin();
+        uint32_t sum = 0;
+        for (uint32_t j = 0; j < g_size / 2; j++)
+        {
+            sum += it.ReadU16();
+        }
+        if (g_size & 1)
+        {
+            sum += it.ReadU8();
+        }
+        while (sum >> 16)
+        {
+            sum = (sum & 0xffff) + (sum >> 16);
+        }
+        result ^= ~sum;
+    }
+    g_sink = result;
+}
+
+/**
+ * Benchmark Buffer::Iterator::CalculateIpChecksum.
+ * \param n number of blocks to process
+ */
+static void
+benchChecksum(uint32_t n)
+{
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        result ^= g_buffer.Begin().CalculateIpChecksum(g_size);
+    }
+    g_sink = result;
+}
+
+/**
+ * Run a benchmark several times and report the best throughput.
+ * \param bench the benchmark to run
+ * \param n number of blocks per run
+ * \param minIterations number of runs
+ * \param name benchmark name
+ */
+template <typename F>
+static void
+runBench(F bench, uint32_t n, uint32_t minIterations, const char* name)
+{
+    uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    for (uint32_t i = 0; i < minIterations; i++)
+    {
+        SystemWallClockMs time;
+        time.Start();
+        bench(n);
+        minDelay = std::min(minDelay, static_cast<uint64_t>(time.End()));
+    }
+    minDelay = std::max<uint64_t>(minDelay, 1);
+    double mbps = static_cast<double>(n) * g_size / 1e6 * 1000 / minDelay;
+    std::cout << mbps << " MB/s"
+              << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 100000;
+    uint32_t minIterations = 3;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark CRC-32 and IP checksum computation");
+    cmd.AddValue("n", "number of blocks per iteration", n);
+    cmd.AddValue("size", "size of each block (bytes)", g_size);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    if (g_size == 0 || g_size > 0xffff)
+    {
+        std::cerr << "Error-- block size must be between 1 and 65535 bytes" << std::endl;
+        exit(1);
+    }
+
+    g_data.resize(g_size);
+    for (uint32_t i = 0; i < g_size; i++)
+    {
+        g_data[i] = static_cast<uint8_t>(i * 7 + 3);
+    }
+    g_buffer.AddAtStart(g_size);
+    g_buffer.Begin().Write(g_data.data(), g_size);
+
+    std::cout << "Running bench-checksum with n=" << n << ", size=" << g_size
+              << ", CLMUL support=" << (CRC32HasClmulSupport() ? "yes" : "no") << std::endl;
+
+    runBench([](uint32_t n) { benchCrc(&CRC32CalculateBytewise, n); },
+             n,
+             minIterations,
+             "CRC-32 bytewise");
+    runBench([](uint32_t n) { benchCrc(&CRC32CalculateSliceBy8, n); },
+             n,
+             minIterations,
+             "CRC-32 slice-by-8");
+    runBench([](uint32_t n) { benchCrc(&CRC32CalculateClmul, n); },
+             n,
+             minIterations,
+             "CRC-32 CLMUL");
+    runBench([](uint32_t n) { benchCrc(&CRC32Calculate, n); },
+             n,
+             minIterations,
+             "CRC-32 dispatched");
+    runBench(&benchChecksumBytewise, n, minIterations, "IP checksum bytewise");
+    runBench(&benchChecksum, n, minIterations, "IP checksum Buffer::Iterator");
+
+    return 0;
+}
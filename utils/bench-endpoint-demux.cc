@@ -0,0 +1,120 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures Ipv4EndPointDemux on a server holding a listening
+// socket and many connected sockets on the same port, as a web server does:
+// the allocation of the endpoints, the lookups of the segments received on
+// the connections and on the listening socket, and the allocation of
+// ephemeral ports by clients.
+// Sample usage:  ./ns3 run 'bench-endpoint-demux --sockets=100000 --lookups=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Print the rate of an operation.
+ * \param phase the name of the operation
+ * \param count the number of operations
+ * \param elapsed the time taken by the operations, in milliseconds
+ */
+static void
+PrintRate(const std::string& phase, uint32_t count, int64_t elapsed)
+{
+    elapsed = std::max<int64_t>(elapsed, 1);
+    std::cout << phase << ":\t" << count * 1000.0 / elapsed << " /s (" << count << " in "
+              << elapsed << " ms)" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t sockets = 100000;
+    uint32_t lookups = 1000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the lookups of Ipv4EndPointDemux with many connected sockets");
+    cmd.AddValue("sockets", "number of connected sockets", sockets);
+    cmd.AddValue("lookups", "number of lookups", lookups);
+    cmd.Parse(argc, argv);
+
+    Ipv4Address server("10.0.0.1");
+    uint16_t serverPort = 80;
+    Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface>();
+
+    // the clients have distinct addresses and ports
+    std::vector<std::pair<Ipv4Address, uint16_t>> peers(sockets);
+    for (uint32_t i = 0; i < sockets; i++)
+    {
+        peers[i] = {Ipv4Address(0x0b000000 + i / 16), static_cast<uint16_t>(49152 + i % 16)};
+    }
+
+    Ipv4EndPointDemux demux;
+    SystemWallClockMs time;
+    time.Start();
+    demux.Allocate(nullptr, server, serverPort);
+    std::vector<Ipv4EndPoint*> endPoints;
+    for (const auto& [address, port] : peers)
+    {
+        endPoints.push_back(demux.Allocate(nullptr, server, serverPort, address, port));
+    }
+    PrintRate("allocate", sockets, time.End());
+
+    std::mt19937 rng(1);
+    uint64_t found = 0;
+    time.Start();
+    for (uint32_t i = 0; i < lookups; i++)
+    {
+        const auto& [address, port] = peers[rng() % sockets];
+        found += demux.Lookup(server, serverPort, address, port, interface).size();
+    }
+    PrintRate("lookup connected", lookups, time.End());
+
+    time.Start();
+    for (uint32_t i = 0; i < lookups; i++)
+    {
+        found += demux.Lookup(server, serverPort, Ipv4Address("12.0.0.1"), i % 65536, interface)
+                     .size();
+    }
+    PrintRate("lookup listening", lookups, time.End());
+
+    time.Start();
+    for (const auto endPoint : endPoints)
+    {
+        demux.DeAllocate(endPoint);
+    }
+    PrintRate("deallocate", sockets, time.End());
+
+    // clients opening connections from ephemeral ports
+    uint32_t ephemeral = std::min<uint32_t>(sockets, 16000);
+    time.Start();
+    for (uint32_t i = 0; i < ephemeral; i++)
+    {
+        demux.Allocate()->SetPeer(server, serverPort);
+    }
+    PrintRate("allocate ephemeral", ephemeral, time.End());
+
+    std::cout << found << " endpoints found" << std::endl;
+    return 0;
+}
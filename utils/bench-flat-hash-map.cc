@@ -0,0 +1,178 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program compares the lookup throughput of std::map, std::unordered_map
+// and ns3::FlatHashMap keyed by Ipv4Address, Ipv6Address and Mac48Address,
+// as used by the ARP and neighbor discovery caches.
+// Sample usage:  ./ns3 run 'bench-flat-hash-map --entries=100000 --lookups=10000000'
+
+#include "ns3/command-line.h"
+#include "ns3/flat-hash-map.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Hash functor using the hash classes already available for addresses.
+ */
+struct LegacyHash
+{
+    /**
+     * \param address the address to hash
+     * \return the hash value
+     */
+    std::size_t operator()(const Ipv4Address& address) const
+    {
+        return Ipv4AddressHash()(address);
+    }
+
+    /**
+     * \param address the address to hash
+     * \return the hash value
+     */
+    std::size_t operator()(const Ipv6Address& address) const
+    {
+        return Ipv6AddressHash()(address);
+    }
+
+    /**
+     * \param address the address to hash
+     * \return the hash value
+     */
+    std::size_t operator()(const Mac48Address& address) const
+    {
+        // no hash class exists for Mac48Address: use the identity, as
+        // std::hash does for integers
+        uint8_t buf[6];
+        address.CopyTo(buf);
+        uint64_t key = 0;
+        for (uint8_t byte : buf)
+        {
+            key = (key << 8) | byte;
+        }
+        return std::hash<uint64_t>()(key);
+    }
+};
+
+/**
+ * Time the lookups of a set of keys in a container.
+ * \tparam Map the container type
+ * \tparam Key the key type
+ * \param keys the keys stored in the container
+ * \param lookups number of lookups to perform
+ * \param name container name
+ */
+template <typename Map, typename Key>
+static void
+BenchLookups(const std::vector<Key>& keys, uint32_t lookups, const char* name)
+{
+    Map map;
+    for (std::size_t i = 0; i < keys.size(); i++)
+    {
+        map[keys[i]] = static_cast<uint32_t>(i);
+    }
+
+    // look up stored keys in a random order, plus one miss out of eight
+    std::mt19937 rng(1);
+    std::vector<std::size_t> order(lookups);
+    for (auto& index : order)
+    {
+        index = rng() % (keys.size() + keys.size() / 8);
+    }
+
+    SystemWallClockMs time;
+    time.Start();
+    uint64_t found = 0;
+    for (auto index : order)
+    {
+        if (index < keys.size())
+        {
+            found += map.find(keys[index])->second;
+        }
+        else
+        {
+            found += (map.find(Key()) == map.end()) ? 0 : 1;
+        }
+    }
+    int64_t elapsed = std::max<int64_t>(time.End(), 1);
+
+    std::cout << lookups * 1000.0 / elapsed << " lookups/s"
+              << " (" << elapsed << " ms elapsed, checksum " << found % 1000 << ")\t" << name
+              << std::endl;
+}
+
+/**
+ * Run the benchmark for all the containers.
+ * \tparam Key the key type
+ * \param keys the keys stored in the containers
+ * \param lookups number of lookups to perform
+ * \param keyName key type name
+ */
+template <typename Key>
+static void
+BenchAll(const std::vector<Key>& keys, uint32_t lookups, std::string keyName)
+{
+    std::cout << keyName << ", " << keys.size() << " entries" << std::endl;
+    BenchLookups<std::map<Key, uint32_t>>(keys, lookups, "std::map");
+    BenchLookups<std::unordered_map<Key, uint32_t, LegacyHash>>(keys,
+                                                                lookups,
+                                                                "std::unordered_map");
+    BenchLookups<FlatHashMap<Key, uint32_t>>(keys, lookups, "ns3::FlatHashMap");
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t entries = 100000;
+    uint32_t lookups = 2000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark address-keyed lookup tables");
+    cmd.AddValue("entries", "number of entries in each table", entries);
+    cmd.AddValue("lookups", "number of lookups", lookups);
+    cmd.Parse(argc, argv);
+
+    // addresses allocated sequentially, as done by the address helpers
+    std::vector<Ipv4Address> ipv4(entries);
+    std::vector<Ipv6Address> ipv6(entries);
+    std::vector<Mac48Address> mac(entries);
+    for (uint32_t i = 0; i < entries; i++)
+    {
+        ipv4[i] = Ipv4Address(0x0a000001 + i);
+        uint8_t buf[16] = {0x20, 0x01, 0x0d, 0xb8};
+        buf[13] = (i + 1) >> 16;
+        buf[14] = (i + 1) >> 8;
+        buf[15] = i + 1;
+        ipv6[i] = Ipv6Address(buf);
+        uint8_t macBuf[6] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+        macBuf[3] = (i + 1) >> 16;
+        macBuf[4] = (i + 1) >> 8;
+        macBuf[5] = i + 1;
+        mac[i].CopyFrom(macBuf);
+    }
+
+    BenchAll(ipv4, lookups, "Ipv4Address");
+    BenchAll(ipv6, lookups, "Ipv6Address");
+    BenchAll(mac, lookups, "Mac48Address");
+
+    return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the overhead of the flow monitor: many UDP flows,
+// each from its own socket, send small datagrams in turn from the first node
+// of a chain of routers to the last one, over point-to-point links fast enough
+// never to queue them. Run it with monitor=false to get the time without flow
+// monitor, and with samplingRate=N to track one packet out of N of each flow.
+// The packet counters of the flow monitor, scaled when sampling, are compared
+// to the actual numbers of packets sent and received.
+// Sample usage:  ./ns3 run 'bench-flow-monitor --flows=1000 --samplingRate=10'
+
+#include "ns3/command-line.h"
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+static std::vector<Ptr<Socket>> g_sockets; //!< The sending sockets, one per flow
+static uint32_t g_size = 0;                //!< Size of the datagrams
+static uint32_t g_sent = 0;                //!< Number of datagrams sent
+static uint32_t g_received = 0;            //!< Number of datagrams received
+
+/**
+ * Send one datagram from each socket of a batch.
+ * \param first the index of the first datagram of the batch
+ * \param count the number of datagrams of the batch
+ */
+static void
+SendDatagrams(uint32_t first, uint32_t count)
+{
+    for (uint32_t i = first; i < first + count; i++)
+    {
+        if (g_sockets[i % g_sockets.size()]->Send(Create<Packet>(g_size)) >= 0)
+        {
+            g_sent++;
+        }
+    }
+}
+
+/**
+ * Read the datagrams received by the receiving socket.
+ * \param socket the receiving socket
+ */
+static void
+ReceiveDatagrams(Ptr<Socket> socket)
+{
+    while (socket->Recv())
+    {
+        g_received++;
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t flows = 1000;
+    uint32_t datagrams = 100000;
+    uint32_t hops = 4;
+    uint32_t batch = 10;
+    uint32_t samplingRate = 1;
+    bool monitor = true;
+    g_size = 64;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the overhead of the flow monitor on UDP flows along a chain of routers");
+    cmd.AddValue("flows", "number of flows", flows);
+    cmd.AddValue("datagrams", "number of datagrams", datagrams);
+    cmd.AddValue("hops", "number of links of the chain", hops);
+    cmd.AddValue("batch", "number of datagrams sent every microsecond", batch);
+    cmd.AddValue("size", "size of the datagrams", g_size);
+    cmd.AddValue("monitor", "whether to install the flow monitor", monitor);
+    cmd.AddValue("samplingRate", "one packet out of samplingRate is tracked", samplingRate);
+    cmd.Parse(argc, argv);
+
+    NodeContainer nodes;
+    nodes.Create(hops + 1);
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(nodes);
+    PointToPointHelper pointToPoint;
+    pointToPoint.SetDeviceAttribute("DataRate", StringValue("100Gbps"));
+    pointToPoint.SetChannelAttribute("Delay", StringValue("10us"));
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.252");
+    Ipv4Address destination;
+    for (uint32_t i = 0; i < hops; i++)
+    {
+        NetDeviceContainer devices = pointToPoint.Install(nodes.Get(i), nodes.Get(i + 1));
+        destination = ipv4.Assign(devices).GetAddress(1);
+        ipv4.NewNetwork();
+    }
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    FlowMonitorHelper flowMonitorHelper;
+    Ptr<FlowMonitor> flowMonitor;
+    if (monitor)
+    {
+        flowMonitorHelper.SetMonitorAttribute("SamplingRate", UintegerValue(samplingRate));
+        flowMonitor = flowMonitorHelper.InstallAll();
+    }
+
+    uint16_t port = 9;
+    Ptr<Socket> receiver = Socket::CreateSocket(nodes.Get(hops), UdpSocketFactory::GetTypeId());
+    receiver->Bind(InetSocketAddress(Ipv4Address::GetAny(), port));
+    receiver->SetRecvCallback(MakeCallback(&ReceiveDatagrams));
+    for (uint32_t i = 0; i < flows; i++)
+    {
+        Ptr<Socket> socket = Socket::CreateSocket(nodes.Get(0), UdpSocketFactory::GetTypeId());
+        socket->Bind();
+        socket->Connect(InetSocketAddress(destination, port));
+        g_sockets.push_back(socket);
+    }
+
+    for (uint32_t i = 0; i < datagrams; i += batch)
+    {
+        Simulator::Schedule(MicroSeconds(i / batch),
+                            &SendDatagrams,
+                            i,
+                            std::min(batch, datagrams - i));
+    }
+    Simulator::Stop(MicroSeconds(datagrams / batch) + MilliSeconds(1));
+
+    SystemWallClockMs wallClock;
+    wallClock.Start();
+    Simulator::Run();
+    int64_t elapsed = std::max<int64_t>(wallClock.End(), 1);
+
+    std::cout << flows << " flows, " << hops << " hops";
+    if (monitor)
+    {
+        uint64_t txPackets = 0;
+        uint64_t rxPackets = 0;
+        for (const auto& [flowId, stats] : flowMonitor->GetFlowStats())
+        {
+            txPackets += stats.txPackets;
+            rxPackets += stats.rxPackets;
+        }
+        std::cout << " (flow monitor, sampling rate " << samplingRate << ": " << txPackets
+                  << " packets sent, " << rxPackets << " received)";
+    }
+    else
+    {
+        std::cout << " (no flow monitor)";
+    }
+    std::cout << ": " << g_sent << " datagrams sent, " << g_received << " received, " << elapsed
+              << " ms (" << g_received * 1000.0 / elapsed << " datagrams/s)" << std::endl;
+
+    g_sockets.clear();
+    Simulator::Destroy();
+    return 0;
+}
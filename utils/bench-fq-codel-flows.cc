@@ -0,0 +1,100 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of the flow queues of FqCoDel with many
+// concurrent flows, with or without lightweight flows: a few packets of each
+// flow are enqueued in turn in a FqCoDel queue disc, which is then drained.
+// Sample usage:  ./ns3 run 'bench-fq-codel-flows --flows=65536 --lightweight=0'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/fq-codel-queue-disc.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/packet.h"
+#include "ns3/queue-size.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t flows = 65536;
+    uint32_t packets = 4;
+    bool lightweight = true;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the flow queues of FqCoDel with many concurrent flows");
+    cmd.AddValue("flows", "number of concurrent flows (and of flow queues)", flows);
+    cmd.AddValue("packets", "number of packets of each flow", packets);
+    cmd.AddValue("lightweight", "enable the lightweight flows", lightweight);
+    cmd.Parse(argc, argv);
+
+    Ptr<FqCoDelQueueDisc> queueDisc = CreateObjectWithAttributes<FqCoDelQueueDisc>(
+        "MaxSize",
+        QueueSizeValue(QueueSize(QueueSizeUnit::PACKETS, flows * packets)),
+        "Flows",
+        UintegerValue(flows),
+        "LightweightFlows",
+        BooleanValue(lightweight));
+    queueDisc->SetQuantum(1514);
+    queueDisc->Initialize();
+
+    Ipv4Header header;
+    header.SetSource(Ipv4Address("10.0.0.1"));
+    header.SetProtocol(17);
+    header.SetPayloadSize(1000);
+    Ptr<Packet> packet = Create<Packet>(1000);
+
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t i = 0; i < packets; i++)
+    {
+        for (uint32_t flow = 0; flow < flows; flow++)
+        {
+            header.SetDestination(Ipv4Address(Ipv4Address("11.0.0.0").Get() + flow));
+            queueDisc->Enqueue(Create<Ipv4QueueDiscItem>(packet, Address(), 0, header));
+        }
+    }
+    int64_t enqueueTime = std::max<int64_t>(time.End(), 1);
+    uint32_t classes = queueDisc->GetNQueueDiscClasses();
+
+    time.Start();
+    uint32_t dequeued = 0;
+    while (queueDisc->Dequeue())
+    {
+        dequeued++;
+    }
+    int64_t dequeueTime = std::max<int64_t>(time.End(), 1);
+
+    std::cout << flows << " flows (" << (lightweight ? "lightweight flows" : "flow classes")
+              << "):\t" << classes << " classes, " << dequeued << " packets dequeued"
+              << std::endl;
+    std::cout << "enqueue:\t" << enqueueTime << " ms ("
+              << static_cast<uint64_t>(flows) * packets * 1000.0 / enqueueTime << " packets/s)"
+              << std::endl;
+    std::cout << "dequeue:\t" << dequeueTime << " ms (" << dequeued * 1000.0 / dequeueTime
+              << " packets/s)" << std::endl;
+
+    queueDisc->Dispose();
+    Simulator::Destroy();
+    return 0;
+}
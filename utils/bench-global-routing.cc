@@ -0,0 +1,151 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the computation of the global routes in a k-ary
+// fat-tree of routers (5k^2/4 routers, k^3/2 point-to-point links), then
+// the recomputation of the routes after the failure of one link, either
+// from scratch or incrementally.
+// Sample usage:  ./ns3 run 'bench-global-routing --k=16 --threads=4 --incremental --coreLink'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/global-route-manager.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/net-device.h"
+#include "ns3/node-container.h"
+#include "ns3/node.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Print the statistics of the last route computation.
+ * \param phase the name of the computation
+ * \param elapsed the total time of the computation, in milliseconds
+ */
+static void
+PrintStatistics(const std::string& phase, int64_t elapsed)
+{
+    GlobalRouteManager::Statistics statistics = GlobalRouteManager::GetStatistics();
+    std::cout << phase << ":\t" << elapsed << " ms (delete " << statistics.deleteTime
+              << " ms, database " << statistics.databaseTime << " ms, compare "
+              << statistics.compareTime << " ms, update " << statistics.updateTime
+              << " ms, SPF " << statistics.spfTime << " ms), " << statistics.nCalculated
+              << " of " << statistics.nRouters << " trees calculated, " << statistics.nUpdated
+              << " routers updated" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t k = 8;
+    uint32_t threads = 1;
+    bool incremental = false;
+    bool coreLink = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the computation of the global routes in a fat-tree");
+    cmd.AddValue("k", "number of ports of the switches of the fat-tree (even)", k);
+    cmd.AddValue("threads", "number of threads calculating the routes (0 for all)", threads);
+    cmd.AddValue("incremental", "recompute the routes incrementally", incremental);
+    cmd.AddValue("coreLink", "fail a link between an aggregation and a core router", coreLink);
+    cmd.Parse(argc, argv);
+
+    if (k < 2 || k % 2)
+    {
+        std::cerr << "Error-- k must be even" << std::endl;
+        return 1;
+    }
+    Config::SetGlobal("GlobalRoutingThreads", UintegerValue(threads));
+    Config::SetGlobal("GlobalRoutingIncremental", BooleanValue(incremental));
+
+    // k pods of k/2 edge and k/2 aggregation routers, and (k/2)^2 core routers
+    uint32_t half = k / 2;
+    NodeContainer edge;
+    NodeContainer aggregation;
+    NodeContainer core;
+    edge.Create(k * half);
+    aggregation.Create(k * half);
+    core.Create(half * half);
+
+    SystemWallClockMs time;
+    time.Start();
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    std::vector<NetDeviceContainer> links;
+    auto connect = [&simpleHelper, &links](Ptr<Node> a, Ptr<Node> b) {
+        Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+        NetDeviceContainer net = simpleHelper.Install(a, channel);
+        net.Add(simpleHelper.Install(b, channel));
+        links.push_back(net);
+    };
+    for (uint32_t pod = 0; pod < k; pod++)
+    {
+        for (uint32_t i = 0; i < half; i++)
+        {
+            Ptr<Node> agg = aggregation.Get(pod * half + i);
+            for (uint32_t j = 0; j < half; j++)
+            {
+                connect(edge.Get(pod * half + j), agg);
+                connect(agg, core.Get(i * half + j));
+            }
+        }
+    }
+
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(edge);
+    internet.Install(aggregation);
+    internet.Install(core);
+
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.252");
+    for (const auto& link : links)
+    {
+        ipv4.Assign(link);
+        ipv4.NewNetwork();
+    }
+    std::cout << edge.GetN() + aggregation.GetN() + core.GetN() << " routers, " << links.size()
+              << " links, " << threads << " thread(s), built in " << time.End() << " ms"
+              << std::endl;
+
+    time.Start();
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    PrintStatistics("populate", time.End());
+
+    // the first link between an edge and an aggregation router, or between an
+    // aggregation and a core router, fails
+    Ptr<NetDevice> device = links[coreLink ? 1 : 0].Get(0);
+    Ptr<Ipv4> ipv4Failed = device->GetNode()->GetObject<Ipv4>();
+    ipv4Failed->SetDown(ipv4Failed->GetInterfaceForDevice(device));
+    time.Start();
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    PrintStatistics(incremental ? "link down (incremental)" : "link down", time.End());
+
+    Simulator::Destroy();
+    return 0;
+}
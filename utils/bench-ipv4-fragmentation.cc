@@ -0,0 +1,180 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the fragmentation and the reassembly of large IPv4
+// datagrams, as sent by UDP video streams over links with a 1500 bytes MTU:
+// first datagrams are sent over a link, fragmented by the sender and
+// reassembled in order by the receiver, then the fragments of many
+// datagrams in flight at once are handed to the receiver in random order.
+// Sample usage:  ./ns3 run 'bench-ipv4-fragmentation --datagrams=20000 --concurrent=1000'
+
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/neighbor-cache-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+/// Protocol number of the datagrams, not handled by any transport protocol
+static const uint8_t BENCH_PROTOCOL = 253;
+
+/**
+ * Print the rate of an operation.
+ * \param phase the name of the operation
+ * \param datagrams the number of datagrams reassembled
+ * \param fragments the number of fragments
+ * \param elapsed the time taken, in milliseconds
+ */
+static void
+PrintRate(const std::string& phase, uint32_t datagrams, uint32_t fragments, int64_t elapsed)
+{
+    elapsed = std::max<int64_t>(elapsed, 1);
+    std::cout << phase << ":\t" << datagrams << " datagrams, " << fragments << " fragments in "
+              << elapsed << " ms (" << fragments * 1000.0 / elapsed << " fragments/s)"
+              << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t datagrams = 5000;
+    uint32_t size = 65000;
+    uint32_t concurrent = 100;
+    uint32_t seed = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the fragmentation and the reassembly of large IPv4 datagrams");
+    cmd.AddValue("datagrams", "number of datagrams", datagrams);
+    cmd.AddValue("size", "size of the payload of a datagram", size);
+    cmd.AddValue("concurrent", "datagrams whose fragments arrive interleaved", concurrent);
+    cmd.AddValue("seed", "seed of the order of the interleaved fragments", seed);
+    cmd.Parse(argc, argv);
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    NetDeviceContainer devices = simpleHelper.Install(nodes);
+    devices.Get(0)->SetMtu(1500);
+    devices.Get(1)->SetMtu(1500);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+    NeighborCacheHelper neighborCache;
+    neighborCache.PopulateNeighborCache();
+
+    Ptr<Ipv4L3Protocol> sender = nodes.Get(0)->GetObject<Ipv4L3Protocol>();
+    Ptr<Ipv4L3Protocol> receiver = nodes.Get(1)->GetObject<Ipv4L3Protocol>();
+    uint32_t fragments = 0;
+    uint32_t delivered = 0;
+    sender->TraceConnectWithoutContext(
+        "Tx",
+        Callback<void, Ptr<const Packet>, Ptr<Ipv4>, uint32_t>(
+            [&fragments](Ptr<const Packet>, Ptr<Ipv4>, uint32_t) { fragments++; }));
+    receiver->TraceConnectWithoutContext(
+        "LocalDeliver",
+        Callback<void, const Ipv4Header&, Ptr<const Packet>, uint32_t>(
+            [&delivered](const Ipv4Header&, Ptr<const Packet>, uint32_t) { delivered++; }));
+
+    Ipv4Address source = interfaces.GetAddress(0);
+    Ipv4Address destination = interfaces.GetAddress(1);
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t i = 0; i < datagrams; i++)
+    {
+        Simulator::ScheduleWithContext(nodes.Get(0)->GetId(),
+                                       MicroSeconds(i),
+                                       &Ipv4L3Protocol::Send,
+                                       sender,
+                                       Create<Packet>(size),
+                                       source,
+                                       destination,
+                                       BENCH_PROTOCOL,
+                                       nullptr);
+    }
+    Simulator::Run();
+    PrintRate("in order", delivered, fragments, time.End());
+
+    // the fragments of groups of datagrams, as sent by the sender
+    uint32_t fragmentSize = (devices.Get(1)->GetMtu() - 20) & ~uint32_t(0x7);
+    std::vector<Ptr<Packet>> group;
+    std::mt19937 rng(seed);
+    Ptr<NetDevice> device = devices.Get(1);
+    Address from = devices.Get(0)->GetAddress();
+    Address to = device->GetAddress();
+    fragments = 0;
+    delivered = 0;
+    int64_t elapsed = 0;
+    for (uint32_t first = 0; first < datagrams; first += concurrent)
+    {
+        group.clear();
+        for (uint32_t i = first; i < std::min(first + concurrent, datagrams); i++)
+        {
+            for (uint32_t offset = 0; offset < size; offset += fragmentSize)
+            {
+                uint32_t length = std::min(fragmentSize, size - offset);
+                Ipv4Header header;
+                header.SetSource(source);
+                header.SetDestination(destination);
+                header.SetProtocol(BENCH_PROTOCOL);
+                header.SetIdentification(i % 65536);
+                header.SetTtl(64);
+                header.SetFragmentOffset(offset);
+                if (offset + length < size)
+                {
+                    header.SetMoreFragments();
+                }
+                else
+                {
+                    header.SetLastFragment();
+                }
+                header.SetPayloadSize(length);
+                Ptr<Packet> fragment = Create<Packet>(length);
+                fragment->AddHeader(header);
+                group.push_back(fragment);
+            }
+        }
+        std::shuffle(group.begin(), group.end(), rng);
+
+        time.Start();
+        for (const auto& fragment : group)
+        {
+            receiver->Receive(device,
+                              fragment,
+                              Ipv4L3Protocol::PROT_NUMBER,
+                              from,
+                              to,
+                              NetDevice::PACKET_HOST);
+        }
+        elapsed += time.End();
+        fragments += group.size();
+    }
+    PrintRate("interleaved", delivered, fragments, elapsed);
+
+    Simulator::Destroy();
+    return 0;
+}
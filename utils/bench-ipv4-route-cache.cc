@@ -0,0 +1,132 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the forwarding rate of IPv4 packets along a chain of
+// routers, with or without the route cache of Ipv4L3Protocol: UDP packets
+// are sent by the first node of the chain to the last one, along the routes
+// computed by the global routing.
+// Sample usage:  ./ns3 run 'bench-ipv4-route-cache --hops=10 --cache=0'
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/neighbor-cache-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t hops = 10;
+    uint32_t packets = 50000;
+    bool cache = true;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the forwarding of IPv4 packets along a chain of routers");
+    cmd.AddValue("hops", "number of links of the chain", hops);
+    cmd.AddValue("packets", "number of packets sent", packets);
+    cmd.AddValue("cache", "enable the route cache", cache);
+    cmd.Parse(argc, argv);
+
+    Config::SetDefault("ns3::Ipv4L3Protocol::RouteCacheSize", UintegerValue(cache ? 1024 : 0));
+
+    NodeContainer nodes;
+    nodes.Create(hops + 1);
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(nodes);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.252");
+    Ipv4Address destination;
+    for (uint32_t i = 0; i < hops; i++)
+    {
+        NetDeviceContainer devices =
+            simpleHelper.Install(NodeContainer(nodes.Get(i), nodes.Get(i + 1)));
+        destination = ipv4.Assign(devices).GetAddress(1);
+        ipv4.NewNetwork();
+    }
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    NeighborCacheHelper neighborCache;
+    neighborCache.PopulateNeighborCache();
+
+    uint32_t hits = 0;
+    uint32_t lookups = 0;
+    uint32_t forwarded = 0;
+    uint32_t delivered = 0;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<Ipv4L3Protocol> ipv4L3 = nodes.Get(i)->GetObject<Ipv4L3Protocol>();
+        ipv4L3->TraceConnectWithoutContext("RouteCache",
+                                           Callback<void, Ipv4Address, bool>(
+                                               [&hits, &lookups](Ipv4Address, bool hit) {
+                                                   lookups++;
+                                                   hits += hit;
+                                               }));
+        ipv4L3->TraceConnectWithoutContext(
+            "UnicastForward",
+            Callback<void, const Ipv4Header&, Ptr<const Packet>, uint32_t>(
+                [&forwarded](const Ipv4Header&, Ptr<const Packet>, uint32_t) { forwarded++; }));
+    }
+    nodes.Get(hops)->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+        "LocalDeliver",
+        Callback<void, const Ipv4Header&, Ptr<const Packet>, uint32_t>(
+            [&delivered](const Ipv4Header&, Ptr<const Packet>, uint32_t) { delivered++; }));
+
+    InetSocketAddress to(destination, 1000);
+    Ptr<Socket> sink = nodes.Get(hops)->GetObject<UdpSocketFactory>()->CreateSocket();
+    sink->Bind(to);
+    sink->SetRecvCallback(Callback<void, Ptr<Socket>>([](Ptr<Socket> socket) {
+        while (socket->Recv())
+        {
+        }
+    }));
+    Ptr<Socket> socket = nodes.Get(0)->GetObject<UdpSocketFactory>()->CreateSocket();
+    for (uint32_t i = 0; i < packets; i++)
+    {
+        Simulator::ScheduleWithContext(nodes.Get(0)->GetId(), MicroSeconds(i), [socket, to]() {
+            socket->SendTo(Create<Packet>(100), 0, to);
+        });
+    }
+
+    SystemWallClockMs time;
+    time.Start();
+    Simulator::Run();
+    int64_t elapsed = std::max<int64_t>(time.End(), 1);
+
+    std::cout << hops << " hops (" << (cache ? "route cache" : "no route cache")
+              << "):\t" << delivered << " packets delivered, " << forwarded << " forwarded in "
+              << elapsed << " ms (" << forwarded * 1000.0 / elapsed << " forwarded/s)"
+              << std::endl;
+    std::cout << "route cache:\t" << hits << " hits / " << lookups << " lookups" << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,174 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the forwarding rate of IPv6 packets along a chain of
+// routers, each having a static default route to the next one: UDP packets
+// are sent by the first node of the chain to the last one. With ipv4=true,
+// the same chain forwards IPv4 packets instead, for comparison.
+// Sample usage:  ./ns3 run 'bench-ipv6-forwarding --hops=10 --ipv4=false'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-static-routing-helper.h"
+#include "ns3/neighbor-cache-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/udp-socket-factory.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t hops = 10;
+    uint32_t packets = 50000;
+    bool ipv4 = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the forwarding of IPv6 (or IPv4) packets along a chain of routers");
+    cmd.AddValue("hops", "number of links of the chain", hops);
+    cmd.AddValue("packets", "number of packets sent", packets);
+    cmd.AddValue("ipv4", "forward IPv4 packets rather than IPv6 ones", ipv4);
+    cmd.Parse(argc, argv);
+
+    Config::SetDefault("ns3::Icmpv6L4Protocol::DAD", BooleanValue(false));
+
+    NodeContainer nodes;
+    nodes.Create(hops + 1);
+    InternetStackHelper internet;
+    internet.SetIpv4StackInstall(ipv4);
+    internet.SetIpv6StackInstall(!ipv4);
+    internet.Install(nodes);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper ipv4Address;
+    ipv4Address.SetBase("10.0.0.0", "255.255.255.252");
+    Ipv6AddressHelper ipv6Address;
+    ipv6Address.SetBase("fd00::", Ipv6Prefix(64));
+    Ipv4StaticRoutingHelper ipv4Routing;
+    Ipv6StaticRoutingHelper ipv6Routing;
+    Address destination;
+    for (uint32_t i = 0; i < hops; i++)
+    {
+        NetDeviceContainer devices =
+            simpleHelper.Install(NodeContainer(nodes.Get(i), nodes.Get(i + 1)));
+        if (ipv4)
+        {
+            Ipv4InterfaceContainer interfaces = ipv4Address.Assign(devices);
+            Ptr<Ipv4> ip = nodes.Get(i)->GetObject<Ipv4>();
+            ipv4Routing.GetStaticRouting(ip)->SetDefaultRoute(
+                interfaces.GetAddress(1),
+                ip->GetInterfaceForDevice(devices.Get(0)));
+            destination = InetSocketAddress(interfaces.GetAddress(1), 1000);
+            ipv4Address.NewNetwork();
+        }
+        else
+        {
+            Ipv6InterfaceContainer interfaces = ipv6Address.Assign(devices);
+            interfaces.SetForwarding(0, true);
+            interfaces.SetForwarding(1, i + 1 < hops);
+            Ptr<Ipv6> ip = nodes.Get(i)->GetObject<Ipv6>();
+            ipv6Routing.GetStaticRouting(ip)->SetDefaultRoute(
+                interfaces.GetAddress(1, 1),
+                ip->GetInterfaceForDevice(devices.Get(0)));
+            destination = Inet6SocketAddress(interfaces.GetAddress(1, 1), 1000);
+            ipv6Address.NewNetwork();
+        }
+    }
+    NeighborCacheHelper neighborCache;
+    neighborCache.PopulateNeighborCache();
+
+    uint32_t forwarded = 0;
+    uint32_t delivered = 0;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        if (ipv4)
+        {
+            Ptr<Ipv4L3Protocol> ip = nodes.Get(i)->GetObject<Ipv4L3Protocol>();
+            ip->TraceConnectWithoutContext(
+                "UnicastForward",
+                Callback<void, const Ipv4Header&, Ptr<const Packet>, uint32_t>(
+                    [&forwarded](const Ipv4Header&, Ptr<const Packet>, uint32_t) {
+                        forwarded++;
+                    }));
+            ip->TraceConnectWithoutContext(
+                "LocalDeliver",
+                Callback<void, const Ipv4Header&, Ptr<const Packet>, uint32_t>(
+                    [&delivered](const Ipv4Header&, Ptr<const Packet>, uint32_t) {
+                        delivered++;
+                    }));
+        }
+        else
+        {
+            Ptr<Ipv6L3Protocol> ip = nodes.Get(i)->GetObject<Ipv6L3Protocol>();
+            ip->TraceConnectWithoutContext(
+                "UnicastForward",
+                Callback<void, const Ipv6Header&, Ptr<const Packet>, uint32_t>(
+                    [&forwarded](const Ipv6Header&, Ptr<const Packet>, uint32_t) {
+                        forwarded++;
+                    }));
+            ip->TraceConnectWithoutContext(
+                "LocalDeliver",
+                Callback<void, const Ipv6Header&, Ptr<const Packet>, uint32_t>(
+                    [&delivered](const Ipv6Header&, Ptr<const Packet>, uint32_t) {
+                        delivered++;
+                    }));
+        }
+    }
+
+    Ptr<Socket> sink = nodes.Get(hops)->GetObject<UdpSocketFactory>()->CreateSocket();
+    sink->Bind(destination);
+    sink->SetRecvCallback(Callback<void, Ptr<Socket>>([](Ptr<Socket> socket) {
+        while (socket->Recv())
+        {
+        }
+    }));
+    Ptr<Socket> socket = nodes.Get(0)->GetObject<UdpSocketFactory>()->CreateSocket();
+    for (uint32_t i = 0; i < packets; i++)
+    {
+        Simulator::ScheduleWithContext(nodes.Get(0)->GetId(),
+                                       MicroSeconds(i),
+                                       [socket, destination]() {
+                                           socket->SendTo(Create<Packet>(100), 0, destination);
+                                       });
+    }
+
+    SystemWallClockMs time;
+    time.Start();
+    Simulator::Run();
+    int64_t elapsed = std::max<int64_t>(time.End(), 1);
+
+    std::cout << hops << " hops (" << (ipv4 ? "IPv4" : "IPv6") << "):\t" << delivered
+              << " packets delivered, " << forwarded << " forwarded in " << elapsed << " ms ("
+              << forwarded * 1000.0 / elapsed << " forwarded/s)" << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the population of the neighbor caches of a LAN by
+// NeighborCacheHelper: the time taken and the memory used to populate the
+// caches of stations attached to a single channel, either with one entry per
+// neighbor in each cache or with one table shared by all the caches, then
+// the time taken by ARP lookups between random pairs of stations.
+// Sample usage:  ./ns3 run 'bench-neighbor-cache --stations=2000 --shared=0'
+
+#include "ns3/arp-l3-protocol.h"
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/neighbor-cache-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Get the resident set size of the process.
+ * \return the resident set size in kB, or 0 if unknown
+ */
+static uint64_t
+GetResidentKb()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+        {
+            return std::stoull(line.substr(6));
+        }
+    }
+    return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t stations = 5000;
+    bool shared = true;
+    bool ipv6 = false;
+    uint32_t lookups = 1000000;
+    uint32_t seed = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the population of the neighbor caches of a large LAN");
+    cmd.AddValue("stations", "number of stations attached to the channel", stations);
+    cmd.AddValue("shared", "share one neighbor table between the caches", shared);
+    cmd.AddValue("ipv6", "populate the NDISC caches too", ipv6);
+    cmd.AddValue("lookups", "number of ARP lookups", lookups);
+    cmd.AddValue("seed", "seed of the pairs of stations looked up", seed);
+    cmd.Parse(argc, argv);
+
+    NodeContainer nodes;
+    nodes.Create(stations);
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    SimpleNetDeviceHelper simpleHelper;
+    NetDeviceContainer devices = simpleHelper.Install(nodes, channel);
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(ipv6);
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4Address;
+    ipv4Address.SetBase("10.0.0.0", "255.0.0.0");
+    Ipv4InterfaceContainer interfaces = ipv4Address.Assign(devices);
+    if (ipv6)
+    {
+        Ipv6AddressHelper ipv6Address;
+        ipv6Address.SetBase(Ipv6Address("2001:db8::"), Ipv6Prefix(64));
+        ipv6Address.Assign(devices);
+    }
+
+    NeighborCacheHelper neighborCache;
+    neighborCache.SetSharedNeighborCache(shared);
+    uint64_t residentBefore = GetResidentKb();
+    SystemWallClockMs time;
+    time.Start();
+    neighborCache.PopulateNeighborCache();
+    int64_t populateTime = time.End();
+    uint64_t residentAfter = GetResidentKb();
+
+    std::cout << "populate " << stations << " stations (" << (shared ? "shared" : "per cache")
+              << "):\t" << populateTime << " ms, " << residentAfter - residentBefore << " kB"
+              << std::endl;
+
+    // ARP lookups between random pairs of stations
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> station(0, stations - 1);
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    pairs.reserve(lookups);
+    for (uint32_t i = 0; i < lookups; i++)
+    {
+        uint32_t from = station(rng);
+        uint32_t to = station(rng);
+        pairs.emplace_back(from, to == from ? (to + 1) % stations : to);
+    }
+    Ptr<Packet> packet = Create<Packet>(100);
+    Ipv4Header header;
+    Address hardwareDestination;
+    uint32_t resolved = 0;
+    time.Start();
+    for (const auto& [from, to] : pairs)
+    {
+        Ptr<Node> node = nodes.Get(from);
+        Ptr<Ipv4Interface> interface =
+            node->GetObject<Ipv4L3Protocol>()->GetInterface(interfaces.Get(from).second);
+        resolved += node->GetObject<ArpL3Protocol>()->Lookup(packet,
+                                                             header,
+                                                             interfaces.GetAddress(to),
+                                                             interface->GetDevice(),
+                                                             interface->GetArpCache(),
+                                                             &hardwareDestination);
+    }
+    int64_t lookupTime = std::max<int64_t>(time.End(), 1);
+    std::cout << "lookups:\t" << lookups << " lookups, " << resolved << " resolved in "
+              << lookupTime << " ms (" << lookups * 1000.0 / lookupTime << " lookups/s)"
+              << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
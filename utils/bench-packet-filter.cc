@@ -0,0 +1,209 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost of classifying packets through many 5-tuple
+// rules in a Prio queue disc: the rules are either a chain of filters, one per
+// rule, which peek the headers of the packets ("peek") or read the 5-tuple
+// cached by the queue disc items ("tuple"), or a single RuleTablePacketFilter
+// ("table"). UDP packets matching random rules are enqueued and dequeued.
+// Sample usage:  ./ns3 run 'bench-packet-filter --rules=1000 --mode=peek'
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/packet.h"
+#include "ns3/prio-queue-disc.h"
+#include "ns3/rule-table-packet-filter.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/udp-header.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/// A 5-tuple rule
+struct Rule
+{
+    uint32_t source;          //!< Source address
+    uint32_t sourceMask;      //!< Mask of the source address
+    uint32_t destination;     //!< Destination address
+    uint32_t destinationMask; //!< Mask of the destination address
+    uint16_t sourcePort;      //!< Source port
+    uint16_t destinationPort; //!< Destination port
+};
+
+/**
+ * Packet filter matching the UDP packets of one rule, as in a chain of filters.
+ */
+class RuleFilter : public PacketFilter
+{
+  public:
+    /**
+     * Constructor
+     * \param rule the rule
+     * \param cls the class of the packets matching the rule
+     * \param peek whether to peek the headers rather than read the cached 5-tuple
+     */
+    RuleFilter(const Rule& rule, int32_t cls, bool peek)
+        : m_rule(rule),
+          m_cls(cls),
+          m_peek(peek)
+    {
+    }
+
+  private:
+    bool CheckProtocol(Ptr<QueueDiscItem> item) const override
+    {
+        return m_peek ? bool(DynamicCast<Ipv4QueueDiscItem>(item)) : bool(item->GetFiveTuple());
+    }
+
+    int32_t DoClassify(Ptr<QueueDiscItem> item) const override
+    {
+        uint32_t source;
+        uint32_t destination;
+        uint8_t protocol;
+        uint16_t sourcePort;
+        uint16_t destinationPort;
+        if (m_peek)
+        {
+            const Ipv4Header& header = DynamicCast<Ipv4QueueDiscItem>(item)->GetHeader();
+            UdpHeader udp;
+            item->GetPacket()->PeekHeader(udp);
+            source = header.GetSource().Get();
+            destination = header.GetDestination().Get();
+            protocol = header.GetProtocol();
+            sourcePort = udp.GetSourcePort();
+            destinationPort = udp.GetDestinationPort();
+        }
+        else
+        {
+            const QueueDiscItem::FiveTuple* tuple = item->GetFiveTuple();
+            source = Ipv4Address::Deserialize(tuple->source).Get();
+            destination = Ipv4Address::Deserialize(tuple->destination).Get();
+            protocol = tuple->protocol;
+            sourcePort = tuple->sourcePort;
+            destinationPort = tuple->destinationPort;
+        }
+        if (protocol == 17 && (source & m_rule.sourceMask) == m_rule.source &&
+            (destination & m_rule.destinationMask) == m_rule.destination &&
+            sourcePort == m_rule.sourcePort && destinationPort == m_rule.destinationPort)
+        {
+            return m_cls;
+        }
+        return PF_NO_MATCH;
+    }
+
+    Rule m_rule;   //!< The rule
+    int32_t m_cls; //!< The class of the packets matching the rule
+    bool m_peek;   //!< Whether to peek the headers
+};
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nRules = 1000;
+    uint32_t packets = 100000;
+    std::string mode = "table";
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the classification of packets through many 5-tuple rules");
+    cmd.AddValue("rules", "number of rules", nRules);
+    cmd.AddValue("packets", "number of packets", packets);
+    cmd.AddValue("mode", "filters of the rules: peek, tuple or table", mode);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(mode != "peek" && mode != "tuple" && mode != "table",
+                    "Unknown mode " << mode);
+
+    // rules with host or /24 addresses, i.e., four groups of rules for the table
+    std::mt19937 rng(1);
+    std::vector<Rule> rules;
+    for (uint32_t i = 0; i < nRules; i++)
+    {
+        Rule rule;
+        rule.sourceMask = (rng() % 2) ? 0xffffffff : 0xffffff00;
+        rule.source = (0x0a000000 | (i << 8) | (rng() & 0xff)) & rule.sourceMask;
+        rule.destinationMask = (rng() % 2) ? 0xffffffff : 0xffffff00;
+        rule.destination = (0x0b000000 | (rng() & 0xffffff)) & rule.destinationMask;
+        rule.sourcePort = 1024 + rng() % 60000;
+        rule.destinationPort = rng() % 1024;
+        rules.push_back(rule);
+    }
+
+    Ptr<PrioQueueDisc> queueDisc = CreateObject<PrioQueueDisc>();
+    if (mode == "table")
+    {
+        Ptr<RuleTablePacketFilter> filter = CreateObject<RuleTablePacketFilter>();
+        for (uint32_t i = 0; i < nRules; i++)
+        {
+            filter->AddRule(Ipv4Address(rules[i].source),
+                            Ipv4Mask(rules[i].sourceMask),
+                            Ipv4Address(rules[i].destination),
+                            Ipv4Mask(rules[i].destinationMask),
+                            17,
+                            rules[i].sourcePort,
+                            rules[i].destinationPort,
+                            i % 2);
+        }
+        queueDisc->AddPacketFilter(filter);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < nRules; i++)
+        {
+            queueDisc->AddPacketFilter(CreateObject<RuleFilter>(rules[i], i % 2, mode == "peek"));
+        }
+    }
+    queueDisc->Initialize();
+
+    Ipv4Header header;
+    header.SetProtocol(17);
+    header.SetPayloadSize(1000);
+    std::vector<uint32_t> matched(rules.size());
+    std::generate(matched.begin(), matched.end(), [&rng, nRules]() { return rng() % nRules; });
+
+    SystemWallClockMs time;
+    time.Start();
+    uint32_t dequeued = 0;
+    for (uint32_t n = 0; n < packets; n++)
+    {
+        const Rule& rule = rules[matched[n % matched.size()]];
+        Ptr<Packet> packet = Create<Packet>(1000 - 8);
+        UdpHeader udp;
+        udp.SetSourcePort(rule.sourcePort);
+        udp.SetDestinationPort(rule.destinationPort);
+        packet->AddHeader(udp);
+        header.SetSource(Ipv4Address(rule.source | (~rule.sourceMask & n)));
+        header.SetDestination(Ipv4Address(rule.destination | (~rule.destinationMask & n)));
+        queueDisc->Enqueue(Create<Ipv4QueueDiscItem>(packet, Address(), 0x0800, header));
+        if (queueDisc->Dequeue())
+        {
+            dequeued++;
+        }
+    }
+    int64_t elapsed = std::max<int64_t>(time.End(), 1);
+
+    std::cout << nRules << " rules (" << mode << "):\t" << dequeued << " packets, " << elapsed
+              << " ms (" << dequeued * 1000.0 / elapsed << " packets/s)" << std::endl;
+
+    queueDisc->Dispose();
+    Simulator::Destroy();
+    return 0;
+}
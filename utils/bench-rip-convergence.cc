@@ -0,0 +1,156 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the time taken to simulate the convergence of RIP
+// (or RIPng) in a torus of routers, each linked to its four neighbors by a
+// point-to-point link with its own network. After the simulated time, every
+// router must have a route to every network.
+// Sample usage:  ./ns3 run 'bench-rip-convergence --rows=12 --cols=12 --ripng=false'
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-list-routing-helper.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/ipv6-list-routing-helper.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/node-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/rip-helper.h"
+#include "ns3/ripng-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t rows = 12;
+    uint32_t cols = 12;
+    bool ripng = false;
+    Time time = Seconds(60);
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the convergence of RIP or RIPng in a torus of routers");
+    cmd.AddValue("rows", "number of rows of routers", rows);
+    cmd.AddValue("cols", "number of columns of routers", cols);
+    cmd.AddValue("ripng", "whether to use RIPng rather than RIP", ripng);
+    cmd.AddValue("time", "simulated time", time);
+    cmd.Parse(argc, argv);
+
+    // the distance between two routers must stay below the RIP infinity
+    NS_ABORT_MSG_IF(rows < 3 || cols < 3 || rows / 2 + cols / 2 >= 15,
+                    "The torus must have 3 to 29 rows and columns, and a diameter below 15");
+
+    NodeContainer routers;
+    routers.Create(rows * cols);
+    InternetStackHelper internet;
+    if (ripng)
+    {
+        Ipv6ListRoutingHelper listRouting;
+        listRouting.Add(RipNgHelper(), 0);
+        internet.SetIpv4StackInstall(false);
+        internet.SetRoutingHelper(listRouting);
+    }
+    else
+    {
+        Ipv4ListRoutingHelper listRouting;
+        listRouting.Add(RipHelper(), 0);
+        internet.SetIpv6StackInstall(false);
+        internet.SetRoutingHelper(listRouting);
+    }
+    internet.Install(routers);
+
+    PointToPointHelper pointToPoint;
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.252");
+    Ipv6AddressHelper ipv6;
+    ipv6.SetBase("2001:db8::", Ipv6Prefix(64));
+    std::vector<Ipv4Address> networks;
+    std::vector<Ipv6Address> networks6;
+    for (uint32_t i = 0; i < rows * cols; i++)
+    {
+        uint32_t row = i / cols;
+        uint32_t col = i % cols;
+        for (uint32_t neighbor : {row * cols + (col + 1) % cols, ((row + 1) % rows) * cols + col})
+        {
+            NetDeviceContainer devices =
+                pointToPoint.Install(routers.Get(i), routers.Get(neighbor));
+            if (ripng)
+            {
+                Ipv6InterfaceContainer interfaces = ipv6.Assign(devices);
+                interfaces.SetForwarding(0, true);
+                interfaces.SetForwarding(1, true);
+                networks6.push_back(interfaces.GetAddress(0, 1));
+                ipv6.NewNetwork();
+            }
+            else
+            {
+                networks.push_back(ipv4.Assign(devices).GetAddress(0));
+                ipv4.NewNetwork();
+            }
+        }
+    }
+
+    Simulator::Stop(time);
+    SystemWallClockMs wallClock;
+    wallClock.Start();
+    Simulator::Run();
+    int64_t elapsed = std::max<int64_t>(wallClock.End(), 1);
+
+    // every router must have a route to every network
+    uint64_t routes = 0;
+    for (uint32_t i = 0; i < routers.GetN(); i++)
+    {
+        Socket::SocketErrno sockerr;
+        if (ripng)
+        {
+            Ptr<Ipv6RoutingProtocol> routing =
+                routers.Get(i)->GetObject<Ipv6>()->GetRoutingProtocol();
+            for (const auto& network : networks6)
+            {
+                Ipv6Header header;
+                header.SetDestination(network);
+                routes += bool(routing->RouteOutput(nullptr, header, nullptr, sockerr));
+            }
+        }
+        else
+        {
+            Ptr<Ipv4RoutingProtocol> routing =
+                routers.Get(i)->GetObject<Ipv4>()->GetRoutingProtocol();
+            for (const auto& network : networks)
+            {
+                Ipv4Header header;
+                header.SetDestination(network);
+                routes += bool(routing->RouteOutput(nullptr, header, nullptr, sockerr));
+            }
+        }
+    }
+    uint64_t expected = static_cast<uint64_t>(routers.GetN()) * routers.GetN() * 2;
+
+    std::cout << (ripng ? "RIPng, " : "RIP, ") << routers.GetN() << " routers, "
+              << routers.GetN() * 2 << " networks: " << routes << "/" << expected << " routes, "
+              << elapsed << " ms" << std::endl;
+
+    Simulator::Destroy();
+    return routes == expected ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the forwarding rate of Ipv4StaticRouting
+// (RouteInput calls per second) with routing tables of increasing size.
+// The prefixes are drawn at random, mostly /24 like in a backbone table.
+// With --linear, a route with a non-contiguous mask is added, which makes
+// the lookups scan the whole table as they did before the prefix trie.
+// Sample usage:  ./ns3 run 'bench-routing-lookup --prefixes=1000,100000,1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Time the forwarding lookups of a router holding a number of prefixes.
+ * \param prefixes number of prefixes in the routing table
+ * \param lookups number of lookups to perform
+ * \param linear whether to force the linear scan of the routing table
+ */
+static void
+BenchForwarding(uint32_t prefixes, uint32_t lookups, bool linear)
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.Install(node);
+    SimpleNetDeviceHelper devHelper;
+    NetDeviceContainer devices;
+    devices.Add(devHelper.Install(node));
+    devices.Add(devHelper.Install(node));
+    Ipv4AddressHelper ipv4Helper("192.168.0.0", "255.255.255.0");
+    ipv4Helper.Assign(NetDeviceContainer(devices.Get(0)));
+    ipv4Helper.NewNetwork();
+    ipv4Helper.Assign(NetDeviceContainer(devices.Get(1)));
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    Ipv4StaticRoutingHelper ipv4RoutingHelper;
+    Ptr<Ipv4StaticRouting> routing = ipv4RoutingHelper.GetStaticRouting(ipv4);
+
+    // 60% of /24, the rest spread between /8 and /23, in 1.0.0.0 - 223.255.255.255
+    std::mt19937 rng(1);
+    std::vector<std::pair<uint32_t, uint32_t>> table(prefixes);
+    SystemWallClockMs time;
+    time.Start();
+    for (auto& [network, length] : table)
+    {
+        length = (rng() % 10 < 6) ? 24 : 8 + rng() % 16;
+        uint32_t mask = 0xffffffff << (32 - length);
+        network = (0x01000000 + rng() % 0xdf000000) & mask;
+        routing->AddNetworkRouteTo(Ipv4Address(network),
+                                   Ipv4Mask(mask),
+                                   Ipv4Address("192.168.1.2"),
+                                   2);
+    }
+    routing->SetDefaultRoute(Ipv4Address("192.168.0.2"), 1);
+    if (linear)
+    {
+        routing->AddNetworkRouteTo(Ipv4Address("224.0.0.0"),
+                                   Ipv4Mask("255.0.0.255"),
+                                   Ipv4Address("192.168.0.2"),
+                                   1);
+    }
+    int64_t setup = time.End();
+
+    // destinations inside the installed prefixes, plus one miss out of eight
+    std::vector<Ipv4Header> headers(std::min<uint32_t>(lookups, 1 << 16));
+    for (auto& header : headers)
+    {
+        uint32_t index = rng() % (prefixes + prefixes / 8);
+        uint32_t dest = 0xc0a80300 | (rng() & 0xff);
+        if (index < prefixes)
+        {
+            auto [network, length] = table[index];
+            dest = network | (rng() & ~(0xffffffff << (32 - length)));
+        }
+        header.SetDestination(Ipv4Address(dest));
+        header.SetSource(Ipv4Address("192.168.0.2"));
+    }
+
+    uint64_t forwarded = 0;
+    Ipv4RoutingProtocol::UnicastForwardCallback ucb(
+        [&forwarded](Ptr<Ipv4Route> route, Ptr<const Packet>, const Ipv4Header&) {
+            forwarded += route->GetOutputDevice()->GetIfIndex();
+        });
+    Ptr<Packet> packet = Create<Packet>(100);
+    Ptr<NetDevice> idev = devices.Get(0);
+
+    time.Start();
+    for (uint32_t i = 0; i < lookups; i++)
+    {
+        routing->RouteInput(packet,
+                            headers[i % headers.size()],
+                            idev,
+                            ucb,
+                            Ipv4RoutingProtocol::MulticastForwardCallback(),
+                            Ipv4RoutingProtocol::LocalDeliverCallback(),
+                            Ipv4RoutingProtocol::ErrorCallback());
+    }
+    int64_t elapsed = std::max<int64_t>(time.End(), 1);
+
+    std::cout << prefixes << " prefixes" << (linear ? " (linear scan)" : "") << ":\t"
+              << lookups * 1000.0 / elapsed << " lookups/s"
+              << " (" << elapsed << " ms elapsed, " << setup << " ms setup, checksum "
+              << forwarded % 1000 << ")" << std::endl;
+
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string prefixes = "1000,100000,1000000";
+    uint32_t lookups = 1000000;
+    bool linear = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the forwarding lookups of Ipv4StaticRouting");
+    cmd.AddValue("prefixes", "comma-separated numbers of prefixes in the routing table", prefixes);
+    cmd.AddValue("lookups", "number of lookups", lookups);
+    cmd.AddValue("linear", "force the linear scan of the routing table", linear);
+    cmd.Parse(argc, argv);
+
+    std::istringstream iss(prefixes);
+    std::string count;
+    while (std::getline(iss, count, ','))
+    {
+        BenchForwarding(std::stoul(count), lookups, linear);
+    }
+
+    return 0;
+}
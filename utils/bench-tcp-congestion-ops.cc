@@ -0,0 +1,217 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the cost per ACK of a TCP congestion control
+// algorithm, driven by synthetic ACK streams outside of any socket: every
+// ackInterval, each flow receives an ACK of one segment, which calls
+// PktsAcked() and IncreaseWindow() (or CongControl() with a synthetic rate
+// sample), and each flow goes through a fast recovery every lossInterval ACKs.
+// The RTT of a flow grows with its window beyond its BDP, so that the
+// delay-based algorithms react too. The checksum hashes the cwnd and ssthresh
+// of every flow after every ACK: an optimization of an algorithm must not
+// change it.
+// Sample usage:  ./ns3 run 'bench-tcp-congestion-ops --cc=ns3::TcpCubic --flows=1000'
+
+#include "ns3/command-line.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-rate-ops.h"
+#include "ns3/tcp-socket-state.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/// A flow driven by the synthetic ACK stream
+struct Flow
+{
+    Ptr<TcpSocketState> tcb;          //!< Socket state
+    Ptr<TcpCongestionOps> cc;         //!< Congestion control
+    TcpRateOps::TcpRateConnection rc; //!< Connection rate, for CongControl
+    TcpRateOps::TcpRateSample rs;     //!< Rate sample, for CongControl
+    Time baseRtt;                     //!< RTT without queueing
+    uint32_t bdp;                     //!< Bandwidth-delay product (bytes)
+    uint32_t acks{0};                 //!< ACKs received
+};
+
+static std::vector<Flow> g_flows;   //!< The flows
+static uint64_t g_checksum = 0;     //!< Hash of the trajectories of the flows
+static uint32_t g_lossInterval = 0; //!< Number of ACKs between losses
+static uint32_t g_acksPerFlow = 0;  //!< Number of ACKs per flow
+static Time g_ackInterval;          //!< Time between the ACKs of a flow
+
+/**
+ * Deliver an ACK of one segment to a flow.
+ * \param flow the flow
+ * \param index the index of the flow
+ */
+static void
+AckFlow(Flow& flow, uint32_t index)
+{
+    Ptr<TcpSocketState> tcb = flow.tcb;
+    uint32_t cWnd = tcb->m_cWnd;
+    Time rtt = flow.baseRtt;
+    if (cWnd > flow.bdp)
+    {
+        rtt += NanoSeconds(flow.baseRtt.GetNanoSeconds() * (cWnd - flow.bdp) / flow.bdp);
+    }
+    tcb->m_lastRtt = rtt;
+    tcb->m_minRtt = std::min(tcb->m_minRtt, rtt);
+    tcb->m_srtt = rtt;
+    tcb->m_bytesInFlight = cWnd;
+    tcb->m_lastAckedSackedBytes = tcb->m_segmentSize;
+    tcb->m_isCwndLimited = true;
+    tcb->m_lastAckedSeq += tcb->m_segmentSize;
+    tcb->m_nextTxSequence = tcb->m_lastAckedSeq + cWnd;
+    tcb->m_highTxMark = tcb->m_nextTxSequence.Get();
+    flow.acks++;
+
+    if (tcb->m_congState == TcpSocketState::CA_RECOVERY)
+    {
+        // the ACK following a loss ends the recovery
+        flow.cc->PktsAcked(tcb, 1, rtt);
+        if (!flow.cc->HasCongControl())
+        {
+            tcb->m_cWnd = tcb->m_ssThresh.Get();
+        }
+        flow.cc->CwndEvent(tcb, TcpSocketState::CA_EVENT_COMPLETE_CWR);
+        flow.cc->CongestionStateSet(tcb, TcpSocketState::CA_OPEN);
+        tcb->m_congState = TcpSocketState::CA_OPEN;
+    }
+    else if ((flow.acks + index) % g_lossInterval == 0)
+    {
+        flow.cc->CongestionStateSet(tcb, TcpSocketState::CA_RECOVERY);
+        tcb->m_congState = TcpSocketState::CA_RECOVERY;
+        tcb->m_ssThresh = flow.cc->GetSsThresh(tcb, cWnd);
+        if (!flow.cc->HasCongControl())
+        {
+            tcb->m_cWnd = tcb->m_ssThresh.Get();
+        }
+    }
+    else
+    {
+        flow.cc->PktsAcked(tcb, 1, rtt);
+        if (flow.cc->HasCongControl())
+        {
+            // a window of data is delivered per RTT, at most at the bottleneck rate
+            uint32_t delivered = std::min(cWnd, flow.bdp);
+            flow.rc.m_delivered += tcb->m_segmentSize;
+            flow.rc.m_deliveredTime = Simulator::Now();
+            TcpRateOps::TcpRateSample& rs = flow.rs;
+            rs.m_interval = rtt;
+            rs.m_delivered = delivered;
+            rs.m_deliveryRate =
+                DataRate(static_cast<uint64_t>(delivered) * 8 * 1000000000 / rtt.GetNanoSeconds());
+            rs.m_priorDelivered = static_cast<uint32_t>(
+                flow.rc.m_delivered - std::min<uint64_t>(flow.rc.m_delivered, delivered));
+            rs.m_priorInFlight = cWnd;
+            rs.m_ackedSacked = tcb->m_segmentSize;
+            flow.cc->CongControl(tcb, flow.rc, rs);
+        }
+        else
+        {
+            flow.cc->IncreaseWindow(tcb, 1);
+        }
+    }
+
+    uint64_t state = (static_cast<uint64_t>(tcb->m_cWnd.Get()) << 32) | tcb->m_ssThresh.Get();
+    g_checksum = (g_checksum ^ state) * 1099511628211ULL;
+}
+
+/**
+ * Deliver an ACK to every flow and reschedule itself.
+ * \param round the number of ACKs delivered to each flow so far
+ */
+static void
+AckAll(uint32_t round)
+{
+    for (uint32_t i = 0; i < g_flows.size(); i++)
+    {
+        AckFlow(g_flows[i], i);
+    }
+    if (round + 1 < g_acksPerFlow)
+    {
+        Simulator::Schedule(g_ackInterval, &AckAll, round + 1);
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string cc = "ns3::TcpCubic";
+    uint32_t flows = 1000;
+    uint32_t segmentSize = 1448;
+    Time baseRtt = MilliSeconds(20);
+    g_acksPerFlow = 10000;
+    g_lossInterval = 2000;
+    g_ackInterval = MicroSeconds(100);
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark a TCP congestion control algorithm with synthetic ACK streams");
+    cmd.AddValue("cc", "TypeId of the congestion control algorithm", cc);
+    cmd.AddValue("flows", "number of flows", flows);
+    cmd.AddValue("acks", "number of ACKs per flow", g_acksPerFlow);
+    cmd.AddValue("lossInterval", "number of ACKs between losses", g_lossInterval);
+    cmd.AddValue("ackInterval", "time between the ACKs of a flow", g_ackInterval);
+    cmd.AddValue("rtt", "base RTT of the first flow (the others get up to 7 ms more)", baseRtt);
+    cmd.Parse(argc, argv);
+
+    ObjectFactory factory;
+    factory.SetTypeId(cc);
+    for (uint32_t i = 0; i < flows; i++)
+    {
+        Flow flow;
+        flow.tcb = CreateObject<TcpSocketState>();
+        flow.tcb->m_segmentSize = segmentSize;
+        flow.tcb->m_initialCWnd = 10;
+        flow.tcb->m_cWnd = 10 * segmentSize;
+        flow.tcb->m_cWndInfl = flow.tcb->m_cWnd;
+        flow.tcb->m_initialSsThresh = UINT32_MAX;
+        flow.tcb->m_ssThresh = UINT32_MAX;
+        flow.tcb->m_maxPacingRate = DataRate("100Gbps");
+        flow.cc = factory.Create<TcpCongestionOps>();
+        flow.baseRtt = baseRtt + MilliSeconds(i % 8);
+        flow.bdp = (50 + (i % 8) * 25) * segmentSize;
+        flow.cc->Init(flow.tcb);
+        g_flows.push_back(flow);
+    }
+    Simulator::Schedule(g_ackInterval, &AckAll, 0);
+
+    SystemWallClockMs wallClock;
+    wallClock.Start();
+    Simulator::Run();
+    int64_t elapsed = std::max<int64_t>(wallClock.End(), 1);
+    Simulator::Destroy();
+
+    uint64_t cWnds = 0;
+    for (const auto& flow : g_flows)
+    {
+        cWnds += flow.tcb->m_cWnd;
+    }
+    uint64_t acks = static_cast<uint64_t>(flows) * g_acksPerFlow;
+    std::cout << cc << ": " << flows << " flows, " << acks << " ACKs, " << elapsed << " ms ("
+              << elapsed * 1e6 / acks << " ns/ACK), mean cwnd " << cWnds / flows / segmentSize
+              << " segments, checksum " << std::hex << std::setw(16) << std::setfill('0')
+              << g_checksum << std::endl;
+    g_flows.clear();
+    return 0;
+}
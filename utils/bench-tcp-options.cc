@@ -0,0 +1,191 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the number of segments per second processed by
+// TcpL4Protocol::Receive with the timestamp and SACK options: once a
+// connection is established, data segments with a timestamp option are
+// delivered straight to the TCP of the receiver, with one pair of segments
+// out of reorderInterval swapped, so that the receiver answers with ACKs
+// carrying timestamp and SACK options, which the sender receives through
+// TcpL4Protocol::Receive too.
+// Sample usage:  ./ns3 run 'bench-tcp-options --segments=100000 --reorderInterval=8'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/node-container.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-option-ts.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+static Ptr<TcpL4Protocol> g_tcp;                                  //!< TCP of the receiver
+static Ptr<Ipv4Interface> g_interface;                            //!< Interface of the receiver
+static std::vector<std::pair<Ptr<Packet>, Ipv4Header>> g_segments; //!< The data segments
+static uint32_t g_acks = 0; //!< Number of segments received by the sender
+
+/**
+ * Deliver a batch of data segments to the TCP of the receiver.
+ * \param first the index of the first segment of the batch
+ * \param count the number of segments of the batch
+ */
+static void
+DeliverSegments(uint32_t first, uint32_t count)
+{
+    for (uint32_t i = first; i < std::min<std::size_t>(first + count, g_segments.size()); i++)
+    {
+        g_tcp->Receive(g_segments[i].first, g_segments[i].second, g_interface);
+    }
+}
+
+/**
+ * Count the segments received by the sender.
+ */
+static void
+CountAck(Ptr<const Packet>, const TcpHeader&, Ptr<const TcpSocketBase>)
+{
+    g_acks++;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t segments = 100000;
+    uint32_t segmentSize = 1448;
+    uint32_t batch = 10;
+    uint32_t reorderInterval = 8;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the processing of TCP segments with timestamp and SACK options");
+    cmd.AddValue("segments", "number of data segments", segments);
+    cmd.AddValue("batch", "number of data segments delivered every microsecond", batch);
+    cmd.AddValue("reorderInterval",
+                 "one pair of segments out of reorderInterval is swapped (0 for none)",
+                 reorderInterval);
+    cmd.Parse(argc, argv);
+
+    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(segmentSize));
+    Config::SetDefault("ns3::TcpSocket::RcvBufSize", UintegerValue(16 << 20));
+    Config::SetDefault("ns3::TcpSocketBase::Sack", BooleanValue(true));
+    Config::SetDefault("ns3::TcpSocketBase::Timestamp", BooleanValue(true));
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    PointToPointHelper pointToPoint;
+    pointToPoint.SetDeviceAttribute("DataRate", StringValue("100Gbps"));
+    pointToPoint.SetChannelAttribute("Delay", StringValue("10us"));
+    NetDeviceContainer devices = pointToPoint.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+
+    // the receiver drains its buffer with a sink, the sender only connects
+    uint16_t port = 9;
+    PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
+                                InetSocketAddress(Ipv4Address::GetAny(), port));
+    ApplicationContainer sinks = sinkHelper.Install(nodes.Get(1));
+    Ptr<Socket> sender = Socket::CreateSocket(nodes.Get(0), TcpSocketFactory::GetTypeId());
+    sender->Bind();
+    InetSocketAddress receiverAddress(interfaces.GetAddress(1), port);
+    Simulator::ScheduleNow([sender, receiverAddress]() { sender->Connect(receiverAddress); });
+    Simulator::Stop(MilliSeconds(1));
+    Simulator::Run();
+    sender->TraceConnectWithoutContext("Rx", MakeCallback(&CountAck));
+
+    Address senderAddress;
+    sender->GetSockName(senderAddress);
+    uint16_t senderPort = InetSocketAddress::ConvertFrom(senderAddress).GetPort();
+    g_tcp = nodes.Get(1)->GetObject<TcpL4Protocol>();
+    g_interface = nodes.Get(1)->GetObject<Ipv4L3Protocol>()->GetInterface(1);
+
+    // the segments of the sender, after the SYN of sequence number 0
+    for (uint32_t i = 0; i < segments; i++)
+    {
+        uint32_t n = i;
+        if (reorderInterval > 1 && i % reorderInterval == 0 && i + 1 < segments)
+        {
+            n = i + 1;
+        }
+        else if (reorderInterval > 1 && i % reorderInterval == 1)
+        {
+            n = i - 1;
+        }
+        TcpHeader tcpHeader;
+        tcpHeader.SetSourcePort(senderPort);
+        tcpHeader.SetDestinationPort(port);
+        tcpHeader.SetSequenceNumber(SequenceNumber32(1 + n * segmentSize));
+        tcpHeader.SetAckNumber(SequenceNumber32(1));
+        tcpHeader.SetFlags(TcpHeader::ACK);
+        Ptr<TcpOptionTS> ts = CreateObject<TcpOptionTS>();
+        ts->SetTimestamp(TcpOptionTS::NowToTsValue() + i / 1000);
+        ts->SetEcho(TcpOptionTS::NowToTsValue());
+        tcpHeader.AppendOption(ts);
+        Ptr<Packet> packet = Create<Packet>(segmentSize);
+        packet->AddHeader(tcpHeader);
+
+        Ipv4Header ipHeader;
+        ipHeader.SetSource(interfaces.GetAddress(0));
+        ipHeader.SetDestination(interfaces.GetAddress(1));
+        ipHeader.SetProtocol(TcpL4Protocol::PROT_NUMBER);
+        ipHeader.SetPayloadSize(packet->GetSize());
+        g_segments.emplace_back(packet, ipHeader);
+    }
+
+    for (uint32_t i = 0; i < segments; i += batch)
+    {
+        Simulator::Schedule(MicroSeconds(i / batch), &DeliverSegments, i, batch);
+    }
+    Simulator::Stop(MicroSeconds(segments / batch) + MilliSeconds(10));
+
+    SystemWallClockMs wallClock;
+    wallClock.Start();
+    Simulator::Run();
+    int64_t elapsed = std::max<int64_t>(wallClock.End(), 1);
+
+    uint64_t received = DynamicCast<PacketSink>(sinks.Get(0))->GetTotalRx();
+    std::cout << segments << " data segments (" << received / segmentSize << " delivered) and "
+              << g_acks << " ACKs, " << elapsed << " ms ("
+              << (segments + g_acks) * 1000.0 / elapsed << " segments/s)" << std::endl;
+
+    g_segments.clear();
+    g_tcp = nullptr;
+    g_interface = nullptr;
+    Simulator::Destroy();
+    return 0;
+}
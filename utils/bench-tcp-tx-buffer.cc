@@ -0,0 +1,214 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the SACK scoreboard of TcpTxBuffer during the loss
+// recovery of a large window: a whole window of segments is sent, some of
+// them are lost at random, and the sender processes the ACK with SACK blocks
+// triggered by each segment received, retransmitting the segments returned
+// by NextSeg, until the whole window is acknowledged.
+// Sample usage:  ./ns3 run 'bench-tcp-tx-buffer --segments=50000 --loss=0.01'
+
+#include "ns3/command-line.h"
+#include "ns3/packet.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/tcp-tx-buffer.h"
+
+#include <deque>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * A receiver reporting the segments received with a cumulative ACK and up
+ * to three SACK blocks, the first one holding the latest segment received.
+ */
+class Receiver
+{
+  public:
+    /**
+     * Constructor.
+     * \param segments the number of segments of the window
+     * \param segmentSize the size of a segment
+     * \param head the sequence number of the first segment
+     */
+    Receiver(uint32_t segments, uint32_t segmentSize, SequenceNumber32 head)
+        : m_received(segments, false),
+          m_segmentSize(segmentSize),
+          m_head(head)
+    {
+    }
+
+    /**
+     * Receive a segment.
+     * \param index the index of the segment in the window
+     * \param sackList the SACK blocks to send back
+     * \return the cumulative ACK to send back
+     */
+    SequenceNumber32 Receive(uint32_t index, TcpOptionSack::SackList& sackList)
+    {
+        if (!m_received[index])
+        {
+            m_received[index] = true;
+            if (index == m_next)
+            {
+                while (m_next < m_received.size() && m_received[m_next])
+                {
+                    m_next++;
+                }
+                if (!m_blocks.empty() && m_blocks.begin()->first < m_next)
+                {
+                    m_blocks.erase(m_blocks.begin());
+                }
+            }
+            else
+            {
+                AddToBlocks(index);
+            }
+        }
+
+        sackList.clear();
+        auto it = m_blocks.upper_bound(index);
+        while (it != m_blocks.begin() && sackList.size() < 3)
+        {
+            --it;
+            sackList.emplace_back(m_head + it->first * m_segmentSize,
+                                  m_head + it->second * m_segmentSize);
+        }
+        return m_head + m_next * m_segmentSize;
+    }
+
+  private:
+    /**
+     * Add a segment received out of order to the blocks.
+     * \param index the index of the segment in the window
+     */
+    void AddToBlocks(uint32_t index)
+    {
+        auto next = m_blocks.upper_bound(index);
+        uint32_t end = index + 1;
+        if (next != m_blocks.end() && next->first == end)
+        {
+            end = next->second;
+            next = m_blocks.erase(next);
+        }
+        if (next != m_blocks.begin() && std::prev(next)->second == index)
+        {
+            std::prev(next)->second = end;
+        }
+        else
+        {
+            m_blocks.emplace(index, end);
+        }
+    }
+
+    std::vector<bool> m_received;           //!< Segments received
+    std::map<uint32_t, uint32_t> m_blocks;  //!< Blocks received out of order [start, end)
+    uint32_t m_next{0};                     //!< First segment not received
+    uint32_t m_segmentSize;                 //!< Size of a segment
+    SequenceNumber32 m_head;                //!< Sequence number of the first segment
+};
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t segments = 50000;
+    uint32_t segmentSize = 1448;
+    double loss = 0.01;
+    uint32_t seed = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the SACK scoreboard of TcpTxBuffer with a large window");
+    cmd.AddValue("segments", "number of segments of the window", segments);
+    cmd.AddValue("segmentSize", "size of a segment", segmentSize);
+    cmd.AddValue("loss", "probability of losing a segment", loss);
+    cmd.AddValue("seed", "seed of the losses", seed);
+    cmd.Parse(argc, argv);
+
+    SequenceNumber32 head(1);
+    SequenceNumber32 end = head + segments * segmentSize;
+    Ptr<TcpTxBuffer> txBuffer = CreateObject<TcpTxBuffer>();
+    txBuffer->SetHeadSequence(head);
+    txBuffer->SetMaxBufferSize(segments * segmentSize);
+    txBuffer->SetSegmentSize(segmentSize);
+    txBuffer->SetDupAckThresh(3);
+    txBuffer->SetSackEnabled(true);
+    txBuffer->SetRWndCallback(Callback<uint32_t>([]() { return UINT32_MAX; }));
+    for (uint32_t i = 0; i < segments; i++)
+    {
+        txBuffer->Add(Create<Packet>(segmentSize));
+    }
+
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t i = 0; i < segments; i++)
+    {
+        txBuffer->CopyFromSequence(segmentSize, head + i * segmentSize);
+    }
+    int64_t sendTime = time.End();
+
+    // the segments in flight, in order of arrival
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution lost(loss);
+    std::deque<uint32_t> inFlight;
+    for (uint32_t i = 0; i < segments; i++)
+    {
+        if (!lost(rng))
+        {
+            inFlight.push_back(i);
+        }
+    }
+
+    Receiver receiver(segments, segmentSize, head);
+    TcpOptionSack::SackList sackList;
+    uint32_t acks = 0;
+    uint32_t retransmissions = 0;
+    time.Start();
+    while (!inFlight.empty())
+    {
+        uint32_t index = inFlight.front();
+        inFlight.pop_front();
+        SequenceNumber32 ack = receiver.Receive(index, sackList);
+        acks++;
+
+        txBuffer->DiscardUpTo(ack);
+        if (ack == end)
+        {
+            break;
+        }
+        txBuffer->Update(sackList);
+
+        // retransmit one segment per ACK, as allowed by the pipe
+        SequenceNumber32 seq;
+        SequenceNumber32 seqHigh;
+        if (txBuffer->NextSeg(&seq, &seqHigh, true))
+        {
+            txBuffer->CopyFromSequence(segmentSize, seq);
+            inFlight.push_back((seq - head) / segmentSize);
+            retransmissions++;
+        }
+    }
+    int64_t recoveryTime = std::max<int64_t>(time.End(), 1);
+
+    std::cout << "send " << segments << " segments:\t" << sendTime << " ms" << std::endl;
+    std::cout << "recovery:\t" << acks << " acks, " << retransmissions << " retransmissions, "
+              << recoveryTime << " ms (" << recoveryTime * 1000.0 / acks << " us/ack)"
+              << std::endl;
+    std::cout << "acknowledged:\t" << (txBuffer->HeadSequence() == end ? "all" : "partial")
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program measures the number of UDP datagrams per second sent and
+// received through UDP sockets: many sockets of one node, connected to a
+// single socket of another node (or sending to it with SendTo when connect is
+// false), each send small datagrams in turn, over a point-to-point link fast
+// enough never to queue them. The receiving socket reads every datagram with
+// RecvFrom.
+// Sample usage:  ./ns3 run 'bench-udp-sockets --sockets=10000 --datagrams=500000'
+
+#include "ns3/command-line.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/udp-socket-factory.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+static std::vector<Ptr<Socket>> g_sockets; //!< The sending sockets
+static Address g_destination;              //!< The address of the receiving socket
+static bool g_connect = true;              //!< Whether the sending sockets are connected
+static uint32_t g_size = 0;                //!< Size of the datagrams
+static uint32_t g_sent = 0;                //!< Number of datagrams sent
+static uint32_t g_received = 0;            //!< Number of datagrams received
+
+/**
+ * Send one datagram from each socket of a batch.
+ * \param first the index of the first datagram of the batch
+ * \param count the number of datagrams of the batch
+ */
+static void
+SendDatagrams(uint32_t first, uint32_t count)
+{
+    for (uint32_t i = first; i < first + count; i++)
+    {
+        Ptr<Socket> socket = g_sockets[i % g_sockets.size()];
+        int sent = g_connect ? socket->Send(Create<Packet>(g_size))
+                             : socket->SendTo(Create<Packet>(g_size), 0, g_destination);
+        if (sent >= 0)
+        {
+            g_sent++;
+        }
+    }
+}
+
+/**
+ * Read the datagrams received by the receiving socket.
+ * \param socket the receiving socket
+ */
+static void
+ReceiveDatagrams(Ptr<Socket> socket)
+{
+    Address from;
+    while (socket->RecvFrom(from))
+    {
+        g_received++;
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t sockets = 10000;
+    uint32_t datagrams = 500000;
+    uint32_t batch = 10;
+    g_size = 64;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark sending and receiving small datagrams through many UDP sockets");
+    cmd.AddValue("sockets", "number of sending sockets", sockets);
+    cmd.AddValue("datagrams", "number of datagrams", datagrams);
+    cmd.AddValue("batch", "number of datagrams sent every microsecond", batch);
+    cmd.AddValue("size", "size of the datagrams", g_size);
+    cmd.AddValue("connect", "whether the sending sockets are connected", g_connect);
+    cmd.Parse(argc, argv);
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    PointToPointHelper pointToPoint;
+    pointToPoint.SetDeviceAttribute("DataRate", StringValue("100Gbps"));
+    pointToPoint.SetChannelAttribute("Delay", StringValue("10us"));
+    NetDeviceContainer devices = pointToPoint.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = ipv4.Assign(devices);
+
+    uint16_t port = 9;
+    Ptr<Socket> receiver = Socket::CreateSocket(nodes.Get(1), UdpSocketFactory::GetTypeId());
+    receiver->Bind(InetSocketAddress(Ipv4Address::GetAny(), port));
+    receiver->SetRecvCallback(MakeCallback(&ReceiveDatagrams));
+    g_destination = InetSocketAddress(interfaces.GetAddress(1), port);
+    for (uint32_t i = 0; i < sockets; i++)
+    {
+        Ptr<Socket> socket = Socket::CreateSocket(nodes.Get(0), UdpSocketFactory::GetTypeId());
+        socket->Bind();
+        if (g_connect)
+        {
+            socket->Connect(g_destination);
+        }
+        g_sockets.push_back(socket);
+    }
+
+    for (uint32_t i = 0; i < datagrams; i += batch)
+    {
+        Simulator::Schedule(MicroSeconds(i / batch),
+                            &SendDatagrams,
+                            i,
+                            std::min(batch, datagrams - i));
+    }
+    Simulator::Stop(MicroSeconds(datagrams / batch) + MilliSeconds(1));
+
+    SystemWallClockMs wallClock;
+    wallClock.Start();
+    Simulator::Run();
+    int64_t elapsed = std::max<int64_t>(wallClock.End(), 1);
+
+    std::cout << sockets << " sockets (" << (g_connect ? "connected" : "unconnected") << "): "
+              << g_sent << " datagrams sent, " << g_received << " received, " << elapsed
+              << " ms (" << g_received * 1000.0 / elapsed << " datagrams/s)" << std::endl;
+
+    g_sockets.clear();
+    Simulator::Destroy();
+    return 0;
+}
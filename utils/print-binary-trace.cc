@@ -0,0 +1,73 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup utils
+ * Render a binary trace file as ascii trace text.
+ *
+ * Sample usage:
+ * \code
+ *   ./ns3 run 'print-binary-trace --input=trace.tr --output=trace.txt'
+ * \endcode
+ */
+
+#include "ns3/binary-trace-file.h"
+#include "ns3/command-line.h"
+#include "ns3/packet.h"
+
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Render a binary trace file (see AsciiTraceHelper::CreateBinaryFileStream) "
+              "as ascii trace text");
+    cmd.AddValue("input", "binary trace file", input);
+    cmd.AddValue("output", "text file (standard output if empty)", output);
+    cmd.Parse(argc, argv);
+
+    if (input.empty())
+    {
+        std::cerr << "No input file given, see --help" << std::endl;
+        return 0;
+    }
+
+    // needed to print the captured packets
+    Packet::EnablePrinting();
+
+    if (output.empty())
+    {
+        BinaryTraceFile::ConvertToAscii(input, std::cout);
+    }
+    else
+    {
+        std::ofstream os(output);
+        if (!os.is_open())
+        {
+            std::cerr << "Unable to open " << output << std::endl;
+            return 1;
+        }
+        BinaryTraceFile::ConvertToAscii(input, os);
+    }
+    return 0;
+}